@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// benchmark_util.h
+//
+// Identification: benchmarks/benchmark_util.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/** Keeps a value (and the computation feeding it) alive past the optimizer. */
+template <typename T>
+inline void DoNotOptimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/** Wall-clock stopwatch for the measured loop of a benchmark. */
+class BenchmarkTimer {
+ public:
+  BenchmarkTimer() : start_(std::chrono::steady_clock::now()) {}
+
+  /** @return seconds since construction */
+  double Elapsed() const {
+    return std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start_).count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * Minimal microbenchmark runner. The build may be configured offline, so unlike GTest no
+ * third-party framework is downloaded at configure time; this header carries the timing
+ * loop instead. A benchmark is a callable that sets up its fixture, runs the measured
+ * operation `iterations` times around a BenchmarkTimer, and returns the seconds the loop
+ * took -- setup and teardown stay outside the measurement. The runner grows the iteration
+ * count until a run lasts long enough to time reliably, prints ns/op per benchmark, and
+ * with --json=<path> also writes the results as a JSON array for trend tracking.
+ */
+class BenchmarkRunner {
+ public:
+  /** A benchmark body: runs its measured operation `iterations` times, returns loop seconds. */
+  using BenchmarkFn = std::function<double(uint64_t iterations)>;
+
+  /**
+   * Registers a benchmark. Benchmarks run in registration order.
+   * @param name the benchmark's name, as reported
+   * @param fn the benchmark body
+   */
+  void Register(std::string name, BenchmarkFn fn) { benchmarks_.emplace_back(std::move(name), std::move(fn)); }
+
+  /**
+   * Runs every registered benchmark and reports the results.
+   * @param argc argument count from main
+   * @param argv arguments from main; recognizes --json=<path>
+   * @return the process exit code
+   */
+  int RunAll(int argc, char **argv) {
+    std::string json_path;
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      if (arg.rfind("--json=", 0) == 0) {
+        json_path = arg.substr(7);
+      } else {
+        std::cerr << "unknown argument: " << arg << "\n";
+        return 1;
+      }
+    }
+    std::vector<Result> results;
+    results.reserve(benchmarks_.size());
+    for (auto &[name, fn] : benchmarks_) {
+      results.push_back(Run(name, fn));
+      const Result &r = results.back();
+      std::cout << r.name_ << ": " << r.ns_per_op_ << " ns/op (" << r.iterations_ << " iterations)\n";
+    }
+    if (!json_path.empty()) {
+      WriteJson(json_path, results);
+      std::cout << "wrote " << json_path << "\n";
+    }
+    return 0;
+  }
+
+ private:
+  struct Result {
+    std::string name_;
+    uint64_t iterations_;
+    double ns_per_op_;
+  };
+
+  /** A run must last at least this long for the per-op time to be trustworthy. */
+  static constexpr double MIN_RUN_SECONDS = 0.2;
+  static constexpr uint64_t MAX_ITERATIONS = 1ULL << 30;
+
+  /** Calibrates the iteration count, then keeps the longest-run measurement. */
+  static Result Run(const std::string &name, const BenchmarkFn &fn) {
+    uint64_t iterations = 64;
+    double seconds = fn(iterations);
+    while (seconds < MIN_RUN_SECONDS && iterations < MAX_ITERATIONS) {
+      // Aim past the threshold in one step, but never grow more than 100x on a noisy sample.
+      double scale = seconds > 0 ? (MIN_RUN_SECONDS * 1.5) / seconds : 100.0;
+      scale = std::min(scale, 100.0);
+      iterations = std::max(iterations + 1, static_cast<uint64_t>(static_cast<double>(iterations) * scale));
+      seconds = fn(iterations);
+    }
+    return {name, iterations, seconds * 1e9 / static_cast<double>(iterations)};
+  }
+
+  static void WriteJson(const std::string &path, const std::vector<Result> &results) {
+    std::ofstream out(path, std::ios::trunc);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); i++) {
+      out << "  {\"name\": \"" << results[i].name_ << "\", \"iterations\": " << results[i].iterations_
+          << ", \"ns_per_op\": " << results[i].ns_per_op_ << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+  }
+
+  std::vector<std::pair<std::string, BenchmarkFn>> benchmarks_;
+};
+
+}  // namespace bustub
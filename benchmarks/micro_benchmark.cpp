@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// micro_benchmark.cpp
+//
+// Identification: benchmarks/micro_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark_util.h"
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "container/hash/linear_probe_hash_table.h"
+#include "recovery/log_manager.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/table_page.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+static const char *BENCHMARK_DB = "benchmark.db";
+
+/** FetchPage of a page that is already resident: the latch-and-lookup cost of a pool hit. */
+static double BM_BufferPoolFetchHit(uint64_t iterations) {
+  DiskManager disk_manager(BENCHMARK_DB);
+  BufferPoolManager bpm(64, &disk_manager);
+  page_id_t page_id;
+  bpm.NewPage(&page_id);
+  bpm.UnpinPage(page_id, false);
+  BenchmarkTimer timer;
+  for (uint64_t i = 0; i < iterations; i++) {
+    Page *page = bpm.FetchPage(page_id);
+    DoNotOptimize(page);
+    bpm.UnpinPage(page_id, false);
+  }
+  double seconds = timer.Elapsed();
+  disk_manager.ShutDown();
+  return seconds;
+}
+
+/** FetchPage cycling a working set 16x the pool: every fetch evicts and reads from disk. */
+static double BM_BufferPoolFetchMiss(uint64_t iterations) {
+  DiskManager disk_manager(BENCHMARK_DB);
+  BufferPoolManager bpm(16, &disk_manager);
+  constexpr uint32_t NUM_PAGES = 256;
+  std::vector<page_id_t> page_ids(NUM_PAGES);
+  for (auto &page_id : page_ids) {
+    bpm.NewPage(&page_id);
+    bpm.UnpinPage(page_id, true);
+  }
+  bpm.FlushAllPages();
+  BenchmarkTimer timer;
+  for (uint64_t i = 0; i < iterations; i++) {
+    page_id_t page_id = page_ids[i % NUM_PAGES];
+    Page *page = bpm.FetchPage(page_id);
+    DoNotOptimize(page);
+    bpm.UnpinPage(page_id, false);
+  }
+  double seconds = timer.Elapsed();
+  disk_manager.ShutDown();
+  return seconds;
+}
+
+/** Inserts of fresh int keys; the table keeps growing, so resizes are amortized in. */
+static double BM_HashTableInsert(uint64_t iterations) {
+  DiskManager disk_manager(BENCHMARK_DB);
+  BufferPoolManager bpm(256, &disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> table("bench", &bpm, IntComparator(), 4096, HashFunction<int>());
+  Transaction txn{0};
+  BenchmarkTimer timer;
+  for (uint64_t i = 0; i < iterations; i++) {
+    auto key = static_cast<int>(i);
+    bool inserted = table.Insert(&txn, key, key);
+    DoNotOptimize(inserted);
+  }
+  double seconds = timer.Elapsed();
+  disk_manager.ShutDown();
+  return seconds;
+}
+
+/** Probes over a fixed 4096-key table, every probe a hit. */
+static double BM_HashTableProbe(uint64_t iterations) {
+  DiskManager disk_manager(BENCHMARK_DB);
+  BufferPoolManager bpm(256, &disk_manager);
+  constexpr int NUM_KEYS = 4096;
+  LinearProbeHashTable<int, int, IntComparator> table("bench", &bpm, IntComparator(), NUM_KEYS, HashFunction<int>());
+  Transaction txn{0};
+  for (int key = 0; key < NUM_KEYS; key++) {
+    table.Insert(&txn, key, key);
+  }
+  std::vector<int> result;
+  BenchmarkTimer timer;
+  for (uint64_t i = 0; i < iterations; i++) {
+    result.clear();
+    table.GetValue(&txn, static_cast<int>(i % NUM_KEYS), &result);
+    DoNotOptimize(result);
+  }
+  double seconds = timer.Elapsed();
+  disk_manager.ShutDown();
+  return seconds;
+}
+
+/** Page-local row inserts on one in-memory page, re-initialized whenever it fills. */
+static double BM_TablePageInsertTuple(uint64_t iterations) {
+  std::vector<Column> columns;
+  columns.emplace_back("a", TypeId::INTEGER);
+  columns.emplace_back("b", TypeId::BIGINT);
+  Schema schema(columns);
+  std::vector<Value> values{Value(TypeId::INTEGER, 42), Value(TypeId::BIGINT, static_cast<int64_t>(42))};
+  Tuple tuple(values, &schema);
+  Transaction txn{0};
+  auto holder = std::make_unique<Page>();
+  auto *page = reinterpret_cast<TablePage *>(holder.get());
+  page->Init(0, PAGE_SIZE, INVALID_PAGE_ID, nullptr, &txn);
+  RID rid;
+  BenchmarkTimer timer;
+  for (uint64_t i = 0; i < iterations; i++) {
+    if (!page->InsertTuple(tuple, &rid, &txn, nullptr, nullptr)) {
+      page->Init(0, PAGE_SIZE, INVALID_PAGE_ID, nullptr, &txn);
+      page->InsertTuple(tuple, &rid, &txn, nullptr, nullptr);
+    }
+    DoNotOptimize(rid);
+  }
+  return timer.Elapsed();
+}
+
+/** Integer equality through the Value type dispatch, over a small rotating operand set. */
+static double BM_ValueCompareEquals(uint64_t iterations) {
+  Value lhs(TypeId::INTEGER, 42);
+  std::vector<Value> operands;
+  operands.reserve(8);
+  for (int i = 0; i < 8; i++) {
+    operands.emplace_back(TypeId::INTEGER, 39 + i);
+  }
+  BenchmarkTimer timer;
+  for (uint64_t i = 0; i < iterations; i++) {
+    CmpBool result = lhs.CompareEquals(operands[i % operands.size()]);
+    DoNotOptimize(result);
+  }
+  return timer.Elapsed();
+}
+
+/** Appends of small commit records into the shared log buffer, flush thread running. */
+static double BM_LogManagerAppend(uint64_t iterations) {
+  DiskManager disk_manager(BENCHMARK_DB);
+  LogManager log_manager(&disk_manager);
+  log_manager.RunFlushThread();
+  BenchmarkTimer timer;
+  for (uint64_t i = 0; i < iterations; i++) {
+    LogRecord record(0, INVALID_LSN, LogRecordType::COMMIT);
+    lsn_t lsn = log_manager.AppendLogRecord(&record);
+    DoNotOptimize(lsn);
+  }
+  double seconds = timer.Elapsed();
+  log_manager.StopFlushThread();
+  disk_manager.ShutDown();
+  return seconds;
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  bustub::BenchmarkRunner runner;
+  runner.Register("BufferPoolManager/FetchPage/hit", bustub::BM_BufferPoolFetchHit);
+  runner.Register("BufferPoolManager/FetchPage/miss", bustub::BM_BufferPoolFetchMiss);
+  runner.Register("LinearProbeHashTable/Insert", bustub::BM_HashTableInsert);
+  runner.Register("LinearProbeHashTable/GetValue", bustub::BM_HashTableProbe);
+  runner.Register("TablePage/InsertTuple", bustub::BM_TablePageInsertTuple);
+  runner.Register("Value/CompareEquals", bustub::BM_ValueCompareEquals);
+  runner.Register("LogManager/AppendLogRecord", bustub::BM_LogManagerAppend);
+  int rc = runner.RunAll(argc, argv);
+  remove(bustub::BENCHMARK_DB);
+  remove("benchmark.free");
+  remove("benchmark.warm");
+  // The log benchmark leaves a run of preallocated WAL segment files; sweep until one is missing.
+  remove("benchmark.log");
+  for (int segment = 1; remove(("benchmark.log." + std::to_string(segment)).c_str()) == 0; segment++) {
+  }
+  return rc;
+}
@@ -0,0 +1,266 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// workload_driver.cpp
+//
+// Identification: benchmarks/workload_driver.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+//
+// End-to-end workload harness: N client threads run a configurable read/write mix
+// (the YCSB A-F shapes) against a TableHeap with a registered LinearProbeHashTableIndex,
+// through the managers a real BustubInstance wires together. Reports throughput and
+// latency percentiles, so any perf change can be validated under concurrency rather
+// than in isolation.
+//
+//   workload_driver [--workload=a..f] [--threads=N] [--rows=N] [--ops=N] [--json=<path>]
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catalog/simple_catalog.h"
+#include "common/bustub_instance.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/linear_probe_hash_table_index.h"
+
+namespace bustub {
+
+static const char *WORKLOAD_DB = "workload.db";
+
+/** The operation mix of one YCSB-shaped workload, in percent. */
+struct WorkloadMix {
+  char name_;
+  uint32_t read_pct_;
+  uint32_t update_pct_;
+  uint32_t insert_pct_;
+  uint32_t scan_pct_;
+  uint32_t rmw_pct_;
+  /** D reads are skewed to the most recently inserted keys. */
+  bool read_latest_;
+};
+
+/** The standard shapes: A 50/50 read-update, B 95/5, C read-only, D read-latest with
+ * inserts, E short scans with inserts, F read-modify-write. */
+static const WorkloadMix WORKLOAD_MIXES[] = {
+    {'a', 50, 50, 0, 0, 0, false}, {'b', 95, 5, 0, 0, 0, false},  {'c', 100, 0, 0, 0, 0, false},
+    {'d', 95, 0, 5, 0, 0, true},   {'e', 0, 0, 5, 95, 0, false},  {'f', 50, 0, 0, 0, 50, false},
+};
+
+/** Keys touched by one E-shape scan. */
+static constexpr uint32_t SCAN_LENGTH = 16;
+/** D-shape reads draw from this many of the newest keys. */
+static constexpr uint32_t LATEST_WINDOW = 1024;
+
+struct DriverOptions {
+  WorkloadMix mix_ = WORKLOAD_MIXES[0];
+  uint32_t threads_ = 4;
+  uint32_t rows_ = 100000;
+  uint32_t ops_ = 200000;
+  std::string json_path_;
+};
+
+/** Everything the client threads share. */
+struct WorkloadContext {
+  BustubInstance *instance_;
+  TableMetadata *table_;
+  Index *index_;
+  const Schema *key_schema_;
+  /** One past the largest key that surely exists; inserts bump it after the row lands. */
+  std::atomic<uint32_t> max_key_;
+};
+
+static Tuple MakeRow(uint32_t key, uint32_t field, const Schema *schema) {
+  std::vector<Value> values{Value(TypeId::INTEGER, static_cast<int32_t>(key)),
+                            Value(TypeId::INTEGER, static_cast<int32_t>(field)),
+                            Value(TypeId::INTEGER, static_cast<int32_t>(field ^ 0x5bd1e995U))};
+  return Tuple(values, schema);
+}
+
+static Tuple MakeKey(uint32_t key, const Schema *key_schema) {
+  std::vector<Value> values{Value(TypeId::INTEGER, static_cast<int32_t>(key))};
+  return Tuple(values, key_schema);
+}
+
+/** Index lookup followed by the heap read, the driver's unit of a point read. */
+static bool ReadKey(WorkloadContext *ctx, uint32_t key, std::vector<RID> *rids, Tuple *row, Transaction *txn) {
+  rids->clear();
+  ctx->index_->ScanKey(MakeKey(key, ctx->key_schema_), rids, txn);
+  return !rids->empty() && ctx->table_->table_->GetTuple(rids->front(), row, txn);
+}
+
+/** One client: runs its share of operations, recording per-operation latency. */
+static void RunClient(WorkloadContext *ctx, const DriverOptions *options, uint32_t client_id,
+                      std::vector<uint64_t> *latencies) {
+  std::default_random_engine engine(client_id + 1);
+  std::uniform_int_distribution<uint32_t> pct_dist(0, 99);
+  const WorkloadMix &mix = options->mix_;
+  uint32_t ops = options->ops_ / options->threads_;
+  latencies->reserve(ops);
+  std::vector<RID> rids;
+  Tuple row;
+  for (uint32_t i = 0; i < ops; i++) {
+    auto start = std::chrono::steady_clock::now();
+    Transaction *txn = ctx->instance_->transaction_manager_->Begin();
+    uint32_t max_key = ctx->max_key_.load(std::memory_order_acquire);
+    std::uniform_int_distribution<uint32_t> key_dist(0, max_key - 1);
+    uint32_t key = key_dist(engine);
+    if (mix.read_latest_) {
+      key = max_key - 1 - (key % std::min(max_key, LATEST_WINDOW));
+    }
+    uint32_t roll = pct_dist(engine);
+    if (roll < mix.read_pct_) {
+      ReadKey(ctx, key, &rids, &row, txn);
+    } else if (roll < mix.read_pct_ + mix.update_pct_) {
+      if (ReadKey(ctx, key, &rids, &row, txn)) {
+        ctx->table_->table_->UpdateTuple(MakeRow(key, i, &ctx->table_->schema_), rids.front(), txn);
+      }
+    } else if (roll < mix.read_pct_ + mix.update_pct_ + mix.insert_pct_) {
+      uint32_t new_key = ctx->max_key_.fetch_add(1, std::memory_order_acq_rel);
+      RID rid;
+      ctx->table_->table_->InsertTuple(MakeRow(new_key, i, &ctx->table_->schema_), &rid, txn);
+    } else if (roll < mix.read_pct_ + mix.update_pct_ + mix.insert_pct_ + mix.scan_pct_) {
+      // A hash index cannot walk a range, so a "scan" probes SCAN_LENGTH consecutive keys.
+      for (uint32_t offset = 0; offset < SCAN_LENGTH; offset++) {
+        ReadKey(ctx, (key + offset) % max_key, &rids, &row, txn);
+      }
+    } else {
+      // Read-modify-write: the update derives from the row just read.
+      if (ReadKey(ctx, key, &rids, &row, txn)) {
+        auto field = row.GetValue(&ctx->table_->schema_, 1).GetAs<int32_t>();
+        ctx->table_->table_->UpdateTuple(MakeRow(key, static_cast<uint32_t>(field) + 1, &ctx->table_->schema_),
+                                         rids.front(), txn);
+      }
+    }
+    ctx->instance_->transaction_manager_->Commit(txn);
+    delete txn;
+    latencies->push_back(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+  }
+}
+
+static uint64_t Percentile(const std::vector<uint64_t> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  auto rank = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+  return sorted[rank];
+}
+
+static int RunDriver(const DriverOptions &options) {
+  BustubInstance instance(WORKLOAD_DB);
+  SimpleCatalog catalog(instance.buffer_pool_manager_, instance.lock_manager_, instance.log_manager_);
+  Transaction *load_txn = instance.transaction_manager_->Begin();
+
+  std::vector<Column> columns{{"key", TypeId::INTEGER}, {"field0", TypeId::INTEGER}, {"field1", TypeId::INTEGER}};
+  Schema schema(columns);
+  TableMetadata *table = catalog.CreateTable(load_txn, "usertable", schema);
+
+  // The request pattern is point lookups, so the key column gets a linear-probe hash index,
+  // registered with the heap before any row lands so every write path maintains it.
+  auto *metadata = new IndexMetadata("usertable_key", "usertable", &table->schema_, {0});
+  LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>> index(
+      metadata, instance.buffer_pool_manager_, options.rows_ * 2, HashFunction<GenericKey<8>>());
+  table->table_->RegisterIndex(&index);
+
+  instance.buffer_pool_manager_->SetBulkPinMode(true);
+  for (uint32_t key = 0; key < options.rows_; key++) {
+    RID rid;
+    table->table_->InsertTuple(MakeRow(key, key, &table->schema_), &rid, load_txn);
+  }
+  instance.buffer_pool_manager_->SetBulkPinMode(false);
+  instance.transaction_manager_->Commit(load_txn);
+  delete load_txn;
+
+  WorkloadContext ctx{&instance, table, &index, index.GetKeySchema(), options.rows_};
+  std::vector<std::vector<uint64_t>> latencies(options.threads_);
+  std::vector<std::thread> clients;
+  clients.reserve(options.threads_);
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t t = 0; t < options.threads_; t++) {
+    clients.emplace_back(RunClient, &ctx, &options, t, &latencies[t]);
+  }
+  for (auto &client : clients) {
+    client.join();
+  }
+  double seconds =
+      std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<uint64_t> merged;
+  merged.reserve(options.ops_);
+  for (auto &thread_latencies : latencies) {
+    merged.insert(merged.end(), thread_latencies.begin(), thread_latencies.end());
+  }
+  std::sort(merged.begin(), merged.end());
+  double throughput = static_cast<double>(merged.size()) / seconds;
+  uint64_t p50 = Percentile(merged, 0.50);
+  uint64_t p95 = Percentile(merged, 0.95);
+  uint64_t p99 = Percentile(merged, 0.99);
+  uint64_t max = merged.empty() ? 0 : merged.back();
+
+  std::cout << "workload " << options.mix_.name_ << ": " << options.threads_ << " threads, " << options.rows_
+            << " rows, " << merged.size() << " ops in " << seconds << " s\n"
+            << "  throughput: " << throughput << " ops/s\n"
+            << "  latency ns: p50=" << p50 << " p95=" << p95 << " p99=" << p99 << " max=" << max << "\n";
+  if (!options.json_path_.empty()) {
+    std::ofstream out(options.json_path_, std::ios::trunc);
+    out << "{\"workload\": \"" << options.mix_.name_ << "\", \"threads\": " << options.threads_
+        << ", \"rows\": " << options.rows_ << ", \"ops\": " << merged.size() << ", \"seconds\": " << seconds
+        << ", \"ops_per_sec\": " << throughput << ", \"p50_ns\": " << p50 << ", \"p95_ns\": " << p95
+        << ", \"p99_ns\": " << p99 << ", \"max_ns\": " << max << "}\n";
+    std::cout << "wrote " << options.json_path_ << "\n";
+  }
+  return 0;
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  bustub::DriverOptions options;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.rfind("--workload=", 0) == 0 && arg.size() == 12) {
+      bool found = false;
+      for (const auto &mix : bustub::WORKLOAD_MIXES) {
+        if (mix.name_ == arg[11]) {
+          options.mix_ = mix;
+          found = true;
+        }
+      }
+      if (!found) {
+        std::cerr << "unknown workload: " << arg[11] << " (expected a-f)\n";
+        return 1;
+      }
+    } else if (arg.rfind("--threads=", 0) == 0) {
+      options.threads_ = std::max(1, std::stoi(arg.substr(10)));
+    } else if (arg.rfind("--rows=", 0) == 0) {
+      options.rows_ = std::max(1, std::stoi(arg.substr(7)));
+    } else if (arg.rfind("--ops=", 0) == 0) {
+      options.ops_ = std::max(1, std::stoi(arg.substr(6)));
+    } else if (arg.rfind("--json=", 0) == 0) {
+      options.json_path_ = arg.substr(7);
+    } else {
+      std::cerr << "usage: workload_driver [--workload=a..f] [--threads=N] [--rows=N] [--ops=N] [--json=<path>]\n";
+      return 1;
+    }
+  }
+  int rc = bustub::RunDriver(options);
+  remove(bustub::WORKLOAD_DB);
+  remove("workload.log");
+  remove("workload.free");
+  remove("workload.warm");
+  return rc;
+}
@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_replacer.cpp
+//
+// Identification: src/buffer/adaptive_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/adaptive_replacer.h"
+
+namespace bustub {
+
+AdaptiveReplacer::AdaptiveReplacer(size_t num_pages, size_t window_misses)
+    : clock_(std::make_unique<ClockReplacer>(num_pages)),
+      lru_k_(std::make_unique<LRUKReplacer>(num_pages)),
+      ghost_capacity_(num_pages),
+      window_misses_(window_misses) {}
+
+bool AdaptiveReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock lock{mu_};
+  if (!PolicyReplacer(active_)->Victim(frame_id)) {
+    return false;
+  }
+  // The shadow policy must forget the frame too, or it would hand out an occupied frame the
+  // moment it becomes active. Pin removes a frame from the evictable set in both policies.
+  ReplacerType shadow = active_ == ReplacerType::CLOCK ? ReplacerType::LRU_K : ReplacerType::CLOCK;
+  PolicyReplacer(shadow)->Pin(*frame_id);
+  return true;
+}
+
+void AdaptiveReplacer::Pin(frame_id_t frame_id) {
+  clock_->Pin(frame_id);
+  lru_k_->Pin(frame_id);
+}
+
+void AdaptiveReplacer::Unpin(frame_id_t frame_id) {
+  clock_->Unpin(frame_id);
+  lru_k_->Unpin(frame_id);
+}
+
+void AdaptiveReplacer::UnpinForReuse(frame_id_t frame_id) {
+  clock_->UnpinForReuse(frame_id);
+  lru_k_->UnpinForReuse(frame_id);
+}
+
+void AdaptiveReplacer::RecordEviction(frame_id_t /*frame_id*/, page_id_t page_id) {
+  std::scoped_lock lock{mu_};
+  auto ghost = ghost_pages_.find(page_id);
+  if (ghost != ghost_pages_.end()) {
+    ghost_order_.erase(ghost->second);
+    ghost_pages_.erase(ghost);
+  }
+  ghost_order_.push_back(page_id);
+  ghost_pages_[page_id] = std::prev(ghost_order_.end());
+  if (ghost_order_.size() > ghost_capacity_) {
+    ghost_pages_.erase(ghost_order_.front());
+    ghost_order_.pop_front();
+  }
+}
+
+void AdaptiveReplacer::RecordMiss(page_id_t page_id) {
+  std::scoped_lock lock{mu_};
+  misses_in_window_++;
+  auto ghost = ghost_pages_.find(page_id);
+  if (ghost != ghost_pages_.end()) {
+    // The active policy evicted a page the workload came back for within a pool's worth of
+    // evictions. Count it once; the page is resident again after this miss.
+    ghost_hits_in_window_++;
+    ghost_hits_++;
+    ghost_order_.erase(ghost->second);
+    ghost_pages_.erase(ghost);
+  }
+  if (misses_in_window_ >= window_misses_) {
+    EndWindow();
+  }
+}
+
+void AdaptiveReplacer::EndWindow() {
+  measured_rate_[static_cast<size_t>(active_)] =
+      static_cast<double>(ghost_hits_in_window_) / static_cast<double>(misses_in_window_);
+  misses_in_window_ = 0;
+  ghost_hits_in_window_ = 0;
+  windows_since_switch_++;
+
+  ReplacerType other = active_ == ReplacerType::CLOCK ? ReplacerType::LRU_K : ReplacerType::CLOCK;
+  double active_rate = measured_rate_[static_cast<size_t>(active_)];
+  double other_rate = measured_rate_[static_cast<size_t>(other)];
+  // Switch when the other policy is unmeasured (exploration), measured better, or simply has not
+  // been given a chance in a while -- its old sample may describe a workload that is gone.
+  if (other_rate == UNMEASURED || other_rate < active_rate || windows_since_switch_ >= PROBE_INTERVAL) {
+    active_ = other;
+    policy_switches_++;
+    windows_since_switch_ = 0;
+  }
+}
+
+size_t AdaptiveReplacer::Size() {
+  std::scoped_lock lock{mu_};
+  return PolicyReplacer(active_)->Size();
+}
+
+ReplacerType AdaptiveReplacer::GetActivePolicy() {
+  std::scoped_lock lock{mu_};
+  return active_;
+}
+
+uint64_t AdaptiveReplacer::GetPolicySwitches() {
+  std::scoped_lock lock{mu_};
+  return policy_switches_;
+}
+
+uint64_t AdaptiveReplacer::GetGhostHits() {
+  std::scoped_lock lock{mu_};
+  return ghost_hits_;
+}
+
+}  // namespace bustub
@@ -12,17 +12,61 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <chrono>  // NOLINT
 #include <list>
 #include <unordered_map>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "buffer/lru_k_replacer.h"
 #include "common/logger.h"
+#include "common/numa_util.h"
+#include "common/tracer.h"
 
 namespace bustub {
 
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // We allocate a consecutive memory space for the buffer pool.
-  pages_ = new Page[pool_size_];
-  replacer_ = new ClockReplacer(pool_size);
+namespace {
+/** @return microseconds elapsed since start */
+uint64_t ElapsedUs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager,
+                                     ReplacerType replacer_type)
+    : BufferPoolManager(pool_size, 1, 0, disk_manager, log_manager, replacer_type) {}
+
+BufferPoolManager::BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                     DiskManager *disk_manager, LogManager *log_manager, ReplacerType replacer_type)
+    : pool_size_(pool_size),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      page_table_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(static_cast<page_id_t>(instance_index)) {
+  // We allocate a consecutive memory space for the buffer pool, interleaved across NUMA
+  // nodes: frames land on alternating nodes instead of all on the constructor's node, so on
+  // a multi-socket box no socket pays the remote-access penalty for the whole pool.
+  // Frame bytes and frame metadata are separate arrays: pin-count and latch traffic then only
+  // dirties the small metadata entries, never a cache line a scan is streaming page bytes from.
+  frame_data_ = static_cast<char *>(NumaUtil::AllocateInterleaved(static_cast<size_t>(PAGE_SIZE) * pool_size_));
+  pages_ = static_cast<Page *>(NumaUtil::AllocateInterleaved(sizeof(Page) * pool_size_));
+  BUSTUB_ASSERT(frame_data_ != nullptr && pages_ != nullptr, "Buffer pool frame allocation cannot fail");
+  for (size_t i = 0; i < pool_size_; ++i) {
+    new (&pages_[i]) Page(frame_data_ + i * PAGE_SIZE);
+  }
+  bulk_frames_.resize(pool_size_, false);
+  if (replacer_type == ReplacerType::LRU_K) {
+    replacer_ = new LRUKReplacer(pool_size);
+  } else if (replacer_type == ReplacerType::ADAPTIVE) {
+    // Kept in a typed pointer too, so GetStats can read the policy counters.
+    adaptive_replacer_ = new AdaptiveReplacer(pool_size);
+    replacer_ = adaptive_replacer_;
+  } else {
+    replacer_ = new ClockReplacer(pool_size);
+  }
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
@@ -30,11 +74,276 @@ BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager
   }
 }
 
+BufferPoolManager::BufferPoolManager(DiskManager *disk_manager, size_t pool_size)
+    : pool_size_(pool_size),
+      pages_(nullptr),
+      disk_manager_(disk_manager),
+      log_manager_(nullptr),
+      page_table_(0),
+      replacer_(nullptr) {}
+
 BufferPoolManager::~BufferPoolManager() {
-  delete[] pages_;
+  StopFlushThread();
+  StopPrefetchThread();
+  if (pages_ != nullptr) {
+    for (size_t i = 0; i < pool_size_; ++i) {
+      pages_[i].~Page();
+    }
+    NumaUtil::FreeInterleaved(pages_, sizeof(Page) * pool_size_);
+    NumaUtil::FreeInterleaved(frame_data_, static_cast<size_t>(PAGE_SIZE) * pool_size_);
+  }
   delete replacer_;
 }
 
+/*
+ * Enqueue a page id for the prefetch worker and return immediately.
+ * The worker thread is started lazily on the first request.
+ */
+void BufferPoolManager::PrefetchPage(page_id_t page_id) {
+  std::lock_guard lock(prefetcher_latch_);
+  if (!prefetcher_running_) {
+    prefetcher_running_ = true;
+    prefetcher_thread_ = new std::thread([this] {
+      std::unique_lock lock(prefetcher_latch_);
+      while (prefetcher_running_) {
+        prefetcher_cv_.wait(lock, [this] { return !prefetcher_running_ || !prefetch_queue_.empty(); });
+        while (!prefetch_queue_.empty()) {
+          auto prefetch_page_id = prefetch_queue_.front();
+          prefetch_queue_.pop_front();
+          lock.unlock();
+          // Skip pages that are already resident so a prefetch of a hot page is free.
+          frame_id_t resident_frame;
+          if (!page_table_.Find(prefetch_page_id, &resident_frame)) {
+            Page *page = FetchPage(prefetch_page_id);
+            if (page != nullptr) {
+              UnpinPage(prefetch_page_id, false);
+            }
+          }
+          lock.lock();
+        }
+      }
+    });
+  }
+  prefetch_queue_.push_back(page_id);
+  prefetcher_cv_.notify_one();
+}
+
+/*
+ * Stop and join the prefetch worker thread, dropping any queued requests.
+ */
+void BufferPoolManager::StopPrefetchThread() {
+  {
+    std::lock_guard lock(prefetcher_latch_);
+    if (!prefetcher_running_) {
+      return;
+    }
+    prefetcher_running_ = false;
+    prefetch_queue_.clear();
+  }
+  prefetcher_cv_.notify_all();
+  prefetcher_thread_->join();
+  delete prefetcher_thread_;
+  prefetcher_thread_ = nullptr;
+}
+
+/*
+ * Start a separate thread that periodically writes dirty frames back to disk,
+ * so victim selection almost never has to do a synchronous write-back.
+ */
+void BufferPoolManager::RunFlushThread() {
+  if (flusher_running_.exchange(true)) {
+    return;
+  }
+  flusher_thread_ = new std::thread([this] {
+    while (flusher_running_) {
+      {
+        std::unique_lock lock(flusher_latch_);
+        flusher_cv_.wait_for(lock, dirty_flush_interval, [this] { return !flusher_running_; });
+      }
+      if (flusher_running_) {
+        FlushDirtyPages();
+        // Keep the warm-set sidecar current so a crash still restarts warm. Routing pools dump
+        // the aggregated set themselves.
+        if (num_instances_ == 1) {
+          SaveWarmSet();
+        }
+      }
+    }
+  });
+}
+
+/*
+ * Stop and join the background flusher thread.
+ */
+void BufferPoolManager::StopFlushThread() {
+  if (!flusher_running_.exchange(false)) {
+    return;
+  }
+  flusher_cv_.notify_all();
+  flusher_thread_->join();
+  delete flusher_thread_;
+  flusher_thread_ = nullptr;
+}
+
+/*
+ * WAL rule: the log records behind a page's lsn may still sit in a transaction's private staging
+ * buffer, so flush-before-write means publish-then-wait, not just wait.
+ */
+void BufferPoolManager::EnsureLogDurable(frame_id_t frame_id) {
+  if (!enable_logging || log_manager_ == nullptr) {
+    return;
+  }
+  lsn_t page_lsn = pages_[frame_id].GetLSN();
+  // Real lsns start at 1; a zero-filled page has never been logged against.
+  if (page_lsn <= 0 || page_lsn <= log_manager_->GetPersistentLSN()) {
+    return;
+  }
+  log_manager_->PublishAllStaged();
+  log_manager_->WaitForFlush(page_lsn);
+}
+
+void BufferPoolManager::FlushDirtyPages() {
+  std::lock_guard lock(latch_);
+  page_table_.ForEach([this](page_id_t page_id, frame_id_t frame_id) {
+    if (!pages_[frame_id].IsDirty()) {
+      return;
+    }
+    EnsureLogDurable(frame_id);
+    // Clear-then-write: the page stays pinned and writable during the flush, so a modification
+    // that lands after this clear re-dirties the frame and the next sweep picks it up. Clearing
+    // after the write would discard that re-dirty and silently lose the modification.
+    pages_[frame_id].is_dirty_ = false;
+    pages_[frame_id].RLatch();
+    disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
+    pages_[frame_id].RUnlatch();
+    num_dirty_writebacks_.fetch_add(1, std::memory_order_relaxed);
+  });
+}
+
+std::vector<page_id_t> BufferPoolManager::GetResidentPageIds() {
+  std::lock_guard lock(latch_);
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(page_table_.Size());
+  page_table_.ForEach([&page_ids](page_id_t page_id, frame_id_t) { page_ids.push_back(page_id); });
+  return page_ids;
+}
+
+std::vector<page_id_t> BufferPoolManager::GetDirtyPageIds() {
+  std::lock_guard lock(latch_);
+  std::vector<page_id_t> page_ids;
+  page_table_.ForEach([this, &page_ids](page_id_t page_id, frame_id_t frame_id) {
+    if (pages_[frame_id].IsDirty()) {
+      page_ids.push_back(page_id);
+    }
+  });
+  return page_ids;
+}
+
+void BufferPoolManager::SaveWarmSet() { disk_manager_->WriteWarmSet(GetResidentPageIds()); }
+
+bool BufferPoolManager::LoadWarmSet() {
+  std::vector<page_id_t> page_ids;
+  if (!disk_manager_->ReadWarmSet(&page_ids) || page_ids.empty()) {
+    return false;
+  }
+  // One batched fetch pulls the whole hot set in with large sequential reads.
+  std::vector<Page *> pages;
+  FetchPages(page_ids, &pages);
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    if (pages[i] != nullptr) {
+      UnpinPage(page_ids[i], false);
+    }
+  }
+  return true;
+}
+
+BufferPoolManager::Stats BufferPoolManager::GetStats() {
+  Stats stats;
+  stats.hits_ = num_hits_.load(std::memory_order_relaxed);
+  stats.misses_ = num_misses_.load(std::memory_order_relaxed);
+  stats.evictions_ = num_evictions_.load(std::memory_order_relaxed);
+  stats.dirty_writebacks_ = num_dirty_writebacks_.load(std::memory_order_relaxed);
+  stats.pin_wait_time_us_ = pin_wait_time_us_.load(std::memory_order_relaxed);
+  stats.frame_waits_ = num_frame_waits_.load(std::memory_order_relaxed);
+  stats.frame_wait_failures_ = num_frame_wait_failures_.load(std::memory_order_relaxed);
+  if (adaptive_replacer_ != nullptr) {
+    stats.replacer_ghost_hits_ = adaptive_replacer_->GetGhostHits();
+    stats.replacer_policy_switches_ = adaptive_replacer_->GetPolicySwitches();
+  }
+  return stats;
+}
+
+/*
+ * Pick an evictable frame. EvictVictim removes the victim's page table mapping BEFORE checking
+ * its pin count; the lock-free fast path in FetchPageImpl bumps the pin count and only then
+ * re-validates the mapping, so whichever side loses the race backs off.
+ */
+bool BufferPoolManager::EvictVictim(frame_id_t *frame_id) {
+  frame_id_t candidate;
+  for (size_t attempt = 0; attempt < pool_size_ && replacer_->Victim(&candidate); ++attempt) {
+    auto victim_page_id = frame_table_[candidate];
+    page_table_.Remove(victim_page_id);
+    // Take ownership by claiming the pin count, not just reading it: a plain zero check followed
+    // by the new page's store(1) would erase a stale fast-path pin that lands in between, and
+    // that pinner's undo would then strip the new owner's pin (see FRAME_CLAIM_PINS).
+    int expected_pins = 0;
+    if (!pages_[candidate].pin_count_.compare_exchange_strong(expected_pins, FRAME_CLAIM_PINS)) {
+      // Re-pinned through the fast path between the replacer's decision and now; restore the
+      // mapping and try the next candidate. The frame rejoins the replacer on its next unpin.
+      page_table_.Insert(victim_page_id, candidate);
+      continue;
+    }
+    num_evictions_.fetch_add(1, std::memory_order_relaxed);
+    replacer_->RecordEviction(candidate, victim_page_id);
+    if (pages_[candidate].IsDirty()) {
+      EnsureLogDurable(candidate);
+    }
+    pages_[candidate].RLatch();
+    if (pages_[candidate].IsDirty()) {
+      num_dirty_writebacks_.fetch_add(1, std::memory_order_relaxed);
+      disk_manager_->WritePage(victim_page_id, pages_[candidate].GetData());
+      pages_[candidate].is_dirty_ = false;
+    }
+    pages_[candidate].RUnlatch();
+    *frame_id = candidate;
+    return true;
+  }
+  return false;
+}
+
+/*
+ * Free list first, then eviction, then a bounded backoff wait. Unpins never take latch_, so
+ * holding it across the sleep does not keep other queries from releasing the frames this one
+ * is waiting for; it only serializes the would-be allocators, which all need a frame anyway.
+ */
+bool BufferPoolManager::AcquireFrame(frame_id_t *frame_id) {
+  for (size_t round = 0;; round++) {
+    if (!free_list_.empty()) {
+      *frame_id = free_list_.front();
+      free_list_.pop_front();
+      // Claim the frame the same way eviction does, so the setup paths see one convention. A
+      // free frame has no owner, but a stale fast-path pin/unpin pair can still be in flight
+      // across it; the claim simply waits out that transient increment.
+      int expected_pins = 0;
+      while (!pages_[*frame_id].pin_count_.compare_exchange_weak(expected_pins, FRAME_CLAIM_PINS)) {
+        expected_pins = 0;
+        std::this_thread::yield();
+      }
+      return true;
+    }
+    if (EvictVictim(frame_id)) {
+      return true;
+    }
+    if (round >= BPM_FRAME_WAIT_RETRIES) {
+      num_frame_wait_failures_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    num_frame_waits_.fetch_add(1, std::memory_order_relaxed);
+    // Exponential backoff, capped so the worst-case wait stays in the low milliseconds.
+    std::this_thread::sleep_for(std::chrono::microseconds(BPM_FRAME_WAIT_INTERVAL_US << std::min<size_t>(round, 5)));
+  }
+}
+
 // TODO: NewPage
 Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   // 1.     Search the page table for the requested page (P).
@@ -44,83 +353,153 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   // 2.     If R is dirty, write it back to the disk.
   // 3.     Delete R from the page table and insert P.
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  std::lock_guard lock(latch_);
-  auto page_it = page_table_.find(page_id);
-  if (page_it != page_table_.end()) {
-    replacer_->Pin(page_it->second);
-    // page_it->second == frame_id
-    return &pages_[page_it->second];
-  }
-  // search freelist
-  if (!free_list_.empty()) {
-    auto free_frame_id = free_list_.front();
-    free_list_.pop_front();
-    page_table_[page_id] = free_frame_id;
-    frame_table_[free_frame_id] = page_id;
-    pages_[free_frame_id].WLatch();
-    disk_manager_->ReadPage(page_id, pages_[free_frame_id].GetData());
-    pages_[free_frame_id].WUnlatch();
-    // NOTE: unpin to replacer
-    replacer_->Unpin(free_frame_id);
-    return &pages_[free_frame_id];
-  }
-  // using replacer
-  frame_id_t replaced;
-  auto success = replacer_->Victim(&replaced);
-  if (!success) {
-    // no frame to replace;
-    return nullptr;
+
+  // Lock-free fast path: a hit on a resident page is one page table probe plus one fetch_add,
+  // with no mutex. The second probe re-validates the mapping after the pin has landed, since
+  // EvictVictim removes the mapping before it inspects the pin count.
+  frame_id_t frame_id;
+  if (page_table_.Find(page_id, &frame_id)) {
+    pages_[frame_id].pin_count_.fetch_add(1);
+    frame_id_t check_frame_id;
+    if (page_table_.Find(page_id, &check_frame_id) && check_frame_id == frame_id) {
+      num_hits_.fetch_add(1, std::memory_order_relaxed);
+      BUSTUB_TRACE(BPM_FETCH, static_cast<uint64_t>(page_id), 1);
+      return &pages_[frame_id];
+    }
+    // The frame was victimized (or reused) in between; undo the pin and take the slow path.
+    pages_[frame_id].pin_count_.fetch_sub(1);
   }
-  pages_[replaced].RLatch();
-  // TODO: just for test
-//  auto replace_page_id = pages_[replaced].GetPageId();
-  auto replace_page_id = frame_table_[replaced];
-  if (pages_[replaced].IsDirty()) {
-    disk_manager_->WritePage(replace_page_id, pages_[replaced].GetData());
+
+  auto wait_start = std::chrono::steady_clock::now();
+  std::lock_guard lock(latch_);
+  pin_wait_time_us_.fetch_add(ElapsedUs(wait_start), std::memory_order_relaxed);
+  if (page_table_.Find(page_id, &frame_id)) {
+    num_hits_.fetch_add(1, std::memory_order_relaxed);
+    BUSTUB_TRACE(BPM_FETCH, static_cast<uint64_t>(page_id), 1);
+    pages_[frame_id].pin_count_.fetch_add(1);
+    // A re-read page has proven itself; it no longer counts as bulk-load churn.
+    bulk_frames_[frame_id] = false;
+    replacer_->Pin(frame_id);
+    return &pages_[frame_id];
   }
-  pages_[replaced].RUnlatch();
-  // update page_table_
-  auto replace_it = page_table_.find(replace_page_id);
-  if (replace_it != page_table_.end()) {
-    page_table_.erase(replace_it);
+  num_misses_.fetch_add(1, std::memory_order_relaxed);
+  replacer_->RecordMiss(page_id);
+  BUSTUB_TRACE(BPM_FETCH, static_cast<uint64_t>(page_id), 0);
+  if (!AcquireFrame(&frame_id)) {
+    // Real starvation: nothing came free within the retry budget.
+    return nullptr;
   }
-  // update page_table_
-  page_table_[page_id] = replaced;
-  frame_table_[replaced] = page_id;
+  page_table_.Insert(page_id, frame_id);
+  frame_table_[frame_id] = page_id;
+  pages_[frame_id].page_id_ = page_id;
+  pages_[frame_id].pin_count_.fetch_add(1 - FRAME_CLAIM_PINS);  // claim -> one real pin, stray pins preserved
+  bulk_frames_[frame_id] = bulk_pin_mode_.load(std::memory_order_relaxed);
+  pages_[frame_id].WLatch();
+  disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
+  pages_[frame_id].WUnlatch();
+  return &pages_[frame_id];
+}
 
-  pages_[replaced].WLatch();
-//  pages_[replaced]
-  disk_manager_->ReadPage(page_id, pages_[replaced].GetData());
-  pages_[replaced].WUnlatch();
-  return &pages_[replaced];
+void BufferPoolManager::FetchPages(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) {
+  std::lock_guard lock(latch_);
+  pages->clear();
+  pages->reserve(page_ids.size());
 
-//  return nullptr;
+  // (page id, destination frame data) pairs handed to the disk manager as one batch.
+  std::vector<std::pair<page_id_t, char *>> misses;
+  for (auto page_id : page_ids) {
+    frame_id_t frame_id;
+    if (page_table_.Find(page_id, &frame_id)) {
+      num_hits_.fetch_add(1, std::memory_order_relaxed);
+      pages_[frame_id].pin_count_.fetch_add(1);
+      bulk_frames_[frame_id] = false;
+      replacer_->Pin(frame_id);
+      pages->push_back(&pages_[frame_id]);
+      continue;
+    }
+    num_misses_.fetch_add(1, std::memory_order_relaxed);
+    replacer_->RecordMiss(page_id);
+    if (!AcquireFrame(&frame_id)) {
+      pages->push_back(nullptr);
+      continue;
+    }
+    page_table_.Insert(page_id, frame_id);
+    frame_table_[frame_id] = page_id;
+    pages_[frame_id].page_id_ = page_id;
+    pages_[frame_id].pin_count_.fetch_add(1 - FRAME_CLAIM_PINS);  // claim -> one real pin, stray pins preserved
+    bulk_frames_[frame_id] = bulk_pin_mode_.load(std::memory_order_relaxed);
+    misses.emplace_back(page_id, pages_[frame_id].GetData());
+    pages->push_back(&pages_[frame_id]);
+  }
+
+  if (!misses.empty()) {
+    disk_manager_->ReadPages(&misses);
+  }
 }
 
-// TODO: dirty needs write to WritePage ?
 bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
-  std::lock_guard lock(latch_);
-  auto page_it = page_table_.find(page_id);
-  if (page_it == page_table_.end()) {
+  BUSTUB_TRACE(BPM_UNPIN, static_cast<uint64_t>(page_id), static_cast<uint64_t>(is_dirty));
+  // Unpin is the single most frequent pool call and never needs the pool latch: the mapping
+  // probe is the same lock-free probe the fetch fast path uses, and the caller still holds its
+  // pin across it, so the frame cannot be victimized underneath us.
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
     return false;
   }
+  // Set the dirty bit while the pin is still held -- the same argument as MarkPageDirty:
+  // eviction only recycles unpinned frames, and the flush paths clear the bit before reading
+  // the bytes they write, so a store here either reaches this write-back or survives it for
+  // the next one. The write-back itself stays off the critical path.
   if (is_dirty) {
-    disk_manager_->WritePage(page_id, pages_[page_it->second].GetData());
+    pages_[frame_id].is_dirty_ = true;
+  }
+  // Guarded decrement, so a stray unpin cannot take the count negative.
+  int pins = pages_[frame_id].pin_count_.load(std::memory_order_relaxed);
+  do {
+    if (pins <= 0) {
+      return false;
+    }
+  } while (!pages_[frame_id].pin_count_.compare_exchange_weak(pins, pins - 1));
+  // The frame only becomes a replacement candidate once the last pin is gone. Frames filled
+  // during a bulk operation go to the front of the victim queue instead of the clock sweep.
+  // Both replacer paths are safe without the pool latch (clock is a single atomic slot write,
+  // LRU-K takes its own latch); EvictVictim already tolerates a frame that gets re-pinned
+  // between this notification and its decision.
+  if (pins == 1) {
+    if (bulk_frames_[frame_id] != 0) {
+      replacer_->UnpinForReuse(frame_id);
+    } else {
+      replacer_->Unpin(frame_id);
+    }
   }
-  replacer_->Unpin(page_it->second);
+  return true;
+}
+
+bool BufferPoolManager::MarkPageDirty(page_id_t page_id) {
+  // The caller holds a pin, so the mapping cannot be victimized out from under the lock-free
+  // probe; the flush paths clear the dirty bit before reading the bytes they write, so this
+  // store either reaches the in-flight write-back or survives it for the next one.
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    return false;
+  }
+  pages_[frame_id].is_dirty_ = true;
   return true;
 }
 
 bool BufferPoolManager::FlushPageImpl(page_id_t page_id) {
   // Make sure you call DiskManager::WritePage!
   std::lock_guard lock(latch_);
-  auto page_it = page_table_.find(page_id);
-  if (page_it == page_table_.end()) {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
     return false;
   }
-  pages_[page_it->second].RLatch();
-  disk_manager_->WritePage(page_id, pages_[page_it->second].GetData());
-  pages_[page_it->second].RUnlatch();
+  EnsureLogDurable(frame_id);
+  // Clear-then-write, like FlushDirtyPages: a concurrent re-dirty must outlive this flush.
+  pages_[frame_id].is_dirty_ = false;
+  pages_[frame_id].RLatch();
+  disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
+  pages_[frame_id].RUnlatch();
   return true;
 }
 
@@ -131,40 +510,35 @@ Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
   std::lock_guard lock(latch_);
-  if (!free_list_.empty()) {
-    auto free_frame_id = free_list_.front();
-    free_list_.pop_front();
-    auto new_page_id = disk_manager_->AllocatePage();
-    *page_id = new_page_id;
-    page_table_[new_page_id]= free_frame_id;
-    frame_table_[free_frame_id] = new_page_id;
-    return &pages_[free_frame_id];
-  }
-  if (replacer_->Size() > 0) {
-    frame_id_t replaced_frame_id;
-    auto ret = replacer_->Victim(&replaced_frame_id);
-    if (ret) {
-      pages_[replaced_frame_id].RLatch();
-      // TODO: just for pass the test
-      auto replaced_page_id = frame_table_[replaced_frame_id];
-//      auto replaced_page_id = pages_[replaced_frame_id].GetPageId();
-      // dirty page write to disk
-      if (pages_[replaced_frame_id].IsDirty()) {
-        disk_manager_->WritePage(replaced_page_id, pages_[replaced_frame_id].GetData());
-      }
-      // TODO: no need to deallocate page
-//      disk_manager_->DeallocatePage(pages_[replaced_frame_id].GetPageId());
-      pages_[replaced_frame_id].RUnlatch();
-      // NOTE: important rm victim page from page_table
-      page_table_.erase(replaced_page_id);
-      auto new_page_id = disk_manager_->AllocatePage();
-      *page_id = new_page_id;
-      page_table_[new_page_id]= replaced_frame_id;
-      frame_table_[replaced_frame_id] = new_page_id;
-      return &pages_[replaced_frame_id];
+  frame_id_t frame_id;
+  if (!AcquireFrame(&frame_id)) {
+    return nullptr;
+  }
+  auto new_page_id = AllocatePageId();
+  // A speculative readahead may have pulled this id in before it was ever allocated (or while
+  // it sat on the disk manager's free list); that frame holds stale bytes and must not shadow
+  // the new page. Nothing but the prefetcher can name an unallocated id, so at worst we wait
+  // out its transient pin. The frame leaves the replacer before rejoining the free list.
+  frame_id_t stale_frame;
+  if (page_table_.Find(new_page_id, &stale_frame)) {
+    while (pages_[stale_frame].GetPinCount() > 0) {
+      std::this_thread::yield();
     }
+    page_table_.Remove(new_page_id);
+    replacer_->Pin(stale_frame);
+    pages_[stale_frame].page_id_ = INVALID_PAGE_ID;
+    pages_[stale_frame].is_dirty_ = false;
+    frame_table_.erase(stale_frame);
+    free_list_.push_back(stale_frame);
   }
-  return nullptr;
+  *page_id = new_page_id;
+  page_table_.Insert(new_page_id, frame_id);
+  frame_table_[frame_id] = new_page_id;
+  pages_[frame_id].page_id_ = new_page_id;
+  pages_[frame_id].pin_count_.fetch_add(1 - FRAME_CLAIM_PINS);  // claim -> one real pin, stray pins preserved
+  bulk_frames_[frame_id] = bulk_pin_mode_.load(std::memory_order_relaxed);
+  BUSTUB_TRACE(BPM_NEW_PAGE, static_cast<uint64_t>(new_page_id), 0);
+  return &pages_[frame_id];
 }
 
 bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
@@ -175,33 +549,67 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
 
   std::lock_guard lock(latch_);
-  auto page_it = page_table_.find(page_id);
-  if (page_it == page_table_.end()) {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
     // not found in page table
     return true;
   }
-  auto frame_id = page_it->second;
-  pages_[frame_id].WLatch();
+  // Remove the mapping before the pin check so a concurrent fast-path re-pin is noticed by its
+  // re-validation probe, exactly like EvictVictim.
+  page_table_.Remove(page_id);
   if (pages_[frame_id].GetPinCount() > 0) {
+    page_table_.Insert(page_id, frame_id);
     return false;
   }
   disk_manager_->DeallocatePage(page_id);
+  pages_[frame_id].WLatch();
   // TODO: necessary ResetMemory?
   pages_[frame_id].ResetMemory();
   pages_[frame_id].WUnlatch();
-  page_table_.erase(page_it);
+  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+  pages_[frame_id].is_dirty_ = false;
   frame_table_.erase(frame_id);
   free_list_.push_back(frame_id);
   return true;
 }
 
+page_id_t BufferPoolManager::AllocatePageId() {
+  if (num_instances_ == 1) {
+    return disk_manager_->AllocatePage();
+  }
+  // Strided allocation keeps page_id % num_instances_ == instance_index_ so a router can
+  // find the owning instance without a shared mapping table.
+  return next_page_id_.fetch_add(static_cast<page_id_t>(num_instances_));
+}
+
 void BufferPoolManager::FlushAllPagesImpl() {
   // You can do it!
   std::lock_guard lock(latch_);
-  for (auto it: page_table_) {
-    pages_[it.second].RLatch();
-    disk_manager_->WritePage(it.first, pages_[it.second].GetData());
-    pages_[it.second].RUnlatch();
+  // Collect the dirty frames and hand them to the disk manager as one batch: it sorts them by
+  // on-disk position and coalesces adjacent pages, so a checkpoint writes large sequential
+  // runs instead of one random single-page write per frame. Clean frames already match disk
+  // and are skipped outright.
+  std::vector<std::pair<page_id_t, frame_id_t>> dirty;
+  page_table_.ForEach([this, &dirty](page_id_t page_id, frame_id_t frame_id) {
+    if (pages_[frame_id].is_dirty_) {
+      dirty.emplace_back(page_id, frame_id);
+    }
+  });
+  std::vector<std::pair<page_id_t, const char *>> requests;
+  requests.reserve(dirty.size());
+  for (const auto &[page_id, frame_id] : dirty) {
+    EnsureLogDurable(frame_id);
+    // Clear-then-write, like FlushDirtyPages: the bit drops before the batch reads the bytes,
+    // so a re-dirty that races the batched write survives for the next flush.
+    pages_[frame_id].is_dirty_ = false;
+    pages_[frame_id].RLatch();
+    requests.emplace_back(page_id, pages_[frame_id].GetData());
+  }
+  if (!requests.empty()) {
+    disk_manager_->WritePages(&requests);
+  }
+  for (const auto &[page_id, frame_id] : dirty) {
+    pages_[frame_id].RUnlatch();
   }
 }
 
@@ -11,88 +11,59 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/clock_replacer.h"
-#include "common/logger.h"
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {
-  max_num_pages_ = num_pages;
-  header_ = list_.end();
+ClockReplacer::ClockReplacer(size_t num_pages) : state_(num_pages), num_pages_(num_pages) {
+  // std::atomic's default constructor leaves the value indeterminate before C++20.
+  for (auto &state : state_) {
+    state.store(ABSENT, std::memory_order_relaxed);
+  }
 }
 
 ClockReplacer::~ClockReplacer() = default;
 
+/*
+ * Sweep the hand over the frame array: a REFERENCED frame loses its second chance, a READY frame
+ * is claimed with a compare-exchange (which also races correctly against a concurrent Pin). Two
+ * full revolutions are enough to downgrade every reference bit and then take a frame; if both
+ * come up empty the replacer held nothing evictable.
+ */
 bool ClockReplacer::Victim(frame_id_t *frame_id) {
-  std::lock_guard lock(mu_);
-  if (list_.empty() || header_ == list_.end()) {
-    return false;
-  }
-  auto it = header_;
-  // circular list
-  while (true) {
-    if (list_.empty() || ref_.empty()) {
-      return false;
-    }
-    auto ref_it = ref_.find(*it);
-    if (ref_it != ref_.end()) {
-      // ref flag is false
-      if (!ref_it->second) {
-        *frame_id = *it;
-        // update header
-        auto tmp = it;
-        header_ = ++it;
-        list_.erase(tmp);
-        // NOTE: important
-        ref_.erase(ref_it);
-        return true;
-      } else {
-        // flip true to false
-        ref_[*it] = false;
-      }
-    }
-    it++;
-    if (it == list_.end()) {
-      it = list_.begin();
+  for (size_t step = 0; step < 2 * num_pages_; step++) {
+    size_t idx = hand_.fetch_add(1, std::memory_order_relaxed) % num_pages_;
+    uint8_t expected = state_[idx].load(std::memory_order_relaxed);
+    if (expected == REFERENCED) {
+      state_[idx].compare_exchange_strong(expected, READY, std::memory_order_relaxed);
+    } else if (expected == READY &&
+               state_[idx].compare_exchange_strong(expected, ABSENT, std::memory_order_relaxed)) {
+      *frame_id = static_cast<frame_id_t>(idx);
+      return true;
     }
   }
+  return false;
 }
 
-void ClockReplacer::Pin(frame_id_t frame_id) {
-  std::lock_guard lock(mu_);
-  if (*header_ == frame_id) {
-    auto it = header_;
-    header_++;
-    list_.erase(it);
-    auto ref_it = ref_.find(frame_id);
-    if (ref_it != ref_.end()) {
-      ref_.erase(ref_it);
-    }
-    return;
-  }
-  auto it = ref_.find(frame_id);
-  if (it != ref_.end()) {
-    list_.remove_if([frame_id](frame_id_t id) { return frame_id == id;});
-    ref_.erase(it);
-  }
-}
+void ClockReplacer::Pin(frame_id_t frame_id) { state_[frame_id].store(ABSENT, std::memory_order_relaxed); }
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {
-  std::lock_guard lock(mu_);
-  auto ref_it = ref_.find(frame_id);
-  if (ref_it != ref_.end()) {
-    // already in the replacer
-    return;
-  }
-  list_.push_back(frame_id);
-  ref_[frame_id] = false;
-  if (header_ == list_.end()) {
-    header_ = list_.begin();
-  }
+void ClockReplacer::Unpin(frame_id_t frame_id) { state_[frame_id].store(REFERENCED, std::memory_order_relaxed); }
+
+/*
+ * Skip the second chance: the frame was filled by a bulk operation and should go back out before
+ * the regular working set does.
+ */
+void ClockReplacer::UnpinForReuse(frame_id_t frame_id) {
+  state_[frame_id].store(READY, std::memory_order_relaxed);
 }
 
 size_t ClockReplacer::Size() {
-  std::lock_guard lock(mu_);
-  return list_.size();
+  size_t count = 0;
+  for (const auto &state : state_) {
+    if (state.load(std::memory_order_relaxed) != ABSENT) {
+      count++;
+    }
+  }
+  return count;
 }
 
 }  // namespace bustub
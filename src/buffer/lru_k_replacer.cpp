@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k) : max_num_pages_(num_pages), k_(k) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  auto &info = frames_[frame_id];
+  info.history_.push_back(current_timestamp_++);
+  if (info.history_.size() > k_) {
+    info.history_.pop_front();
+  }
+}
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard lock(mu_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  bool found = false;
+  bool victim_inf = false;
+  size_t victim_oldest = 0;
+  frame_id_t victim = INVALID_PAGE_ID;
+  for (auto &[id, info] : frames_) {
+    if (!info.evictable_) {
+      continue;
+    }
+    // Fewer than k accesses means an infinite backward k-distance: such frames are preferred,
+    // ties (and ties among full histories) broken by the oldest recorded access.
+    bool inf = info.history_.size() < k_;
+    size_t oldest = info.history_.front();
+    if (!found || (inf && !victim_inf) || (inf == victim_inf && oldest < victim_oldest)) {
+      found = true;
+      victim_inf = inf;
+      victim_oldest = oldest;
+      victim = id;
+    }
+  }
+  if (!found) {
+    return false;
+  }
+  frames_.erase(victim);
+  curr_size_--;
+  *frame_id = victim;
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard lock(mu_);
+  RecordAccess(frame_id);
+  auto &info = frames_[frame_id];
+  if (info.evictable_) {
+    info.evictable_ = false;
+    curr_size_--;
+  }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard lock(mu_);
+  RecordAccess(frame_id);
+  auto &info = frames_[frame_id];
+  if (!info.evictable_) {
+    info.evictable_ = true;
+    curr_size_++;
+  }
+}
+
+size_t LRUKReplacer::Size() {
+  std::lock_guard lock(mu_);
+  return curr_size_;
+}
+
+}  // namespace bustub
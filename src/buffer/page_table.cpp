@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+namespace bustub {
+
+PageTable::PageTable(size_t num_frames) {
+  // Keep the load factor at or below 25% so linear probe sequences stay short.
+  capacity_ = 16;
+  while (capacity_ < num_frames * 4) {
+    capacity_ <<= 1;
+  }
+  slots_ = std::make_unique<Slot[]>(capacity_);
+}
+
+bool PageTable::Find(page_id_t page_id, frame_id_t *frame_id) const {
+  size_t idx = IndexOf(page_id);
+  for (size_t probe = 0; probe < capacity_; ++probe, idx = (idx + 1) & (capacity_ - 1)) {
+    page_id_t key = slots_[idx].page_id_.load(std::memory_order_acquire);
+    if (key == EMPTY_KEY) {
+      return false;
+    }
+    if (key == page_id) {
+      *frame_id = slots_[idx].frame_id_.load(std::memory_order_acquire);
+      return true;
+    }
+  }
+  return false;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  size_t idx = IndexOf(page_id);
+  size_t target = capacity_;
+  for (size_t probe = 0; probe < capacity_; ++probe, idx = (idx + 1) & (capacity_ - 1)) {
+    page_id_t key = slots_[idx].page_id_.load(std::memory_order_acquire);
+    if (key == page_id) {
+      slots_[idx].frame_id_.store(frame_id, std::memory_order_release);
+      return;
+    }
+    if (key == TOMBSTONE_KEY && target == capacity_) {
+      target = idx;
+    }
+    if (key == EMPTY_KEY) {
+      if (target == capacity_) {
+        target = idx;
+      }
+      break;
+    }
+  }
+  // The frame id is published before the key so a concurrent probe that matches the key never
+  // reads a stale frame id.
+  slots_[target].frame_id_.store(frame_id, std::memory_order_release);
+  slots_[target].page_id_.store(page_id, std::memory_order_release);
+  size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PageTable::Remove(page_id_t page_id) {
+  size_t idx = IndexOf(page_id);
+  for (size_t probe = 0; probe < capacity_; ++probe, idx = (idx + 1) & (capacity_ - 1)) {
+    page_id_t key = slots_[idx].page_id_.load(std::memory_order_acquire);
+    if (key == EMPTY_KEY) {
+      return;
+    }
+    if (key == page_id) {
+      slots_[idx].page_id_.store(TOMBSTONE_KEY, std::memory_order_release);
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+void PageTable::ForEach(const std::function<void(page_id_t, frame_id_t)> &fn) const {
+  for (size_t idx = 0; idx < capacity_; ++idx) {
+    page_id_t key = slots_[idx].page_id_.load(std::memory_order_acquire);
+    if (key != EMPTY_KEY && key != TOMBSTONE_KEY) {
+      fn(key, slots_[idx].frame_id_.load(std::memory_order_acquire));
+    }
+  }
+}
+
+}  // namespace bustub
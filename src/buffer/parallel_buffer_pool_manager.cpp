@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <memory>
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(uint32_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, LogManager *log_manager)
+    : BufferPoolManager(disk_manager, num_instances * pool_size), num_instances_(num_instances), next_instance_(0) {
+  instances_.reserve(num_instances_);
+  for (uint32_t i = 0; i < num_instances_; ++i) {
+    instances_.emplace_back(std::make_unique<BufferPoolManager>(pool_size, num_instances_, i, disk_manager,
+                                                                log_manager));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() { StopFlushThread(); }
+
+BufferPoolManager *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
+  return instances_[static_cast<uint32_t>(page_id) % num_instances_].get();
+}
+
+void ParallelBufferPoolManager::FetchPages(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) {
+  pages->assign(page_ids.size(), nullptr);
+  // Group the requests per shard so every instance takes its latch (and batches its reads) once.
+  std::vector<std::vector<size_t>> shard_requests(num_instances_);
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    shard_requests[static_cast<uint32_t>(page_ids[i]) % num_instances_].push_back(i);
+  }
+  std::vector<page_id_t> shard_ids;
+  std::vector<Page *> shard_pages;
+  for (uint32_t shard = 0; shard < num_instances_; ++shard) {
+    if (shard_requests[shard].empty()) {
+      continue;
+    }
+    shard_ids.clear();
+    for (auto i : shard_requests[shard]) {
+      shard_ids.push_back(page_ids[i]);
+    }
+    instances_[shard]->FetchPages(shard_ids, &shard_pages);
+    for (size_t j = 0; j < shard_requests[shard].size(); ++j) {
+      (*pages)[shard_requests[shard][j]] = shard_pages[j];
+    }
+  }
+}
+
+Page *ParallelBufferPoolManager::FetchPageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id);
+}
+
+bool ParallelBufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+bool ParallelBufferPoolManager::MarkPageDirty(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->MarkPageDirty(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPageImpl(page_id_t *page_id) {
+  // Start each NewPage call at a different instance so new pages spread across the shards, and
+  // fall through to the next instance when one shard has no evictable frame left.
+  uint32_t start = next_instance_.fetch_add(1) % num_instances_;
+  for (uint32_t i = 0; i < num_instances_; ++i) {
+    Page *page = instances_[(start + i) % num_instances_]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+bool ParallelBufferPoolManager::DeletePageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPagesImpl() {
+  for (auto &instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+void ParallelBufferPoolManager::PrefetchPage(page_id_t page_id) { GetBufferPoolManager(page_id)->PrefetchPage(page_id); }
+
+BufferPoolManager::Stats ParallelBufferPoolManager::GetStats() {
+  Stats stats;
+  for (auto &instance : instances_) {
+    Stats instance_stats = instance->GetStats();
+    stats.hits_ += instance_stats.hits_;
+    stats.misses_ += instance_stats.misses_;
+    stats.evictions_ += instance_stats.evictions_;
+    stats.dirty_writebacks_ += instance_stats.dirty_writebacks_;
+    stats.pin_wait_time_us_ += instance_stats.pin_wait_time_us_;
+    stats.frame_waits_ += instance_stats.frame_waits_;
+    stats.frame_wait_failures_ += instance_stats.frame_wait_failures_;
+    stats.replacer_ghost_hits_ += instance_stats.replacer_ghost_hits_;
+    stats.replacer_policy_switches_ += instance_stats.replacer_policy_switches_;
+  }
+  return stats;
+}
+
+void ParallelBufferPoolManager::RunFlushThread() {
+  for (auto &instance : instances_) {
+    instance->RunFlushThread();
+  }
+  // The shards only flush their own frames; the aggregated warm set is dumped here.
+  if (!warm_set_running_.exchange(true)) {
+    warm_set_thread_ = new std::thread([this] {
+      while (warm_set_running_) {
+        {
+          std::unique_lock lock(warm_set_latch_);
+          warm_set_cv_.wait_for(lock, dirty_flush_interval, [this] { return !warm_set_running_; });
+        }
+        if (warm_set_running_) {
+          SaveWarmSet();
+        }
+      }
+    });
+  }
+}
+
+void ParallelBufferPoolManager::StopFlushThread() {
+  for (auto &instance : instances_) {
+    instance->StopFlushThread();
+  }
+  if (warm_set_running_.exchange(false)) {
+    warm_set_cv_.notify_all();
+    warm_set_thread_->join();
+    delete warm_set_thread_;
+    warm_set_thread_ = nullptr;
+  }
+}
+
+void ParallelBufferPoolManager::SetBulkPinMode(bool enabled) {
+  for (auto &instance : instances_) {
+    instance->SetBulkPinMode(enabled);
+  }
+}
+
+std::vector<page_id_t> ParallelBufferPoolManager::GetResidentPageIds() {
+  std::vector<page_id_t> page_ids;
+  for (auto &instance : instances_) {
+    auto instance_ids = instance->GetResidentPageIds();
+    page_ids.insert(page_ids.end(), instance_ids.begin(), instance_ids.end());
+  }
+  return page_ids;
+}
+
+std::vector<page_id_t> ParallelBufferPoolManager::GetDirtyPageIds() {
+  std::vector<page_id_t> page_ids;
+  for (auto &instance : instances_) {
+    auto instance_ids = instance->GetDirtyPageIds();
+    page_ids.insert(page_ids.end(), instance_ids.begin(), instance_ids.end());
+  }
+  return page_ids;
+}
+
+}  // namespace bustub
@@ -12,12 +12,81 @@
 
 #include "catalog/schema.h"
 
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace bustub {
 
+namespace {
+/**
+ * The process-wide schema intern pool: one canonical Schema per distinct projected column
+ * vector, keyed by content hash with chained equality checks. Interned schemas live until
+ * process exit, which is what lets every holder treat the pointer as stable.
+ */
+struct SchemaInterner {
+  std::mutex latch_;
+  std::unordered_map<size_t, std::vector<std::unique_ptr<Schema>>> buckets_;
+};
+
+SchemaInterner &Interner() {
+  static SchemaInterner interner;
+  return interner;
+}
+
+/** Folds one column into a running hash; expressions hash by identity, like they compare. */
+size_t HashColumn(size_t hash, const Column &col) {
+  constexpr size_t PRIME = 1099511628211ULL;
+  hash = (hash ^ static_cast<size_t>(col.GetType())) * PRIME;
+  hash = (hash ^ col.GetLength()) * PRIME;
+  hash = (hash ^ std::hash<std::string>{}(col.GetName())) * PRIME;
+  return (hash ^ std::hash<const void *>{}(col.GetExpr())) * PRIME;
+}
+
+/** @return true when the columns match in everything but their recomputed offset */
+bool SameColumn(const Column &lhs, const Column &rhs) {
+  return lhs.GetType() == rhs.GetType() && lhs.GetLength() == rhs.GetLength() && lhs.GetExpr() == rhs.GetExpr() &&
+         lhs.GetName() == rhs.GetName();
+}
+}  // namespace
+
+Schema *Schema::CopySchema(const Schema *from, const std::vector<uint32_t> &attrs) {
+  // Hash and compare straight against the source columns, so the hit path allocates nothing.
+  size_t hash = attrs.size();
+  for (uint32_t i : attrs) {
+    hash = HashColumn(hash, from->columns_[i]);
+  }
+  SchemaInterner &interner = Interner();
+  std::lock_guard lock(interner.latch_);
+  auto &bucket = interner.buckets_[hash];
+  for (const auto &candidate : bucket) {
+    if (candidate->GetColumnCount() != attrs.size()) {
+      continue;
+    }
+    bool match = true;
+    for (uint32_t i = 0; i < attrs.size(); i++) {
+      if (!SameColumn(candidate->columns_[i], from->columns_[attrs[i]])) {
+        match = false;
+        break;
+      }
+    }
+    if (match) {
+      return candidate.get();
+    }
+  }
+  std::vector<Column> cols;
+  cols.reserve(attrs.size());
+  for (const auto i : attrs) {
+    cols.emplace_back(from->columns_[i]);
+  }
+  bucket.push_back(std::make_unique<Schema>(cols));
+  return bucket.back().get();
+}
+
 Schema::Schema(const std::vector<Column> &columns) : tuple_is_inlined_(true) {
   uint32_t curr_offset = 0;
   for (uint32_t index = 0; index < columns.size(); index++) {
@@ -1,9 +1,13 @@
 #include "catalog/table_generator.h"
 
 #include <algorithm>
+#include <cmath>
+#include <memory>
 #include <random>
 #include <vector>
 
+#include "common/thread_pool.h"
+
 namespace bustub {
 
 template <typename CppType>
@@ -16,7 +20,66 @@ std::vector<Value> TableGenerator::GenNumericValues(ColumnInsertMeta *col_meta,
     }
     return values;
   }
+  if (col_meta->dist_ == Dist::Cluster) {
+    // Runs of duplicates: the value steps every cluster_run_ rows and wraps at the
+    // cardinality, so equal keys sit on consecutive rows like time-correlated data.
+    uint64_t cardinality = col_meta->max_ - col_meta->min_ + 1;
+    for (uint32_t i = 0; i < count; i++) {
+      uint64_t v = col_meta->min_ + (col_meta->serial_counter_ / col_meta->cluster_run_) % cardinality;
+      values.emplace_back(Value(col_meta->type_, static_cast<CppType>(v)));
+      col_meta->serial_counter_ += 1;
+    }
+    return values;
+  }
   std::default_random_engine generator;
+  if (col_meta->dist_ != Dist::Uniform) {
+    // The Zipf variants, by Gray et al.'s quantile method: rank 1 is the hottest value and
+    // maps to min_. zeta(n) is the one O(n) part, cached until the cardinality changes.
+    double theta;
+    switch (col_meta->dist_) {
+      case Dist::Zipf_50:
+        theta = 0.5;
+        break;
+      case Dist::Zipf_75:
+        theta = 0.75;
+        break;
+      case Dist::Zipf_95:
+        theta = 0.95;
+        break;
+      default:
+        theta = 0.99;
+        break;
+    }
+    uint64_t n = col_meta->max_ - col_meta->min_ + 1;
+    if (col_meta->zipf_zeta_for_ != n) {
+      double zeta = 0;
+      for (uint64_t i = 1; i <= n; i++) {
+        zeta += 1.0 / std::pow(static_cast<double>(i), theta);
+      }
+      col_meta->zipf_zeta_n_ = zeta;
+      col_meta->zipf_zeta_for_ = n;
+    }
+    double zeta_n = col_meta->zipf_zeta_n_;
+    double zeta_2 = 1.0 + std::pow(0.5, theta);
+    double alpha = 1.0 / (1.0 - theta);
+    double eta = (1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - zeta_2 / zeta_n);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (uint32_t i = 0; i < count; i++) {
+      double u = uniform(generator);
+      double uz = u * zeta_n;
+      uint64_t rank;
+      if (uz < 1.0) {
+        rank = 1;
+      } else if (uz < zeta_2) {
+        rank = 2;
+      } else {
+        rank = 1 + static_cast<uint64_t>(static_cast<double>(n) * std::pow(eta * u - eta + 1.0, alpha));
+      }
+      rank = std::min(rank, n);
+      values.emplace_back(Value(col_meta->type_, static_cast<CppType>(col_meta->min_ + rank - 1)));
+    }
+    return values;
+  }
   // TODO(Amadou): Break up in two branches if this is too weird.
   std::conditional_t<std::is_integral_v<CppType>, std::uniform_int_distribution<CppType>,
                      std::uniform_real_distribution<CppType>>
@@ -46,6 +109,17 @@ std::vector<Value> TableGenerator::MakeValues(ColumnInsertMeta *col_meta, uint32
 }
 
 void TableGenerator::FillTable(TableMetadata *info, TableInsertMeta *table_meta) {
+  // The generated pages are written once and rarely re-read; keep them out of the regular
+  // clock sweep so filling a big test table does not evict everything else.
+  exec_ctx_->GetBufferPoolManager()->SetBulkPinMode(true);
+  // A big fixture is generated and written in parallel: each worker builds its own run of
+  // pages with no latch contention, and the runs are linked into one chain at the end.
+  if (table_meta->num_rows_ >= PARALLEL_LOAD_THRESHOLD && exec_ctx_->GetThreadPool()->Size() > 1) {
+    ParallelFillTable(info, table_meta);
+    exec_ctx_->GetBufferPoolManager()->SetBulkPinMode(false);
+    LOG_INFO("Wrote %d tuples to table %s.", table_meta->num_rows_, table_meta->name_);
+    return;
+  }
   uint32_t num_inserted = 0;
   uint32_t batch_size = 128;
   while (num_inserted < table_meta->num_rows_) {
@@ -67,9 +141,93 @@ void TableGenerator::FillTable(TableMetadata *info, TableInsertMeta *table_meta)
     }
     // exec_ctx_->GetBufferPoolManager()->FlushAllPages();
   }
+  exec_ctx_->GetBufferPoolManager()->SetBulkPinMode(false);
   LOG_INFO("Wrote %d tuples to table %s.", num_inserted, table_meta->name_);
 }
 
+void TableGenerator::ParallelFillTable(TableMetadata *info, TableInsertMeta *table_meta) {
+  ThreadPool *pool = exec_ctx_->GetThreadPool();
+  // Enough workers that each gets a meaningful partition, never more than the pool can run.
+  auto num_workers = static_cast<uint32_t>(
+      std::min<size_t>(pool->Size(), (table_meta->num_rows_ + PARALLEL_LOAD_THRESHOLD - 1) / PARALLEL_LOAD_THRESHOLD));
+  uint32_t rows_per_worker = table_meta->num_rows_ / num_workers;
+  std::vector<std::unique_ptr<TableHeap>> partitions(num_workers);
+  TaskGroup group(pool);
+  for (uint32_t w = 0; w < num_workers; w++) {
+    uint32_t start = w * rows_per_worker;
+    uint32_t end = w + 1 == num_workers ? table_meta->num_rows_ : start + rows_per_worker;
+    group.Submit([this, info, table_meta, &partitions, w, start, end] {
+      // Worker-local column metadata: serial columns resume at the partition's first row, so
+      // the linked table carries the same globally serial values as a single-threaded load.
+      std::vector<ColumnInsertMeta> col_meta = table_meta->col_meta_;
+      for (auto &col : col_meta) {
+        if (col.dist_ == Dist::Serial || col.dist_ == Dist::Cluster) {
+          col.serial_counter_ += start;
+        }
+      }
+      // A fixture load is not transactional -- nothing ever rolls one back -- so each worker
+      // writes under a throwaway transaction instead of racing the context's write set.
+      Transaction partition_txn{static_cast<txn_id_t>(w)};
+      auto heap =
+          std::make_unique<TableHeap>(exec_ctx_->GetBufferPoolManager(), exec_ctx_->GetLockManager(),
+                                      exec_ctx_->GetLogManager(), &partition_txn, &info->schema_,
+                                      info->table_->GetLayout());
+      uint32_t num_inserted = start;
+      uint32_t batch_size = 128;
+      while (num_inserted < end) {
+        uint32_t num_values = std::min(batch_size, end - num_inserted);
+        std::vector<std::vector<Value>> values;
+        for (auto &col : col_meta) {
+          values.emplace_back(MakeValues(&col, num_values));
+        }
+        std::vector<Tuple> tuples;
+        tuples.reserve(num_values);
+        for (uint32_t i = 0; i < num_values; i++) {
+          std::vector<Value> entry;
+          entry.reserve(values.size());
+          for (const auto &col : values) {
+            entry.emplace_back(col[i]);
+          }
+          tuples.emplace_back(entry, &info->schema_);
+        }
+        std::vector<RID> rids;
+        bool inserted = heap->InsertTuples(tuples, &rids, &partition_txn);
+        BUSTUB_ASSERT(inserted, "Partitioned bulk load cannot fail");
+        num_inserted += num_values;
+      }
+      partitions[w] = std::move(heap);
+    });
+  }
+  group.Wait();
+  // Link the runs onto the table's chain in partition order; row order matches a serial load
+  // page-run by page-run.
+  for (auto &partition : partitions) {
+    info->table_->AppendChain(partition.get());
+  }
+  // The shared metadata's serial counters move past everything the workers generated.
+  for (auto &col : table_meta->col_meta_) {
+    if (col.dist_ == Dist::Serial || col.dist_ == Dist::Cluster) {
+      col.serial_counter_ += table_meta->num_rows_;
+    }
+  }
+}
+
+TableMetadata *TableGenerator::GenerateTable(TableInsertMeta *table_meta) {
+  std::vector<Column> cols{};
+  cols.reserve(table_meta->col_meta_.size());
+  for (const auto &col_meta : table_meta->col_meta_) {
+    if (col_meta.type_ != TypeId::VARCHAR) {
+      cols.emplace_back(col_meta.name_, col_meta.type_);
+    } else {
+      cols.emplace_back(col_meta.name_, col_meta.type_, TEST_VARLEN_SIZE);
+    }
+  }
+  Schema schema(cols);
+  auto info = exec_ctx_->GetCatalog()->CreateTable(exec_ctx_->GetTransaction(), table_meta->name_, schema);
+  FillTable(info, table_meta);
+  return info;
+}
+
 void TableGenerator::GenerateTestTables() {
   /**
    * This array configures each of the test tables. Each able is configured
@@ -105,22 +263,19 @@ void TableGenerator::GenerateTestTables() {
       {"empty_table3",
        0,
        {{"outA", TypeId::INTEGER, false, Dist::Serial, 0, 0}, {"outB", TypeId::INTEGER, false, Dist::Uniform, 0, 9}}},
+
+      // Skewed table: a Zipfian key and clustered duplicates, so hash-join skew and
+      // probe-chain clustering show up in tests the way they do on production keys
+      {"test_skew",
+       TEST1_SIZE,
+       {{"colA", TypeId::INTEGER, false, Dist::Serial, 0, 0},
+        {"colB", TypeId::INTEGER, false, Dist::Zipf_99, 0, 9},
+        {"colC", TypeId::INTEGER, false, Dist::Cluster, 0, 99},
+        {"colD", TypeId::INTEGER, false, Dist::Zipf_50, 0, 9999}}},
   };
 
   for (auto &table_meta : insert_meta) {
-    // Create Schema
-    std::vector<Column> cols{};
-    cols.reserve(table_meta.col_meta_.size());
-    for (const auto &col_meta : table_meta.col_meta_) {
-      if (col_meta.type_ != TypeId::VARCHAR) {
-        cols.emplace_back(col_meta.name_, col_meta.type_);
-      } else {
-        cols.emplace_back(col_meta.name_, col_meta.type_, TEST_VARLEN_SIZE);
-      }
-    }
-    Schema schema(cols);
-    auto info = exec_ctx_->GetCatalog()->CreateTable(exec_ctx_->GetTransaction(), table_meta.name_, schema);
-    FillTable(info, &table_meta);
+    GenerateTable(&table_meta);
   }
 }
 }  // namespace bustub
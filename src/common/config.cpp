@@ -20,4 +20,8 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds dirty_flush_interval = std::chrono::milliseconds(50);
+
+std::chrono::milliseconds checkpoint_poll_interval = std::chrono::milliseconds(50);
+
 }  // namespace bustub
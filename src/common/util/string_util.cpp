@@ -23,8 +23,62 @@
 
 namespace bustub {
 
+namespace {
+
+constexpr uint64_t HIGH_BITS = 0x8080808080808080ULL;
+constexpr uint64_t LOW_BYTES = 0x0101010101010101ULL;
+
+/** @return a word with the high bit set in every byte lane holding an ascii byte in [lo, hi] */
+uint64_t BytesInRange(uint64_t word, char lo, char hi) {
+  // Classic SWAR range test on the low seven bits; the final mask drops non-ascii lanes, whose
+  // own high bit was set in the input word.
+  uint64_t heptets = word & ~HIGH_BITS;
+  uint64_t ge_lo = heptets + (0x80 - static_cast<uint64_t>(lo)) * LOW_BYTES;
+  uint64_t gt_hi = heptets + (0x7F - static_cast<uint64_t>(hi)) * LOW_BYTES;
+  return ge_lo & ~gt_hi & ~word & HIGH_BITS;
+}
+
+}  // namespace
+
 bool StringUtil::Contains(const std::string &haystack, const std::string &needle) {
-  return (haystack.find(needle) != std::string::npos);
+  return Contains(haystack.data(), haystack.size(), needle.data(), needle.size());
+}
+
+bool StringUtil::Contains(const char *haystack, std::size_t haystack_len, const char *needle,
+                          std::size_t needle_len) {
+  if (needle_len == 0) {
+    return true;
+  }
+  return memmem(haystack, haystack_len, needle, needle_len) != nullptr;
+}
+
+void StringUtil::UpperInPlace(char *data, std::size_t len) {
+  std::size_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(uint64_t));
+    // 'a'..'z' differ from 'A'..'Z' only in bit 5 (0x20 = 0x80 >> 2); clear it where set.
+    word &= ~(BytesInRange(word, 'a', 'z') >> 2);
+    memcpy(data + i, &word, sizeof(uint64_t));
+  }
+  for (; i < len; i++) {
+    auto c = static_cast<unsigned char>(data[i]);
+    data[i] = static_cast<char>(static_cast<uint32_t>(c - 'a') < 26U ? c & ~0x20U : c);
+  }
+}
+
+void StringUtil::LowerInPlace(char *data, std::size_t len) {
+  std::size_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(uint64_t));
+    word |= BytesInRange(word, 'A', 'Z') >> 2;
+    memcpy(data + i, &word, sizeof(uint64_t));
+  }
+  for (; i < len; i++) {
+    auto c = static_cast<unsigned char>(data[i]);
+    data[i] = static_cast<char>(static_cast<uint32_t>(c - 'A') < 26U ? c | 0x20U : c);
+  }
 }
 
 void StringUtil::RTrim(std::string *str) {
@@ -132,13 +186,13 @@ std::string StringUtil::Bold(const std::string &str) {
 
 std::string StringUtil::Upper(const std::string &str) {
   std::string copy(str);
-  std::transform(copy.begin(), copy.end(), copy.begin(), [](unsigned char c) { return std::toupper(c); });
+  UpperInPlace(copy.data(), copy.size());
   return (copy);
 }
 
 std::string StringUtil::Lower(const std::string &str) {
   std::string copy(str);
-  std::transform(copy.begin(), copy.end(), copy.begin(), [](unsigned char c) { return std::tolower(c); });
+  LowerInPlace(copy.data(), copy.size());
   return (copy);
 }
 
@@ -12,45 +12,405 @@
 
 #include "concurrency/lock_manager.h"
 
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "common/tracer.h"
+#include "concurrency/transaction_manager.h"
+
 namespace bustub {
 
+bool LockManager::Compatible(LockMode held, LockMode wanted) {
+  switch (held) {
+    case LockMode::INTENTION_SHARED:
+      return wanted != LockMode::EXCLUSIVE;
+    case LockMode::INTENTION_EXCLUSIVE:
+      return wanted == LockMode::INTENTION_SHARED || wanted == LockMode::INTENTION_EXCLUSIVE;
+    case LockMode::SHARED:
+      return wanted == LockMode::INTENTION_SHARED || wanted == LockMode::SHARED;
+    case LockMode::EXCLUSIVE:
+      return false;
+  }
+  return false;
+}
+
+bool LockManager::Covers(LockMode held, LockMode wanted) {
+  switch (held) {
+    case LockMode::EXCLUSIVE:
+      return true;
+    case LockMode::SHARED:
+      return wanted == LockMode::SHARED || wanted == LockMode::INTENTION_SHARED;
+    case LockMode::INTENTION_EXCLUSIVE:
+      return wanted == LockMode::INTENTION_EXCLUSIVE || wanted == LockMode::INTENTION_SHARED;
+    case LockMode::INTENTION_SHARED:
+      return wanted == LockMode::INTENTION_SHARED;
+  }
+  return false;
+}
+
+bool LockManager::CanGrant(LockRequestQueue *queue, std::list<LockRequest>::iterator request) {
+  for (auto it = queue->request_queue_.begin(); it != request; ++it) {
+    if (!Compatible(it->lock_mode_, request->lock_mode_)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void LockManager::WakeGrantable(LockRequestQueue *queue) {
+  for (auto it = queue->request_queue_.begin(); it != queue->request_queue_.end(); ++it) {
+    if (!it->granted_ && CanGrant(queue, it)) {
+      it->cv_.notify_one();
+    }
+  }
+}
+
+void LockManager::WoundYounger(LockRequestQueue *queue, Transaction *txn, LockMode mode) {
+  for (auto &request : queue->request_queue_) {
+    if (request.txn_id_ <= txn->GetTransactionId()) {
+      continue;
+    }
+    if (!Compatible(request.lock_mode_, mode)) {
+      TransactionManager::GetTransaction(request.txn_id_)->SetState(TransactionState::ABORTED);
+      // Only the wounded waiter needs to wake up and notice the abort.
+      request.cv_.notify_one();
+    }
+  }
+}
+
+bool LockManager::WaitForGrant(std::unique_lock<std::mutex> *lock, LockRequestQueue *queue, Transaction *txn,
+                               std::list<LockRequest>::iterator request) {
+  while (txn->GetState() != TransactionState::ABORTED && !CanGrant(queue, request)) {
+    if (Detection()) {
+      // Refresh this waiter's outgoing waits-for edges to match the current queue contents; the
+      // set of blockers shrinks as requests ahead are released or aborted.
+      std::lock_guard graph_lock(latch_);
+      waits_for_[txn->GetTransactionId()].clear();
+      for (auto it = queue->request_queue_.begin(); it != request; ++it) {
+        if (!Compatible(it->lock_mode_, request->lock_mode_)) {
+          AddEdge(txn->GetTransactionId(), it->txn_id_);
+        }
+      }
+    }
+    // Timed wait: a wound or deadlock abort may happen while this transaction is parked on a
+    // different queue's condition variable, so re-check the state periodically.
+    request->cv_.wait_for(*lock, cycle_detection_interval);
+  }
+  if (Detection()) {
+    // Granted or aborted either way, this transaction no longer waits on anyone.
+    std::lock_guard graph_lock(latch_);
+    waits_for_.erase(txn->GetTransactionId());
+  }
+  if (txn->GetState() == TransactionState::ABORTED) {
+    queue->request_queue_.erase(request);
+    WakeGrantable(queue);
+    return false;
+  }
+  request->granted_ = true;
+  return true;
+}
+
 bool LockManager::LockShared(Transaction *txn, const RID &rid) {
+  if (txn->GetState() == TransactionState::ABORTED) {
+    return false;
+  }
+  if (txn->GetState() == TransactionState::SHRINKING) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  auto &shard = Shard(rid);
+  std::unique_lock lock(shard.latch_);
+  auto &queue = shard.lock_table_[rid];
+  queue.request_queue_.emplace_back(txn->GetTransactionId(), LockMode::SHARED);
+  auto request = std::prev(queue.request_queue_.end());
+  if (Prevention()) {
+    WoundYounger(&queue, txn, LockMode::SHARED);
+  }
+  BUSTUB_TRACE_WAIT_START(trace_wait_start);
+  if (!WaitForGrant(&lock, &queue, txn, request)) {
+    return false;
+  }
+  BUSTUB_TRACE_WAIT_END(LOCK_SHARED_WAIT, static_cast<uint64_t>(txn->GetTransactionId()), trace_wait_start);
   txn->GetSharedLockSet()->emplace(rid);
+  txn->RecordLockedRid(rid);
   return true;
 }
 
 bool LockManager::LockExclusive(Transaction *txn, const RID &rid) {
+  if (txn->GetState() == TransactionState::ABORTED) {
+    return false;
+  }
+  if (txn->GetState() == TransactionState::SHRINKING) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  auto &shard = Shard(rid);
+  std::unique_lock lock(shard.latch_);
+  auto &queue = shard.lock_table_[rid];
+  queue.request_queue_.emplace_back(txn->GetTransactionId(), LockMode::EXCLUSIVE);
+  auto request = std::prev(queue.request_queue_.end());
+  if (Prevention()) {
+    WoundYounger(&queue, txn, LockMode::EXCLUSIVE);
+  }
+  BUSTUB_TRACE_WAIT_START(trace_wait_start);
+  if (!WaitForGrant(&lock, &queue, txn, request)) {
+    return false;
+  }
+  BUSTUB_TRACE_WAIT_END(LOCK_EXCLUSIVE_WAIT, static_cast<uint64_t>(txn->GetTransactionId()), trace_wait_start);
   txn->GetExclusiveLockSet()->emplace(rid);
+  txn->RecordLockedRid(rid);
   return true;
 }
 
 bool LockManager::LockUpgrade(Transaction *txn, const RID &rid) {
+  if (txn->GetState() == TransactionState::ABORTED) {
+    return false;
+  }
+  if (txn->GetState() == TransactionState::SHRINKING) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  auto &shard = Shard(rid);
+  std::unique_lock lock(shard.latch_);
+  auto &queue = shard.lock_table_[rid];
+  if (queue.upgrading_) {
+    // Two simultaneous upgraders deadlock on each other's shared lock; abort the second.
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  auto request = std::find_if(queue.request_queue_.begin(), queue.request_queue_.end(),
+                              [txn](const LockRequest &r) { return r.txn_id_ == txn->GetTransactionId(); });
+  if (request == queue.request_queue_.end() || !request->granted_ || request->lock_mode_ != LockMode::SHARED) {
+    return false;
+  }
+  queue.upgrading_ = true;
+  request->lock_mode_ = LockMode::EXCLUSIVE;
+  request->granted_ = false;
+  // Move the request to the front so the upgrade only waits for the remaining shared holders,
+  // not for later arrivals.
+  queue.request_queue_.splice(queue.request_queue_.begin(), queue.request_queue_, request);
+  if (Prevention()) {
+    WoundYounger(&queue, txn, LockMode::EXCLUSIVE);
+  }
+  bool granted = WaitForGrant(&lock, &queue, txn, request);
+  queue.upgrading_ = false;
+  if (!granted) {
+    return false;
+  }
   txn->GetSharedLockSet()->erase(rid);
   txn->GetExclusiveLockSet()->emplace(rid);
+  txn->RecordLockedRid(rid);
+  return true;
+}
+
+bool LockManager::LockTableIntention(Transaction *txn, page_id_t table_id, bool exclusive) {
+  if (txn->GetState() == TransactionState::ABORTED) {
+    return false;
+  }
+  RID table_rid(table_id, TABLE_LOCK_SLOT);
+  LockMode wanted = exclusive ? LockMode::INTENTION_EXCLUSIVE : LockMode::INTENTION_SHARED;
+  auto &shard = Shard(table_rid);
+  std::unique_lock lock(shard.latch_);
+  auto &queue = shard.lock_table_[table_rid];
+  auto request = std::find_if(queue.request_queue_.begin(), queue.request_queue_.end(),
+                              [txn](const LockRequest &r) { return r.txn_id_ == txn->GetTransactionId(); });
+  if (request != queue.request_queue_.end()) {
+    if (request->granted_ && Covers(request->lock_mode_, wanted)) {
+      return true;
+    }
+    // Strengthen the held table-level mode in place, e.g. IS -> IX when a reader starts writing.
+    request->lock_mode_ = wanted;
+    request->granted_ = false;
+    queue.request_queue_.splice(queue.request_queue_.begin(), queue.request_queue_, request);
+  } else {
+    if (txn->GetState() == TransactionState::SHRINKING) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    queue.request_queue_.emplace_back(txn->GetTransactionId(), wanted);
+    request = std::prev(queue.request_queue_.end());
+  }
+  if (Prevention()) {
+    WoundYounger(&queue, txn, wanted);
+  }
+  if (!WaitForGrant(&lock, &queue, txn, request)) {
+    return false;
+  }
+  if (exclusive) {
+    txn->GetExclusiveLockSet()->emplace(table_rid);
+  } else {
+    txn->GetSharedLockSet()->emplace(table_rid);
+  }
+  txn->RecordLockedRid(table_rid);
   return true;
 }
 
+bool LockManager::LockTable(Transaction *txn, page_id_t table_id, bool exclusive) {
+  if (txn->GetState() == TransactionState::ABORTED) {
+    return false;
+  }
+  RID table_rid(table_id, TABLE_LOCK_SLOT);
+  LockMode wanted = exclusive ? LockMode::EXCLUSIVE : LockMode::SHARED;
+  auto &shard = Shard(table_rid);
+  std::unique_lock lock(shard.latch_);
+  auto &queue = shard.lock_table_[table_rid];
+  auto request = std::find_if(queue.request_queue_.begin(), queue.request_queue_.end(),
+                              [txn](const LockRequest &r) { return r.txn_id_ == txn->GetTransactionId(); });
+  if (request != queue.request_queue_.end()) {
+    if (request->granted_ && Covers(request->lock_mode_, wanted)) {
+      return true;
+    }
+    // Escalation: trade the held intention (or shared) lock for the full table lock. Move to the
+    // front so only the current holders are waited on, like LockUpgrade.
+    request->lock_mode_ = wanted;
+    request->granted_ = false;
+    queue.request_queue_.splice(queue.request_queue_.begin(), queue.request_queue_, request);
+  } else {
+    if (txn->GetState() == TransactionState::SHRINKING) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    queue.request_queue_.emplace_back(txn->GetTransactionId(), wanted);
+    request = std::prev(queue.request_queue_.end());
+  }
+  if (Prevention()) {
+    WoundYounger(&queue, txn, wanted);
+  }
+  if (!WaitForGrant(&lock, &queue, txn, request)) {
+    return false;
+  }
+  if (exclusive) {
+    txn->GetSharedLockSet()->erase(table_rid);
+    txn->GetExclusiveLockSet()->emplace(table_rid);
+  } else {
+    txn->GetSharedLockSet()->emplace(table_rid);
+  }
+  txn->RecordLockedRid(table_rid);
+  return true;
+}
+
+bool LockManager::RecordRowLock(Transaction *txn, page_id_t table_id) {
+  std::lock_guard lock(escalation_latch_);
+  return ++row_lock_counts_[txn->GetTransactionId()][table_id] == escalation_threshold_;
+}
+
 bool LockManager::Unlock(Transaction *txn, const RID &rid) {
+  if (two_pl_mode_ == TwoPLMode::STRICT && txn->GetState() == TransactionState::GROWING) {
+    // Strict 2PL: locks are only released at commit/abort.
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  if (two_pl_mode_ == TwoPLMode::REGULAR && txn->GetState() == TransactionState::GROWING) {
+    txn->SetState(TransactionState::SHRINKING);
+  }
+  auto &shard = Shard(rid);
+  std::unique_lock lock(shard.latch_);
+  auto queue_it = shard.lock_table_.find(rid);
+  if (queue_it == shard.lock_table_.end()) {
+    return false;
+  }
+  auto &queue = queue_it->second;
+  auto request = std::find_if(queue.request_queue_.begin(), queue.request_queue_.end(),
+                              [txn](const LockRequest &r) { return r.txn_id_ == txn->GetTransactionId(); });
+  if (request == queue.request_queue_.end()) {
+    return false;
+  }
+  queue.request_queue_.erase(request);
+  WakeGrantable(&queue);
+  if (queue.request_queue_.empty() && !queue.upgrading_) {
+    shard.lock_table_.erase(queue_it);
+  }
   txn->GetSharedLockSet()->erase(rid);
   txn->GetExclusiveLockSet()->erase(rid);
+  if (txn->GetSharedLockSet()->empty() && txn->GetExclusiveLockSet()->empty()) {
+    // Last lock released: drop the transaction's escalation counters.
+    std::lock_guard escalation_lock(escalation_latch_);
+    row_lock_counts_.erase(txn->GetTransactionId());
+  }
   return true;
 }
 
-void LockManager::AddEdge(txn_id_t t1, txn_id_t t2) { assert(Detection()); }
+void LockManager::AddEdge(txn_id_t t1, txn_id_t t2) {
+  assert(Detection());
+  auto &edges = waits_for_[t1];
+  auto it = std::lower_bound(edges.begin(), edges.end(), t2);
+  if (it == edges.end() || *it != t2) {
+    // Kept sorted so DFS explores the lowest transaction id first, deterministically.
+    edges.insert(it, t2);
+  }
+}
 
-void LockManager::RemoveEdge(txn_id_t t1, txn_id_t t2) { assert(Detection()); }
+void LockManager::RemoveEdge(txn_id_t t1, txn_id_t t2) {
+  assert(Detection());
+  auto entry = waits_for_.find(t1);
+  if (entry == waits_for_.end()) {
+    return;
+  }
+  auto it = std::lower_bound(entry->second.begin(), entry->second.end(), t2);
+  if (it != entry->second.end() && *it == t2) {
+    entry->second.erase(it);
+  }
+}
 
 bool LockManager::HasCycle(txn_id_t *txn_id) {
   BUSTUB_ASSERT(Detection(), "Detection should be enabled!");
+  std::vector<txn_id_t> vertices;
+  vertices.reserve(waits_for_.size());
+  for (auto &entry : waits_for_) {
+    if (!entry.second.empty()) {
+      vertices.push_back(entry.first);
+    }
+  }
+  std::sort(vertices.begin(), vertices.end());
+
+  std::unordered_set<txn_id_t> visited;
+  std::vector<txn_id_t> path;
+  std::unordered_map<txn_id_t, size_t> on_path;
+  std::function<bool(txn_id_t)> dfs = [&](txn_id_t vertex) {
+    visited.insert(vertex);
+    on_path[vertex] = path.size();
+    path.push_back(vertex);
+    auto entry = waits_for_.find(vertex);
+    if (entry != waits_for_.end()) {
+      for (txn_id_t next : entry->second) {
+        auto cycle_start = on_path.find(next);
+        if (cycle_start != on_path.end()) {
+          // Back edge: the cycle is the path suffix from next; report its youngest member.
+          txn_id_t youngest = next;
+          for (size_t i = cycle_start->second; i < path.size(); i++) {
+            youngest = std::max(youngest, path[i]);
+          }
+          *txn_id = youngest;
+          return true;
+        }
+        if (visited.count(next) == 0 && dfs(next)) {
+          return true;
+        }
+      }
+    }
+    on_path.erase(vertex);
+    path.pop_back();
+    return false;
+  };
+  for (txn_id_t vertex : vertices) {
+    if (visited.count(vertex) == 0 && dfs(vertex)) {
+      return true;
+    }
+  }
   return false;
 }
 
 std::vector<std::pair<txn_id_t, txn_id_t>> LockManager::GetEdgeList() {
   BUSTUB_ASSERT(Detection(), "Detection should be enabled!");
-  return {};
+  std::lock_guard lock(latch_);
+  std::vector<std::pair<txn_id_t, txn_id_t>> edges;
+  for (auto &entry : waits_for_) {
+    for (txn_id_t t2 : entry.second) {
+      edges.emplace_back(entry.first, t2);
+    }
+  }
+  return edges;
 }
 
 void LockManager::RunCycleDetection() {
@@ -59,8 +419,19 @@ void LockManager::RunCycleDetection() {
     std::this_thread::sleep_for(cycle_detection_interval);
     {
       std::unique_lock<std::mutex> l(latch_);
-      // TODO(student): remove the continue and add your cycle detection and abort code here
-      continue;
+      txn_id_t victim;
+      while (HasCycle(&victim)) {
+        // Abort the youngest transaction on the cycle; it notices via its timed wait, removes its
+        // request and returns false from the lock call.
+        TransactionManager::GetTransaction(victim)->SetState(TransactionState::ABORTED);
+        waits_for_.erase(victim);
+        for (auto &entry : waits_for_) {
+          auto it = std::lower_bound(entry.second.begin(), entry.second.end(), victim);
+          if (it != entry.second.end() && *it == victim) {
+            entry.second.erase(it);
+          }
+        }
+      }
     }
   }
 }
@@ -0,0 +1,23 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// transaction.cpp
+//
+// Identification: src/concurrency/transaction.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/transaction.h"
+
+#include "concurrency/transaction_manager.h"
+
+namespace bustub {
+
+// Defined out of line because transaction.h cannot see TransactionManager: the manager's header
+// includes this one.
+Transaction::~Transaction() { TransactionManager::Unregister(txn_id_, this); }
+
+}  // namespace bustub
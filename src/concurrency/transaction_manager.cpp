@@ -15,30 +15,54 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "concurrency/version_manager.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
-std::unordered_map<txn_id_t, Transaction *> TransactionManager::txn_map = {};
+std::array<TransactionManager::TxnMapShard, TransactionManager::TXN_MAP_SHARDS> TransactionManager::txn_map_shards =
+    {};
 
-Transaction *TransactionManager::Begin(Transaction *txn) {
+Transaction *TransactionManager::Begin(Transaction *txn, bool read_only) {
   // Acquire the global transaction latch in shared mode.
   global_txn_latch_.RLock();
 
   if (txn == nullptr) {
-    txn = new Transaction(next_txn_id_++);
+    // Reuse a recycled Transaction when one is available; its containers are already allocated.
+    {
+      std::lock_guard<std::mutex> lock(txn_pool_latch_);
+      if (!txn_pool_.empty()) {
+        txn = txn_pool_.back();
+        txn_pool_.pop_back();
+      }
+    }
+    if (txn != nullptr) {
+      txn->Reset(next_txn_id_++);
+    } else {
+      txn = new Transaction(next_txn_id_++);
+    }
   }
+  // Snapshot: the transaction reads the database as of the most recent commit.
+  txn->SetReadTs(last_commit_ts_.load());
+  txn->SetReadOnly(read_only);
 
   if (enable_logging) {
-    // TODO(student): Add logging here.
+    LogRecord record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::BEGIN);
+    txn->SetPrevLSN(log_manager_->StageLogRecord(&record, txn));
   }
 
-  txn_map[txn->GetTransactionId()] = txn;
+  {
+    auto &shard = TxnShard(txn->GetTransactionId());
+    std::lock_guard<std::mutex> lock(shard.latch_);
+    shard.map_[txn->GetTransactionId()] = txn;
+  }
   return txn;
 }
 
 void TransactionManager::Commit(Transaction *txn) {
   txn->SetState(TransactionState::COMMITTED);
+  // Make this transaction's versions visible to snapshots taken from now on.
+  VersionManager::Instance().CommitTxn(txn->GetTransactionId(), ++last_commit_ts_);
 
   // Perform all deletes before we commit.
   auto write_set = txn->GetWriteSet();
@@ -54,7 +78,22 @@ void TransactionManager::Commit(Transaction *txn) {
   write_set->clear();
 
   if (enable_logging) {
-    // TODO(student): add logging here
+    // Group commit: append the COMMIT record and park until the flush thread has covered it.
+    // One WriteLog wakes every transaction whose commit record made it into that flush.
+    LogRecord record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::COMMIT);
+    lsn_t lsn = log_manager_->StageLogRecord(&record, txn);
+    txn->SetPrevLSN(lsn);
+    // Publish the transaction's staged records in one copy, then park for the covering flush.
+    log_manager_->PublishStagedLog(txn);
+    if (early_lock_release_) {
+      // With the COMMIT record in the log buffer, dependent transactions may proceed; their own
+      // commit records land after ours, so their flush wait implies our durability.
+      ReleaseLocks(txn);
+      log_manager_->WaitForFlush(lsn);
+      global_txn_latch_.RUnlock();
+      return;
+    }
+    log_manager_->WaitForFlush(lsn);
   }
 
   // Release all the locks.
@@ -65,6 +104,7 @@ void TransactionManager::Commit(Transaction *txn) {
 
 void TransactionManager::Abort(Transaction *txn) {
   txn->SetState(TransactionState::ABORTED);
+  VersionManager::Instance().AbortTxn(txn->GetTransactionId());
 
   // Rollback before releasing the lock.
   auto write_set = txn->GetWriteSet();
@@ -84,7 +124,10 @@ void TransactionManager::Abort(Transaction *txn) {
   write_set->clear();
 
   if (enable_logging) {
-    // TODO(student): add logging here
+    // An abort does not need to be durable before releasing locks; no flush wait here.
+    LogRecord record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::ABORT);
+    txn->SetPrevLSN(log_manager_->StageLogRecord(&record, txn));
+    log_manager_->PublishStagedLog(txn);
   }
 
   // Release all the locks.
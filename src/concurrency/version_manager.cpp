@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// version_manager.cpp
+//
+// Identification: src/concurrency/version_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/version_manager.h"
+
+namespace bustub {
+
+VersionManager &VersionManager::Instance() {
+  static VersionManager instance;
+  return instance;
+}
+
+void VersionManager::Append(const RID &rid, const Tuple &base_tuple, bool base_deleted, const Tuple &new_tuple,
+                            bool new_deleted, Transaction *txn) {
+  {
+    auto &shard = Shard(rid);
+    std::lock_guard lock(shard.latch_);
+    auto &chain = shard.chains_[rid];
+    if (chain.empty()) {
+      // The pre-image predates the chain store, so it is visible to every snapshot (timestamp 0).
+      chain.push_back(Version{base_tuple, base_deleted, INVALID_TXN_ID, 0});
+    }
+    chain.push_back(Version{new_tuple, new_deleted, txn->GetTransactionId(), UNCOMMITTED_TS});
+  }
+  std::lock_guard lock(txn_writes_latch_);
+  txn_writes_[txn->GetTransactionId()].push_back(rid);
+}
+
+void VersionManager::OnWrite(const RID &rid, const Tuple &old_tuple, const Tuple &new_tuple, bool deleted,
+                             Transaction *txn) {
+  Append(rid, old_tuple, false, new_tuple, deleted, txn);
+}
+
+void VersionManager::OnInsert(const RID &rid, const Tuple &tuple, Transaction *txn) {
+  // The base version is "row not present" so snapshots older than the insert skip it.
+  Append(rid, Tuple{}, true, tuple, false, txn);
+}
+
+void VersionManager::CommitTxn(txn_id_t txn_id, timestamp_t commit_ts) {
+  std::vector<RID> rids;
+  {
+    std::lock_guard lock(txn_writes_latch_);
+    auto entry = txn_writes_.find(txn_id);
+    if (entry == txn_writes_.end()) {
+      return;
+    }
+    rids = std::move(entry->second);
+    txn_writes_.erase(entry);
+  }
+  for (const RID &rid : rids) {
+    auto &shard = Shard(rid);
+    std::lock_guard lock(shard.latch_);
+    for (auto &version : shard.chains_[rid]) {
+      if (version.writer_ == txn_id) {
+        version.commit_ts_ = commit_ts;
+      }
+    }
+  }
+}
+
+void VersionManager::AbortTxn(txn_id_t txn_id) {
+  std::vector<RID> rids;
+  {
+    std::lock_guard lock(txn_writes_latch_);
+    auto entry = txn_writes_.find(txn_id);
+    if (entry == txn_writes_.end()) {
+      return;
+    }
+    rids = std::move(entry->second);
+    txn_writes_.erase(entry);
+  }
+  for (const RID &rid : rids) {
+    auto &shard = Shard(rid);
+    std::lock_guard lock(shard.latch_);
+    auto &chain = shard.chains_[rid];
+    for (auto it = chain.begin(); it != chain.end();) {
+      it = it->writer_ == txn_id ? chain.erase(it) : std::next(it);
+    }
+  }
+}
+
+VersionManager::Lookup VersionManager::GetVisible(const RID &rid, timestamp_t read_ts, Tuple *tuple) {
+  auto &shard = Shard(rid);
+  std::lock_guard lock(shard.latch_);
+  auto entry = shard.chains_.find(rid);
+  if (entry == shard.chains_.end()) {
+    return Lookup::NO_CHAIN;
+  }
+  // Newest first; the base version (timestamp 0) guarantees a hit.
+  for (auto it = entry->second.rbegin(); it != entry->second.rend(); ++it) {
+    if (it->commit_ts_ <= read_ts) {
+      if (it->deleted_) {
+        return Lookup::DELETED;
+      }
+      *tuple = it->tuple_;
+      return Lookup::FOUND;
+    }
+  }
+  return Lookup::DELETED;
+}
+
+}  // namespace bustub
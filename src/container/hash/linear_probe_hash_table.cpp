@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
@@ -26,21 +29,332 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  CreateTable(num_buckets);
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+  table_latch_.RLock();
+  // During an incremental resize a pair lives in exactly one layout (migration tombstones the
+  // old copy under the block latch before releasing it), so probe the old layout first and let
+  // ProbeGet skip anything the new layout repeats.
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    ProbeGet(old_header_page_id_, old_size_, key, result);
+  }
+  ProbeGet(header_page_id_, size_, key, result);
+  table_latch_.RUnlock();
+  return !result->empty();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, HashTableResultBuffer<ValueType> *result) {
+  table_latch_.RLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    ProbeGet(old_header_page_id_, old_size_, key, result);
+  }
+  ProbeGet(header_page_id_, size_, key, result);
+  table_latch_.RUnlock();
+  return !result->empty();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::GetSingleValue(Transaction *transaction, const KeyType &key, ValueType *result) {
+  table_latch_.RLock();
+  // With a unique key the first match is the answer, so whichever layout yields one first
+  // ends the lookup; a pair momentarily visible in both layouts is the same pair.
+  bool found = old_header_page_id_ != INVALID_PAGE_ID && ProbeGetFirst(old_header_page_id_, old_size_, key, result);
+  if (!found) {
+    found = ProbeGetFirst(header_page_id_, size_, key, result);
+  }
+  table_latch_.RUnlock();
+  return found;
 }
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  table_latch_.RLock();
+  while (true) {
+    // New pairs go only into the current layout; the old one is checked just for duplicates,
+    // so a pair is never migrated twice.
+    bool resizing = old_header_page_id_ != INVALID_PAGE_ID;
+    if (resizing && ProbeContains(old_header_page_id_, old_size_, key, value)) {
+      table_latch_.RUnlock();
+      return false;
+    }
+    ProbeInsertResult probe_result = ProbeInsert(header_page_id_, size_, key, value);
+    if (probe_result == ProbeInsertResult::DUPLICATE) {
+      table_latch_.RUnlock();
+      return false;
+    }
+    if (probe_result == ProbeInsertResult::INSERTED) {
+      num_readable_.fetch_add(1, std::memory_order_relaxed);
+      // Pay the migration debt: move one old block.
+      StepMigrationAndUnlock();
+      return true;
+    }
+    // Every slot is occupied: grow the table and probe again against the new layout.
+    size_t old_size = size_;
+    table_latch_.RUnlock();
+    Resize(old_size);
+    table_latch_.RLock();
+  }
+}
+
+/*****************************************************************************
+ * BATCHED OPERATIONS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::InsertBatch(Transaction *transaction, const std::vector<std::pair<KeyType, ValueType>> &entries) {
+  table_latch_.RLock();
+  // With a resize in flight every pair needs both layouts reconciled, which defeats the
+  // one-latch-per-block batching; hand the entries to the one-pair path instead.
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    table_latch_.RUnlock();
+    for (const auto &entry : entries) {
+      Insert(transaction, entry.first, entry.second);
+    }
+    return;
+  }
+  size_t size = size_;
+  std::vector<size_t> order(entries.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [this, &entries, size](size_t a, size_t b) {
+    return HomeSlot(entries[a].first, size) < HomeSlot(entries[b].first, size);
+  });
+  auto *header_raw = buffer_pool_manager_->FetchPage(header_page_id_);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_raw->GetData());
+  std::vector<size_t> spilled;
+  size_t i = 0;
+  while (i < order.size()) {
+    // One fetch and one latch cover every insert whose probe starts in this block.
+    size_t block_index = HomeSlot(entries[order[i]].first, size) / BLOCK_ARRAY_SIZE;
+    page_id_t block_page_id = header->GetBlockPageId(block_index);
+    auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    bool dirty = false;
+    page->WLatch();
+    for (; i < order.size() && HomeSlot(entries[order[i]].first, size) / BLOCK_ARRAY_SIZE == block_index; i++) {
+      const auto &entry = entries[order[i]];
+      size_t slot = HomeSlot(entry.first, size);
+      unsigned char tag = HASH_TABLE_BLOCK_TYPE::Tag(entry.first);
+      bool settled = false;
+      size_t walked = 0;
+      while (true) {
+        slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+        if (!block->IsOccupied(offset)) {
+          block->Insert(offset, entry.first, entry.second);
+          num_readable_.fetch_add(1, std::memory_order_relaxed);
+          dirty = true;
+          settled = true;
+          break;
+        }
+        if (block->IsReadable(offset) && block->TagAt(offset) == tag &&
+            comparator_(block->KeyAt(offset), entry.first) == 0 && block->ValueAt(offset) == entry.second) {
+          settled = true;  // exact duplicate, skipped like Insert does
+          break;
+        }
+        walked++;
+        slot = (slot + 1) % size;
+        if (slot % BLOCK_ARRAY_SIZE == 0) {
+          break;  // the probe left this block
+        }
+      }
+      if (settled) {
+        RecordProbeLength(walked);
+      } else {
+        spilled.push_back(order[i]);  // the rerun below records its own probe
+      }
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, dirty);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  // The rare probes that crossed a block boundary rerun from their home slot; the one-pair
+  // path also absorbs growing the table if the batch filled it.
+  for (size_t index : spilled) {
+    Insert(transaction, entries[index].first, entries[index].second);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::BulkLoad(Transaction *transaction, const std::vector<std::pair<KeyType, ValueType>> &entries) {
+  table_latch_.WLock();
+  // Bulk loading installs a right-sized fresh layout, which only an empty table can afford;
+  // a table that already stores pairs keeps its slots and the entries go down the batched
+  // insert path instead.
+  if (num_readable_.load(std::memory_order_relaxed) != 0 || old_header_page_id_ != INVALID_PAGE_ID) {
+    table_latch_.WUnlock();
+    InsertBatch(transaction, entries);
+    return;
+  }
+  if (entries.empty()) {
+    table_latch_.WUnlock();
+    return;
+  }
+  // Pre-size to the final bucket count: half full after the load, like a freshly resized
+  // table, so the build never grows mid-flight and later operations keep short probes.
+  size_t target_slots = std::max(size_, entries.size() * 2);
+  if (target_slots > size_) {
+    auto *old_raw = buffer_pool_manager_->FetchPage(header_page_id_);
+    auto *old_header = reinterpret_cast<HashTableHeaderPage *>(old_raw->GetData());
+    for (size_t block_index = 0; block_index < num_blocks_; block_index++) {
+      buffer_pool_manager_->DeletePage(old_header->GetBlockPageId(block_index));
+    }
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    buffer_pool_manager_->DeletePage(header_page_id_);
+    CreateTable(target_slots);
+  }
+  num_tombstones_.store(0, std::memory_order_relaxed);
+  size_t size = size_;
+  // Partition by destination: in home slot order every block's entries are consecutive, so
+  // one fetch covers all the inserts that start in it.
+  std::vector<size_t> order(entries.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [this, &entries, size](size_t a, size_t b) {
+    return HomeSlot(entries[a].first, size) < HomeSlot(entries[b].first, size);
+  });
+  auto *header_raw = buffer_pool_manager_->FetchPage(header_page_id_);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_raw->GetData());
+  std::vector<size_t> spilled;
+  size_t i = 0;
+  while (i < order.size()) {
+    size_t block_index = HomeSlot(entries[order[i]].first, size) / BLOCK_ARRAY_SIZE;
+    page_id_t block_page_id = header->GetBlockPageId(block_index);
+    auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    bool dirty = false;
+    for (; i < order.size() && HomeSlot(entries[order[i]].first, size) / BLOCK_ARRAY_SIZE == block_index; i++) {
+      const auto &entry = entries[order[i]];
+      size_t slot = HomeSlot(entry.first, size);
+      unsigned char tag = HASH_TABLE_BLOCK_TYPE::Tag(entry.first);
+      bool settled = false;
+      size_t walked = 0;
+      while (true) {
+        slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+        if (!block->IsOccupied(offset)) {
+          block->Insert(offset, entry.first, entry.second);
+          num_readable_.fetch_add(1, std::memory_order_relaxed);
+          dirty = true;
+          settled = true;
+          break;
+        }
+        if (block->IsReadable(offset) && block->TagAt(offset) == tag &&
+            comparator_(block->KeyAt(offset), entry.first) == 0 && block->ValueAt(offset) == entry.second) {
+          settled = true;  // exact duplicate, skipped like Insert does
+          break;
+        }
+        walked++;
+        slot = (slot + 1) % size;
+        if (slot % BLOCK_ARRAY_SIZE == 0) {
+          break;  // the probe left this block
+        }
+      }
+      if (settled) {
+        RecordProbeLength(walked);
+      } else {
+        spilled.push_back(order[i]);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, dirty);
+  }
+  // The rare probes that crossed their block rerun unlatched; the half-empty layout
+  // guarantees them a slot. The duplicate check stays exact, like Insert's.
+  for (size_t index : spilled) {
+    const auto &entry = entries[index];
+    if (ProbeContains(header_page_id_, size, entry.first, entry.second)) {
+      continue;
+    }
+    InsertUnlatched(header, entry.first, entry.second);
+    num_readable_.fetch_add(1, std::memory_order_relaxed);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::GetValueBatch(Transaction *transaction, const std::vector<KeyType> &keys,
+                                    std::vector<std::vector<ValueType>> *results) {
+  results->clear();
+  results->resize(keys.size());
+  table_latch_.RLock();
+  // See InsertBatch: two layouts defeat the batching, so probe per key.
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    for (size_t key_index = 0; key_index < keys.size(); key_index++) {
+      ProbeGet(old_header_page_id_, old_size_, keys[key_index], &(*results)[key_index]);
+      ProbeGet(header_page_id_, size_, keys[key_index], &(*results)[key_index]);
+    }
+    table_latch_.RUnlock();
+    return;
+  }
+  size_t size = size_;
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [this, &keys, size](size_t a, size_t b) {
+    return HomeSlot(keys[a], size) < HomeSlot(keys[b], size);
+  });
+  auto *header_raw = buffer_pool_manager_->FetchPage(header_page_id_);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_raw->GetData());
+  std::vector<size_t> spilled;
+  size_t i = 0;
+  while (i < order.size()) {
+    size_t block_index = HomeSlot(keys[order[i]], size) / BLOCK_ARRAY_SIZE;
+    page_id_t block_page_id = header->GetBlockPageId(block_index);
+    auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    page->RLatch();
+    for (; i < order.size() && HomeSlot(keys[order[i]], size) / BLOCK_ARRAY_SIZE == block_index; i++) {
+      const KeyType &key = keys[order[i]];
+      std::vector<ValueType> *result = &(*results)[order[i]];
+      size_t slot = HomeSlot(key, size);
+      bool settled = false;
+      size_t walked = 0;
+      while (true) {
+        slot_offset_t start_offset = slot % BLOCK_ARRAY_SIZE;
+        slot_offset_t base = start_offset & ~static_cast<slot_offset_t>(63);
+        uint64_t match_mask;
+        slot_offset_t chain_end;
+        bool ended = block->ProbeWindow(start_offset, key, &match_mask, &chain_end);
+        while (match_mask != 0) {
+          slot_offset_t offset = base + __builtin_ctzll(match_mask);
+          ValueType value = block->ValueAt(offset);
+          if (std::find(result->begin(), result->end(), value) == result->end()) {
+            result->push_back(value);
+          }
+          match_mask &= match_mask - 1;
+        }
+        walked += chain_end - start_offset;
+        slot = (slot + chain_end - start_offset) % size;
+        if (ended) {
+          settled = true;
+          break;
+        }
+        if (slot % BLOCK_ARRAY_SIZE == 0) {
+          break;  // the probe left this block
+        }
+      }
+      if (settled) {
+        RecordProbeLength(walked);
+      } else {
+        spilled.push_back(order[i]);  // ProbeGet records the rerun
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  // Rerun the rare cross-block probes from scratch; ProbeGet skips values the
+  // block pass already collected.
+  for (size_t index : spilled) {
+    ProbeGet(header_page_id_, size, keys[index], &(*results)[index]);
+  }
+  table_latch_.RUnlock();
 }
 
 /*****************************************************************************
@@ -48,21 +362,427 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  table_latch_.RLock();
+  bool removed_from_old = false;
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    removed_from_old = ProbeRemove(old_header_page_id_, old_size_, key, value);
+  }
+  bool removed = removed_from_old || ProbeRemove(header_page_id_, size_, key, value);
+  if (removed) {
+    num_readable_.fetch_sub(1, std::memory_order_relaxed);
+    // A tombstone in the old layout disappears with the layout, so only
+    // current-layout tombstones count.
+    if (!removed_from_old) {
+      num_tombstones_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  bool compact = removed && old_header_page_id_ == INVALID_PAGE_ID &&
+                 static_cast<double>(num_tombstones_.load(std::memory_order_relaxed)) >=
+                     compaction_tombstone_ratio_ * static_cast<double>(size_);
+  // Removes pay migration debt just like inserts, so a compaction (or resize)
+  // in flight finishes even if nothing is ever inserted again.
+  StepMigrationAndUnlock();
+  if (compact) {
+    Compact();
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  // A concurrent inserter may have grown the table while this one waited for the latch.
+  if (2 * initial_size <= size_) {
+    table_latch_.WUnlock();
+    return;
+  }
+  // Growing again while the previous growth is still migrating is possible only when the
+  // doubled layout filled up before its inserts could move the old blocks; settle the old
+  // debt first so at most two layouts ever exist.
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    FinishMigration();
+  }
+  old_header_page_id_ = header_page_id_;
+  old_size_ = size_;
+  old_num_blocks_ = num_blocks_;
+  next_migrate_block_.store(0);
+  migrated_blocks_.store(0);
+  CreateTable(2 * initial_size);
+  // The fresh layout starts tombstone-free, and the old layout's tombstones
+  // die with it once migration finishes.
+  num_tombstones_.store(0, std::memory_order_relaxed);
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 size_t HASH_TABLE_TYPE::GetSize() {
-  return 0;
+  table_latch_.RLock();
+  size_t size = size_;
+  table_latch_.RUnlock();
+  return size;
+}
+
+/*****************************************************************************
+ * STATISTICS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::SetCompactionThreshold(double tombstone_ratio) {
+  table_latch_.WLock();
+  compaction_tombstone_ratio_ = tombstone_ratio;
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::GetStats(HashTableStats *stats) {
+  table_latch_.RLock();
+  stats->num_slots = size_;
+  stats->num_readable = num_readable_.load(std::memory_order_relaxed);
+  stats->num_tombstones = num_tombstones_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < HashTableStats::PROBE_HISTOGRAM_BUCKETS; i++) {
+    stats->probe_lengths[i] = probe_lengths_[i].load(std::memory_order_relaxed);
+  }
+  table_latch_.RUnlock();
+}
+
+/*****************************************************************************
+ * PROBES
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename ResultContainer>
+void HASH_TABLE_TYPE::ProbeGet(page_id_t header_page_id, size_t size, const KeyType &key, ResultContainer *result) {
+  auto *header_raw = buffer_pool_manager_->FetchPage(header_page_id);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_raw->GetData());
+  size_t slot = HomeSlot(key, size);
+  size_t probed = 0;
+  bool stop = false;
+  while (!stop && probed < size) {
+    // Latch only the block this stretch of the probe runs in; the latch is dropped before the
+    // probe moves to the next block, so probes in other blocks proceed in parallel.
+    page_id_t block_page_id = header->GetBlockPageId(slot / BLOCK_ARRAY_SIZE);
+    auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    page->RLatch();
+    while (probed < size) {
+      // One vectorized pass covers up to 64 slots: the occupancy bitmaps are read a word at a
+      // time and the candidate keys are compared in bulk (see ProbeWindow).
+      slot_offset_t start_offset = slot % BLOCK_ARRAY_SIZE;
+      slot_offset_t base = start_offset & ~static_cast<slot_offset_t>(63);
+      uint64_t match_mask;
+      slot_offset_t chain_end;
+      bool ended = block->ProbeWindow(start_offset, key, &match_mask, &chain_end);
+      while (match_mask != 0) {
+        slot_offset_t offset = base + __builtin_ctzll(match_mask);
+        ValueType value = block->ValueAt(offset);
+        if (std::find(result->begin(), result->end(), value) == result->end()) {
+          result->push_back(value);
+        }
+        match_mask &= match_mask - 1;
+      }
+      probed += chain_end - start_offset;
+      slot = (slot + chain_end - start_offset) % size;
+      if (ended) {
+        // A never-used slot ends every probe chain that could hold the key.
+        stop = true;
+        break;
+      }
+      if (slot % BLOCK_ARRAY_SIZE == 0) {
+        break;  // crossed into the next block
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+  }
+  RecordProbeLength(probed);
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::ProbeGetFirst(page_id_t header_page_id, size_t size, const KeyType &key, ValueType *result) {
+  auto *header_raw = buffer_pool_manager_->FetchPage(header_page_id);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_raw->GetData());
+  size_t slot = HomeSlot(key, size);
+  size_t probed = 0;
+  bool stop = false;
+  bool found = false;
+  while (!stop && probed < size) {
+    page_id_t block_page_id = header->GetBlockPageId(slot / BLOCK_ARRAY_SIZE);
+    auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    page->RLatch();
+    while (probed < size) {
+      slot_offset_t start_offset = slot % BLOCK_ARRAY_SIZE;
+      slot_offset_t base = start_offset & ~static_cast<slot_offset_t>(63);
+      uint64_t match_mask;
+      slot_offset_t chain_end;
+      bool ended = block->ProbeWindow(start_offset, key, &match_mask, &chain_end);
+      probed += chain_end - start_offset;
+      slot = (slot + chain_end - start_offset) % size;
+      if (match_mask != 0) {
+        // First match wins: the caller asserted the key is unique, so there is nothing to
+        // deduplicate and no reason to walk the rest of the chain.
+        *result = block->ValueAt(base + __builtin_ctzll(match_mask));
+        found = true;
+        stop = true;
+        break;
+      }
+      if (ended) {
+        stop = true;
+        break;
+      }
+      if (slot % BLOCK_ARRAY_SIZE == 0) {
+        break;  // crossed into the next block
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+  }
+  RecordProbeLength(probed);
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+typename HASH_TABLE_TYPE::ProbeInsertResult HASH_TABLE_TYPE::ProbeInsert(page_id_t header_page_id, size_t size,
+                                                                         const KeyType &key, const ValueType &value) {
+  auto *header_raw = buffer_pool_manager_->FetchPage(header_page_id);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_raw->GetData());
+  size_t slot = HomeSlot(key, size);
+  size_t probed = 0;
+  unsigned char tag = HASH_TABLE_BLOCK_TYPE::Tag(key);
+  ProbeInsertResult result = ProbeInsertResult::FULL;
+  while (probed < size && result == ProbeInsertResult::FULL) {
+    page_id_t block_page_id = header->GetBlockPageId(slot / BLOCK_ARRAY_SIZE);
+    auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    page->WLatch();
+    while (probed < size) {
+      slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+      if (!block->IsOccupied(offset)) {
+        // First never-used slot: the pair cannot exist beyond it, so claim it.
+        block->Insert(offset, key, value);
+        result = ProbeInsertResult::INSERTED;
+        break;
+      }
+      if (block->IsReadable(offset) && block->TagAt(offset) == tag && comparator_(block->KeyAt(offset), key) == 0 &&
+          block->ValueAt(offset) == value) {
+        // The exact pair is already present; duplicates are not allowed.
+        result = ProbeInsertResult::DUPLICATE;
+        break;
+      }
+      probed++;
+      slot = (slot + 1) % size;
+      if (slot % BLOCK_ARRAY_SIZE == 0) {
+        break;  // crossed into the next block
+      }
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, result == ProbeInsertResult::INSERTED);
+  }
+  RecordProbeLength(probed);
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  return result;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::ProbeRemove(page_id_t header_page_id, size_t size, const KeyType &key, const ValueType &value) {
+  auto *header_raw = buffer_pool_manager_->FetchPage(header_page_id);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_raw->GetData());
+  size_t slot = HomeSlot(key, size);
+  size_t probed = 0;
+  unsigned char tag = HASH_TABLE_BLOCK_TYPE::Tag(key);
+  bool removed = false;
+  bool stop = false;
+  while (!stop && !removed && probed < size) {
+    page_id_t block_page_id = header->GetBlockPageId(slot / BLOCK_ARRAY_SIZE);
+    auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    page->WLatch();
+    while (probed < size) {
+      slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+      if (!block->IsOccupied(offset)) {
+        stop = true;
+        break;
+      }
+      if (block->IsReadable(offset) && block->TagAt(offset) == tag && comparator_(block->KeyAt(offset), key) == 0 &&
+          block->ValueAt(offset) == value) {
+        // Tombstone the slot; Insert keeps each pair unique, so the probe can stop here.
+        block->Remove(offset);
+        removed = true;
+        break;
+      }
+      probed++;
+      slot = (slot + 1) % size;
+      if (slot % BLOCK_ARRAY_SIZE == 0) {
+        break;  // crossed into the next block
+      }
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, removed);
+  }
+  RecordProbeLength(probed);
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::ProbeContains(page_id_t header_page_id, size_t size, const KeyType &key,
+                                    const ValueType &value) {
+  std::vector<ValueType> values;
+  ProbeGet(header_page_id, size, key, &values);
+  return std::find(values.begin(), values.end(), value) != values.end();
+}
+
+/*****************************************************************************
+ * MIGRATION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::StepMigrationAndUnlock() {
+  // Whoever moves the last block frees the old pages, which needs the table
+  // latch exclusively for a moment.
+  bool migration_complete = old_header_page_id_ != INVALID_PAGE_ID && MigrateStep();
+  page_id_t finished_header_page_id = old_header_page_id_;
+  table_latch_.RUnlock();
+  if (migration_complete) {
+    table_latch_.WLock();
+    if (old_header_page_id_ == finished_header_page_id && old_header_page_id_ != INVALID_PAGE_ID) {
+      FinishMigration();
+    }
+    table_latch_.WUnlock();
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::Compact() {
+  table_latch_.WLock();
+  // A migration already in flight either is a compaction or will shed the
+  // tombstones anyway; and a concurrent compaction may have reset the count
+  // while this caller waited for the latch.
+  if (old_header_page_id_ != INVALID_PAGE_ID ||
+      static_cast<double>(num_tombstones_.load(std::memory_order_relaxed)) <
+          compaction_tombstone_ratio_ * static_cast<double>(size_)) {
+    table_latch_.WUnlock();
+    return;
+  }
+  old_header_page_id_ = header_page_id_;
+  old_size_ = size_;
+  old_num_blocks_ = num_blocks_;
+  next_migrate_block_.store(0);
+  migrated_blocks_.store(0);
+  CreateTable(size_);
+  num_tombstones_.store(0, std::memory_order_relaxed);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::MigrateStep() {
+  size_t block_index = next_migrate_block_.fetch_add(1);
+  if (block_index >= old_num_blocks_) {
+    return migrated_blocks_.load() == old_num_blocks_;
+  }
+  auto *header_raw = buffer_pool_manager_->FetchPage(old_header_page_id_);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_raw->GetData());
+  page_id_t block_page_id = header->GetBlockPageId(block_index);
+  auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+  auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+  // Holding this block's write latch for the whole move keeps each pair in exactly one layout
+  // as far as any latched reader can observe: the new copy is planted before the old one is
+  // tombstoned, and both happen before the latch is released. Only the occupied bits survive,
+  // so probe chains running through this block are undisturbed.
+  page->WLatch();
+  for (slot_offset_t offset = 0; offset < BLOCK_ARRAY_SIZE; offset++) {
+    if (block->IsReadable(offset)) {
+      ProbeInsertResult result = ProbeInsert(header_page_id_, size_, block->KeyAt(offset), block->ValueAt(offset));
+      BUSTUB_ASSERT(result == ProbeInsertResult::INSERTED, "Migration target layout rejected a pair.");
+      block->Remove(offset);
+    }
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(block_page_id, true);
+  buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  return migrated_blocks_.fetch_add(1) + 1 == old_num_blocks_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::FinishMigration() {
+  auto *old_header_raw = buffer_pool_manager_->FetchPage(old_header_page_id_);
+  auto *old_header = reinterpret_cast<HashTableHeaderPage *>(old_header_raw->GetData());
+  auto *new_header_raw = buffer_pool_manager_->FetchPage(header_page_id_);
+  auto *new_header = reinterpret_cast<HashTableHeaderPage *>(new_header_raw->GetData());
+  for (size_t block_index = 0; block_index < old_num_blocks_; block_index++) {
+    page_id_t block_page_id = old_header->GetBlockPageId(block_index);
+    auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    for (slot_offset_t offset = 0; offset < BLOCK_ARRAY_SIZE; offset++) {
+      if (block->IsReadable(offset)) {
+        InsertUnlatched(new_header, block->KeyAt(offset), block->ValueAt(offset));
+      }
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+    buffer_pool_manager_->DeletePage(block_page_id);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  buffer_pool_manager_->DeletePage(old_header_page_id_);
+  old_header_page_id_ = INVALID_PAGE_ID;
+  old_size_ = 0;
+  old_num_blocks_ = 0;
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::CreateTable(size_t num_buckets) {
+  num_blocks_ = std::max<size_t>(1, (num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE);
+  size_ = num_blocks_ * BLOCK_ARRAY_SIZE;
+  auto *header_raw = buffer_pool_manager_->NewPage(&header_page_id_);
+  BUSTUB_ASSERT(header_raw != nullptr, "Couldn't create the hash table header page.");
+  // NewPage may hand back an evicted frame; the slot state bitmaps must start zeroed.
+  memset(header_raw->GetData(), 0, PAGE_SIZE);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_raw->GetData());
+  header->SetPageId(header_page_id_);
+  header->SetSize(size_);
+  for (size_t block_index = 0; block_index < num_blocks_; block_index++) {
+    page_id_t block_page_id;
+    auto *block_raw = buffer_pool_manager_->NewPage(&block_page_id);
+    BUSTUB_ASSERT(block_raw != nullptr, "Couldn't create a hash table block page.");
+    memset(block_raw->GetData(), 0, PAGE_SIZE);
+    header->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::InsertUnlatched(HashTableHeaderPage *header, const KeyType &key, const ValueType &value) {
+  size_t slot = HomeSlot(key, size_);
+  while (true) {
+    page_id_t block_page_id = header->GetBlockPageId(slot / BLOCK_ARRAY_SIZE);
+    auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    bool inserted = false;
+    while (true) {
+      slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+      if (block->Insert(offset, key, value)) {
+        inserted = true;
+        break;
+      }
+      slot = (slot + 1) % size_;
+      if (slot % BLOCK_ARRAY_SIZE == 0) {
+        break;  // crossed into the next block
+      }
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, inserted);
+    if (inserted) {
+      return;
+    }
+  }
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -17,19 +17,75 @@
 
 #include "execution/executors/abstract_executor.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/executors/delete_executor.h"
+#include "execution/executors/exchange_executor.h"
+#include "execution/executors/fused_join_aggregation_executor.h"
 #include "execution/executors/hash_join_executor.h"
+#include "execution/executors/index_join_executor.h"
+#include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/seq_scan_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/executors/sort_merge_join_executor.h"
+#include "execution/executors/stats_executor.h"
+#include "execution/executors/top_n_executor.h"
+#include "execution/executors/update_executor.h"
 
 namespace bustub {
+
+namespace {
+/** The plan type's name, used to label the executor's runtime counters. */
+const char *PlanTypeName(PlanType type) {
+  switch (type) {
+    case PlanType::SeqScan:
+      return "SeqScan";
+    case PlanType::IndexScan:
+      return "IndexScan";
+    case PlanType::HashJoin:
+      return "HashJoin";
+    case PlanType::SortMergeJoin:
+      return "SortMergeJoin";
+    case PlanType::IndexJoin:
+      return "IndexJoin";
+    case PlanType::Insert:
+      return "Insert";
+    case PlanType::Update:
+      return "Update";
+    case PlanType::Delete:
+      return "Delete";
+    case PlanType::Aggregation:
+      return "Aggregation";
+    case PlanType::Sort:
+      return "Sort";
+    case PlanType::Limit:
+      return "Limit";
+    case PlanType::Exchange:
+      return "Exchange";
+  }
+  return "Unknown";
+}
+}  // namespace
+
 std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx,
                                                                   const AbstractPlanNode *plan) {
+  // Every executor is wrapped, so a finished query leaves a per-operator profile on the context.
+  return std::make_unique<StatsExecutor>(exec_ctx, PlanTypeName(plan->GetType()),
+                                         CreateRawExecutor(exec_ctx, plan));
+}
+
+std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateRawExecutor(ExecutorContext *exec_ctx,
+                                                                     const AbstractPlanNode *plan) {
   switch (plan->GetType()) {
     // Create a new sequential scan executor.
     case PlanType::SeqScan: {
       return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan));
     }
 
+    // Create a new index scan executor.
+    case PlanType::IndexScan: {
+      return std::make_unique<IndexScanExecutor>(exec_ctx, dynamic_cast<const IndexScanPlanNode *>(plan));
+    }
+
     // Create a new insert executor.
     case PlanType::Insert: {
       auto insert_plan = dynamic_cast<const InsertPlanNode *>(plan);
@@ -38,22 +94,100 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
       return std::make_unique<InsertExecutor>(exec_ctx, insert_plan, std::move(child_executor));
     }
 
-    // Create a new hash join executor.
+    // Create a new update executor.
+    case PlanType::Update: {
+      auto update_plan = dynamic_cast<const UpdatePlanNode *>(plan);
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, update_plan->GetChildPlan());
+      return std::make_unique<UpdateExecutor>(exec_ctx, update_plan, std::move(child_executor));
+    }
+
+    // Create a new delete executor.
+    case PlanType::Delete: {
+      auto delete_plan = dynamic_cast<const DeletePlanNode *>(plan);
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, delete_plan->GetChildPlan());
+      return std::make_unique<DeleteExecutor>(exec_ctx, delete_plan, std::move(child_executor));
+    }
+
+    // Create a new hash join executor — unless both children already deliver the join keys in
+    // order, in which case the streams are merged directly and the hash build is skipped.
     case PlanType::HashJoin: {
       auto join_plan = dynamic_cast<const HashJoinPlanNode *>(plan);
       auto left_executor = ExecutorFactory::CreateExecutor(exec_ctx, join_plan->GetLeftPlan());
       auto right_executor = ExecutorFactory::CreateExecutor(exec_ctx, join_plan->GetRightPlan());
+      if (SortMergeJoinExecutor::CanMerge(join_plan)) {
+        return std::make_unique<SortMergeJoinExecutor>(exec_ctx, join_plan, std::move(left_executor),
+                                                       std::move(right_executor));
+      }
       return std::make_unique<HashJoinExecutor>(exec_ctx, join_plan, std::move(left_executor),
                                                 std::move(right_executor));
     }
 
-    // Create a new aggregation executor.
+    // Create a new sort-merge join executor.
+    case PlanType::SortMergeJoin: {
+      auto join_plan = dynamic_cast<const SortMergeJoinPlanNode *>(plan);
+      auto left_executor = ExecutorFactory::CreateExecutor(exec_ctx, join_plan->GetLeftPlan());
+      auto right_executor = ExecutorFactory::CreateExecutor(exec_ctx, join_plan->GetRightPlan());
+      return std::make_unique<SortMergeJoinExecutor>(exec_ctx, join_plan, std::move(left_executor),
+                                                     std::move(right_executor));
+    }
+
+    // Create a new index nested-loop join executor.
+    case PlanType::IndexJoin: {
+      auto join_plan = dynamic_cast<const IndexJoinPlanNode *>(plan);
+      auto outer_executor = ExecutorFactory::CreateExecutor(exec_ctx, join_plan->GetOuterPlan());
+      return std::make_unique<IndexJoinExecutor>(exec_ctx, join_plan, std::move(outer_executor));
+    }
+
+    // Create a new aggregation executor. An aggregation that groups on the keys of the hash
+    // join below it is fused: the fused executor reuses the join's probe hashes as the group
+    // hashes instead of hashing the same columns twice.
     case PlanType::Aggregation: {
       auto agg_plan = dynamic_cast<const AggregationPlanNode *>(plan);
+      const AbstractPlanNode *child_plan = agg_plan->GetChildPlan();
+      if (child_plan->GetType() == PlanType::HashJoin) {
+        auto join_plan = dynamic_cast<const HashJoinPlanNode *>(child_plan);
+        if (FusedJoinAggregationExecutor::CanFuse(agg_plan, join_plan)) {
+          auto left_executor = ExecutorFactory::CreateExecutor(exec_ctx, join_plan->GetLeftPlan());
+          auto right_executor = ExecutorFactory::CreateExecutor(exec_ctx, join_plan->GetRightPlan());
+          // The join is constructed directly, not wrapped: the fused executor needs the
+          // concrete type to read back each output row's key hash.
+          auto join_executor = std::make_unique<HashJoinExecutor>(exec_ctx, join_plan, std::move(left_executor),
+                                                                  std::move(right_executor));
+          return std::make_unique<FusedJoinAggregationExecutor>(exec_ctx, agg_plan, std::move(join_executor));
+        }
+      }
       auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, agg_plan->GetChildPlan());
       return std::make_unique<AggregationExecutor>(exec_ctx, agg_plan, std::move(child_executor));
     }
 
+    // Create a new exchange executor.
+    case PlanType::Exchange: {
+      auto exchange_plan = dynamic_cast<const ExchangePlanNode *>(plan);
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, exchange_plan->GetChildPlan());
+      return std::make_unique<ExchangeExecutor>(exec_ctx, exchange_plan, std::move(child_executor));
+    }
+
+    // Create a new sort executor.
+    case PlanType::Sort: {
+      auto sort_plan = dynamic_cast<const SortPlanNode *>(plan);
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, sort_plan->GetChildPlan());
+      return std::make_unique<SortExecutor>(exec_ctx, sort_plan, std::move(child_executor));
+    }
+
+    // Create a new Top-N executor. A limit over a sort is fused: the executor runs over the
+    // sort's child with a bounded heap instead of sorting the whole input first.
+    case PlanType::Limit: {
+      auto limit_plan = dynamic_cast<const LimitPlanNode *>(plan);
+      const AbstractPlanNode *child_plan = limit_plan->GetChildPlan();
+      if (child_plan->GetType() == PlanType::Sort) {
+        auto sort_plan = dynamic_cast<const SortPlanNode *>(child_plan);
+        auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, sort_plan->GetChildPlan());
+        return std::make_unique<TopNExecutor>(exec_ctx, limit_plan, sort_plan, std::move(child_executor));
+      }
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, child_plan);
+      return std::make_unique<TopNExecutor>(exec_ctx, limit_plan, nullptr, std::move(child_executor));
+    }
+
     default: {
       BUSTUB_ASSERT(false, "Unsupported plan type.");
     }
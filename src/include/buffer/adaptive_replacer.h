@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_replacer.h
+//
+// Identification: src/include/buffer/adaptive_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * AdaptiveReplacer switches between the clock and LRU-K policies at runtime based on the observed
+ * workload. No single policy wins both an OLTP-style point-access mix (where clock's constant-time
+ * slot writes shine) and scan-heavy batch reports (where LRU-K's scan resistance does).
+ *
+ * Both sub-policies are kept fully up to date on every Pin/Unpin, so either can take over
+ * instantly; only Victim consults the active one. Quality is sampled with a ghost list in the
+ * ARC style: the page ids of the last pool-size evictions are remembered, and a fetch miss on a
+ * remembered page means the active policy evicted something the workload still wanted. When a
+ * window's worth of misses has accumulated, the active policy's ghost-hit rate is compared
+ * against the other policy's last measured rate and the better one takes over; the losing policy
+ * is re-probed for one window periodically so a workload shift is noticed.
+ */
+class AdaptiveReplacer : public Replacer {
+ public:
+  /**
+   * Create a new AdaptiveReplacer. Clock starts as the active policy, matching the buffer pool's
+   * default.
+   * @param num_pages the maximum number of pages the replacer will be required to store; also
+   *        the ghost list capacity
+   * @param window_misses the number of fetch misses over which each ghost-hit rate is measured
+   */
+  explicit AdaptiveReplacer(size_t num_pages, size_t window_misses = ADAPTIVE_REPLACER_WINDOW);
+
+  ~AdaptiveReplacer() override = default;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void UnpinForReuse(frame_id_t frame_id) override;
+
+  void RecordEviction(frame_id_t frame_id, page_id_t page_id) override;
+
+  void RecordMiss(page_id_t page_id) override;
+
+  size_t Size() override;
+
+  /** @return the policy Victim currently consults */
+  ReplacerType GetActivePolicy();
+
+  /** @return the number of times the active policy has been switched */
+  uint64_t GetPolicySwitches();
+
+  /** @return the number of fetch misses that hit the ghost list (premature evictions) */
+  uint64_t GetGhostHits();
+
+ private:
+  /** Re-probe the inactive policy after this many windows without a switch. */
+  static constexpr size_t PROBE_INTERVAL = 8;
+  /** Sentinel for a policy whose ghost-hit rate has not been measured yet. */
+  static constexpr double UNMEASURED = -1.0;
+
+  /** Closes the current measurement window and switches policies if the sample says to. */
+  void EndWindow();
+
+  /** @return the sub-replacer for the given policy */
+  Replacer *PolicyReplacer(ReplacerType type) {
+    return type == ReplacerType::CLOCK ? static_cast<Replacer *>(clock_.get()) : lru_k_.get();
+  }
+
+  std::unique_ptr<ClockReplacer> clock_;
+  std::unique_ptr<LRUKReplacer> lru_k_;
+  ReplacerType active_{ReplacerType::CLOCK};
+
+  /** Recently evicted page ids, oldest first, capped at the pool size. */
+  std::list<page_id_t> ghost_order_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> ghost_pages_;
+  size_t ghost_capacity_;
+
+  size_t window_misses_;
+  size_t misses_in_window_{0};
+  size_t ghost_hits_in_window_{0};
+  size_t windows_since_switch_{0};
+  /** Last measured ghost-hit rate per policy, indexed by ReplacerType; UNMEASURED until sampled. */
+  double measured_rate_[2]{UNMEASURED, UNMEASURED};
+
+  uint64_t policy_switches_{0};
+  uint64_t ghost_hits_{0};
+
+  /** Guards the active policy, the ghost list and the window counters. */
+  std::mutex mu_;
+};
+
+}  // namespace bustub
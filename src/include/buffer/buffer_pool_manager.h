@@ -12,11 +12,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
 #include <list>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
+#include "buffer/adaptive_replacer.h"
 #include "buffer/clock_replacer.h"
+#include "buffer/page_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -31,18 +37,56 @@ class BufferPoolManager {
   enum class CallbackType { BEFORE, AFTER };
   using bufferpool_callback_fn = void (*)(enum CallbackType, const page_id_t page_id);
 
+  /** A consistent snapshot of the buffer pool counters, taken with GetStats. */
+  struct Stats {
+    /** Number of FetchPage calls satisfied from the pool. */
+    uint64_t hits_{0};
+    /** Number of FetchPage calls that had to go to disk. */
+    uint64_t misses_{0};
+    /** Number of frames victimized to make room. */
+    uint64_t evictions_{0};
+    /** Number of dirty frames written back to disk. */
+    uint64_t dirty_writebacks_{0};
+    /** Total time spent waiting for the pool latch, in microseconds. */
+    uint64_t pin_wait_time_us_{0};
+    /** Times a fetch found every frame pinned and backed off to wait for an unpin. */
+    uint64_t frame_waits_{0};
+    /** Frame waits that exhausted their retries: real starvation surfaced to the caller. */
+    uint64_t frame_wait_failures_{0};
+    /** Misses on recently evicted pages, counted by the adaptive replacer; 0 otherwise. */
+    uint64_t replacer_ghost_hits_{0};
+    /** Times the adaptive replacer switched its active policy; 0 otherwise. */
+    uint64_t replacer_policy_switches_{0};
+  };
+
   /**
    * Creates a new BufferPoolManager.
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy to use for victim selection
+   */
+  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                    ReplacerType replacer_type = ReplacerType::CLOCK);
+
+  /**
+   * Creates a BufferPoolManager that is one of several instances sharing the same disk manager.
+   * Page ids handed out by this instance always satisfy page_id % num_instances == instance_index,
+   * so a router (e.g. ParallelBufferPoolManager) can map any page id back to its owning instance.
+   * @param pool_size the size of this buffer pool instance
+   * @param num_instances total number of instances sharing the disk manager
+   * @param instance_index index of this instance, in [0, num_instances)
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy to use for victim selection
    */
-  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index, DiskManager *disk_manager,
+                    LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::CLOCK);
 
   /**
    * Destroys an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager();
 
   /** Grading function. Do not modify! */
   Page *FetchPage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) {
@@ -91,32 +135,112 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Fetch a batch of pages, pinning resident pages under a single latch acquisition and issuing
+   * the misses to disk as one batched read. The output vector is parallel to page_ids; an entry is
+   * nullptr if no frame could be found for that page.
+   * @param page_ids ids of the pages to fetch
+   * @param[out] pages the fetched pages, in the same order as page_ids
+   */
+  virtual void FetchPages(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages);
+
+  /**
+   * Start the background flusher thread. It periodically writes dirty, unpinned frames back to
+   * disk (like LogManager::RunFlushThread does for the log) so that victim selection almost always
+   * finds a clean frame and read misses do not pay for a victim write-back.
+   */
+  virtual void RunFlushThread();
+
+  /** Stop and join the background flusher thread. */
+  virtual void StopFlushThread();
+
+  /**
+   * Schedule a non-blocking read of the given page into the pool. The call only enqueues the page
+   * id and returns; a background worker performs the read, so callers can overlap the disk I/O for
+   * the next page in a chain with processing of the current one. Prefetched pages enter the pool
+   * unpinned; a page that is already resident is left untouched.
+   * @param page_id id of the page to prefetch
+   */
+  virtual void PrefetchPage(page_id_t page_id);
+
+  /**
+   * Returns a snapshot of the buffer pool counters. The counters are relaxed atomics incremented
+   * on the fetch/unpin paths, cheap enough to stay enabled in production.
+   * @return the counter snapshot
+   */
+  virtual Stats GetStats();
+
+  /**
+   * Dump the ids of the currently resident pages to the warm-set sidecar file, so a future
+   * restart can prewarm the pool with LoadWarmSet. Also called periodically by the background
+   * flusher thread.
+   */
+  void SaveWarmSet();
+
+  /**
+   * Prewarm the pool by reading the pages recorded in the warm-set sidecar file with one batched
+   * FetchPages call; the pages are left resident but unpinned.
+   * @return true if a warm set was found and replayed
+   */
+  bool LoadWarmSet();
+
+  /** @return ids of the pages currently resident in the pool */
+  virtual std::vector<page_id_t> GetResidentPageIds();
+
+  /** @return ids of the resident pages whose in-memory image is newer than the disk image */
+  virtual std::vector<page_id_t> GetDirtyPageIds();
+
+  /**
+   * Enables or disables bulk-pin mode. While enabled, frames filled by NewPage or a FetchPage
+   * miss are marked for immediate reuse: when they are unpinned they become the replacer's
+   * preferred next victim instead of joining the regular clock sweep. Bulk loaders (e.g.
+   * TableGenerator) use this so one ETL pass does not evict the OLTP working set.
+   * @param enabled true to enable bulk-pin mode
+   */
+  virtual void SetBulkPinMode(bool enabled) { bulk_pin_mode_.store(enabled, std::memory_order_relaxed); }
+
+  /**
+   * Marks a page as stored compressed on disk. A compressed table's heap calls this for every
+   * page it allocates, before the page's first flush, so the disk manager compresses each
+   * on-disk image of it.
+   * @param page_id id of the page
+   */
+  virtual void MarkPageCompressed(page_id_t page_id) {
+    if (disk_manager_ != nullptr) {
+      disk_manager_->SetPageCompressed(page_id);
+    }
+  }
+
+  /**
+   * Sets the dirty bit of a resident page without going through a fetch/unpin pair. Meant for
+   * pages pinned for the pool's lifetime (see TableHeap::PinForLifetime), whose callers bypass
+   * FetchPage/UnpinPage entirely and so never pass is_dirty the normal way. The caller must
+   * hold a pin on the page; a pinned page cannot be evicted, so the frame lookup is stable.
+   * @param page_id id of the page
+   * @return false if the page is not resident, true otherwise
+   */
+  virtual bool MarkPageDirty(page_id_t page_id);
+
   /** @return pointer to all the pages in the buffer pool */
   Page *GetPages() { return pages_; }
 
   /** @return size of the buffer pool */
   size_t GetPoolSize() { return pool_size_; }
 
- private:
+ protected:
   /**
-   * Grading function. Do not modify!
-   * Invokes the callback function if it is not null.
-   * @param callback callback function to be invoked
-   * @param callback_type BEFORE or AFTER
-   * @param page_id the page id to invoke the callback with
+   * Constructor used by buffer pool managers that only route to inner instances and hold no frames themselves.
+   * @param disk_manager the disk manager shared by the inner instances
+   * @param pool_size the aggregate size reported by GetPoolSize
    */
-  void GradingCallback(bufferpool_callback_fn callback, CallbackType callback_type, page_id_t page_id) {
-    if (callback != nullptr) {
-      callback(callback_type, page_id);
-    }
-  }
+  BufferPoolManager(DiskManager *disk_manager, size_t pool_size);
 
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
    * @return the requested page
    */
-  Page *FetchPageImpl(page_id_t page_id);
+  virtual Page *FetchPageImpl(page_id_t page_id);
 
   /**
    * Unpin the target page from the buffer pool.
@@ -124,50 +248,166 @@ class BufferPoolManager {
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @return false if the page pin count is <= 0 before this call, true otherwise
    */
-  bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
+  virtual bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
 
   /**
    * Flushes the target page to disk.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  bool FlushPageImpl(page_id_t page_id);
+  virtual bool FlushPageImpl(page_id_t page_id);
 
   /**
    * Creates a new page in the buffer pool.
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  Page *NewPageImpl(page_id_t *page_id);
+  virtual Page *NewPageImpl(page_id_t *page_id);
 
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  bool DeletePageImpl(page_id_t page_id);
+  virtual bool DeletePageImpl(page_id_t page_id);
 
   /**
    * Flushes all the pages in the buffer pool to disk.
    */
-  void FlushAllPagesImpl();
+  virtual void FlushAllPagesImpl();
+
+  /**
+   * Allocates the next page id owned by this instance.
+   * A standalone pool delegates to DiskManager::AllocatePage; an instance that is part of a sharded pool
+   * hands out ids with stride num_instances_ so that page_id % num_instances_ == instance_index_.
+   * @return the id of the allocated page
+   */
+  page_id_t AllocatePageId();
+
+  /**
+   * Writes every dirty frame back to disk and clears its dirty bit.
+   * Called periodically by the background flusher thread.
+   */
+  void FlushDirtyPages();
+
+  /** Stop and join the prefetch worker thread. */
+  void StopPrefetchThread();
+
+  /**
+   * Ownership claim placed in a frame's pin count while it is being recycled. A stale fast-path
+   * pin can still land on the frame after its mapping is removed (and is undone once the pinner's
+   * re-validation fails), so the new page's setup cannot just store pin = 1 -- the store would
+   * erase the stray increment and its matching decrement would then strip the new owner's pin.
+   * Claiming by CAS(0 -> FRAME_CLAIM_PINS) and setting up with fetch_add(1 - FRAME_CLAIM_PINS)
+   * keeps every stray pin/unpin pair balanced on top of the claim instead.
+   */
+  static constexpr int FRAME_CLAIM_PINS = 1 << 20;
+
+  /**
+   * Picks a frame to evict: asks the replacer for victims, skipping frames that were re-pinned
+   * through the lock-free fast path, and writes the victim back if it is dirty. The victim's page
+   * table mapping is removed before its pin count is claimed (CAS 0 -> FRAME_CLAIM_PINS), which
+   * pairs with the re-validation in FetchPageImpl so one of the two sides always notices a
+   * concurrent re-pin.
+   * Must be called with latch_ held.
+   * @param[out] frame_id the evicted frame, its pin count holding the claim
+   * @return false if every replacer candidate turned out to be pinned
+   */
+  bool EvictVictim(frame_id_t *frame_id);
+
+  /**
+   * Takes a frame for a new resident page: free list first, then eviction. Finding every frame
+   * pinned is usually transient -- concurrent queries unpin as they advance, and unpins do not
+   * take the pool latch -- so a miss backs off and retries before it is treated as starvation
+   * and surfaced as a failure to the caller.
+   * Must be called with latch_ held.
+   * @param[out] frame_id the acquired frame, its pin count holding FRAME_CLAIM_PINS
+   * @return false if no frame came free within the retry budget
+   */
+  bool AcquireFrame(frame_id_t *frame_id);
+
+  /**
+   * WAL rule: a page must not reach disk before the log records that produced its lsn. Publishes
+   * any privately staged records and waits for the log to cover the frame's page lsn.
+   * Call before every DiskManager::WritePage of a table page.
+   * @param frame_id the frame about to be written back
+   */
+  void EnsureLogDurable(frame_id_t frame_id);
+
+ private:
+  /**
+   * Grading function. Do not modify!
+   * Invokes the callback function if it is not null.
+   * @param callback callback function to be invoked
+   * @param callback_type BEFORE or AFTER
+   * @param page_id the page id to invoke the callback with
+   */
+  void GradingCallback(bufferpool_callback_fn callback, CallbackType callback_type, page_id_t page_id) {
+    if (callback != nullptr) {
+      callback(callback_type, page_id);
+    }
+  }
 
   /** Number of pages in the buffer pool. */
   size_t pool_size_;
-  /** Array of buffer pool pages. */
+  /** Array of buffer pool page metadata entries; the page bytes live in frame_data_. */
   Page *pages_;
+  /** The frame arena: pool_size_ contiguous PAGE_SIZE slots the pages' data_ points into,
+   * allocated apart from the metadata so pin and latch traffic never invalidates page bytes. */
+  char *frame_data_{nullptr};
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /** Page table for keeping track of buffer pool pages. Lookups are lock free; a buffer pool hit
+   * is one probe plus a pin-count fetch_add without touching latch_. Mutations happen under latch_. */
+  PageTable page_table_;
   /** Replacer to find unpinned pages for replacement. */
   Replacer *replacer_;
+  /** Set (aliasing replacer_) when the pool was built with ReplacerType::ADAPTIVE, for stats. */
+  AdaptiveReplacer *adaptive_replacer_{nullptr};
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
+  /** True while a bulk operation wants its frames marked for immediate-reuse eviction. */
+  std::atomic<bool> bulk_pin_mode_{false};
+  /** Per-frame flag: the frame was filled while bulk-pin mode was on. Guarded by latch_. */
+  /** Per-frame "filled by a bulk operation" flags. Byte-wide (not vector<bool>) because the
+   * latch-free unpin path reads a frame's flag while the latched paths write neighbours. */
+  std::vector<uint8_t> bulk_frames_;
   /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
   std::mutex latch_;
+  /** Total number of instances sharing the disk manager (1 for a standalone pool). */
+  uint32_t num_instances_ = 1;
+  /** Index of this instance among the sharing instances. */
+  uint32_t instance_index_ = 0;
+  /** Next page id handed out by AllocatePageId when this instance is part of a sharded pool. */
+  std::atomic<page_id_t> next_page_id_;
+  /** Background thread that proactively writes back dirty frames, nullptr when not running. */
+  std::thread *flusher_thread_ = nullptr;
+  /** True while the background flusher thread should keep running. */
+  std::atomic<bool> flusher_running_{false};
+  /** Wakes the flusher thread up early on StopFlushThread. */
+  std::condition_variable flusher_cv_;
+  /** Protects the flusher condition variable. */
+  std::mutex flusher_latch_;
+  /** Background worker that services PrefetchPage requests, nullptr until the first request. */
+  std::thread *prefetcher_thread_ = nullptr;
+  /** True while the prefetch worker should keep running. */
+  std::atomic<bool> prefetcher_running_{false};
+  /** Page ids waiting to be prefetched. */
+  std::list<page_id_t> prefetch_queue_;
+  /** Wakes the prefetch worker when requests arrive or on shutdown. */
+  std::condition_variable prefetcher_cv_;
+  /** Protects the prefetch queue and the lazy start of the worker. */
+  std::mutex prefetcher_latch_;
+  /** Pool counters; incremented with relaxed atomics so they can stay on in production. */
+  std::atomic<uint64_t> num_hits_{0};
+  std::atomic<uint64_t> num_misses_{0};
+  std::atomic<uint64_t> num_evictions_{0};
+  std::atomic<uint64_t> num_dirty_writebacks_{0};
+  std::atomic<uint64_t> pin_wait_time_us_{0};
+  std::atomic<uint64_t> num_frame_waits_{0};
+  std::atomic<uint64_t> num_frame_wait_failures_{0};
 
   // store frame's page_id, just to pass the test
   std::unordered_map<frame_id_t, page_id_t> frame_table_;
@@ -12,10 +12,8 @@
 
 #pragma once
 
-#include <list>
-#include <mutex>  // NOLINT
+#include <atomic>
 #include <vector>
-#include <map>
 
 #include "buffer/replacer.h"
 #include "common/config.h"
@@ -23,7 +21,15 @@
 namespace bustub {
 
 /**
- * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ * ClockReplacer implements the clock replacement policy, which approximates the Least Recently
+ * Used policy.
+ *
+ * The state is a flat per-frame byte array indexed by frame id (absent / present with the
+ * reference bit set / present with it cleared) plus an atomic clock hand, so there is no latch
+ * and no container lookup anywhere: Pin and Unpin are a single relaxed atomic operation on the
+ * frame's slot, and Victim advances the hand with fetch_add and claims a frame with one
+ * compare-exchange. Unpin is on the unpin path of every page access, which is what makes the
+ * constant-time slot write worth the loss of strict insertion order between frames.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -44,15 +50,23 @@ class ClockReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void UnpinForReuse(frame_id_t frame_id) override;
+
   size_t Size() override;
 
  private:
-  // TODO(student): implement me!
-  std::list<frame_id_t> list_;
-  std::map<frame_id_t, bool> ref_;
-  size_t max_num_pages_;
-  std::mutex mu_;
-  std::list<frame_id_t>::iterator header_;
+  /** Frame is pinned (or was victimized) and must not be handed out. */
+  static constexpr uint8_t ABSENT = 0;
+  /** Frame is evictable and its reference bit is clear: the next sweep may take it. */
+  static constexpr uint8_t READY = 1;
+  /** Frame is evictable but recently unpinned: the next sweep downgrades it to READY. */
+  static constexpr uint8_t REFERENCED = 2;
+
+  /** Per-frame state, indexed by frame id. */
+  std::vector<std::atomic<uint8_t>> state_;
+  /** The clock hand; only ever advanced, read modulo the pool size. */
+  std::atomic<size_t> hand_{0};
+  size_t num_pages_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy: the victim is the evictable frame with the
+ * largest backward k-distance, i.e. the largest gap between now and its k-th most recent access.
+ * Frames with fewer than k recorded accesses have an infinite backward k-distance and are evicted
+ * first (oldest access wins ties). Unlike a plain clock, a single sequential scan only gives every
+ * page one access, so it cannot push out pages with an established re-reference history such as
+ * index root and catalog pages.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of historical accesses tracked per frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+ private:
+  /** Records an access to the given frame at the current logical timestamp. */
+  void RecordAccess(frame_id_t frame_id);
+
+  /** Per-frame state: the last (up to) k access timestamps and whether the frame can be victimized. */
+  struct FrameInfo {
+    std::deque<size_t> history_;
+    bool evictable_{false};
+  };
+
+  std::unordered_map<frame_id_t, FrameInfo> frames_;
+  size_t max_num_pages_;
+  size_t k_;
+  /** Logical clock, advanced on every recorded access. */
+  size_t current_timestamp_{0};
+  /** Number of evictable frames. */
+  size_t curr_size_{0};
+  std::mutex mu_;
+};
+
+}  // namespace bustub
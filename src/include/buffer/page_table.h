@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps resident page ids to frame ids with a fixed-capacity, open-addressing hash table
+ * whose slots are atomics. Lookups (the 99% re-pin case) are completely lock free: one linear
+ * probe sequence over atomic slots. Mutations (Insert/Remove) are only performed by the buffer
+ * pool manager while it holds its latch, so they do not race with each other; deleted slots are
+ * tombstoned so concurrent probes never miss a live entry.
+ */
+class PageTable {
+ public:
+  /**
+   * Creates a page table sized for the given number of frames.
+   * @param num_frames the maximum number of resident pages
+   */
+  explicit PageTable(size_t num_frames);
+
+  /**
+   * Looks up the frame holding the given page. Lock free.
+   * @param page_id id of the page to look up
+   * @param[out] frame_id frame holding the page
+   * @return true if the page is resident
+   */
+  bool Find(page_id_t page_id, frame_id_t *frame_id) const;
+
+  /**
+   * Inserts or updates the mapping for a page. Must be called under the pool latch.
+   * @param page_id id of the page
+   * @param frame_id frame now holding the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Removes the mapping for a page, if present. Must be called under the pool latch.
+   * @param page_id id of the page
+   */
+  void Remove(page_id_t page_id);
+
+  /**
+   * Invokes fn(page_id, frame_id) for every live mapping. Must be called under the pool latch.
+   * @param fn the function to invoke
+   */
+  void ForEach(const std::function<void(page_id_t, frame_id_t)> &fn) const;
+
+  /** @return the number of live mappings */
+  size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+ private:
+  /** Slot key marking a never-used slot (probe sequences stop here). */
+  static constexpr page_id_t EMPTY_KEY = INVALID_PAGE_ID;
+  /** Slot key marking a deleted slot (probe sequences continue past it). */
+  static constexpr page_id_t TOMBSTONE_KEY = INVALID_PAGE_ID - 1;
+
+  struct Slot {
+    std::atomic<page_id_t> page_id_{EMPTY_KEY};
+    std::atomic<frame_id_t> frame_id_{-1};
+  };
+
+  /** @return the probe start index for a page id */
+  size_t IndexOf(page_id_t page_id) const { return static_cast<size_t>(page_id) & (capacity_ - 1); }
+
+  /** Number of slots; always a power of two so probing can mask instead of mod. */
+  size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace bustub
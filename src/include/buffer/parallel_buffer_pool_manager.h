@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool into several independent BufferPoolManager
+ * instances so that concurrent callers do not all contend on one global latch. Pages are routed
+ * to the instance page_id % num_instances; each instance allocates page ids with that stride,
+ * so the routing never needs a shared mapping table. The public FetchPage/NewPage/UnpinPage API
+ * is unchanged, so existing callers (TableHeap, the hash index, ...) work without modification.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of independent buffer pool instances
+   * @param pool_size the size of each buffer pool instance
+   * @param disk_manager the disk manager, shared by all instances
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   */
+  ParallelBufferPoolManager(uint32_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            LogManager *log_manager = nullptr);
+
+  ~ParallelBufferPoolManager() override;
+
+  /** @return the number of buffer pool instances */
+  uint32_t GetNumInstances() { return num_instances_; }
+
+  /** @return the buffer pool instance that owns the given page id */
+  BufferPoolManager *GetBufferPoolManager(page_id_t page_id);
+
+  void FetchPages(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) override;
+
+  void RunFlushThread() override;
+
+  void StopFlushThread() override;
+
+  void PrefetchPage(page_id_t page_id) override;
+
+  Stats GetStats() override;
+
+  std::vector<page_id_t> GetResidentPageIds() override;
+
+  std::vector<page_id_t> GetDirtyPageIds() override;
+
+  void SetBulkPinMode(bool enabled) override;
+
+  bool MarkPageDirty(page_id_t page_id) override;
+
+ protected:
+  Page *FetchPageImpl(page_id_t page_id) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  Page *NewPageImpl(page_id_t *page_id) override;
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  void FlushAllPagesImpl() override;
+
+ private:
+  /** Number of independent buffer pool instances. */
+  uint32_t num_instances_;
+  /** Start index for the round-robin search in NewPageImpl. */
+  std::atomic<uint32_t> next_instance_;
+  /** Background thread that periodically dumps the aggregated warm set, nullptr when not running. */
+  std::thread *warm_set_thread_ = nullptr;
+  /** True while the warm-set dump thread should keep running. */
+  std::atomic<bool> warm_set_running_{false};
+  /** Wakes the warm-set dump thread up early on StopFlushThread. */
+  std::condition_variable warm_set_cv_;
+  /** Protects the warm-set condition variable. */
+  std::mutex warm_set_latch_;
+  /** The buffer pool instances; instance i owns every page id with page_id % num_instances_ == i. */
+  std::vector<std::unique_ptr<BufferPoolManager>> instances_;
+};
+
+}  // namespace bustub
@@ -16,6 +16,9 @@
 
 namespace bustub {
 
+/** The replacement policies a BufferPoolManager can be constructed with. */
+enum class ReplacerType { CLOCK, LRU_K, ADAPTIVE };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -43,6 +46,29 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Unpins a frame that was filled by a bulk operation and is unlikely to be re-read, making it
+   * the preferred next victim instead of the coldest regular frame. Policies that cannot express
+   * this fall back to a regular Unpin.
+   * @param frame_id the id of the frame to unpin
+   */
+  virtual void UnpinForReuse(frame_id_t frame_id) { Unpin(frame_id); }
+
+  /**
+   * Tells the replacer which page just left the pool through the frame it picked. Policies that
+   * keep history beyond the resident set (ghost lists) use this; the base policies ignore it.
+   * @param frame_id the frame that was victimized
+   * @param page_id the page that was living in it
+   */
+  virtual void RecordEviction(frame_id_t /*frame_id*/, page_id_t /*page_id*/) {}
+
+  /**
+   * Tells the replacer that a fetch missed the pool for the given page, so it can score how
+   * recently that page was evicted. The base policies ignore it.
+   * @param page_id the page that had to be read from disk
+   */
+  virtual void RecordMiss(page_id_t /*page_id*/) {}
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
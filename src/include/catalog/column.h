@@ -88,7 +88,7 @@ class Column {
    * @param type type whose size is to be determined
    * @return size in bytes
    */
-  static uint8_t TypeSize(TypeId type) {
+  static constexpr uint8_t TypeSize(TypeId type) {
     switch (type) {
       case TypeId::BOOLEAN:
         return 1;
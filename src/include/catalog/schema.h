@@ -29,14 +29,18 @@ class Schema {
    */
   explicit Schema(const std::vector<Column> &columns);
 
-  static Schema *CopySchema(const Schema *from, const std::vector<uint32_t> &attrs) {
-    std::vector<Column> cols;
-    cols.reserve(attrs.size());
-    for (const auto i : attrs) {
-      cols.emplace_back(from->columns_[i]);
-    }
-    return new Schema{cols};
-  }
+  /**
+   * Returns the canonical projection of the source schema onto the given column indices.
+   * Projected schemas are interned: two calls projecting onto column vectors with the same
+   * names, types, lengths, and expressions get the same pointer back, and repeated projections
+   * (every index open, every per-query key schema) cost a hash probe over the source columns
+   * instead of rebuilding a Column vector and recomputing offsets. Interned schemas are owned
+   * by the process-wide intern pool and live until exit; callers must not delete them.
+   * @param from the schema to project from
+   * @param attrs the source column indices to keep, in output order
+   * @return the interned projected schema
+   */
+  static Schema *CopySchema(const Schema *from, const std::vector<uint32_t> &attrs);
 
   /** @return all the columns in the schema */
   const std::vector<Column> &GetColumns() const { return columns_; }
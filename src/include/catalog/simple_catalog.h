@@ -1,12 +1,20 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "catalog/string_dictionary.h"
+#include "catalog/table_stats.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/generic_key.h"
 #include "storage/index/index.h"
 #include "storage/table/table_heap.h"
 
@@ -17,25 +25,75 @@ namespace bustub {
  */
 using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
+using index_oid_t = uint32_t;
 
 /**
  * Metadata about a table.
+ *
+ * schema_ describes the rows as stored: a dictionary-encoded column appears in it as the
+ * INTEGER codes the pages actually hold, while logical_schema_ keeps the column as declared.
+ * The two only differ for tables created with dictionary columns; a VARCHAR's in-row entry
+ * and a code are both 4 bytes, so every other column sits at the same offset in both schemas.
  */
 struct TableMetadata {
   TableMetadata(Schema schema, std::string name, std::unique_ptr<TableHeap> &&table, table_oid_t oid)
-      : schema_(std::move(schema)), name_(std::move(name)), table_(std::move(table)), oid_(oid) {}
+      : schema_(std::move(schema)), logical_schema_(schema_), name_(std::move(name)), table_(std::move(table)),
+        oid_(oid) {}
+  /** Deferred form for AttachTable: no heap yet, just where its first page lives. */
+  TableMetadata(Schema schema, std::string name, page_id_t first_page_id, table_oid_t oid)
+      : schema_(std::move(schema)), logical_schema_(schema_), name_(std::move(name)), oid_(oid),
+        first_page_id_(first_page_id) {}
   Schema schema_;
+  Schema logical_schema_;
   std::string name_;
   std::unique_ptr<TableHeap> table_;
   table_oid_t oid_;
+  /** Per-column string dictionaries, keyed by column index; empty for plain tables. */
+  std::unordered_map<uint32_t, std::shared_ptr<StringDictionary>> dictionaries_;
+  /** Statistics from the last Analyze over this table; null until one has run. */
+  std::unique_ptr<TableStats> stats_;
+  /** Per-page min/max ranges for scan pruning; null until CreateZoneMap. */
+  std::unique_ptr<ZoneMap> zone_map_;
+  /** True when this table's pages are stored compressed on disk. */
+  bool compressed_{false};
+  /** First page of a lazily attached table; meaningful only while table_ is still null. */
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+};
+
+/**
+ * Metadata about an index. The catalog owns the index object; the table's heap holds a
+ * borrowed pointer to it and maintains its entries on every write path.
+ */
+struct IndexInfo {
+  IndexInfo(std::string name, std::string table_name, std::unique_ptr<Index> &&index, index_oid_t oid)
+      : name_(std::move(name)), table_name_(std::move(table_name)), index_(std::move(index)), oid_(oid) {}
+  std::string name_;
+  std::string table_name_;
+  std::unique_ptr<Index> index_;
+  index_oid_t oid_;
 };
 
 /**
  * SimpleCatalog is a non-persistent catalog that is designed for the executor to use.
  * It handles table creation and table lookup.
+ *
+ * Lookups are lock-free: the name and oid maps live in an immutable snapshot behind an
+ * atomically swapped shared_ptr, so DDL -- which copies the snapshot under a latch and
+ * publishes the new one -- never blocks a reader and a reader never blocks DDL. Metadata
+ * objects themselves are shared between snapshots and never deleted, so a pointer returned
+ * by GetTable or GetIndex stays valid for the catalog's lifetime.
  */
 class SimpleCatalog {
+  struct Snapshot;
+
  public:
+  /**
+   * An immutable catalog version, pinned by holding the handle; see PinVersion. Reclamation is
+   * by the shared_ptr count: a retired version is freed when its last pin drops, and since the
+   * metadata objects are shared between versions, freeing one only releases its map entries.
+   */
+  using Version = std::shared_ptr<const Snapshot>;
+
   /**
    * Creates a new catalog object.
    * @param bpm the buffer pool manager backing tables created by this catalog
@@ -50,29 +108,406 @@ class SimpleCatalog {
    * @param txn the transaction in which the table is being created
    * @param table_name the name of the new table
    * @param schema the schema of the new table
+   * @param layout the page layout of the new table; PAX requires a fixed-length schema
+   * @param dict_cols indexes of VARCHAR columns to dictionary-encode: their tuples store
+   * 4-byte codes instead of strings, translated through a dictionary attached here
+   * @param compressed true to store the table's pages compressed on disk, trading decompression
+   * CPU on page reads for smaller disk images; suited to cold, compressible data
    * @return a pointer to the metadata of the new table
    */
-  TableMetadata *CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema) {
-    BUSTUB_ASSERT(names_.count(table_name) == 0, "Table names should be unique!");
-    return nullptr;
+  TableMetadata *CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema,
+                             TableLayout layout = TableLayout::ROW, const std::vector<uint32_t> &dict_cols = {},
+                             bool compressed = false) {
+    std::scoped_lock lock{ddl_latch_};
+    BUSTUB_ASSERT(snapshot_->names_.count(table_name) == 0, "Table names should be unique!");
+    table_oid_t oid = next_table_oid_++;
+    // The storage schema swaps each dictionary column's VARCHAR for the INTEGER its codes are.
+    Schema storage_schema = schema;
+    if (!dict_cols.empty()) {
+      std::vector<Column> columns;
+      columns.reserve(schema.GetColumnCount());
+      for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+        const Column &col = schema.GetColumn(i);
+        if (std::find(dict_cols.begin(), dict_cols.end(), i) != dict_cols.end()) {
+          BUSTUB_ASSERT(col.GetType() == TypeId::VARCHAR, "Only VARCHAR columns can be dictionary-encoded");
+          columns.emplace_back(col.GetName(), TypeId::INTEGER);
+        } else {
+          columns.push_back(col);
+        }
+      }
+      storage_schema = Schema(columns);
+    }
+    auto table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn, &storage_schema, layout,
+                                             compressed);
+    auto metadata = std::make_shared<TableMetadata>(storage_schema, table_name, std::move(table), oid);
+    metadata->logical_schema_ = schema;
+    metadata->compressed_ = compressed;
+    for (uint32_t col_idx : dict_cols) {
+      metadata->dictionaries_[col_idx] = std::make_shared<StringDictionary>();
+    }
+    TableMetadata *result = metadata.get();
+    // Copy-and-swap: readers keep resolving against the old snapshot until the new one lands.
+    auto next = std::make_shared<Snapshot>(*snapshot_);
+    next->tables_[oid] = std::move(metadata);
+    next->names_[table_name] = oid;
+    Publish(std::move(next));
+    return result;
   }
 
-  /** @return table metadata by name */
-  TableMetadata *GetTable(const std::string &table_name) { return nullptr; }
+  /**
+   * Register a row-layout table whose pages already exist on disk, without touching any of
+   * them. The attach itself is a map insert: the TableHeap is constructed on the first lookup
+   * that returns this table, and its header page is only read when a query first accesses it.
+   * Opening a database with thousands of tables therefore costs no I/O up front; see
+   * WarmAttachedTables for turning the eventual header reads into one batched pass.
+   * @param table_name the name of the existing table
+   * @param schema the schema its rows were stored with
+   * @param first_page_id the first page of the existing heap
+   * @return a pointer to the metadata of the attached table
+   */
+  TableMetadata *AttachTable(const std::string &table_name, const Schema &schema, page_id_t first_page_id) {
+    std::scoped_lock lock{ddl_latch_};
+    BUSTUB_ASSERT(snapshot_->names_.count(table_name) == 0, "Table names should be unique!");
+    table_oid_t oid = next_table_oid_++;
+    auto metadata = std::make_shared<TableMetadata>(schema, table_name, first_page_id, oid);
+    TableMetadata *result = metadata.get();
+    auto next = std::make_shared<Snapshot>(*snapshot_);
+    next->tables_[oid] = std::move(metadata);
+    next->names_[table_name] = oid;
+    Publish(std::move(next));
+    return result;
+  }
+
+  /** @return table metadata by name, or nullptr if no such table exists */
+  TableMetadata *GetTable(const std::string &table_name) {
+    auto snapshot = Load();
+    auto oid = snapshot->names_.find(table_name);
+    if (oid == snapshot->names_.end()) {
+      return nullptr;
+    }
+    auto table = snapshot->tables_.find(oid->second);
+    return table == snapshot->tables_.end() ? nullptr : EnsureHeap(table->second.get());
+  }
 
-  /** @return table metadata by oid */
-  TableMetadata *GetTable(table_oid_t table_oid) { return nullptr; }
+  /** @return table metadata by oid, or nullptr if no such table exists */
+  TableMetadata *GetTable(table_oid_t table_oid) {
+    auto snapshot = Load();
+    auto table = snapshot->tables_.find(table_oid);
+    if (table == snapshot->tables_.end()) {
+      return nullptr;
+    }
+    return EnsureHeap(table->second.get());
+  }
+
+  /**
+   * Pins the current catalog version. Lookups against the handle resolve the same way for as
+   * long as it is held, no matter what DDL publishes in between, and involve no catalog
+   * synchronization at all -- the maps behind a version never change. A query that pins at
+   * start therefore sees one consistent catalog for its whole lifetime.
+   * @return the pinned version
+   */
+  Version PinVersion() const { return Load(); }
+
+  /** @return table metadata by name, resolved against a pinned version */
+  TableMetadata *GetTable(const Version &version, const std::string &table_name) {
+    auto oid = version->names_.find(table_name);
+    if (oid == version->names_.end()) {
+      return nullptr;
+    }
+    auto table = version->tables_.find(oid->second);
+    return table == version->tables_.end() ? nullptr : EnsureHeap(table->second.get());
+  }
+
+  /** @return table metadata by oid, resolved against a pinned version */
+  TableMetadata *GetTable(const Version &version, table_oid_t table_oid) {
+    auto table = version->tables_.find(table_oid);
+    if (table == version->tables_.end()) {
+      return nullptr;
+    }
+    return EnsureHeap(table->second.get());
+  }
+
+  /**
+   * Reads the header pages of every attached-but-untouched table into the buffer pool with a
+   * single FetchPages call, so the disk sees one sorted batch instead of a random read per
+   * table when the first queries arrive. Optional -- without it each header is simply read on
+   * demand -- and cheap to call again: already-materialized tables are skipped.
+   * @return the number of header pages fetched
+   */
+  size_t WarmAttachedTables() {
+    auto snapshot = Load();
+    std::vector<page_id_t> header_pages;
+    for (const auto &[oid, table] : snapshot->tables_) {
+      if (table->table_ == nullptr) {
+        header_pages.push_back(table->first_page_id_);
+      }
+    }
+    if (header_pages.empty()) {
+      return 0;
+    }
+    std::vector<Page *> pages;
+    bpm_->FetchPages(header_pages, &pages);
+    size_t fetched = 0;
+    for (size_t i = 0; i < pages.size(); i++) {
+      if (pages[i] != nullptr) {
+        bpm_->UnpinPage(header_pages[i], false);
+        fetched++;
+      }
+    }
+    return fetched;
+  }
+
+  /**
+   * Pins a table's pages into the buffer pool for the process's lifetime, turning its page
+   * accesses into direct frame-pointer derefs; see TableHeap::PinForLifetime. Meant for small
+   * hot lookup tables that every query resolves against. Call after the table is loaded and
+   * before it sees concurrent access; the pins are never released.
+   * @param table_name the table to pin
+   * @return the number of pages pinned, 0 if the table does not exist or the pool cannot hold it
+   */
+  size_t PinTable(const std::string &table_name) {
+    TableMetadata *table = GetTable(table_name);
+    if (table == nullptr) {
+      return 0;
+    }
+    return table->table_->PinForLifetime();
+  }
+
+  /**
+   * Create a B+ tree index over a table and return its metadata. The index is backfilled from
+   * the rows already stored, then registered with the table's heap, whose write paths keep it
+   * current from there on -- so a registered index can be trusted instead of falling back to a
+   * scan. Keys are extracted against the storage schema, so a dictionary-encoded column
+   * indexes its codes, not its strings.
+   * @param txn the transaction in which the index is being created
+   * @param index_name the name of the new index, unique within its table
+   * @param table_name the table to index
+   * @param key_attrs the indexed columns, as storage-schema column indexes
+   * @return a pointer to the metadata of the new index
+   */
+  template <class KeyType, class ValueType, class KeyComparator>
+  IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                         const std::vector<uint32_t> &key_attrs) {
+    std::scoped_lock lock{ddl_latch_};
+    TableMetadata *table = GetTableLocked(table_name);
+    BUSTUB_ASSERT(table != nullptr, "Cannot index a table that does not exist.");
+    auto table_indexes = snapshot_->index_names_.find(table_name);
+    BUSTUB_ASSERT(table_indexes == snapshot_->index_names_.end() || table_indexes->second.count(index_name) == 0,
+                  "Index names should be unique per table!");
+    auto *metadata = new IndexMetadata(index_name, table_name, &table->schema_, key_attrs);
+    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_);
+    // Backfill before registering, so concurrent inserts cannot be double-entered.
+    for (auto it = table->table_->Begin(txn); it != table->table_->End(); ++it) {
+      index->InsertEntry(it->KeyFromTuple(&table->schema_, index->GetKeySchema(), key_attrs), it->GetRid(), txn);
+    }
+    table->table_->RegisterIndex(index.get());
+    index_oid_t oid = next_index_oid_++;
+    auto info = std::make_shared<IndexInfo>(index_name, table_name, std::move(index), oid);
+    IndexInfo *result = info.get();
+    auto next = std::make_shared<Snapshot>(*snapshot_);
+    next->indexes_[oid] = std::move(info);
+    next->index_names_[table_name][index_name] = oid;
+    Publish(std::move(next));
+    return result;
+  }
+
+  /**
+   * Create a B+ tree index, resolving the key width once at creation time. The key schema's
+   * byte length picks the narrowest GenericKey specialization that fits, so every later probe
+   * runs fixed-width loads and compares with no per-key size branch; width never has to be
+   * rechecked because it is baked into the instantiation behind the virtual Index interface.
+   * Keys wider than 64 bytes are rejected, matching the widest instantiation we build.
+   * @param txn the transaction in which the index is being created
+   * @param index_name the name of the new index, unique within its table
+   * @param table_name the table to index
+   * @param key_attrs the indexed columns, as storage-schema column indexes
+   * @return a pointer to the metadata of the new index
+   */
+  IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                         const std::vector<uint32_t> &key_attrs) {
+    TableMetadata *table = GetTable(table_name);
+    BUSTUB_ASSERT(table != nullptr, "Cannot index a table that does not exist.");
+    uint32_t key_size = Schema::CopySchema(&table->schema_, key_attrs)->GetLength();
+    if (key_size <= 4) {
+      return CreateIndex<GenericKey<4>, RID, GenericComparator<4>>(txn, index_name, table_name, key_attrs);
+    }
+    if (key_size <= 8) {
+      return CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(txn, index_name, table_name, key_attrs);
+    }
+    if (key_size <= 16) {
+      return CreateIndex<GenericKey<16>, RID, GenericComparator<16>>(txn, index_name, table_name, key_attrs);
+    }
+    if (key_size <= 32) {
+      return CreateIndex<GenericKey<32>, RID, GenericComparator<32>>(txn, index_name, table_name, key_attrs);
+    }
+    BUSTUB_ASSERT(key_size <= 64, "Index keys wider than 64 bytes are not supported.");
+    return CreateIndex<GenericKey<64>, RID, GenericComparator<64>>(txn, index_name, table_name, key_attrs);
+  }
+
+  /** @return index metadata by name, or nullptr if the table has no index of that name */
+  IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) {
+    auto snapshot = Load();
+    auto table = snapshot->index_names_.find(table_name);
+    if (table == snapshot->index_names_.end()) {
+      return nullptr;
+    }
+    auto oid = table->second.find(index_name);
+    if (oid == table->second.end()) {
+      return nullptr;
+    }
+    auto index = snapshot->indexes_.find(oid->second);
+    return index == snapshot->indexes_.end() ? nullptr : index->second.get();
+  }
+
+  /** @return index metadata by oid */
+  IndexInfo *GetIndex(index_oid_t index_oid) {
+    auto snapshot = Load();
+    auto index = snapshot->indexes_.find(index_oid);
+    if (index == snapshot->indexes_.end()) {
+      return nullptr;
+    }
+    return index->second.get();
+  }
+
+  /**
+   * Create a zone map over a table and return it. Existing rows are loaded first, then the
+   * map is registered with the table's heap, whose write paths keep it current from there on
+   * -- so scans may trust it for page pruning. Ranges are recorded against the storage
+   * schema, so a dictionary-encoded column maps its codes, not its strings.
+   * @param txn the transaction in which the zone map is being created
+   * @param table_name the table to map
+   * @param cols the mapped columns, as storage-schema column indexes
+   * @return a pointer to the new zone map
+   */
+  ZoneMap *CreateZoneMap(Transaction *txn, const std::string &table_name, const std::vector<uint32_t> &cols) {
+    // Installs into existing metadata -- no snapshot swap -- but it is DDL, so serialize it.
+    std::scoped_lock lock{ddl_latch_};
+    TableMetadata *table = GetTableLocked(table_name);
+    BUSTUB_ASSERT(table != nullptr, "Cannot map a table that does not exist.");
+    BUSTUB_ASSERT(table->zone_map_ == nullptr, "The table already has a zone map.");
+    auto zone_map = std::make_unique<ZoneMap>(cols);
+    // Load before registering, exactly like an index backfill.
+    for (auto it = table->table_->Begin(txn); it != table->table_->End(); ++it) {
+      zone_map->Update(it->GetRid().GetPageId(), *it, &table->schema_);
+    }
+    table->table_->RegisterZoneMap(zone_map.get());
+    table->zone_map_ = std::move(zone_map);
+    return table->zone_map_.get();
+  }
+
+  /**
+   * Collect statistics for a table (ANALYZE) and store them with its metadata, replacing any
+   * previous collection. Statistics are sampled, see TableStats::Collect; they describe the
+   * table as of this call and go stale as it is written, until the next Analyze.
+   * @param txn the transaction on whose behalf the table is read
+   * @param table_oid the table to analyze
+   * @return a pointer to the freshly collected statistics
+   */
+  const TableStats *Analyze(Transaction *txn, table_oid_t table_oid) {
+    TableMetadata *table = GetTable(table_oid);
+    BUSTUB_ASSERT(table != nullptr, "Cannot analyze a table that does not exist.");
+    table->stats_ = std::make_unique<TableStats>(TableStats::Collect(table->table_.get(), &table->schema_, txn));
+    return table->stats_.get();
+  }
+
+  /** @return the table's statistics from the last Analyze, or nullptr if it has never run */
+  const TableStats *GetStats(table_oid_t table_oid) {
+    TableMetadata *table = GetTable(table_oid);
+    return table == nullptr ? nullptr : table->stats_.get();
+  }
+
+  /** @return the metadata of every index over the given table, in creation order */
+  std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) {
+    auto snapshot = Load();
+    std::vector<IndexInfo *> result;
+    auto table = snapshot->index_names_.find(table_name);
+    if (table == snapshot->index_names_.end()) {
+      return result;
+    }
+    result.reserve(table->second.size());
+    for (const auto &[name, oid] : table->second) {
+      auto index = snapshot->indexes_.find(oid);
+      if (index != snapshot->indexes_.end()) {
+        result.push_back(index->second.get());
+      }
+    }
+    std::sort(result.begin(), result.end(), [](IndexInfo *a, IndexInfo *b) { return a->oid_ < b->oid_; });
+    return result;
+  }
 
  private:
+  /**
+   * Constructs a lazily attached table's heap on the first lookup that returns it. The
+   * constructor just records the first page id -- no page is read until a query touches the
+   * table. Serialized on the DDL latch with a double check, so concurrent first touches build
+   * the heap once; once table_ is set the fast path never takes the latch again.
+   */
+  TableMetadata *EnsureHeap(TableMetadata *table) {
+    if (table->table_ == nullptr) {
+      std::scoped_lock lock{ddl_latch_};
+      EnsureHeapLocked(table);
+    }
+    return table;
+  }
+
+  /** The materialization itself; callers must hold ddl_latch_. */
+  void EnsureHeapLocked(TableMetadata *table) {
+    if (table->table_ == nullptr) {
+      table->table_ = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, table->first_page_id_);
+    }
+  }
+
+  /** Name lookup for DDL paths that already hold ddl_latch_, where GetTable would deadlock. */
+  TableMetadata *GetTableLocked(const std::string &table_name) {
+    auto oid = snapshot_->names_.find(table_name);
+    if (oid == snapshot_->names_.end()) {
+      return nullptr;
+    }
+    auto table = snapshot_->tables_.find(oid->second);
+    if (table == snapshot_->tables_.end()) {
+      return nullptr;
+    }
+    EnsureHeapLocked(table->second.get());
+    return table->second.get();
+  }
+
+  /**
+   * One immutable version of the lookup maps. DDL builds the next version as a copy of the
+   * current one; the metadata objects are shared between versions, so a copy is a handful of
+   * map entries, not a copy of any table.
+   */
+  struct Snapshot {
+    /** tables_ : table identifiers -> table metadata. The snapshots share ownership. */
+    std::unordered_map<table_oid_t, std::shared_ptr<TableMetadata>> tables_;
+    /** names_ : table names -> table identifiers */
+    std::unordered_map<std::string, table_oid_t> names_;
+    /** indexes_ : index identifiers -> index metadata. The snapshots share ownership. */
+    std::unordered_map<index_oid_t, std::shared_ptr<IndexInfo>> indexes_;
+    /** index_names_ : table name -> index names -> index identifiers */
+    std::unordered_map<std::string, std::unordered_map<std::string, index_oid_t>> index_names_;
+  };
+
+  /** @return the current snapshot, pinned for as long as the caller holds it */
+  std::shared_ptr<const Snapshot> Load() const {
+    return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+  }
+
+  /** Makes a new snapshot current. Callers must hold ddl_latch_. */
+  void Publish(std::shared_ptr<const Snapshot> snapshot) {
+    std::atomic_store_explicit(&snapshot_, std::move(snapshot), std::memory_order_release);
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
 
-  /** tables_ : table identifiers -> table metadata. Note that tables_ owns all table metadata. */
-  std::unordered_map<table_oid_t, std::unique_ptr<TableMetadata>> tables_;
-  /** names_ : table names -> table identifiers */
-  std::unordered_map<std::string, table_oid_t> names_;
+  /** The current lookup maps; swapped whole by DDL, loaded atomically by every lookup. */
+  std::shared_ptr<const Snapshot> snapshot_{std::make_shared<Snapshot>()};
+  /** Serializes DDL. Lookups never take it -- they run against whatever snapshot is current. */
+  std::mutex ddl_latch_;
   /** The next table identifier to be used. */
   std::atomic<table_oid_t> next_table_oid_{0};
+  /** The next index identifier to be used. */
+  std::atomic<index_oid_t> next_index_oid_{0};
 };
 }  // namespace bustub
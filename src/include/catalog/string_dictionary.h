@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// string_dictionary.h
+//
+// Identification: src/include/catalog/string_dictionary.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * StringDictionary maps a low-cardinality column's strings to dense 4-byte codes and back.
+ * A dictionary-encoded column stores only the codes in its tuples; the catalog attaches one
+ * dictionary per encoded column and the executors translate at the table boundary -- inserts
+ * intern the string, scans decode surviving rows, and an equality predicate compares codes
+ * without ever touching string bytes.
+ *
+ * Codes are assigned in insertion order and never change or get reclaimed, so a code embedded
+ * in stored tuples stays valid for the life of the table. Insertion order also means codes do
+ * NOT sort like their strings: only equality may be evaluated on codes directly.
+ */
+class StringDictionary {
+ public:
+  /** A code no string ever receives; equality rewrites use it for strings not in the dictionary. */
+  static constexpr int32_t INVALID_CODE = -1;
+
+  /** Interns a string, assigning the next code on first sight. */
+  int32_t GetOrInsertCode(const std::string &str) {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto it = codes_.find(str);
+    if (it != codes_.end()) {
+      return it->second;
+    }
+    auto code = static_cast<int32_t>(strings_.size());
+    strings_.push_back(str);
+    codes_.emplace(str, code);
+    return code;
+  }
+
+  /**
+   * Looks a string up without interning it, for predicate rewrites.
+   * @param str the string to look up
+   * @param[out] code the string's code, untouched if absent
+   * @return true if the string is in the dictionary
+   */
+  bool TryGetCode(const std::string &str, int32_t *code) const {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto it = codes_.find(str);
+    if (it == codes_.end()) {
+      return false;
+    }
+    *code = it->second;
+    return true;
+  }
+
+  /** @return the string behind a code previously handed out by GetOrInsertCode */
+  std::string Decode(int32_t code) const {
+    std::lock_guard<std::mutex> guard(latch_);
+    return strings_[static_cast<size_t>(code)];
+  }
+
+  /** @return the number of distinct strings interned so far */
+  size_t Size() const {
+    std::lock_guard<std::mutex> guard(latch_);
+    return strings_.size();
+  }
+
+ private:
+  mutable std::mutex latch_;
+  /** string -> code; the authority for interning. */
+  std::unordered_map<std::string, int32_t> codes_;
+  /** code -> string; codes index this vector densely. */
+  std::vector<std::string> strings_;
+};
+
+}  // namespace bustub
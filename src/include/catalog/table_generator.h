@@ -25,11 +25,13 @@ class TableGenerator {
    */
   void GenerateTestTables();
 
- private:
   /**
-   * Enumeration to characterize the distribution of values in a given column
+   * Enumeration to characterize the distribution of values in a given column. The Zipf
+   * variants draw from a Zipfian with the named skew (Zipf_99 is theta = 0.99, heavily
+   * skewed); Cluster emits runs of duplicate values, so equal keys land on consecutive
+   * rows the way time-correlated production keys do.
    */
-  enum class Dist : uint8_t { Uniform, Zipf_50, Zipf_75, Zipf_95, Zipf_99, Serial };
+  enum class Dist : uint8_t { Uniform, Zipf_50, Zipf_75, Zipf_95, Zipf_99, Serial, Cluster };
 
   /**
    * Metadata about the data for a given column. Specifically, the type of the
@@ -61,15 +63,26 @@ class TableGenerator {
      */
     uint64_t max_;
     /**
-     * Counter to generate serial data
+     * Counter to generate serial data; Cluster columns advance it too, one per row
      */
     uint64_t serial_counter_{0};
+    /**
+     * Rows per run of duplicates for a Cluster column
+     */
+    uint64_t cluster_run_{16};
+    /**
+     * Cached zeta(n) for the Zipf variants, recomputed only when the cardinality changes
+     */
+    double zipf_zeta_n_{0};
+    uint64_t zipf_zeta_for_{0};
 
     /**
      * Constructor
      */
-    ColumnInsertMeta(const char *name, const TypeId type, bool nullable, Dist dist, uint64_t min, uint64_t max)
-        : name_(name), type_(type), nullable_(nullable), dist_(dist), min_(min), max_(max) {}
+    ColumnInsertMeta(const char *name, const TypeId type, bool nullable, Dist dist, uint64_t min, uint64_t max,
+                     uint64_t cluster_run = 16)
+        : name_(name), type_(type), nullable_(nullable), dist_(dist), min_(min), max_(max),
+          cluster_run_(cluster_run) {}
   };
 
   /**
@@ -97,14 +110,36 @@ class TableGenerator {
         : name_(name), num_rows_(num_rows), col_meta_(std::move(col_meta)) {}
   };
 
+  /**
+   * Creates and fills one table from caller-supplied metadata, so a benchmark can dial the
+   * row count and per-column distributions -- e.g. a million-row heap with a Zipf_99 join key
+   * -- instead of being limited to the fixed test fixtures.
+   * @param table_meta the table's name, row count and column distributions
+   * @return the new table's catalog metadata
+   */
+  TableMetadata *GenerateTable(TableInsertMeta *table_meta);
+
+ private:
   void FillTable(TableMetadata *info, TableInsertMeta *table_meta);
 
+  /**
+   * The parallel load path of FillTable: the row range is partitioned across the context's
+   * thread pool, each worker generates its partition and batch-inserts it into a private
+   * heap (its own run of pages, no latch contention), and the runs are linked onto the
+   * table's chain in partition order at the end. Serial columns stay globally serial: each
+   * worker's counters start at its partition's first row.
+   */
+  void ParallelFillTable(TableMetadata *info, TableInsertMeta *table_meta);
+
   std::vector<Value> MakeValues(ColumnInsertMeta *col_meta, uint32_t count);
 
   template <typename CppType>
   std::vector<Value> GenNumericValues(ColumnInsertMeta *col_meta, uint32_t count);
 
  private:
+  /** Tables at least this many rows load through ParallelFillTable. */
+  static constexpr uint32_t PARALLEL_LOAD_THRESHOLD = 1U << 16;
+
   ExecutorContext *exec_ctx_;
 };
 }  // namespace bustub
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_stats.h
+//
+// Identification: src/include/catalog/table_stats.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/util/hash_util.h"
+#include "common/util/hyperloglog.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/**
+ * Statistics for a single column, gathered from the sampled pages. min_ and max_ stay
+ * INVALID-typed until a non-null value has been seen, so an all-null (or unsampled) column
+ * reads as having no range. ndv_ is a HyperLogLog estimate over the sampled rows and is a
+ * lower bound for the whole table; null_count_ and the per-column estimates are not scaled,
+ * only TableStats::row_count_ is.
+ */
+struct ColumnStats {
+  Value min_{TypeId::INVALID};
+  Value max_{TypeId::INVALID};
+  /** Estimated number of distinct non-null values among the sampled rows. */
+  size_t ndv_{0};
+  /** Number of null values among the sampled rows. */
+  size_t null_count_{0};
+};
+
+/**
+ * Table-level statistics: an estimated row count plus per-column ranges and distinct-count
+ * sketches, collected by ANALYZE (SimpleCatalog::Analyze) and stored next to the table's
+ * metadata for planners and executors to consult -- e.g. to put the smaller input on the
+ * build side of a hash join.
+ *
+ * Collect() samples whole pages rather than individual rows: page count is estimated from
+ * the page directory, a sampling rate is derived so that roughly SAMPLE_TARGET_PAGES pages
+ * are processed, and rows on unsampled pages are skipped without extracting or hashing any
+ * values. The iterator still walks the chain, but the per-row work -- which dominates --
+ * only happens on the sample, and the row count is scaled back up by the fraction of pages
+ * actually processed.
+ */
+class TableStats {
+ public:
+  /** Roughly this many pages are processed per Collect(), however large the table. */
+  static constexpr size_t SAMPLE_TARGET_PAGES = 64;
+
+  /**
+   * Collects statistics for a table by sampling its pages.
+   * @param table the heap to sample
+   * @param schema the storage schema of the table; a dictionary column is measured over
+   * its codes, so its ndv_ is meaningful but its min_/max_ range the codes
+   * @param txn the transaction on whose behalf pages are read
+   * @return the collected statistics
+   */
+  static TableStats Collect(TableHeap *table, const Schema *schema, Transaction *txn) {
+    TableStats stats;
+    uint32_t column_count = schema->GetColumnCount();
+    stats.columns_.resize(column_count);
+    std::vector<HyperLogLog> sketches(column_count);
+
+    // The directory has one entry per DIRECTORY_INTERVAL chain positions, so it bounds the
+    // chain length without walking it; take every rate-th page to land near the target.
+    size_t page_estimate = std::max<size_t>(1, table->GetPageDirectory().size() * TableHeap::DIRECTORY_INTERVAL);
+    size_t rate = std::max<size_t>(1, page_estimate / SAMPLE_TARGET_PAGES);
+
+    page_id_t current_page = INVALID_PAGE_ID;
+    size_t page_ordinal = 0;
+    size_t pages_seen = 0;
+    size_t pages_sampled = 0;
+    size_t rows_sampled = 0;
+    bool in_sample = false;
+    for (auto it = table->Begin(txn); it != table->End(); ++it) {
+      if (it->GetRid().GetPageId() != current_page) {
+        current_page = it->GetRid().GetPageId();
+        in_sample = page_ordinal % rate == 0;
+        page_ordinal++;
+        pages_seen++;
+        if (in_sample) {
+          pages_sampled++;
+        }
+      }
+      if (!in_sample) {
+        continue;
+      }
+      rows_sampled++;
+      for (uint32_t i = 0; i < column_count; i++) {
+        Value v = it->GetValue(schema, i);
+        ColumnStats &col = stats.columns_[i];
+        if (v.IsNull()) {
+          col.null_count_++;
+          continue;
+        }
+        sketches[i].Insert(HashUtil::HashValue(&v));
+        if (col.min_.GetTypeId() == TypeId::INVALID || v.CompareLessThan(col.min_) == CmpBool::CmpTrue) {
+          col.min_ = v;
+        }
+        if (col.max_.GetTypeId() == TypeId::INVALID || v.CompareGreaterThan(col.max_) == CmpBool::CmpTrue) {
+          col.max_ = v;
+        }
+      }
+    }
+
+    // Scale the sampled row count back up to the whole chain.
+    double scale = pages_sampled == 0 ? 1.0 : static_cast<double>(pages_seen) / static_cast<double>(pages_sampled);
+    stats.row_count_ = static_cast<size_t>(static_cast<double>(rows_sampled) * scale + 0.5);
+    for (uint32_t i = 0; i < column_count; i++) {
+      stats.columns_[i].ndv_ = sketches[i].Estimate();
+    }
+    return stats;
+  }
+
+  /** Estimated total row count, scaled up from the sample. */
+  size_t row_count_{0};
+  /** Per-column statistics, indexed by storage-schema column index. */
+  std::vector<ColumnStats> columns_;
+};
+
+}  // namespace bustub
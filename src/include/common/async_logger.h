@@ -0,0 +1,218 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_logger.h
+//
+// Identification: src/include/common/async_logger.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace bustub {
+
+/**
+ * The asynchronous backend behind the LOG_* macros. A call site formats its message into a
+ * slot of a per-thread staging ring -- no lock, no syscall, no flush -- and a background
+ * drain thread moves staged messages to the output stream in batches, flushing once per
+ * batch instead of once per message. That keeps a hot path with info logging enabled at
+ * in-memory cost while the drain thread absorbs the I/O.
+ *
+ * Messages from one thread appear in order; messages from different threads may interleave
+ * differently than their wall-clock order, which diagnostics tolerate (each line carries its
+ * own timestamp). When a thread logs faster than the drainer writes, the full ring makes the
+ * producer wait rather than drop diagnostics. Flush() blocks until everything staged before
+ * the call is on the stream; the singleton's destructor does the same at process exit.
+ */
+class AsyncLogger {
+ public:
+  /** @return the process-wide logger, started on first use */
+  static AsyncLogger &Instance() {
+    static AsyncLogger logger;
+    return logger;
+  }
+
+  /**
+   * Stages one formatted log line; the header matches the synchronous logger's format.
+   * @param level the level tag of the message ("ERROR", "INFO ", ...)
+   * @param file the call site's file name
+   * @param line the call site's line number
+   * @param func the call site's function name
+   * @param fmt printf format of the message, followed by its arguments
+   */
+  void Append(const char *level, const char *file, int line, const char *func, const char *fmt, ...)
+      __attribute__((format(printf, 6, 7))) {
+    char message[Ring::SLOT_SIZE];
+    int offset = FormatHeader(message, sizeof(message), level, file, line, func);
+    va_list args;
+    va_start(args, fmt);
+    int written = vsnprintf(message + offset, sizeof(message) - static_cast<size_t>(offset) - 1, fmt, args);
+    va_end(args);
+    if (written < 0) {
+      return;
+    }
+    auto length = static_cast<size_t>(offset) + static_cast<size_t>(written);
+    length = std::min(length, Ring::SLOT_SIZE - 2);  // long messages truncate into the slot
+    message[length++] = '\n';
+
+    Ring *ring = MyRing();
+    uint64_t tail = ring->tail_.load(std::memory_order_relaxed);
+    while (tail - ring->head_.load(std::memory_order_acquire) == Ring::SLOTS) {
+      // Ring full: wait for the drainer rather than drop the message.
+      cv_.notify_one();
+      std::this_thread::yield();
+    }
+    std::memcpy(ring->slots_[tail % Ring::SLOTS].data(), message, length);
+    ring->lengths_[tail % Ring::SLOTS] = static_cast<uint16_t>(length);
+    ring->tail_.store(tail + 1, std::memory_order_release);
+    cv_.notify_one();
+  }
+
+  /** Blocks until every message staged before this call has reached the output stream. */
+  void Flush() {
+    uint64_t target = flush_requests_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    cv_.notify_one();
+    std::unique_lock lock(latch_);
+    flushed_cv_.wait(lock, [this, target] { return flushes_done_.load(std::memory_order_acquire) >= target; });
+  }
+
+  /**
+   * Redirects output, draining what is staged first. For tests; the default is the same
+   * stream the synchronous logger wrote to.
+   * @param stream the stream future messages are written to
+   */
+  void SetStream(FILE *stream) {
+    Flush();
+    stream_.store(stream, std::memory_order_release);
+  }
+
+ private:
+  /** One thread's staging buffer: the owning thread fills, only the drainer empties. */
+  struct Ring {
+    static constexpr size_t SLOTS = 256;
+    static constexpr size_t SLOT_SIZE = 256;
+    std::array<std::array<char, SLOT_SIZE>, SLOTS> slots_;
+    std::array<uint16_t, SLOTS> lengths_;
+    /** Next slot to drain; owned by the drain thread. */
+    std::atomic<uint64_t> head_{0};
+    /** Next slot to fill; owned by the staging thread. */
+    std::atomic<uint64_t> tail_{0};
+    /** Set when the owning thread exits; the drainer empties the ring, then drops it. */
+    std::atomic<bool> retired_{false};
+  };
+
+  /** Registers the ring on first use and retires it when its thread exits. */
+  struct RingHolder {
+    explicit RingHolder(AsyncLogger *logger) : ring_(std::make_shared<Ring>()) {
+      std::scoped_lock lock(logger->latch_);
+      logger->rings_.push_back(ring_);
+    }
+    ~RingHolder() { ring_->retired_.store(true, std::memory_order_release); }
+    std::shared_ptr<Ring> ring_;
+  };
+
+  AsyncLogger() {
+    drain_thread_ = std::thread([this] {
+      while (true) {
+        {
+          std::unique_lock lock(latch_);
+          cv_.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        uint64_t requests = flush_requests_.load(std::memory_order_acquire);
+        DrainAll();
+        if (requests > flushes_done_.load(std::memory_order_relaxed)) {
+          {
+            // Taken so a Flush caller between its predicate check and its wait cannot miss this.
+            std::scoped_lock lock(latch_);
+            flushes_done_.store(requests, std::memory_order_release);
+          }
+          flushed_cv_.notify_all();
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+          DrainAll();
+          return;
+        }
+      }
+    });
+  }
+
+  ~AsyncLogger() {
+    stopping_.store(true, std::memory_order_release);
+    cv_.notify_one();
+    drain_thread_.join();
+  }
+
+  Ring *MyRing() {
+    thread_local RingHolder holder(this);
+    return holder.ring_.get();
+  }
+
+  /** One drain pass over every ring; flushes the stream if anything moved. */
+  void DrainAll() {
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+      std::scoped_lock lock(latch_);
+      // Drop rings whose threads exited once they are empty.
+      auto retired_and_empty = [](const std::shared_ptr<Ring> &ring) {
+        return ring->retired_.load(std::memory_order_acquire) &&
+               ring->head_.load(std::memory_order_relaxed) == ring->tail_.load(std::memory_order_acquire);
+      };
+      rings_.erase(std::remove_if(rings_.begin(), rings_.end(), retired_and_empty), rings_.end());
+      rings = rings_;
+    }
+    FILE *stream = stream_.load(std::memory_order_acquire);
+    bool wrote = false;
+    for (auto &ring : rings) {
+      uint64_t head = ring->head_.load(std::memory_order_relaxed);
+      uint64_t tail = ring->tail_.load(std::memory_order_acquire);
+      for (; head != tail; head++) {
+        fwrite(ring->slots_[head % Ring::SLOTS].data(), 1, ring->lengths_[head % Ring::SLOTS], stream);
+        wrote = true;
+      }
+      ring->head_.store(head, std::memory_order_release);
+    }
+    if (wrote) {
+      fflush(stream);
+    }
+  }
+
+  /** Writes the "time [file:line:func] LEVEL - " prefix; the format OutputLogHeader used. */
+  static int FormatHeader(char *buffer, size_t size, const char *level, const char *file, int line, const char *func) {
+    time_t t = ::time(nullptr);
+    tm cur_time;
+    localtime_r(&t, &cur_time);
+    char time_str[32];
+    ::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", &cur_time);
+    int written = snprintf(buffer, size, "%s [%s:%d:%s] %s - ", time_str, file, line, func, level);
+    return written < 0 ? 0 : std::min(written, static_cast<int>(size) - 1);
+  }
+
+  std::vector<std::shared_ptr<Ring>> rings_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::condition_variable flushed_cv_;
+  std::atomic<FILE *> stream_{stdout};
+  std::atomic<uint64_t> flush_requests_{0};
+  std::atomic<uint64_t> flushes_done_{0};
+  std::atomic<bool> stopping_{false};
+  std::thread drain_thread_;
+};
+
+}  // namespace bustub
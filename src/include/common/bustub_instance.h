@@ -14,25 +14,43 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
+#include "common/memory_tracker.h"
+#include "common/thread_pool.h"
 #include "concurrency/lock_manager.h"
 #include "recovery/checkpoint_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_uring.h"
 
 namespace bustub {
 
+/** The disk I/O backends a BustubInstance can be constructed with. */
+enum class DiskBackend { STREAM, URING, DIRECT };
+
 class BustubInstance {
  public:
-  explicit BustubInstance(const std::string &db_file_name) {
+  explicit BustubInstance(const std::string &db_file_name, DiskBackend disk_backend = DiskBackend::STREAM,
+                          bool prewarm = false) {
     enable_logging = false;
 
     // storage related
-    disk_manager_ = new DiskManager(db_file_name);
+    if (disk_backend == DiskBackend::URING) {
+      disk_manager_ = new DiskManagerUring(db_file_name);
+    } else if (disk_backend == DiskBackend::DIRECT) {
+      disk_manager_ = new DiskManagerUring(db_file_name, /*use_direct_io=*/true);
+    } else {
+      disk_manager_ = new DiskManager(db_file_name);
+    }
 
     // log related
     log_manager_ = new LogManager(disk_manager_);
 
     buffer_pool_manager_ = new BufferPoolManager(BUFFER_POOL_SIZE, disk_manager_, log_manager_);
+    if (prewarm) {
+      // Replay the warm-set sidecar (if any) before serving traffic, so the pool does not refill
+      // one miss at a time after a restart.
+      buffer_pool_manager_->LoadWarmSet();
+    }
 
     // txn related
     lock_manager_ = new LockManager(TwoPLMode::STRICT, DeadlockMode::PREVENTION);  // S2PL
@@ -40,12 +58,19 @@ class BustubInstance {
 
     // checkpoints
     checkpoint_manager_ = new CheckpointManager(transaction_manager_, log_manager_, buffer_pool_manager_);
+
+    // execution related: one worker pool shared by every query's parallel operators
+    thread_pool_ = new ThreadPool();
+    // one memory budget shared by every query's buffering operators
+    memory_tracker_ = new MemoryTracker(EXECUTOR_MEMORY_BUDGET);
   }
 
   ~BustubInstance() {
     if (enable_logging) {
       log_manager_->StopFlushThread();
     }
+    delete memory_tracker_;
+    delete thread_pool_;
     delete checkpoint_manager_;
     delete log_manager_;
     delete buffer_pool_manager_;
@@ -60,6 +85,8 @@ class BustubInstance {
   TransactionManager *transaction_manager_;
   LogManager *log_manager_;
   CheckpointManager *checkpoint_manager_;
+  ThreadPool *thread_pool_;
+  MemoryTracker *memory_tracker_;
 };
 
 }  // namespace bustub
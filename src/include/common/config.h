@@ -21,6 +21,12 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** The buffer pool's background flusher writes dirty frames every DIRTY_FLUSH_INTERVAL milliseconds. */
+extern std::chrono::milliseconds dirty_flush_interval;
+
+/** The checkpoint scheduler re-evaluates its trigger thresholds every CHECKPOINT_POLL_INTERVAL milliseconds. */
+extern std::chrono::milliseconds checkpoint_poll_interval;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
@@ -34,8 +40,20 @@ static constexpr int HEADER_PAGE_ID = 0;                                      //
 static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
+static constexpr int LOG_SEGMENT_SIZE = 4 * LOG_BUFFER_SIZE;                  // size of one preallocated WAL segment file
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr size_t LRUK_REPLACER_K = 2;                                  // default k for the LRU-K replacer
+static constexpr size_t ADAPTIVE_REPLACER_WINDOW = 256;                       // misses per adaptive-replacer sample window
+static constexpr size_t BPM_FRAME_WAIT_RETRIES = 16;                          // eviction retries before a full pool is starvation
+static constexpr size_t BPM_FRAME_WAIT_INTERVAL_US = 50;                      // base backoff between eviction retries
+static constexpr size_t DIRECT_IO_ALIGNMENT = 512;                            // buffer alignment required for O_DIRECT
+static constexpr size_t BACKUP_CHUNK_SIZE = 1 << 20;                          // bytes per sequential backup-copy read
+static constexpr size_t CACHE_LINE_SIZE = 64;                                 // coherence granularity, for false-sharing layout
+static constexpr size_t EXECUTOR_MEMORY_BUDGET = 64UL * 1024 * 1024;          // process-wide budget for buffering operators
+static constexpr size_t CHECKPOINT_WAL_BYTE_BUDGET = 4UL * LOG_SEGMENT_SIZE;  // WAL bytes a restart may have to replay
+static constexpr double CHECKPOINT_DIRTY_FRAME_RATIO = 0.75;                  // dirty-frame fraction that forces a checkpoint
 
+using timestamp_t = uint64_t;  // MVCC read/commit timestamp type
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
 using txn_id_t = int32_t;      // transaction id type
@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.h
+//
+// Identification: src/include/common/epoch_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Epoch-based memory reclamation for lock-free structures.
+ *
+ * A lock-free reader may hold a raw pointer into a structure while another thread unlinks the
+ * node it points at; the node's memory must not be freed until every such reader is provably
+ * gone. The classic three-epoch scheme makes that proof cheap: each registered thread announces
+ * the global epoch when it enters a read-side critical section (one relaxed-ish store, no RMW,
+ * no shared-cacheline contention beyond the announcement itself), unlinked nodes are retired
+ * into the current epoch's limbo list instead of freed, and the global epoch only advances when
+ * every in-section thread has caught up to it. By the advance out of epoch e + 2, no reader
+ * that could have seen a node retired in epoch e remains, and its limbo list is drained.
+ *
+ * Registration hands a thread a fixed slot so the announcement is a store into its own cache
+ * line; the epoch advance is the only operation that reads them all. Advancing is cooperative
+ * and off the fast path -- call TryAdvance from maintenance points (a structure's resize, a
+ * background thread) rather than from readers. Retirement takes a short mutex on the limbo
+ * lists; it is on the writer's unlink path, which already paid for an atomic RMW, not on the
+ * read path.
+ */
+class EpochManager {
+ public:
+  /** Registered threads get one announcement slot each; plenty for the pools this tree runs. */
+  static constexpr size_t MAX_THREADS = 256;
+
+  EpochManager() = default;
+
+  /** Everything still in limbo is unreachable by now -- the structure's users are gone. */
+  ~EpochManager() {
+    for (auto &list : limbo_) {
+      for (auto &[ptr, deleter] : list) {
+        deleter(ptr);
+      }
+    }
+  }
+
+  DISALLOW_COPY(EpochManager);
+
+  /**
+   * Claims an announcement slot for the calling thread. A thread registers once (per manager)
+   * and reuses its slot for every critical section; pool workers typically register at pool
+   * attach and unregister at detach.
+   * @return the slot to pass to Enter/Exit/UnregisterThread
+   */
+  size_t RegisterThread() {
+    for (size_t i = 0; i < MAX_THREADS; i++) {
+      if (!slots_[i].registered_.exchange(true, std::memory_order_acq_rel)) {
+        slots_[i].epoch_.store(INACTIVE, std::memory_order_release);
+        return i;
+      }
+    }
+    UNREACHABLE("More threads than EpochManager slots; raise MAX_THREADS.");
+  }
+
+  /** Releases a slot claimed by RegisterThread. The thread must be outside any section. */
+  void UnregisterThread(size_t slot) {
+    slots_[slot].epoch_.store(INACTIVE, std::memory_order_release);
+    slots_[slot].registered_.store(false, std::memory_order_release);
+  }
+
+  /**
+   * Enters a read-side critical section: announces the current global epoch in the thread's
+   * slot. Pointers read from the protected structure stay valid until Exit. The store is
+   * sequentially consistent so the announcement is visible before any protected load -- the
+   * one fence a reader pays.
+   * @param slot the calling thread's slot
+   */
+  void Enter(size_t slot) {
+    slots_[slot].epoch_.store(global_epoch_.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+  }
+
+  /** Leaves the critical section; protected pointers must not be dereferenced afterwards. */
+  void Exit(size_t slot) { slots_[slot].epoch_.store(INACTIVE, std::memory_order_release); }
+
+  /**
+   * Retires a node unlinked from the protected structure: it is freed with the given deleter
+   * once two epoch advances prove no reader can still hold it. Called by the unlinking writer,
+   * inside or outside a critical section.
+   * @param ptr the unlinked node
+   * @param deleter invoked exactly once to free it
+   */
+  void Retire(void *ptr, void (*deleter)(void *)) {
+    std::lock_guard<std::mutex> guard(limbo_latch_);
+    limbo_[global_epoch_.load(std::memory_order_relaxed) % 3].emplace_back(ptr, deleter);
+  }
+
+  /** Retires a node to be freed with delete, the common case. */
+  template <typename T>
+  void Retire(T *ptr) {
+    Retire(ptr, [](void *p) { delete static_cast<T *>(p); });
+  }
+
+  /**
+   * Attempts one quiescent-state advance: if every registered thread is outside a section or
+   * already announcing the current epoch, the global epoch moves forward and the limbo list
+   * two epochs back -- whose nodes no surviving reader can hold -- is drained. Cooperative
+   * and cheap to call when it fails; structures call it at maintenance points, not per read.
+   * @return true when the epoch advanced
+   */
+  bool TryAdvance() {
+    uint64_t epoch = global_epoch_.load(std::memory_order_seq_cst);
+    for (size_t i = 0; i < MAX_THREADS; i++) {
+      if (!slots_[i].registered_.load(std::memory_order_acquire)) {
+        continue;
+      }
+      uint64_t announced = slots_[i].epoch_.load(std::memory_order_seq_cst);
+      if (announced != INACTIVE && announced != epoch) {
+        return false;
+      }
+    }
+    std::vector<std::pair<void *, void (*)(void *)>> reclaimable;
+    {
+      std::lock_guard<std::mutex> guard(limbo_latch_);
+      // A racing advance got here first; its drain covered the same garbage.
+      if (global_epoch_.load(std::memory_order_relaxed) != epoch) {
+        return false;
+      }
+      // With three lists, (epoch + 1) % 3 is the one filled two epochs ago.
+      reclaimable.swap(limbo_[(epoch + 1) % 3]);
+      global_epoch_.store(epoch + 1, std::memory_order_seq_cst);
+    }
+    // Free outside the latch; deleters can be arbitrarily expensive.
+    for (auto &[ptr, deleter] : reclaimable) {
+      deleter(ptr);
+    }
+    return true;
+  }
+
+  /** @return the current global epoch, for tests and diagnostics */
+  uint64_t CurrentEpoch() const { return global_epoch_.load(std::memory_order_acquire); }
+
+ private:
+  /** The announcement of a thread outside any critical section. */
+  static constexpr uint64_t INACTIVE = ~static_cast<uint64_t>(0);
+
+  /** One thread's announcement, padded to a cache line so announcements never false-share. */
+  struct alignas(64) Slot {
+    std::atomic<bool> registered_{false};
+    std::atomic<uint64_t> epoch_{INACTIVE};
+  };
+
+  std::atomic<uint64_t> global_epoch_{0};
+  Slot slots_[MAX_THREADS];
+  /** Guards the limbo lists; taken by retirement and the advance's drain, never by readers. */
+  std::mutex limbo_latch_;
+  /** Deferred frees by retirement epoch modulo three; see TryAdvance for the rotation. */
+  std::vector<std::pair<void *, void (*)(void *)>> limbo_[3];
+};
+
+/**
+ * Scoped critical section: Enter on construction, Exit on destruction, so early returns from
+ * a lock-free read path cannot leak an announcement and stall every future advance.
+ */
+class EpochGuard {
+ public:
+  EpochGuard(EpochManager *manager, size_t slot) : manager_(manager), slot_(slot) { manager_->Enter(slot_); }
+  ~EpochGuard() { manager_->Exit(slot_); }
+
+  DISALLOW_COPY(EpochGuard);
+
+ private:
+  EpochManager *manager_;
+  size_t slot_;
+};
+
+}  // namespace bustub
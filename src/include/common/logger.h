@@ -26,16 +26,22 @@
 
 /**
  * Debug logging functions for EE. Unlike the performance counters,
- * these are just fprintf() turned on/off by LOG_LEVEL compile option.
+ * these are turned on/off by LOG_LEVEL compile option.
  * The main concern here is not to add any overhead on runtime performance
  * when the logging is turned off. Use LOG_XXX_ENABLED macros defined here to
  * eliminate all instructions in the final binary.
  * @author Hideaki
+ *
+ * Enabled messages no longer fprintf+fflush at the call site: they stage into
+ * AsyncLogger's per-thread ring and a background thread writes them out, so a
+ * hot path can keep info logging on without serializing on the output stream.
  */
 
 #include <ctime>
 #include <string>
 
+#include "common/async_logger.h"
+
 namespace bustub {
 
 // https://blog.galowicz.de/2016/02/20/short_file_macro/
@@ -98,11 +104,8 @@ void OutputLogHeader(const char *file, int line, const char *func, int level);
 #if LOG_LEVEL <= LOG_LEVEL_ERROR
 #define LOG_ERROR_ENABLED
 // #pragma message("LOG_ERROR was enabled.")
-#define LOG_ERROR(...)                                                      \
-  OutputLogHeader(__SHORT_FILE__, __LINE__, __FUNCTION__, LOG_LEVEL_ERROR); \
-  ::fprintf(LOG_OUTPUT_STREAM, __VA_ARGS__);                                \
-  fprintf(LOG_OUTPUT_STREAM, "\n");                                         \
-  ::fflush(stdout)
+#define LOG_ERROR(...) \
+  bustub::AsyncLogger::Instance().Append("ERROR", __SHORT_FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
 #else
 #define LOG_ERROR(...) ((void)0)
 #endif
@@ -113,11 +116,8 @@ void OutputLogHeader(const char *file, int line, const char *func, int level);
 #if LOG_LEVEL <= LOG_LEVEL_WARN
 #define LOG_WARN_ENABLED
 // #pragma message("LOG_WARN was enabled.")
-#define LOG_WARN(...)                                                      \
-  OutputLogHeader(__SHORT_FILE__, __LINE__, __FUNCTION__, LOG_LEVEL_WARN); \
-  ::fprintf(LOG_OUTPUT_STREAM, __VA_ARGS__);                               \
-  fprintf(LOG_OUTPUT_STREAM, "\n");                                        \
-  ::fflush(stdout)
+#define LOG_WARN(...) \
+  bustub::AsyncLogger::Instance().Append("WARN ", __SHORT_FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
 #else
 #define LOG_WARN(...) ((void)0)
 #endif
@@ -128,11 +128,8 @@ void OutputLogHeader(const char *file, int line, const char *func, int level);
 #if LOG_LEVEL <= LOG_LEVEL_INFO
 #define LOG_INFO_ENABLED
 // #pragma message("LOG_INFO was enabled.")
-#define LOG_INFO(...)                                                      \
-  OutputLogHeader(__SHORT_FILE__, __LINE__, __FUNCTION__, LOG_LEVEL_INFO); \
-  ::fprintf(LOG_OUTPUT_STREAM, __VA_ARGS__);                               \
-  fprintf(LOG_OUTPUT_STREAM, "\n");                                        \
-  ::fflush(stdout)
+#define LOG_INFO(...) \
+  bustub::AsyncLogger::Instance().Append("INFO ", __SHORT_FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
 #else
 #define LOG_INFO(...) ((void)0)
 #endif
@@ -143,11 +140,8 @@ void OutputLogHeader(const char *file, int line, const char *func, int level);
 #if LOG_LEVEL <= LOG_LEVEL_DEBUG
 #define LOG_DEBUG_ENABLED
 // #pragma message("LOG_DEBUG was enabled.")
-#define LOG_DEBUG(...)                                                      \
-  OutputLogHeader(__SHORT_FILE__, __LINE__, __FUNCTION__, LOG_LEVEL_DEBUG); \
-  ::fprintf(LOG_OUTPUT_STREAM, __VA_ARGS__);                                \
-  fprintf(LOG_OUTPUT_STREAM, "\n");                                         \
-  ::fflush(stdout)
+#define LOG_DEBUG(...) \
+  bustub::AsyncLogger::Instance().Append("DEBUG", __SHORT_FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
 #else
 #define LOG_DEBUG(...) ((void)0)
 #endif
@@ -158,11 +152,8 @@ void OutputLogHeader(const char *file, int line, const char *func, int level);
 #if LOG_LEVEL <= LOG_LEVEL_TRACE
 #define LOG_TRACE_ENABLED
 // #pragma message("LOG_TRACE was enabled.")
-#define LOG_TRACE(...)                                                      \
-  OutputLogHeader(__SHORT_FILE__, __LINE__, __FUNCTION__, LOG_LEVEL_TRACE); \
-  ::fprintf(LOG_OUTPUT_STREAM, __VA_ARGS__);                                \
-  fprintf(LOG_OUTPUT_STREAM, "\n");                                         \
-  ::fflush(stdout)
+#define LOG_TRACE(...) \
+  bustub::AsyncLogger::Instance().Append("TRACE", __SHORT_FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
 #else
 #define LOG_TRACE(...) ((void)0)
 #endif
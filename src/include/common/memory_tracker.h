@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_tracker.h
+//
+// Identification: src/include/common/memory_tracker.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * MemoryTracker meters the memory of buffering operators (join builds, aggregation tables,
+ * sort buffers) against a process-wide budget. Operators ask for memory through a
+ * MemoryReservation before growing and take their spill path when the grant is denied, so
+ * concurrent memory-hungry queries degrade to temp I/O instead of driving the process into
+ * swap. Grants are advisory accounting, not an allocator: the operator still allocates
+ * normally, the tracker just decides whether it may.
+ */
+class MemoryTracker {
+ public:
+  /**
+   * Creates a tracker with the given budget.
+   * @param budget the total bytes buffering operators may hold at once
+   */
+  explicit MemoryTracker(size_t budget) : budget_(budget) {}
+
+  /**
+   * Tries to claim bytes against the budget.
+   * @param bytes the number of bytes to claim
+   * @return true if the claim fit in the budget
+   */
+  bool Grant(size_t bytes) {
+    if (used_.fetch_add(bytes, std::memory_order_relaxed) + bytes <= budget_) {
+      return true;
+    }
+    used_.fetch_sub(bytes, std::memory_order_relaxed);
+    return false;
+  }
+
+  /**
+   * Returns claimed bytes to the budget.
+   * @param bytes the number of bytes to return
+   */
+  void Release(size_t bytes) { used_.fetch_sub(bytes, std::memory_order_relaxed); }
+
+  /** @return the bytes currently claimed */
+  size_t Used() const { return used_.load(std::memory_order_relaxed); }
+
+  /** @return the budget in bytes */
+  size_t Budget() const { return budget_; }
+
+ private:
+  /** Bytes currently claimed across all reservations. */
+  std::atomic<size_t> used_{0};
+  /** The total budget in bytes. */
+  size_t budget_;
+};
+
+/**
+ * MemoryReservation is one operator's running claim against a tracker. Reserve() is called
+ * with the operator's current footprint and grows the claim in chunks, so the hot path is
+ * almost always a comparison against the already-reserved amount rather than an atomic on the
+ * shared tracker. Everything is released when the reservation is reset or destroyed. A null
+ * tracker means no budget: every reserve succeeds, which keeps contexts without an attached
+ * tracker (tests, tools) unthrottled.
+ */
+class MemoryReservation {
+ public:
+  /** Creates a reservation against the given tracker, or an unlimited one for nullptr. */
+  explicit MemoryReservation(MemoryTracker *tracker) : tracker_(tracker) {}
+
+  DISALLOW_COPY_AND_MOVE(MemoryReservation);
+
+  ~MemoryReservation() { Release(); }
+
+  /**
+   * Ensures the reservation covers the given footprint.
+   * @param bytes the operator's current footprint in bytes
+   * @return true if the footprint is covered; false if the budget is exhausted and the
+   * operator should spill
+   */
+  bool Reserve(size_t bytes) {
+    if (tracker_ == nullptr || bytes <= reserved_) {
+      return true;
+    }
+    size_t grow = ((bytes - reserved_) + CHUNK - 1) / CHUNK * CHUNK;
+    if (!tracker_->Grant(grow)) {
+      return false;
+    }
+    reserved_ += grow;
+    return true;
+  }
+
+  /** Returns the whole reservation to the tracker, e.g. after the operator spilled. */
+  void Release() {
+    if (tracker_ != nullptr && reserved_ > 0) {
+      tracker_->Release(reserved_);
+      reserved_ = 0;
+    }
+  }
+
+ private:
+  /** Grant granularity; coarse enough that per-row Reserve calls rarely touch the tracker. */
+  static constexpr size_t CHUNK = 64 * 1024;
+
+  /** The shared tracker, or nullptr for an unlimited reservation. */
+  MemoryTracker *tracker_;
+  /** Bytes currently claimed from the tracker. */
+  size_t reserved_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// numa_util.h
+//
+// Identification: src/include/common/numa_util.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bustub {
+
+/**
+ * NUMA placement helpers. On a multi-socket box, memory first-touched (or bound) on one
+ * node costs every other node a remote access; a buffer pool allocated naively lands
+ * entirely on whichever node ran the constructor. These helpers interleave large
+ * allocations across nodes and pin worker threads to a node, so frame accesses average the
+ * local/remote cost instead of paying the remote penalty on all but one socket.
+ *
+ * Everything is best-effort and dependency-free: node topology comes from sysfs, the
+ * binding goes through the raw mbind syscall, and on a single-node machine (or a kernel
+ * without NUMA) every call degrades to plain behavior. Non-Linux builds compile the
+ * fallbacks only.
+ */
+class NumaUtil {
+ public:
+  /** @return the number of NUMA nodes with memory, 1 when undetectable */
+  static size_t NodeCount() {
+    static size_t count = CountNodes();
+    return count;
+  }
+
+  /**
+   * Allocates page-aligned memory interleaved across every node, backed by 2MB huge pages
+   * when the size warrants it (explicit hugetlb if the system has a reservation, otherwise
+   * a transparent-huge-page hint) so a large frame array does not thrash the TLB. The
+   * caller owns the region and frees it with FreeInterleaved.
+   * @param bytes the allocation size
+   * @return the region, or nullptr on failure
+   */
+  static void *AllocateInterleaved(size_t bytes) {
+#ifdef __linux__
+    void *region = MAP_FAILED;
+    if (bytes >= HUGE_PAGE_SIZE) {
+      // Explicit 2MB huge pages first: one TLB entry then covers 512 frames instead of one.
+      // The hugetlb reservation may be absent or too small, so failure is expected and falls
+      // back to normal pages with a transparent-huge-page hint.
+      region = mmap(nullptr, RoundToHugePages(bytes), PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (region == MAP_FAILED) {
+      size_t length = bytes >= HUGE_PAGE_SIZE ? RoundToHugePages(bytes) : bytes;
+      region = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (region == MAP_FAILED) {
+        return nullptr;
+      }
+      if (bytes >= HUGE_PAGE_SIZE) {
+        madvise(region, length, MADV_HUGEPAGE);
+      }
+    }
+    size_t nodes = NodeCount();
+    if (nodes > 1 && nodes < 64) {
+      // MPOL_INTERLEAVE over all nodes; a failure just leaves default (first-touch) policy.
+      uint64_t node_mask = (1ULL << nodes) - 1;
+      syscall(SYS_mbind, region, bytes, MPOL_INTERLEAVE_POLICY, &node_mask, nodes + 1, 0);
+    }
+    return region;
+#else
+    return ::operator new(bytes, std::nothrow);
+#endif
+  }
+
+  /**
+   * Frees a region from AllocateInterleaved.
+   * @param region the region
+   * @param bytes the size it was allocated with
+   */
+  static void FreeInterleaved(void *region, size_t bytes) {
+#ifdef __linux__
+    if (region != nullptr) {
+      // Matches the allocation length: hugetlb mappings must be unmapped at huge-page
+      // granularity, and the allocator rounds any huge-eligible size the same way.
+      munmap(region, bytes >= HUGE_PAGE_SIZE ? RoundToHugePages(bytes) : bytes);
+    }
+#else
+    (void)bytes;
+    ::operator delete(region);
+#endif
+  }
+
+  /**
+   * Pins the calling thread to the CPUs of one node. No-op on a single-node machine, on
+   * failure, or off Linux.
+   * @param node the node whose CPUs the thread should run on
+   */
+  static void PinThreadToNode(size_t node) {
+#ifdef __linux__
+    if (NodeCount() <= 1) {
+      return;
+    }
+    std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if (!cpulist.is_open()) {
+      return;
+    }
+    // The file is ranges like "0-7,16-23".
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    bool any = false;
+    std::string token;
+    while (std::getline(cpulist, token, ',')) {
+      size_t dash = token.find('-');
+      int first = std::stoi(token);
+      int last = dash == std::string::npos ? first : std::stoi(token.substr(dash + 1));
+      for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+        CPU_SET(cpu, &cpus);
+        any = true;
+      }
+    }
+    if (any) {
+      pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#else
+    (void)node;
+#endif
+  }
+
+ private:
+  /** The kernel's MPOL_INTERLEAVE; defined here so no libnuma header is needed. */
+  static constexpr int MPOL_INTERLEAVE_POLICY = 3;
+  /** The x86-64 huge page size; allocations at least this big are huge-page backed. */
+  static constexpr size_t HUGE_PAGE_SIZE = 2UL << 20;
+
+  static constexpr size_t RoundToHugePages(size_t bytes) {
+    return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  }
+
+  static size_t CountNodes() {
+#ifdef __linux__
+    size_t count = 0;
+    while (true) {
+      std::ifstream node("/sys/devices/system/node/node" + std::to_string(count) + "/cpulist");
+      if (!node.is_open()) {
+        break;
+      }
+      count++;
+    }
+    return count == 0 ? 1 : count;
+#else
+    return 1;
+#endif
+  }
+};
+
+}  // namespace bustub
@@ -12,25 +12,39 @@
 
 #pragma once
 
-#include <climits>
+#include <atomic>
 #include <condition_variable>  // NOLINT
+#include <cstdint>
 #include <mutex>               // NOLINT
+#include <thread>              // NOLINT
 
 #include "common/macros.h"
+#include "common/tracer.h"
 
 namespace bustub {
 
 /**
- * Reader-Writer latch backed by std::mutex.
+ * Reader-Writer latch with a single-atomic-word fast path.
+ *
+ * The latch state lives in one 32-bit word: the top bit is the writer flag, the rest count active
+ * readers. An uncontended RLock or WLock is a single compare-and-swap and the matching unlock one
+ * atomic RMW -- page latching in TablePage is the hottest synchronization in the system, so the
+ * old take-a-mutex-per-RLatch implementation was pure overhead. Contended acquisitions spin
+ * briefly before parking on the mutex/condition-variable slow path. Writers are preferred: once a
+ * writer sets its flag, new readers park until it has come and gone.
  */
 class ReaderWriterLatch {
-  using mutex_t = std::mutex;
-  using cond_t = std::condition_variable;
-  static const uint32_t MAX_READERS = UINT_MAX;
+  /** Set while a writer holds the latch or is draining the active readers. */
+  static constexpr uint32_t WRITER = 1U << 31;
+  /** The active reader count occupies the remaining bits. */
+  static constexpr uint32_t READER_MASK = WRITER - 1;
+  /** Failed acquisitions yield this many times before parking. */
+  static constexpr int SPIN_LIMIT = 64;
 
  public:
   ReaderWriterLatch() = default;
-  ~ReaderWriterLatch() { std::lock_guard<mutex_t> guard(mutex_); }
+  // Let a straggling unlock finish touching the parking lot before the latch is destroyed.
+  ~ReaderWriterLatch() { std::lock_guard<std::mutex> guard(mutex_); }
 
   DISALLOW_COPY(ReaderWriterLatch);
 
@@ -38,13 +52,42 @@ class ReaderWriterLatch {
    * Acquire a write latch.
    */
   void WLock() {
-    std::unique_lock<mutex_t> latch(mutex_);
-    while (writer_entered_) {
-      reader_.wait(latch);
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    int spins = 0;
+    // Claim the writer flag first so new readers stop entering.
+    while (true) {
+      if ((state & WRITER) == 0 &&
+          state_.compare_exchange_weak(state, state | WRITER, std::memory_order_acquire, std::memory_order_relaxed)) {
+        break;
+      }
+      if ((state & WRITER) == 0) {
+        // Lost the race to another thread (or the CAS failed spuriously); retry right away.
+        continue;
+      }
+      if (++spins < SPIN_LIMIT) {
+        std::this_thread::yield();
+        state = state_.load(std::memory_order_relaxed);
+        continue;
+      }
+      BUSTUB_TRACE_WAIT_START(trace_park_start);
+      std::unique_lock<std::mutex> latch(mutex_);
+      released_.wait(latch, [this, &state] {
+        state = state_.load(std::memory_order_relaxed);
+        return (state & WRITER) == 0;
+      });
+      BUSTUB_TRACE_WAIT_END(RWLATCH_WLOCK_WAIT, reinterpret_cast<uint64_t>(this), trace_park_start);
     }
-    writer_entered_ = true;
-    while (reader_count_ > 0) {
-      writer_.wait(latch);
+    // Drain the in-flight readers: spin briefly, then park until the last one leaves.
+    spins = 0;
+    while ((state_.load(std::memory_order_acquire) & READER_MASK) != 0) {
+      if (++spins < SPIN_LIMIT) {
+        std::this_thread::yield();
+        continue;
+      }
+      BUSTUB_TRACE_WAIT_START(trace_park_start);
+      std::unique_lock<std::mutex> latch(mutex_);
+      drained_.wait(latch, [this] { return (state_.load(std::memory_order_acquire) & READER_MASK) == 0; });
+      BUSTUB_TRACE_WAIT_END(RWLATCH_WLOCK_WAIT, reinterpret_cast<uint64_t>(this), trace_park_start);
     }
   }
 
@@ -52,45 +95,62 @@ class ReaderWriterLatch {
    * Release a write latch.
    */
   void WUnlock() {
-    std::lock_guard<mutex_t> guard(mutex_);
-    writer_entered_ = false;
-    reader_.notify_all();
+    state_.fetch_and(~WRITER, std::memory_order_release);
+    // Taking the mutex orders this notify after any waiter's park decision, so no wakeup is lost.
+    std::lock_guard<std::mutex> guard(mutex_);
+    released_.notify_all();
   }
 
   /**
    * Acquire a read latch.
    */
   void RLock() {
-    std::unique_lock<mutex_t> latch(mutex_);
-    while (writer_entered_ || reader_count_ == MAX_READERS) {
-      reader_.wait(latch);
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    int spins = 0;
+    while (true) {
+      if ((state & WRITER) == 0 &&
+          state_.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+        return;
+      }
+      if ((state & WRITER) == 0) {
+        // Raced with another reader; the CAS reloaded state, retry right away.
+        continue;
+      }
+      if (++spins < SPIN_LIMIT) {
+        std::this_thread::yield();
+        state = state_.load(std::memory_order_relaxed);
+        continue;
+      }
+      BUSTUB_TRACE_WAIT_START(trace_park_start);
+      std::unique_lock<std::mutex> latch(mutex_);
+      released_.wait(latch, [this, &state] {
+        state = state_.load(std::memory_order_relaxed);
+        return (state & WRITER) == 0;
+      });
+      BUSTUB_TRACE_WAIT_END(RWLATCH_RLOCK_WAIT, reinterpret_cast<uint64_t>(this), trace_park_start);
     }
-    reader_count_++;
   }
 
   /**
    * Release a read latch.
    */
   void RUnlock() {
-    std::lock_guard<mutex_t> guard(mutex_);
-    reader_count_--;
-    if (writer_entered_) {
-      if (reader_count_ == 0) {
-        writer_.notify_one();
-      }
-    } else {
-      if (reader_count_ == MAX_READERS - 1) {
-        reader_.notify_one();
-      }
+    uint32_t state = state_.fetch_sub(1, std::memory_order_release);
+    // The last reader out from under a pending writer hands the latch over to it.
+    if ((state & WRITER) != 0 && (state & READER_MASK) == 1) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      drained_.notify_one();
     }
   }
 
  private:
-  mutex_t mutex_;
-  cond_t writer_;
-  cond_t reader_;
-  uint32_t reader_count_{0};
-  bool writer_entered_{false};
+  std::atomic<uint32_t> state_{0};
+  /** Parking lot for the slow path; never touched by uncontended acquisitions. */
+  std::mutex mutex_;
+  /** Signalled when a writer releases the latch. */
+  std::condition_variable released_;
+  /** Signalled when the reader count drops to zero under a pending writer. */
+  std::condition_variable drained_;
 };
 
 }  // namespace bustub
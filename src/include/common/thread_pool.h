@@ -0,0 +1,277 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// thread_pool.h
+//
+// Identification: src/include/common/thread_pool.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/numa_util.h"
+
+namespace bustub {
+
+/**
+ * ThreadPool runs submitted tasks on a fixed set of worker threads. Workers are started once and
+ * reused across tasks, so submitting work costs a queue push rather than a thread spawn.
+ *
+ * Each worker owns its own task deque; Submit distributes tasks round-robin and a worker that
+ * drains its own deque steals from the back of another's, so an uneven task mix stays load
+ * balanced without funneling every pop through one shared queue. The pool is intended to be
+ * shared process-wide: operators that need to wait for their own tasks (and only their own)
+ * should submit them through a TaskGroup rather than using the whole-pool WaitAll.
+ */
+class ThreadPool {
+ public:
+  /**
+   * Creates a pool and starts its worker threads.
+   * @param num_threads the number of workers; defaults to the hardware concurrency
+   */
+  explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency()) {
+    if (num_threads == 0) {
+      num_threads = 1;
+    }
+    queues_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+      queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+      workers_.emplace_back([this, i] { RunWorker(i); });
+    }
+  }
+
+  /** Drains outstanding tasks and joins the workers. */
+  ~ThreadPool() {
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      shutting_down_ = true;
+    }
+    task_available_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(ThreadPool);
+
+  /** @return the number of worker threads in this pool */
+  size_t Size() const { return workers_.size(); }
+
+  /**
+   * Enqueues a task for execution on some worker.
+   * @param task the task to run
+   */
+  void Submit(std::function<void()> task) {
+    size_t q = next_queue_.fetch_add(1) % queues_.size();
+    {
+      std::lock_guard<std::mutex> queue_lock(queues_[q]->latch_);
+      queues_[q]->tasks_.emplace_back(std::move(task));
+    }
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      num_pending_++;
+    }
+    task_available_.notify_one();
+  }
+
+  /**
+   * Runs one queued task on the calling thread, if any is queued. Lets a thread that is blocked
+   * waiting for pool work (e.g. TaskGroup::Wait, or an exchange consumer waiting on its
+   * producer) contribute cycles instead of idling, which also keeps nested parallel operators
+   * from deadlocking a fully busy pool.
+   * @return true if a task was run
+   */
+  bool RunPendingTask() {
+    std::function<void()> task;
+    if (!TryPop(0, &task)) {
+      return false;
+    }
+    RunTask(std::move(task));
+    return true;
+  }
+
+  /** Blocks until every submitted task has finished running, regardless of who submitted it. */
+  void WaitAll() {
+    std::unique_lock<std::mutex> lock(latch_);
+    all_done_.wait(lock, [this] { return num_pending_ == 0 && num_running_ == 0; });
+  }
+
+ private:
+  /** A worker's private task deque. The owner pops the front; thieves take the back. */
+  struct WorkerQueue {
+    std::deque<std::function<void()>> tasks_;
+    std::mutex latch_;
+  };
+
+  /**
+   * Pops a task, preferring the given queue and stealing from the others if it is empty.
+   * @param start the queue to try first
+   * @param[out] task the popped task
+   * @return true if a task was popped
+   */
+  bool TryPop(size_t start, std::function<void()> *task) {
+    for (size_t i = 0; i < queues_.size(); i++) {
+      WorkerQueue &queue = *queues_[(start + i) % queues_.size()];
+      std::lock_guard<std::mutex> queue_lock(queue.latch_);
+      if (queue.tasks_.empty()) {
+        continue;
+      }
+      if (i == 0) {
+        *task = std::move(queue.tasks_.front());
+        queue.tasks_.pop_front();
+      } else {
+        // Steal from the back, away from the owner's end of the deque.
+        *task = std::move(queue.tasks_.back());
+        queue.tasks_.pop_back();
+      }
+      return true;
+    }
+    return false;
+  }
+
+  /** Runs one popped task, keeping the pending/running counters coherent for WaitAll. */
+  void RunTask(std::function<void()> &&task) {
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      num_pending_--;
+      num_running_++;
+    }
+    task();
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      num_running_--;
+      if (num_pending_ == 0 && num_running_ == 0) {
+        all_done_.notify_all();
+      }
+    }
+  }
+
+  /** Worker loop: pop (or steal) tasks until shutdown is requested and the queues are empty. */
+  void RunWorker(size_t worker_id) {
+    // Spread workers round-robin over the NUMA nodes: buffer pool frames are interleaved
+    // across nodes, so a spread keeps every worker's share of them node-local on average
+    // instead of every worker racing to the constructor's node. Single-node: no-op.
+    NumaUtil::PinThreadToNode(worker_id % NumaUtil::NodeCount());
+    while (true) {
+      std::function<void()> task;
+      if (TryPop(worker_id, &task)) {
+        RunTask(std::move(task));
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(latch_);
+      task_available_.wait(lock, [this] { return shutting_down_ || num_pending_ > 0; });
+      if (shutting_down_ && num_pending_ == 0) {
+        return;
+      }
+    }
+  }
+
+  /** The worker threads. */
+  std::vector<std::thread> workers_;
+  /** One task deque per worker; stable addresses, hence the indirection. */
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  /** Round-robin cursor for Submit's queue choice. */
+  std::atomic<size_t> next_queue_{0};
+  /** Protects the counters below. */
+  std::mutex latch_;
+  /** Signaled when a task is submitted or shutdown begins. */
+  std::condition_variable task_available_;
+  /** Signaled when the pool becomes idle (no queued and no running tasks). */
+  std::condition_variable all_done_;
+  /** The number of tasks queued and not yet picked up. */
+  size_t num_pending_{0};
+  /** The number of tasks currently executing. */
+  size_t num_running_{0};
+  /** True once the destructor has requested shutdown. */
+  bool shutting_down_{false};
+};
+
+/**
+ * TaskGroup tracks completion of one operator's tasks on a shared pool. ThreadPool::WaitAll
+ * waits for the whole pool, which is wrong once the pool is shared across operators and
+ * queries; Wait() here returns as soon as this group's tasks are done, and helps run queued
+ * pool tasks while it waits so a group waited on from inside another pool task cannot
+ * deadlock a fully busy pool.
+ */
+class TaskGroup {
+ public:
+  /**
+   * Creates a group submitting to the given pool.
+   * @param pool the pool to run this group's tasks on; must outlive the group
+   */
+  explicit TaskGroup(ThreadPool *pool) : pool_(pool) {}
+
+  /** Waits for any stragglers so a task never outlives the state it captured. */
+  ~TaskGroup() { Wait(); }
+
+  DISALLOW_COPY_AND_MOVE(TaskGroup);
+
+  /** @return the pool this group submits to */
+  ThreadPool *GetPool() const { return pool_; }
+
+  /**
+   * Enqueues a task belonging to this group.
+   * @param task the task to run
+   */
+  void Submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      pending_++;
+    }
+    pool_->Submit([this, task = std::move(task)] {
+      task();
+      std::lock_guard<std::mutex> lock(latch_);
+      if (--pending_ == 0) {
+        done_.notify_all();
+      }
+    });
+  }
+
+  /** Blocks until every task submitted to this group has finished, helping the pool meanwhile. */
+  void Wait() {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(latch_);
+        if (pending_ == 0) {
+          return;
+        }
+      }
+      if (!pool_->RunPendingTask()) {
+        // Nothing to help with; our tasks are running elsewhere. Sleep until one finishes,
+        // with a timeout so newly queued pool work gets helped promptly.
+        std::unique_lock<std::mutex> lock(latch_);
+        done_.wait_for(lock, std::chrono::milliseconds(1), [this] { return pending_ == 0; });
+      }
+    }
+  }
+
+ private:
+  /** The pool this group's tasks run on. */
+  ThreadPool *pool_;
+  /** Protects the pending count. */
+  std::mutex latch_;
+  /** Signaled when the group's last outstanding task finishes. */
+  std::condition_variable done_;
+  /** The number of this group's tasks still queued or running. */
+  size_t pending_{0};
+};
+
+}  // namespace bustub
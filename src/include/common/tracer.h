@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tracer.h
+//
+// Identification: src/include/common/tracer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * Probe points for flame-level attribution on the hot paths that aggregate counters cannot
+ * explain: which thread pinned which page, how long a latch or lock made someone wait, how
+ * long a commit stalled on the log flush. Values are part of the binary trace format; only
+ * append.
+ */
+enum class TraceEvent : uint16_t {
+  INVALID = 0,
+  /** arg0 = page id, arg1 = 1 on a pool hit */
+  BPM_FETCH,
+  /** arg0 = page id */
+  BPM_NEW_PAGE,
+  /** arg0 = page id, arg1 = 1 if dirty */
+  BPM_UNPIN,
+  /** arg0 = latch address, arg1 = wait ns */
+  RWLATCH_RLOCK_WAIT,
+  /** arg0 = latch address, arg1 = wait ns */
+  RWLATCH_WLOCK_WAIT,
+  /** arg0 = txn id, arg1 = wait ns */
+  LOCK_SHARED_WAIT,
+  /** arg0 = txn id, arg1 = wait ns */
+  LOCK_EXCLUSIVE_WAIT,
+  /** arg0 = lsn waited for, arg1 = stall ns */
+  LOG_FLUSH_WAIT,
+  /** arg0 = bytes written, arg1 = write ns */
+  LOG_SWAP_FLUSH,
+};
+
+/**
+ * One fixed-size binary trace record; the layout an external reader decodes. 32 bytes,
+ * little-endian on every platform this tree targets.
+ */
+struct TraceRecord {
+  /** Nanoseconds on the steady clock, comparable across threads of one process. */
+  uint64_t timestamp_ns_;
+  /** The recording thread, for per-thread attribution. */
+  uint32_t thread_id_;
+  TraceEvent event_;
+  uint16_t unused_{0};
+  uint64_t arg0_;
+  uint64_t arg1_;
+};
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord is a wire format");
+
+/**
+ * The tracing backend behind the BUSTUB_TRACE_* macros. Recording appends to a per-thread
+ * ring of TraceRecords -- no lock, no branch beyond the ring index -- and the ring keeps the
+ * most recent records, overwriting the oldest once full. Dump() snapshots every thread's
+ * ring into one binary file (a flat sequence of TraceRecords, oldest first per thread) for
+ * an external tool to sort and render.
+ *
+ * The facility only exists in binaries built with BUSTUB_TRACING; without it the macros
+ * compile to nothing and no probe instruction remains.
+ */
+class Tracer {
+ public:
+  /** Records kept per thread; older ones are overwritten. */
+  static constexpr size_t RING_RECORDS = 1 << 14;
+
+  /** Appends one record to the calling thread's ring. */
+  static void Record(TraceEvent event, uint64_t arg0, uint64_t arg1) {
+    Ring *ring = MyRing();
+    uint64_t slot = ring->next_.load(std::memory_order_relaxed);
+    TraceRecord &record = ring->records_[slot % RING_RECORDS];
+    record.timestamp_ns_ = Now();
+    record.thread_id_ = ring->thread_id_;
+    record.event_ = event;
+    record.arg0_ = arg0;
+    record.arg1_ = arg1;
+    ring->next_.store(slot + 1, std::memory_order_release);
+  }
+
+  /** @return nanoseconds on the steady clock, the timebase of every record */
+  static uint64_t Now() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  /**
+   * Writes every thread's buffered records to the given file, oldest first within each
+   * thread. Records written concurrently with the dump may be missed or torn; dump at a
+   * quiesced point for exact traces.
+   * @param path the output file
+   * @return true if the file was written
+   */
+  static bool Dump(const std::string &path) {
+    FILE *out = fopen(path.c_str(), "wb");
+    if (out == nullptr) {
+      return false;
+    }
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+      std::scoped_lock lock(Registry().latch_);
+      rings = Registry().rings_;
+    }
+    for (auto &ring : rings) {
+      uint64_t next = ring->next_.load(std::memory_order_acquire);
+      uint64_t first = next > RING_RECORDS ? next - RING_RECORDS : 0;
+      for (uint64_t slot = first; slot < next; slot++) {
+        fwrite(&ring->records_[slot % RING_RECORDS], sizeof(TraceRecord), 1, out);
+      }
+    }
+    fclose(out);
+    return true;
+  }
+
+ private:
+  struct Ring {
+    std::vector<TraceRecord> records_{std::vector<TraceRecord>(RING_RECORDS)};
+    /** Count of records ever written; the ring holds the last RING_RECORDS of them. */
+    std::atomic<uint64_t> next_{0};
+    uint32_t thread_id_{0};
+  };
+
+  /** Rings stay registered after their thread exits so a dump still sees their tail. */
+  struct Registry_ {
+    std::mutex latch_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::atomic<uint32_t> next_thread_id_{0};
+  };
+
+  static Registry_ &Registry() {
+    static Registry_ registry;
+    return registry;
+  }
+
+  static Ring *MyRing() {
+    thread_local std::shared_ptr<Ring> ring = [] {
+      auto created = std::make_shared<Ring>();
+      std::scoped_lock lock(Registry().latch_);
+      created->thread_id_ = Registry().next_thread_id_++;
+      Registry().rings_.push_back(created);
+      return created;
+    }();
+    return ring.get();
+  }
+};
+
+}  // namespace bustub
+
+/**
+ * The probe macros. BUSTUB_TRACE records a point event; BUSTUB_TRACE_WAIT_START /
+ * BUSTUB_TRACE_WAIT_END bracket a potentially-blocking section and record it with its
+ * duration. Built without BUSTUB_TRACING they expand to nothing.
+ */
+#ifdef BUSTUB_TRACING
+#define BUSTUB_TRACE(event, arg0, arg1) bustub::Tracer::Record(bustub::TraceEvent::event, (arg0), (arg1))
+#define BUSTUB_TRACE_WAIT_START(var) uint64_t var = bustub::Tracer::Now()
+#define BUSTUB_TRACE_WAIT_END(event, arg0, var) \
+  bustub::Tracer::Record(bustub::TraceEvent::event, (arg0), bustub::Tracer::Now() - (var))
+#else
+#define BUSTUB_TRACE(event, arg0, arg1) ((void)0)
+#define BUSTUB_TRACE_WAIT_START(var) ((void)0)
+#define BUSTUB_TRACE_WAIT_END(event, arg0, var) ((void)0)
+#endif
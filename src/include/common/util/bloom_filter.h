@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/common/util/bloom_filter.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * BloomFilter is a fixed-size Bloom filter over pre-computed hashes. Insert() records a hash
+ * and MayContain() answers whether it might have been recorded: false is definitive, true may
+ * be a false positive. The probe positions are derived from the one hash by double hashing, so
+ * callers pay a single hash computation per key. The default size keeps the bit array small
+ * enough to stay cache resident while holding the false-positive rate low for build sides up
+ * to the tens of thousands of keys.
+ */
+class BloomFilter {
+ public:
+  /**
+   * Creates a Bloom filter.
+   * @param num_bits the size of the bit array; rounded down to a multiple of 64, must be a power of two
+   */
+  explicit BloomFilter(uint32_t num_bits = DEFAULT_NUM_BITS) : num_bits_(num_bits), bits_(num_bits / 64, 0) {}
+
+  /** Records a hash in the filter. */
+  void Insert(uint64_t h) {
+    uint64_t h2 = SecondHash(h);
+    for (uint32_t i = 0; i < NUM_PROBES; i++) {
+      uint64_t bit = (h + i * h2) & (num_bits_ - 1);
+      bits_[bit / 64] |= 1ULL << (bit % 64);
+    }
+  }
+
+  /** @return false if the hash was definitely never inserted, true if it might have been */
+  bool MayContain(uint64_t h) const {
+    uint64_t h2 = SecondHash(h);
+    for (uint32_t i = 0; i < NUM_PROBES; i++) {
+      uint64_t bit = (h + i * h2) & (num_bits_ - 1);
+      if ((bits_[bit / 64] & (1ULL << (bit % 64))) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  /** 2^19 bits = 64 KiB. */
+  static constexpr uint32_t DEFAULT_NUM_BITS = 1 << 19;
+  /** The number of bits each key sets and tests. */
+  static constexpr uint32_t NUM_PROBES = 4;
+
+  /** @return a second hash for double hashing, forced odd so every probe stride hits all bits */
+  static uint64_t SecondHash(uint64_t h) { return (h * 0x9E3779B97F4A7C15ULL) | 1; }
+
+  /** The size of the bit array. */
+  uint64_t num_bits_;
+  /** The bit array, packed into words. */
+  std::vector<uint64_t> bits_;
+};
+
+}  // namespace bustub
@@ -25,6 +25,22 @@ class StringUtil {
   /** @return true if haystack contains needle, false otherwise */
   static bool Contains(const std::string &haystack, const std::string &needle);
 
+  /**
+   * @return true if the haystack buffer contains the needle buffer, false otherwise
+   * Buffer-level overload for expression evaluation over varlen values: no string materialization,
+   * and the search itself runs through memmem rather than byte-at-a-time.
+   */
+  static bool Contains(const char *haystack, std::size_t haystack_len, const char *needle, std::size_t needle_len);
+
+  /**
+   * Uppercases the ascii letters in the buffer in place, eight bytes at a time.
+   * Non-ascii bytes pass through untouched, matching what std::toupper does in the "C" locale.
+   */
+  static void UpperInPlace(char *data, std::size_t len);
+
+  /** Lowercases the ascii letters in the buffer in place, eight bytes at a time. */
+  static void LowerInPlace(char *data, std::size_t len);
+
   /** @return true if target string starts with given prefix, false otherwise */
   static bool StartsWith(const std::string &str, const std::string &prefix);
 
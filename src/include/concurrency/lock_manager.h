@@ -13,7 +13,9 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <condition_variable>  // NOLINT
+#include <functional>
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -38,7 +40,7 @@ enum class DeadlockMode { PREVENTION, DETECTION };
  * LockManager handles transactions asking for locks on records.
  */
 class LockManager {
-  enum class LockMode { SHARED, EXCLUSIVE };
+  enum class LockMode { SHARED, EXCLUSIVE, INTENTION_SHARED, INTENTION_EXCLUSIVE };
 
   class LockRequest {
    public:
@@ -47,12 +49,15 @@ class LockManager {
     txn_id_t txn_id_;
     LockMode lock_mode_;
     bool granted_;
+    /** Per-request condition variable: a grant or a wound wakes exactly the affected waiter, so
+     * a hot key with many parked transactions does not thundering-herd on every release. List
+     * nodes never move, so the condition variable can live in the element. */
+    std::condition_variable cv_;
   };
 
   class LockRequestQueue {
    public:
     std::list<LockRequest> request_queue_;
-    std::condition_variable cv_;  // for notifying blocked transactions on this rid
     bool upgrading_ = false;
   };
 
@@ -121,6 +126,47 @@ class LockManager {
    */
   bool Unlock(Transaction *txn, const RID &rid);
 
+  /*
+   * [TABLE_LOCK_NOTE]: Table-granularity locks are queued on a sentinel RID (the table's first
+   * page id with slot TABLE_LOCK_SLOT), so they reuse the sharded queues and are released by the
+   * same Unlock/ReleaseLocks path as row locks. Row locks under a table are counted per
+   * transaction; once the count reaches the escalation threshold the caller should trade its
+   * intention lock for a full table lock and stop taking row locks (see TableHeap).
+   */
+
+  /** Slot number that marks a sentinel RID as a table-granularity lock. */
+  static constexpr uint32_t TABLE_LOCK_SLOT = 0xFFFFFFFF;
+
+  /**
+   * Acquire an intention lock on a table, announcing row-level locking underneath it.
+   * Idempotent when the transaction already holds a covering table lock.
+   * @param txn the transaction requesting the lock
+   * @param table_id the table's first page id
+   * @param exclusive true for intention-exclusive, false for intention-shared
+   * @return true if the lock is granted
+   */
+  bool LockTableIntention(Transaction *txn, page_id_t table_id, bool exclusive);
+
+  /**
+   * Acquire (or escalate an intention lock into) a full table lock.
+   * @param txn the transaction requesting the lock
+   * @param table_id the table's first page id
+   * @param exclusive true for an exclusive table lock, false for shared
+   * @return true if the lock is granted
+   */
+  bool LockTable(Transaction *txn, page_id_t table_id, bool exclusive);
+
+  /**
+   * Count one row lock taken by the transaction under the given table.
+   * @param txn the transaction taking the row lock
+   * @param table_id the table's first page id
+   * @return true exactly when the count reaches the escalation threshold
+   */
+  bool RecordRowLock(Transaction *txn, page_id_t table_id);
+
+  /** Sets the per-table row-lock count at which a transaction escalates to a table lock. */
+  void SetLockEscalationThreshold(size_t threshold) { escalation_threshold_ = threshold; }
+
   /*** Graph API ***/
   /**
    * Adds edge t1->t2
@@ -146,18 +192,72 @@ class LockManager {
   void RunCycleDetection();
 
  private:
-  TwoPLMode two_pl_mode_ __attribute__((__unused__));
+  /** Number of independently latched lock-table shards. */
+  static constexpr size_t LOCK_TABLE_SHARDS = 16;
+
+  /**
+   * One shard of the lock table. A lock request only takes its RID's shard latch, so requests on
+   * unrelated rows never contend on lock-manager internals.
+   */
+  struct LockTableShard {
+    std::mutex latch_;
+    std::unordered_map<RID, LockRequestQueue> lock_table_;
+  };
+
+  TwoPLMode two_pl_mode_;
   DeadlockMode deadlock_mode_;
 
   bool Detection() { return deadlock_mode_ == DeadlockMode::DETECTION; }
   bool Prevention() { return deadlock_mode_ == DeadlockMode::PREVENTION; }
 
+  /** @return the shard whose latch and table cover the given rid */
+  LockTableShard &Shard(const RID &rid) { return lock_table_shards_[std::hash<RID>()(rid) % LOCK_TABLE_SHARDS]; }
+
+  /** @return true when the two modes can be held on the same resource at once */
+  static bool Compatible(LockMode held, LockMode wanted);
+
+  /** @return true when holding `held` already grants everything `wanted` would */
+  static bool Covers(LockMode held, LockMode wanted);
+
+  /**
+   * A request can be granted when every request ahead of it in the queue is compatible with it.
+   * FIFO order keeps writers from starving.
+   */
+  bool CanGrant(LockRequestQueue *queue, std::list<LockRequest>::iterator request);
+
+  /**
+   * Wound-wait prevention: abort every younger transaction in the queue whose request is
+   * incompatible with the given mode, so the older requester never waits on a younger one.
+   * Caller holds the shard latch.
+   */
+  void WoundYounger(LockRequestQueue *queue, Transaction *txn, LockMode mode);
+
+  /**
+   * Wake exactly the waiters whose requests became grantable after the queue changed, instead of
+   * broadcasting to every parked transaction. Caller holds the shard latch.
+   */
+  void WakeGrantable(LockRequestQueue *queue);
+
+  /**
+   * Parks on the request's condition variable until the request can be granted or the transaction
+   * is aborted; removes the request and returns false in the latter case. Caller holds the shard
+   * latch via lock.
+   */
+  bool WaitForGrant(std::unique_lock<std::mutex> *lock, LockRequestQueue *queue, Transaction *txn,
+                    std::list<LockRequest>::iterator request);
+
   std::mutex latch_;
   std::atomic<bool> enable_cycle_detection_;
   std::thread *cycle_detection_thread_;
 
-  /** Lock table for lock requests. */
-  std::unordered_map<RID, LockRequestQueue> lock_table_;
+  /** Lock table for lock requests, sharded by RID hash. */
+  std::array<LockTableShard, LOCK_TABLE_SHARDS> lock_table_shards_;
+
+  /** Row-lock count at which a transaction trades its row locks on a table for one table lock. */
+  size_t escalation_threshold_ = 1024;
+  /** Per-transaction, per-table row-lock counts driving escalation. */
+  std::unordered_map<txn_id_t, std::unordered_map<page_id_t, size_t>> row_lock_counts_;
+  std::mutex escalation_latch_;
   /** Waits-for graph representation. */
   std::unordered_map<txn_id_t, std::vector<txn_id_t>> waits_for_;
 };
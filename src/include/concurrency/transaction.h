@@ -12,11 +12,14 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <deque>
 #include <memory>
+#include <mutex>   // NOLINT
 #include <thread>  // NOLINT
 #include <unordered_set>
+#include <vector>
 
 #include "common/config.h"
 #include "common/logger.h"
@@ -77,10 +80,35 @@ class Transaction {
     deleted_page_set_ = std::make_shared<std::unordered_set<page_id_t>>();
   }
 
-  ~Transaction() = default;
+  /**
+   * Destroying a transaction removes it from the global registry, so background walkers such as
+   * the checkpoint scheduler never dereference a client-owned object after its owner freed it.
+   */
+  ~Transaction();
 
   DISALLOW_COPY(Transaction);
 
+  /**
+   * Re-initializes this object for a new transaction, reusing the already-allocated containers.
+   * Used by TransactionManager's recycling pool so a begin/commit cycle does not churn the heap.
+   * @param txn_id the id of the new transaction
+   */
+  void Reset(txn_id_t txn_id) {
+    state_ = TransactionState::GROWING;
+    thread_id_ = std::this_thread::get_id();
+    txn_id_ = txn_id;
+    prev_lsn_ = INVALID_LSN;
+    read_ts_ = 0;
+    read_only_ = false;
+    write_set_->clear();
+    log_staging_buffer_.clear();
+    page_set_->clear();
+    deleted_page_set_->clear();
+    shared_lock_set_->clear();
+    exclusive_lock_set_->clear();
+    lock_filter_.fill(0);
+  }
+
   /** @return the id of the thread running the transaction */
   inline std::thread::id GetThreadId() const { return thread_id_; }
 
@@ -115,10 +143,26 @@ class Transaction {
   inline std::shared_ptr<std::unordered_set<RID>> GetExclusiveLockSet() { return exclusive_lock_set_; }
 
   /** @return true if rid is shared locked by this transaction */
-  bool IsSharedLocked(const RID &rid) { return shared_lock_set_->find(rid) != shared_lock_set_->end(); }
+  bool IsSharedLocked(const RID &rid) {
+    return MightHoldLock(rid) && shared_lock_set_->find(rid) != shared_lock_set_->end();
+  }
 
   /** @return true if rid is exclusively locked by this transaction */
-  bool IsExclusiveLocked(const RID &rid) { return exclusive_lock_set_->find(rid) != exclusive_lock_set_->end(); }
+  bool IsExclusiveLocked(const RID &rid) {
+    return MightHoldLock(rid) && exclusive_lock_set_->find(rid) != exclusive_lock_set_->end();
+  }
+
+  /**
+   * Marks a rid in the held-lock filter. The lock manager calls this whenever it grants this
+   * transaction a lock; bits are never cleared before Reset, so an unlocked rid merely costs the
+   * exact set probe again.
+   * @param rid the rid a lock was granted on
+   */
+  inline void RecordLockedRid(const RID &rid) {
+    uint64_t hash = LockFilterHash(rid);
+    lock_filter_[(hash >> 6) % LOCK_FILTER_WORDS] |= uint64_t{1} << (hash & 63);
+    lock_filter_[(hash >> 38) % LOCK_FILTER_WORDS] |= uint64_t{1} << ((hash >> 32) & 63);
+  }
 
   /** @return the current state of the transaction */
   inline TransactionState GetState() { return state_; }
@@ -138,9 +182,55 @@ class Transaction {
    */
   inline void SetPrevLSN(lsn_t prev_lsn) { prev_lsn_ = prev_lsn; }
 
+  /** @return the transaction-local log staging buffer (see LogManager::StageLogRecord) */
+  inline std::vector<char> *GetLogStagingBuffer() { return &log_staging_buffer_; }
+
+  /** @return the latch guarding the staging buffer; uncontended except when the buffer pool
+   * publishes staged records on behalf of the transaction to uphold the WAL rule */
+  inline std::mutex *GetLogStagingLatch() { return &log_staging_latch_; }
+
+  /** @return the snapshot timestamp this transaction reads as of (see VersionManager) */
+  inline timestamp_t GetReadTs() const { return read_ts_; }
+
+  /** Sets the snapshot timestamp; done once by TransactionManager::Begin. */
+  inline void SetReadTs(timestamp_t read_ts) { read_ts_ = read_ts; }
+
+  /** @return true if this transaction only reads and resolves reads against its snapshot */
+  inline bool IsReadOnly() const { return read_only_; }
+
+  /** Marks this transaction read-only; its reads bypass the lock manager entirely. */
+  inline void SetReadOnly(bool read_only) { read_only_ = read_only; }
+
  private:
-  /** The current transaction state. */
-  TransactionState state_;
+  /** Number of 64-bit words in the held-lock filter (1024 bits). */
+  static constexpr size_t LOCK_FILTER_WORDS = 16;
+
+  /** @return a mixed 64-bit hash of the rid, two independent bit positions per 32-bit half */
+  static inline uint64_t LockFilterHash(const RID &rid) {
+    // splitmix64 finalizer: cheap and spreads the page-id/slot structure over all bits.
+    auto hash = static_cast<uint64_t>(rid.Get());
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBULL;
+    return hash ^ (hash >> 31);
+  }
+
+  /**
+   * @return true if this transaction may hold any lock on the rid; false means definitely not.
+   * A read re-touching a row it already locked -- the dominant pattern in point-lookup
+   * workloads -- answers from these two word probes without hashing into the lock sets, and a
+   * first touch skips both set probes before going to the lock manager.
+   */
+  inline bool MightHoldLock(const RID &rid) const {
+    uint64_t hash = LockFilterHash(rid);
+    return ((lock_filter_[(hash >> 6) % LOCK_FILTER_WORDS] >> (hash & 63)) &
+            (lock_filter_[(hash >> 38) % LOCK_FILTER_WORDS] >> ((hash >> 32) & 63)) & 1) != 0;
+  }
+
+  /** The current transaction state. Atomic because deadlock handling (wound-wait and the cycle
+   * detector) aborts a victim from another thread while the victim itself polls the state. */
+  std::atomic<TransactionState> state_;
   /** The thread ID, used in single-threaded transactions. */
   std::thread::id thread_id_;
   /** The ID of this transaction. */
@@ -150,6 +240,14 @@ class Transaction {
   std::shared_ptr<std::deque<WriteRecord>> write_set_;
   /** The LSN of the last record written by the transaction. */
   lsn_t prev_lsn_;
+  /** Log records staged locally by this transaction, published to the LogManager in one batch. */
+  std::vector<char> log_staging_buffer_;
+  /** Guards log_staging_buffer_ against a concurrent publish from the buffer pool. */
+  std::mutex log_staging_latch_;
+  /** MVCC: the snapshot timestamp this transaction reads as of. */
+  timestamp_t read_ts_{0};
+  /** MVCC: true when reads go to the snapshot instead of the lock manager. */
+  bool read_only_{false};
 
   /** Concurrent index: the pages that were latched during index operation. */
   std::shared_ptr<std::deque<Page *>> page_set_;
@@ -160,6 +258,8 @@ class Transaction {
   std::shared_ptr<std::unordered_set<RID>> shared_lock_set_;
   /** LockManager: the set of exclusive-locked tuples held by this transaction. */
   std::shared_ptr<std::unordered_set<RID>> exclusive_lock_set_;
+  /** Bloom filter over every rid this transaction has ever locked; see MightHoldLock. */
+  std::array<uint64_t, LOCK_FILTER_WORDS> lock_filter_{};
 };
 
 }  // namespace bustub
@@ -12,9 +12,13 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <functional>
+#include <mutex>  // NOLINT
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
@@ -32,14 +36,19 @@ class TransactionManager {
   explicit TransactionManager(LockManager *lock_manager, LogManager *log_manager = nullptr)
       : lock_manager_(lock_manager), log_manager_(log_manager) {}
 
-  ~TransactionManager() = default;
+  ~TransactionManager() {
+    for (auto *txn : txn_pool_) {
+      delete txn;
+    }
+  }
 
   /**
    * Begins a new transaction.
    * @param txn an optional transaction object to be initialized, otherwise a new transaction is created
+   * @param read_only true for a snapshot transaction whose reads bypass the lock manager
    * @return an initialized transaction
    */
-  Transaction *Begin(Transaction *txn = nullptr);
+  Transaction *Begin(Transaction *txn = nullptr, bool read_only = false);
 
   /**
    * Commits a transaction.
@@ -57,8 +66,25 @@ class TransactionManager {
    * Global list of running transactions
    */
 
-  /** The transaction map is a global list of all the running transactions in the system. */
-  static std::unordered_map<txn_id_t, Transaction *> txn_map;
+  /**
+   * The global transaction registry, sharded by transaction id so a Begin on one thread does not
+   * serialize against lookups on another; next_txn_id_ is the only allocation state every thread
+   * shares. An entry lives until its Transaction is destroyed or recycled (see Unregister), so a
+   * walker like ForEachTransaction never sees a pointer whose owner already freed it.
+   */
+  static constexpr size_t TXN_MAP_SHARDS = 16;
+
+  struct TxnMapShard {
+    std::mutex latch_;
+    std::unordered_map<txn_id_t, Transaction *> map_;
+  };
+
+  static std::array<TxnMapShard, TXN_MAP_SHARDS> txn_map_shards;
+
+  /** @return the shard owning the given transaction id */
+  static TxnMapShard &TxnShard(txn_id_t txn_id) {
+    return txn_map_shards[static_cast<size_t>(txn_id) % TXN_MAP_SHARDS];
+  }
 
   /**
    * Locates and returns the transaction with the given transaction ID.
@@ -66,12 +92,72 @@ class TransactionManager {
    * @return the transaction with the given transaction id
    */
   static Transaction *GetTransaction(txn_id_t txn_id) {
-    assert(TransactionManager::txn_map.find(txn_id) != TransactionManager::txn_map.end());
-    auto *res = TransactionManager::txn_map[txn_id];
-    assert(res != nullptr);
-    return res;
+    auto &shard = TxnShard(txn_id);
+    std::lock_guard<std::mutex> lock(shard.latch_);
+    auto it = shard.map_.find(txn_id);
+    assert(it != shard.map_.end());
+    assert(it->second != nullptr);
+    return it->second;
   }
 
+  /**
+   * Drops the registry entry for the given transaction id, if it still refers to this object.
+   * Called by ~Transaction and Recycle; the pointer check keeps a directly-constructed
+   * Transaction (tests build them without Begin) from erasing a registered one that happens to
+   * share its id. A no-op for ids that were never registered or were already unregistered.
+   * @param txn_id the id whose entry should be dropped
+   * @param txn the object the entry must point at to be dropped
+   */
+  static void Unregister(txn_id_t txn_id, const Transaction *txn) {
+    auto &shard = TxnShard(txn_id);
+    std::lock_guard<std::mutex> lock(shard.latch_);
+    auto it = shard.map_.find(txn_id);
+    if (it != shard.map_.end() && it->second == txn) {
+      shard.map_.erase(it);
+    }
+  }
+
+  /**
+   * Invokes the callback on every registered transaction, one shard at a time.
+   * @param callback the function to invoke per transaction
+   */
+  static void ForEachTransaction(const std::function<void(Transaction *)> &callback) {
+    for (auto &shard : txn_map_shards) {
+      std::lock_guard<std::mutex> lock(shard.latch_);
+      for (auto &entry : shard.map_) {
+        callback(entry.second);
+      }
+    }
+  }
+
+  /**
+   * Returns a finished transaction's object to the recycling pool instead of freeing it; a later
+   * Begin will Reset and reuse it, skipping the container allocations of a fresh Transaction.
+   * Call in place of `delete txn` once the transaction has committed or aborted.
+   * @param txn the finished transaction
+   */
+  void Recycle(Transaction *txn) {
+    // A pooled object is parked, not destroyed, so its destructor cannot unregister it; drop the
+    // registry entry here. (The delete path unregisters again harmlessly.)
+    Unregister(txn->GetTransactionId(), txn);
+    std::lock_guard<std::mutex> lock(txn_pool_latch_);
+    if (txn_pool_.size() < TXN_POOL_LIMIT) {
+      txn_pool_.push_back(txn);
+      return;
+    }
+    delete txn;
+  }
+
+  /**
+   * Early lock release: commit drops the transaction's locks as soon as its COMMIT record is in
+   * the log buffer, overlapping the durability wait with dependent transactions instead of
+   * serializing hot rows at fsync latency. Safe under group commit: a dependent's own COMMIT
+   * record lands after ours in the log, so its flush wait covers ours -- no dependent can report
+   * commit before this transaction is durable. Commit itself still returns only after the flush.
+   * @param enabled true to release locks before the flush wait
+   */
+  void SetEarlyLockRelease(bool enabled) { early_lock_release_ = enabled; }
+
   /** Prevents all transactions from performing operations, used for checkpointing. */
   void BlockAllTransactions();
 
@@ -96,7 +182,17 @@ class TransactionManager {
     }
   }
 
+  /** Recycled Transaction objects kept beyond this count are freed instead. */
+  static constexpr size_t TXN_POOL_LIMIT = 64;
+
   std::atomic<txn_id_t> next_txn_id_{0};
+  /** Finished Transaction objects waiting to be reused by Begin. */
+  std::vector<Transaction *> txn_pool_;
+  std::mutex txn_pool_latch_;
+  /** MVCC: the timestamp of the most recent commit; new snapshots read as of this point. */
+  std::atomic<timestamp_t> last_commit_ts_{0};
+  /** Commit releases locks before waiting for the log flush (see SetEarlyLockRelease). */
+  bool early_lock_release_{false};
   LockManager *lock_manager_ __attribute__((__unused__));
   LogManager *log_manager_ __attribute__((__unused__));
 
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// version_manager.h
+//
+// Identification: src/include/concurrency/version_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/rid.h"
+#include "concurrency/transaction.h"
+
+namespace bustub {
+
+/**
+ * VersionManager keeps in-memory version chains for rows modified by in-flight and recently
+ * committed transactions, so read-only transactions can read a consistent snapshot without taking
+ * any locks. Writers append a version (stamped with their transaction until commit) under the page
+ * write latch; readers resolve visibility against their read timestamp. A row with no chain has
+ * not been written since the chain store started and can be read straight from the page.
+ */
+class VersionManager {
+ public:
+  /** Outcome of a snapshot lookup. */
+  enum class Lookup {
+    /** No chain exists; the page image is the only (and visible) version. */
+    NO_CHAIN,
+    /** A visible version was found and copied out. */
+    FOUND,
+    /** The row was deleted (or not yet inserted) as of the snapshot. */
+    DELETED,
+  };
+
+  /** @return the process-wide version store, shared by all tables (like TransactionManager's
+   * global transaction registry) */
+  static VersionManager &Instance();
+
+  /**
+   * Record the state of a row after a write by an uncommitted transaction.
+   * Must be called under the page's write latch so chain creation cannot race a snapshot read.
+   * @param rid the row that was written
+   * @param old_tuple the row's value before the write (seeds the chain's base version)
+   * @param new_tuple the row's value after the write (ignored when deleted)
+   * @param deleted true when the write removes the row (or, for the base of a fresh insert's
+   *                chain, when the row did not exist before)
+   * @param txn the writing transaction
+   */
+  void OnWrite(const RID &rid, const Tuple &old_tuple, const Tuple &new_tuple, bool deleted, Transaction *txn);
+
+  /**
+   * Record a freshly inserted row: the base version is "not present" so older snapshots skip it.
+   * Must be called under the page's write latch.
+   * @param rid the row that was inserted
+   * @param tuple the inserted value
+   * @param txn the inserting transaction
+   */
+  void OnInsert(const RID &rid, const Tuple &tuple, Transaction *txn);
+
+  /**
+   * Stamp every version written by the transaction with its commit timestamp, making them
+   * visible to snapshots taken from now on.
+   * @param txn_id the committing transaction
+   * @param commit_ts the transaction's commit timestamp
+   */
+  void CommitTxn(txn_id_t txn_id, timestamp_t commit_ts);
+
+  /**
+   * Drop every version written by the transaction; the rollback restores the page image.
+   * @param txn_id the aborting transaction
+   */
+  void AbortTxn(txn_id_t txn_id);
+
+  /**
+   * Find the newest version of the row committed at or before the read timestamp.
+   * Call under the page's read latch so a NO_CHAIN answer stays valid for the page read.
+   * @param rid the row to read
+   * @param read_ts the reader's snapshot timestamp
+   * @param[out] tuple the visible version, when the result is FOUND
+   * @return NO_CHAIN, FOUND or DELETED
+   */
+  Lookup GetVisible(const RID &rid, timestamp_t read_ts, Tuple *tuple);
+
+ private:
+  /** A committed-or-pending state of one row. */
+  struct Version {
+    Tuple tuple_;
+    bool deleted_;
+    txn_id_t writer_;
+    /** UNCOMMITTED_TS until the writer commits. */
+    timestamp_t commit_ts_;
+  };
+
+  /** Commit timestamp of a version whose writer is still in flight. */
+  static constexpr timestamp_t UNCOMMITTED_TS = static_cast<timestamp_t>(-1);
+
+  static constexpr size_t VERSION_SHARDS = 16;
+
+  struct VersionShard {
+    std::mutex latch_;
+    /** Chains ordered oldest to newest; the base version is always committed. */
+    std::unordered_map<RID, std::vector<Version>> chains_;
+  };
+
+  VersionShard &Shard(const RID &rid) { return shards_[std::hash<RID>()(rid) % VERSION_SHARDS]; }
+
+  /** Appends the pending version, seeding the chain's base from the pre-image when needed. */
+  void Append(const RID &rid, const Tuple &base_tuple, bool base_deleted, const Tuple &new_tuple, bool new_deleted,
+              Transaction *txn);
+
+  std::array<VersionShard, VERSION_SHARDS> shards_;
+
+  /** Rows with pending versions per transaction, for commit stamping and abort cleanup. */
+  std::unordered_map<txn_id_t, std::vector<RID>> txn_writes_;
+  std::mutex txn_writes_latch_;
+};
+
+}  // namespace bustub
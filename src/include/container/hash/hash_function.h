@@ -13,11 +13,20 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 
+#include "common/util/hash_util.h"
 #include "murmur3/MurmurHash3.h"
 
 namespace bustub {
 
+/**
+ * Computes the bucket hash of a fixed-size key. Keys that fit in a machine
+ * word are hashed with a single multiply and an avalanching mix; wider keys
+ * go through HashUtil::HashBytes, which runs a word at a time (hardware
+ * CRC32C when the target has it). Define BUSTUB_MURMUR_HASH to fall back to
+ * the original MurmurHash3 backend, e.g. to compare distributions.
+ */
 template <typename KeyType>
 class HashFunction {
  public:
@@ -26,10 +35,25 @@ class HashFunction {
    * @return the hashed value
    */
   virtual uint64_t GetHash(KeyType key) {
+#ifdef BUSTUB_MURMUR_HASH
     uint64_t hash[2];
     murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
                                  reinterpret_cast<void *>(&hash));
     return hash[0];
+#else
+    if constexpr (sizeof(KeyType) <= sizeof(uint64_t)) {
+      // fixed-width keys: one Fibonacci multiply spreads the bits, the
+      // xor-shift rounds avalanche them
+      uint64_t word = 0;
+      std::memcpy(&word, &key, sizeof(KeyType));
+      word *= UINT64_C(0x9E3779B97F4A7C15);
+      word ^= word >> 32;
+      word *= UINT64_C(0xD6E8FEB86659FD93);
+      word ^= word >> 32;
+      return word;
+    }
+    return HashUtil::HashBytes(reinterpret_cast<const char *>(&key), sizeof(KeyType));
+#endif
   }
 };
 
@@ -12,15 +12,109 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
 #include <queue>
 #include <string>
 #include <vector>
 
+#include "common/macros.h"
 #include "concurrency/transaction.h"
 #include "storage/page/hash_table_page_defs.h"
 
 namespace bustub {
 
+/**
+ * A point-in-time snapshot of a hash table's occupancy and probe behavior,
+ * collected so bucket counts and resize thresholds can be tuned from live
+ * workloads rather than guessed.
+ */
+struct HashTableStats {
+  /** Number of probe-length buckets; the last bucket absorbs longer probes. */
+  static constexpr size_t PROBE_HISTOGRAM_BUCKETS = 16;
+
+  /** Slots in the current layout. */
+  size_t num_slots{0};
+  /** Slots holding a live key-value pair. */
+  size_t num_readable{0};
+  /** Slots holding a tombstone: occupied but no longer readable. */
+  size_t num_tombstones{0};
+  /**
+   * probe_lengths[i] counts probes that stepped past i occupied slots before
+   * resolving; a spike in the high buckets means heavy clustering.
+   */
+  size_t probe_lengths[PROBE_HISTOGRAM_BUCKETS]{};
+
+  /** @return the fraction of slots holding a live pair */
+  double LoadFactor() const {
+    return num_slots == 0 ? 0.0 : static_cast<double>(num_readable) / static_cast<double>(num_slots);
+  }
+};
+
+/**
+ * A small-buffer-optimized result container for point queries. Almost every
+ * probe against a unique index resolves to exactly one value, and a fresh
+ * std::vector heap-allocates even for that single element; this buffer holds
+ * the first few values inline and only touches the heap once a non-unique key
+ * overflows them. clear() keeps whatever capacity the buffer grew to, so one
+ * buffer amortizes across a loop of probes. The members mirror the slice of
+ * std::vector's interface the lookup paths use, so the two are interchangeable
+ * inside the probe code.
+ */
+template <typename ValueType>
+class HashTableResultBuffer {
+ public:
+  /** Values held inline before the buffer spills to the heap. */
+  static constexpr size_t INLINE_CAPACITY = 4;
+
+  HashTableResultBuffer() = default;
+  DISALLOW_COPY(HashTableResultBuffer);
+
+  /** Appends a value, spilling to a doubled heap buffer when full. */
+  void push_back(const ValueType &value) {  // NOLINT
+    if (size_ == capacity_) {
+      Grow();
+    }
+    data_[size_++] = value;
+  }
+
+  /** Forgets the stored values; spilled capacity, if any, is kept. */
+  void clear() { size_ = 0; }  // NOLINT
+
+  /** @return true if the buffer holds no values */
+  bool empty() const { return size_ == 0; }  // NOLINT
+
+  /** @return the number of stored values */
+  size_t size() const { return size_; }  // NOLINT
+
+  /** @return the stored value at the given position */
+  const ValueType &operator[](size_t index) const { return data_[index]; }
+
+  const ValueType *begin() const { return data_; }  // NOLINT
+  const ValueType *end() const { return data_ + size_; }  // NOLINT
+
+ private:
+  /** Moves the values into a heap buffer of twice the current capacity. */
+  void Grow() {
+    size_t new_capacity = capacity_ * 2;
+    auto new_heap = std::make_unique<ValueType[]>(new_capacity);
+    std::copy(data_, data_ + size_, new_heap.get());
+    heap_ = std::move(new_heap);
+    data_ = heap_.get();
+    capacity_ = new_capacity;
+  }
+
+  /** The inline storage every buffer starts in. */
+  ValueType inline_values_[INLINE_CAPACITY];
+  /** The spill storage, allocated on first overflow. */
+  std::unique_ptr<ValueType[]> heap_;
+  /** Points at inline_values_ until the buffer spills, then at heap_. */
+  ValueType *data_{inline_values_};
+  size_t size_{0};
+  size_t capacity_{INLINE_CAPACITY};
+};
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTable {
  public:
@@ -52,6 +146,12 @@ class HashTable {
    * @return the value(s) associated with the given key
    */
   virtual bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) = 0;
+
+  /**
+   * Snapshots the table's occupancy counters and probe-length histogram.
+   * @param[out] stats the snapshot to fill
+   */
+  virtual void GetStats(HashTableStats *stats) = 0;
 };
 
 }  // namespace bustub
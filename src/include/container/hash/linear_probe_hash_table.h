@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <queue>
 #include <string>
 #include <vector>
@@ -32,6 +34,25 @@ namespace bustub {
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Latching is two-level: the table-wide table_latch_ is held shared by every
+ * operation and exclusively only by Resize, and within an operation each
+ * visited block holds its own page latch for just the slots probed in it. A
+ * probe that crosses a block boundary releases the latch before taking the
+ * next one, so concurrent operations on different blocks never contend.
+ *
+ * Growth is incremental. Resize only installs a fresh, twice-as-large layout
+ * and keeps the old one alive; every subsequent insert migrates one old
+ * block's live pairs into the new layout, and while both layouts exist the
+ * read paths consult the old one first. The insert that migrates the last
+ * block frees the old pages in a brief exclusive section, so the exclusive
+ * latch never covers a rebuild -- only page allocation and page deallocation.
+ *
+ * Tombstone compaction reuses the same machinery: once removes push the
+ * tombstone ratio past a configurable threshold, a fresh same-size layout is
+ * installed and the live pairs migrate into it while the tombstones stay
+ * behind. Removes pay migration debt just like inserts, so compaction makes
+ * progress even on delete-only workloads.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
@@ -75,7 +96,67 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Performs a point query into a small-buffer result container, so a probe
+   * that returns a handful of values never heap-allocates.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return true if the key stores at least one value
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, HashTableResultBuffer<ValueType> *result);
+
+  /**
+   * Point-query fast path for unique keys: the probe stops at the first match
+   * and writes it straight to the caller, with no result container at all.
+   * Callers assert uniqueness by using it -- under a non-unique key an
+   * arbitrary one of the stored values is returned.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value associated with the key
+   * @return true if the key stores a value
+   */
+  bool GetSingleValue(Transaction *transaction, const KeyType &key, ValueType *result);
+
+  /**
+   * Inserts a batch of key-value pairs. The entries are processed in home
+   * slot order so each block page is fetched and latched once for every
+   * insert that starts in it, instead of once per pair; probes that leave
+   * their starting block (or find the table full) fall back to the one-pair
+   * path. Per-entry semantics match Insert: exact duplicates are skipped.
+   * @param transaction the current transaction
+   * @param entries the key-value pairs to insert
+   */
+  void InsertBatch(Transaction *transaction, const std::vector<std::pair<KeyType, ValueType>> &entries);
+
+  /**
+   * Builds the table from scratch in one pass. The layout is pre-sized so the load ends half
+   * full -- the headroom a fresh Resize leaves -- so the build itself can never trigger a
+   * mid-build grow. The entries are then partitioned by destination block and each block page
+   * is filled in one pinned pass with no page latches at all: the exclusive table latch stands
+   * in for them. Exact duplicates are skipped, matching Insert. A table that already stores
+   * pairs (or has a migration in flight) cannot swap its layout out, so the entries take the
+   * batched insert path instead.
+   * @param transaction the current transaction
+   * @param entries the key-value pairs to load; the vector's size is the sizing hint
+   */
+  void BulkLoad(Transaction *transaction, const std::vector<std::pair<KeyType, ValueType>> &entries);
+
+  /**
+   * Performs a batch of point queries, filling results[i] with the values
+   * stored under keys[i]. Like InsertBatch, the keys are processed in home
+   * slot order so each block page is fetched and latched once.
+   * @param transaction the current transaction
+   * @param keys the keys to look up
+   * @param[out] results one value list per key, in the keys' order
+   */
+  void GetValueBatch(Transaction *transaction, const std::vector<KeyType> &keys,
+                     std::vector<std::vector<ValueType>> *results);
+
+  /**
+   * Grows the table to at least twice the initial size provided. Only a new
+   * empty layout is installed here; the old layout's pairs migrate one block
+   * per subsequent insert (see MigrateStep), so no caller ever waits for a
+   * full rebuild.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
@@ -86,12 +167,152 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    */
   size_t GetSize();
 
+  /**
+   * Snapshots the occupancy counters and probe-length histogram. The counters
+   * are bumped with relaxed atomics on the operation paths, so a snapshot
+   * taken under load is consistent to within the operations in flight; while
+   * a resize is migrating, pairs still in the old layout are counted but
+   * num_slots already reflects the new one.
+   * @param[out] stats the snapshot to fill
+   */
+  void GetStats(HashTableStats *stats) override;
+
+  /**
+   * Sets the tombstones-per-slot fraction beyond which a remove schedules
+   * tombstone compaction.
+   * @param tombstone_ratio the new threshold
+   */
+  void SetCompactionThreshold(double tombstone_ratio);
+
  private:
+  /** Outcome of one probe-and-insert pass over a layout. */
+  enum class ProbeInsertResult { INSERTED, DUPLICATE, FULL };
+
+  /**
+   * Allocates and zeroes a fresh header page and enough block pages for at
+   * least num_buckets slots, leaving header_page_id_, size_ and num_blocks_
+   * describing the new layout. Callers hold the table latch exclusively (or
+   * are the constructor).
+   * @param num_buckets the minimum number of slots
+   */
+  void CreateTable(size_t num_buckets);
+
+  /**
+   * Collects the values stored under a key in one layout, latching each
+   * visited block. Values already in the result are skipped, since a pair
+   * mid-migration can be visible in both layouts for a moment. Templated over
+   * the result container so the std::vector and small-buffer GetValue
+   * overloads share one probe; both containers expose the vector surface the
+   * body uses.
+   */
+  template <typename ResultContainer>
+  void ProbeGet(page_id_t header_page_id, size_t size, const KeyType &key, ResultContainer *result);
+
+  /**
+   * Probes one layout and stops at the first value stored under the key,
+   * latching each visited block.
+   * @return true if a value was found and written to result
+   */
+  bool ProbeGetFirst(page_id_t header_page_id, size_t size, const KeyType &key, ValueType *result);
+
+  /**
+   * Probes one layout from the key's home slot and claims the first
+   * never-used slot, latching each visited block.
+   */
+  ProbeInsertResult ProbeInsert(page_id_t header_page_id, size_t size, const KeyType &key, const ValueType &value);
+
+  /** Removes the pair from one layout; returns true if it was found. */
+  bool ProbeRemove(page_id_t header_page_id, size_t size, const KeyType &key, const ValueType &value);
+
+  /** @return true if the exact pair is stored in the given layout */
+  bool ProbeContains(page_id_t header_page_id, size_t size, const KeyType &key, const ValueType &value);
+
+  /**
+   * Migrates at most one old-layout block into the current layout: live
+   * pairs are re-inserted (latched) and tombstoned in the old block, leaving
+   * its occupied bits set so concurrent probe chains stay intact. Runs under
+   * the shared table latch, once per insert while a resize is in flight.
+   * @return true if every old block has now been migrated
+   */
+  bool MigrateStep();
+
+  /**
+   * Moves one old block if a migration is in flight and releases the shared
+   * table latch, which the caller holds. The caller that moves the last block
+   * re-acquires the latch exclusively for a moment to free the old pages.
+   */
+  void StepMigrationAndUnlock();
+
+  /**
+   * Reclaims tombstones by installing a fresh layout with the same slot count
+   * and letting the incremental migration rehash the live pairs into it; the
+   * tombstones simply never move. A no-op if a migration is already in flight
+   * or a concurrent compaction got there first.
+   */
+  void Compact();
+
+  /**
+   * Synchronously migrates whatever the per-insert steps have not yet moved
+   * and frees the old layout's pages. Callers hold the table latch
+   * exclusively; already-migrated blocks hold only tombstones, so re-scanning
+   * them moves nothing.
+   */
+  void FinishMigration();
+
+  /**
+   * Inserts a key-value pair without taking any latches, probing from the
+   * key's home slot. Only FinishMigration uses this, under the exclusive
+   * table latch.
+   * @param header the pinned header page of the table being filled
+   * @param key the key to insert
+   * @param value the value to be associated with the key
+   */
+  void InsertUnlatched(HashTableHeaderPage *header, const KeyType &key, const ValueType &value);
+
+  /** @return the slot the key probes from, in a layout of the given size */
+  size_t HomeSlot(const KeyType &key, size_t size) { return hash_fn_.GetHash(key) % size; }
+
+  /** Counts a probe that stepped past the given number of occupied slots. */
+  void RecordProbeLength(size_t probed) {
+    probe_lengths_[std::min(probed, HashTableStats::PROBE_HISTOGRAM_BUCKETS - 1)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
+  // Slot count and block count of the current layout, mirrored from the
+  // header page so probes do not pin it; guarded by table_latch_.
+  size_t size_{0};
+  size_t num_blocks_{0};
+
+  // Old layout kept alive during an incremental resize; INVALID_PAGE_ID when
+  // no resize is in flight. Installed and torn down under the exclusive table
+  // latch, read under the shared one.
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  size_t old_size_{0};
+  size_t old_num_blocks_{0};
+  // Migration progress: inserts claim old blocks to move with next_migrate_block_
+  // and count finished moves in migrated_blocks_.
+  std::atomic<size_t> next_migrate_block_{0};
+  std::atomic<size_t> migrated_blocks_{0};
+
+  // Occupancy counters and probe-length histogram, bumped with relaxed
+  // operations on the hot paths so monitoring costs no synchronization.
+  // num_tombstones_ describes the current layout and starts over on Resize,
+  // since the fresh layout begins tombstone-free; num_readable_ counts live
+  // pairs across both layouts (migration moves pairs, it never adds any).
+  std::atomic<size_t> num_readable_{0};
+  std::atomic<size_t> num_tombstones_{0};
+
+  // Tombstone ratio that triggers compaction; written under the exclusive
+  // table latch, read under the shared one.
+  static constexpr double DEFAULT_COMPACTION_TOMBSTONE_RATIO = 0.25;
+  double compaction_tombstone_ratio_{DEFAULT_COMPACTION_TOMBSTONE_RATIO};
+  std::atomic<size_t> probe_lengths_[HashTableStats::PROBE_HISTOGRAM_BUCKETS] = {};
+
   // Readers includes inserts and removes, writer is only resize
   ReaderWriterLatch table_latch_;
 
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_hasher.h
+//
+// Identification: src/include/execution/batch_hasher.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/util/hash_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * BatchHasher computes the combined key hash of every tuple in a batch, column at a time.
+ * Row-at-a-time hashing pays the HashValue type switch and a CombineHashes call per column per
+ * row, interleaved with expression evaluation; here each key column is evaluated down the whole
+ * batch with the type switch hoisted out of the loop, and the per-row value hashes are folded
+ * into the running hashes in a second flat pass over two contiguous arrays, where successive
+ * rows are independent and the CRC/multiply kernels pipeline across iterations.
+ *
+ * The result is bit-for-bit identical to HashUtil::CombineHashes(h, HashUtil::HashValue(&val))
+ * applied per non-null column in order. That is load-bearing: the Bloom filter a hash join
+ * pushes into a probe-side scan re-hashes rows with the scalar path, and a partition spilled
+ * under batch hashes is probed with scalar ones, so the two must always agree.
+ */
+class BatchHasher {
+ public:
+  /**
+   * Hashes every tuple of a batch against the given key expressions.
+   * @param batch the batch to hash
+   * @param schema the schema the expressions evaluate against
+   * @param exprs the key expressions; a null value contributes nothing to its row's hash
+   * @param[out] hashes the per-row combined hashes, resized to the batch
+   */
+  void HashBatch(TupleBatch *batch, const Schema *schema, const std::vector<const AbstractExpression *> &exprs,
+                 std::vector<hash_t> *hashes) {
+    size_t n = batch->Size();
+    hashes->assign(n, 0);
+    column_.resize(n);
+    valid_.resize(n);
+    for (const auto *expr : exprs) {
+      GatherColumnHashes(batch, schema, expr);
+      hash_t *row_hashes = hashes->data();
+      for (size_t i = 0; i < n; i++) {
+        if (valid_[i] != 0) {
+          row_hashes[i] = HashUtil::CombineHashes(row_hashes[i], column_[i]);
+        }
+      }
+    }
+  }
+
+ private:
+  /** Evaluates one key expression down the batch, leaving each row's value hash in column_. */
+  void GatherColumnHashes(TupleBatch *batch, const Schema *schema, const AbstractExpression *expr) {
+    switch (expr->GetReturnType()) {
+      case TypeId::TINYINT:
+        GatherInteger<int8_t>(batch, schema, expr);
+        break;
+      case TypeId::SMALLINT:
+        GatherInteger<int16_t>(batch, schema, expr);
+        break;
+      case TypeId::INTEGER:
+        GatherInteger<int32_t>(batch, schema, expr);
+        break;
+      case TypeId::BIGINT:
+        GatherInteger<int64_t>(batch, schema, expr);
+        break;
+      default:
+        // Varlen and the remaining scalar types keep the per-value dispatch; they are off the
+        // integer-key path that join and group-by schemas overwhelmingly use.
+        for (size_t i = 0; i < batch->Size(); i++) {
+          Value val = expr->Evaluate(&batch->Get(i), schema);
+          valid_[i] = static_cast<uint8_t>(!val.IsNull());
+          column_[i] = valid_[i] != 0 ? HashUtil::HashValue(&val) : 0;
+        }
+        break;
+    }
+  }
+
+  /** The typed gather: each value widens to the same canonical word HashValue hashes. */
+  template <typename T>
+  void GatherInteger(TupleBatch *batch, const Schema *schema, const AbstractExpression *expr) {
+    for (size_t i = 0; i < batch->Size(); i++) {
+      Value val = expr->Evaluate(&batch->Get(i), schema);
+      if (val.IsNull()) {
+        valid_[i] = 0;
+        continue;
+      }
+      auto raw = static_cast<int64_t>(val.GetAs<T>());
+      valid_[i] = 1;
+      column_[i] = HashUtil::Hash<int64_t>(&raw);
+    }
+  }
+
+  /** Per-column scratch: each row's value hash and whether the value was non-null. */
+  std::vector<hash_t> column_;
+  std::vector<uint8_t> valid_;
+};
+
+}  // namespace bustub
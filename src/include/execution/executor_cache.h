@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// executor_cache.h
+//
+// Identification: src/include/execution/executor_cache.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include "execution/executor_factory.h"
+
+namespace bustub {
+
+/**
+ * ExecutorCache keeps prepared executor trees keyed by their plan, so repeated executions of
+ * the same statement skip rebuilding the tree and re-run through Init() instead. Construction
+ * is where the one-time work lives -- expression compilation, hash table and buffer
+ * allocations -- while Init() only resets state (tables are emptied but keep their capacity),
+ * so the steady-state cost of a cached statement is the reset, not the build.
+ *
+ * Plans are keyed by pointer: a caller executing the same statement repeatedly holds a stable
+ * plan tree, so pointer identity stands in for shape equality. Executors bind the context they
+ * were created with, so a cache must not outlive its ExecutorContext or be shared across
+ * contexts. Drop the cache (or Clear() it) when a schema change invalidates the plans.
+ */
+class ExecutorCache {
+ public:
+  /**
+   * Returns the prepared executor for a plan, building and caching it on first use. The caller
+   * re-runs the statement with Init() then Next(); the cache retains ownership.
+   * @param exec_ctx the executor context the statement runs in
+   * @param plan the plan to be executed
+   * @return the prepared executor, valid until the cache is cleared or destroyed
+   */
+  AbstractExecutor *GetExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan) {
+    auto it = executors_.find(plan);
+    if (it == executors_.end()) {
+      it = executors_.emplace(plan, ExecutorFactory::CreateExecutor(exec_ctx, plan)).first;
+    }
+    return it->second.get();
+  }
+
+  /** Drops every prepared executor, e.g. after a schema change invalidates the plans. */
+  void Clear() { executors_.clear(); }
+
+ private:
+  /** The prepared executors, keyed by their plan tree. */
+  std::unordered_map<const AbstractPlanNode *, std::unique_ptr<AbstractExecutor>> executors_;
+};
+}  // namespace bustub
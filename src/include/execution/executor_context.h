@@ -12,13 +12,25 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "catalog/simple_catalog.h"
+#include "common/memory_tracker.h"
+#include "common/thread_pool.h"
 #include "concurrency/transaction.h"
+#include "execution/executor_stats.h"
+#include "storage/disk/temp_space_manager.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "type/arena_pool.h"
 
 namespace bustub {
 /**
@@ -31,9 +43,22 @@ class ExecutorContext {
    * @param transaction the transaction executing the query
    * @param catalog the catalog that the executor should use
    * @param bpm the buffer pool manager that the executor should use
+   * @param thread_pool the process-wide worker pool (e.g. BustubInstance's), or nullptr to give
+   * this query a private pool on first use
+   * @param memory_tracker the process-wide executor memory tracker (e.g. BustubInstance's), or
+   * nullptr to run this query's operators unthrottled
    */
-  ExecutorContext(Transaction *transaction, SimpleCatalog *catalog, BufferPoolManager *bpm)
-      : transaction_(transaction), catalog_{catalog}, bpm_{bpm} {}
+  ExecutorContext(Transaction *transaction, SimpleCatalog *catalog, BufferPoolManager *bpm,
+                  ThreadPool *thread_pool = nullptr, MemoryTracker *memory_tracker = nullptr)
+      : transaction_(transaction),
+        catalog_{catalog},
+        bpm_{bpm},
+        shared_thread_pool_{thread_pool},
+        memory_tracker_{memory_tracker} {
+    // A query may keep up to a quarter of the pool pinned before its discretionary fetches
+    // are gated; see WithinPinQuota.
+    pin_quota_ = bpm != nullptr ? std::max<size_t>(1, bpm->GetPoolSize() / 4) : SIZE_MAX;
+  }
 
   DISALLOW_COPY_AND_MOVE(ExecutorContext);
 
@@ -45,6 +70,59 @@ class ExecutorContext {
   /** @return the catalog */
   SimpleCatalog *GetCatalog() { return catalog_; }
 
+  /**
+   * Pins the catalog as of now for the rest of this context's lifetime: every later resolution
+   * answers from the pinned version with no catalog synchronization, and DDL published after
+   * the pin is invisible to this query -- repeatable plan-time resolution instead of the
+   * default read-latest behavior. Call at query start, before the first resolution.
+   */
+  void PinCatalogVersion() {
+    if (catalog_ != nullptr) {
+      catalog_version_ = catalog_->PinVersion();
+    }
+  }
+
+  /**
+   * Resolves a table by oid through this query's resolution cache. Metadata pointers are
+   * stable for the catalog's lifetime, so the first resolution's answer serves every later
+   * one and repeated executor Init() calls stop going back to the catalog. Misses are not
+   * cached: a table created after the first attempt is still found -- unless the context has
+   * pinned a catalog version, in which case resolution is repeatable against that version.
+   * Not thread-safe -- executors resolve in Init() on the query thread, before any workers run.
+   * @param table_oid the table to resolve
+   * @return the table's metadata, or nullptr if no such table exists
+   */
+  TableMetadata *GetTable(table_oid_t table_oid) {
+    auto cached = table_oid_cache_.find(table_oid);
+    if (cached != table_oid_cache_.end()) {
+      return cached->second;
+    }
+    TableMetadata *table =
+        catalog_version_ != nullptr ? catalog_->GetTable(catalog_version_, table_oid) : catalog_->GetTable(table_oid);
+    if (table != nullptr) {
+      table_oid_cache_.emplace(table_oid, table);
+    }
+    return table;
+  }
+
+  /**
+   * Resolves a table by name through this query's resolution cache; see GetTable(table_oid_t).
+   * @param table_name the table to resolve
+   * @return the table's metadata, or nullptr if no such table exists
+   */
+  TableMetadata *GetTable(const std::string &table_name) {
+    auto cached = table_name_cache_.find(table_name);
+    if (cached != table_name_cache_.end()) {
+      return cached->second;
+    }
+    TableMetadata *table =
+        catalog_version_ != nullptr ? catalog_->GetTable(catalog_version_, table_name) : catalog_->GetTable(table_name);
+    if (table != nullptr) {
+      table_name_cache_.emplace(table_name, table);
+    }
+    return table;
+  }
+
   /** @return the buffer pool manager */
   BufferPoolManager *GetBufferPoolManager() { return bpm_; }
 
@@ -54,10 +132,141 @@ class ExecutorContext {
   /** @return the lock manager - don't worry about it for now */
   LockManager *GetLockManager() { return nullptr; }
 
+  /**
+   * @return the thread pool for this query's parallel operators: the process-wide pool when the
+   * context was built with one, otherwise a private pool created on first use so purely serial
+   * queries never spawn worker threads. Operators must scope their waits with a TaskGroup; the
+   * pool may be running other operators' (and other queries') tasks.
+   */
+  ThreadPool *GetThreadPool() {
+    if (shared_thread_pool_ != nullptr) {
+      return shared_thread_pool_;
+    }
+    if (thread_pool_ == nullptr) {
+      thread_pool_ = std::make_unique<ThreadPool>();
+    }
+    return thread_pool_.get();
+  }
+
+  /**
+   * @return this query's temp-space manager, created on first use so queries that never spill
+   * pay nothing. Spilling operators (grace hash join, external sort) put their TmpTuplePages
+   * here instead of in the buffer pool, so spill traffic cannot evict the working set; the
+   * temp file and every page in it are dropped when the context is destroyed.
+   */
+  TempSpaceManager *GetTempSpace() {
+    if (temp_space_ == nullptr) {
+      temp_space_ = std::make_unique<TempSpaceManager>();
+    }
+    return temp_space_.get();
+  }
+
+  /**
+   * @return the process-wide memory tracker that buffering operators reserve against, or
+   * nullptr when the context was built without one. Operators hold a MemoryReservation on it
+   * and take their spill path when a reserve is denied.
+   */
+  MemoryTracker *GetMemoryTracker() { return memory_tracker_; }
+
+  /**
+   * @return the most groups an aggregation may hold in memory before it spills partitions to
+   * temp space; see AggregationExecutor. Counted in groups rather than bytes so the check is
+   * a comparison against the table's size instead of an accounting pass over its Values.
+   */
+  size_t GetAggregationGroupBudget() const { return aggregation_group_budget_; }
+
+  /** Overrides the aggregation group budget, e.g. to force spilling in tests. */
+  void SetAggregationGroupBudget(size_t budget) { aggregation_group_budget_ = budget; }
+
+  /**
+   * @return the arena that backs tuple buffers materialized during this query. Executors point
+   * scratch tuples at it (Tuple::SetPool) so per-row copies bump-allocate out of the arena
+   * instead of hitting malloc; everything is reclaimed wholesale when the context is destroyed.
+   * Not thread-safe -- parallel operators keep their per-worker copies on the heap.
+   */
+  ArenaPool *GetTuplePool() { return &tuple_pool_; }
+
+  /**
+   * Records one buffer pool pin taken on behalf of this query; pair with RecordUnpin. Scans
+   * account their page pins here so a single query's in-flight footprint is visible and
+   * discretionary consumption -- speculative readahead first -- can be gated on the quota.
+   */
+  void RecordPin() { pinned_pages_.fetch_add(1, std::memory_order_relaxed); }
+
+  /** Records the release of a pin counted by RecordPin. */
+  void RecordUnpin() { pinned_pages_.fetch_sub(1, std::memory_order_relaxed); }
+
+  /** @return the pages this query currently holds pinned through the accounted paths */
+  size_t PinnedPages() const { return pinned_pages_.load(std::memory_order_relaxed); }
+
+  /**
+   * @return true while this query's accounted pins are under its quota. Required pins (the
+   * page a scan is positioned on) are taken regardless; callers consult this only for pages
+   * they can do without, so a runaway query throttles itself before it pins the pool solid.
+   */
+  bool WithinPinQuota() const { return PinnedPages() < pin_quota_; }
+
+  /** Overrides the pin quota, e.g. to force readahead throttling in tests. */
+  void SetPinQuota(size_t quota) { pin_quota_ = quota; }
+
+  /**
+   * Registers runtime counters for one executor of this query. Called by the StatsExecutor
+   * wrapper at construction; the context owns the counters so the profile survives the
+   * executor tree.
+   * @param name the executor's plan type name
+   * @return the counters, valid for the lifetime of this context
+   */
+  ExecutorStats *RegisterStats(std::string name) {
+    executor_stats_.push_back(std::make_unique<ExecutorStats>(std::move(name)));
+    return executor_stats_.back().get();
+  }
+
+  /** @return the per-executor runtime counters of this query, in executor creation order */
+  const std::vector<std::unique_ptr<ExecutorStats>> &GetExecutorStats() const { return executor_stats_; }
+
+  /**
+   * Formats the per-executor counters as an EXPLAIN ANALYZE-style report, one line per
+   * executor. Time and fetch counts are inclusive of each executor's subtree.
+   * @return the report, empty if no executor has been created under this context
+   */
+  std::string ReportStats() const {
+    std::ostringstream report;
+    for (const auto &stats : executor_stats_) {
+      report << stats->name_ << ": rows=" << stats->rows_out_ << " next_calls=" << stats->next_calls_
+             << " batch_calls=" << stats->batch_calls_ << " cycles=" << stats->cycles_
+             << " pool_fetches=" << stats->pool_fetches_ << "\n";
+    }
+    return report.str();
+  }
+
  private:
   Transaction *transaction_;
   SimpleCatalog *catalog_;
+  /** The catalog version this query resolves against, or null to always read the latest. */
+  SimpleCatalog::Version catalog_version_;
   BufferPoolManager *bpm_;
+  /** The process-wide worker pool, or nullptr when this query runs with a private pool. */
+  ThreadPool *shared_thread_pool_;
+  /** The process-wide executor memory tracker, or nullptr when this query is unthrottled. */
+  MemoryTracker *memory_tracker_;
+  /** Lazily created private pool, used only when no shared pool was supplied. */
+  std::unique_ptr<ThreadPool> thread_pool_;
+  /** Lazily created temp space for this query's spilling operators; see GetTempSpace. */
+  std::unique_ptr<TempSpaceManager> temp_space_;
+  /** The cap on in-memory aggregation groups before spilling; see GetAggregationGroupBudget. */
+  size_t aggregation_group_budget_{1 << 20};
+  /** Buffer pool pins currently held by this query's accounted paths; see RecordPin. */
+  std::atomic<size_t> pinned_pages_{0};
+  /** The quota WithinPinQuota checks accounted pins against; see SetPinQuota. */
+  size_t pin_quota_;
+  /** Runtime counters of this query's executors, registered by their StatsExecutor wrappers. */
+  std::vector<std::unique_ptr<ExecutorStats>> executor_stats_;
+  /** Tables this query has already resolved by oid; see GetTable. */
+  std::unordered_map<table_oid_t, TableMetadata *> table_oid_cache_;
+  /** Tables this query has already resolved by name; see GetTable. */
+  std::unordered_map<std::string, TableMetadata *> table_name_cache_;
+  /** Arena behind the tuples this query materializes, freed wholesale with the context. */
+  ArenaPool tuple_pool_;
 };
 
 }  // namespace bustub
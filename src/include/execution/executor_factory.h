@@ -30,5 +30,14 @@ class ExecutorFactory {
    * @return an executor for the given plan and context
    */
   static std::unique_ptr<AbstractExecutor> CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan);
+
+ private:
+  /**
+   * Creates the bare executor for a plan node, without the stats wrapper CreateExecutor adds.
+   * @param exec_ctx the executor context for the created executor
+   * @param plan the plan node that needs to be executed
+   * @return an executor for the given plan and context
+   */
+  static std::unique_ptr<AbstractExecutor> CreateRawExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan);
 };
 }  // namespace bustub
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// executor_stats.h
+//
+// Identification: src/include/execution/executor_stats.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>  // NOLINT
+#endif
+
+namespace bustub {
+
+/**
+ * ExecutorStats holds the runtime counters of one executor in a query, collected by the
+ * StatsExecutor wrapper the factory places around every operator. The counters are inclusive:
+ * an operator's time and buffer pool fetches include those of the subtree below it, the way
+ * EXPLAIN ANALYZE reports them.
+ */
+struct ExecutorStats {
+  /** Creates counters for the named executor, all zeroed. */
+  explicit ExecutorStats(std::string name) : name_(std::move(name)) {}
+
+  /** The executor's plan type name, e.g. "SeqScan". */
+  std::string name_;
+  /** Number of tuple-at-a-time Next calls. */
+  uint64_t next_calls_{0};
+  /** Number of NextBatch calls. */
+  uint64_t batch_calls_{0};
+  /** Number of tuples this executor produced. */
+  uint64_t rows_out_{0};
+  /** Cycles spent in Init, Next, and NextBatch, including the subtree below. */
+  uint64_t cycles_{0};
+  /** Buffer pool fetches issued while this executor (or its subtree) was running. */
+  uint64_t pool_fetches_{0};
+};
+
+/**
+ * Reads the processor cycle counter. rdtsc costs a couple dozen cycles, cheap enough to wrap
+ * every Next call and leave enabled in production; platforms without it fall back to the
+ * steady clock in nanoseconds.
+ * @return the current cycle count
+ */
+inline uint64_t ReadCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+}  // namespace bustub
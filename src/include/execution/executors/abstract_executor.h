@@ -13,11 +13,14 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
+#include "type/varlen_pool.h"
 
 namespace bustub {
 /**
- * AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * AbstractExecutor implements the Volcano tuple-at-a-time iterator model, extended with a
+ * batch-at-a-time NextBatch for operators that can amortize per-tuple costs.
  */
 class AbstractExecutor {
  public:
@@ -43,6 +46,30 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple) = 0;
 
+  /**
+   * Produces up to TupleBatch::BATCH_SIZE tuples in one call, so a parent pays one virtual
+   * dispatch per batch instead of per row. The default implementation drains the tuple-at-a-time
+   * Next(); executors with a cheaper bulk path override it.
+   * @param[out] batch cleared, then filled with the produced tuples
+   * @return true if at least one tuple was produced, false once the executor is exhausted
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    batch->Clear();
+    // The scratch tuple recycles one arena slot across rows (the pool rolls back its most
+    // recent allocation), and survivors are copied into the batch's own arena -- so draining
+    // a child does no per-row malloc at all. The varlen scope does the same for the varchar
+    // Value temporaries Next() churns through (column reads, casts, predicate intermediates):
+    // they bump-allocate from the thread's arena and are released together when the batch is
+    // done. Nothing built under the scope escapes it except as serialized tuple bytes.
+    VarlenPool::Scope varlen_scope(VarlenPool::ThreadLocal());
+    Tuple tuple;
+    tuple.SetPool(exec_ctx_->GetTuplePool());
+    while (!batch->Full() && Next(&tuple)) {
+      batch->AddFromPage(tuple.GetRid(), tuple.GetData(), tuple.GetLength());
+    }
+    return !batch->Empty();
+  }
+
   /** @return the schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
@@ -12,17 +12,23 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "common/memory_tracker.h"
 #include "common/util/hash_util.h"
 #include "container/hash/hash_function.h"
+#include "execution/batch_hasher.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/aggregation_plan.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
 
@@ -39,7 +45,14 @@ class SimpleAggregationHashTable {
    */
   SimpleAggregationHashTable(const std::vector<const AbstractExpression *> &agg_exprs,
                              const std::vector<AggregationType> &agg_types)
-      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
+      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {
+    // The aggregate types are fixed for the executor's lifetime, so the per-row update for
+    // each (aggregation, input type) pair is picked once here instead of per row.
+    kernels_.reserve(agg_exprs_.size());
+    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+      kernels_.push_back(CompileCombineKernel(agg_types_[i], agg_exprs_[i]->GetReturnType()));
+    }
+  }
 
   /** @return the initial aggregrate value for this aggregation executor */
   AggregateValue GenerateInitialAggregateValue() {
@@ -70,6 +83,12 @@ class SimpleAggregationHashTable {
   /** Combines the input into the aggregation result. */
   void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
     for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+      if (kernels_[i] != nullptr) {
+        // A compiled kernel updates the raw representation directly -- a Sum over INTEGER is
+        // an int32 add -- instead of going through the per-type Value virtuals.
+        kernels_[i](&result->aggregates_[i], input.aggregates_[i]);
+        continue;
+      }
       switch (agg_types_[i]) {
         case AggregationType::CountAggregate:
           // Count increases by one.
@@ -91,18 +110,65 @@ class SimpleAggregationHashTable {
     }
   }
 
+  /**
+   * Merges a partial aggregation result into the running aggregation. Unlike
+   * CombineAggregateValues, the input is itself an aggregate: counts are summed rather than
+   * incremented, so partial tables built over disjoint slices of the input merge correctly.
+   */
+  void MergeAggregateValues(AggregateValue *result, const AggregateValue &partial) {
+    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+      switch (agg_types_[i]) {
+        case AggregationType::CountAggregate:
+          // A partial count is added, not counted as one more row.
+          result->aggregates_[i] = result->aggregates_[i].Add(partial.aggregates_[i]);
+          break;
+        case AggregationType::SumAggregate:
+          result->aggregates_[i] = result->aggregates_[i].Add(partial.aggregates_[i]);
+          break;
+        case AggregationType::MinAggregate:
+          result->aggregates_[i] = result->aggregates_[i].Min(partial.aggregates_[i]);
+          break;
+        case AggregationType::MaxAggregate:
+          result->aggregates_[i] = result->aggregates_[i].Max(partial.aggregates_[i]);
+          break;
+      }
+    }
+  }
+
   /**
    * Inserts a value into the hash table and then combines it with the current aggregation.
+   * The key is taken by value so a caller's temporary moves into the table instead of having
+   * its Values deep-copied, and try_emplace finds or creates the group in a single probe.
    * @param agg_key the key to be inserted
    * @param agg_val the value to be inserted
    */
-  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht.count(agg_key) == 0) {
-      ht.insert({agg_key, GenerateInitialAggregateValue()});
+  void InsertCombine(AggregateKey agg_key, const AggregateValue &agg_val) {
+    auto [it, inserted] = ht.try_emplace(std::move(agg_key));
+    if (inserted) {
+      it->second = GenerateInitialAggregateValue();
+    }
+    CombineAggregateValues(&it->second, agg_val);
+  }
+
+  /**
+   * Inserts a group's partial aggregation result and merges it with the current aggregation.
+   * @param agg_key the key to be inserted
+   * @param partial the group's partial aggregate from another table
+   */
+  void InsertMerge(AggregateKey agg_key, const AggregateValue &partial) {
+    auto [it, inserted] = ht.try_emplace(std::move(agg_key));
+    if (inserted) {
+      it->second = GenerateInitialAggregateValue();
     }
-    CombineAggregateValues(&ht[agg_key], agg_val);
+    MergeAggregateValues(&it->second, partial);
   }
 
+  /** Removes every group, keeping the map's bucket array for the next execution. */
+  void Clear() { ht.clear(); }
+
+  /** @return the number of groups in the table */
+  size_t Size() const { return ht.size(); }
+
   /**
    * An iterator through the simplified aggregation hash table.
    */
@@ -141,16 +207,483 @@ class SimpleAggregationHashTable {
   Iterator End() { return Iterator{ht.cend()}; }
 
  private:
+  /**
+   * A non-virtual per-row update for one aggregate slot, specialized to its
+   * (AggregationType, input TypeId) pair; nullptr when no specialization exists and the
+   * interpreted switch runs instead.
+   */
+  using CombineKernel = void (*)(Value *result, const Value &input);
+
+  /**
+   * Picks the specialized update body for one aggregate. The kernels work on the values' raw
+   * representation and defer to the Value virtuals exactly where those do more than
+   * arithmetic: null operands (which poison the result), a result that has not settled on the
+   * expected type, and integer overflow (which throws). Count ignores its input entirely, so
+   * it specializes regardless of type.
+   * @return the kernel, or nullptr for shapes the interpreted switch keeps handling
+   */
+  static CombineKernel CompileCombineKernel(AggregationType agg_type, TypeId type) {
+    if (agg_type == AggregationType::CountAggregate) {
+      return [](Value *result, const Value &input) {
+        int32_t count;
+        if (result->IsNull() || __builtin_add_overflow(result->GetAs<int32_t>(), 1, &count)) {
+          *result = result->Add(ValueFactory::GetIntegerValue(1));
+          return;
+        }
+        *result = ValueFactory::GetIntegerValue(count);
+      };
+    }
+    switch (type) {
+      case TypeId::INTEGER:
+        switch (agg_type) {
+          case AggregationType::SumAggregate:
+            return [](Value *result, const Value &input) {
+              int32_t sum;
+              if (result->IsNull() || input.IsNull() || result->GetTypeId() != TypeId::INTEGER ||
+                  __builtin_add_overflow(result->GetAs<int32_t>(), input.GetAs<int32_t>(), &sum)) {
+                *result = result->Add(input);
+                return;
+              }
+              *result = ValueFactory::GetIntegerValue(sum);
+            };
+          case AggregationType::MinAggregate:
+            return [](Value *result, const Value &input) {
+              if (result->IsNull() || input.IsNull() || result->GetTypeId() != TypeId::INTEGER) {
+                *result = result->Min(input);
+                return;
+              }
+              if (input.GetAs<int32_t>() < result->GetAs<int32_t>()) {
+                *result = input;
+              }
+            };
+          case AggregationType::MaxAggregate:
+            return [](Value *result, const Value &input) {
+              if (result->IsNull() || input.IsNull() || result->GetTypeId() != TypeId::INTEGER) {
+                *result = result->Max(input);
+                return;
+              }
+              if (input.GetAs<int32_t>() > result->GetAs<int32_t>()) {
+                *result = input;
+              }
+            };
+          default:
+            break;
+        }
+        break;
+      case TypeId::BIGINT:
+        switch (agg_type) {
+          case AggregationType::SumAggregate:
+            return [](Value *result, const Value &input) {
+              int64_t sum;
+              if (result->IsNull() || input.IsNull() || result->GetTypeId() != TypeId::BIGINT ||
+                  __builtin_add_overflow(result->GetAs<int64_t>(), input.GetAs<int64_t>(), &sum)) {
+                *result = result->Add(input);
+                return;
+              }
+              *result = ValueFactory::GetBigIntValue(sum);
+            };
+          case AggregationType::MinAggregate:
+            return [](Value *result, const Value &input) {
+              if (result->IsNull() || input.IsNull() || result->GetTypeId() != TypeId::BIGINT) {
+                *result = result->Min(input);
+                return;
+              }
+              if (input.GetAs<int64_t>() < result->GetAs<int64_t>()) {
+                *result = input;
+              }
+            };
+          case AggregationType::MaxAggregate:
+            return [](Value *result, const Value &input) {
+              if (result->IsNull() || input.IsNull() || result->GetTypeId() != TypeId::BIGINT) {
+                *result = result->Max(input);
+                return;
+              }
+              if (input.GetAs<int64_t>() > result->GetAs<int64_t>()) {
+                *result = input;
+              }
+            };
+          default:
+            break;
+        }
+        break;
+      case TypeId::DECIMAL:
+        switch (agg_type) {
+          case AggregationType::SumAggregate:
+            return [](Value *result, const Value &input) {
+              if (result->IsNull() || input.IsNull() || result->GetTypeId() != TypeId::DECIMAL) {
+                *result = result->Add(input);
+                return;
+              }
+              *result = ValueFactory::GetDecimalValue(result->GetAs<double>() + input.GetAs<double>());
+            };
+          case AggregationType::MinAggregate:
+            return [](Value *result, const Value &input) {
+              if (result->IsNull() || input.IsNull() || result->GetTypeId() != TypeId::DECIMAL) {
+                *result = result->Min(input);
+                return;
+              }
+              if (input.GetAs<double>() < result->GetAs<double>()) {
+                *result = input;
+              }
+            };
+          case AggregationType::MaxAggregate:
+            return [](Value *result, const Value &input) {
+              if (result->IsNull() || input.IsNull() || result->GetTypeId() != TypeId::DECIMAL) {
+                *result = result->Max(input);
+                return;
+              }
+              if (input.GetAs<double>() > result->GetAs<double>()) {
+                *result = input;
+              }
+            };
+          default:
+            break;
+        }
+        break;
+      default:
+        break;
+    }
+    return nullptr;
+  }
+
   /** The hash table is just a map from aggregate keys to aggregate values. */
   std::unordered_map<AggregateKey, AggregateValue> ht{};
   /** The aggregate expressions that we have. */
   const std::vector<const AbstractExpression *> &agg_exprs_;
   /** The types of aggregations that we have. */
   const std::vector<AggregationType> &agg_types_;
+  /** Per-aggregate compiled update kernels, nullptr where the switch interprets. */
+  std::vector<CombineKernel> kernels_;
+};
+
+/**
+ * CompactAggregationHashTable aggregates groups whose keys are all fixed-width integers in a
+ * flat open-addressing table with the key words stored inline, so grouping an input row costs
+ * one probe over a contiguous array instead of the three allocations and vector-of-Value
+ * compare of the generic map. The key layout is chosen once, from the group-by expressions'
+ * return types: up to two integer columns pack into 16 inline bytes plus a null mask. Key
+ * schemas that do not fit -- varlen or too many columns -- fall back to the generic
+ * SimpleAggregationHashTable behind the same interface.
+ */
+class CompactAggregationHashTable {
+ public:
+  /**
+   * Create a new compact aggregation hash table.
+   * @param group_bys the group-by expressions, used to pick the key layout
+   * @param agg_exprs the aggregation expressions
+   * @param agg_types the types of aggregations
+   */
+  CompactAggregationHashTable(const std::vector<const AbstractExpression *> &group_bys,
+                              const std::vector<const AbstractExpression *> &agg_exprs,
+                              const std::vector<AggregationType> &agg_types)
+      : generic_(agg_exprs, agg_types) {
+    fixed_ = group_bys.size() <= MAX_FIXED_KEYS;
+    for (const auto *expr : group_bys) {
+      key_types_.push_back(expr->GetReturnType());
+      if (!IsFixedWidthInteger(expr->GetReturnType())) {
+        fixed_ = false;
+      }
+    }
+    if (fixed_) {
+      entries_.resize(INITIAL_CAPACITY);
+    }
+  }
+
+  /**
+   * Inserts a value into the hash table and then combines it with the current aggregation.
+   * @param agg_key the key to be inserted
+   * @param agg_val the value to be inserted
+   */
+  void InsertCombine(AggregateKey agg_key, const AggregateValue &agg_val) {
+    if (!fixed_) {
+      generic_.InsertCombine(std::move(agg_key), agg_val);
+      return;
+    }
+    if (2 * (num_groups_ + 1) > entries_.size()) {
+      Grow();
+    }
+    PackedKey key = PackKey(agg_key);
+    Entry *entry = FindEntry(&entries_, key, HashKey(key));
+    if (!entry->occupied_) {
+      entry->occupied_ = true;
+      entry->value_ = generic_.GenerateInitialAggregateValue();
+      num_groups_++;
+    }
+    generic_.CombineAggregateValues(&entry->value_, agg_val);
+  }
+
+  /**
+   * Inserts and combines under a key hash the caller already computed -- e.g. the join-key hash
+   * a fused aggregation reuses from the hash join below it -- skipping the re-hash of the key.
+   * All inserts into one table must use the same hash source, so equal keys always probe from
+   * the same slot; do not mix this with the self-hashing InsertCombine on one table.
+   * @param hash the caller-computed hash of the key
+   * @param agg_key the key to be inserted
+   * @param agg_val the value to be inserted
+   */
+  void InsertCombineHashed(hash_t hash, AggregateKey agg_key, const AggregateValue &agg_val) {
+    if (!fixed_) {
+      generic_.InsertCombine(std::move(agg_key), agg_val);
+      return;
+    }
+    if (2 * (num_groups_ + 1) > entries_.size()) {
+      Grow();
+    }
+    Entry *entry = FindEntry(&entries_, PackKey(agg_key), hash);
+    if (!entry->occupied_) {
+      entry->occupied_ = true;
+      entry->value_ = generic_.GenerateInitialAggregateValue();
+      num_groups_++;
+    }
+    generic_.CombineAggregateValues(&entry->value_, agg_val);
+  }
+
+  /**
+   * Inserts a group's partial aggregation result and merges it with the current aggregation.
+   * @param agg_key the key to be inserted
+   * @param partial the group's partial aggregate from another table
+   */
+  void InsertMerge(AggregateKey agg_key, const AggregateValue &partial) {
+    if (!fixed_) {
+      generic_.InsertMerge(std::move(agg_key), partial);
+      return;
+    }
+    if (2 * (num_groups_ + 1) > entries_.size()) {
+      Grow();
+    }
+    PackedKey key = PackKey(agg_key);
+    Entry *entry = FindEntry(&entries_, key, HashKey(key));
+    if (!entry->occupied_) {
+      entry->occupied_ = true;
+      entry->value_ = generic_.GenerateInitialAggregateValue();
+      num_groups_++;
+    }
+    generic_.MergeAggregateValues(&entry->value_, partial);
+  }
+
+  /** Removes every group, keeping the flat table's allocation for the next execution. */
+  void Clear() {
+    for (auto &entry : entries_) {
+      entry.occupied_ = false;
+    }
+    num_groups_ = 0;
+    generic_.Clear();
+  }
+
+  /** @return the number of groups in the table */
+  size_t Size() const { return fixed_ ? num_groups_ : generic_.Size(); }
+
+  /**
+   * An iterator through the compact aggregation hash table. In the fixed-width mode the
+   * group-by Values are reconstructed from the packed key words on access.
+   */
+  class Iterator {
+   public:
+    /** Creates an iterator positioned at the given slot of the flat table. */
+    Iterator(const CompactAggregationHashTable *table, size_t slot) : table_(table), slot_(slot) { SkipEmpty(); }
+
+    /** Creates an iterator wrapping the generic fallback table's iterator. */
+    explicit Iterator(SimpleAggregationHashTable::Iterator iter) : generic_iter_(iter) {}
+
+    /** @return the key of the iterator */
+    const AggregateKey &Key() {
+      if (table_ == nullptr) {
+        return generic_iter_.Key();
+      }
+      key_cache_ = table_->UnpackKey(table_->entries_[slot_]);
+      return key_cache_;
+    }
+
+    /** @return the value of the iterator */
+    const AggregateValue &Val() {
+      return table_ == nullptr ? generic_iter_.Val() : table_->entries_[slot_].value_;
+    }
+
+    /** @return the iterator after it is incremented */
+    Iterator &operator++() {
+      if (table_ == nullptr) {
+        ++generic_iter_;
+      } else {
+        slot_++;
+        SkipEmpty();
+      }
+      return *this;
+    }
+
+    /** @return true if both iterators are identical */
+    bool operator==(const Iterator &other) {
+      return table_ == nullptr ? generic_iter_ == other.generic_iter_ : slot_ == other.slot_;
+    }
+
+    /** @return true if both iterators are different */
+    bool operator!=(const Iterator &other) { return !(*this == other); }
+
+   private:
+    /** Advances past unoccupied slots. */
+    void SkipEmpty() {
+      while (slot_ < table_->entries_.size() && !table_->entries_[slot_].occupied_) {
+        slot_++;
+      }
+    }
+
+    /** The flat table being iterated, or nullptr when wrapping the generic iterator. */
+    const CompactAggregationHashTable *table_{nullptr};
+    /** The current slot of the flat table. */
+    size_t slot_{0};
+    /** The wrapped generic iterator, used when table_ is nullptr. */
+    SimpleAggregationHashTable::Iterator generic_iter_{{}};
+    /** Holds the reconstructed key so Key() can hand out a reference. */
+    AggregateKey key_cache_;
+  };
+
+  /** @return iterator to the start of the hash table */
+  Iterator Begin() { return fixed_ ? Iterator{this, 0} : Iterator{generic_.Begin()}; }
+
+  /** @return iterator to the end of the hash table */
+  Iterator End() { return fixed_ ? Iterator{this, entries_.size()} : Iterator{generic_.End()}; }
+
+ private:
+  /** The most group-by columns the inline key can hold. */
+  static constexpr size_t MAX_FIXED_KEYS = 2;
+  /** The initial slot count of the flat table; must be a power of two. */
+  static constexpr size_t INITIAL_CAPACITY = 256;
+
+  /** A packed fixed-width group-by key: one word per column plus a null mask. */
+  struct PackedKey {
+    std::array<int64_t, MAX_FIXED_KEYS> words_{};
+    uint8_t null_mask_{0};
+
+    bool operator==(const PackedKey &other) const {
+      return words_ == other.words_ && null_mask_ == other.null_mask_;
+    }
+  };
+
+  /** One slot of the flat table. */
+  struct Entry {
+    PackedKey key_;
+    /** The hash the key was inserted under; reused verbatim when the table grows. */
+    hash_t hash_{0};
+    AggregateValue value_;
+    bool occupied_{false};
+  };
+
+  /** @return true if values of this type pack into a key word */
+  static bool IsFixedWidthInteger(TypeId type) {
+    return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+  }
+
+  /** @return the slot the hash probes to or the first free slot of its probe chain */
+  static Entry *FindEntry(std::vector<Entry> *entries, const PackedKey &key, hash_t hash) {
+    size_t mask = entries->size() - 1;
+    size_t slot = hash & mask;
+    while ((*entries)[slot].occupied_ && !((*entries)[slot].key_ == key)) {
+      slot = (slot + 1) & mask;
+    }
+    Entry *entry = &(*entries)[slot];
+    if (!entry->occupied_) {
+      entry->key_ = key;
+      entry->hash_ = hash;
+    }
+    return entry;
+  }
+
+  /** @return the hash of a packed key */
+  static hash_t HashKey(const PackedKey &key) {
+    hash_t h = key.null_mask_;
+    for (int64_t word : key.words_) {
+      h = HashUtil::CombineHashes(h, static_cast<hash_t>(word));
+    }
+    return h;
+  }
+
+  /** Doubles the flat table and re-seats every occupied entry under its original hash. */
+  void Grow() {
+    std::vector<Entry> grown(entries_.size() * 2);
+    for (auto &entry : entries_) {
+      if (entry.occupied_) {
+        Entry *dst = FindEntry(&grown, entry.key_, entry.hash_);
+        *dst = std::move(entry);
+      }
+    }
+    entries_ = std::move(grown);
+  }
+
+  /** Packs an AggregateKey's integer values into inline words. */
+  PackedKey PackKey(const AggregateKey &agg_key) const {
+    PackedKey key;
+    for (size_t i = 0; i < agg_key.group_bys_.size(); i++) {
+      const Value &val = agg_key.group_bys_[i];
+      if (val.IsNull()) {
+        key.null_mask_ |= 1U << i;
+        continue;
+      }
+      switch (key_types_[i]) {
+        case TypeId::TINYINT:
+          key.words_[i] = val.GetAs<int8_t>();
+          break;
+        case TypeId::SMALLINT:
+          key.words_[i] = val.GetAs<int16_t>();
+          break;
+        case TypeId::INTEGER:
+          key.words_[i] = val.GetAs<int32_t>();
+          break;
+        default:
+          key.words_[i] = val.GetAs<int64_t>();
+          break;
+      }
+    }
+    return key;
+  }
+
+  /** Rebuilds an AggregateKey from an entry's packed words, with the original column types. */
+  AggregateKey UnpackKey(const Entry &entry) const {
+    std::vector<Value> values;
+    values.reserve(key_types_.size());
+    for (size_t i = 0; i < key_types_.size(); i++) {
+      if ((entry.key_.null_mask_ & (1U << i)) != 0) {
+        values.push_back(ValueFactory::GetNullValueByType(key_types_[i]));
+        continue;
+      }
+      switch (key_types_[i]) {
+        case TypeId::TINYINT:
+          values.emplace_back(key_types_[i], static_cast<int8_t>(entry.key_.words_[i]));
+          break;
+        case TypeId::SMALLINT:
+          values.emplace_back(key_types_[i], static_cast<int16_t>(entry.key_.words_[i]));
+          break;
+        case TypeId::INTEGER:
+          values.emplace_back(key_types_[i], static_cast<int32_t>(entry.key_.words_[i]));
+          break;
+        default:
+          values.emplace_back(key_types_[i], entry.key_.words_[i]);
+          break;
+      }
+    }
+    return {values};
+  }
+
+  /** The generic fallback table; also supplies the shared combine logic. */
+  SimpleAggregationHashTable generic_;
+  /** True if the key schema packs into inline words and the flat table is in use. */
+  bool fixed_;
+  /** The group-by column types, for packing and unpacking keys. */
+  std::vector<TypeId> key_types_;
+  /** The flat open-addressing table. */
+  std::vector<Entry> entries_;
+  /** The number of occupied slots. */
+  size_t num_groups_{0};
 };
 
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX) on the tuples of a child executor.
+ *
+ * The hash table is bounded by the context's group budget: when a build pass pushes the table
+ * past it, every resident group is written out as a (key, partial aggregate) row into temp-space
+ * TmpTuplePage chains partitioned by key hash, and the table starts over empty. After the input
+ * is drained the spilled partitions are merged back one at a time -- every occurrence of a key
+ * spilled into the same partition, so one partition's groups fit the same budget that triggered
+ * the spill -- and Next() streams each rebuilt partition before loading the next. A GROUP BY
+ * with more groups than memory degrades to extra temp I/O instead of taking the process down.
  */
 class AggregationExecutor : public AbstractExecutor {
  public:
@@ -162,16 +695,77 @@ class AggregationExecutor : public AbstractExecutor {
    */
   AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
                       std::unique_ptr<AbstractExecutor> &&child)
-      : AbstractExecutor(exec_ctx) {}
+      : AbstractExecutor(exec_ctx),
+        plan_(plan),
+        child_(std::move(child)),
+        aht_(plan_->GetGroupBys(), plan_->GetAggregates(), plan_->GetAggregateTypes()),
+        aht_iterator_(aht_.Begin()),
+        reservation_(exec_ctx->GetMemoryTracker()) {}
 
   /** Do not use or remove this function, otherwise you will get zero points. */
   const AbstractExecutor *GetChildExecutor() const { return child_.get(); }
 
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
-  void Init() override {}
+  void Init() override {
+    child_->Init();
+    // A prepared executor re-runs through Init; empty the table but keep its allocation.
+    aht_.Clear();
+    spilled_ = false;
+    spill_parts_.assign(NUM_SPILL_PARTITIONS, {});
+    spill_open_.assign(NUM_SPILL_PARTITIONS, nullptr);
+    next_partition_ = 0;
+    if (plan_->IsParallel()) {
+      ParallelAggregate();
+    } else {
+      // Group-by hashes are computed a batch at a time by the column-at-a-time kernel and
+      // handed to the table, which otherwise re-hashes every key on insert.
+      TupleBatch batch;
+      while (child_->NextBatch(&batch)) {
+        batch_hasher_.HashBatch(&batch, child_->GetOutputSchema(), plan_->GetGroupBys(), &batch_hashes_);
+        for (size_t i = 0; i < batch.Size(); i++) {
+          Tuple *tuple = &batch.Get(i);
+          aht_.InsertCombineHashed(batch_hashes_[i], MakeKey(tuple), MakeVal(tuple));
+        }
+        MaybeSpill();
+      }
+    }
+    if (spilled_) {
+      // The resident groups join their partitions, and Next() then serves partition by
+      // partition; a partition holds every occurrence of its keys, so rebuilding it is final.
+      SpillTable();
+      CloseSpillPages();
+      aht_.Clear();
+      LoadNextPartition();
+    }
+    aht_iterator_ = aht_.Begin();
+  }
 
-  bool Next(Tuple *tuple) override { return false; }
+  bool Next(Tuple *tuple) override {
+    const AbstractExpression *having = plan_->GetHaving();
+    const Schema *out_schema = GetOutputSchema();
+    while (true) {
+      while (aht_iterator_ != aht_.End()) {
+        const AggregateKey &key = aht_iterator_.Key();
+        const AggregateValue &val = aht_iterator_.Val();
+        if (having == nullptr || having->EvaluateAggregate(key.group_bys_, val.aggregates_).GetAs<bool>()) {
+          std::vector<Value> values;
+          values.reserve(out_schema->GetColumnCount());
+          for (const auto &col : out_schema->GetColumns()) {
+            values.push_back(col.GetExpr()->EvaluateAggregate(key.group_bys_, val.aggregates_));
+          }
+          *tuple = Tuple(values, out_schema);
+          ++aht_iterator_;
+          return true;
+        }
+        ++aht_iterator_;
+      }
+      if (!spilled_ || !LoadNextPartition()) {
+        return false;
+      }
+      aht_iterator_ = aht_.Begin();
+    }
+  }
 
   /** @return the tuple as an AggregateKey */
   AggregateKey MakeKey(const Tuple *tuple) {
@@ -192,13 +786,217 @@ class AggregationExecutor : public AbstractExecutor {
   }
 
  private:
+  /**
+   * Two-phase parallel aggregation. Phase one: the calling thread drains the child in batches
+   * and hands them round-robin to the shared thread pool, where each worker slot aggregates
+   * into its own partial table behind its own latch -- workers never contend on one shared
+   * table. Phase two: once the input is exhausted the partial tables are merged into the final
+   * table with merge (not combine) semantics, so partial counts sum instead of counting each
+   * partial group as a single row.
+   */
+  void ParallelAggregate() {
+    // The pool may be shared with other operators and queries; the group scopes the wait to
+    // this aggregation's tasks only.
+    TaskGroup group(exec_ctx_->GetThreadPool());
+    size_t num_workers = group.GetPool()->Size();
+    std::vector<CompactAggregationHashTable> partials;
+    partials.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; i++) {
+      partials.emplace_back(plan_->GetGroupBys(), plan_->GetAggregates(), plan_->GetAggregateTypes());
+    }
+    std::vector<std::mutex> latches(num_workers);
+    // One hasher (and scratch) per worker slot, used under that slot's latch.
+    std::vector<BatchHasher> hashers(num_workers);
+
+    size_t batch_no = 0;
+    auto batch = std::make_shared<TupleBatch>();
+    while (child_->NextBatch(batch.get())) {
+      size_t w = batch_no++ % num_workers;
+      std::shared_ptr<TupleBatch> work = std::move(batch);
+      group.Submit([this, work, &partials, &latches, &hashers, w] {
+        std::lock_guard<std::mutex> guard(latches[w]);
+        std::vector<hash_t> hashes;
+        hashers[w].HashBatch(work.get(), child_->GetOutputSchema(), plan_->GetGroupBys(), &hashes);
+        for (size_t i = 0; i < work->Size(); i++) {
+          Tuple *tuple = &work->Get(i);
+          partials[w].InsertCombineHashed(hashes[i], MakeKey(tuple), MakeVal(tuple));
+        }
+      });
+      batch = std::make_shared<TupleBatch>();
+    }
+    group.Wait();
+
+    for (auto &partial : partials) {
+      for (auto it = partial.Begin(); it != partial.End(); ++it) {
+        aht_.InsertMerge(it.Key(), it.Val());
+        MaybeSpill();
+      }
+    }
+  }
+
+  /** Spills the table to temp space and restarts it empty once it exceeds the context's group
+   * budget, or once the process-wide memory budget stops covering its estimated footprint. */
+  void MaybeSpill() {
+    // Groups hold one Value per key and aggregate column plus table overhead; an estimate is
+    // enough here, the tracker meters pressure rather than exact footprints.
+    size_t bytes_per_group =
+        (plan_->GetGroupBys().size() + plan_->GetAggregates().size()) * sizeof(Value) + GROUP_OVERHEAD_BYTES;
+    if (aht_.Size() <= exec_ctx_->GetAggregationGroupBudget() &&
+        reservation_.Reserve(aht_.Size() * bytes_per_group)) {
+      return;
+    }
+    SpillTable();
+    aht_.Clear();
+    reservation_.Release();
+  }
+
+  /** @return the value-based hash of a group key; stable across spill passes so every
+   * occurrence of a key lands in the same partition */
+  static hash_t HashAggKey(const AggregateKey &key) {
+    hash_t h = 0;
+    for (const Value &val : key.group_bys_) {
+      if (!val.IsNull()) {
+        h = HashUtil::CombineHashes(h, HashUtil::HashValue(&val));
+      }
+    }
+    return h;
+  }
+
+  /**
+   * @return the schema spilled (key, partial aggregate) rows are serialized under: the
+   * group-by columns in plan order followed by one INTEGER column per aggregate (every
+   * aggregate kind here accumulates an integer). Built on first spill and owned by the
+   * executor; the declared varchar length is nominal, tuples store their actual bytes.
+   */
+  const Schema *SpillSchema() {
+    if (spill_schema_ == nullptr) {
+      std::vector<Column> columns;
+      for (const auto *expr : plan_->GetGroupBys()) {
+        if (expr->GetReturnType() == TypeId::VARCHAR) {
+          columns.emplace_back("group", TypeId::VARCHAR, PAGE_SIZE / 2);
+        } else {
+          columns.emplace_back("group", expr->GetReturnType());
+        }
+      }
+      for (size_t i = 0; i < plan_->GetAggregates().size(); i++) {
+        columns.emplace_back("agg", TypeId::INTEGER);
+      }
+      spill_schema_ = std::make_unique<Schema>(columns);
+    }
+    return spill_schema_.get();
+  }
+
+  /** Writes every resident group into its partition's spill chain as one serialized row. */
+  void SpillTable() {
+    spilled_ = true;
+    const Schema *schema = SpillSchema();
+    auto *tmp = exec_ctx_->GetTempSpace();
+    for (auto it = aht_.Begin(); it != aht_.End(); ++it) {
+      const AggregateKey &key = it.Key();
+      const AggregateValue &val = it.Val();
+      std::vector<Value> values;
+      values.reserve(schema->GetColumnCount());
+      values.insert(values.end(), key.group_bys_.begin(), key.group_bys_.end());
+      values.insert(values.end(), val.aggregates_.begin(), val.aggregates_.end());
+      Tuple row(values, schema);
+      uint32_t p = static_cast<uint32_t>(HashAggKey(key) % NUM_SPILL_PARTITIONS);
+      TmpTuple slot(INVALID_PAGE_ID, 0);
+      if (spill_open_[p] != nullptr && spill_open_[p]->Insert(row, &slot)) {
+        continue;
+      }
+      if (spill_open_[p] != nullptr) {
+        tmp->UnpinPage(spill_open_[p]->GetTablePageId(), true);
+      }
+      page_id_t page_id;
+      auto *page = static_cast<TmpTuplePage *>(tmp->NewPage(&page_id));
+      BUSTUB_ASSERT(page != nullptr, "Out of temp space while spilling an aggregation.");
+      page->Init(page_id, PAGE_SIZE);
+      spill_parts_[p].push_back(page_id);
+      spill_open_[p] = page;
+      bool inserted = page->Insert(row, &slot);
+      BUSTUB_ASSERT(inserted, "Group row is too large to fit in an empty TmpTuplePage.");
+    }
+  }
+
+  /** Unpins (dirty) every open spill page; the build is done appending to them. */
+  void CloseSpillPages() {
+    auto *tmp = exec_ctx_->GetTempSpace();
+    for (auto *&page : spill_open_) {
+      if (page != nullptr) {
+        tmp->UnpinPage(page->GetTablePageId(), true);
+        page = nullptr;
+      }
+    }
+  }
+
+  /**
+   * Rebuilds the next non-empty spilled partition in the table, merging each key's partial
+   * aggregates, and frees the partition's pages.
+   * @return false once every partition has been served
+   */
+  bool LoadNextPartition() {
+    const Schema *schema = SpillSchema();
+    size_t num_group_bys = plan_->GetGroupBys().size();
+    auto *tmp = exec_ctx_->GetTempSpace();
+    while (next_partition_ < NUM_SPILL_PARTITIONS) {
+      std::vector<page_id_t> pages = std::move(spill_parts_[next_partition_++]);
+      if (pages.empty()) {
+        continue;
+      }
+      aht_.Clear();
+      for (page_id_t page_id : pages) {
+        auto *page = static_cast<TmpTuplePage *>(tmp->FetchPage(page_id));
+        BUSTUB_ASSERT(page != nullptr, "Failed to fetch a spilled aggregation page.");
+        size_t offset = page->GetFirstTupleOffset();
+        Tuple row;
+        while (page->GetNextTuple(&offset, &row)) {
+          std::vector<Value> keys;
+          keys.reserve(num_group_bys);
+          for (uint32_t i = 0; i < num_group_bys; i++) {
+            keys.push_back(row.GetValue(schema, i));
+          }
+          std::vector<Value> aggs;
+          aggs.reserve(schema->GetColumnCount() - num_group_bys);
+          for (uint32_t i = num_group_bys; i < schema->GetColumnCount(); i++) {
+            aggs.push_back(row.GetValue(schema, i));
+          }
+          aht_.InsertMerge(AggregateKey{std::move(keys)}, AggregateValue{std::move(aggs)});
+        }
+        tmp->UnpinPage(page_id, false);
+        tmp->DeletePage(page_id);
+      }
+      return true;
+    }
+    return false;
+  }
+
   /** The aggregation plan node. */
   const AggregationPlanNode *plan_;
   /** The child executor whose tuples we are aggregating. */
   std::unique_ptr<AbstractExecutor> child_;
-  /** Simple aggregation hash table. */
-  // Uncomment me! SimpleAggregationHashTable aht_;
-  /** Simple aggregation hash table iterator. */
-  // Uncomment me! SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** Aggregation hash table: flat fixed-width keys where possible, generic map otherwise. */
+  CompactAggregationHashTable aht_;
+  /** Aggregation hash table iterator. */
+  CompactAggregationHashTable::Iterator aht_iterator_;
+  /** Column-at-a-time group-by hashing for the serial build, with its per-batch scratch. */
+  BatchHasher batch_hasher_;
+  std::vector<hash_t> batch_hashes_;
+
+  /** The fan-out of the spill partitioning. */
+  static constexpr uint32_t NUM_SPILL_PARTITIONS = 8;
+  /** Estimated per-group table overhead beyond the Values themselves; see MaybeSpill. */
+  static constexpr size_t GROUP_OVERHEAD_BYTES = 64;
+  /** True once any groups were spilled and Next() must serve partition by partition. */
+  bool spilled_{false};
+  /** The spill chains, one per partition. */
+  std::vector<std::vector<page_id_t>> spill_parts_;
+  /** The open (pinned) spill page of each partition during the build. */
+  std::vector<TmpTuplePage *> spill_open_;
+  /** The schema spilled group rows are serialized under; see SpillSchema. */
+  std::unique_ptr<Schema> spill_schema_;
+  /** The next spilled partition Next() will rebuild. */
+  size_t next_partition_{0};
+  /** This aggregation's claim on the process-wide executor memory budget. */
+  MemoryReservation reservation_;
 };
 }  // namespace bustub
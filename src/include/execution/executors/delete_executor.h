@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// delete_executor.h
+//
+// Identification: src/include/execution/executors/delete_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/delete_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * DeleteExecutor executes a delete from a table.
+ * The rows to delete come from the child executor; only their RIDs are used, so the child's
+ * output schema does not matter.
+ *
+ * The child is drained completely first and the RIDs are applied in page order: consecutive
+ * deletes then hit the same resident page, so each table page pays one buffer pool fetch for
+ * its whole group of deletes instead of one per row, and the heap's MarkDelete keeps every
+ * registered index in sync as usual. Draining first also keeps a delete whose child scans the
+ * target table from chasing its own writes.
+ */
+class DeleteExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new delete executor.
+   * @param exec_ctx the executor context
+   * @param plan the delete plan to be executed
+   * @param child_executor the child executor providing the rows to delete
+   */
+  DeleteExecutor(ExecutorContext *exec_ctx, const DeletePlanNode *plan,
+                 std::unique_ptr<AbstractExecutor> &&child_executor)
+      : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child_executor)) {}
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override {
+    table_info_ = exec_ctx_->GetTable(plan_->TableOid());
+    child_->Init();
+    done_ = false;
+  }
+
+  // Note that Delete does not make use of the tuple pointer being passed in.
+  // We return false if any delete failed, and true once every row has been deleted.
+  bool Next([[maybe_unused]] Tuple *tuple) override {
+    if (done_) {
+      return false;
+    }
+    done_ = true;
+    Transaction *txn = exec_ctx_->GetTransaction();
+    std::vector<RID> rids;
+    TupleBatch batch;
+    while (child_->NextBatch(&batch)) {
+      for (auto &t : batch) {
+        rids.push_back(t.GetRid());
+      }
+    }
+    // Page order groups each page's deletes together; see the class comment.
+    std::sort(rids.begin(), rids.end(), [](const RID &lhs, const RID &rhs) {
+      return lhs.GetPageId() != rhs.GetPageId() ? lhs.GetPageId() < rhs.GetPageId()
+                                                : lhs.GetSlotNum() < rhs.GetSlotNum();
+    });
+    for (const auto &rid : rids) {
+      if (!table_info_->table_->MarkDelete(rid, txn)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  /** The delete plan node to be executed. */
+  const DeletePlanNode *plan_;
+  /** The child executor providing the rows to delete. */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** Metadata of the table deleted from. */
+  TableMetadata *table_info_{nullptr};
+  /** True once the delete has run for this Init(). */
+  bool done_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_executor.h
+//
+// Identification: src/include/execution/executors/exchange_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/exchange_plan.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * ExchangeExecutor runs its child as a separate pipeline stage on the shared worker pool. A
+ * producer task drains the child through NextBatch into a bounded queue of batches; the parent
+ * consumes from the queue, so the stage below the exchange fills the next batch while the stage
+ * above processes the current one.
+ *
+ * The producer never blocks holding a pool worker: a production round stops when the queue is
+ * full and the consumer resubmits it when it takes a batch back out. That keeps the producer
+ * safe to run on any worker -- including the consumer's own thread, which helps run pool tasks
+ * while the queue is empty, so an exchange degrades to serial execution instead of deadlocking
+ * when the pool is saturated.
+ */
+class ExchangeExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new exchange executor.
+   * @param exec_ctx the executor context
+   * @param plan the exchange plan to be executed
+   * @param child the child executor producing tuples for the exchange
+   */
+  ExchangeExecutor(ExecutorContext *exec_ctx, const ExchangePlanNode *plan, std::unique_ptr<AbstractExecutor> &&child)
+      : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child)), group_(exec_ctx->GetThreadPool()) {}
+
+  /** Stops the producer before the queue and child it uses are torn down. */
+  ~ExchangeExecutor() override {
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      cancelled_ = true;
+    }
+    group_.Wait();
+  }
+
+  void Init() override {
+    // Park and drain any producer from a previous Init before resetting the child under it.
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      cancelled_ = true;
+    }
+    group_.Wait();
+    child_->Init();
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      ready_batches_.clear();
+      producer_done_ = false;
+      producer_running_ = true;
+      cancelled_ = false;
+    }
+    current_batch_.Clear();
+    current_idx_ = 0;
+    group_.Submit([this] { ProduceRound(); });
+  }
+
+  bool Next(Tuple *tuple) override {
+    while (current_idx_ >= current_batch_.Size()) {
+      if (!PullBatch(&current_batch_)) {
+        return false;
+      }
+      current_idx_ = 0;
+    }
+    *tuple = current_batch_.Get(current_idx_++);
+    return true;
+  }
+
+  bool NextBatch(TupleBatch *batch) override {
+    batch->Clear();
+    // Serve a buffered remainder first so batch and tuple pulls can be mixed.
+    if (current_idx_ < current_batch_.Size()) {
+      for (size_t i = current_idx_; i < current_batch_.Size(); i++) {
+        batch->Add(std::move(current_batch_.Get(i)));
+      }
+      current_batch_.Clear();
+      current_idx_ = 0;
+      return true;
+    }
+    return PullBatch(batch);
+  }
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /** Batches buffered between the stages; bounds the memory an eager producer can pin. */
+  static constexpr size_t MAX_QUEUED_BATCHES = 4;
+
+  /**
+   * One production round: drains the child into the queue until it fills or the child is
+   * exhausted, then returns the worker. Never blocks on the queue -- the consumer restarts the
+   * round when it frees a slot.
+   */
+  void ProduceRound() {
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(latch_);
+        if (cancelled_ || ready_batches_.size() >= MAX_QUEUED_BATCHES) {
+          producer_running_ = false;
+          return;
+        }
+      }
+      TupleBatch batch;
+      if (!child_->NextBatch(&batch)) {
+        std::lock_guard<std::mutex> lock(latch_);
+        producer_done_ = true;
+        producer_running_ = false;
+        return;
+      }
+      std::lock_guard<std::mutex> lock(latch_);
+      ready_batches_.push_back(std::move(batch));
+    }
+  }
+
+  /**
+   * Takes the next batch from the queue, restarting the producer when it parked on a full
+   * queue, and helping run pool tasks while the queue is empty.
+   * @param[out] batch the pulled batch
+   * @return true if a batch was pulled, false once the producer is done and the queue drained
+   */
+  bool PullBatch(TupleBatch *batch) {
+    while (true) {
+      bool pulled = false;
+      bool restart_producer = false;
+      {
+        std::lock_guard<std::mutex> lock(latch_);
+        if (!ready_batches_.empty()) {
+          *batch = std::move(ready_batches_.front());
+          ready_batches_.pop_front();
+          pulled = true;
+        } else if (producer_done_) {
+          return false;
+        }
+        if (!producer_done_ && !producer_running_) {
+          // The producer parked on a full queue (or lost a race); bring it back.
+          producer_running_ = true;
+          restart_producer = true;
+        }
+      }
+      if (restart_producer) {
+        group_.Submit([this] { ProduceRound(); });
+      }
+      if (pulled) {
+        return true;
+      }
+      if (!exec_ctx_->GetThreadPool()->RunPendingTask()) {
+        // Nothing to help with; give the producer a moment to run elsewhere.
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  /** The exchange plan node to be executed. */
+  const ExchangePlanNode *plan_;
+  /** The child executor, driven only by the producer task after Init. */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** The producer's task group, scoping waits to this exchange. */
+  TaskGroup group_;
+  /** Protects the queue and producer state. */
+  std::mutex latch_;
+  /** Batches produced and not yet consumed. */
+  std::deque<TupleBatch> ready_batches_;
+  /** True once the child is exhausted. */
+  bool producer_done_{false};
+  /** True while a production round is queued or running. */
+  bool producer_running_{false};
+  /** True once the consumer is tearing down; parks the producer for good. */
+  bool cancelled_{false};
+  /** The batch Next() is currently serving from. */
+  TupleBatch current_batch_;
+  /** The next tuple of current_batch_ to hand out. */
+  size_t current_idx_{0};
+};
+}  // namespace bustub
@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// fused_join_aggregation_executor.h
+//
+// Identification: src/include/execution/executors/fused_join_aggregation_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/aggregation_executor.h"
+#include "execution/executors/hash_join_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+
+namespace bustub {
+
+/**
+ * FusedJoinAggregationExecutor runs an aggregation that groups on the keys of the hash join
+ * directly below it, without hashing the same values twice. The join's probe already computed
+ * the key hash for every output row; the factory fuses the two operators when the group-by
+ * columns are exactly one side's join keys (see CanFuse), and the aggregation table is then
+ * probed with the join's hash via InsertCombineHashed instead of re-hashing the group columns.
+ * A star-schema rollup -- join a fact table to a dimension, group by the join key -- pays for
+ * its key hashes once.
+ */
+class FusedJoinAggregationExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new fused join-aggregation executor.
+   * @param exec_ctx the executor context
+   * @param plan the aggregation plan node; its child is the join's plan
+   * @param join the hash join executor feeding the aggregation
+   */
+  FusedJoinAggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                               std::unique_ptr<HashJoinExecutor> &&join)
+      : AbstractExecutor(exec_ctx),
+        plan_(plan),
+        join_(std::move(join)),
+        aht_(plan_->GetGroupBys(), plan_->GetAggregates(), plan_->GetAggregateTypes()),
+        aht_iterator_(aht_.Begin()) {}
+
+  /**
+   * Decides whether the aggregation can reuse the join's key hashes. The group-by columns must
+   * be plain column references into the join's output whose source columns are exactly one
+   * side's join keys: then two output rows agree on the group-bys iff they agree on that side's
+   * full key, so the probe hash is a valid hash of the group key.
+   * @param agg_plan the aggregation plan
+   * @param join_plan the hash join plan below it
+   * @return true if the operators can be fused
+   */
+  static bool CanFuse(const AggregationPlanNode *agg_plan, const HashJoinPlanNode *join_plan) {
+    if (agg_plan->GetGroupBys().empty() || agg_plan->IsParallel()) {
+      return false;
+    }
+    // Resolve each group-by to (side, column) through the join's output schema.
+    std::vector<std::pair<uint32_t, uint32_t>> group_cols;
+    for (const auto *group_by : agg_plan->GetGroupBys()) {
+      const auto *col_ref = dynamic_cast<const ColumnValueExpression *>(group_by);
+      if (col_ref == nullptr) {
+        return false;
+      }
+      const auto *src =
+          dynamic_cast<const ColumnValueExpression *>(join_plan->OutputSchema()->GetColumn(col_ref->GetColIdx()).GetExpr());
+      if (src == nullptr) {
+        return false;
+      }
+      group_cols.emplace_back(src->GetTupleIdx(), src->GetColIdx());
+    }
+    // All group-bys must come from the same side, and cover that side's keys exactly: a subset
+    // would map several distinct full keys (distinct hashes) onto one group.
+    uint32_t side = group_cols[0].first;
+    const auto &keys = side == 0 ? join_plan->GetLeftKeys() : join_plan->GetRightKeys();
+    if (group_cols.size() != keys.size()) {
+      return false;
+    }
+    for (const auto *key : keys) {
+      const auto *key_ref = dynamic_cast<const ColumnValueExpression *>(key);
+      if (key_ref == nullptr) {
+        return false;
+      }
+      bool covered = false;
+      for (const auto &group_col : group_cols) {
+        if (group_col.first == side && group_col.second == key_ref->GetColIdx()) {
+          covered = true;
+          break;
+        }
+      }
+      if (!covered) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void Init() override {
+    join_->Init();
+    aht_.Clear();
+    Tuple tuple;
+    while (join_->Next(&tuple)) {
+      // The probe computed this row's key hash; group under it instead of re-hashing.
+      aht_.InsertCombineHashed(join_->LastKeyHash(), MakeKey(&tuple), MakeVal(&tuple));
+    }
+    aht_iterator_ = aht_.Begin();
+  }
+
+  bool Next(Tuple *tuple) override {
+    const AbstractExpression *having = plan_->GetHaving();
+    const Schema *out_schema = GetOutputSchema();
+    while (aht_iterator_ != aht_.End()) {
+      const AggregateKey &key = aht_iterator_.Key();
+      const AggregateValue &val = aht_iterator_.Val();
+      if (having == nullptr || having->EvaluateAggregate(key.group_bys_, val.aggregates_).GetAs<bool>()) {
+        std::vector<Value> values;
+        values.reserve(out_schema->GetColumnCount());
+        for (const auto &col : out_schema->GetColumns()) {
+          values.push_back(col.GetExpr()->EvaluateAggregate(key.group_bys_, val.aggregates_));
+        }
+        *tuple = Tuple(values, out_schema);
+        ++aht_iterator_;
+        return true;
+      }
+      ++aht_iterator_;
+    }
+    return false;
+  }
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /** @return the group-by key of the join output tuple */
+  AggregateKey MakeKey(const Tuple *tuple) {
+    std::vector<Value> keys;
+    for (const auto &expr : plan_->GetGroupBys()) {
+      keys.emplace_back(expr->Evaluate(tuple, join_->GetOutputSchema()));
+    }
+    return {keys};
+  }
+
+  /** @return the aggregate input of the join output tuple */
+  AggregateValue MakeVal(const Tuple *tuple) {
+    std::vector<Value> vals;
+    for (const auto &expr : plan_->GetAggregates()) {
+      vals.emplace_back(expr->Evaluate(tuple, join_->GetOutputSchema()));
+    }
+    return {vals};
+  }
+
+  /** The aggregation plan node. */
+  const AggregationPlanNode *plan_;
+  /** The hash join feeding the aggregation; also the source of the key hashes. */
+  std::unique_ptr<HashJoinExecutor> join_;
+  /** The aggregation hash table, probed with the join's key hashes. */
+  CompactAggregationHashTable aht_;
+  /** The iterator over the aggregation hash table. */
+  CompactAggregationHashTable::Iterator aht_iterator_;
+};
+}  // namespace bustub
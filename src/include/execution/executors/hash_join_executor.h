@@ -12,20 +12,28 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "common/memory_tracker.h"
+#include "common/util/bloom_filter.h"
 #include "common/util/hash_util.h"
 #include "container/hash/hash_function.h"
+#include "execution/batch_hasher.h"
 #include "container/hash/linear_probe_hash_table.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/executors/stats_executor.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/join_output_stager.h"
 #include "execution/plans/hash_join_plan.h"
 #include "storage/index/hash_comparator.h"
+#include "storage/page/tmp_tuple_page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
@@ -59,32 +67,161 @@ class SimpleHashJoinHashTable {
    * @param t the tuple to associate with the key
    * @return true if the insert succeeded
    */
-  bool Insert(Transaction *txn, hash_t h, const Tuple &t) {
-    hash_table_[h].emplace_back(t);
+  bool Insert(Transaction *txn, hash_t h, Tuple t) {
+    hash_table_[h].emplace_back(std::move(t));
     return true;
   }
 
   /**
-   * Gets the values in the hash table that match the given hash key.
+   * Gets the values in the hash table that match the given hash key. The pointers stay valid
+   * until the next Insert().
    * @param txn the transaction that we execute in
    * @param h the hash key
    * @param[out] t the list of tuples that matched the key
    */
-  void GetValue(Transaction *txn, hash_t h, std::vector<Tuple> *t) { *t = hash_table_[h]; }
+  void GetValue(Transaction *txn, hash_t h, std::vector<const Tuple *> *t) {
+    t->clear();
+    for (const Tuple &tuple : hash_table_[h]) {
+      t->push_back(&tuple);
+    }
+  }
 
  private:
   std::unordered_map<hash_t, std::vector<Tuple>> hash_table_;
 };
 
-// TODO(student): when you are ready to attempt task 3, replace the using declaration!
-using HT = SimpleHashJoinHashTable;
+/**
+ * A radix-partitioned open-addressing hash table for joins. Build tuples are buffered by
+ * Insert() and laid out by Build(): a counting sort on the low radix bits of the hash groups
+ * each radix partition's tuples contiguously, and every partition gets its own linear-probing
+ * slot array sized to twice its tuple count. With the build capped at the executor's in-memory
+ * limit, each partition's slots and tuples span a cache-friendly chunk, so probing is an array
+ * scan instead of the pointer chase and per-node allocation of an unordered_multimap.
+ */
+class RadixJoinHashTable {
+ public:
+  /** Creates a new radix-partitioned join hash table. */
+  RadixJoinHashTable(const std::string &name, BufferPoolManager *bpm, HashComparator cmp, uint32_t buckets,
+                     const IdentityHashFunction &hash_fn) {}
 
-// using HashJoinKeyType = ???;
-// using HashJoinValType = ???;
-// using HT = LinearProbeHashTable<HashJoinKeyType, HashJoinValType, HashComparator>;
+  /**
+   * Buffers a (hash key, tuple) pair; the table is not probeable until Build() runs.
+   * @param txn the transaction that we execute in
+   * @param h the hash key
+   * @param t the tuple to associate with the key
+   * @return true if the insert succeeded
+   */
+  bool Insert(Transaction *txn, hash_t h, Tuple t) {
+    hashes_.push_back(h);
+    tuples_.emplace_back(std::move(t));
+    return true;
+  }
+
+  /** Partitions the buffered pairs by hash radix and builds the per-partition slot arrays. */
+  void Build() {
+    // Counting sort on the low radix bits groups each partition's tuples contiguously.
+    std::vector<uint32_t> counts(NUM_RADIX_PARTITIONS, 0);
+    for (hash_t h : hashes_) {
+      counts[RadixOf(h)]++;
+    }
+    partition_begin_.assign(NUM_RADIX_PARTITIONS + 1, 0);
+    for (uint32_t p = 0; p < NUM_RADIX_PARTITIONS; p++) {
+      partition_begin_[p + 1] = partition_begin_[p] + counts[p];
+    }
+    std::vector<uint32_t> cursor(partition_begin_.begin(), partition_begin_.end() - 1);
+    std::vector<hash_t> sorted_hashes(hashes_.size());
+    std::vector<Tuple> sorted_tuples(tuples_.size());
+    for (size_t i = 0; i < hashes_.size(); i++) {
+      uint32_t dst = cursor[RadixOf(hashes_[i])]++;
+      sorted_hashes[dst] = hashes_[i];
+      sorted_tuples[dst] = std::move(tuples_[i]);
+    }
+    hashes_ = std::move(sorted_hashes);
+    tuples_ = std::move(sorted_tuples);
+
+    // One linear-probing slot array per partition, sized to keep the load factor under a half.
+    slots_.assign(NUM_RADIX_PARTITIONS, {});
+    for (uint32_t p = 0; p < NUM_RADIX_PARTITIONS; p++) {
+      uint32_t n = partition_begin_[p + 1] - partition_begin_[p];
+      if (n == 0) {
+        continue;
+      }
+      uint32_t capacity = 1;
+      while (capacity < 2 * n) {
+        capacity <<= 1;
+      }
+      auto &slots = slots_[p];
+      slots.assign(capacity, EMPTY_SLOT);
+      for (uint32_t i = partition_begin_[p]; i < partition_begin_[p + 1]; i++) {
+        uint32_t slot = ProbeStart(hashes_[i], capacity);
+        while (slots[slot] != EMPTY_SLOT) {
+          slot = (slot + 1) & (capacity - 1);
+        }
+        slots[slot] = i;
+      }
+    }
+  }
+
+  /**
+   * Gets the values in the hash table that match the given hash key. Only valid after Build().
+   * The pointers reference the table's own storage, so the caller joins against candidates
+   * in place instead of copying every one out.
+   * @param txn the transaction that we execute in
+   * @param h the hash key
+   * @param[out] t the list of tuples that matched the key
+   */
+  void GetValue(Transaction *txn, hash_t h, std::vector<const Tuple *> *t) {
+    t->clear();
+    const auto &slots = slots_[RadixOf(h)];
+    if (slots.empty()) {
+      return;
+    }
+    uint32_t capacity = static_cast<uint32_t>(slots.size());
+    uint32_t slot = ProbeStart(h, capacity);
+    while (slots[slot] != EMPTY_SLOT) {
+      if (hashes_[slots[slot]] == h) {
+        t->push_back(&tuples_[slots[slot]]);
+      }
+      slot = (slot + 1) & (capacity - 1);
+    }
+  }
+
+ private:
+  /** The number of low hash bits that select a radix partition. */
+  static constexpr uint32_t RADIX_BITS = 6;
+  static constexpr uint32_t NUM_RADIX_PARTITIONS = 1 << RADIX_BITS;
+  /** Marks an unoccupied slot. */
+  static constexpr uint32_t EMPTY_SLOT = static_cast<uint32_t>(-1);
+
+  /** @return the radix partition the hash belongs to */
+  static uint32_t RadixOf(hash_t h) { return static_cast<uint32_t>(h & (NUM_RADIX_PARTITIONS - 1)); }
+
+  /** @return the first slot to probe; skips the radix bits already spent on partitioning */
+  static uint32_t ProbeStart(hash_t h, uint32_t capacity) {
+    return static_cast<uint32_t>((h >> RADIX_BITS) & (capacity - 1));
+  }
+
+  /** Build-side hashes, grouped by radix partition after Build(). */
+  std::vector<hash_t> hashes_;
+  /** Build-side tuples, parallel to hashes_. */
+  std::vector<Tuple> tuples_;
+  /** The first tuple index of each radix partition, plus a trailing end sentinel. */
+  std::vector<uint32_t> partition_begin_;
+  /** Per-partition linear-probing arrays of tuple indexes. */
+  std::vector<std::vector<uint32_t>> slots_;
+};
+
+using HT = RadixJoinHashTable;
 
 /**
- * HashJoinExecutor executes hash join operations.
+ * HashJoinExecutor executes hash join operations as a partitioned (grace) hash join. Init()
+ * drains both children and hash-partitions their tuples into spill chains of TmpTuplePages in
+ * the query's temp space -- not the buffer pool, so a spilling join cannot evict the working
+ * set -- and neither side ever has to fit in memory at once. Next() then joins the
+ * partitions pairwise: the left partition is loaded into an in-memory hash table and the
+ * matching right partition is streamed against it. A left partition that is still too large
+ * to build in memory -- a skewed key range -- is recursively repartitioned with a different
+ * hash seed, up to a depth cap past which it is joined in memory regardless.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -97,16 +234,74 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan, std::unique_ptr<AbstractExecutor> &&left,
                    std::unique_ptr<AbstractExecutor> &&right)
-      : AbstractExecutor(exec_ctx) {}
-
-  /** @return the JHT in use. Do not modify this function, otherwise you will get a zero. */
-  // Uncomment me! const HT *GetJHT() const { return &jht_; }
+      : AbstractExecutor(exec_ctx),
+        plan_(plan),
+        left_(std::move(left)),
+        right_(std::move(right)),
+        build_reservation_(exec_ctx->GetMemoryTracker()) {}
 
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
-  void Init() override {}
+  void Init() override {
+    left_->Init();
+    right_->Init();
+    pending_.clear();
+    output_buffer_.clear();
+    output_hashes_.clear();
+    output_idx_ = 0;
+    // A pure-projection output schema -- the common join shape -- stages its rows by copying
+    // column bytes out of the matched pair instead of evaluating an expression per column.
+    if (output_stager_ == nullptr) {
+      output_stager_ = std::make_unique<JoinOutputStager>(GetOutputSchema(), left_->GetOutputSchema(),
+                                                          right_->GetOutputSchema());
+    }
 
-  bool Next(Tuple *tuple) override { return false; }
+    // Depth-0 partitioning: spill both children into matching partitions. The build pass also
+    // fills a Bloom filter over the left key hashes, which is pushed into a probe-side scan so
+    // tuples that cannot match any build key are discarded inside the page, pre-materialization.
+    std::vector<std::vector<page_id_t>> left_parts(NUM_PARTITIONS);
+    std::vector<std::vector<page_id_t>> right_parts(NUM_PARTITIONS);
+    std::vector<size_t> left_counts(NUM_PARTITIONS, 0);
+    std::vector<size_t> left_bytes(NUM_PARTITIONS, 0);
+    left_key_filter_ = BloomFilter();
+    PartitionChild(left_.get(), left_->GetOutputSchema(), plan_->GetLeftKeys(), 0, &left_parts, &left_counts,
+                   &left_bytes, &left_key_filter_);
+    auto *probe_scan = dynamic_cast<SeqScanExecutor *>(StatsExecutor::Unwrap(right_.get()));
+    if (probe_scan != nullptr) {
+      probe_scan->SetKeyFilter(&left_key_filter_, plan_->GetRightKeys());
+    }
+    PartitionChild(right_.get(), right_->GetOutputSchema(), plan_->GetRightKeys(), 0, &right_parts, nullptr, nullptr,
+                   nullptr);
+    for (uint32_t i = 0; i < NUM_PARTITIONS; i++) {
+      pending_.push_back(
+          PartitionPair{std::move(left_parts[i]), std::move(right_parts[i]), left_counts[i], left_bytes[i], 0});
+    }
+  }
+
+  bool Next(Tuple *tuple) override {
+    while (output_idx_ >= output_buffer_.size()) {
+      if (pending_.empty()) {
+        return false;
+      }
+      output_buffer_.clear();
+      output_hashes_.clear();
+      output_idx_ = 0;
+      PartitionPair pair = std::move(pending_.front());
+      pending_.pop_front();
+      JoinPartition(&pair);
+    }
+    *tuple = output_buffer_[output_idx_];
+    last_key_hash_ = output_hashes_[output_idx_];
+    output_idx_++;
+    return true;
+  }
+
+  /**
+   * @return the join-key hash of the tuple last returned by Next(). The probe already computed
+   * it, so a parent that groups on the join keys (see FusedJoinAggregationExecutor) can reuse
+   * it instead of re-hashing the same values.
+   */
+  hash_t LastKeyHash() const { return last_key_hash_; }
 
   /**
    * Hashes a tuple by evaluating it against every expression on the given schema, combining all non-null hashes.
@@ -131,16 +326,232 @@ class HashJoinExecutor : public AbstractExecutor {
   }
 
  private:
+  /** The fan-out of each partitioning pass. */
+  static constexpr uint32_t NUM_PARTITIONS = 8;
+  /** The most left tuples a partition may hold before it is repartitioned instead of built. */
+  static constexpr size_t BUILD_LIMIT = 1 << 16;
+  /** The depth past which a skewed partition is built in memory rather than split again. */
+  static constexpr uint32_t MAX_PARTITION_DEPTH = 4;
+
+  /** A matched pair of spilled partitions awaiting their build/probe pass. */
+  struct PartitionPair {
+    /** The pages holding the build-side tuples of this partition. */
+    std::vector<page_id_t> left_pages_;
+    /** The pages holding the probe-side tuples of this partition. */
+    std::vector<page_id_t> right_pages_;
+    /** The number of build-side tuples, used to decide whether to repartition. */
+    size_t left_tuples_;
+    /** The build-side tuples' total bytes, reserved against the memory budget before a build. */
+    size_t left_bytes_;
+    /** How many partitioning passes produced this pair. */
+    uint32_t depth_;
+  };
+
+  /** @return the partition a hash falls into at the given depth; each depth reshuffles the keys */
+  static uint32_t PartitionOf(hash_t h, uint32_t depth) {
+    return static_cast<uint32_t>(HashUtil::CombineHashes(h, depth) % NUM_PARTITIONS);
+  }
+
+  /** Appends a tuple to a partition's spill chain, growing the chain when the open page fills. */
+  void SpillTuple(const Tuple &tuple, std::vector<page_id_t> *pages, TmpTuplePage **open_page) {
+    TmpTuple slot(INVALID_PAGE_ID, 0);
+    if (*open_page != nullptr && (*open_page)->Insert(tuple, &slot)) {
+      return;
+    }
+    auto *tmp = exec_ctx_->GetTempSpace();
+    if (*open_page != nullptr) {
+      tmp->UnpinPage((*open_page)->GetTablePageId(), true);
+    }
+    page_id_t page_id;
+    auto *page = static_cast<TmpTuplePage *>(tmp->NewPage(&page_id));
+    BUSTUB_ASSERT(page != nullptr, "Out of temp space while spilling a join partition.");
+    page->Init(page_id, PAGE_SIZE);
+    pages->push_back(page_id);
+    *open_page = page;
+    bool inserted = page->Insert(tuple, &slot);
+    BUSTUB_ASSERT(inserted, "Tuple is too large to fit in an empty TmpTuplePage.");
+  }
+
+  /** Drains a child executor into per-partition spill chains at the given depth, optionally
+   * recording every key hash in a Bloom filter for probe-side pushdown. The child is drained
+   * a batch at a time and each batch's key hashes are computed by the column-at-a-time kernel;
+   * hashing both inputs is the bulk of this pass on wide fan-ins. */
+  void PartitionChild(AbstractExecutor *child, const Schema *schema, const std::vector<const AbstractExpression *> &keys,
+                      uint32_t depth, std::vector<std::vector<page_id_t>> *parts, std::vector<size_t> *counts,
+                      std::vector<size_t> *bytes, BloomFilter *bloom) {
+    std::vector<TmpTuplePage *> open_pages(NUM_PARTITIONS, nullptr);
+    TupleBatch batch;
+    while (child->NextBatch(&batch)) {
+      batch_hasher_.HashBatch(&batch, schema, keys, &batch_hashes_);
+      for (size_t i = 0; i < batch.Size(); i++) {
+        hash_t h = batch_hashes_[i];
+        if (bloom != nullptr) {
+          bloom->Insert(h);
+        }
+        uint32_t p = PartitionOf(h, depth);
+        SpillTuple(batch.Get(i), &(*parts)[p], &open_pages[p]);
+        if (counts != nullptr) {
+          (*counts)[p]++;
+        }
+        if (bytes != nullptr) {
+          (*bytes)[p] += batch.Get(i).GetLength();
+        }
+      }
+    }
+    CloseOpenPages(&open_pages);
+  }
+
+  /** Unpins (dirty) every open spill page after a partitioning pass. */
+  void CloseOpenPages(std::vector<TmpTuplePage *> *open_pages) {
+    auto *tmp = exec_ctx_->GetTempSpace();
+    for (auto *&page : *open_pages) {
+      if (page != nullptr) {
+        tmp->UnpinPage(page->GetTablePageId(), true);
+        page = nullptr;
+      }
+    }
+  }
+
+  /** Invokes fn on every tuple stored in the given spill chain. fn may take the tuple by
+   * mutable reference and move its buffer out; the next read re-allocates it regardless. */
+  template <typename F>
+  void ForEachSpilled(const std::vector<page_id_t> &pages, const F &fn) {
+    auto *tmp = exec_ctx_->GetTempSpace();
+    for (page_id_t page_id : pages) {
+      auto *page = static_cast<TmpTuplePage *>(tmp->FetchPage(page_id));
+      BUSTUB_ASSERT(page != nullptr, "Failed to fetch a spilled join partition page.");
+      size_t offset = page->GetFirstTupleOffset();
+      Tuple tuple;
+      while (page->GetNextTuple(&offset, &tuple)) {
+        fn(tuple);
+      }
+      tmp->UnpinPage(page_id, false);
+    }
+  }
+
+  /** Deletes every page of a spill chain once its partition has been joined. */
+  void FreePages(const std::vector<page_id_t> &pages) {
+    auto *tmp = exec_ctx_->GetTempSpace();
+    for (page_id_t page_id : pages) {
+      tmp->DeletePage(page_id);
+    }
+  }
+
+  /**
+   * Joins one partition pair into output_buffer_, or -- if the build side is too large and the
+   * depth cap allows -- repartitions it with the next depth's hash seed and queues the sub-pairs.
+   */
+  void JoinPartition(PartitionPair *pair) {
+    // A build that is over the tuple cap -- or that the process-wide memory budget cannot
+    // cover right now -- is split further instead of built, until the depth cap.
+    bool fits_memory = build_reservation_.Reserve(pair->left_bytes_);
+    if ((pair->left_tuples_ > BUILD_LIMIT || !fits_memory) && pair->depth_ < MAX_PARTITION_DEPTH) {
+      build_reservation_.Release();
+      Repartition(pair);
+      return;
+    }
+    Transaction *txn = exec_ctx_->GetTransaction();
+    const Schema *left_schema = left_->GetOutputSchema();
+    const Schema *right_schema = right_->GetOutputSchema();
+    const AbstractExpression *predicate = plan_->Predicate();
+    const Schema *out_schema = GetOutputSchema();
+
+    HT table{"grace hash join partition", exec_ctx_->GetBufferPoolManager(), jht_comp_, jht_num_buckets_,
+             jht_hash_fn_};
+    ForEachSpilled(pair->left_pages_, [&](Tuple &tuple) {
+      // Hash before the move: argument evaluation order is unspecified.
+      hash_t h = HashValues(&tuple, left_schema, plan_->GetLeftKeys());
+      table.Insert(txn, h, std::move(tuple));
+    });
+    table.Build();
+    std::vector<const Tuple *> candidates;
+    ForEachSpilled(pair->right_pages_, [&](const Tuple &right_tuple) {
+      hash_t probe_hash = HashValues(&right_tuple, right_schema, plan_->GetRightKeys());
+      table.GetValue(txn, probe_hash, &candidates);
+      for (const Tuple *left_tuple : candidates) {
+        if (predicate != nullptr &&
+            !predicate->EvaluateJoin(left_tuple, left_schema, &right_tuple, right_schema).GetAs<bool>()) {
+          continue;
+        }
+        if (output_stager_->Viable()) {
+          output_buffer_.push_back(output_stager_->Stage(*left_tuple, right_tuple));
+        } else {
+          std::vector<Value> values;
+          values.reserve(out_schema->GetColumnCount());
+          for (const auto &col : out_schema->GetColumns()) {
+            values.push_back(col.GetExpr()->EvaluateJoin(left_tuple, left_schema, &right_tuple, right_schema));
+          }
+          output_buffer_.emplace_back(std::move(values), out_schema);
+        }
+        output_hashes_.push_back(probe_hash);
+      }
+    });
+    FreePages(pair->left_pages_);
+    FreePages(pair->right_pages_);
+    // The partition's table dies with this frame; hand its claim back.
+    build_reservation_.Release();
+  }
+
+  /** Splits a skewed partition pair into NUM_PARTITIONS sub-pairs at the next depth. */
+  void Repartition(PartitionPair *pair) {
+    uint32_t depth = pair->depth_ + 1;
+    std::vector<std::vector<page_id_t>> left_parts(NUM_PARTITIONS);
+    std::vector<std::vector<page_id_t>> right_parts(NUM_PARTITIONS);
+    std::vector<size_t> left_counts(NUM_PARTITIONS, 0);
+    std::vector<size_t> left_bytes(NUM_PARTITIONS, 0);
+    {
+      std::vector<TmpTuplePage *> open_pages(NUM_PARTITIONS, nullptr);
+      ForEachSpilled(pair->left_pages_, [&](const Tuple &tuple) {
+        uint32_t p = PartitionOf(HashValues(&tuple, left_->GetOutputSchema(), plan_->GetLeftKeys()), depth);
+        SpillTuple(tuple, &left_parts[p], &open_pages[p]);
+        left_counts[p]++;
+        left_bytes[p] += tuple.GetLength();
+      });
+      CloseOpenPages(&open_pages);
+      ForEachSpilled(pair->right_pages_, [&](const Tuple &tuple) {
+        uint32_t p = PartitionOf(HashValues(&tuple, right_->GetOutputSchema(), plan_->GetRightKeys()), depth);
+        SpillTuple(tuple, &right_parts[p], &open_pages[p]);
+      });
+      CloseOpenPages(&open_pages);
+    }
+    FreePages(pair->left_pages_);
+    FreePages(pair->right_pages_);
+    for (uint32_t i = 0; i < NUM_PARTITIONS; i++) {
+      pending_.push_back(
+          PartitionPair{std::move(left_parts[i]), std::move(right_parts[i]), left_counts[i], left_bytes[i], depth});
+    }
+  }
+
   /** The hash join plan node. */
   const HashJoinPlanNode *plan_;
+  /** The build-side child executor. */
+  std::unique_ptr<AbstractExecutor> left_;
+  /** The probe-side child executor. */
+  std::unique_ptr<AbstractExecutor> right_;
+  /** Partition pairs that still have to be joined (or repartitioned). */
+  std::deque<PartitionPair> pending_;
+  /** Bloom filter over the build side's key hashes, pushed into a probe-side scan. */
+  BloomFilter left_key_filter_;
+  /** Byte-copy plan for a pure-projection output schema; falls back when not Viable(). */
+  std::unique_ptr<JoinOutputStager> output_stager_;
+  /** The joined tuples of the partition most recently processed. */
+  std::vector<Tuple> output_buffer_;
+  /** The probe-key hash of each output_buffer_ tuple, for reuse by a fused parent. */
+  std::vector<hash_t> output_hashes_;
+  /** The next tuple of output_buffer_ to hand out. */
+  size_t output_idx_{0};
+  /** The key hash of the tuple last handed out by Next(). */
+  hash_t last_key_hash_{0};
+  /** Column-at-a-time key hashing for the partitioning passes, with its per-batch scratch. */
+  BatchHasher batch_hasher_;
+  std::vector<hash_t> batch_hashes_;
+  /** The current build table's claim on the process-wide executor memory budget. */
+  MemoryReservation build_reservation_;
   /** The comparator is used to compare hashes. */
   [[maybe_unused]] HashComparator jht_comp_{};
   /** The identity hash function. */
   IdentityHashFunction jht_hash_fn_{};
-
-  /** The hash table that we are using. */
-  // Uncomment me! HT jht_;
-  /** The number of buckets in the hash table. */
+  /** The number of buckets in the per-partition hash table. */
   static constexpr uint32_t jht_num_buckets_ = 2;
 };
 }  // namespace bustub
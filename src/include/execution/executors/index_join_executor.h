@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_join_executor.h
+//
+// Identification: src/include/execution/executors/index_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/index_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * IndexJoinExecutor executes an index nested-loop join. For each outer tuple it forms an index
+ * key from the plan's outer key expressions, probes the inner table's index with ScanKey, and
+ * fetches only the matching inner tuples by RID -- the inner table is never scanned and no hash
+ * table is built, which is the right trade when the outer side is small and the inner is large.
+ * Matches are filtered through the join predicate (the index matches on key equality; the
+ * predicate can add more) and laid out in the plan's output schema.
+ */
+class IndexJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new index join executor.
+   * @param exec_ctx the context that the join should be performed in
+   * @param plan the index join plan node
+   * @param outer the outer child executor, probed once per tuple against the index
+   */
+  IndexJoinExecutor(ExecutorContext *exec_ctx, const IndexJoinPlanNode *plan,
+                    std::unique_ptr<AbstractExecutor> &&outer)
+      : AbstractExecutor(exec_ctx), plan_(plan), outer_(std::move(outer)) {}
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override {
+    outer_->Init();
+    inner_table_ = exec_ctx_->GetTable(plan_->GetInnerTableOid());
+    matches_.clear();
+    match_idx_ = 0;
+  }
+
+  bool Next(Tuple *tuple) override {
+    Transaction *txn = exec_ctx_->GetTransaction();
+    const Schema *outer_schema = outer_->GetOutputSchema();
+    const Schema *inner_schema = &inner_table_->schema_;
+    const AbstractExpression *predicate = plan_->Predicate();
+    while (true) {
+      // Drain the matches of the current outer tuple first. The inner tuple is read as an
+      // in-page view; only a join survivor is ever materialized into an owned tuple.
+      while (match_idx_ < matches_.size()) {
+        RID rid = matches_[match_idx_++];
+        bool produced = false;
+        inner_table_->table_->GetTupleView(rid, txn, [&](const Tuple &inner_tuple) {
+          if (predicate != nullptr &&
+              !predicate->EvaluateJoin(&outer_tuple_, outer_schema, &inner_tuple, inner_schema).GetAs<bool>()) {
+            return;
+          }
+          const Schema *out_schema = GetOutputSchema();
+          std::vector<Value> values;
+          values.reserve(out_schema->GetColumnCount());
+          for (const auto &col : out_schema->GetColumns()) {
+            values.push_back(col.GetExpr()->EvaluateJoin(&outer_tuple_, outer_schema, &inner_tuple, inner_schema));
+          }
+          *tuple = Tuple(values, out_schema);
+          produced = true;
+        });
+        if (produced) {
+          return true;
+        }
+      }
+      // Advance to the next outer tuple and probe the index with its key.
+      if (!outer_->Next(&outer_tuple_)) {
+        return false;
+      }
+      std::vector<Value> key_values;
+      key_values.reserve(plan_->GetOuterKeys().size());
+      for (const auto *key : plan_->GetOuterKeys()) {
+        key_values.push_back(key->Evaluate(&outer_tuple_, outer_schema));
+      }
+      Tuple key(key_values, plan_->GetIndex()->GetKeySchema());
+      matches_.clear();
+      match_idx_ = 0;
+      plan_->GetIndex()->ScanKey(key, &matches_, txn);
+    }
+  }
+
+ private:
+  /** The index join plan node. */
+  const IndexJoinPlanNode *plan_;
+  /** The outer child executor. */
+  std::unique_ptr<AbstractExecutor> outer_;
+  /** Metadata of the inner table. */
+  TableMetadata *inner_table_{nullptr};
+  /** The current outer tuple, joined against each of its index matches. */
+  Tuple outer_tuple_;
+  /** The RIDs the index returned for the current outer tuple. */
+  std::vector<RID> matches_;
+  /** The next RID of matches_ to fetch. */
+  size_t match_idx_{0};
+};
+}  // namespace bustub
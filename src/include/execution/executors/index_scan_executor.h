@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_scan_executor.h
+//
+// Identification: src/include/execution/executors/index_scan_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/expression_compiler.h"
+#include "execution/plans/index_scan_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * IndexScanExecutor fetches a table's tuples through an index probe. Init() evaluates the
+ * plan's key expressions once and resolves them with a single ScanKey call -- or a single
+ * ScanRange call for a range scan plan; Next() then fetches the matching tuples by RID and
+ * filters them through the residual predicate. A query whose equality columns are covered by
+ * the index therefore costs one probe plus one fetch per match, instead of a scan of the whole
+ * table.
+ */
+class IndexScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new index scan executor.
+   * @param exec_ctx the executor context
+   * @param plan the index scan plan to be executed
+   */
+  IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
+      : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+  void Init() override {
+    table_info_ = exec_ctx_->GetTable(plan_->GetTableOid());
+    matches_.clear();
+    match_idx_ = 0;
+    // The residual predicate runs interpreted per match; screening its rows on the validity
+    // bitmap first settles null inputs without materializing operand Values.
+    null_screen_ = ExpressionCompiler::CompileNullScreen(plan_->GetPredicate(), &table_info_->schema_);
+    // The keys are constant for the scan: evaluate them once and probe once.
+    if (plan_->IsRangeScan()) {
+      Tuple low = EvaluateKey(plan_->GetLowKeys());
+      Tuple high = EvaluateKey(plan_->GetHighKeys());
+      plan_->GetIndex()->ScanRange(low, high, &matches_, exec_ctx_->GetTransaction());
+    } else {
+      Tuple key = EvaluateKey(plan_->GetKeys());
+      plan_->GetIndex()->ScanKey(key, &matches_, exec_ctx_->GetTransaction());
+    }
+  }
+
+  bool Next(Tuple *tuple) override {
+    Transaction *txn = exec_ctx_->GetTransaction();
+    const Schema *schema = &table_info_->schema_;
+    const AbstractExpression *predicate = plan_->GetPredicate();
+    while (match_idx_ < matches_.size()) {
+      RID rid = matches_[match_idx_++];
+      // Evaluate the residual predicate and the projection against the in-page view; only a
+      // survivor is ever materialized into an owned tuple.
+      bool produced = false;
+      table_info_->table_->GetTupleView(rid, txn, [&](const Tuple &raw_tuple) {
+        if (predicate != nullptr) {
+          if (null_screen_ && null_screen_(raw_tuple)) {
+            return;
+          }
+          if (!predicate->Evaluate(&raw_tuple, schema).GetAs<bool>()) {
+            return;
+          }
+        }
+        const Schema *out_schema = GetOutputSchema();
+        std::vector<Value> values;
+        values.reserve(out_schema->GetColumnCount());
+        for (const auto &col : out_schema->GetColumns()) {
+          values.push_back(col.GetExpr()->Evaluate(&raw_tuple, schema));
+        }
+        *tuple = Tuple(values, out_schema);
+        produced = true;
+      });
+      if (produced) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /** Evaluates a set of constant key expressions into a tuple over the index key schema. */
+  Tuple EvaluateKey(const std::vector<const AbstractExpression *> &keys) {
+    std::vector<Value> key_values;
+    key_values.reserve(keys.size());
+    for (const auto *key : keys) {
+      key_values.push_back(key->Evaluate(nullptr, nullptr));
+    }
+    return Tuple(key_values, plan_->GetIndex()->GetKeySchema());
+  }
+
+  /** The index scan plan node to be executed. */
+  const IndexScanPlanNode *plan_;
+  /** Metadata of the scanned table. */
+  TableMetadata *table_info_{nullptr};
+  /** The RIDs the index probe returned. */
+  std::vector<RID> matches_;
+  /** Validity pre-screen for the residual predicate, or empty (see CompileNullScreen). */
+  ExpressionCompiler::NullScreen null_screen_;
+  /** The next RID of matches_ to fetch. */
+  size_t match_idx_{0};
+};
+}  // namespace bustub
@@ -14,16 +14,25 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/insert_plan.h"
+#include "storage/table/row_serializer.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 /**
  * InsertExecutor executes an insert into a table.
  * Inserted values can either be embedded in the plan itself ("raw insert") or come from a child executor.
+ *
+ * Either way the rows reach the table through TableHeap::InsertTuples, which keeps the tail page
+ * pinned and write-latched across the whole batch: a raw insert goes down in one batch, and a
+ * child plan is drained through NextBatch and inserted a batch at a time. The per-row buffer pool
+ * fetch and latch round trip of repeated InsertTuple calls is what bulk loads spend most of their
+ * time on otherwise.
  */
 class InsertExecutor : public AbstractExecutor {
  public:
@@ -35,18 +44,94 @@ class InsertExecutor : public AbstractExecutor {
    */
   InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
                  std::unique_ptr<AbstractExecutor> &&child_executor)
-      : AbstractExecutor(exec_ctx) {}
+      : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child_executor)) {}
 
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
-  void Init() override {}
+  void Init() override {
+    table_info_ = exec_ctx_->GetTable(plan_->TableOid());
+    // Rows are laid out against the storage schema; compiling its offsets and widths once here
+    // keeps the per-row serialization pass straight-line.
+    row_serializer_ = std::make_unique<RowSerializer>(&table_info_->schema_);
+    if (child_ != nullptr) {
+      child_->Init();
+    }
+    done_ = false;
+  }
 
   // Note that Insert does not make use of the tuple pointer being passed in.
   // We return false if the insert failed for any reason, and return true if all inserts succeeded.
-  bool Next([[maybe_unused]] Tuple *tuple) override { return false; }
+  bool Next([[maybe_unused]] Tuple *tuple) override {
+    if (done_) {
+      return false;
+    }
+    done_ = true;
+    Transaction *txn = exec_ctx_->GetTransaction();
+    std::vector<RID> rids;
+    bool dict = !table_info_->dictionaries_.empty();
+    if (plan_->IsRawInsert()) {
+      // Materialize the embedded values once and hand the table one batch. A dictionary table
+      // stores codes for its encoded columns, so those values are interned on the way in.
+      std::vector<Tuple> tuples;
+      tuples.reserve(plan_->RawValues().size());
+      for (const auto &values : plan_->RawValues()) {
+        if (dict) {
+          tuples.push_back(row_serializer_->MakeTuple(EncodeDictionaryColumns(values)));
+        } else {
+          tuples.push_back(row_serializer_->MakeTuple(values));
+        }
+      }
+      return table_info_->table_->InsertTuples(tuples, &rids, txn);
+    }
+    TupleBatch batch;
+    while (child_->NextBatch(&batch)) {
+      std::vector<Tuple> tuples;
+      tuples.reserve(batch.Size());
+      for (auto &t : batch) {
+        if (dict) {
+          // A child hands out rows against the declared schema; re-lay them out with codes.
+          const Schema *logical_schema = &table_info_->logical_schema_;
+          std::vector<Value> values;
+          values.reserve(logical_schema->GetColumnCount());
+          for (uint32_t i = 0; i < logical_schema->GetColumnCount(); i++) {
+            values.push_back(t.GetValue(logical_schema, i));
+          }
+          tuples.push_back(row_serializer_->MakeTuple(EncodeDictionaryColumns(values)));
+        } else {
+          tuples.push_back(std::move(t));
+        }
+      }
+      if (!table_info_->table_->InsertTuples(tuples, &rids, txn)) {
+        return false;
+      }
+    }
+    return true;
+  }
 
  private:
+  /** Swaps each dictionary column's string for its code, interning new strings as they appear. */
+  std::vector<Value> EncodeDictionaryColumns(const std::vector<Value> &values) {
+    std::vector<Value> encoded = values;
+    for (const auto &[col_idx, dict] : table_info_->dictionaries_) {
+      const Value &val = values[col_idx];
+      if (val.IsNull()) {
+        encoded[col_idx] = ValueFactory::GetNullValueByType(TypeId::INTEGER);
+      } else {
+        encoded[col_idx] = ValueFactory::GetIntegerValue(dict->GetOrInsertCode(val.ToString()));
+      }
+    }
+    return encoded;
+  }
+
   /** The insert plan node to be executed. */
   const InsertPlanNode *plan_;
+  /** The child executor providing tuples to insert, or nullptr for a raw insert. */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** Metadata of the table inserted into. */
+  TableMetadata *table_info_{nullptr};
+  /** Row serializer compiled from the table's storage schema, rebuilt per Init(). */
+  std::unique_ptr<RowSerializer> row_serializer_;
+  /** True once the insert has run for this Init(). */
+  bool done_{false};
 };
 }  // namespace bustub
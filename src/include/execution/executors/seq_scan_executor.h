@@ -12,17 +12,44 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
 #include <vector>
 
+#include "common/util/bloom_filter.h"
+#include "common/util/hash_util.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expression_compiler.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/simd_filter.h"
+#include "storage/page/pax_table_page.h"
+#include "storage/page/table_page.h"
+#include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 /**
- * SeqScanExecutor executes a sequential scan over a table.
+ * SeqScanExecutor executes a sequential scan over a table. The plan's predicate is evaluated
+ * against the tuple bytes inside the pinned table page through a non-owning view, so rows that
+ * fail the filter are never materialized; only survivors are copied out of the page. Pages ahead
+ * of the scan cursor are handed to the buffer pool's prefetch worker, so their disk reads overlap
+ * with filtering the current page instead of stalling the query thread on every miss.
+ *
+ * When the plan requests a parallel scan, the table's page chain is split into fixed-size morsels
+ * and the context's shared thread pool scans them concurrently: each worker repeatedly claims the
+ * next unclaimed morsel, filters and materializes its pages into a worker-local buffer, and merges
+ * the buffer into the shared result set once. Claiming by atomic counter keeps the workers load
+ * balanced -- a worker that draws a sparse morsel simply claims another. The output order is
+ * unspecified in this mode.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -31,16 +58,933 @@ class SeqScanExecutor : public AbstractExecutor {
    * @param exec_ctx the executor context
    * @param plan the sequential scan plan to be executed
    */
-  SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
+  SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx), plan_(plan) {}
 
-  void Init() override {}
+  ~SeqScanExecutor() override { LeaveSharedScanIfJoined(); }
 
-  bool Next(Tuple *tuple) override { return false; }
+  void Init() override {
+    LeaveSharedScanIfJoined();
+    table_info_ = exec_ctx_->GetTable(plan_->GetTableOid());
+    cur_page_id_ = table_info_->table_->GetFirstPageId();
+    cur_slot_ = 0;
+    results_.clear();
+    result_idx_ = 0;
+    scanned_ = false;
+    // Serial scans cooperate through the heap's shared-scan group: one that starts while
+    // another is sweeping the same chain attaches at the published position, rides the same
+    // page fetches, and wraps around to cover the pages before its attach point -- so
+    // concurrent full scans of a big table read each page from disk roughly once between
+    // them. An uncontended scan leads a fresh sweep and behaves exactly as before.
+    shared_start_ = INVALID_PAGE_ID;
+    wrapped_ = false;
+    if (!plan_->IsParallel()) {
+      shared_heap_ = table_info_->table_.get();
+      page_id_t attach = shared_heap_->JoinSharedScan();
+      if (attach != INVALID_PAGE_ID) {
+        shared_start_ = attach;
+        cur_page_id_ = attach;
+      }
+      shared_heap_->PublishScanPosition(cur_page_id_);
+    }
+    // Projection pushdown: when every output column is a plain column reference, survivors are
+    // assembled from just those columns' bytes while still in the page, and the full row is
+    // never copied -- a narrow projection of a wide table skips the dead weight entirely.
+    direct_project_ = true;
+    projected_cols_.clear();
+    for (const auto &col : GetOutputSchema()->GetColumns()) {
+      const auto *col_ref = dynamic_cast<const ColumnValueExpression *>(col.GetExpr());
+      if (col_ref == nullptr) {
+        direct_project_ = false;
+        projected_cols_.clear();
+        break;
+      }
+      projected_cols_.push_back(col_ref->GetColIdx());
+    }
+    pax_ = table_info_->table_->GetLayout() == TableLayout::PAX;
+    // Dictionary tables store codes where the plan expects strings: equality against a string
+    // constant rewrites to a code comparison, anything else touching an encoded column filters
+    // on the decoded row instead, and surviving rows decode on the way out either way.
+    dict_ = !table_info_->dictionaries_.empty();
+    effective_predicate_ = plan_->GetPredicate();
+    decode_filter_ = false;
+    dict_predicate_.reset();
+    if (dict_) {
+      RewriteDictPredicate();
+    }
+    // A PAX table gathers only the columns the scan actually reads out of the minipages.
+    if (pax_) {
+      RebuildNeededColumns();
+    }
+    // Compile the predicate once per executor, surviving re-Init of a prepared executor;
+    // unsupported shapes keep the interpreted Evaluate. A dictionary rewrite depends on the
+    // dictionary's contents at Init time, so those tables recompile on every Init.
+    if (!predicate_compiled_ || dict_) {
+      compiled_predicate_ =
+          decode_filter_ ? ExpressionCompiler::CompiledPredicate{}
+                         : ExpressionCompiler::Compile(effective_predicate_, &table_info_->schema_);
+      // A shape the kernels reject (a varchar or decimal operand, say) falls back to the
+      // interpreted Evaluate; screen its rows on the validity bitmap first so null inputs
+      // never materialize operand Values at all. Compiled kernels carry their own null checks.
+      null_screen_ = compiled_predicate_ || decode_filter_
+                         ? ExpressionCompiler::NullScreen{}
+                         : ExpressionCompiler::CompileNullScreen(effective_predicate_, &table_info_->schema_);
+      predicate_compiled_ = true;
+    }
+    // A row-layout heap with a varlen schema may keep big payloads in overflow chains; such
+    // rows cannot be filtered in the page and are resolved through the heap after the latch.
+    toastable_ = !pax_ && table_info_->table_->GetSchema() != nullptr &&
+                 table_info_->schema_.GetUnlinedColumnCount() > 0;
+    // A PAX scan with a simple enough predicate filters whole minipages with a columnar kernel.
+    ClassifySimdFilter();
+    // A predicate over a zone-mapped column lets the scan skip whole pages by their ranges.
+    zone_map_ = table_info_->zone_map_.get();
+    ClassifyZonePrune();
+  }
+
+  bool Next(Tuple *tuple) override {
+    if (plan_->IsParallel()) {
+      if (!scanned_) {
+        ParallelScan();
+        scanned_ = true;
+      }
+      if (result_idx_ >= results_.size()) {
+        return false;
+      }
+      *tuple = results_[result_idx_++];
+      return true;
+    }
+    auto *bpm = exec_ctx_->GetBufferPoolManager();
+    const Schema *schema = &table_info_->schema_;
+    const AbstractExpression *predicate = effective_predicate_;
+    if (pax_) {
+      // The PAX variant of the loop below: the page gathers only needed_cols_ out of its
+      // minipages, so a narrow scan of a wide table never touches the other columns' bytes.
+      while (cur_page_id_ != INVALID_PAGE_ID) {
+        if (cur_slot_ == 0 && SkipPrunedPage(bpm)) {
+          continue;
+        }
+        auto *page = static_cast<PaxTablePage *>(FetchScanPage(bpm, cur_page_id_));
+        if (page == nullptr) {
+          LeaveSharedScanIfJoined();
+          return false;
+        }
+        page->RLatch();
+        if (cur_slot_ == 0) {
+          page_id_t prefetch_id = page->GetNextPageId();
+          if (prefetch_id != INVALID_PAGE_ID && exec_ctx_->WithinPinQuota()) {
+            bpm->PrefetchPage(prefetch_id);
+          }
+          // One kernel pass over the predicate column replaces the per-row comparison for the
+          // whole page; the bitmap stays valid while the scan resumes into the same page.
+          if (simd_filter_) {
+            BuildSelection(page, schema, &selection_);
+          }
+        }
+        RID rid;
+        // A decode-filtered row is judged on its decoded form inside consume; accepted stays
+        // false when it fails there, and the loop resumes from the next slot.
+        bool accepted = true;
+        bool found = page->FindFirstMatch(
+            schema, cur_slot_, needed_cols_,
+            [this, predicate, schema](const Tuple &view) {
+              if (decode_filter_) {
+                return true;
+              }
+              return simd_filter_ ? PassesKeyFilter(view, schema) : PassesFilters(view, schema, predicate);
+            },
+            &rid,
+            [this, tuple, schema, &accepted](const Tuple &view) {
+              if (decode_filter_) {
+                Tuple logical = DecodeRow(view, schema);
+                if (!PassesDecodedFilters(logical)) {
+                  accepted = false;
+                  return;
+                }
+                *tuple = MaterializeDecoded(logical);
+                return;
+              }
+              *tuple = Materialize(view, schema);
+            },
+            simd_filter_ ? selection_.data() : nullptr);
+        if (found) {
+          cur_slot_ = rid.GetSlotNum() + 1;
+          page->RUnlatch();
+          UnpinScanPage(bpm, cur_page_id_);
+          if (!accepted) {
+            continue;
+          }
+          // The projection rebuilt the tuple; keep its source RID so DML parents can use it.
+          tuple->SetRid(rid);
+          return true;
+        }
+        page_id_t next_page_id = page->GetNextPageId();
+        page->RUnlatch();
+        UnpinScanPage(bpm, cur_page_id_);
+        if (zone_map_ != nullptr) {
+          // Teach the zone map this page's successor, so a later scan can prune it fetch-free.
+          zone_map_->SetNextPage(cur_page_id_, next_page_id);
+        }
+        cur_page_id_ = next_page_id;
+        cur_slot_ = 0;
+      }
+      return false;
+    }
+    while (cur_page_id_ != INVALID_PAGE_ID) {
+      if (cur_slot_ == 0 && SkipPrunedPage(bpm)) {
+        continue;
+      }
+      auto *page = static_cast<TablePage *>(FetchScanPage(bpm, cur_page_id_));
+      if (page == nullptr) {
+        LeaveSharedScanIfJoined();
+        return false;
+      }
+      page->RLatch();
+      // On entering a page, hand its successor to the pool's prefetch worker: the next page's
+      // disk read then overlaps with filtering this page's slots, so a working set larger than
+      // the pool costs latency on the first page only instead of on every chain step.
+      if (cur_slot_ == 0) {
+        page_id_t prefetch_id = page->GetNextPageId();
+        if (prefetch_id != INVALID_PAGE_ID && exec_ctx_->WithinPinQuota()) {
+          bpm->PrefetchPage(prefetch_id);
+        }
+      }
+      RID rid;
+      // The filter and the projection both run in the page, against the storage bytes; failing
+      // rows cost no copy, and surviving rows copy only the projected columns. A toasted row is
+      // the exception: its varlen entries point at overflow chains, so it passes through here
+      // untouched and is filtered off-latch below.
+      bool deferred = false;
+      bool accepted = true;
+      bool found = page->FindFirstMatch(
+          cur_slot_,
+          [this, predicate, schema](const Tuple &view) {
+            if (toastable_ && TableHeap::IsToasted(view, schema)) {
+              return true;
+            }
+            if (decode_filter_) {
+              return true;
+            }
+            return PassesFilters(view, schema, predicate);
+          },
+          &rid,
+          [this, tuple, schema, &deferred, &accepted](const Tuple &view) {
+            if (toastable_ && TableHeap::IsToasted(view, schema)) {
+              deferred = true;
+              return;
+            }
+            if (decode_filter_) {
+              Tuple logical = DecodeRow(view, schema);
+              if (!PassesDecodedFilters(logical)) {
+                accepted = false;
+                return;
+              }
+              *tuple = MaterializeDecoded(logical);
+              return;
+            }
+            *tuple = Materialize(view, schema);
+          });
+      if (found) {
+        cur_slot_ = rid.GetSlotNum() + 1;
+        page->RUnlatch();
+        UnpinScanPage(bpm, cur_page_id_);
+        if (deferred) {
+          // Off-latch: read the full row through the heap's detoasting path, then filter it.
+          Tuple full;
+          if (!table_info_->table_->GetTuple(rid, &full, exec_ctx_->GetTransaction())) {
+            continue;
+          }
+          if (decode_filter_) {
+            Tuple logical = DecodeRow(full, schema);
+            if (!PassesDecodedFilters(logical)) {
+              continue;
+            }
+            *tuple = MaterializeDecoded(logical);
+          } else {
+            if (!PassesFilters(full, schema, predicate)) {
+              continue;
+            }
+            *tuple = Materialize(full, schema);
+          }
+        }
+        if (!accepted) {
+          continue;
+        }
+        // The projection rebuilt the tuple; keep its source RID so DML parents can use it.
+        tuple->SetRid(rid);
+        return true;
+      }
+      page_id_t next_page_id = page->GetNextPageId();
+      page->RUnlatch();
+      UnpinScanPage(bpm, cur_page_id_);
+      if (zone_map_ != nullptr) {
+        // Teach the zone map this page's successor, so a later scan can prune it fetch-free.
+        zone_map_->SetNextPage(cur_page_id_, next_page_id);
+      }
+      AdvanceCursor(next_page_id);
+    }
+    return false;
+  }
 
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
+  /**
+   * Attaches a Bloom filter over join-key hashes, pushed down by a parent hash join so that
+   * probe-side tuples whose keys cannot match any build-side key are discarded inside the page
+   * scan, before they are ever materialized. The key expressions are given against this scan's
+   * output schema; each must be a plain column reference so it can be translated to the table
+   * schema the in-page filter evaluates against. If any key is not a column reference the
+   * filter is dropped -- it is only an optimization.
+   * @param filter the filter over the build side's key hashes; must outlive this executor
+   * @param keys the probe-side key expressions, against this scan's output schema
+   */
+  void SetKeyFilter(const BloomFilter *filter, const std::vector<const AbstractExpression *> &keys) {
+    key_filter_ = nullptr;
+    filter_key_exprs_.clear();
+    // An encoded table's in-page bytes hash codes where the join hashed strings, so the two
+    // sides would never agree; the filter is only an optimization, so it is dropped.
+    if (dict_) {
+      return;
+    }
+    const Schema *out_schema = plan_->OutputSchema();
+    for (const auto *key : keys) {
+      const auto *col_ref = dynamic_cast<const ColumnValueExpression *>(key);
+      if (col_ref == nullptr) {
+        filter_key_exprs_.clear();
+        return;
+      }
+      filter_key_exprs_.push_back(out_schema->GetColumn(col_ref->GetColIdx()).GetExpr());
+    }
+    key_filter_ = filter;
+    // The in-page filter reads the key columns, so a PAX scan must gather them too.
+    if (pax_) {
+      RebuildNeededColumns();
+    }
+  }
+
  private:
+  /** Runs the morsel-driven parallel scan, leaving every surviving tuple in results_. */
+  void ParallelScan() {
+    auto *bpm = exec_ctx_->GetBufferPoolManager();
+    const Schema *schema = &table_info_->schema_;
+    const AbstractExpression *predicate = effective_predicate_;
+
+    // The heap's sampled page directory hands out the split points in O(1): each entry starts a
+    // run of DIRECTORY_INTERVAL chain pages, so no up-front walk of the whole chain is needed.
+    std::vector<page_id_t> starts = table_info_->table_->GetPageDirectory();
+    size_t num_morsels = starts.size();
+    if (num_morsels == 0) {
+      return;
+    }
+
+    // The pool may be shared with other operators and queries; the group scopes the wait to
+    // this scan's tasks only.
+    TaskGroup group(exec_ctx_->GetThreadPool());
+    std::atomic<size_t> next_morsel{0};
+    std::mutex results_latch;
+    size_t num_workers = std::min(group.GetPool()->Size(), num_morsels);
+    for (size_t i = 0; i < num_workers; i++) {
+      group.Submit([&, bpm, schema, predicate] {
+        std::vector<Tuple> local;
+        size_t morsel;
+        while ((morsel = next_morsel.fetch_add(1)) < num_morsels) {
+          // Walk this morsel's run of the chain; both layouts keep the next-page id at the same
+          // header offset, so the row-page accessor serves. One page of read-ahead keeps the
+          // next page streaming in from disk while this one is filtered.
+          page_id_t page_id = starts[morsel];
+          for (size_t p = 0; p < TableHeap::DIRECTORY_INTERVAL && page_id != INVALID_PAGE_ID; p++) {
+            auto *page = static_cast<TablePage *>(FetchScanPage(bpm, page_id));
+            if (page == nullptr) {
+              break;
+            }
+            page->RLatch();
+            page_id_t next_page_id = page->GetNextPageId();
+            if (p + 1 < TableHeap::DIRECTORY_INTERVAL && next_page_id != INVALID_PAGE_ID) {
+              bpm->PrefetchPage(next_page_id);
+            }
+            // A pruned page contributes nothing; release it before the slot sweep.
+            if (CanSkipPage(page_id)) {
+              page->RUnlatch();
+              UnpinScanPage(bpm, page_id);
+              page_id = next_page_id;
+              continue;
+            }
+            RID rid;
+            uint32_t slot = 0;
+            // Toasted rows pass the in-page filter untouched and are resolved after the latch,
+            // exactly as in the serial loop.
+            std::vector<RID> deferred;
+            if (pax_) {
+              auto *pax_page = reinterpret_cast<PaxTablePage *>(page);
+              std::vector<uint64_t> selection;
+              if (simd_filter_) {
+                BuildSelection(pax_page, schema, &selection);
+              }
+              while (pax_page->FindFirstMatch(
+                  schema, slot, needed_cols_,
+                  [this, predicate, schema](const Tuple &view) {
+                    if (decode_filter_) {
+                      return true;
+                    }
+                    return simd_filter_ ? PassesKeyFilter(view, schema) : PassesFilters(view, schema, predicate);
+                  },
+                  &rid,
+                  [this, &local, schema](const Tuple &view) {
+                    if (decode_filter_) {
+                      Tuple logical = DecodeRow(view, schema);
+                      if (PassesDecodedFilters(logical)) {
+                        local.push_back(MaterializeDecoded(logical));
+                        local.back().SetRid(view.GetRid());
+                      }
+                      return;
+                    }
+                    local.push_back(Materialize(view, schema));
+                    local.back().SetRid(view.GetRid());
+                  },
+                  simd_filter_ ? selection.data() : nullptr)) {
+                slot = rid.GetSlotNum() + 1;
+              }
+            } else {
+              while (page->FindFirstMatch(
+                  slot,
+                  [this, predicate, schema](const Tuple &view) {
+                    if (toastable_ && TableHeap::IsToasted(view, schema)) {
+                      return true;
+                    }
+                    if (decode_filter_) {
+                      return true;
+                    }
+                    return PassesFilters(view, schema, predicate);
+                  },
+                  &rid,
+                  [this, &local, &deferred, schema](const Tuple &view) {
+                    if (toastable_ && TableHeap::IsToasted(view, schema)) {
+                      deferred.push_back(view.GetRid());
+                      return;
+                    }
+                    if (decode_filter_) {
+                      Tuple logical = DecodeRow(view, schema);
+                      if (PassesDecodedFilters(logical)) {
+                        local.push_back(MaterializeDecoded(logical));
+                        local.back().SetRid(view.GetRid());
+                      }
+                      return;
+                    }
+                    local.push_back(Materialize(view, schema));
+                    local.back().SetRid(view.GetRid());
+                  })) {
+                slot = rid.GetSlotNum() + 1;
+              }
+            }
+            page->RUnlatch();
+            UnpinScanPage(bpm, page_id);
+            for (const auto &toasted_rid : deferred) {
+              Tuple full;
+              if (!table_info_->table_->GetTuple(toasted_rid, &full, exec_ctx_->GetTransaction())) {
+                continue;
+              }
+              if (decode_filter_) {
+                Tuple logical = DecodeRow(full, schema);
+                if (PassesDecodedFilters(logical)) {
+                  local.push_back(MaterializeDecoded(logical));
+                  local.back().SetRid(toasted_rid);
+                }
+              } else if (PassesFilters(full, schema, predicate)) {
+                local.push_back(Materialize(full, schema));
+                local.back().SetRid(toasted_rid);
+              }
+            }
+            page_id = next_page_id;
+          }
+        }
+        std::lock_guard<std::mutex> guard(results_latch);
+        for (auto &t : local) {
+          results_.push_back(std::move(t));
+        }
+      });
+    }
+    group.Wait();
+  }
+
+  /** Appends the table-schema indexes of every column reference in an expression tree. */
+  static void CollectColumns(const AbstractExpression *expr, std::vector<uint32_t> *cols) {
+    if (expr == nullptr) {
+      return;
+    }
+    if (const auto *col_ref = dynamic_cast<const ColumnValueExpression *>(expr)) {
+      cols->push_back(col_ref->GetColIdx());
+    }
+    for (const auto *child : expr->GetChildren()) {
+      CollectColumns(child, cols);
+    }
+  }
+
+  /**
+   * Recomputes the columns a PAX scan must gather out of the minipages: the projected columns
+   * plus everything the predicate and the pushed-down key filter read -- or every column, when
+   * the output is not a pure projection and Materialize may evaluate anything, or when the
+   * filter runs on decoded rows and decoding needs the whole row.
+   */
+  void RebuildNeededColumns() {
+    needed_cols_.clear();
+    const Schema *schema = &table_info_->schema_;
+    if (!direct_project_ || decode_filter_) {
+      for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+        needed_cols_.push_back(i);
+      }
+      return;
+    }
+    needed_cols_ = projected_cols_;
+    CollectColumns(plan_->GetPredicate(), &needed_cols_);
+    for (const auto *expr : filter_key_exprs_) {
+      CollectColumns(expr, &needed_cols_);
+    }
+    std::sort(needed_cols_.begin(), needed_cols_.end());
+    needed_cols_.erase(std::unique(needed_cols_.begin(), needed_cols_.end()), needed_cols_.end());
+  }
+
+  /** Fetches a heap page for the scan, counting the pin in the query's accounting. */
+  Page *FetchScanPage(BufferPoolManager *bpm, page_id_t page_id) {
+    Page *page = bpm->FetchPage(page_id);
+    if (page != nullptr) {
+      exec_ctx_->RecordPin();
+    }
+    return page;
+  }
+
+  /** Releases a (clean) scan page pin recorded by FetchScanPage. */
+  void UnpinScanPage(BufferPoolManager *bpm, page_id_t page_id) {
+    bpm->UnpinPage(page_id, false);
+    exec_ctx_->RecordUnpin();
+  }
+
+  /** Runs the plan predicate and the pushed-down key filter against an in-page tuple view. */
+  bool PassesFilters(const Tuple &view, const Schema *schema, const AbstractExpression *predicate) const {
+    if (compiled_predicate_) {
+      if (!compiled_predicate_(view)) {
+        return false;
+      }
+    } else if (predicate != nullptr) {
+      if (null_screen_ && null_screen_(view)) {
+        return false;
+      }
+      if (!predicate->Evaluate(&view, schema).GetAs<bool>()) {
+        return false;
+      }
+    }
+    return PassesKeyFilter(view, schema);
+  }
+
+  /** Runs just the pushed-down key filter; used when the plan predicate was already applied. */
+  bool PassesKeyFilter(const Tuple &view, const Schema *schema) const {
+    if (key_filter_ == nullptr) {
+      return true;
+    }
+    // Hash the key columns the way the join hashes its build keys: combine non-null hashes.
+    hash_t h = 0;
+    for (const auto *expr : filter_key_exprs_) {
+      Value val = expr->Evaluate(&view, schema);
+      if (!val.IsNull()) {
+        h = HashUtil::CombineHashes(h, HashUtil::HashValue(&val));
+      }
+    }
+    return key_filter_->MayContain(h);
+  }
+
+  /**
+   * Detects the predicate shape the columnar kernels accept -- a comparison between one
+   * fixed-width column and a non-null constant of the same type -- and records its pieces.
+   * The kernels treat the type's null sentinel as NULL, exactly like the compiled predicate
+   * path, so the two filters always agree; every other shape keeps the per-row path.
+   */
+  void ClassifySimdFilter() {
+    simd_filter_ = false;
+    if (!pax_ || decode_filter_) {
+      return;
+    }
+    const auto *cmp = dynamic_cast<const ComparisonExpression *>(effective_predicate_);
+    if (cmp == nullptr) {
+      return;
+    }
+    const auto *lhs_col = dynamic_cast<const ColumnValueExpression *>(cmp->GetChildAt(0));
+    const auto *rhs_col = dynamic_cast<const ColumnValueExpression *>(cmp->GetChildAt(1));
+    const ColumnValueExpression *col_ref;
+    const AbstractExpression *const_side;
+    ComparisonType op = cmp->GetComparisonType();
+    if (lhs_col != nullptr && rhs_col == nullptr) {
+      col_ref = lhs_col;
+      const_side = cmp->GetChildAt(1);
+    } else if (rhs_col != nullptr && lhs_col == nullptr) {
+      // const OP col runs as col Mirror(OP) const, as in the compiled path.
+      col_ref = rhs_col;
+      const_side = cmp->GetChildAt(0);
+      op = ExpressionCompiler::Mirror(op);
+    } else {
+      return;
+    }
+    const auto *constant = dynamic_cast<const ConstantValueExpression *>(const_side);
+    if (constant == nullptr) {
+      return;
+    }
+    const Column &col = table_info_->schema_.GetColumn(col_ref->GetColIdx());
+    if (!SimdFilter::Supported(col.GetType())) {
+      return;
+    }
+    Value val = constant->Evaluate(nullptr, nullptr);
+    if (val.IsNull() || val.GetTypeId() != col.GetType()) {
+      return;
+    }
+    simd_col_ = col_ref->GetColIdx();
+    simd_op_ = op;
+    simd_const_ = val;
+    simd_filter_ = true;
+  }
+
+  /** Runs the columnar kernel over the predicate column's minipage; caller holds the latch. */
+  void BuildSelection(PaxTablePage *page, const Schema *schema, std::vector<uint64_t> *selection) const {
+    const char *data;
+    uint32_t count;
+    page->GetColumnVector(schema, simd_col_, &data, &count);
+    selection->resize((count + 63) / 64);
+    SimdFilter::Filter(schema->GetColumn(simd_col_).GetType(), simd_op_, simd_const_, data, count, selection->data());
+  }
+
+  /**
+   * Detects a predicate the table's zone map can prune on -- a comparison between a mapped
+   * column and a non-null constant of its type -- and records its pieces. The dictionary
+   * rewrite runs first, so an encoded column prunes on its codes, which is exactly what the
+   * zone map records; a decode-filtered predicate never prunes. Every other shape scans
+   * normally.
+   */
+  void ClassifyZonePrune() {
+    zone_prune_ = false;
+    if (zone_map_ == nullptr || decode_filter_) {
+      return;
+    }
+    const auto *cmp = dynamic_cast<const ComparisonExpression *>(effective_predicate_);
+    if (cmp == nullptr) {
+      return;
+    }
+    const auto *lhs_col = dynamic_cast<const ColumnValueExpression *>(cmp->GetChildAt(0));
+    const auto *rhs_col = dynamic_cast<const ColumnValueExpression *>(cmp->GetChildAt(1));
+    const ColumnValueExpression *col_ref;
+    const AbstractExpression *const_side;
+    ComparisonType op = cmp->GetComparisonType();
+    if (lhs_col != nullptr && rhs_col == nullptr) {
+      col_ref = lhs_col;
+      const_side = cmp->GetChildAt(1);
+    } else if (rhs_col != nullptr && lhs_col == nullptr) {
+      col_ref = rhs_col;
+      const_side = cmp->GetChildAt(0);
+      op = ExpressionCompiler::Mirror(op);
+    } else {
+      return;
+    }
+    const auto *constant = dynamic_cast<const ConstantValueExpression *>(const_side);
+    if (constant == nullptr) {
+      return;
+    }
+    const auto &mapped = zone_map_->GetColumns();
+    if (std::find(mapped.begin(), mapped.end(), col_ref->GetColIdx()) == mapped.end()) {
+      return;
+    }
+    Value val = constant->Evaluate(nullptr, nullptr);
+    if (val.IsNull() || val.GetTypeId() != table_info_->schema_.GetColumn(col_ref->GetColIdx()).GetType()) {
+      return;
+    }
+    zone_col_ = col_ref->GetColIdx();
+    zone_op_ = op;
+    zone_const_ = val;
+    zone_prune_ = true;
+  }
+
+  /**
+   * @return true when the page's recorded range proves no row on it can pass the predicate.
+   * A page with no recorded range is never skipped, and rows with a NULL in the mapped column
+   * need no accounting -- a comparison against NULL never passes the filter anyway.
+   */
+  bool CanSkipPage(page_id_t page_id) const {
+    if (!zone_prune_) {
+      return false;
+    }
+    Value min;
+    Value max;
+    if (!zone_map_->GetRange(page_id, zone_col_, &min, &max)) {
+      return false;
+    }
+    switch (zone_op_) {
+      case ComparisonType::Equal:
+        return zone_const_.CompareLessThan(min) == CmpBool::CmpTrue ||
+               zone_const_.CompareGreaterThan(max) == CmpBool::CmpTrue;
+      case ComparisonType::NotEqual:
+        // Only prunable when the page holds nothing but the constant.
+        return min.CompareEquals(zone_const_) == CmpBool::CmpTrue &&
+               max.CompareEquals(zone_const_) == CmpBool::CmpTrue;
+      case ComparisonType::LessThan:
+        return min.CompareGreaterThanEquals(zone_const_) == CmpBool::CmpTrue;
+      case ComparisonType::LessThanOrEqual:
+        return min.CompareGreaterThan(zone_const_) == CmpBool::CmpTrue;
+      case ComparisonType::GreaterThan:
+        return max.CompareLessThanEquals(zone_const_) == CmpBool::CmpTrue;
+      case ComparisonType::GreaterThanOrEqual:
+        return max.CompareLessThan(zone_const_) == CmpBool::CmpTrue;
+    }
+    return false;
+  }
+
+  /**
+   * Steps the serial scan over the current page when the zone map prunes it. With a cached
+   * chain successor the page is never fetched at all; otherwise it is fetched just long
+   * enough to read the chain pointer, which also primes the cache for the next scan.
+   * @return true when the page was pruned and the cursor advanced
+   */
+  bool SkipPrunedPage(BufferPoolManager *bpm) {
+    if (!CanSkipPage(cur_page_id_)) {
+      return false;
+    }
+    page_id_t next_page_id;
+    if (!zone_map_->GetNextPage(cur_page_id_, &next_page_id)) {
+      // Both layouts keep the next-page id at the same header offset, so the row accessor serves.
+      auto *page = static_cast<TablePage *>(FetchScanPage(bpm, cur_page_id_));
+      if (page == nullptr) {
+        cur_page_id_ = INVALID_PAGE_ID;
+        LeaveSharedScanIfJoined();
+        return true;
+      }
+      page->RLatch();
+      next_page_id = page->GetNextPageId();
+      page->RUnlatch();
+      UnpinScanPage(bpm, cur_page_id_);
+      zone_map_->SetNextPage(cur_page_id_, next_page_id);
+    }
+    AdvanceCursor(next_page_id);
+    return true;
+  }
+
+  /**
+   * Steps the serial cursor to the next chain page, publishing the position to the scan
+   * group. For a scan that attached mid-sweep, the chain tail wraps back to the head and the
+   * sweep finishes just short of the attach point, having covered every page exactly once.
+   */
+  void AdvanceCursor(page_id_t next_page_id) {
+    if (shared_start_ != INVALID_PAGE_ID) {
+      if (next_page_id == INVALID_PAGE_ID && !wrapped_) {
+        wrapped_ = true;
+        next_page_id = table_info_->table_->GetFirstPageId();
+      }
+      if (wrapped_ && next_page_id == shared_start_) {
+        next_page_id = INVALID_PAGE_ID;
+      }
+    }
+    cur_page_id_ = next_page_id;
+    cur_slot_ = 0;
+    if (cur_page_id_ != INVALID_PAGE_ID) {
+      table_info_->table_->PublishScanPosition(cur_page_id_);
+    } else {
+      LeaveSharedScanIfJoined();
+    }
+  }
+
+  /** Leaves the heap's cooperative scan group if this scan is in it; safe to call again. */
+  void LeaveSharedScanIfJoined() {
+    if (shared_heap_ != nullptr) {
+      shared_heap_->LeaveSharedScan();
+      shared_heap_ = nullptr;
+    }
+  }
+
+  /**
+   * Lays out a surviving row from the in-page view. Pure column projections read the needed
+   * columns straight from their storage offsets; computed output columns fall back to
+   * expression evaluation.
+   */
+  Tuple Materialize(const Tuple &raw_tuple, const Schema *schema) {
+    const Schema *out_schema = GetOutputSchema();
+    std::vector<Value> values;
+    values.reserve(out_schema->GetColumnCount());
+    if (direct_project_) {
+      if (dict_) {
+        // A projected column may be an encoded one; its code decodes on the way out.
+        for (uint32_t col_idx : projected_cols_) {
+          values.push_back(DecodeValue(raw_tuple, schema, col_idx));
+        }
+        return Tuple(values, out_schema);
+      }
+      for (uint32_t col_idx : projected_cols_) {
+        values.push_back(raw_tuple.GetValue(schema, col_idx));
+      }
+    } else {
+      // Arbitrary output expressions expect the declared column types, so an encoded row is
+      // decoded in full before they run.
+      if (dict_) {
+        return MaterializeDecoded(DecodeRow(raw_tuple, schema));
+      }
+      for (const auto &col : out_schema->GetColumns()) {
+        values.push_back(col.GetExpr()->Evaluate(&raw_tuple, schema));
+      }
+    }
+    return Tuple(values, out_schema);
+  }
+
+  /**
+   * Decides how a dictionary table's plan predicate runs. An equality or inequality between an
+   * encoded column and a non-null string constant rewrites to the same comparison over codes,
+   * which the compiled and columnar paths then treat like any other integer predicate; a string
+   * the dictionary has never seen compares against INVALID_CODE, which no row stores. Any other
+   * shape that touches an encoded column falls back to filtering on the decoded row. Predicates
+   * over the table's plain columns need no rewrite at all -- codes never enter them.
+   */
+  void RewriteDictPredicate() {
+    const AbstractExpression *predicate = plan_->GetPredicate();
+    std::vector<uint32_t> cols;
+    CollectColumns(predicate, &cols);
+    bool touches_dict = false;
+    for (uint32_t col : cols) {
+      if (table_info_->dictionaries_.count(col) != 0) {
+        touches_dict = true;
+        break;
+      }
+    }
+    if (!touches_dict) {
+      return;
+    }
+    const auto *cmp = dynamic_cast<const ComparisonExpression *>(predicate);
+    if (cmp != nullptr &&
+        (cmp->GetComparisonType() == ComparisonType::Equal || cmp->GetComparisonType() == ComparisonType::NotEqual)) {
+      const auto *lhs_col = dynamic_cast<const ColumnValueExpression *>(cmp->GetChildAt(0));
+      const auto *rhs_col = dynamic_cast<const ColumnValueExpression *>(cmp->GetChildAt(1));
+      const ColumnValueExpression *col_ref = lhs_col != nullptr ? lhs_col : rhs_col;
+      const auto *constant =
+          dynamic_cast<const ConstantValueExpression *>(lhs_col != nullptr ? cmp->GetChildAt(1) : cmp->GetChildAt(0));
+      if (col_ref != nullptr && constant != nullptr && table_info_->dictionaries_.count(col_ref->GetColIdx()) != 0) {
+        Value val = constant->Evaluate(nullptr, nullptr);
+        if (!val.IsNull() && val.GetTypeId() == TypeId::VARCHAR) {
+          int32_t code = StringDictionary::INVALID_CODE;
+          table_info_->dictionaries_.at(col_ref->GetColIdx())->TryGetCode(val.ToString(), &code);
+          dict_col_expr_ = std::make_unique<ColumnValueExpression>(0, col_ref->GetColIdx(), TypeId::INTEGER);
+          dict_const_expr_ = std::make_unique<ConstantValueExpression>(ValueFactory::GetIntegerValue(code));
+          dict_predicate_ =
+              std::make_unique<ComparisonExpression>(dict_col_expr_.get(), dict_const_expr_.get(),
+                                                     cmp->GetComparisonType());
+          effective_predicate_ = dict_predicate_.get();
+          return;
+        }
+      }
+    }
+    decode_filter_ = true;
+  }
+
+  /** Reads one column of a stored row, translating an encoded column's code back to its string. */
+  Value DecodeValue(const Tuple &raw, const Schema *storage_schema, uint32_t col_idx) const {
+    auto dict_it = table_info_->dictionaries_.find(col_idx);
+    if (dict_it == table_info_->dictionaries_.end()) {
+      return raw.GetValue(storage_schema, col_idx);
+    }
+    Value code = raw.GetValue(storage_schema, col_idx);
+    if (code.IsNull()) {
+      return ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+    }
+    return ValueFactory::GetVarcharValue(dict_it->second->Decode(code.GetAs<int32_t>()));
+  }
+
+  /** Rebuilds a stored row against the declared schema, decoding every encoded column. */
+  Tuple DecodeRow(const Tuple &raw, const Schema *storage_schema) const {
+    std::vector<Value> values;
+    values.reserve(storage_schema->GetColumnCount());
+    for (uint32_t i = 0; i < storage_schema->GetColumnCount(); i++) {
+      values.push_back(DecodeValue(raw, storage_schema, i));
+    }
+    return Tuple(values, &table_info_->logical_schema_);
+  }
+
+  /** Runs the plan predicate against a decoded row; only decode-filtered tables get here. */
+  bool PassesDecodedFilters(const Tuple &logical) const {
+    const AbstractExpression *predicate = plan_->GetPredicate();
+    return predicate == nullptr || predicate->Evaluate(&logical, &table_info_->logical_schema_).GetAs<bool>();
+  }
+
+  /** Lays out an output row from an already-decoded row, against the declared schema. */
+  Tuple MaterializeDecoded(const Tuple &logical) {
+    const Schema *out_schema = GetOutputSchema();
+    const Schema *logical_schema = &table_info_->logical_schema_;
+    std::vector<Value> values;
+    values.reserve(out_schema->GetColumnCount());
+    if (direct_project_) {
+      for (uint32_t col_idx : projected_cols_) {
+        values.push_back(logical.GetValue(logical_schema, col_idx));
+      }
+    } else {
+      for (const auto &col : out_schema->GetColumns()) {
+        values.push_back(col.GetExpr()->Evaluate(&logical, logical_schema));
+      }
+    }
+    return Tuple(values, out_schema);
+  }
+
   /** The sequential scan plan node to be executed. */
   const SeqScanPlanNode *plan_;
+  /** Metadata of the scanned table. */
+  TableMetadata *table_info_{nullptr};
+  /** The page the scan is currently positioned on. */
+  page_id_t cur_page_id_{INVALID_PAGE_ID};
+  /** The slot the scan resumes from within the current page. */
+  uint32_t cur_slot_{0};
+  /** Merged output of a parallel scan, drained by Next(). */
+  std::vector<Tuple> results_;
+  /** The next tuple of results_ to hand out. */
+  size_t result_idx_{0};
+  /** True once the parallel scan has run for this Init(). */
+  bool scanned_{false};
+  /** The heap whose cooperative scan group this scan has joined, or nullptr. */
+  TableHeap *shared_heap_{nullptr};
+  /** The attach position when this scan joined a sweep in progress; INVALID when leading. */
+  page_id_t shared_start_{INVALID_PAGE_ID};
+  /** True once an attached scan has wrapped from the chain tail back to the head. */
+  bool wrapped_{false};
+  /** Bloom filter over build-side key hashes pushed down by a parent hash join, or nullptr. */
+  const BloomFilter *key_filter_{nullptr};
+  /** The key expressions, translated to the table schema for in-page evaluation. */
+  std::vector<const AbstractExpression *> filter_key_exprs_;
+  /** The plan predicate compiled to a specialized closure, or empty to use Evaluate. */
+  ExpressionCompiler::CompiledPredicate compiled_predicate_;
+  /** Validity pre-screen for an interpreted predicate, or empty (see CompileNullScreen). */
+  ExpressionCompiler::NullScreen null_screen_;
+  /** True once the predicate has been through the compiler, whatever the outcome. */
+  bool predicate_compiled_{false};
+  /** True when every output column is a plain column reference (see Materialize). */
+  bool direct_project_{false};
+  /** The table-schema indexes of the projected columns, valid when direct_project_. */
+  std::vector<uint32_t> projected_cols_;
+  /** True when the scanned table stores its pages in the PAX layout. */
+  bool pax_{false};
+  /** True when the scanned row-layout table may keep varlen payloads in overflow chains. */
+  bool toastable_{false};
+  /** The columns a PAX scan gathers out of the minipages, valid when pax_. */
+  std::vector<uint32_t> needed_cols_;
+  /** True when the predicate runs as a columnar kernel over a minipage, see ClassifySimdFilter. */
+  bool simd_filter_{false};
+  /** The predicate column, operator, and constant of the columnar filter, valid when simd_filter_. */
+  uint32_t simd_col_{0};
+  ComparisonType simd_op_{ComparisonType::Equal};
+  Value simd_const_;
+  /** The serial scan's selection bitmap over the current page, rebuilt on page entry. */
+  std::vector<uint64_t> selection_;
+  /** The scanned table's zone map, or nullptr when it has none. */
+  ZoneMap *zone_map_{nullptr};
+  /** True when the predicate can prune pages by their ranges, see ClassifyZonePrune. */
+  bool zone_prune_{false};
+  /** The predicate column, operator, and constant of the pruning check, valid when zone_prune_. */
+  uint32_t zone_col_{0};
+  ComparisonType zone_op_{ComparisonType::Equal};
+  Value zone_const_;
+  /** True when the scanned table has dictionary-encoded columns. */
+  bool dict_{false};
+  /** True when the predicate must run on decoded rows, see RewriteDictPredicate. */
+  bool decode_filter_{false};
+  /** The predicate the in-page filter evaluates: the plan's, or its dictionary rewrite. */
+  const AbstractExpression *effective_predicate_{nullptr};
+  /** The pieces of the rewritten code comparison, owned here; valid while dict_predicate_ is. */
+  std::unique_ptr<ColumnValueExpression> dict_col_expr_;
+  std::unique_ptr<ConstantValueExpression> dict_const_expr_;
+  std::unique_ptr<ComparisonExpression> dict_predicate_;
 };
 }  // namespace bustub
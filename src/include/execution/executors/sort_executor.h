@@ -0,0 +1,233 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "common/memory_tracker.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * SortExecutor orders the tuples of its child by the plan's key expressions. Inputs that fit
+ * the plan's buffer capacity are sorted in memory and served directly. Larger inputs become an
+ * external merge sort: each time the buffer fills it is sorted and spilled as a run of
+ * TmpTuplePages in the query's temp space -- not the buffer pool, so a spilling sort cannot
+ * evict the working set -- and Next() then streams the k-way merge of the runs through a heap
+ * of run cursors, so memory stays bounded by the buffer plus one pinned page per run. Run
+ * pages are deleted as the merge finishes with them.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort executor.
+   * @param exec_ctx the context that the sort should be performed in
+   * @param plan the sort plan node
+   * @param child the child executor whose tuples are sorted
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child)
+      : AbstractExecutor(exec_ctx),
+        plan_(plan),
+        child_(std::move(child)),
+        reservation_(exec_ctx->GetMemoryTracker()) {}
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override {
+    child_->Init();
+    buffer_.clear();
+    buffer_idx_ = 0;
+    cursors_.clear();
+    heap_ = decltype(heap_){[this](size_t a, size_t b) { return TupleLess(cursors_[b].current_, cursors_[a].current_); }};
+
+    std::vector<std::vector<page_id_t>> runs;
+    buffer_bytes_ = 0;
+    Tuple tuple;
+    while (child_->Next(&tuple)) {
+      buffer_bytes_ += tuple.GetLength();
+      buffer_.emplace_back(std::move(tuple));
+      // Spill at the plan's capacity, or earlier when the process-wide memory budget is
+      // exhausted by concurrent buffering operators.
+      if (buffer_.size() >= plan_->GetBufferCapacity() || !reservation_.Reserve(buffer_bytes_)) {
+        SpillRun(&runs);
+      }
+    }
+    if (runs.empty()) {
+      // The whole input fit in the buffer: sort in place and serve from memory.
+      SortBuffer();
+      external_ = false;
+      return;
+    }
+    if (!buffer_.empty()) {
+      SpillRun(&runs);
+    }
+    // Open a cursor per run and seed the merge heap with each run's first tuple.
+    external_ = true;
+    cursors_.resize(runs.size());
+    for (size_t i = 0; i < runs.size(); i++) {
+      cursors_[i].pages_ = std::move(runs[i]);
+      Advance(&cursors_[i]);
+      if (cursors_[i].valid_) {
+        heap_.push(i);
+      }
+    }
+  }
+
+  bool Next(Tuple *tuple) override {
+    if (!external_) {
+      if (buffer_idx_ >= buffer_.size()) {
+        return false;
+      }
+      *tuple = buffer_[buffer_idx_++];
+      return true;
+    }
+    if (heap_.empty()) {
+      return false;
+    }
+    size_t run = heap_.top();
+    heap_.pop();
+    *tuple = cursors_[run].current_;
+    Advance(&cursors_[run]);
+    if (cursors_[run].valid_) {
+      heap_.push(run);
+    }
+    return true;
+  }
+
+ private:
+  /** A read position in a spilled run. */
+  struct RunCursor {
+    /** The run's pages, in sorted order. */
+    std::vector<page_id_t> pages_;
+    /** The page the cursor is on. */
+    size_t page_idx_{0};
+    /** The current page, pinned across reads; nullptr before the page is opened. */
+    TmpTuplePage *page_{nullptr};
+    /** The byte offset of the next tuple in the current page. */
+    size_t offset_{0};
+    /** The tuple the cursor currently points at. */
+    Tuple current_;
+    /** False once the run is exhausted. */
+    bool valid_{false};
+  };
+
+  /** @return true if a orders strictly before b under the plan's keys and directions */
+  bool TupleLess(const Tuple &a, const Tuple &b) {
+    const Schema *schema = child_->GetOutputSchema();
+    const auto &keys = plan_->GetOrderBys();
+    for (uint32_t i = 0; i < keys.size(); i++) {
+      Value va = keys[i]->Evaluate(&a, schema);
+      Value vb = keys[i]->Evaluate(&b, schema);
+      if (va.CompareLessThan(vb) == CmpBool::CmpTrue) {
+        return !plan_->IsDescending(i);
+      }
+      if (vb.CompareLessThan(va) == CmpBool::CmpTrue) {
+        return plan_->IsDescending(i);
+      }
+    }
+    return false;
+  }
+
+  /** Sorts the in-memory buffer by the plan's keys. */
+  void SortBuffer() {
+    std::sort(buffer_.begin(), buffer_.end(), [this](const Tuple &a, const Tuple &b) { return TupleLess(a, b); });
+  }
+
+  /**
+   * Sorts the buffer and spills it as one run. TmpTuplePage reads a page back in reverse
+   * insertion order, so the buffer is inserted back to front and the page list reversed,
+   * leaving a cursor that walks the pages front to back in sorted order.
+   */
+  void SpillRun(std::vector<std::vector<page_id_t>> *runs) {
+    SortBuffer();
+    auto *tmp = exec_ctx_->GetTempSpace();
+    std::vector<page_id_t> pages;
+    TmpTuplePage *open_page = nullptr;
+    TmpTuple slot(INVALID_PAGE_ID, 0);
+    for (auto it = buffer_.rbegin(); it != buffer_.rend(); ++it) {
+      if (open_page == nullptr || !open_page->Insert(*it, &slot)) {
+        if (open_page != nullptr) {
+          tmp->UnpinPage(open_page->GetTablePageId(), true);
+        }
+        page_id_t page_id;
+        open_page = static_cast<TmpTuplePage *>(tmp->NewPage(&page_id));
+        BUSTUB_ASSERT(open_page != nullptr, "Out of temp space while spilling a sort run.");
+        open_page->Init(page_id, PAGE_SIZE);
+        pages.push_back(page_id);
+        bool inserted = open_page->Insert(*it, &slot);
+        BUSTUB_ASSERT(inserted, "Tuple is too large to fit in an empty TmpTuplePage.");
+      }
+    }
+    if (open_page != nullptr) {
+      tmp->UnpinPage(open_page->GetTablePageId(), true);
+    }
+    std::reverse(pages.begin(), pages.end());
+    runs->push_back(std::move(pages));
+    buffer_.clear();
+    buffer_bytes_ = 0;
+    reservation_.Release();
+  }
+
+  /** Steps a run cursor to its next tuple, holding the current page pinned across reads and
+   * deleting run pages as they are drained. */
+  void Advance(RunCursor *cursor) {
+    auto *tmp = exec_ctx_->GetTempSpace();
+    while (cursor->page_idx_ < cursor->pages_.size()) {
+      page_id_t page_id = cursor->pages_[cursor->page_idx_];
+      if (cursor->page_ == nullptr) {
+        cursor->page_ = static_cast<TmpTuplePage *>(tmp->FetchPage(page_id));
+        BUSTUB_ASSERT(cursor->page_ != nullptr, "Failed to fetch a spilled sort run page.");
+        cursor->offset_ = cursor->page_->GetFirstTupleOffset();
+      }
+      if (cursor->page_->GetNextTuple(&cursor->offset_, &cursor->current_)) {
+        cursor->valid_ = true;
+        return;
+      }
+      tmp->UnpinPage(page_id, false);
+      tmp->DeletePage(page_id);
+      cursor->page_ = nullptr;
+      cursor->page_idx_++;
+    }
+    cursor->valid_ = false;
+  }
+
+  /** The sort plan node. */
+  const SortPlanNode *plan_;
+  /** The child executor whose tuples we are sorting. */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** The in-memory sort buffer; holds the full sorted input when no run spilled. */
+  std::vector<Tuple> buffer_;
+  /** The buffered tuples' total bytes, reserved against the process-wide memory budget. */
+  size_t buffer_bytes_{0};
+  /** This sort's claim on the process-wide executor memory budget. */
+  MemoryReservation reservation_;
+  /** The next tuple of a fully in-memory sort to hand out. */
+  size_t buffer_idx_{0};
+  /** True once Init() decided the input needed spilled runs and a merge phase. */
+  bool external_{false};
+  /** One cursor per spilled run. */
+  std::vector<RunCursor> cursors_;
+  /** Min-heap of run indexes, ordered by each run's current tuple. */
+  std::priority_queue<size_t, std::vector<size_t>, std::function<bool(size_t, size_t)>> heap_{
+      [](size_t, size_t) { return false; }};
+};
+}  // namespace bustub
@@ -0,0 +1,253 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_merge_join_executor.h
+//
+// Identification: src/include/execution/executors/sort_merge_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/join_output_stager.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/sort_merge_join_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * SortMergeJoinExecutor joins two children already ordered ascending on the join keys by
+ * merging the two streams: both cursors advance in key order, and only the right side's
+ * current group of key-equal tuples is ever buffered, so the join runs in constant memory
+ * when keys are near-unique — no build phase, no hash table. The factory also upgrades a
+ * HashJoinPlanNode to this executor when both children are Sort nodes ordered on the join
+ * keys (see CanMerge), so an already-ordered input never pays for a hash build.
+ */
+class SortMergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort-merge join executor.
+   * @param exec_ctx the context that the join should be performed in
+   * @param plan the sort-merge join plan node
+   * @param left the left child, ordered ascending on the plan's left keys
+   * @param right the right child, ordered ascending on the plan's right keys
+   */
+  SortMergeJoinExecutor(ExecutorContext *exec_ctx, const SortMergeJoinPlanNode *plan,
+                        std::unique_ptr<AbstractExecutor> &&left, std::unique_ptr<AbstractExecutor> &&right)
+      : AbstractExecutor(exec_ctx),
+        out_schema_(plan->OutputSchema()),
+        predicate_(plan->Predicate()),
+        left_keys_(plan->GetLeftKeys()),
+        right_keys_(plan->GetRightKeys()),
+        left_(std::move(left)),
+        right_(std::move(right)) {}
+
+  /** Creates a sort-merge join executor for a hash join plan whose children satisfy CanMerge. */
+  SortMergeJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                        std::unique_ptr<AbstractExecutor> &&left, std::unique_ptr<AbstractExecutor> &&right)
+      : AbstractExecutor(exec_ctx),
+        out_schema_(plan->OutputSchema()),
+        predicate_(plan->Predicate()),
+        left_keys_(plan->GetLeftKeys()),
+        right_keys_(plan->GetRightKeys()),
+        left_(std::move(left)),
+        right_(std::move(right)) {}
+
+  /**
+   * @return true if the hash join's children both report the ordering a merge needs: each is a
+   * Sort node whose leading ascending order-by columns are exactly that side's join keys. The
+   * join keys carry the join's tuple index while the sort keys are rooted at the child's own
+   * schema, so only the column indexes are compared.
+   */
+  static bool CanMerge(const HashJoinPlanNode *join_plan) {
+    return join_plan->GetChildren().size() == 2 && SideOrdered(join_plan->GetLeftPlan(), join_plan->GetLeftKeys()) &&
+           SideOrdered(join_plan->GetRightPlan(), join_plan->GetRightKeys());
+  }
+
+  const Schema *GetOutputSchema() override { return out_schema_; }
+
+  void Init() override {
+    left_->Init();
+    right_->Init();
+    if (output_stager_ == nullptr) {
+      output_stager_ =
+          std::make_unique<JoinOutputStager>(out_schema_, left_->GetOutputSchema(), right_->GetOutputSchema());
+    }
+    AdvanceLeft();
+    AdvanceRight();
+    right_group_.clear();
+    group_idx_ = 0;
+    group_active_ = false;
+  }
+
+  bool Next(Tuple *tuple) override {
+    while (true) {
+      if (group_active_) {
+        // Pair the current left tuple with the buffered right group.
+        while (group_idx_ < right_group_.size()) {
+          const Tuple &right_tuple = right_group_[group_idx_++];
+          if (predicate_ != nullptr &&
+              !predicate_->EvaluateJoin(&left_tuple_, left_->GetOutputSchema(), &right_tuple, right_->GetOutputSchema())
+                   .GetAs<bool>()) {
+            continue;
+          }
+          *tuple = Compose(left_tuple_, right_tuple);
+          return true;
+        }
+        // This left tuple is done with the group; the next one rejoins it if its key matches.
+        AdvanceLeft();
+        if (left_valid_ && CompareKeys(left_key_, group_key_) == 0) {
+          group_idx_ = 0;
+          continue;
+        }
+        group_active_ = false;
+        right_group_.clear();
+      }
+      if (!left_valid_ || !right_valid_) {
+        return false;
+      }
+      int cmp = CompareKeys(left_key_, right_key_);
+      if (cmp < 0) {
+        AdvanceLeft();
+        continue;
+      }
+      if (cmp > 0) {
+        AdvanceRight();
+        continue;
+      }
+      // Keys match: buffer the right side's group of key-equal tuples — the only state the
+      // merge ever materializes — and join the left side's matching run against it.
+      group_key_ = right_key_;
+      right_group_.clear();
+      do {
+        right_group_.emplace_back(std::move(right_tuple_));
+        AdvanceRight();
+      } while (right_valid_ && CompareKeys(right_key_, group_key_) == 0);
+      group_idx_ = 0;
+      group_active_ = true;
+    }
+  }
+
+ private:
+  /** @return true if the child is a Sort whose leading ascending order-bys are exactly keys */
+  static bool SideOrdered(const AbstractPlanNode *child, const std::vector<const AbstractExpression *> &keys) {
+    if (child->GetType() != PlanType::Sort || keys.empty()) {
+      return false;
+    }
+    auto *sort_plan = static_cast<const SortPlanNode *>(child);
+    const auto &order_bys = sort_plan->GetOrderBys();
+    if (order_bys.size() < keys.size()) {
+      return false;
+    }
+    for (uint32_t i = 0; i < keys.size(); i++) {
+      if (sort_plan->IsDescending(i)) {
+        return false;
+      }
+      auto *key_ref = dynamic_cast<const ColumnValueExpression *>(keys[i]);
+      auto *order_ref = dynamic_cast<const ColumnValueExpression *>(order_bys[i]);
+      if (key_ref == nullptr || order_ref == nullptr || key_ref->GetColIdx() != order_ref->GetColIdx()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** Evaluates a side's key expressions on a tuple. */
+  static std::vector<Value> KeyOf(const Tuple &tuple, const Schema *schema,
+                                  const std::vector<const AbstractExpression *> &keys) {
+    std::vector<Value> values;
+    values.reserve(keys.size());
+    for (const auto *key : keys) {
+      values.push_back(key->Evaluate(&tuple, schema));
+    }
+    return values;
+  }
+
+  /** @return negative, zero, or positive as a orders before, with, or after b */
+  static int CompareKeys(const std::vector<Value> &a, const std::vector<Value> &b) {
+    for (size_t i = 0; i < a.size(); i++) {
+      if (a[i].CompareLessThan(b[i]) == CmpBool::CmpTrue) {
+        return -1;
+      }
+      if (b[i].CompareLessThan(a[i]) == CmpBool::CmpTrue) {
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+  /** Steps the left cursor and re-evaluates its key. */
+  void AdvanceLeft() {
+    left_valid_ = left_->Next(&left_tuple_);
+    if (left_valid_) {
+      left_key_ = KeyOf(left_tuple_, left_->GetOutputSchema(), left_keys_);
+    }
+  }
+
+  /** Steps the right cursor and re-evaluates its key. */
+  void AdvanceRight() {
+    right_valid_ = right_->Next(&right_tuple_);
+    if (right_valid_) {
+      right_key_ = KeyOf(right_tuple_, right_->GetOutputSchema(), right_keys_);
+    }
+  }
+
+  /** Builds one output tuple from a matched pair. */
+  Tuple Compose(const Tuple &left_tuple, const Tuple &right_tuple) {
+    if (output_stager_->Viable()) {
+      return output_stager_->Stage(left_tuple, right_tuple);
+    }
+    std::vector<Value> values;
+    values.reserve(out_schema_->GetColumnCount());
+    for (const auto &col : out_schema_->GetColumns()) {
+      values.push_back(
+          col.GetExpr()->EvaluateJoin(&left_tuple, left_->GetOutputSchema(), &right_tuple, right_->GetOutputSchema()));
+    }
+    return Tuple(std::move(values), out_schema_);
+  }
+
+  /** The join's output schema. */
+  const Schema *out_schema_;
+  /** The predicate applied on top of key equality; may be null. */
+  const AbstractExpression *predicate_;
+  /** The left child's join keys. */
+  std::vector<const AbstractExpression *> left_keys_;
+  /** The right child's join keys. */
+  std::vector<const AbstractExpression *> right_keys_;
+  /** The left child, ordered ascending on left_keys_. */
+  std::unique_ptr<AbstractExecutor> left_;
+  /** The right child, ordered ascending on right_keys_. */
+  std::unique_ptr<AbstractExecutor> right_;
+  /** Byte-copy plan for a pure-projection output schema; falls back when not Viable(). */
+  std::unique_ptr<JoinOutputStager> output_stager_;
+
+  /** The left cursor's current tuple and key. */
+  Tuple left_tuple_;
+  std::vector<Value> left_key_;
+  bool left_valid_{false};
+  /** The right cursor's current tuple and key; one tuple of lookahead past the group. */
+  Tuple right_tuple_;
+  std::vector<Value> right_key_;
+  bool right_valid_{false};
+  /** The buffered right-side group of key-equal tuples, and the key they share. */
+  std::vector<Tuple> right_group_;
+  std::vector<Value> group_key_;
+  /** The next group tuple to pair with the current left tuple. */
+  size_t group_idx_{0};
+  /** True while the merge is emitting pairs for the buffered group. */
+  bool group_active_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// stats_executor.h
+//
+// Identification: src/include/execution/executors/stats_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * StatsExecutor wraps another executor and records its runtime behavior: rows produced, Next and
+ * NextBatch call counts, cycles spent, and buffer pool fetches issued while it ran. The factory
+ * wraps every executor it creates, so a finished query leaves a per-operator profile on the
+ * ExecutorContext (see ExecutorContext::ReportStats). Timing uses the raw cycle counter and the
+ * fetch counts come from the buffer pool's relaxed counters, so the overhead per call is a few
+ * dozen cycles and the wrapper can stay on in production.
+ */
+class StatsExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new stats-collecting wrapper.
+   * @param exec_ctx the executor context
+   * @param name the wrapped executor's plan type name, used in the report
+   * @param child the executor to wrap
+   */
+  StatsExecutor(ExecutorContext *exec_ctx, std::string name, std::unique_ptr<AbstractExecutor> &&child)
+      : AbstractExecutor(exec_ctx), child_(std::move(child)), stats_(exec_ctx->RegisterStats(std::move(name))) {}
+
+  void Init() override {
+    uint64_t fetches_before = PoolFetches();
+    uint64_t start = ReadCycleCounter();
+    child_->Init();
+    stats_->cycles_ += ReadCycleCounter() - start;
+    stats_->pool_fetches_ += PoolFetches() - fetches_before;
+  }
+
+  bool Next(Tuple *tuple) override {
+    uint64_t fetches_before = PoolFetches();
+    uint64_t start = ReadCycleCounter();
+    bool produced = child_->Next(tuple);
+    stats_->cycles_ += ReadCycleCounter() - start;
+    stats_->pool_fetches_ += PoolFetches() - fetches_before;
+    stats_->next_calls_++;
+    if (produced) {
+      stats_->rows_out_++;
+    }
+    return produced;
+  }
+
+  bool NextBatch(TupleBatch *batch) override {
+    uint64_t fetches_before = PoolFetches();
+    uint64_t start = ReadCycleCounter();
+    bool produced = child_->NextBatch(batch);
+    stats_->cycles_ += ReadCycleCounter() - start;
+    stats_->pool_fetches_ += PoolFetches() - fetches_before;
+    stats_->batch_calls_++;
+    stats_->rows_out_ += batch->Size();
+    return produced;
+  }
+
+  const Schema *GetOutputSchema() override { return child_->GetOutputSchema(); }
+
+  /**
+   * Strips the wrapper from an executor, for operators that sniff a child's concrete type to
+   * push an optimization into it (e.g. the hash join's Bloom filter pushdown into a scan).
+   * @param executor the possibly wrapped executor
+   * @return the wrapped executor, or the argument itself if it is not a wrapper
+   */
+  static AbstractExecutor *Unwrap(AbstractExecutor *executor) {
+    auto *stats = dynamic_cast<StatsExecutor *>(executor);
+    return stats != nullptr ? stats->child_.get() : executor;
+  }
+
+ private:
+  /** @return the buffer pool's cumulative fetch count (hits plus misses) */
+  uint64_t PoolFetches() {
+    auto pool_stats = exec_ctx_->GetBufferPoolManager()->GetStats();
+    return pool_stats.hits_ + pool_stats.misses_;
+  }
+
+  /** The wrapped executor. */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** This executor's counters, owned by the context so they outlive the executor tree. */
+  ExecutorStats *stats_;
+};
+}  // namespace bustub
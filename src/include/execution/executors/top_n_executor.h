@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// top_n_executor.h
+//
+// Identification: src/include/execution/executors/top_n_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * TopNExecutor executes a limit, fused with an ordering when one is present. Given a sort plan
+ * (the limit's child in the original ORDER BY ... LIMIT N shape), Init() drains the input into
+ * a heap bounded at N tuples -- the heap's top is the worst tuple kept, and an incoming tuple
+ * either displaces it or is dropped on the spot -- so no more than N rows are ever materialized
+ * or sorted, regardless of input size. Without a sort plan it degenerates to a plain limit that
+ * passes through the first N child tuples.
+ */
+class TopNExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new Top-N executor.
+   * @param exec_ctx the context that the limit should be performed in
+   * @param plan the limit plan node
+   * @param sort_plan the sort plan fused into this executor, or nullptr for a plain limit
+   * @param child the child executor; the sort's child when a sort plan is fused
+   */
+  TopNExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *plan, const SortPlanNode *sort_plan,
+               std::unique_ptr<AbstractExecutor> &&child)
+      : AbstractExecutor(exec_ctx), plan_(plan), sort_plan_(sort_plan), child_(std::move(child)) {}
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override {
+    child_->Init();
+    num_emitted_ = 0;
+    top_.clear();
+    top_idx_ = 0;
+    if (sort_plan_ == nullptr) {
+      return;
+    }
+    size_t n = plan_->GetLimit();
+    auto less = [this](const Tuple &a, const Tuple &b) { return TupleLess(a, b); };
+    Tuple tuple;
+    while (child_->Next(&tuple)) {
+      if (top_.size() < n) {
+        top_.emplace_back(std::move(tuple));
+        std::push_heap(top_.begin(), top_.end(), less);
+        continue;
+      }
+      if (n > 0 && TupleLess(tuple, top_.front())) {
+        std::pop_heap(top_.begin(), top_.end(), less);
+        top_.back() = std::move(tuple);
+        std::push_heap(top_.begin(), top_.end(), less);
+      }
+    }
+    std::sort_heap(top_.begin(), top_.end(), less);
+  }
+
+  bool Next(Tuple *tuple) override {
+    if (sort_plan_ == nullptr) {
+      // Plain limit: pass through the first N child tuples.
+      if (num_emitted_ >= plan_->GetLimit() || !child_->Next(tuple)) {
+        return false;
+      }
+      num_emitted_++;
+      return true;
+    }
+    if (top_idx_ >= top_.size()) {
+      return false;
+    }
+    *tuple = top_[top_idx_++];
+    return true;
+  }
+
+ private:
+  /** @return true if a orders strictly before b under the fused sort's keys and directions */
+  bool TupleLess(const Tuple &a, const Tuple &b) {
+    const Schema *schema = child_->GetOutputSchema();
+    const auto &keys = sort_plan_->GetOrderBys();
+    for (uint32_t i = 0; i < keys.size(); i++) {
+      Value va = keys[i]->Evaluate(&a, schema);
+      Value vb = keys[i]->Evaluate(&b, schema);
+      if (va.CompareLessThan(vb) == CmpBool::CmpTrue) {
+        return !sort_plan_->IsDescending(i);
+      }
+      if (vb.CompareLessThan(va) == CmpBool::CmpTrue) {
+        return sort_plan_->IsDescending(i);
+      }
+    }
+    return false;
+  }
+
+  /** The limit plan node. */
+  const LimitPlanNode *plan_;
+  /** The sort plan fused into this executor, or nullptr for a plain limit. */
+  const SortPlanNode *sort_plan_;
+  /** The child executor whose tuples we are limiting. */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** The N best tuples, in output order after Init(). */
+  std::vector<Tuple> top_;
+  /** The next tuple of top_ to hand out. */
+  size_t top_idx_{0};
+  /** The number of tuples passed through in plain-limit mode. */
+  size_t num_emitted_{0};
+};
+}  // namespace bustub
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// update_executor.h
+//
+// Identification: src/include/execution/executors/update_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/update_plan.h"
+#include "storage/table/row_serializer.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/**
+ * UpdateExecutor executes an update on a table.
+ * The rows to update come from the child executor; only their RIDs are used -- each row is
+ * re-read from the table before the per-column updates are applied, so the child may project
+ * freely. Updates work on the storage schema, so a dictionary-encoded column keeps its codes
+ * unless the update targets it directly.
+ *
+ * Like the delete executor, the child is drained completely first and the RIDs are applied in
+ * page order: each table page pays one buffer pool fetch for its whole group of updates, and
+ * the heap's UpdateTuple keeps every registered index in sync as usual. Draining first also
+ * keeps an update whose child scans the target table from chasing its own writes (Halloween
+ * problem).
+ */
+class UpdateExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new update executor.
+   * @param exec_ctx the executor context
+   * @param plan the update plan to be executed
+   * @param child_executor the child executor providing the rows to update
+   */
+  UpdateExecutor(ExecutorContext *exec_ctx, const UpdatePlanNode *plan,
+                 std::unique_ptr<AbstractExecutor> &&child_executor)
+      : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child_executor)) {}
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override {
+    table_info_ = exec_ctx_->GetTable(plan_->TableOid());
+    row_serializer_ = std::make_unique<RowSerializer>(&table_info_->schema_);
+    child_->Init();
+    done_ = false;
+  }
+
+  // Note that Update does not make use of the tuple pointer being passed in.
+  // We return false if any update failed, and true once every row has been updated.
+  bool Next([[maybe_unused]] Tuple *tuple) override {
+    if (done_) {
+      return false;
+    }
+    done_ = true;
+    Transaction *txn = exec_ctx_->GetTransaction();
+    std::vector<RID> rids;
+    TupleBatch batch;
+    while (child_->NextBatch(&batch)) {
+      for (auto &t : batch) {
+        rids.push_back(t.GetRid());
+      }
+    }
+    // Page order groups each page's updates together; see the class comment.
+    std::sort(rids.begin(), rids.end(), [](const RID &lhs, const RID &rhs) {
+      return lhs.GetPageId() != rhs.GetPageId() ? lhs.GetPageId() < rhs.GetPageId()
+                                                : lhs.GetSlotNum() < rhs.GetSlotNum();
+    });
+    const Schema *schema = &table_info_->schema_;
+    for (const auto &rid : rids) {
+      Tuple old_tuple;
+      if (!table_info_->table_->GetTuple(rid, &old_tuple, txn)) {
+        return false;
+      }
+      if (!table_info_->table_->UpdateTuple(GenerateUpdatedTuple(old_tuple, schema), rid, txn)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  /** @return a copy of the given row with the plan's per-column updates applied */
+  Tuple GenerateUpdatedTuple(const Tuple &old_tuple, const Schema *schema) {
+    const auto &update_attrs = plan_->GetUpdateAttrs();
+    std::vector<Value> values;
+    values.reserve(schema->GetColumnCount());
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      auto update = update_attrs.find(i);
+      if (update == update_attrs.end()) {
+        values.push_back(old_tuple.GetValue(schema, i));
+      } else if (update->second.type_ == UpdateType::Add) {
+        values.push_back(old_tuple.GetValue(schema, i).Add(ValueFactory::GetIntegerValue(update->second.update_val_)));
+      } else {
+        values.push_back(ValueFactory::GetIntegerValue(update->second.update_val_));
+      }
+    }
+    return row_serializer_->MakeTuple(values);
+  }
+
+  /** The update plan node to be executed. */
+  const UpdatePlanNode *plan_;
+  /** The child executor providing the rows to update. */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** Metadata of the table updated. */
+  TableMetadata *table_info_{nullptr};
+  /** Row serializer compiled from the table's storage schema, rebuilt per Init(). */
+  std::unique_ptr<RowSerializer> row_serializer_;
+  /** True once the update has run for this Init(). */
+  bool done_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,367 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// expression_compiler.h
+//
+// Identification: src/include/execution/expression_compiler.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "storage/table/tuple.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+/**
+ * ExpressionCompiler flattens a predicate tree into one specialized closure, built once per
+ * query. The interpreted path pays around six indirect calls per row: a virtual Evaluate per
+ * tree node plus the type system's own dispatch inside every comparison -- Value::CompareEquals
+ * goes through a virtual Type method that then switches on the right-hand TypeId.
+ *
+ * Compile() instead walks a dispatch ladder once, switching on both operand types and the
+ * operator, and instantiates a comparison kernel templated on the concrete C++ types of both
+ * sides. The kernel loads raw column bytes at precomputed offsets with no per-row type
+ * dispatch at all: evaluating a row is two inline loads, two null-sentinel checks, and an
+ * integer compare behind a single call.
+ *
+ * Only the shapes that dominate scan predicates compile: a comparison whose operands are
+ * fixed-width integer columns or constants. Anything else returns an empty function and the
+ * caller keeps the interpreted Evaluate -- compilation is strictly an optimization.
+ */
+class ExpressionCompiler {
+ public:
+  /** A compiled predicate; evaluates a tuple laid out in the schema it was compiled against. */
+  using CompiledPredicate = std::function<bool(const Tuple &)>;
+
+  /**
+   * Compiles a predicate against the schema its tuples will use.
+   * @param expr the predicate to compile; may be nullptr
+   * @param schema the schema of the tuples the predicate will see
+   * @return the specialized closure, or an empty function if the shape is unsupported
+   */
+  static CompiledPredicate Compile(const AbstractExpression *expr, const Schema *schema) {
+    const auto *cmp = dynamic_cast<const ComparisonExpression *>(expr);
+    if (cmp == nullptr) {
+      return {};
+    }
+    ComparisonType op = cmp->GetComparisonType();
+    Operand lhs = ClassifyOperand(cmp->GetChildAt(0), schema);
+    Operand rhs = ClassifyOperand(cmp->GetChildAt(1), schema);
+    if (!lhs.ok || !rhs.ok) {
+      return {};
+    }
+    // SQL comparisons against NULL are false, so a null constant rejects every row.
+    if (lhs.is_column && rhs.is_column) {
+      return DispatchColCol(lhs, rhs, op);
+    }
+    if (lhs.is_column) {
+      if (rhs.is_null) {
+        return [](const Tuple &) { return false; };
+      }
+      return DispatchColConst(lhs, rhs.word, op);
+    }
+    if (rhs.is_column) {
+      if (lhs.is_null) {
+        return [](const Tuple &) { return false; };
+      }
+      // const OP col runs as col MIRROR(OP) const so one kernel family covers both orders.
+      return DispatchColConst(rhs, lhs.word, Mirror(op));
+    }
+    // Both sides constant: fold the comparison now and capture the verdict.
+    if (lhs.is_null || rhs.is_null) {
+      return [](const Tuple &) { return false; };
+    }
+    bool verdict = CompareWords(lhs.word, rhs.word, op);
+    return [verdict](const Tuple &) { return verdict; };
+  }
+
+  /** A compiled validity screen; true when the tuple's null bits alone decide the predicate. */
+  using NullScreen = std::function<bool(const Tuple &)>;
+
+  /**
+   * Builds a validity pre-screen for a comparison the kernel compiler rejected. A SQL
+   * comparison with a NULL input is never true, so probing the validity bitmap of each column
+   * operand -- one bit test per column, no Value construction and no type dispatch -- rejects
+   * a row before the interpreted Evaluate materializes its operands. On mostly-null optional
+   * columns the interpreted comparison then runs only over the values actually present; a
+   * varchar operand in particular never copies its payload for a row the bitmap rejects.
+   * @param expr the predicate; may be nullptr
+   * @param schema the schema of the tuples the screen will see; must outlive the screen
+   * @return the screen, or an empty function when the shape gives the bitmap no say
+   */
+  static NullScreen CompileNullScreen(const AbstractExpression *expr, const Schema *schema) {
+    const auto *cmp = dynamic_cast<const ComparisonExpression *>(expr);
+    if (cmp == nullptr) {
+      return {};
+    }
+    uint32_t cols[2];
+    size_t num_cols = 0;
+    for (size_t i = 0; i < 2; i++) {
+      const AbstractExpression *child = cmp->GetChildAt(i);
+      if (const auto *col_ref = dynamic_cast<const ColumnValueExpression *>(child); col_ref != nullptr) {
+        cols[num_cols++] = col_ref->GetColIdx();
+        continue;
+      }
+      if (const auto *constant = dynamic_cast<const ConstantValueExpression *>(child); constant != nullptr) {
+        if (constant->Evaluate(nullptr, nullptr).IsNull()) {
+          // The comparison is false for every row, whatever the columns hold.
+          return [](const Tuple &) { return true; };
+        }
+        continue;
+      }
+      // A computed operand could be non-null over null inputs; the row must reach Evaluate.
+      return {};
+    }
+    if (num_cols == 0) {
+      return {};
+    }
+    if (num_cols == 1) {
+      uint32_t col = cols[0];
+      return [schema, col](const Tuple &t) { return t.IsNull(schema, col); };
+    }
+    uint32_t lhs = cols[0];
+    uint32_t rhs = cols[1];
+    return [schema, lhs, rhs](const Tuple &t) { return t.IsNull(schema, lhs) || t.IsNull(schema, rhs); };
+  }
+
+  /** Swaps the operand order of a comparison: a OP b == b Mirror(OP) a. */
+  static ComparisonType Mirror(ComparisonType op) {
+    switch (op) {
+      case ComparisonType::LessThan:
+        return ComparisonType::GreaterThan;
+      case ComparisonType::LessThanOrEqual:
+        return ComparisonType::GreaterThanOrEqual;
+      case ComparisonType::GreaterThan:
+        return ComparisonType::LessThan;
+      case ComparisonType::GreaterThanOrEqual:
+        return ComparisonType::LessThanOrEqual;
+      default:
+        return op;
+    }
+  }
+
+ private:
+  /** One classified comparison operand: an integer column's type and offset, or a folded constant. */
+  struct Operand {
+    bool ok{false};
+    bool is_column{false};
+    TypeId type{TypeId::INVALID};
+    uint32_t offset{0};
+    bool is_null{false};
+    int64_t word{0};
+  };
+
+  /** Classifies an operand; ok stays false for anything the kernels cannot handle. */
+  static Operand ClassifyOperand(const AbstractExpression *expr, const Schema *schema) {
+    Operand operand;
+    if (const auto *col_ref = dynamic_cast<const ColumnValueExpression *>(expr); col_ref != nullptr) {
+      const Column &col = schema->GetColumn(col_ref->GetColIdx());
+      switch (col.GetType()) {
+        case TypeId::TINYINT:
+        case TypeId::SMALLINT:
+        case TypeId::INTEGER:
+        case TypeId::BIGINT:
+          operand.ok = true;
+          operand.is_column = true;
+          operand.type = col.GetType();
+          operand.offset = col.GetOffset();
+          break;
+        default:
+          break;
+      }
+      return operand;
+    }
+    if (const auto *constant = dynamic_cast<const ConstantValueExpression *>(expr); constant != nullptr) {
+      Value val = constant->Evaluate(nullptr, nullptr);
+      if (val.IsNull()) {
+        operand.ok = true;
+        operand.is_null = true;
+        return operand;
+      }
+      switch (val.GetTypeId()) {
+        case TypeId::TINYINT:
+          operand.ok = true;
+          operand.word = val.GetAs<int8_t>();
+          break;
+        case TypeId::SMALLINT:
+          operand.ok = true;
+          operand.word = val.GetAs<int16_t>();
+          break;
+        case TypeId::INTEGER:
+          operand.ok = true;
+          operand.word = val.GetAs<int32_t>();
+          break;
+        case TypeId::BIGINT:
+          operand.ok = true;
+          operand.word = val.GetAs<int64_t>();
+          break;
+        default:
+          break;
+      }
+      return operand;
+    }
+    return operand;
+  }
+
+  /** The null sentinel the type system stores for T, see type/limits.h. */
+  template <typename T>
+  static constexpr T NullSentinel() {
+    if constexpr (std::is_same_v<T, int8_t>) {
+      return BUSTUB_INT8_NULL;
+    } else if constexpr (std::is_same_v<T, int16_t>) {
+      return BUSTUB_INT16_NULL;
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+      return BUSTUB_INT32_NULL;
+    } else {
+      return BUSTUB_INT64_NULL;
+    }
+  }
+
+  /** The fully typed column-vs-column kernel; everything but the two offsets is compile time. */
+  template <typename L, typename R, typename Op>
+  static CompiledPredicate ColColKernel(uint32_t lhs_offset, uint32_t rhs_offset) {
+    return [lhs_offset, rhs_offset](const Tuple &t) {
+      L a;
+      R b;
+      memcpy(&a, t.GetData() + lhs_offset, sizeof(a));
+      memcpy(&b, t.GetData() + rhs_offset, sizeof(b));
+      return a != NullSentinel<L>() && b != NullSentinel<R>() &&
+             Op{}(static_cast<int64_t>(a), static_cast<int64_t>(b));
+    };
+  }
+
+  /** The fully typed column-vs-constant kernel; the constant is captured pre-widened. */
+  template <typename L, typename Op>
+  static CompiledPredicate ColConstKernel(uint32_t offset, int64_t constant) {
+    return [offset, constant](const Tuple &t) {
+      L a;
+      memcpy(&a, t.GetData() + offset, sizeof(a));
+      return a != NullSentinel<L>() && Op{}(static_cast<int64_t>(a), constant);
+    };
+  }
+
+  // The dispatch ladder below runs once per expression; each switch peels one runtime
+  // parameter into a template argument until the kernel instantiation is fully typed.
+
+  template <typename L, typename R>
+  static CompiledPredicate DispatchColColOp(uint32_t lhs_offset, uint32_t rhs_offset, ComparisonType op) {
+    switch (op) {
+      case ComparisonType::Equal:
+        return ColColKernel<L, R, std::equal_to<int64_t>>(lhs_offset, rhs_offset);
+      case ComparisonType::NotEqual:
+        return ColColKernel<L, R, std::not_equal_to<int64_t>>(lhs_offset, rhs_offset);
+      case ComparisonType::LessThan:
+        return ColColKernel<L, R, std::less<int64_t>>(lhs_offset, rhs_offset);
+      case ComparisonType::LessThanOrEqual:
+        return ColColKernel<L, R, std::less_equal<int64_t>>(lhs_offset, rhs_offset);
+      case ComparisonType::GreaterThan:
+        return ColColKernel<L, R, std::greater<int64_t>>(lhs_offset, rhs_offset);
+      case ComparisonType::GreaterThanOrEqual:
+        return ColColKernel<L, R, std::greater_equal<int64_t>>(lhs_offset, rhs_offset);
+      default:
+        return {};
+    }
+  }
+
+  template <typename L>
+  static CompiledPredicate DispatchColColRhs(uint32_t lhs_offset, const Operand &rhs, ComparisonType op) {
+    switch (rhs.type) {
+      case TypeId::TINYINT:
+        return DispatchColColOp<L, int8_t>(lhs_offset, rhs.offset, op);
+      case TypeId::SMALLINT:
+        return DispatchColColOp<L, int16_t>(lhs_offset, rhs.offset, op);
+      case TypeId::INTEGER:
+        return DispatchColColOp<L, int32_t>(lhs_offset, rhs.offset, op);
+      case TypeId::BIGINT:
+        return DispatchColColOp<L, int64_t>(lhs_offset, rhs.offset, op);
+      default:
+        return {};
+    }
+  }
+
+  static CompiledPredicate DispatchColCol(const Operand &lhs, const Operand &rhs, ComparisonType op) {
+    switch (lhs.type) {
+      case TypeId::TINYINT:
+        return DispatchColColRhs<int8_t>(lhs.offset, rhs, op);
+      case TypeId::SMALLINT:
+        return DispatchColColRhs<int16_t>(lhs.offset, rhs, op);
+      case TypeId::INTEGER:
+        return DispatchColColRhs<int32_t>(lhs.offset, rhs, op);
+      case TypeId::BIGINT:
+        return DispatchColColRhs<int64_t>(lhs.offset, rhs, op);
+      default:
+        return {};
+    }
+  }
+
+  template <typename L>
+  static CompiledPredicate DispatchColConstOp(uint32_t offset, int64_t constant, ComparisonType op) {
+    switch (op) {
+      case ComparisonType::Equal:
+        return ColConstKernel<L, std::equal_to<int64_t>>(offset, constant);
+      case ComparisonType::NotEqual:
+        return ColConstKernel<L, std::not_equal_to<int64_t>>(offset, constant);
+      case ComparisonType::LessThan:
+        return ColConstKernel<L, std::less<int64_t>>(offset, constant);
+      case ComparisonType::LessThanOrEqual:
+        return ColConstKernel<L, std::less_equal<int64_t>>(offset, constant);
+      case ComparisonType::GreaterThan:
+        return ColConstKernel<L, std::greater<int64_t>>(offset, constant);
+      case ComparisonType::GreaterThanOrEqual:
+        return ColConstKernel<L, std::greater_equal<int64_t>>(offset, constant);
+      default:
+        return {};
+    }
+  }
+
+  static CompiledPredicate DispatchColConst(const Operand &col, int64_t constant, ComparisonType op) {
+    switch (col.type) {
+      case TypeId::TINYINT:
+        return DispatchColConstOp<int8_t>(col.offset, constant, op);
+      case TypeId::SMALLINT:
+        return DispatchColConstOp<int16_t>(col.offset, constant, op);
+      case TypeId::INTEGER:
+        return DispatchColConstOp<int32_t>(col.offset, constant, op);
+      case TypeId::BIGINT:
+        return DispatchColConstOp<int64_t>(col.offset, constant, op);
+      default:
+        return {};
+    }
+  }
+
+  /** The constant-folding compare used when both sides are constants. */
+  static bool CompareWords(int64_t a, int64_t b, ComparisonType op) {
+    switch (op) {
+      case ComparisonType::Equal:
+        return a == b;
+      case ComparisonType::NotEqual:
+        return a != b;
+      case ComparisonType::LessThan:
+        return a < b;
+      case ComparisonType::LessThanOrEqual:
+        return a <= b;
+      case ComparisonType::GreaterThan:
+        return a > b;
+      case ComparisonType::GreaterThanOrEqual:
+        return a >= b;
+      default:
+        return false;
+    }
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_output_stager.h
+//
+// Identification: src/include/execution/join_output_stager.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/column_value_expression.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * JoinOutputStager lays out a join's output row straight from the two source rows' bytes. The
+ * generic path evaluates every output column expression over the pair -- a virtual EvaluateJoin
+ * and a Value per column, then the value constructor's per-column serialization -- even though
+ * a join's output columns are almost always plain column references. The stager resolves each
+ * reference once, at construction, to a (side, source offset, width) copy slot; staging a row
+ * is then one memcpy per column out of the source tuples plus a bit transplant between the
+ * validity bitmaps. Inlined columns copy their full-width slot unconditionally, null sentinel
+ * and all, so only varlen columns branch on nullness at all.
+ *
+ * Viable() is false when any output column computes something -- the caller keeps the
+ * expression path for those plans, so staging is strictly an optimization.
+ */
+class JoinOutputStager {
+ public:
+  /**
+   * Compiles the copy plan for a join's output. All three schemas must outlive the stager.
+   * @param out_schema the join's output schema; its column expressions are inspected
+   * @param left_schema schema of the build-side rows
+   * @param right_schema schema of the probe-side rows
+   */
+  JoinOutputStager(const Schema *out_schema, const Schema *left_schema, const Schema *right_schema)
+      : fixed_length_(out_schema->GetLength()), bitmap_size_(Tuple::NullBitmapSize(out_schema)) {
+    slots_.reserve(out_schema->GetColumnCount());
+    for (uint32_t i = 0; i < out_schema->GetColumnCount(); i++) {
+      const Column &out_col = out_schema->GetColumn(i);
+      const auto *col_ref = dynamic_cast<const ColumnValueExpression *>(out_col.GetExpr());
+      if (col_ref == nullptr) {
+        return;
+      }
+      const Schema *src_schema = col_ref->GetTupleIdx() == 0 ? left_schema : right_schema;
+      const Column &src_col = src_schema->GetColumn(col_ref->GetColIdx());
+      if (src_col.GetType() != out_col.GetType()) {
+        return;
+      }
+      slots_.push_back(CopySlot{col_ref->GetTupleIdx() == 0, src_col.GetOffset(), col_ref->GetColIdx(),
+                                out_col.GetOffset(), out_col.IsInlined() ? out_col.GetFixedLength() : 0});
+    }
+    left_bitmap_size_ = Tuple::NullBitmapSize(left_schema);
+    right_bitmap_size_ = Tuple::NullBitmapSize(right_schema);
+    viable_ = true;
+  }
+
+  /** @return true if every output column resolved to a copy slot and staging may be used */
+  bool Viable() const { return viable_; }
+
+  /**
+   * Materializes one output row from a matching pair; a drop-in for evaluating the output
+   * schema's expressions over it.
+   * @param left the build-side row
+   * @param right the probe-side row
+   * @return the staged output tuple
+   */
+  Tuple Stage(const Tuple &left, const Tuple &right) const {
+    const char *left_bitmap = left.GetData() + left.GetLength() - left_bitmap_size_;
+    const char *right_bitmap = right.GetData() + right.GetLength() - right_bitmap_size_;
+    // Size pass: fixed section, surviving varlen payloads, trailing bitmap.
+    uint32_t size = fixed_length_ + bitmap_size_;
+    for (const CopySlot &slot : slots_) {
+      if (slot.width_ != 0) {
+        continue;
+      }
+      const char *src = slot.from_left_ ? left.GetData() : right.GetData();
+      const char *bitmap = slot.from_left_ ? left_bitmap : right_bitmap;
+      if ((bitmap[slot.src_col_ / 8] & (1U << (slot.src_col_ % 8))) == 0) {
+        uint32_t payload_offset = *reinterpret_cast<const uint32_t *>(src + slot.src_offset_);
+        size += *reinterpret_cast<const uint32_t *>(src + payload_offset) + sizeof(uint32_t);
+      }
+    }
+    Tuple tuple;
+    char *data = tuple.ResizeData(size);
+    std::memset(data, 0, size);
+    char *out_bitmap = data + size - bitmap_size_;
+    uint32_t offset = fixed_length_;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(slots_.size()); i++) {
+      const CopySlot &slot = slots_[i];
+      const char *src = slot.from_left_ ? left.GetData() : right.GetData();
+      const char *bitmap = slot.from_left_ ? left_bitmap : right_bitmap;
+      char null_bit = static_cast<char>((bitmap[slot.src_col_ / 8] >> (slot.src_col_ % 8)) & 1);
+      out_bitmap[i / 8] |= static_cast<char>(null_bit << (i % 8));
+      if (slot.width_ != 0) {
+        // The source slot holds the sentinel when null, so the copy needs no branch.
+        std::memcpy(data + slot.out_offset_, src + slot.src_offset_, slot.width_);
+        continue;
+      }
+      if (null_bit == 0) {
+        uint32_t payload_offset = *reinterpret_cast<const uint32_t *>(src + slot.src_offset_);
+        uint32_t payload_size = *reinterpret_cast<const uint32_t *>(src + payload_offset) + sizeof(uint32_t);
+        *reinterpret_cast<uint32_t *>(data + slot.out_offset_) = offset;
+        std::memcpy(data + offset, src + payload_offset, payload_size);
+        offset += payload_size;
+      }
+    }
+    return tuple;
+  }
+
+ private:
+  /** One output column's resolved copy: its source side, slot, and destination. */
+  struct CopySlot {
+    bool from_left_;
+    uint32_t src_offset_;
+    uint32_t src_col_;
+    uint32_t out_offset_;
+    /** Fixed width of the column, 0 meaning varlen. */
+    uint32_t width_;
+  };
+
+  /** Length of the output's fixed-width section, where the varlen tail begins. */
+  uint32_t fixed_length_;
+  /** Size in bytes of the output's trailing null bitmap. */
+  uint32_t bitmap_size_;
+  /** Bitmap sizes of the source schemas, for locating their validity bits. */
+  uint32_t left_bitmap_size_{0};
+  uint32_t right_bitmap_size_{0};
+  /** Per-output-column copy slots, in output schema order; complete only when viable_. */
+  std::vector<CopySlot> slots_;
+  /** True when every output column resolved to a plain column reference. */
+  bool viable_{false};
+};
+
+}  // namespace bustub
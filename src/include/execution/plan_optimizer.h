@@ -0,0 +1,335 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// plan_optimizer.h
+//
+// Identification: src/include/execution/plan_optimizer.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "catalog/simple_catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/delete_plan.h"
+#include "execution/plans/exchange_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/insert_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/update_plan.h"
+
+namespace bustub {
+
+/**
+ * PlanOptimizer is a lightweight cost-based pass over a plan tree, run between plan
+ * construction and ExecutorFactory::CreateExecutor. It walks the tree bottom-up, estimates
+ * each node's output cardinality from the statistics collected by the catalog's last
+ * Analyze, and rewrites any hash join whose build side (the left child, by convention) is
+ * estimated larger than its probe side -- a wrong build side costs memory and partitioning
+ * passes, not just cycles. A join chain is handled by the same rule applied at every level:
+ * estimates propagate up through the rewritten joins, so each join in the chain builds on
+ * its cheaper input. Joins are never re-associated across levels -- that would re-derive
+ * every intermediate schema -- and nothing is rewritten where statistics are missing, so
+ * a plan over unanalyzed tables passes through untouched.
+ *
+ * Rewritten plan nodes, flipped expressions, and re-derived schemas are owned by the
+ * optimizer, which must therefore outlive the executors running the returned plan.
+ */
+class PlanOptimizer {
+ public:
+  /** Cardinality returned for a subtree that no statistics cover. */
+  static constexpr size_t UNKNOWN_CARDINALITY = static_cast<size_t>(-1);
+
+  explicit PlanOptimizer(SimpleCatalog *catalog) : catalog_(catalog) {}
+
+  /**
+   * Optimizes a plan tree.
+   * @param plan the root of the tree to optimize
+   * @return the optimized root: the input itself if nothing changed, otherwise a rewritten
+   * tree owned by this optimizer
+   */
+  const AbstractPlanNode *Optimize(const AbstractPlanNode *plan) {
+    if (plan == nullptr) {
+      return nullptr;
+    }
+    switch (plan->GetType()) {
+      case PlanType::HashJoin:
+        return OptimizeHashJoin(static_cast<const HashJoinPlanNode *>(plan));
+      case PlanType::Aggregation: {
+        auto *agg = static_cast<const AggregationPlanNode *>(plan);
+        const AbstractPlanNode *child = Optimize(agg->GetChildPlan());
+        if (child == agg->GetChildPlan()) {
+          return plan;
+        }
+        std::vector<const AbstractExpression *> group_bys(agg->GetGroupBys());
+        std::vector<const AbstractExpression *> aggregates(agg->GetAggregates());
+        std::vector<AggregationType> agg_types(agg->GetAggregateTypes());
+        return Own(std::make_unique<AggregationPlanNode>(agg->OutputSchema(), child, agg->GetHaving(),
+                                                         std::move(group_bys), std::move(aggregates),
+                                                         std::move(agg_types), agg->IsParallel()));
+      }
+      case PlanType::Sort: {
+        auto *sort = static_cast<const SortPlanNode *>(plan);
+        const AbstractPlanNode *child = Optimize(sort->GetChildPlan());
+        if (child == sort->GetChildPlan()) {
+          return plan;
+        }
+        std::vector<const AbstractExpression *> order_bys(sort->GetOrderBys());
+        std::vector<bool> descending;
+        descending.reserve(order_bys.size());
+        for (uint32_t i = 0; i < order_bys.size(); i++) {
+          descending.push_back(sort->IsDescending(i));
+        }
+        return Own(std::make_unique<SortPlanNode>(sort->OutputSchema(), child, std::move(order_bys),
+                                                  std::move(descending), sort->GetBufferCapacity()));
+      }
+      case PlanType::Limit: {
+        auto *limit = static_cast<const LimitPlanNode *>(plan);
+        const AbstractPlanNode *child = Optimize(limit->GetChildPlan());
+        if (child == limit->GetChildPlan()) {
+          return plan;
+        }
+        return Own(std::make_unique<LimitPlanNode>(limit->OutputSchema(), child, limit->GetLimit()));
+      }
+      case PlanType::Exchange: {
+        auto *exchange = static_cast<const ExchangePlanNode *>(plan);
+        const AbstractPlanNode *child = Optimize(exchange->GetChildPlan());
+        if (child == exchange->GetChildPlan()) {
+          return plan;
+        }
+        return Own(std::make_unique<ExchangePlanNode>(exchange->OutputSchema(), child));
+      }
+      case PlanType::IndexJoin: {
+        auto *join = static_cast<const IndexJoinPlanNode *>(plan);
+        const AbstractPlanNode *outer = Optimize(join->GetOuterPlan());
+        if (outer == join->GetOuterPlan()) {
+          return plan;
+        }
+        std::vector<const AbstractExpression *> outer_keys(join->GetOuterKeys());
+        return Own(std::make_unique<IndexJoinPlanNode>(join->OutputSchema(), outer, join->Predicate(),
+                                                       join->GetInnerTableOid(), join->GetIndex(),
+                                                       std::move(outer_keys)));
+      }
+      case PlanType::Insert: {
+        auto *insert = static_cast<const InsertPlanNode *>(plan);
+        if (insert->IsRawInsert()) {
+          return plan;
+        }
+        const AbstractPlanNode *child = Optimize(insert->GetChildPlan());
+        if (child == insert->GetChildPlan()) {
+          return plan;
+        }
+        return Own(std::make_unique<InsertPlanNode>(child, insert->TableOid()));
+      }
+      case PlanType::Update: {
+        auto *update = static_cast<const UpdatePlanNode *>(plan);
+        const AbstractPlanNode *child = Optimize(update->GetChildPlan());
+        if (child == update->GetChildPlan()) {
+          return plan;
+        }
+        std::unordered_map<uint32_t, UpdateInfo> update_attrs(update->GetUpdateAttrs());
+        return Own(std::make_unique<UpdatePlanNode>(child, update->TableOid(), std::move(update_attrs)));
+      }
+      case PlanType::Delete: {
+        auto *del = static_cast<const DeletePlanNode *>(plan);
+        const AbstractPlanNode *child = Optimize(del->GetChildPlan());
+        if (child == del->GetChildPlan()) {
+          return plan;
+        }
+        return Own(std::make_unique<DeletePlanNode>(child, del->TableOid()));
+      }
+      default:
+        // Scans and raw inserts are leaves; there is nothing below them to rewrite.
+        return plan;
+    }
+  }
+
+  /**
+   * Estimates the number of tuples a subtree produces, from the catalog's statistics.
+   * @param plan the subtree to estimate
+   * @return the estimated cardinality, or UNKNOWN_CARDINALITY if no statistics cover it
+   */
+  size_t EstimateCardinality(const AbstractPlanNode *plan) {
+    switch (plan->GetType()) {
+      case PlanType::SeqScan: {
+        auto *scan = static_cast<const SeqScanPlanNode *>(plan);
+        const TableStats *stats = catalog_->GetStats(scan->GetTableOid());
+        if (stats == nullptr) {
+          return UNKNOWN_CARDINALITY;
+        }
+        return EstimateFilter(stats->row_count_, scan->GetPredicate(), stats);
+      }
+      case PlanType::IndexScan: {
+        auto *scan = static_cast<const IndexScanPlanNode *>(plan);
+        const TableStats *stats = catalog_->GetStats(scan->GetTableOid());
+        if (stats == nullptr) {
+          return UNKNOWN_CARDINALITY;
+        }
+        // A keyed scan reads some range of the table; without histograms, assume a third.
+        size_t base = scan->GetLowKeys().empty() ? stats->row_count_ : std::max<size_t>(1, stats->row_count_ / 3);
+        return EstimateFilter(base, scan->GetPredicate(), stats);
+      }
+      case PlanType::HashJoin: {
+        auto *join = static_cast<const HashJoinPlanNode *>(plan);
+        size_t left = EstimateCardinality(join->GetLeftPlan());
+        size_t right = EstimateCardinality(join->GetRightPlan());
+        if (left == UNKNOWN_CARDINALITY || right == UNKNOWN_CARDINALITY) {
+          return UNKNOWN_CARDINALITY;
+        }
+        // Assume a key/foreign-key equi-join: every row of the larger side matches once.
+        return std::max(left, right);
+      }
+      case PlanType::IndexJoin:
+        // Each outer row probes the index for its single match.
+        return EstimateCardinality(static_cast<const IndexJoinPlanNode *>(plan)->GetOuterPlan());
+      case PlanType::Aggregation: {
+        auto *agg = static_cast<const AggregationPlanNode *>(plan);
+        if (agg->GetGroupBys().empty()) {
+          return 1;
+        }
+        size_t child = EstimateCardinality(agg->GetChildPlan());
+        if (child == UNKNOWN_CARDINALITY) {
+          return UNKNOWN_CARDINALITY;
+        }
+        // No per-group statistics; assume grouping collapses an order of magnitude.
+        return std::max<size_t>(1, child / 10);
+      }
+      case PlanType::Limit: {
+        auto *limit = static_cast<const LimitPlanNode *>(plan);
+        return std::min(limit->GetLimit(), EstimateCardinality(limit->GetChildPlan()));
+      }
+      case PlanType::Sort:
+        return EstimateCardinality(static_cast<const SortPlanNode *>(plan)->GetChildPlan());
+      case PlanType::Exchange:
+        return EstimateCardinality(static_cast<const ExchangePlanNode *>(plan)->GetChildPlan());
+      case PlanType::Insert:
+        return 0;
+      default:
+        return UNKNOWN_CARDINALITY;
+    }
+  }
+
+ private:
+  /** Rewrites a hash join to build on its smaller input, recursing into both children. */
+  const AbstractPlanNode *OptimizeHashJoin(const HashJoinPlanNode *join) {
+    const AbstractPlanNode *left = Optimize(join->GetLeftPlan());
+    const AbstractPlanNode *right = Optimize(join->GetRightPlan());
+    size_t build = EstimateCardinality(left);
+    size_t probe = EstimateCardinality(right);
+    if (build == UNKNOWN_CARDINALITY || probe == UNKNOWN_CARDINALITY || build <= probe) {
+      if (left == join->GetLeftPlan() && right == join->GetRightPlan()) {
+        return join;
+      }
+      std::vector<const AbstractExpression *> left_keys(join->GetLeftKeys());
+      std::vector<const AbstractExpression *> right_keys(join->GetRightKeys());
+      return Own(std::make_unique<HashJoinPlanNode>(join->OutputSchema(),
+                                                    std::vector<const AbstractPlanNode *>{left, right},
+                                                    join->Predicate(), std::move(left_keys), std::move(right_keys)));
+    }
+    // Build on the smaller right side: children and key lists trade places. Keys evaluate
+    // against their own child's schema and move across unchanged, but the predicate and the
+    // output columns evaluate with EvaluateJoin, so their column references must flip sides.
+    std::vector<const AbstractExpression *> left_keys(join->GetRightKeys());
+    std::vector<const AbstractExpression *> right_keys(join->GetLeftKeys());
+    return Own(std::make_unique<HashJoinPlanNode>(FlipSchema(join->OutputSchema()),
+                                                  std::vector<const AbstractPlanNode *>{right, left},
+                                                  FlipSides(join->Predicate()), std::move(left_keys),
+                                                  std::move(right_keys)));
+  }
+
+  /** Applies a textbook selectivity guess for a scan predicate over a table's statistics. */
+  size_t EstimateFilter(size_t rows, const AbstractExpression *predicate, const TableStats *stats) {
+    if (predicate == nullptr) {
+      return rows;
+    }
+    if (auto *cmp = dynamic_cast<const ComparisonExpression *>(predicate)) {
+      auto *col = dynamic_cast<const ColumnValueExpression *>(cmp->GetChildAt(0));
+      if (col == nullptr) {
+        col = dynamic_cast<const ColumnValueExpression *>(cmp->GetChildAt(1));
+      }
+      if (col != nullptr && col->GetColIdx() < stats->columns_.size()) {
+        if (cmp->GetComparisonType() == ComparisonType::Equal) {
+          size_t ndv = std::max<size_t>(1, stats->columns_[col->GetColIdx()].ndv_);
+          return std::max<size_t>(1, rows / ndv);
+        }
+        // A one-sided range keeps a third of the rows, by the usual guess.
+        return std::max<size_t>(1, rows / 3);
+      }
+    }
+    return std::max<size_t>(1, rows / 2);
+  }
+
+  /** Returns an expression with every join-side column reference flipped to the other side. */
+  const AbstractExpression *FlipSides(const AbstractExpression *expr) {
+    if (expr == nullptr) {
+      return nullptr;
+    }
+    if (auto *col = dynamic_cast<const ColumnValueExpression *>(expr)) {
+      return Own(
+          std::make_unique<ColumnValueExpression>(1 - col->GetTupleIdx(), col->GetColIdx(), col->GetReturnType()));
+    }
+    if (auto *cmp = dynamic_cast<const ComparisonExpression *>(expr)) {
+      const AbstractExpression *lhs = FlipSides(cmp->GetChildAt(0));
+      const AbstractExpression *rhs = FlipSides(cmp->GetChildAt(1));
+      if (lhs == cmp->GetChildAt(0) && rhs == cmp->GetChildAt(1)) {
+        return expr;
+      }
+      return Own(std::make_unique<ComparisonExpression>(lhs, rhs, cmp->GetComparisonType()));
+    }
+    // Constants and aggregate references name no join side.
+    return expr;
+  }
+
+  /** Returns a join output schema with every column's expression flipped to the other side. */
+  const Schema *FlipSchema(const Schema *schema) {
+    std::vector<Column> columns;
+    columns.reserve(schema->GetColumnCount());
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      const Column &col = schema->GetColumn(i);
+      if (col.IsInlined()) {
+        columns.emplace_back(col.GetName(), col.GetType(), FlipSides(col.GetExpr()));
+      } else {
+        columns.emplace_back(col.GetName(), col.GetType(), col.GetVariableLength(), FlipSides(col.GetExpr()));
+      }
+    }
+    schemas_.push_back(std::make_unique<Schema>(columns));
+    return schemas_.back().get();
+  }
+
+  const AbstractPlanNode *Own(std::unique_ptr<AbstractPlanNode> plan) {
+    plans_.push_back(std::move(plan));
+    return plans_.back().get();
+  }
+
+  const AbstractExpression *Own(std::unique_ptr<AbstractExpression> expr) {
+    exprs_.push_back(std::move(expr));
+    return exprs_.back().get();
+  }
+
+  /** The catalog whose statistics drive the estimates. */
+  SimpleCatalog *catalog_;
+  /** Rewritten plan nodes; alive as long as the optimizer. */
+  std::vector<std::unique_ptr<AbstractPlanNode>> plans_;
+  /** Flipped expressions; alive as long as the optimizer. */
+  std::vector<std::unique_ptr<AbstractExpression>> exprs_;
+  /** Re-derived output schemas; alive as long as the optimizer. */
+  std::vector<std::unique_ptr<Schema>> schemas_;
+};
+
+}  // namespace bustub
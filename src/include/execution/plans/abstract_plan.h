@@ -20,7 +20,20 @@
 namespace bustub {
 
 /** PlanType represents the types of plans that we have in our system. */
-enum class PlanType { SeqScan, HashJoin, Insert, Aggregation };
+enum class PlanType {
+  SeqScan,
+  IndexScan,
+  HashJoin,
+  SortMergeJoin,
+  IndexJoin,
+  Insert,
+  Update,
+  Delete,
+  Aggregation,
+  Sort,
+  Limit,
+  Exchange
+};
 
 /**
  * AbstractPlanNode represents all the possible types of plan nodes in our system.
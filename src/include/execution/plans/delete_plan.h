@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// delete_plan.h
+//
+// Identification: src/include/execution/plans/delete_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "catalog/simple_catalog.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * DeletePlanNode identifies the rows of a table that should be deleted.
+ * The rows come from the single child plan, usually a (filtered) scan over the target table;
+ * only their RIDs matter, so any projection the child applies is irrelevant.
+ */
+class DeletePlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new delete plan node.
+   * @param child the child plan providing the rows to delete
+   * @param table_oid the identifier of the table to delete from
+   */
+  DeletePlanNode(const AbstractPlanNode *child, table_oid_t table_oid)
+      : AbstractPlanNode(nullptr, {child}), table_oid_(table_oid) {}
+
+  PlanType GetType() const override { return PlanType::Delete; }
+
+  /** @return the identifier of the table to delete from */
+  table_oid_t TableOid() const { return table_oid_; }
+
+  /** @return the child plan providing the rows to delete */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Delete should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+ private:
+  /** The table to delete from. */
+  table_oid_t table_oid_;
+};
+
+}  // namespace bustub
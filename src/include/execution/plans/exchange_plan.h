@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_plan.h
+//
+// Identification: src/include/execution/plans/exchange_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * ExchangePlanNode cuts its child off into a separate pipeline stage: the child runs on the
+ * shared worker pool and its batches flow to the parent through a bounded queue, so the stages
+ * below and above the exchange execute concurrently. The exchange passes tuples through
+ * unchanged; its output schema is its child's.
+ */
+class ExchangePlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new exchange plan node.
+   * @param output the output schema of this plan node
+   * @param child the child plan to run as a separate pipeline stage
+   */
+  ExchangePlanNode(const Schema *output, const AbstractPlanNode *child) : AbstractPlanNode(output, {child}) {}
+
+  PlanType GetType() const override { return PlanType::Exchange; }
+
+  /** @return the child plan providing tuples for the exchange */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Exchange expects exactly one child plan.");
+    return GetChildAt(0);
+  }
+};
+}  // namespace bustub
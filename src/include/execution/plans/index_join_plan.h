@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_join_plan.h
+//
+// Identification: src/include/execution/plans/index_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/simple_catalog.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+/**
+ * IndexJoinPlanNode represents an index nested-loop join: for every tuple of the outer child
+ * (index 0, the left side of the join), the inner table's index is probed with the outer key,
+ * so the inner side is never scanned or built into a hash table. By convention the outer child
+ * should be the smaller input.
+ */
+class IndexJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new index join plan node.
+   * @param output the output format of this join
+   * @param outer the outer child, probed once per tuple against the index
+   * @param predicate the join predicate, evaluated on top of each index match; may be nullptr
+   * @param inner_table_oid the table the index maps into
+   * @param index the inner table's index, keyed on the join columns
+   * @param outer_keys the outer-side key expressions, in the index key schema's column order
+   */
+  IndexJoinPlanNode(const Schema *output, const AbstractPlanNode *outer, const AbstractExpression *predicate,
+                    table_oid_t inner_table_oid, Index *index, std::vector<const AbstractExpression *> &&outer_keys)
+      : AbstractPlanNode(output, {outer}),
+        predicate_(predicate),
+        inner_table_oid_(inner_table_oid),
+        index_(index),
+        outer_keys_(std::move(outer_keys)) {}
+
+  PlanType GetType() const override { return PlanType::IndexJoin; }
+
+  /** @return the outer child of this join */
+  const AbstractPlanNode *GetOuterPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Index join expected to only have the outer child.");
+    return GetChildAt(0);
+  }
+
+  /** @return the predicate evaluated on top of each index match */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the identifier of the inner table */
+  table_oid_t GetInnerTableOid() const { return inner_table_oid_; }
+
+  /** @return the inner table's index on the join columns */
+  Index *GetIndex() const { return index_; }
+
+  /** @return the outer-side key expressions, in the index key schema's column order */
+  const std::vector<const AbstractExpression *> &GetOuterKeys() const { return outer_keys_; }
+
+ private:
+  /** The join predicate; index matches are additionally filtered through it when present. */
+  const AbstractExpression *predicate_;
+  /** The table the probed index maps into. */
+  table_oid_t inner_table_oid_;
+  /** The inner table's index on the join columns. */
+  Index *index_;
+  /** The outer-side key expressions used to form each probe key. */
+  std::vector<const AbstractExpression *> outer_keys_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_scan_plan.h
+//
+// Identification: src/include/execution/plans/index_scan_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/simple_catalog.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+/**
+ * IndexScanPlanNode identifies a table whose tuples should be fetched through an index probe
+ * rather than a full scan. The key expressions pin down the indexed columns by equality -- the
+ * probe resolves them in one ScanKey call -- and the optional predicate filters whatever the
+ * index returns, covering any non-indexed conditions of the original query.
+ *
+ * The second constructor builds a range scan instead: low and high key expressions bound the
+ * indexed columns inclusively on both ends, and the probe resolves them in one ScanRange call.
+ * Range scans require an order-preserving index (e.g. a B+ tree).
+ */
+class IndexScanPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new index scan plan node.
+   * @param output the output format of this scan plan node
+   * @param predicate the residual predicate; tuples are returned if predicate(tuple) = true or predicate = nullptr
+   * @param table_oid the identifier of the table the index maps into
+   * @param index the index to probe, keyed on the equality columns
+   * @param keys the probe key expressions, in the index key schema's column order; evaluated once
+   */
+  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, table_oid_t table_oid, Index *index,
+                    std::vector<const AbstractExpression *> &&keys)
+      : AbstractPlanNode(output, {}),
+        predicate_(predicate),
+        table_oid_(table_oid),
+        index_(index),
+        keys_(std::move(keys)) {}
+
+  /**
+   * Creates a new index range scan plan node.
+   * @param output the output format of this scan plan node
+   * @param predicate the residual predicate; tuples are returned if predicate(tuple) = true or predicate = nullptr
+   * @param table_oid the identifier of the table the index maps into
+   * @param index the index to probe; must support ScanRange
+   * @param low_keys the inclusive lower bound key expressions, in the index key schema's column order
+   * @param high_keys the inclusive upper bound key expressions, in the index key schema's column order
+   */
+  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, table_oid_t table_oid, Index *index,
+                    std::vector<const AbstractExpression *> &&low_keys,
+                    std::vector<const AbstractExpression *> &&high_keys)
+      : AbstractPlanNode(output, {}),
+        predicate_(predicate),
+        table_oid_(table_oid),
+        index_(index),
+        keys_(std::move(low_keys)),
+        high_keys_(std::move(high_keys)),
+        is_range_scan_(true) {}
+
+  PlanType GetType() const override { return PlanType::IndexScan; }
+
+  /** @return the residual predicate applied to the tuples the index returns */
+  const AbstractExpression *GetPredicate() const { return predicate_; }
+
+  /** @return the identifier of the table being scanned */
+  table_oid_t GetTableOid() const { return table_oid_; }
+
+  /** @return the index to probe */
+  Index *GetIndex() const { return index_; }
+
+  /** @return the probe key expressions, in the index key schema's column order */
+  const std::vector<const AbstractExpression *> &GetKeys() const { return keys_; }
+
+  /** @return true if this scan resolves a key range rather than an equality probe */
+  bool IsRangeScan() const { return is_range_scan_; }
+
+  /** @return the inclusive lower bound key expressions of a range scan */
+  const std::vector<const AbstractExpression *> &GetLowKeys() const { return keys_; }
+
+  /** @return the inclusive upper bound key expressions of a range scan */
+  const std::vector<const AbstractExpression *> &GetHighKeys() const { return high_keys_; }
+
+ private:
+  /** The residual predicate applied on top of the index matches. */
+  const AbstractExpression *predicate_;
+  /** The table whose tuples are fetched. */
+  table_oid_t table_oid_;
+  /** The index resolving the equality columns. */
+  Index *index_;
+  /** The probe key expressions; the lower bound for a range scan. */
+  std::vector<const AbstractExpression *> keys_;
+  /** The inclusive upper bound key expressions of a range scan. */
+  std::vector<const AbstractExpression *> high_keys_;
+  /** Whether this scan resolves a key range rather than an equality probe. */
+  bool is_range_scan_{false};
+};
+
+}  // namespace bustub
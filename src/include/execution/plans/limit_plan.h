@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// limit_plan.h
+//
+// Identification: src/include/execution/plans/limit_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+/**
+ * LimitPlanNode limits the number of tuples produced by its child. When the child is a
+ * SortPlanNode, the executor factory fuses the two into a Top-N executor that keeps a bounded
+ * heap instead of sorting the whole input.
+ */
+class LimitPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new limit plan node.
+   * @param output the output format of this limit plan node, by convention the child's schema
+   * @param child the child plan whose output should be limited
+   * @param limit the maximum number of tuples to produce
+   */
+  LimitPlanNode(const Schema *output, const AbstractPlanNode *child, size_t limit)
+      : AbstractPlanNode(output, {child}), limit_(limit) {}
+
+  PlanType GetType() const override { return PlanType::Limit; }
+
+  /** @return the child of this limit plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Limit expected to only have one child.");
+    return GetChildAt(0);
+  }
+
+  /** @return the maximum number of tuples to produce */
+  size_t GetLimit() const { return limit_; }
+
+ private:
+  /** The maximum number of tuples to produce. */
+  size_t limit_;
+};
+
+}  // namespace bustub
@@ -27,9 +27,12 @@ class SeqScanPlanNode : public AbstractPlanNode {
    * @param output the output format of this scan plan node
    * @param predicate the predicate to scan with, tuples are returned if predicate(tuple) = true or predicate = nullptr
    * @param table_oid the identifier of table to be scanned
+   * @param parallel if true, the executor splits the table into morsels and scans them on the
+   * shared thread pool; the order of the output tuples is then unspecified
    */
-  SeqScanPlanNode(const Schema *output, const AbstractExpression *predicate, table_oid_t table_oid)
-      : AbstractPlanNode(output, {}), predicate_{predicate}, table_oid_(table_oid) {}
+  SeqScanPlanNode(const Schema *output, const AbstractExpression *predicate, table_oid_t table_oid,
+                  bool parallel = false)
+      : AbstractPlanNode(output, {}), predicate_{predicate}, table_oid_(table_oid), parallel_(parallel) {}
 
   PlanType GetType() const override { return PlanType::SeqScan; }
 
@@ -39,11 +42,16 @@ class SeqScanPlanNode : public AbstractPlanNode {
   /** @return the identifier of the table that should be scanned */
   table_oid_t GetTableOid() const { return table_oid_; }
 
+  /** @return true if the scan should run in parallel over morsels of the table */
+  bool IsParallel() const { return parallel_; }
+
  private:
   /** The predicate that all returned tuples must satisfy. */
   const AbstractExpression *predicate_;
   /** The table whose tuples should be scanned. */
   table_oid_t table_oid_;
+  /** Whether the scan should be executed in parallel. */
+  bool parallel_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_merge_join_plan.h
+//
+// Identification: src/include/execution/plans/sort_merge_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/plans/abstract_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * SortMergeJoinPlanNode joins two children that already deliver their tuples ordered ascending
+ * on the join keys — a Sort node, or any other order-preserving source. The executor merges the
+ * two streams without building a hash table, so an equi-join over pre-sorted inputs costs no
+ * extra memory beyond the current key group.
+ */
+class SortMergeJoinPlanNode : public AbstractPlanNode {
+ public:
+  SortMergeJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                        const AbstractExpression *predicate, std::vector<const AbstractExpression *> &&left_keys,
+                        std::vector<const AbstractExpression *> &&right_keys)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        predicate_(predicate),
+        left_keys_(std::move(left_keys)),
+        right_keys_(std::move(right_keys)) {}
+
+  PlanType GetType() const override { return PlanType::SortMergeJoin; }
+
+  /** @return the predicate evaluated on each key-equal pair; nullptr joins on key equality alone */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the left plan node, which must produce tuples ordered ascending on the left keys */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Sort-merge joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node, which must produce tuples ordered ascending on the right keys */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Sort-merge joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+  /** @return the left join keys, most significant first */
+  const std::vector<const AbstractExpression *> &GetLeftKeys() const { return left_keys_; }
+
+  /** @return the right join keys, most significant first */
+  const std::vector<const AbstractExpression *> &GetRightKeys() const { return right_keys_; }
+
+ private:
+  /** The join predicate applied on top of key equality. */
+  const AbstractExpression *predicate_;
+  /** The left child's join keys. */
+  std::vector<const AbstractExpression *> left_keys_;
+  /** The right child's join keys. */
+  std::vector<const AbstractExpression *> right_keys_;
+};
+
+}  // namespace bustub
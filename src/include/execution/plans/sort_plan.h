@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_plan.h
+//
+// Identification: src/include/execution/plans/sort_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+/**
+ * SortPlanNode orders the tuples of its child by a list of key expressions. The output schema
+ * is the child's output schema; sorting does not project.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new sort plan node.
+   * @param output the output format of this sort plan node, by convention the child's schema
+   * @param child the child plan whose tuples should be sorted
+   * @param order_bys the key expressions to order by, most significant first
+   * @param descending per-key direction flags; an empty vector sorts every key ascending
+   * @param buffer_capacity the number of tuples the executor may sort in memory before it
+   * spills sorted runs and finishes with an external merge
+   */
+  SortPlanNode(const Schema *output, const AbstractPlanNode *child,
+               std::vector<const AbstractExpression *> &&order_bys, std::vector<bool> &&descending = {},
+               size_t buffer_capacity = DEFAULT_BUFFER_CAPACITY)
+      : AbstractPlanNode(output, {child}),
+        order_bys_(std::move(order_bys)),
+        descending_(std::move(descending)),
+        buffer_capacity_(buffer_capacity) {}
+
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  /** @return the child of this sort plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Sort expected to only have one child.");
+    return GetChildAt(0);
+  }
+
+  /** @return the key expressions to order by, most significant first */
+  const std::vector<const AbstractExpression *> &GetOrderBys() const { return order_bys_; }
+
+  /** @return true if the idx'th key sorts descending */
+  bool IsDescending(uint32_t idx) const { return idx < descending_.size() && descending_[idx]; }
+
+  /** @return the number of tuples the executor may hold in memory at once */
+  size_t GetBufferCapacity() const { return buffer_capacity_; }
+
+ private:
+  /** The default in-memory sort buffer size, in tuples. */
+  static constexpr size_t DEFAULT_BUFFER_CAPACITY = 1 << 14;
+
+  /** The key expressions to order by. */
+  std::vector<const AbstractExpression *> order_bys_;
+  /** Per-key direction flags, parallel to order_bys_; empty means all ascending. */
+  std::vector<bool> descending_;
+  /** The in-memory sort buffer size, in tuples. */
+  size_t buffer_capacity_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// update_plan.h
+//
+// Identification: src/include/execution/plans/update_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <unordered_map>
+#include <utility>
+
+#include "catalog/simple_catalog.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** How an updated column's new value is derived from its old one. */
+enum class UpdateType { Add, Set };
+
+/**
+ * One column's update: either add a constant to the old integer value or overwrite it.
+ */
+struct UpdateInfo {
+  UpdateInfo(UpdateType type, int update_val) : type_(type), update_val_(update_val) {}
+  /** How the new value is derived. */
+  UpdateType type_;
+  /** The operand: the addend for Add, the new value for Set. */
+  int update_val_;
+};
+
+/**
+ * UpdatePlanNode identifies the rows of a table that should be updated and how.
+ * The rows come from the single child plan, usually a (filtered) scan over the target table;
+ * only their RIDs matter, since the executor re-reads each row from the table before applying
+ * the per-column updates.
+ */
+class UpdatePlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new update plan node.
+   * @param child the child plan providing the rows to update
+   * @param table_oid the identifier of the table to update
+   * @param update_attrs the per-column updates, keyed by column index in the table schema
+   */
+  UpdatePlanNode(const AbstractPlanNode *child, table_oid_t table_oid,
+                 std::unordered_map<uint32_t, UpdateInfo> &&update_attrs)
+      : AbstractPlanNode(nullptr, {child}), table_oid_(table_oid), update_attrs_(std::move(update_attrs)) {}
+
+  PlanType GetType() const override { return PlanType::Update; }
+
+  /** @return the identifier of the table to update */
+  table_oid_t TableOid() const { return table_oid_; }
+
+  /** @return the per-column updates, keyed by column index */
+  const std::unordered_map<uint32_t, UpdateInfo> &GetUpdateAttrs() const { return update_attrs_; }
+
+  /** @return the child plan providing the rows to update */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Update should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+ private:
+  /** The table to update. */
+  table_oid_t table_oid_;
+  /** The per-column updates, keyed by column index in the table schema. */
+  std::unordered_map<uint32_t, UpdateInfo> update_attrs_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,195 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// result_cursor.h
+//
+// Identification: src/include/execution/result_cursor.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "execution/executor_factory.h"
+
+namespace bustub {
+
+/**
+ * A pull-based cursor that streams a plan's results to its consumer at constant memory.
+ * The executor tree runs on a dedicated producer thread and hands finished tuples over in
+ * batches through a bounded ring; when the consumer falls behind, the producer blocks on the
+ * full ring instead of buffering, so a gigabyte result set pipelines to the client holding at
+ * most CURSOR_RING_BATCHES * CURSOR_BATCH_SIZE tuples plus whatever the operators themselves
+ * buffer. Tuples are deep-copied into the ring -- an executor's output may be a view into a
+ * page only pinned until its next call, and the consumer reads on another thread.
+ *
+ * Next pulls one tuple at a time, like driving an executor directly; it returns false once
+ * the plan is exhausted and rethrows on the consumer thread any exception the tree raised.
+ * Closing (or destroying) the cursor before exhaustion stops the producer at its next batch
+ * boundary. Not thread-safe on the consumer side: one thread pulls.
+ */
+class ResultCursor {
+ public:
+  /** Tuples handed over per ring slot; full slots amortize the handoff latch. */
+  static constexpr size_t CURSOR_BATCH_SIZE = 256;
+  /** Ring capacity in batches; small, since it only needs to hide consumer jitter. */
+  static constexpr size_t CURSOR_RING_BATCHES = 4;
+
+  /**
+   * Creates a cursor over the given plan and starts producing immediately.
+   * @param exec_ctx the executor context to run the plan under
+   * @param plan the plan whose results the cursor streams
+   * @param ring_batches the ring capacity in batches, e.g. 1 to force lockstep in tests
+   */
+  ResultCursor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan,
+               size_t ring_batches = CURSOR_RING_BATCHES)
+      : ring_batches_(std::max<size_t>(1, ring_batches)) {
+    executor_ = ExecutorFactory::CreateExecutor(exec_ctx, plan);
+    producer_ = std::thread([this] { Produce(); });
+  }
+
+  DISALLOW_COPY_AND_MOVE(ResultCursor);
+
+  ~ResultCursor() { Close(); }
+
+  /**
+   * Pulls the next result tuple, blocking while the ring is empty and the plan is not done.
+   * @param[out] tuple the next tuple, owning its buffer
+   * @return true if a tuple was produced, false once the plan is exhausted or the cursor closed
+   */
+  bool Next(Tuple *tuple) {
+    if (pos_ == current_.size()) {
+      current_.clear();
+      pos_ = 0;
+      std::unique_lock<std::mutex> lock(latch_);
+      consumer_cv_.wait(lock, [this] { return !ring_.empty() || done_; });
+      if (ring_.empty()) {
+        if (error_ != nullptr) {
+          // The tree raised on the producer thread; surface it to the caller exactly once.
+          std::exception_ptr error = std::exchange(error_, nullptr);
+          lock.unlock();
+          std::rethrow_exception(error);
+        }
+        return false;
+      }
+      current_ = std::move(ring_.front());
+      ring_.pop_front();
+      lock.unlock();
+      producer_cv_.notify_one();
+    }
+    *tuple = std::move(current_[pos_++]);
+    return true;
+  }
+
+  /**
+   * Stops the producer and joins it. The producer notices at its next batch handoff;
+   * idempotent, and run by the destructor for cursors abandoned mid-stream.
+   */
+  void Close() {
+    {
+      std::lock_guard<std::mutex> guard(latch_);
+      closed_ = true;
+    }
+    producer_cv_.notify_all();
+    if (producer_.joinable()) {
+      producer_.join();
+    }
+  }
+
+ private:
+  /** Runs the executor tree to exhaustion (or until closed), filling the ring. */
+  void Produce() {
+    std::vector<Tuple> batch;
+    batch.reserve(CURSOR_BATCH_SIZE);
+    try {
+      executor_->Init();
+      Tuple tuple;
+      while (executor_->Next(&tuple)) {
+        batch.push_back(OwnedCopy(tuple));
+        if (batch.size() == CURSOR_BATCH_SIZE && !PushBatch(&batch)) {
+          break;
+        }
+      }
+      if (!batch.empty()) {
+        PushBatch(&batch);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(latch_);
+      error_ = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> guard(latch_);
+      done_ = true;
+    }
+    consumer_cv_.notify_all();
+  }
+
+  /**
+   * Hands a full batch to the ring, blocking while it is at capacity.
+   * @return false if the cursor was closed, telling the producer to stop
+   */
+  bool PushBatch(std::vector<Tuple> *batch) {
+    std::unique_lock<std::mutex> lock(latch_);
+    producer_cv_.wait(lock, [this] { return ring_.size() < ring_batches_ || closed_; });
+    if (closed_) {
+      return false;
+    }
+    ring_.push_back(std::move(*batch));
+    lock.unlock();
+    consumer_cv_.notify_one();
+    batch->clear();
+    batch->reserve(CURSOR_BATCH_SIZE);
+    return true;
+  }
+
+  /** @return a tuple owning its buffer; a view (copying one would alias the page) is copied out */
+  static Tuple OwnedCopy(Tuple &tuple) {
+    if (tuple.IsAllocated()) {
+      return tuple;
+    }
+    Tuple owned;
+    owned.rid_ = tuple.rid_;
+    memcpy(owned.ResizeData(tuple.size_), tuple.data_, tuple.size_);
+    return owned;
+  }
+
+  /** The executor tree this cursor streams, driven only by the producer thread. */
+  std::unique_ptr<AbstractExecutor> executor_;
+  /** Ring capacity in batches. */
+  size_t ring_batches_;
+  /** Guards the ring and the done/closed/error flags. */
+  std::mutex latch_;
+  /** Signaled when a batch arrives or the producer finishes. */
+  std::condition_variable consumer_cv_;
+  /** Signaled when a ring slot frees up or the cursor closes. */
+  std::condition_variable producer_cv_;
+  /** The bounded handoff ring, oldest batch at the front. */
+  std::deque<std::vector<Tuple>> ring_;
+  /** Set once the producer has pushed its last batch (or died); guarded by latch_. */
+  bool done_{false};
+  /** Set by Close to stop the producer; guarded by latch_. */
+  bool closed_{false};
+  /** The exception the tree raised, if any, rethrown by Next; guarded by latch_. */
+  std::exception_ptr error_;
+  /** The batch the consumer is currently draining, consumer thread only. */
+  std::vector<Tuple> current_;
+  /** Position in current_, consumer thread only. */
+  size_t pos_{0};
+  /** The producer thread; started by the constructor, joined by Close. */
+  std::thread producer_;
+};
+
+}  // namespace bustub
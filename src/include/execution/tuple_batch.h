@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch carries up to BATCH_SIZE tuples between executors, amortizing the virtual Next()
+ * dispatch over a whole batch instead of paying it per row. Downstream operators iterate the
+ * batch with plain indexed loops, which also gives expression evaluation a tight kernel to
+ * vectorize over.
+ */
+class TupleBatch {
+ public:
+  /** Tuples produced per NextBatch call; sized so a batch of small tuples stays cache-resident. */
+  static constexpr size_t BATCH_SIZE = 1024;
+
+  TupleBatch() { tuples_.reserve(BATCH_SIZE); }
+
+  /** Appends a tuple to the batch. */
+  void Add(Tuple tuple) { tuples_.emplace_back(std::move(tuple)); }
+
+  /**
+   * Copies tuple bytes straight out of a page into the batch arena and appends a non-owning
+   * view over them. Survivors of a page scan land back to back in memory with no per-tuple
+   * heap allocation; the views stay valid until the batch is cleared or destroyed.
+   */
+  void AddFromPage(const RID &rid, const char *data, uint32_t size) {
+    char *dest = ArenaAlloc(size);
+    memcpy(dest, data, size);
+    Tuple view;
+    view.rid_ = rid;
+    view.size_ = size;
+    view.data_ = dest;
+    tuples_.emplace_back(view);
+  }
+
+  /** @return the tuple at the given index */
+  Tuple &Get(size_t i) { return tuples_[i]; }
+
+  /** @return the number of tuples currently in the batch */
+  size_t Size() const { return tuples_.size(); }
+
+  /** @return true if the batch holds no tuples */
+  bool Empty() const { return tuples_.empty(); }
+
+  /** @return true once the batch has reached BATCH_SIZE tuples */
+  bool Full() const { return tuples_.size() >= BATCH_SIZE; }
+
+  /** Empties the batch for reuse; keeps the allocations, including arena chunks. */
+  void Clear() {
+    tuples_.clear();
+    arena_chunk_ = 0;
+    arena_used_ = 0;
+  }
+
+  /** @return iterator support so batches work in range-for loops */
+  std::vector<Tuple>::iterator begin() { return tuples_.begin(); }  // NOLINT
+  std::vector<Tuple>::iterator end() { return tuples_.end(); }     // NOLINT
+
+ private:
+  /** Arena chunk size; a tuple always fits one chunk because tuples never exceed a page. */
+  static constexpr size_t ARENA_CHUNK_SIZE = 4096;
+
+  /** Bump-allocates space for one tuple's bytes, reusing chunks retained across Clear calls. */
+  char *ArenaAlloc(uint32_t size) {
+    BUSTUB_ASSERT(size <= ARENA_CHUNK_SIZE, "Tuples cannot be larger than a page.");
+    if (arena_chunk_ >= arena_.size() || arena_used_ + size > ARENA_CHUNK_SIZE) {
+      if (arena_chunk_ + 1 < arena_.size()) {
+        arena_chunk_++;
+      } else {
+        arena_.emplace_back(new char[ARENA_CHUNK_SIZE]);
+        arena_chunk_ = arena_.size() - 1;
+      }
+      arena_used_ = 0;
+    }
+    char *dest = arena_[arena_chunk_].get() + arena_used_;
+    arena_used_ += size;
+    return dest;
+  }
+
+  std::vector<Tuple> tuples_;
+  /** Backing storage for AddFromPage views; chunk pointers are stable as the batch grows. */
+  std::vector<std::unique_ptr<char[]>> arena_;
+  size_t arena_chunk_{0};
+  size_t arena_used_{0};
+};
+
+}  // namespace bustub
@@ -12,6 +12,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/transaction_manager.h"
 #include "recovery/log_manager.h"
@@ -19,7 +26,9 @@
 namespace bustub {
 
 /**
- * CheckpointManager creates consistent checkpoints by blocking all other transactions temporarily.
+ * CheckpointManager creates consistent checkpoints by blocking all other transactions temporarily
+ * (BeginCheckpoint/EndCheckpoint), or fuzzy ones that only pause transactions long enough to
+ * snapshot the active-txn and dirty-page tables (TakeFuzzyCheckpoint).
  */
 class CheckpointManager {
  public:
@@ -29,15 +38,80 @@ class CheckpointManager {
         log_manager_(log_manager),
         buffer_pool_manager_(buffer_pool_manager) {}
 
-  ~CheckpointManager() = default;
+  ~CheckpointManager() { StopCheckpointThread(); }
 
   void BeginCheckpoint();
   void EndCheckpoint();
 
+  /**
+   * Fuzzy checkpoint: briefly blocks transactions to snapshot the active-transaction table and
+   * the buffer pool's dirty-page table into a CHECKPOINT log record, then resumes them before
+   * doing the expensive work — flushing the snapshotted pages and forcing the WAL. Begin/Commit
+   * only stall for the snapshot, not for the page writes. A non-zero flush_pacing sleeps that
+   * long between page writes, spreading the checkpoint's I/O instead of issuing it as one burst.
+   */
+  void TakeFuzzyCheckpoint(std::chrono::microseconds flush_pacing = std::chrono::microseconds::zero());
+
+  /**
+   * Starts the adaptive scheduler thread. Every checkpoint_poll_interval it measures the WAL
+   * bytes written since the last checkpoint — the redo work a restart would have to replay —
+   * and the buffer pool's dirty-frame ratio, and takes a fuzzy checkpoint once either crosses
+   * its budget. The checkpoint's page writes are paced, and the pacing tightens the further a
+   * signal is past its budget, so flush I/O ramps with pressure instead of arriving as the
+   * periodic cliff a timer-driven checkpoint produces.
+   */
+  void RunCheckpointThread();
+
+  /** Stops and joins the scheduler thread. */
+  void StopCheckpointThread();
+
+  /** Sets the WAL bytes a restart may have to replay before a checkpoint is forced. */
+  void SetWalByteBudget(size_t bytes) { wal_byte_budget_ = bytes; }
+
+  /** Sets the dirty-frame fraction of the pool that forces a checkpoint. */
+  void SetDirtyFrameThreshold(double ratio) { dirty_frame_threshold_ = ratio; }
+
+  /** Sets the baseline gap between a scheduled checkpoint's page writes. */
+  void SetFlushPacing(std::chrono::microseconds pacing) { flush_pacing_ = pacing; }
+
+  /** @return checkpoints the scheduler thread has taken, for tests and diagnostics */
+  size_t GetScheduledCheckpoints() const { return scheduled_checkpoints_.load(); }
+
+  /**
+   * Streams a consistent backup of the database into backup_file without dragging pages
+   * through the buffer pool. A fuzzy checkpoint first puts every page its snapshot saw dirty
+   * on disk, the data files are then copied with the disk manager's below-the-pool sequential
+   * reads, and finally the WAL is forced and the live log segments are copied. Writes that
+   * race the data copy are covered by the copied log tail, so opening the backup as a
+   * database replays it to a consistent state through the normal restart recovery path.
+   * @param disk_manager the disk manager whose files are backed up
+   * @param backup_file the destination database file name
+   * @return true if every file was copied whole
+   */
+  bool TakeBackup(DiskManager *disk_manager, const std::string &backup_file);
+
  private:
-  TransactionManager *transaction_manager_ __attribute__((__unused__));
-  LogManager *log_manager_ __attribute__((__unused__));
-  BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+  /**
+   * How far the hottest trigger signal is past its budget, as a fraction: 1.0 means a signal
+   * just crossed, 2.0 means one is at double its budget. Below 1.0 no checkpoint is due.
+   */
+  double CheckpointUrgency();
+
+  TransactionManager *transaction_manager_;
+  LogManager *log_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+
+  /** WAL bytes already flushed when the last checkpoint was taken; the replay baseline. */
+  size_t last_checkpoint_wal_bytes_{0};
+  size_t wal_byte_budget_{CHECKPOINT_WAL_BYTE_BUDGET};
+  double dirty_frame_threshold_{CHECKPOINT_DIRTY_FRAME_RATIO};
+  std::chrono::microseconds flush_pacing_{500};
+
+  std::atomic<bool> scheduler_running_{false};
+  std::atomic<size_t> scheduled_checkpoints_{0};
+  std::thread *checkpoint_thread_{nullptr};
+  std::mutex scheduler_latch_;
+  std::condition_variable scheduler_cv_;
 };
 
 }  // namespace bustub
@@ -14,22 +14,31 @@
 
 #include <algorithm>
 #include <condition_variable>  // NOLINT
-#include <future>              // NOLINT
-#include <mutex>               // NOLINT
-
+#include <functional>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "common/rwlatch.h"
 #include "recovery/log_record.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
 
+class Transaction;
+
 /**
  * LogManager maintains a separate thread that is awakened whenever the log buffer is full or whenever a timeout
  * happens. When the thread is awakened, the log buffer's content is written into the disk log file.
  */
 class LogManager {
  public:
+  // next_lsn_ starts at 1 so a zero-filled (never written) page's lsn field of 0 always compares
+  // older than any real record during recovery.
   explicit LogManager(DiskManager *disk_manager)
-      : next_lsn_(0), persistent_lsn_(INVALID_LSN), disk_manager_(disk_manager) {
+      : next_lsn_(1), persistent_lsn_(INVALID_LSN), disk_manager_(disk_manager) {
     log_buffer_ = new char[LOG_BUFFER_SIZE];
     flush_buffer_ = new char[LOG_BUFFER_SIZE];
   }
@@ -46,13 +55,98 @@ class LogManager {
 
   lsn_t AppendLogRecord(LogRecord *log_record);
 
+  /**
+   * Serialize a log record into the transaction's local staging buffer instead of the shared log
+   * buffer. Only the lsn assignment touches shared state (one fetch_add); the copy is private to
+   * the transaction, so per-record synchronization disappears. Staged records reach the shared
+   * buffer in one batch via PublishStagedLog, which the transaction manager calls at commit/abort,
+   * or earlier here when the staging buffer grows large.
+   * @param log_record the record to stage; its lsn is assigned here
+   * @param txn the transaction staging the record
+   * @return the lsn assigned to the record
+   */
+  lsn_t StageLogRecord(LogRecord *log_record, Transaction *txn);
+
+  /**
+   * Copy the transaction's staged log records into the shared log buffer in one reservation and
+   * clear the staging buffer. Must precede any WaitForFlush for the transaction's records.
+   * @param txn the transaction whose staged records should be published
+   */
+  void PublishStagedLog(Transaction *txn);
+
+  /**
+   * Publish every transaction's staged records. The buffer pool calls this before writing out a
+   * page whose lsn is past the durable lsn: the records behind that lsn may still sit in a private
+   * staging buffer, and the WAL rule says they must reach the log before the page reaches disk.
+   */
+  void PublishAllStaged();
+
+  /**
+   * Group commit: block until every log record up to and including the given lsn is on disk.
+   * Committing transactions park here instead of forcing their own flush; the flush thread
+   * covers all parked transactions with one DiskManager::WriteLog and wakes them together.
+   * @param lsn the lsn the caller needs persisted
+   */
+  void WaitForFlush(lsn_t lsn);
+
+  /**
+   * A log consumer receives every flushed extent right after it reaches disk: a pointer into
+   * the flush buffer (valid only for the duration of the call — send or copy before returning),
+   * the extent's size, its logical byte offset in the log, and the last lsn it covers. Extents
+   * arrive in offset order with no gaps. The call runs on the flush thread before group-commit
+   * waiters wake, so a sink that has seen offset X holds every log byte behind any commit the
+   * primary has reported durable; keep consumers short (a socket send or a queue hand-off), as
+   * they sit on the commit path.
+   */
+  using LogConsumer = std::function<void(const char *data, int size, int start_offset, lsn_t end_lsn)>;
+
+  /**
+   * Registers a consumer for flushed log extents, e.g. a replication sender feeding a standby's
+   * LogReceiver.
+   * @param consumer the callback to invoke per flushed extent
+   * @return a handle for UnregisterLogConsumer
+   */
+  size_t RegisterLogConsumer(LogConsumer consumer) {
+    std::lock_guard<std::mutex> guard(consumers_latch_);
+    log_consumers_[next_consumer_id_] = std::move(consumer);
+    return next_consumer_id_++;
+  }
+
+  /** Removes a registered consumer. Once this returns no further call to it is in flight. */
+  void UnregisterLogConsumer(size_t handle) {
+    std::lock_guard<std::mutex> guard(consumers_latch_);
+    log_consumers_.erase(handle);
+  }
+
+  /**
+   * Hand WAL segments that lie entirely before the given logical byte offset back to the disk
+   * manager's recycled pool. Driven by the checkpoint manager once the log before a checkpoint is
+   * no longer needed for recovery.
+   * @param live_offset logical offset of the first log byte that must be kept
+   */
+  void RecycleOldSegments(int live_offset) { disk_manager_->RecycleLogSegments(live_offset); }
+
+  /** @return the number of log bytes written to disk so far */
+  inline int GetFlushedBytes() { return flushed_bytes_; }
+
   inline lsn_t GetNextLSN() { return next_lsn_; }
   inline lsn_t GetPersistentLSN() { return persistent_lsn_; }
   inline void SetPersistentLSN(lsn_t lsn) { persistent_lsn_ = lsn; }
   inline char *GetLogBuffer() { return log_buffer_; }
 
  private:
-  // TODO(students): you may add your own member variables
+  /**
+   * Swap the append buffer with the flush buffer and write it out, then wake group-commit
+   * waiters and blocked appenders. Called only from the flush thread.
+   */
+  void SwapAndFlush();
+
+  /** Serializes a log record (header plus type-specific payload) at the given position. */
+  void SerializeLogRecord(LogRecord *log_record, char *pos);
+
+  /** Copies already-serialized record bytes into the shared log buffer, with the same
+   * reservation/retry protocol as AppendLogRecord. size must be smaller than LOG_BUFFER_SIZE. */
+  void AppendRawBytes(const char *data, int size);
 
   /** The atomic counter which records the next log sequence number. */
   std::atomic<lsn_t> next_lsn_;
@@ -62,13 +156,44 @@ class LogManager {
   char *log_buffer_;
   char *flush_buffer_;
 
+  /** Bytes reserved in log_buffer_. Appenders claim their slot with one fetch_add; a value past
+   * LOG_BUFFER_SIZE means the buffer is sealed until the flush thread swaps it out. */
+  std::atomic<int> offset_{0};
+  /** End of the valid data in a sealed buffer: the reservation offset of the first appender that
+   * overflowed. Written inside that appender's shared section, read under the exclusive swap. */
+  std::atomic<int> sealed_bytes_{0};
+  /** Set when an appender fills the buffer or a committer needs a flush now. */
+  std::atomic<bool> need_flush_{false};
+
+  /** Total log bytes handed to the disk manager; the logical offset where the next flush lands. */
+  std::atomic<int> flushed_bytes_{0};
+
+  /** Held shared while appenders copy into log_buffer_, exclusive during the buffer swap, so
+   * concurrent appenders only serialize against the swap, not against each other. */
+  ReaderWriterLatch buffer_latch_;
+
   std::mutex latch_;
 
-  std::thread *flush_thread_ __attribute__((__unused__));
+  /** Transactions that currently hold staged records, so PublishAllStaged can find them. A
+   * transaction must publish (commit or abort does this) before its object is destroyed. */
+  std::unordered_set<Transaction *> staging_txns_;
+  std::mutex staging_txns_latch_;
+
+  /** Flushed-extent consumers by registration handle; invoked in order from the flush thread. */
+  std::unordered_map<size_t, LogConsumer> log_consumers_;
+  std::mutex consumers_latch_;
+  size_t next_consumer_id_{0};
+
+  std::thread *flush_thread_ = nullptr;
 
+  /** Wakes the flush thread (buffer full, commit waiting, or shutdown). */
   std::condition_variable cv_;
+  /** Wakes appenders that found the log buffer full. */
+  std::condition_variable append_cv_;
+  /** Wakes group-commit waiters when persistent_lsn_ advances. */
+  std::condition_variable flush_cv_;
 
-  DiskManager *disk_manager_ __attribute__((__unused__));
+  DiskManager *disk_manager_;
 };
 
 }  // namespace bustub
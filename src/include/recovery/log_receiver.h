@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_receiver.h
+//
+// Identification: src/include/recovery/log_receiver.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+#include "recovery/log_recovery.h"
+
+namespace bustub {
+
+/**
+ * Standby-side endpoint for shipped log extents. The primary's registered LogConsumer — a
+ * socket sender in a real deployment, a direct call in tests — delivers every flushed extent
+ * here. Receive copies the extent off the primary's flush buffer and returns immediately; the
+ * apply side then lands the bytes in the standby's own WAL (so the standby can restart from
+ * its copy alone) and replays them with LogRecovery::Redo, which resumes from its previous
+ * stopping point. The standby thus tracks the primary at sequential-log speed, and a final
+ * ApplyPending followed by the usual Undo promotes it to a consistent primary.
+ */
+class LogReceiver {
+ public:
+  LogReceiver(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager)
+      : disk_manager_(disk_manager), log_recovery_(disk_manager, buffer_pool_manager) {}
+
+  ~LogReceiver() { StopApplyThread(); }
+
+  DISALLOW_COPY(LogReceiver);
+
+  /**
+   * Accepts one shipped extent. Safe to call from the primary's flush thread: the bytes are
+   * copied into the pending queue and the call returns without touching the standby's disk.
+   * Duplicate extents (a sender's resend) are dropped; an extent past a gap is dropped with a
+   * warning, since the standby cannot apply log it never received and needs a reseed.
+   * @param data the extent bytes; only read during the call
+   * @param size the extent's size in bytes
+   * @param start_offset the extent's logical byte offset in the primary's log
+   */
+  void Receive(const char *data, int size, int start_offset);
+
+  /**
+   * Drains the pending queue: appends every queued extent to the standby's WAL, then replays
+   * the new log through LogRecovery::Redo. Called by the apply thread, or directly by a test
+   * or a failover sequence that needs the standby caught up now.
+   */
+  void ApplyPending();
+
+  /** Starts the apply thread, which drains the queue as extents arrive. */
+  void RunApplyThread();
+
+  /** Stops and joins the apply thread, draining whatever the last round left behind. */
+  void StopApplyThread();
+
+  /** Forwards to LogRecovery::RegisterIndex; must precede the first apply of index records. */
+  void RegisterIndex(uint32_t index_oid, Index *index) { log_recovery_.RegisterIndex(index_oid, index); }
+
+  /** @return log bytes landed in the standby's WAL and replayed so far */
+  int GetAppliedBytes() {
+    std::lock_guard<std::mutex> guard(apply_latch_);
+    return applied_bytes_;
+  }
+
+ private:
+  DiskManager *disk_manager_;
+  LogRecovery log_recovery_;
+
+  /** Extents received but not yet written to the standby WAL, in log order. */
+  std::deque<std::vector<char>> pending_;
+  /** The primary log offset the next extent must start at; detects duplicates and gaps. */
+  int next_offset_{0};
+  std::mutex latch_;
+  /** Wakes the apply thread when an extent arrives. */
+  std::condition_variable apply_cv_;
+
+  /** Serializes ApplyPending calls: Redo keeps cross-call state and must not run twice at once. */
+  std::mutex apply_latch_;
+  int applied_bytes_{0};
+
+  std::atomic<bool> apply_running_{false};
+  std::thread *apply_thread_{nullptr};
+};
+
+}  // namespace bustub
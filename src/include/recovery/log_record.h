@@ -14,6 +14,8 @@
 
 #include <cassert>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "storage/table/tuple.h"
@@ -32,6 +34,14 @@ enum class LogRecordType {
   ABORT,
   /** Creating a new page in the table heap. */
   NEWPAGE,
+  /** Fuzzy checkpoint: snapshot of the active-transaction and dirty-page tables. */
+  CHECKPOINT,
+  /** One physiological record covering a run of inserts into the same page. */
+  INSERTBATCH,
+  /** Logical index operation: the key was inserted into the index named by its oid. */
+  INDEXINSERT,
+  /** Logical index operation: the key was removed from the index named by its oid. */
+  INDEXDELETE,
 };
 
 /**
@@ -57,6 +67,14 @@ enum class LogRecordType {
  *--------------------------
  * | HEADER | prev_page_id |
  *--------------------------
+ * For insert batch type log record (all rids name the same page)
+ *------------------------------------------------------------------------
+ * | HEADER | count | rid_1 | size_1 | data_1 | ... | rid_n | size_n | data_n |
+ *------------------------------------------------------------------------
+ * For index insert/delete type log record (logical: key and heap rid, no page ids)
+ *------------------------------------------------------------
+ * | HEADER | index_oid | key_size | key_data | tuple_rid |
+ *------------------------------------------------------------
  */
 class LogRecord {
   friend class LogManager;
@@ -69,44 +87,93 @@ class LogRecord {
   LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type)
       : size_(HEADER_SIZE), txn_id_(txn_id), prev_lsn_(prev_lsn), log_record_type_(log_record_type) {}
 
-  // constructor for INSERT/DELETE type
+  // constructor for INSERT/DELETE type. The record keeps a reference to the caller's tuple
+  // rather than a copy: every mutation record is serialized into the log buffer within the
+  // call that builds it, so the tuple image is written straight from the source row and the
+  // copy-into-the-record is skipped. The record must not outlive the referenced tuple.
   LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, const RID &rid, const Tuple &tuple)
       : txn_id_(txn_id), prev_lsn_(prev_lsn), log_record_type_(log_record_type) {
     if (log_record_type == LogRecordType::INSERT) {
       insert_rid_ = rid;
-      insert_tuple_ = tuple;
+      insert_ref_ = &tuple;
     } else {
       assert(log_record_type == LogRecordType::APPLYDELETE || log_record_type == LogRecordType::MARKDELETE ||
              log_record_type == LogRecordType::ROLLBACKDELETE);
       delete_rid_ = rid;
-      delete_tuple_ = tuple;
+      delete_ref_ = &tuple;
     }
     // calculate log record size
     size_ = HEADER_SIZE + sizeof(RID) + sizeof(int32_t) + tuple.GetLength();
   }
 
-  // constructor for UPDATE type
+  // constructor for UPDATE type; references both images, see the INSERT/DELETE constructor
   LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, const RID &update_rid,
             const Tuple &old_tuple, const Tuple &new_tuple)
       : txn_id_(txn_id),
         prev_lsn_(prev_lsn),
         log_record_type_(log_record_type),
         update_rid_(update_rid),
-        old_tuple_(old_tuple),
-        new_tuple_(new_tuple) {
+        old_ref_(&old_tuple),
+        new_ref_(&new_tuple) {
     // calculate log record size
     size_ = HEADER_SIZE + sizeof(RID) + old_tuple.GetLength() + new_tuple.GetLength() + 2 * sizeof(int32_t);
   }
 
   // constructor for NEWPAGE type
-  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, page_id_t page_id)
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, page_id_t prev_page_id,
+            page_id_t page_id)
       : size_(HEADER_SIZE),
         txn_id_(txn_id),
         prev_lsn_(prev_lsn),
         log_record_type_(log_record_type),
-        prev_page_id_(page_id) {
+        prev_page_id_(prev_page_id),
+        page_id_(page_id) {
     // calculate log record size
-    size_ = HEADER_SIZE + sizeof(page_id_t);
+    size_ = HEADER_SIZE + 2 * sizeof(page_id_t);
+  }
+
+  // constructor for INSERTBATCH type: one record for a run of inserts into the same page,
+  // staged once per page instead of once per row. References every row image like the
+  // INSERT/DELETE constructor; the record must not outlive the referenced tuples.
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, std::vector<RID> rids,
+            std::vector<const Tuple *> tuples)
+      : txn_id_(txn_id),
+        prev_lsn_(prev_lsn),
+        log_record_type_(log_record_type),
+        batch_rids_(std::move(rids)),
+        batch_refs_(std::move(tuples)) {
+    assert(log_record_type == LogRecordType::INSERTBATCH);
+    // calculate log record size
+    size_ = HEADER_SIZE + sizeof(uint32_t);
+    for (const Tuple *tuple : batch_refs_) {
+      size_ += sizeof(RID) + sizeof(int32_t) + tuple->GetLength();
+    }
+  }
+
+  // constructor for INDEXINSERT/INDEXDELETE type: a logical index operation, identified by
+  // the catalog's index oid rather than page ids since the container is free to move pairs
+  // around. References the caller's key like the INSERT/DELETE constructor.
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, uint32_t index_oid, const Tuple &key,
+            const RID &rid)
+      : txn_id_(txn_id),
+        prev_lsn_(prev_lsn),
+        log_record_type_(log_record_type),
+        index_oid_(index_oid),
+        index_rid_(rid),
+        index_key_ref_(&key) {
+    assert(log_record_type == LogRecordType::INDEXINSERT || log_record_type == LogRecordType::INDEXDELETE);
+    // calculate log record size
+    size_ = HEADER_SIZE + sizeof(uint32_t) + sizeof(int32_t) + key.GetLength() + sizeof(RID);
+  }
+
+  // constructor for CHECKPOINT type; a checkpoint belongs to no transaction
+  LogRecord(std::vector<txn_id_t> active_txns, std::vector<page_id_t> dirty_pages)
+      : log_record_type_(LogRecordType::CHECKPOINT),
+        checkpoint_active_txns_(std::move(active_txns)),
+        checkpoint_dirty_pages_(std::move(dirty_pages)) {
+    // calculate log record size
+    size_ = HEADER_SIZE + 2 * sizeof(uint32_t) + checkpoint_active_txns_.size() * sizeof(txn_id_t) +
+            checkpoint_dirty_pages_.size() * sizeof(page_id_t);
   }
 
   ~LogRecord() = default;
@@ -119,6 +186,22 @@ class LogRecord {
 
   inline page_id_t GetNewPageRecord() { return prev_page_id_; }
 
+  inline page_id_t GetNewPageId() { return page_id_; }
+
+  inline const std::vector<RID> &GetBatchRids() { return batch_rids_; }
+
+  inline const std::vector<Tuple> &GetBatchTuples() { return batch_tuples_; }
+
+  inline uint32_t GetIndexOid() { return index_oid_; }
+
+  inline Tuple &GetIndexKey() { return index_key_tuple_; }
+
+  inline RID &GetIndexRID() { return index_rid_; }
+
+  inline const std::vector<txn_id_t> &GetCheckpointActiveTxns() { return checkpoint_active_txns_; }
+
+  inline const std::vector<page_id_t> &GetCheckpointDirtyPages() { return checkpoint_dirty_pages_; }
+
   inline int32_t GetSize() { return size_; }
 
   inline lsn_t GetLSN() { return lsn_; }
@@ -164,8 +247,35 @@ class LogRecord {
   Tuple old_tuple_;
   Tuple new_tuple_;
 
+  // Write-path references set by the mutation constructors: serialization reads the tuple
+  // images through these, falling back to the owned tuples above, which recovery deserializes
+  // into. Never set on a recovered record.
+  const Tuple *delete_ref_{nullptr};
+  const Tuple *insert_ref_{nullptr};
+  const Tuple *old_ref_{nullptr};
+  const Tuple *new_ref_{nullptr};
+
   // case4: for new page opeartion
   page_id_t prev_page_id_{INVALID_PAGE_ID};
+  // the id of the page that was created (serialized after prev_page_id_ so redo knows the target)
+  page_id_t page_id_{INVALID_PAGE_ID};
+
+  // case7: for logical index operations; the key image flows through index_key_ref_ on the
+  // write path like the other mutation records, recovery deserializes into index_key_tuple_
+  uint32_t index_oid_{0};
+  RID index_rid_;
+  Tuple index_key_tuple_;
+  const Tuple *index_key_ref_{nullptr};
+
+  // case5: for checkpoint operation; serialized as count + ids for each table
+  std::vector<txn_id_t> checkpoint_active_txns_;
+  std::vector<page_id_t> checkpoint_dirty_pages_;
+
+  // case6: for batch insert; parallel rid/row-image vectors, all rids on one page.
+  // batch_refs_ is the write path's view of the rows; recovery deserializes into batch_tuples_.
+  std::vector<RID> batch_rids_;
+  std::vector<const Tuple *> batch_refs_;
+  std::vector<Tuple> batch_tuples_;
   static const int HEADER_SIZE = 20;
 };  // namespace bustub
 
@@ -14,7 +14,10 @@
 
 #include <algorithm>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/lock_manager.h"
@@ -22,6 +25,8 @@
 
 namespace bustub {
 
+class Index;
+
 /**
  * Read log file from disk, redo and undo.
  */
@@ -41,7 +46,47 @@ class LogRecovery {
   void Undo();
   bool DeserializeLogRecord(const char *data, LogRecord *log_record);
 
+  /**
+   * Registers an index as the redo/undo target for the logical INDEXINSERT/INDEXDELETE
+   * records carrying its oid, so its entries are restored at log-replay speed instead of by
+   * rescanning the whole heap. Must be called before Redo; records naming an unregistered
+   * oid are skipped, since that index's owner has chosen to rebuild it.
+   * @param index_oid the catalog oid the index logged its operations under
+   * @param index the index to replay into
+   */
+  void RegisterIndex(uint32_t index_oid, Index *index) { indexes_[index_oid] = index; }
+
  private:
+  /**
+   * Replays one tuple-level log record against its table page if the page's lsn is older.
+   * Safe to run concurrently with other records as long as no other thread touches the same page;
+   * Redo guarantees that by partitioning records by page id.
+   */
+  void RedoLogRecord(LogRecord *log_record);
+
+  /**
+   * Replays a NEWPAGE record: (re-)initializes the created page and links it behind its
+   * predecessor. Applied inline during the log scan because it touches two pages.
+   */
+  void RedoNewPage(LogRecord *log_record);
+
+  /** @return the id of the page a tuple-level record touches */
+  page_id_t TupleRecordPageId(LogRecord *log_record);
+
+  /**
+   * Replays (or, in the undo phase, reverts) one logical index record against its registered
+   * index. Both directions are idempotent: the container skips exact-duplicate inserts and a
+   * remove of an absent pair is a no-op.
+   * @param log_record the INDEXINSERT/INDEXDELETE record
+   * @param undo true to apply the record's inverse operation
+   */
+  void ApplyIndexRecord(LogRecord *log_record, bool undo);
+
+  /**
+   * Reads the on-disk lsn of every page the log touches with large sequential I/O, so Redo can
+   * drop records whose effects a flushed page image already holds without a buffer pool fetch.
+   */
+  std::unordered_map<page_id_t, lsn_t> ScanDiskLsns(const std::unordered_set<page_id_t> &touched_pages);
   DiskManager *disk_manager_ __attribute__((__unused__));
   BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
 
@@ -52,6 +97,8 @@ class LogRecovery {
 
   int offset_ __attribute__((__unused__));
   char *log_buffer_;
+  /** Redo/undo targets for logical index records, by the oid they logged under. */
+  std::unordered_map<uint32_t, Index *> indexes_;
 };
 
 }  // namespace bustub
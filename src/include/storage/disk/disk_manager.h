@@ -15,12 +15,60 @@
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
+#include <mutex>  // NOLINT
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 
 namespace bustub {
 
+/**
+ * A point-in-time snapshot of the disk manager's I/O latency histograms, collected so p99
+ * spikes can be attributed to the disk rather than guessed at from throughput counters.
+ * Bucket i counts operations whose duration d satisfied 2^i <= d < 2^(i+1), in cycles
+ * (nanoseconds on platforms without a cycle counter); the last bucket absorbs longer ones.
+ */
+struct IoLatencyStats {
+  /** Number of log-spaced latency buckets; 2^32 cycles is over a second on any modern part. */
+  static constexpr size_t LATENCY_HISTOGRAM_BUCKETS = 32;
+
+  /** Durations of single-page reads, including decompression and checksum verification. */
+  uint64_t read_page_cycles[LATENCY_HISTOGRAM_BUCKETS]{};
+  /** Durations of single-page writes, including compression of opted-in pages. */
+  uint64_t write_page_cycles[LATENCY_HISTOGRAM_BUCKETS]{};
+  /** Durations of log appends, including the fsync. */
+  uint64_t write_log_cycles[LATENCY_HISTOGRAM_BUCKETS]{};
+
+  /**
+   * @return an upper bound on the given percentile of a histogram, in cycles; 0 when the
+   * histogram is empty. The bound is the top of the bucket the percentile falls in, so it is
+   * accurate to a factor of two -- plenty to tell a 10us write from a 10ms one.
+   */
+  static uint64_t Percentile(const uint64_t (&histogram)[LATENCY_HISTOGRAM_BUCKETS], double p) {
+    uint64_t total = 0;
+    for (uint64_t count : histogram) {
+      total += count;
+    }
+    if (total == 0) {
+      return 0;
+    }
+    auto rank = static_cast<uint64_t>(p * static_cast<double>(total));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; ++i) {
+      seen += histogram[i];
+      if (seen > rank) {
+        return uint64_t{1} << (i + 1);
+      }
+    }
+    return uint64_t{1} << LATENCY_HISTOGRAM_BUCKETS;
+  }
+};
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
@@ -33,29 +81,59 @@ class DiskManager {
    */
   explicit DiskManager(const std::string &db_file);
 
-  ~DiskManager() = default;
+  /**
+   * Creates a disk manager that stripes pages across several database files, so the files can sit
+   * on different devices and their writes proceed in parallel. Page page_id lives in file
+   * page_id % db_files.size() at offset (page_id / db_files.size()) * PAGE_SIZE; AllocatePage
+   * hands out increasing ids, which walks the stripes round-robin. The log and warm-set sidecar
+   * files are derived from the first path.
+   * @param db_files the file names of the database stripe files, in stripe order
+   */
+  explicit DiskManager(const std::vector<std::string> &db_files);
+
+  virtual ~DiskManager() = default;
 
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
    * @param page_id id of the page
    * @param page_data raw page data
    */
-  void WritePage(page_id_t page_id, const char *page_data);
+  virtual void WritePage(page_id_t page_id, const char *page_data);
+
+  /**
+   * Write a batch of pages to the database file.
+   * The requests are sorted by stripe then page id, and runs of disk-adjacent pages are
+   * coalesced into single large sequential writes, so a checkpoint's dirty pages hit the disk
+   * as multi-page sequential I/O instead of random single-page writes.
+   * @param requests (page id, logical page image) pairs; reordered in place
+   */
+  virtual void WritePages(std::vector<std::pair<page_id_t, const char *>> *requests);
 
   /**
    * Read a page from the database file.
    * @param page_id id of the page
    * @param[out] page_data output buffer
    */
-  void ReadPage(page_id_t page_id, char *page_data);
+  virtual void ReadPage(page_id_t page_id, char *page_data);
+
+  /**
+   * Read a batch of pages from the database file.
+   * The requests are sorted by page id so the file is touched in one ascending pass, and runs of
+   * consecutive page ids are coalesced into a single read.
+   * @param requests (page id, output buffer) pairs; reordered in place
+   */
+  virtual void ReadPages(std::vector<std::pair<page_id_t, char *>> *requests);
 
   /**
    * Append a log entry to the log file.
+   * The log is stored as fixed-size, preallocated segment files; logical byte offset off lives in
+   * segment off / LOG_SEGMENT_SIZE. Preallocation means an append fsync never has to update the
+   * file-size metadata, and recycled segments are renamed into place instead of re-created.
    * @param log_data raw log data
    * @param size size of log entry
    */
@@ -65,23 +143,105 @@ class DiskManager {
    * Read a log entry from the log file.
    * @param[out] log_data output buffer
    * @param size size of the log entry
-   * @param offset offset of the log entry in the file
+   * @param offset logical offset of the log entry in the log
    * @return true if the read was successful, false otherwise
    */
   bool ReadLog(char *log_data, int size, int offset);
 
   /**
-   * Allocate a page on disk.
+   * Retire every log segment that lies entirely before the given logical offset, moving its file
+   * into a pool of preallocated segments that future log growth reuses instead of creating and
+   * zero-filling new files. Called after a checkpoint with the offset up to which the log is no
+   * longer needed. The pool only lives for this process; stray pool files are removed on startup.
+   * @param live_offset logical offset of the first byte that must be kept
+   */
+  void RecycleLogSegments(int live_offset);
+
+  /**
+   * Overwrite the warm-set sidecar file with the given page ids.
+   * The sidecar records which pages were resident in the buffer pool so a restart can prewarm.
+   * @param page_ids ids of the resident pages
+   */
+  void WriteWarmSet(const std::vector<page_id_t> &page_ids);
+
+  /**
+   * Read the page ids recorded in the warm-set sidecar file.
+   * @param[out] page_ids the recorded page ids
+   * @return true if a sidecar file was found and read
+   */
+  bool ReadWarmSet(std::vector<page_id_t> *page_ids);
+
+  /**
+   * Streams the database stripe files into a backup copy, reading below the buffer pool. The
+   * copy goes through a dedicated read handle opened with O_DIRECT where the filesystem allows
+   * it, in BACKUP_CHUNK_SIZE sequential chunks, so a full-file backup neither drags pages
+   * through FetchPage nor displaces the working set from the OS page cache. Stripe 0 lands at
+   * backup_file itself and stripe i at backup_file + "." + i; the free-list sidecar is saved
+   * first and copied along, so the backup opens as a complete database. Pages written while
+   * the copy runs may land before or after the reader passes them -- see
+   * CheckpointManager::TakeBackup for how the copied log tail makes the backup consistent.
+   * @param backup_file the destination database file name
+   * @return true if every file was copied whole
+   */
+  bool BackupDataFiles(const std::string &backup_file);
+
+  /**
+   * Streams the live log segment files alongside a data backup, with the same below-the-pool
+   * chunked reads. The destination names are derived from backup_file the way the constructor
+   * derives them from the database file name, so DiskManager(backup_file) finds the log.
+   * A segment recycled while the copy runs lies entirely before the live log and is skipped.
+   * @param backup_file the destination database file name the data files were backed up to
+   * @return true if every live segment was copied whole
+   */
+  bool BackupLogFiles(const std::string &backup_file);
+
+  /**
+   * Allocate a page on disk. Deallocated pages are reused before the file is grown, and the
+   * lowest free id is handed out first for locality.
    * @return the id of the allocated page
    */
   page_id_t AllocatePage();
 
   /**
-   * Deallocate a page on disk.
+   * Deallocate a page on disk, returning its id to the free list so a later AllocatePage can
+   * reuse the file space. The free list is persisted to a sidecar file on ShutDown.
    * @param page_id id of the page to deallocate
    */
   void DeallocatePage(page_id_t page_id);
 
+  /**
+   * Marks a page as belonging to a compressed table. Future writes of the page store an
+   * LZ4-style compressed image inside its slot and reads decompress it back into the frame.
+   * Tables opt in at creation time, so a page is marked when its heap allocates it -- before
+   * its first write -- and every on-disk image of it is compressed. The set of marked pages
+   * is persisted in the free-list sidecar so reads after a restart still decompress.
+   * @param page_id id of the page
+   */
+  void SetPageCompressed(page_id_t page_id);
+
+  /**
+   * @param page_id id of the page
+   * @return true iff the page has been marked compressed
+   */
+  bool IsPageCompressed(page_id_t page_id);
+
+  /**
+   * Turns I/O latency tracking on or off. Off (the default) costs nothing on the I/O paths
+   * beyond one relaxed flag load; on, each ReadPage/WritePage/WriteLog brackets its work with
+   * the cycle counter and bumps one relaxed atomic bucket, cheap enough to leave running on a
+   * production instance while a latency spike is being chased.
+   * @param enabled whether to record I/O latencies
+   */
+  void SetIoLatencyTracking(bool enabled) { io_latency_enabled_.store(enabled, std::memory_order_relaxed); }
+
+  /**
+   * Snapshots the I/O latency histograms, the disk-side companion of BufferPoolManager
+   * stats. Like those, the buckets are bumped with relaxed atomics, so a snapshot taken
+   * under load is consistent to within the operations in flight.
+   * @param[out] stats the snapshot to fill
+   */
+  void GetIoLatencyStats(IoLatencyStats *stats);
+
   /** @return the number of disk flushes */
   int GetNumFlushes() const;
 
@@ -91,6 +251,9 @@ class DiskManager {
   /** @return the number of disk writes */
   int GetNumWrites() const;
 
+  /** @return the number of page reads whose image failed checksum verification */
+  int GetNumChecksumMismatches() const;
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -100,19 +263,177 @@ class DiskManager {
   /** Checks if the non-blocking flush future was set. */
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
- private:
+ protected:
   int GetFileSize(const std::string &file_name);
-  // stream to write log file
+
+  /** @return the stream for the stripe file holding the given page */
+  std::fstream &StripeIo(page_id_t page_id);
+
+  /** @return the name of the stripe file holding the given page */
+  const std::string &StripeName(page_id_t page_id);
+
+  /** @return the byte offset of the given page within its stripe file */
+  size_t StripeOffset(page_id_t page_id) const;
+
+  /**
+   * Reads the free-list sidecar file, restoring the allocation high-water mark and the set of
+   * deallocated page ids. Skipped when the database file itself is missing or empty, so a stale
+   * sidecar from a deleted database cannot corrupt a fresh one.
+   */
+  void LoadFreeList();
+
+  /** Overwrites the free-list sidecar file with the current allocation state. */
+  void SaveFreeList();
+
+  /**
+   * Reads the checksum sidecar file into the page checksum table and opens the sidecar for
+   * appending, so verification covers pages written before the last restart -- the restart a
+   * torn page is discovered on is precisely the one after the crash that tore it. The journal
+   * is replayed last-record-wins; a fresh (or deleted) database truncates any stale sidecar.
+   */
+  void LoadPageChecksums();
+
+  /** Compacts the checksum sidecar to one record per page and closes the journal. */
+  void SavePageChecksums();
+
+  /** @return the file name of the given log segment; segment 0 keeps the plain .log name */
+  std::string LogSegmentName(int segment) const;
+
+  /**
+   * Points log_io_ at the given segment, taking a file from the recycled pool when one is
+   * available and creating (and zero-filling to LOG_SEGMENT_SIZE) a fresh one otherwise.
+   */
+  void OpenLogSegment(int segment);
+
+  /**
+   * Reads log bytes across segment boundaries without consulting the logical log size; bytes in
+   * missing or recycled segments come back zeroed.
+   */
+  void RawReadLog(char *log_data, int size, int offset);
+
+  /**
+   * Walks the record length prefixes from the start of the log to find where valid data ends, so
+   * appends after a restart continue at the right position inside the preallocated tail. The only
+   * record structure assumed here is the leading int32 length.
+   */
+  int FindLogEnd();
+
+  /**
+   * Builds the slot image to write for a page. For a compressed page the scratch buffer gets a
+   * CompressedPageHeader plus the compressed payload, zero-padded to an I/O-alignment multiple,
+   * and that many bytes of scratch should be written; for a raw page (not opted in, or an image
+   * that does not shrink) the page data itself should be written whole.
+   * @param page_id id of the page
+   * @param page_data the PAGE_SIZE page image
+   * @param scratch a PAGE_SIZE, I/O-aligned staging buffer for the compressed slot image
+   * @param[out] write_size the number of bytes to write from the returned buffer
+   * @return scratch when the slot is compressed, page_data otherwise
+   */
+  const char *EncodePageImage(page_id_t page_id, const char *page_data, char *scratch, size_t *write_size);
+
+  /**
+   * Decompresses a freshly read slot image in place, if the page is marked compressed and the
+   * slot carries a valid compressed image. A slot without the magic (e.g. a page allocated but
+   * never written) is left as-is; a slot with the magic but a malformed payload is zeroed and
+   * logged, mirroring how a short read yields a zeroed page.
+   * @param page_id id of the page
+   * @param page_data the PAGE_SIZE slot image, decompressed in place
+   */
+  void DecodePageImage(page_id_t page_id, char *page_data);
+
+  /**
+   * Records the CRC32-C checksum of a page image that was just written.
+   * @param page_id id of the page
+   * @param page_data the page image that was written
+   */
+  void RecordPageChecksum(page_id_t page_id, const char *page_data);
+
+  /**
+   * Verifies a page image that was just read against its recorded checksum, if any.
+   * A mismatch indicates a torn or corrupted page and is logged.
+   * @param page_id id of the page
+   * @param page_data the page image that was read
+   * @return false iff a recorded checksum exists and does not match
+   */
+  bool VerifyPageChecksum(page_id_t page_id, const char *page_data);
+
+  /**
+   * @return the cycle counter if latency tracking is on, 0 otherwise. A zero start makes the
+   * matching RecordIoLatency a no-op, so the I/O paths bracket themselves unconditionally.
+   */
+  uint64_t IoTimerStart() const;
+
+  /**
+   * Buckets the time elapsed since start into the given histogram; a no-op when start is 0
+   * (tracking was off when the operation began).
+   * @param histogram one of the latency histograms, LATENCY_HISTOGRAM_BUCKETS long
+   * @param start the IoTimerStart result bracketing the operation
+   */
+  void RecordIoLatency(std::atomic<uint64_t> *histogram, uint64_t start);
+
+  /**
+   * Copies src into dest with BACKUP_CHUNK_SIZE sequential reads through a private handle,
+   * O_DIRECT when the filesystem allows it so the copy bypasses the OS page cache. A handle
+   * whose direct reads are rejected restarts the copy buffered.
+   * @return true if src existed and was copied whole
+   */
+  static bool CopyFileStreamed(const std::string &src, const std::string &dest);
+
+  // stream to write log file (always positioned on segment cur_log_segment_)
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
+  // segment log_io_ currently points at
+  int cur_log_segment_ = 0;
+  // oldest segment still holding live log data; earlier ones have been recycled
+  int first_log_segment_ = 0;
+  // logical end of the log in bytes (valid data, not preallocated file size)
+  int log_size_ = 0;
+  // preallocated segment files retired by RecycleLogSegments, awaiting reuse
+  std::vector<std::string> recycled_segments_;
+  // names handed to pool files so far, so each gets a distinct one
+  int recycled_counter_ = 0;
+  // guards the recycled pool and first_log_segment_ (checkpoint thread vs. flush thread)
+  std::mutex log_segment_latch_;
+  // sidecar file recording the resident page set for warm restarts
+  std::string warm_set_name_;
+  // sidecar file persisting the free page list and allocation high-water mark
+  std::string free_list_name_;
+  // deallocated page ids available for reuse; ordered so allocation prefers low ids
+  std::set<page_id_t> free_pages_;
+  std::mutex free_list_latch_;
+  // stream to write db file (stripe 0 when striping across several files)
   std::fstream db_io_;
   std::string file_name_;
+  // stripe file names, in stripe order; stripe_names_[0] == file_name_
+  std::vector<std::string> stripe_names_;
+  // streams for stripes 1..n-1; stripe 0 goes through db_io_
+  std::vector<std::fstream> stripe_ios_;
+  // number of stripe files pages are spread across (1 = classic single-file layout)
+  size_t num_stripes_ = 1;
   std::atomic<page_id_t> next_page_id_;
   int num_flushes_;
-  int num_writes_;
+  // Atomic because the per-stripe writer threads in WritePages all count through it.
+  std::atomic<int> num_writes_;
   bool flush_log_;
   std::future<void> *flush_log_f_;
+  // Whether the I/O paths time themselves; see SetIoLatencyTracking.
+  std::atomic<bool> io_latency_enabled_{false};
+  // Log-spaced latency buckets, bumped with relaxed atomics on the I/O paths.
+  std::atomic<uint64_t> read_page_cycles_[IoLatencyStats::LATENCY_HISTOGRAM_BUCKETS] = {};
+  std::atomic<uint64_t> write_page_cycles_[IoLatencyStats::LATENCY_HISTOGRAM_BUCKETS] = {};
+  std::atomic<uint64_t> write_log_cycles_[IoLatencyStats::LATENCY_HISTOGRAM_BUCKETS] = {};
+  // CRC32-C checksum of the most recently written image of each page, used to detect torn pages.
+  std::unordered_map<page_id_t, uint32_t> page_checksums_;
+  std::mutex checksum_latch_;
+  // sidecar file journaling page checksums so torn-page detection survives a crash
+  std::string checksum_name_;
+  // reads whose page image did not match its recorded checksum
+  std::atomic<int> num_checksum_mismatches_{0};
+  // append handle to the checksum sidecar; each page write journals its fresh checksum
+  std::ofstream checksum_io_;
+  // pages whose slots hold compressed images; persisted alongside the free list
+  std::unordered_set<page_id_t> compressed_pages_;
+  std::mutex compression_latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,231 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_compressor.h
+//
+// Identification: src/include/storage/disk/page_compressor.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** Header stored at the front of a page slot that holds a compressed page image. */
+struct CompressedPageHeader {
+  /** Identifies the slot as compressed; raw slots never start with this value. */
+  uint32_t magic_;
+  /** Size of the compressed payload that follows the header, in bytes. */
+  uint32_t compressed_size_;
+};
+
+/**
+ * PageCompressor turns a PAGE_SIZE page image into an LZ4-style compressed block and back.
+ * The disk manager uses it to store opted-in table pages compressed inside their fixed page
+ * slot: the slot starts with a CompressedPageHeader and the payload follows, so a read can
+ * tell how many payload bytes are meaningful and the rest of the slot is ignored.
+ *
+ * The format is the usual byte-oriented LZ77 token stream: each token byte carries a literal
+ * run length in its high nibble and a match length (minus the 4-byte minimum) in its low
+ * nibble, 15 in either nibble continues with 255-extension bytes, and a match is a little-endian
+ * 2-byte backwards offset. Compression is greedy over a positional hash of 4-byte sequences.
+ * The codec is self-contained on purpose -- the build configures offline, so it cannot fetch
+ * a compression library, and pages are small enough that a 4K-entry hash table covers them.
+ *
+ * Decompression is defensive: every read and copy is bounds-checked and a malformed payload
+ * (torn write, stale slot) fails cleanly instead of overrunning the frame.
+ */
+class PageCompressor {
+ public:
+  /** Marks a page slot as holding a compressed image. Outside the non-negative page-id range,
+   * so the first word of a raw table page (its own page id) can never collide with it. */
+  static constexpr uint32_t COMPRESSED_PAGE_MAGIC = 0xC0DBCA9E;
+
+  /** A compressed slot must fit its header and still undercut the raw page to be worth it. */
+  static constexpr size_t MAX_PAYLOAD = PAGE_SIZE - sizeof(CompressedPageHeader) - 1;
+
+  /**
+   * Compresses one page image.
+   * @param src the PAGE_SIZE source image
+   * @param dst the payload output buffer, at least MAX_PAYLOAD bytes
+   * @return the payload size, or 0 if the image does not shrink below MAX_PAYLOAD
+   */
+  static size_t Compress(const char *src, char *dst) {
+    const auto *in = reinterpret_cast<const uint8_t *>(src);
+    auto *out = reinterpret_cast<uint8_t *>(dst);
+    size_t out_pos = 0;
+    // Positions of previously seen 4-byte sequences, keyed by hash; 0 means empty, else pos + 1.
+    uint16_t table[HASH_SIZE];
+    std::memset(table, 0, sizeof(table));
+
+    size_t literal_start = 0;
+    size_t pos = 0;
+    // Leave the tail as literals so a match copy never has to run past the end of the page.
+    while (pos + MIN_MATCH + TAIL_LITERALS <= PAGE_SIZE) {
+      uint32_t sequence = Load32(in + pos);
+      uint32_t hash = Hash(sequence);
+      size_t candidate = table[hash];
+      table[hash] = static_cast<uint16_t>(pos + 1);
+      if (candidate == 0 || Load32(in + (candidate - 1)) != sequence) {
+        pos++;
+        continue;
+      }
+      size_t match_start = candidate - 1;
+      size_t match_len = MIN_MATCH;
+      while (pos + match_len + TAIL_LITERALS < PAGE_SIZE && in[match_start + match_len] == in[pos + match_len]) {
+        match_len++;
+      }
+      if (!EmitToken(out, &out_pos, in + literal_start, pos - literal_start, pos - match_start, match_len)) {
+        return 0;
+      }
+      pos += match_len;
+      literal_start = pos;
+    }
+    // Final literal-only token covering the tail.
+    if (!EmitToken(out, &out_pos, in + literal_start, PAGE_SIZE - literal_start, 0, 0)) {
+      return 0;
+    }
+    return out_pos;
+  }
+
+  /**
+   * Decompresses one page image.
+   * @param src the compressed payload
+   * @param src_size the payload size in bytes
+   * @param dst the PAGE_SIZE output frame
+   * @return true iff the payload was well formed and produced exactly PAGE_SIZE bytes
+   */
+  static bool Decompress(const char *src, size_t src_size, char *dst) {
+    const auto *in = reinterpret_cast<const uint8_t *>(src);
+    auto *out = reinterpret_cast<uint8_t *>(dst);
+    size_t in_pos = 0;
+    size_t out_pos = 0;
+    while (in_pos < src_size) {
+      uint8_t token = in[in_pos++];
+      size_t literal_len = token >> 4;
+      if (!ReadExtension(in, src_size, &in_pos, &literal_len)) {
+        return false;
+      }
+      if (in_pos + literal_len > src_size || out_pos + literal_len > PAGE_SIZE) {
+        return false;
+      }
+      std::memcpy(out + out_pos, in + in_pos, literal_len);
+      in_pos += literal_len;
+      out_pos += literal_len;
+      if (in_pos == src_size) {
+        // The stream ends with a literal-only token.
+        break;
+      }
+      if (in_pos + 2 > src_size) {
+        return false;
+      }
+      size_t offset = in[in_pos] | (static_cast<size_t>(in[in_pos + 1]) << 8);
+      in_pos += 2;
+      size_t match_len = (token & 0x0F);
+      if (!ReadExtension(in, src_size, &in_pos, &match_len)) {
+        return false;
+      }
+      match_len += MIN_MATCH;
+      if (offset == 0 || offset > out_pos || out_pos + match_len > PAGE_SIZE) {
+        return false;
+      }
+      // Byte-wise on purpose: overlapping matches (offset < length) replicate the source run.
+      for (size_t i = 0; i < match_len; i++) {
+        out[out_pos + i] = out[out_pos + i - offset];
+      }
+      out_pos += match_len;
+    }
+    return out_pos == PAGE_SIZE;
+  }
+
+ private:
+  static constexpr size_t MIN_MATCH = 4;
+  static constexpr size_t TAIL_LITERALS = 8;
+  static constexpr size_t HASH_BITS = 12;
+  static constexpr size_t HASH_SIZE = 1 << HASH_BITS;
+
+  static uint32_t Load32(const uint8_t *p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+  }
+
+  /** Fibonacci hash of a 4-byte sequence into the match table. */
+  static uint32_t Hash(uint32_t sequence) { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+  /** Reads 255-extension bytes when a nibble length saturated at 15. */
+  static bool ReadExtension(const uint8_t *in, size_t size, size_t *in_pos, size_t *len) {
+    if (*len != 0x0F) {
+      return true;
+    }
+    uint8_t byte;
+    do {
+      if (*in_pos >= size) {
+        return false;
+      }
+      byte = in[(*in_pos)++];
+      *len += byte;
+    } while (byte == 0xFF);
+    return true;
+  }
+
+  /** Writes a nibble length's 255-extension bytes, if it saturated. */
+  static bool WriteExtension(uint8_t *out, size_t *out_pos, size_t len) {
+    if (len < 0x0F) {
+      return true;
+    }
+    for (len -= 0x0F; len >= 0xFF; len -= 0xFF) {
+      if (*out_pos >= MAX_PAYLOAD) {
+        return false;
+      }
+      out[(*out_pos)++] = 0xFF;
+    }
+    if (*out_pos >= MAX_PAYLOAD) {
+      return false;
+    }
+    out[(*out_pos)++] = static_cast<uint8_t>(len);
+    return true;
+  }
+
+  /**
+   * Emits one token: the pending literals followed by a match, or literals only when
+   * match_len is 0 (the stream-final token). Fails when the output would reach MAX_PAYLOAD,
+   * which the caller treats as "incompressible, store raw".
+   */
+  static bool EmitToken(uint8_t *out, size_t *out_pos, const uint8_t *literals, size_t literal_len, size_t offset,
+                        size_t match_len) {
+    size_t match_code = match_len == 0 ? 0 : match_len - MIN_MATCH;
+    if (*out_pos >= MAX_PAYLOAD) {
+      return false;
+    }
+    out[(*out_pos)++] = static_cast<uint8_t>((literal_len < 0x0F ? literal_len : 0x0F) << 4 |
+                                             (match_code < 0x0F ? match_code : 0x0F));
+    if (!WriteExtension(out, out_pos, literal_len)) {
+      return false;
+    }
+    if (*out_pos + literal_len > MAX_PAYLOAD) {
+      return false;
+    }
+    std::memcpy(out + *out_pos, literals, literal_len);
+    *out_pos += literal_len;
+    if (match_len == 0) {
+      return true;
+    }
+    if (*out_pos + 2 > MAX_PAYLOAD) {
+      return false;
+    }
+    out[(*out_pos)++] = static_cast<uint8_t>(offset & 0xFF);
+    out[(*out_pos)++] = static_cast<uint8_t>(offset >> 8);
+    return WriteExtension(out, out_pos, match_code);
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// temp_space_manager.h
+//
+// Identification: src/include/storage/disk/temp_space_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * TempSpaceManager serves the scratch pages of spilling operators (grace hash join partitions,
+ * external sort runs) from a dedicated temp file, so spill traffic never competes with table
+ * pages for buffer pool frames and never touches the WAL-ordered write path -- temp pages do
+ * not survive the query, so they are unlogged, unchecksummed, and never recovered.
+ *
+ * There is no replacement policy: a page occupies a frame only while it is pinned, a dirty
+ * unpin writes it to the file and recycles the frame, and a fetch reads it back. Spilling
+ * operators already pin only a handful of pages at a time (one open page per partition, one
+ * per run cursor) and stream whole pages between pins, so a cache would mostly hold pages
+ * that are read exactly once. Deleted page ids go on a free list and are reused by later
+ * allocations, keeping the file no larger than the query's peak spill; the file itself is
+ * removed when the manager is destroyed with its query's ExecutorContext.
+ *
+ * One instance belongs to one query and is not thread-safe: spilling operators run their
+ * partitioning and merge phases on the query thread.
+ */
+class TempSpaceManager {
+ public:
+  /** Creates a temp-space manager backed by a fresh, uniquely named temp file. */
+  TempSpaceManager();
+
+  DISALLOW_COPY_AND_MOVE(TempSpaceManager);
+
+  /** Closes and removes the temp file; every page is dropped regardless of pins. */
+  ~TempSpaceManager();
+
+  /**
+   * Allocates a new temp page, reusing a freed page id when one is available.
+   * @param[out] page_id id of the allocated page
+   * @return the pinned page, zero-filled
+   */
+  Page *NewPage(page_id_t *page_id);
+
+  /**
+   * Reads a previously written temp page back into a frame.
+   * @param page_id id of the page to fetch
+   * @return the pinned page
+   */
+  Page *FetchPage(page_id_t page_id);
+
+  /**
+   * Releases a pinned page, writing it to the temp file first when it is dirty.
+   * @param page_id id of the page to unpin
+   * @param is_dirty true if the page was modified since it was pinned
+   */
+  void UnpinPage(page_id_t page_id, bool is_dirty);
+
+  /**
+   * Returns an unpinned page's id to the free list for reuse by a later NewPage.
+   * @param page_id id of the page to delete
+   */
+  void DeletePage(page_id_t page_id);
+
+ private:
+  /** @return a frame from the recycle pool, or a freshly allocated one */
+  std::unique_ptr<Page> TakeFrame();
+
+  /** The temp file, pages at offset page_id * PAGE_SIZE. */
+  std::fstream io_;
+  std::string file_name_;
+  /** The next never-used page id. */
+  page_id_t next_page_id_{0};
+  /** Page ids freed by DeletePage, reused before the file is grown. */
+  std::vector<page_id_t> free_pages_;
+  /** Frames of pages currently pinned, keyed by page id. */
+  std::unordered_map<page_id_t, std::unique_ptr<Page>> pinned_;
+  /** Frames released by UnpinPage, reused by the next pin. */
+  std::vector<std::unique_ptr<Page>> frame_pool_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree.h
+//
+// Identification: src/include/storage/index/b_plus_tree.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * Main class providing the API for a disk-backed B+ tree index.
+ *
+ * Keys are kept sorted and duplicate keys are supported, so the tree serves
+ * non-unique indexes and range scans. Lookups descend into the leftmost
+ * subtree that can hold the key and then walk right across the leaf chain,
+ * collecting every matching entry.
+ *
+ * Concurrency uses latch crabbing. Readers couple read latches one level at
+ * a time. Inserts first try an optimistic descent that only write-latches the
+ * reached leaf; if the leaf would split, they retry pessimistically, holding
+ * write latches down the path and releasing ancestors as soon as a child is
+ * known not to split. Deletion is lazy: entries are removed from their leaf
+ * but pages are never merged or recycled, which keeps removals cheap and the
+ * latching protocol simple at the cost of space after heavy deletes.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree {
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE - 1);
+
+  /** @return true if this tree has no keys */
+  bool IsEmpty();
+
+  /**
+   * Inserts a key/value pair. Duplicate keys are allowed.
+   * @param key the key to insert
+   * @param value the value to insert
+   * @param transaction the current transaction
+   */
+  void Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  /**
+   * Removes the pair matching both key and value, if present. Removal is
+   * lazy: the entry leaves its leaf, but pages are never merged.
+   * @param key the key to remove
+   * @param value the value to remove
+   * @param transaction the current transaction
+   */
+  void Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  /**
+   * Collects every value stored under the given key.
+   * @param key the key to look up
+   * @param[out] result the values found
+   * @param transaction the current transaction
+   * @return true if at least one value was found
+   */
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
+
+  /**
+   * Collects every value whose key lies in [low, high], in key order. Either
+   * bound may be null to leave that end of the range open.
+   * @param low the inclusive lower bound, or nullptr
+   * @param high the inclusive upper bound, or nullptr
+   * @param[out] result the values found
+   * @param transaction the current transaction
+   */
+  void ScanRange(const KeyType *low, const KeyType *high, std::vector<ValueType> *result,
+                 Transaction *transaction = nullptr);
+
+ private:
+  void StartNewTree(const KeyType &key, const ValueType &value);
+  bool InsertOptimistic(const KeyType &key, const ValueType &value);
+  void InsertPessimistic(const KeyType &key, const ValueType &value);
+  void InsertIntoParent(std::vector<Page *> *latched_path, BPlusTreePage *old_node, const KeyType &key,
+                        BPlusTreePage *new_node, bool root_latched);
+  /**
+   * Descends to the first leaf that may hold the key (or the leftmost leaf if
+   * key is null) with read-latch coupling.
+   * @return the leaf's page, read-latched and pinned, or nullptr if the tree is empty
+   */
+  Page *FindLeafPageRead(const KeyType *key);
+
+  std::string index_name_;
+  /** Guards root_page_id_; also serializes structural changes near the root. */
+  ReaderWriterLatch root_latch_;
+  page_id_t root_page_id_{INVALID_PAGE_ID};
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_size_;
+};
+
+}  // namespace bustub
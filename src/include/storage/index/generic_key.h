@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
 
+#include "common/macros.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -32,7 +34,9 @@ class GenericKey {
   inline void SetFromKey(const Tuple &tuple) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    // A key tuple may trail a null bitmap past the key's fixed width; clamp so a tightly sized
+    // key does not overflow. Index keys are non-null, so the truncated bitmap carries no data.
+    memcpy(data_, tuple.GetData(), std::min(static_cast<size_t>(tuple.GetLength()), KeySize));
   }
 
   // NOTE: for test purpose only
@@ -103,4 +107,128 @@ class GenericComparator {
   Schema *key_schema_;
 };
 
+/**
+ * A binary-comparable ("normalized") index key. SetFromKey encodes the key
+ * columns into order-preserving bytes -- big-endian sign-flipped integers,
+ * bit-tweaked doubles, zero-padded varchar prefixes -- so two keys can be
+ * ordered with a single memcmp over the whole array: no Value is
+ * deserialized and no virtual comparison runs in the compare loop.
+ *
+ * A VARCHAR column consumes every byte remaining in the key, so it must be
+ * the last key column; strings that agree over that window compare equal
+ * (prefix truncation). Columns that do not fit the key's capacity are
+ * likewise truncated.
+ */
+template <size_t KeySize>
+class NormalizedKey {
+ public:
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
+    memset(data_, 0, KeySize);
+    size_t offset = 0;
+    uint32_t column_count = key_schema->GetColumnCount();
+    for (uint32_t i = 0; i < column_count && offset < KeySize; i++) {
+      Value value = tuple.GetValue(key_schema, i);
+      offset += EncodeValue(value, key_schema->GetColumn(i).GetType(), data_ + offset, KeySize - offset);
+    }
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) {
+    memset(data_, 0, KeySize);
+    PutUint(static_cast<uint64_t>(key) ^ (uint64_t{1} << 63), sizeof(int64_t), data_);
+  }
+
+  // actual location of data, extends past the end.
+  char data_[KeySize];
+
+ private:
+  /** Writes the low width bytes of bits, most significant first. */
+  static inline void PutUint(uint64_t bits, size_t width, char *out) {
+    for (size_t i = 0; i < width; i++) {
+      out[i] = static_cast<char>(bits >> (8 * (width - 1 - i)));
+    }
+  }
+
+  /** Flipping the sign bit makes two's complement order match unsigned byte order. */
+  static inline size_t EncodeSigned(int64_t value, size_t width, char *out, size_t space) {
+    if (space < width) {
+      return space;  // truncated: the zero padding stands in for the dropped bytes
+    }
+    PutUint(static_cast<uint64_t>(value) ^ (uint64_t{1} << (8 * width - 1)), width, out);
+    return width;
+  }
+
+  /** @return the number of key bytes the column consumed */
+  static inline size_t EncodeValue(const Value &value, TypeId type, char *out, size_t space) {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return EncodeSigned(value.GetAs<int8_t>(), 1, out, space);
+      case TypeId::SMALLINT:
+        return EncodeSigned(value.GetAs<int16_t>(), 2, out, space);
+      case TypeId::INTEGER:
+        return EncodeSigned(value.GetAs<int32_t>(), 4, out, space);
+      case TypeId::BIGINT:
+        return EncodeSigned(value.GetAs<int64_t>(), 8, out, space);
+      case TypeId::TIMESTAMP: {
+        if (space < sizeof(uint64_t)) {
+          return space;
+        }
+        PutUint(value.GetAs<uint64_t>(), sizeof(uint64_t), out);
+        return sizeof(uint64_t);
+      }
+      case TypeId::DECIMAL: {
+        if (space < sizeof(double)) {
+          return space;
+        }
+        double raw = value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &raw, sizeof(double));
+        // positive doubles order like unsigned ints once the sign bit is set;
+        // negative ones need every bit flipped to reverse their order
+        bits = ((bits >> 63) != 0) ? ~bits : (bits | (uint64_t{1} << 63));
+        PutUint(bits, sizeof(uint64_t), out);
+        return sizeof(uint64_t);
+      }
+      case TypeId::VARCHAR: {
+        // the prefix keeps byte order and the zero padding ranks shorter
+        // strings first; bytes past the window cannot influence the compare
+        size_t length = std::min(static_cast<size_t>(value.GetLength()), space);
+        memcpy(out, value.GetData(), length);
+        return space;
+      }
+      default:
+        BUSTUB_ASSERT(false, "Unsupported type.");
+    }
+    return space;
+  }
+};
+
+/**
+ * Function object ordering normalized keys with a single memcmp.
+ */
+template <size_t KeySize>
+class NormalizedComparator {
+ public:
+  inline int operator()(const NormalizedKey<KeySize> &lhs, const NormalizedKey<KeySize> &rhs) const {
+    return std::memcmp(lhs.data_, rhs.data_, KeySize);
+  }
+
+  NormalizedComparator(const NormalizedComparator &other) = default;
+
+  // constructor; the schema is already baked into the key bytes
+  explicit NormalizedComparator(Schema * /*key_schema*/) {}
+};
+
+/** Builds an index key from a key tuple; normalized keys also need the key schema to encode. */
+template <size_t KeySize>
+inline void BuildIndexKey(GenericKey<KeySize> *index_key, const Tuple &tuple, const Schema * /*key_schema*/) {
+  index_key->SetFromKey(tuple);
+}
+
+template <size_t KeySize>
+inline void BuildIndexKey(NormalizedKey<KeySize> *index_key, const Tuple &tuple, const Schema *key_schema) {
+  index_key->SetFromKey(tuple, key_schema);
+}
+
 }  // namespace bustub
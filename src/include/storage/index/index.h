@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -42,7 +43,8 @@ class IndexMetadata {
     key_schema_ = Schema::CopySchema(tuple_schema, key_attrs_);
   }
 
-  ~IndexMetadata() { delete key_schema_; }
+  // key_schema_ is interned (see Schema::CopySchema) and owned by the intern pool, not us.
+  ~IndexMetadata() = default;
 
   inline const std::string &GetName() const { return name_; }
 
@@ -137,6 +139,12 @@ class Index {
 
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  // collect every rid whose key lies in [low, high], in key order; only
+  // order-preserving index types override this
+  virtual void ScanRange(const Tuple &low, const Tuple &high, std::vector<RID> *result, Transaction *transaction) {
+    throw Exception(ExceptionType::NOT_IMPLEMENTED, "this index type does not support range scans");
+  }
+
  private:
   //===--------------------------------------------------------------------===//
   //  Data members
@@ -14,10 +14,12 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
 #include "container/hash/linear_probe_hash_table.h"
+#include "recovery/log_manager.h"
 #include "storage/index/index.h"
 
 namespace bustub {
@@ -27,8 +29,15 @@ namespace bustub {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTableIndex : public Index {
  public:
+  /**
+   * Creates the index. When a log manager and oid are supplied, every insert and delete
+   * writes ahead a logical INDEXINSERT/INDEXDELETE record under that oid, so after a crash
+   * the index is restored by log replay (LogRecovery::RegisterIndex) instead of a full
+   * rebuild from the heap. Without them the index is unlogged, as before.
+   */
   LinearProbeHashTableIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager, size_t num_buckets,
-                            const HashFunction<KeyType> &hash_fn);
+                            const HashFunction<KeyType> &hash_fn, LogManager *log_manager = nullptr,
+                            uint32_t index_oid = 0);
 
   ~LinearProbeHashTableIndex() override = default;
 
@@ -38,11 +47,46 @@ class LinearProbeHashTableIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * Point-lookup fast path for unique indexes: the probe stops at the first
+   * match and writes the RID straight to the caller, skipping the result
+   * vector entirely. Under a non-unique key an arbitrary matching RID is
+   * returned.
+   * @return true if the key is indexed
+   */
+  bool ScanSingleKey(const Tuple &key, ValueType *result, Transaction *transaction);
+
+  /**
+   * Inserts a batch of entries in one pass. The underlying table orders the
+   * keys by bucket and pins each block page once for all the inserts that
+   * land in it, so a bulk index build touches each page once instead of once
+   * per entry.
+   */
+  void InsertEntries(const std::vector<std::pair<Tuple, ValueType>> &entries, Transaction *transaction);
+
+  /**
+   * Probes a batch of keys in one pass, filling results[i] with the rids
+   * stored under keys[i]; like InsertEntries, each block page is pinned once.
+   */
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<ValueType>> *results,
+                Transaction *transaction);
+
  protected:
+  /**
+   * Writes ahead one logical log record for an index mutation, linking it into the
+   * transaction's chain. A no-op while logging is off, for unlogged indexes, and for
+   * operations outside a transaction -- recovery replay itself runs with a null one.
+   */
+  void LogIndexOperation(LogRecordType log_record_type, const Tuple &key, RID rid, Transaction *transaction);
+
   // comparator for key
   KeyComparator comparator_;
   // container
   LinearProbeHashTable<KeyType, ValueType, KeyComparator> container_;
+  // log manager the logical records go through, nullptr for an unlogged index
+  LogManager *log_manager_;
+  // catalog oid the records are tagged with, so recovery can find the index again
+  uint32_t index_oid_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_internal_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_internal_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <queue>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
+#define INTERNAL_PAGE_HEADER_SIZE 24
+#define INTERNAL_PAGE_SIZE ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+
+/**
+ * Store n indexed keys and n+1 child pointers (page_id) within internal page.
+ * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
+ * K(i) <= K < K(i+1).
+ * NOTE: since the number of keys does not equal to number of child pointers,
+ * the first key always remains invalid. That is to say, any search/lookup
+ * should ignore the first key.
+ *
+ * Internal page format (keys are stored in increasing order):
+ *  --------------------------------------------------------------------------
+ * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ *  --------------------------------------------------------------------------
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeInternalPage : public BPlusTreePage {
+ public:
+  /**
+   * Initializes a freshly allocated page as an empty internal page.
+   * @param page_id this page's id
+   * @param parent_id the parent's page id, or INVALID_PAGE_ID for the root
+   * @param max_size the number of children at which the page must split
+   */
+  void Init(page_id_t page_id, page_id_t parent_id, int max_size);
+
+  /** @return the key at the given index; index 0 holds no key */
+  KeyType KeyAt(int index) const;
+
+  /** Sets the key at the given index. */
+  void SetKeyAt(int index, const KeyType &key);
+
+  /** @return the index of the child with the given value, or -1 */
+  int ValueIndex(const ValueType &value) const;
+
+  /** @return the child at the given index */
+  ValueType ValueAt(int index) const;
+
+  /**
+   * Finds the child subtree a key belongs to. Descends to the leftmost
+   * subtree that can contain the key -- separators equal to the key keep the
+   * search left of them -- so scans over duplicate keys start at the first
+   * occurrence.
+   * @param key the search key
+   * @param comparator the key comparator
+   * @return the child page id to descend into
+   */
+  ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const;
+
+  /**
+   * Fills a new root with its first two children after the old root split.
+   * @param old_value the page id of the old root
+   * @param new_key the separator between the two children
+   * @param new_value the page id of the old root's split sibling
+   */
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+
+  /**
+   * Inserts a new key/child pair immediately after the child with old_value.
+   * @param old_value the child after which to insert
+   * @param new_key the separator key of the new child
+   * @param new_value the new child's page id
+   * @return the page's size after the insert
+   */
+  int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+
+  /**
+   * Moves the latter half of this page's pairs to an empty recipient and
+   * re-parents the moved children.
+   * @param recipient the new right sibling
+   * @param buffer_pool_manager used to update the moved children's parents
+   */
+  void MoveHalfTo(BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
+
+ private:
+  MappingType array_[0];
+};
+}  // namespace bustub
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_leaf_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_leaf_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
+#define LEAF_PAGE_HEADER_SIZE 28
+#define LEAF_PAGE_SIZE ((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+
+/**
+ * Store indexed key and record id (record id = page id combined with slot id,
+ * see include/common/rid.h for detailed implementation) together within leaf
+ * page. Only support unique key within one (key, value) pair; the same key may
+ * appear with different values, so the tree serves non-unique indexes.
+ *
+ * Leaf page format (keys are stored in order):
+ *  ----------------------------------------------------------------------
+ * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ *  ----------------------------------------------------------------------
+ *
+ * Header format (size in byte, 28 bytes in total):
+ * ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ * ---------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4)
+ * ---------------------------------------------------------------------
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeLeafPage : public BPlusTreePage {
+ public:
+  /**
+   * Initializes a freshly allocated page as an empty leaf page.
+   * @param page_id this page's id
+   * @param parent_id the parent's page id, or INVALID_PAGE_ID for the root
+   * @param max_size the number of entries at which the page must split
+   */
+  void Init(page_id_t page_id, page_id_t parent_id, int max_size);
+
+  /** @return the next leaf in key order, or INVALID_PAGE_ID for the last */
+  page_id_t GetNextPageId() const;
+
+  /** Sets the next leaf in key order. */
+  void SetNextPageId(page_id_t next_page_id);
+
+  /** @return the key at the given index */
+  KeyType KeyAt(int index) const;
+
+  /** @return the key/value pair at the given index */
+  const MappingType &GetItem(int index) const;
+
+  /**
+   * Finds the first index whose key is not less than the given key; with
+   * duplicate keys this is the first occurrence.
+   * @param key the search key
+   * @param comparator the key comparator
+   * @return the index, or GetSize() if every key is smaller
+   */
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+
+  /**
+   * Inserts a key/value pair, keeping the entries sorted. Equal keys are
+   * allowed; the new pair lands after existing ones with the same key.
+   * @param key the key to insert
+   * @param value the value to insert
+   * @param comparator the key comparator
+   * @return the page's size after the insert
+   */
+  int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  /**
+   * Removes the pair matching both key and value, if present.
+   * @param key the key to remove
+   * @param value the value to remove
+   * @param comparator the key comparator
+   * @return true if the pair was found and removed
+   */
+  bool RemoveRecord(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  /**
+   * Moves the latter half of this page's pairs to an empty recipient.
+   * @param recipient the new right sibling
+   */
+  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+
+ private:
+  page_id_t next_page_id_;
+  MappingType array_[0];
+};
+}  // namespace bustub
@@ -32,6 +32,10 @@ namespace bustub {
  *
  *  Here '+' means concatenation.
  *
+ * Besides the occupancy bitmaps, every slot carries a one-byte fingerprint
+ * tag derived from its key's hash. A probe compares tags before keys, so a
+ * negative lookup walks its chain on byte compares and touches the full
+ * keys only for the ~1/256 of slots whose tag collides.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBlockPage {
@@ -93,11 +97,41 @@ class HashTableBlockPage {
    */
   bool IsReadable(slot_offset_t bucket_ind) const;
 
+  /**
+   * Probes the aligned 64-slot window containing start in one pass. The occupied and readable
+   * bitmaps are read a word at a time instead of a bit per slot, and the readable candidates are
+   * compared against the probe key with 256-bit vector compares where the build and the key
+   * width allow it. Byte equality is the right test: keys hash by their bytes, so keys that are
+   * equal to the table are stored byte-identical.
+   *
+   * @param start the first slot to examine
+   * @param key the probe key
+   * @param[out] match_mask bit (i - base) is set for every readable slot i at or after start and
+   *             before the chain end whose key equals the probe key, where base is start rounded
+   *             down to a multiple of 64
+   * @param[out] chain_end the first never-occupied slot at or after start, or the first slot
+   *             past the window when the chain does not end inside it
+   * @return true if the probe chain ends inside this window
+   */
+  bool ProbeWindow(slot_offset_t start, const KeyType &key, uint64_t *match_mask, slot_offset_t *chain_end) const;
+
+  /** @return the one-byte fingerprint a key is stored under */
+  static unsigned char Tag(const KeyType &key);
+
+  /** @return the stored fingerprint of a slot; stale for tombstones, but those fail IsReadable */
+  unsigned char TagAt(slot_offset_t bucket_ind) const { return tags_[bucket_ind]; }
+
  private:
+  /** @return the 64 bitmap bits covering slots [base, base + 64), zero-padded past the array */
+  uint64_t LoadBitmapWord(const std::atomic_char *bitmap, slot_offset_t base) const;
+
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  // One fingerprint byte per slot, written before the readable bit is set;
+  // all tag accesses happen under the block's page latch.
+  unsigned char tags_[BLOCK_ARRAY_SIZE];
   MappingType array_[0];
 };
 
@@ -14,6 +14,7 @@
 
 #define MappingType std::pair<KeyType, ValueType>
 
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+// Each slot costs its key/value pair, two bitmap bits, and a one-byte fingerprint tag.
+#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 5))
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.h
+//
+// Identification: src/include/storage/page/overflow_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * One page of an overflow chain, holding a slice of a large varlen payload a
+ * table heap moved out of line (see TableHeap's TOAST support). The pages of
+ * a chain are singly linked; the chain belongs to exactly one row entry and
+ * is written once, read whole, and deleted with the row.
+ *
+ *  Header format (size in bytes):
+ *  ----------------------------------------------------------
+ *  | PageId (4) | LSN (4) | NextPageId (4) | DataSize (4) |
+ *  ----------------------------------------------------------
+ */
+class OverflowPage : public Page {
+ public:
+  /** The payload bytes one overflow page holds. */
+  static constexpr uint32_t CAPACITY = PAGE_SIZE - 16;
+
+  /** Initialize the overflow page header. */
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id_t));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetDataSize(0);
+  }
+
+  /** @return the page ID of this overflow page */
+  page_id_t GetOverflowPageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /** @return the page ID of the next page in the chain, or INVALID_PAGE_ID at the tail */
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page id of the next page in the chain. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of payload bytes stored in this page */
+  uint32_t GetDataSize() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_SIZE); }
+
+  /** Set the number of payload bytes stored in this page. */
+  void SetDataSize(uint32_t size) { memcpy(GetData() + OFFSET_DATA_SIZE, &size, sizeof(uint32_t)); }
+
+  /** @return pointer to this page's slice of the payload */
+  char *GetPayload() { return GetData() + SIZE_OVERFLOW_PAGE_HEADER; }
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t SIZE_OVERFLOW_PAGE_HEADER = 16;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_DATA_SIZE = 12;
+};
+}  // namespace bustub
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <new>
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -24,17 +26,35 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The book-keeping lives apart from the page bytes: data_ points into a frame arena the buffer
+ * pool allocates separately from its Page metadata array. Pins, latches, and version bumps then
+ * dirty only the small metadata entry, never a cache line a scan is streaming page bytes from,
+ * and the arena itself stays hot-path read-only. A Page constructed without an arena slot (tests,
+ * benchmarks) owns a standalone aligned buffer instead.
  */
 class Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManager;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
-
-  /** Default destructor. */
-  ~Page() = default;
+  /** Constructor for a standalone page owning its own aligned buffer. Zeros out the page data. */
+  Page() : data_(static_cast<char *>(::operator new(PAGE_SIZE, std::align_val_t{DIRECT_IO_ALIGNMENT}))), owns_data_(true) {
+    ResetMemory();
+  }
+
+  /**
+   * Constructor for a buffer pool frame viewing a slot of the pool's data arena.
+   * @param frame_data the frame's PAGE_SIZE slot; must outlive the page and be I/O-aligned
+   */
+  explicit Page(char *frame_data) : data_(frame_data) { ResetMemory(); }
+
+  /** Destructor. Frees the buffer of a standalone page; arena slots belong to the pool. */
+  ~Page() {
+    if (owns_data_) {
+      ::operator delete(data_, std::align_val_t{DIRECT_IO_ALIGNMENT});
+    }
+  }
 
   /** @return the actual data contained within this page */
   inline char *GetData() { return data_; }
@@ -43,16 +63,24 @@ class Page {
   inline page_id_t GetPageId() { return page_id_; }
 
   /** @return the pin count of this page */
-  inline int GetPinCount() { return pin_count_; }
+  inline int GetPinCount() { return pin_count_.load(std::memory_order_acquire); }
 
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline bool IsDirty() { return is_dirty_; }
 
-  /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  /** Acquire the page write latch. Bumps the version to an odd value so optimistic readers can
+   * tell a writer is in the page. */
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1, std::memory_order_release);
+  }
 
-  /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  /** Release the page write latch. Bumps the version back to even, invalidating any optimistic
+   * read that overlapped the write. */
+  inline void WUnlatch() {
+    version_.fetch_add(1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -60,6 +88,24 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * Begin an optimistic (latch-free) read. The caller copies what it needs out of the page, then
+   * checks ValidateOptimisticRead with the returned version; on failure the copy may be torn and
+   * must be discarded. No cache line is written, so readers scale across sockets.
+   * @return the current page version; an odd value means a writer is active and the caller
+   *         should fall back to RLatch right away
+   */
+  inline uint64_t BeginOptimisticRead() { return version_.load(std::memory_order_acquire); }
+
+  /**
+   * @param version the value BeginOptimisticRead returned
+   * @return true if no writer entered the page since, i.e. the optimistic copy is consistent
+   */
+  inline bool ValidateOptimisticRead(uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (version & 1) == 0 && version_.load(std::memory_order_relaxed) == version;
+  }
+
   /** @return the page LSN. */
   inline lsn_t GetLSN() { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -78,16 +124,31 @@ class Page {
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  /** The page bytes: a slot of the buffer pool's frame arena, or an owned buffer for a
+   * standalone page. Always aligned so the frame can be handed directly to O_DIRECT disk I/O
+   * without an intermediate bounce buffer. */
+  char *data_;
+  static_assert(DIRECT_IO_ALIGNMENT % CACHE_LINE_SIZE == 0, "page data must also be cache-line aligned");
+
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
-  /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  /** True when this page allocated data_ itself and must free it. */
+  bool owns_data_ = false;
+  /** The pin count of this page. Atomic so the buffer pool manager can re-pin a resident page
+   * with one fetch_add instead of taking its latch. On its own cache line with the latch and
+   * version words: these are written on every pin and latch, and sharing a line with the
+   * read-mostly page_id_ would invalidate it under readers on other cores. */
+  alignas(CACHE_LINE_SIZE) std::atomic<int> pin_count_{0};
+  /** True if the page is dirty, i.e. it is different from its corresponding page on disk.
+   * Atomic because the latch-free unpin and MarkPageDirty paths set it while a flusher holding
+   * only the page latch clears it; the flush paths clear before reading the bytes they write,
+   * so a concurrent re-dirty always survives for the next flush. */
+  std::atomic<bool> is_dirty_{false};
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Version counter for optimistic reads: odd while a writer holds the latch, bumped on every
+   * write latch acquire and release (seqlock protocol). */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
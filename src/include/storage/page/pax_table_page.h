@@ -0,0 +1,276 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_page.h
+//
+// Identification: src/include/storage/page/pax_table_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "concurrency/lock_manager.h"
+#include "recovery/log_manager.h"
+#include "storage/page/page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * PAX page format: rows are decomposed into per-column minipages so a scan
+ * that needs two columns of a wide table touches two dense byte runs instead
+ * of dragging every full row through the cache. Only fixed-length schemas are
+ * supported; each page holds the same fixed number of slots and a slot lives
+ * at the same index in every minipage.
+ *
+ *  ------------------------------------------------------------------------------------
+ *  | HEADER | SLOT STATUS (1 per slot) | COL 0 MINIPAGE | COL 1 ... | NULL BITMAPS |
+ *  ------------------------------------------------------------------------------------
+ *
+ * The last minipage holds one null bitmap per slot, mirroring the bitmap that
+ * trails every serialized row tuple.
+ *
+ *  Header format (size in bytes):
+ *  ---------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| TupleCount (4)|
+ *  | Capacity (4)|
+ *  ---------------------------------------------------------------------------
+ *
+ * The header prefix matches TablePage, so the doubly-linked page chain walks
+ * the same way for either layout. TupleCount is the high-water slot mark;
+ * slots below it are live, tombstoned, or reusable-empty per their status
+ * byte. The schema is not stored in the page -- callers pass it in, exactly
+ * as TablePage callers pass tuple sizes.
+ */
+class PaxTablePage : public Page {
+ public:
+  /**
+   * Initialize the PAX page header.
+   * @param page_id the page ID of this table page
+   * @param schema the fixed-length schema rows are decomposed by
+   * @param prev_page_id the previous table page ID
+   * @param log_manager the log manager in use
+   * @param txn the transaction that this page is created in
+   */
+  void Init(page_id_t page_id, const Schema *schema, page_id_t prev_page_id, LogManager *log_manager, Transaction *txn);
+
+  /** @return the page ID of this table page */
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /** @return the page ID of the previous table page */
+  page_id_t GetPrevPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
+
+  /** @return the page ID of the next table page */
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page id of the previous page in the table. */
+  void SetPrevPageId(page_id_t prev_page_id) {
+    memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  }
+
+  /** Set the page id of the next page in the table. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of slots a page of this schema holds */
+  static uint32_t Capacity(const Schema *schema) {
+    // One status byte, one row's worth of column bytes, and one null bitmap per slot.
+    return (PAGE_SIZE - SIZE_PAX_PAGE_HEADER) / (1 + schema->GetLength() + Tuple::NullBitmapSize(schema));
+  }
+
+  /**
+   * Insert a tuple into the page, scattering its columns into the minipages.
+   * @param schema the table schema
+   * @param tuple tuple to insert
+   * @param[out] rid rid of the inserted tuple
+   * @param txn transaction performing the insert
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @return true if the insert is successful (i.e. there is a free slot)
+   */
+  bool InsertTuple(const Schema *schema, const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager,
+                   LogManager *log_manager);
+
+  /**
+   * Mark a tuple as deleted. This does not actually delete the tuple.
+   * @param rid rid of the tuple to mark as deleted
+   * @param txn transaction performing the delete
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @return true if marking the tuple as deleted is successful (i.e the tuple exists)
+   */
+  bool MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
+
+  /**
+   * Update a tuple in place. Rows are fixed-length, so the new value always
+   * fits where the old one was.
+   * @param schema the table schema
+   * @param new_tuple new value of the tuple
+   * @param[out] old_tuple old value of the tuple
+   * @param rid rid of the tuple
+   * @param txn transaction performing the update
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @return true if updating the tuple succeeded
+   */
+  bool UpdateTuple(const Schema *schema, const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, Transaction *txn,
+                   LockManager *lock_manager, LogManager *log_manager);
+
+  /** To be called on commit or abort. Actually perform the delete or rollback an insert. */
+  void ApplyDelete(const Schema *schema, const RID &rid, Transaction *txn, LogManager *log_manager);
+
+  /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
+  void RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
+
+  /**
+   * Read a tuple from the page, gathering its columns out of the minipages.
+   * @param schema the table schema
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that was read
+   * @param txn transaction performing the read
+   * @param lock_manager the lock manager
+   * @return true if the read is successful (i.e. the tuple exists)
+   */
+  bool GetTuple(const Schema *schema, const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
+
+  /**
+   * Read a tuple without materializing it: the columns are gathered into a stack scratch row
+   * and the consumer sees a non-owning view over it, valid only for the duration of the call.
+   * Takes the same row lock GetTuple would; callers copy out whatever survives their filters.
+   * @param schema the table's (fixed-length) schema
+   * @param rid rid of the tuple to read
+   * @param consume invoked once with the view of the tuple
+   * @param txn transaction performing the read
+   * @param lock_manager the lock manager
+   * @return true if the tuple exists and the consumer ran
+   */
+  bool GetTupleView(const Schema *schema, const RID &rid, const std::function<void(const Tuple &)> &consume,
+                    Transaction *txn, LockManager *lock_manager);
+
+  /**
+   * Find the first live tuple at or after the given slot that satisfies the predicate. Only the
+   * named columns are gathered out of their minipages into a scratch row the predicate and the
+   * consumer see through a non-owning view -- the other minipages are never touched, which is
+   * the whole point of the layout. The view's unlisted columns hold garbage, so needed_cols must
+   * cover every column the callbacks read. Caller holds the page read latch; the view is valid
+   * only for the duration of the callback.
+   * @param schema the table schema
+   * @param start_slot the slot to resume the scan from
+   * @param needed_cols the schema indexes of the columns the callbacks read
+   * @param predicate filter evaluated against the gathered view; nullptr accepts every tuple
+   * @param[out] rid the rid of the matching tuple
+   * @param consume invoked once with the gathered view of the matching tuple
+   * @param selection optional selection bitmap over the slots, one bit each; slots whose bit is
+   * clear are skipped without gathering anything. Built by a columnar kernel over a minipage,
+   * see GetColumnVector.
+   * @return true if a match was found in this page
+   */
+  bool FindFirstMatch(const Schema *schema, uint32_t start_slot, const std::vector<uint32_t> &needed_cols,
+                      const std::function<bool(const Tuple &)> &predicate, RID *rid,
+                      const std::function<void(const Tuple &)> &consume, const uint64_t *selection = nullptr);
+
+  /**
+   * Exposes one column's minipage as a contiguous vector for a columnar filter pass: the
+   * column's values for slots [0, count) sit back to back at *data. Null values hold the
+   * type's null sentinel; empty and deleted slots hold stale bytes, so a bitmap built over
+   * the vector is advisory and FindFirstMatch still checks slot status. Caller holds the
+   * page latch; the pointer is valid only while it is held.
+   * @param schema the table schema
+   * @param col_idx the (fixed-width) column to expose
+   * @param[out] data base of the column's minipage
+   * @param[out] count the number of slots under the high-water mark
+   */
+  void GetColumnVector(const Schema *schema, uint32_t col_idx, const char **data, uint32_t *count);
+
+  /**
+   * Reclaims scan work after applied deletes: trailing empty slots are trimmed off the
+   * high-water slot mark so scans and gathers stop visiting them (the minipage bytes
+   * themselves are fixed-position and need no compaction). Caller holds the page write latch.
+   * @return the number of slots still in use (live or tombstoned)
+   */
+  uint32_t VacuumSlots();
+
+  /**
+   * @param[out] first_rid the RID of the first tuple in this page
+   * @return true if the first tuple exists, false otherwise
+   */
+  bool GetFirstTupleRid(RID *first_rid);
+
+  /**
+   * @param cur_rid the RID of the current tuple
+   * @param[out] next_rid the RID of the tuple following the current tuple
+   * @return true if the next tuple exists, false otherwise
+   */
+  bool GetNextTupleRid(const RID &cur_rid, RID *next_rid);
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t SIZE_PAX_PAGE_HEADER = 24;
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_TUPLE_COUNT = 16;
+  static constexpr size_t OFFSET_CAPACITY = 20;
+
+  /** Slot has never held a row (or its delete was applied) and can be claimed. */
+  static constexpr char SLOT_EMPTY = 0;
+  /** Slot holds a live row. */
+  static constexpr char SLOT_LIVE = 1;
+  /** Slot holds a row marked deleted but not yet applied. */
+  static constexpr char SLOT_DELETED = 2;
+
+  /** @return the high-water slot mark, see header comment */
+  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+
+  /** Set the high-water slot mark. */
+  void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
+
+  /** @return the number of slots this page holds, fixed at Init */
+  uint32_t GetCapacity() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_CAPACITY); }
+
+  /** Set the slot capacity. */
+  void SetCapacity(uint32_t capacity) { memcpy(GetData() + OFFSET_CAPACITY, &capacity, sizeof(uint32_t)); }
+
+  /** @return the status byte of a slot */
+  char GetSlotStatus(uint32_t slot_num) { return GetData()[SIZE_PAX_PAGE_HEADER + slot_num]; }
+
+  /** Set the status byte of a slot. */
+  void SetSlotStatus(uint32_t slot_num, char status) { GetData()[SIZE_PAX_PAGE_HEADER + slot_num] = status; }
+
+  /**
+   * @return the address of a column's entry for a slot. The minipage for column col_idx starts
+   * right after the status bytes, offset by the bytes of every preceding column's minipage --
+   * which is the column's row offset scaled by the slot capacity.
+   */
+  char *ColumnEntry(const Schema *schema, uint32_t col_idx, uint32_t slot_num) {
+    const Column &col = schema->GetColumn(col_idx);
+    return GetData() + SIZE_PAX_PAGE_HEADER + GetCapacity() + GetCapacity() * col.GetOffset() +
+           static_cast<size_t>(slot_num) * col.GetFixedLength();
+  }
+
+  /** @return pointer to the slot's null bitmap, stored in one more minipage after the columns */
+  char *NullBitmapEntry(const Schema *schema, uint32_t slot_num) {
+    return GetData() + SIZE_PAX_PAGE_HEADER + GetCapacity() + GetCapacity() * schema->GetLength() +
+           static_cast<size_t>(slot_num) * Tuple::NullBitmapSize(schema);
+  }
+
+  /** Scatter the given columns of a row buffer into their minipage entries. */
+  void ScatterColumns(const Schema *schema, uint32_t slot_num, const char *row);
+
+  /** Gather the given columns of a slot into a row buffer laid out by the schema. */
+  void GatherColumns(const Schema *schema, uint32_t slot_num, const std::vector<uint32_t> &cols, char *row);
+
+  /** Gather every column of a slot into a freshly allocated tuple. */
+  void GatherTuple(const Schema *schema, uint32_t slot_num, Tuple *tuple);
+};
+}  // namespace bustub
@@ -13,6 +13,8 @@
 #pragma once
 
 #include <cstring>
+#include <functional>
+#include <vector>
 
 #include "common/rid.h"
 #include "concurrency/lock_manager.h"
@@ -24,6 +26,8 @@ static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
 
 namespace bustub {
 
+class TupleBatch;
+
 /**
  * Slotted page format:
  *  ---------------------------------------------------------
@@ -36,10 +40,19 @@ namespace bustub {
  *  ----------------------------------------------------------------------------
  *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
  *  ----------------------------------------------------------------------------
- *  ----------------------------------------------------------------
- *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
- *  ----------------------------------------------------------------
+ *  --------------------------------------------------------------------------
+ *  | TupleCount (4) | OccupiedBitmap (64) | DeletedBitmap (64) |
+ *  --------------------------------------------------------------------------
+ *  --------------------------------------------------------------------
+ *  | LiveTupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
+ *  --------------------------------------------------------------------
  *
+ *  The bitmaps hold one bit per slot: occupied means the slot holds stored bytes (live or
+ *  tombstoned), deleted means those bytes carry the tombstone flag. They mirror the per-slot
+ *  size words exactly and are maintained by every write path, so the slot walks (next live
+ *  rid, batch copies, free-slot search) advance by bit-scan over a cache line instead of
+ *  re-reading the whole slot directory -- the rid walk used to be quadratic over a page.
+ *  LiveTupleCount counts the occupied, non-tombstoned slots.
  */
 class TablePage : public Page {
  public:
@@ -79,9 +92,28 @@ class TablePage : public Page {
    * @param txn transaction performing the insert
    * @param lock_manager the lock manager
    * @param log_manager the log manager
+   * @param reserved free-space bytes the insert must leave untouched: fill-factor headroom the
+   * heap sets aside so later updates that grow a row can still succeed in place (see
+   * TableHeap::SetFillFactor). The insert fails as if the page were full rather than dip into it.
+   * @param defer_log true to take the row's lock but stage no log record: the caller is batching
+   * inserts into this page and covers the run with one LogInsertBatch call before unlatching
    * @return true if the insert is successful (i.e. there is enough space)
    */
-  bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
+  bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager,
+                   uint32_t reserved = 0, bool defer_log = false);
+
+  /**
+   * Stages one physiological log record covering a run of rows a batch insert already wrote to
+   * this page with defer_log, cutting the record count and staging calls for an ingest batch
+   * by the rows-per-page factor. The caller holds the page write latch and must call this
+   * before unlatching, so the page's LSN covers the bytes when they reach disk.
+   * @param rids the rids of the run's rows, in insertion order; all on this page
+   * @param tuples the rows' images, parallel to rids; must outlive the call
+   * @param txn the inserting transaction
+   * @param log_manager the log manager in use
+   */
+  void LogInsertBatch(const std::vector<RID> &rids, const std::vector<const Tuple *> &tuples, Transaction *txn,
+                      LogManager *log_manager);
 
   /**
    * Mark a tuple as deleted. This does not actually delete the tuple.
@@ -122,6 +154,97 @@ class TablePage : public Page {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Copy a tuple's stored bytes out regardless of its deleted flag: undo-time callers (e.g.
+   * the heap releasing a row's overflow chains while applying its delete) need the bytes after
+   * the row has been tombstoned. Takes no locks and never touches a transaction; the caller
+   * holds the page latch.
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the stored tuple bytes
+   * @return true if the slot holds bytes (live or tombstoned)
+   */
+  bool GetTupleRaw(const RID &rid, Tuple *tuple);
+
+  /**
+   * Read a tuple without copying it: the consumer sees a non-owning view over the tuple bytes
+   * inside this (latched, pinned) page, valid only for the duration of the call. Takes the same
+   * row lock GetTuple would; callers copy out whatever survives their filters.
+   * @param rid rid of the tuple to read
+   * @param consume invoked once with the in-page view of the tuple
+   * @param txn transaction performing the read
+   * @param lock_manager the lock manager
+   * @return true if the tuple exists and the consumer ran
+   */
+  bool GetTupleView(const RID &rid, const std::function<void(const Tuple &)> &consume, Transaction *txn,
+                    LockManager *lock_manager);
+
+  /**
+   * Copy every live tuple in a slot range into a batch in one pass. The deleted-flag check and
+   * the byte copy happen slot by slot under whatever latch the caller already holds, so a scan
+   * pays one latch acquisition per page instead of one GetTuple call (locks, Tuple allocation)
+   * per slot. Takes no per-tuple locks; callers that need them should stay on GetTuple. Caller
+   * holds the page read latch. Appends to the batch without clearing it first.
+   * @param slot_start the first slot to read
+   * @param slot_end one past the last slot to read; clamped to the page's tuple count
+   * @param[out] batch receives the surviving tuples, bytes copied contiguously
+   * @return true if at least one tuple was appended to the batch
+   */
+  bool GetTuples(uint32_t slot_start, uint32_t slot_end, TupleBatch *batch);
+
+  /**
+   * Reclaims slot-array space after applied deletes: trailing empty slots are trimmed off the
+   * high-water tuple count so their entries rejoin the free space. Tuple bytes are already
+   * compacted as each delete applies, and interior empty slots are reused by inserts, so this
+   * is all that is left to reclaim inside a page. Caller holds the page write latch.
+   * @return the number of slots still holding bytes (live or tombstoned)
+   */
+  uint32_t VacuumSlots();
+
+  /** @return the bytes still free between the slot directory and the tuple data; the heap
+   * samples this into its free space map to direct inserts. Caller holds the page latch. */
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
+  /**
+   * Latch-free tuple copy for optimistic readers (see Page::BeginOptimisticRead). Every header
+   * field is range-checked before use because a concurrent writer can leave the page momentarily
+   * inconsistent; the caller must validate the page version afterwards and discard the result on
+   * a mismatch. Takes no locks and never touches the transaction.
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that was read; only meaningful once the version validates
+   * @return true if the tuple exists and was copied out
+   */
+  bool GetTupleOptimistic(const RID &rid, Tuple *tuple);
+
+  /**
+   * Find the first live tuple at or after the given slot that satisfies the predicate, copying
+   * only the survivor out. The predicate sees a non-owning view over the tuple bytes inside this
+   * (latched, pinned) page, valid only for the duration of the call -- rows that fail the filter
+   * are never materialized. Caller holds the page read latch.
+   * @param start_slot the slot to resume the scan from
+   * @param predicate filter evaluated against the in-page view; nullptr accepts every tuple
+   * @param[out] rid the rid of the matching tuple
+   * @param[out] tuple a deep copy of the matching tuple
+   * @return true if a match was found in this page
+   */
+  bool FindFirstMatch(uint32_t start_slot, const std::function<bool(const Tuple &)> &predicate, RID *rid, Tuple *tuple);
+
+  /**
+   * Find the first live tuple at or after the given slot that satisfies the predicate, handing
+   * the survivor to a consumer instead of copying it out. The consumer (like the predicate) sees
+   * the non-owning view over the tuple bytes inside this page, so a projecting caller can copy
+   * out only the columns it needs and the full row is never materialized. Caller holds the page
+   * read latch; the view is valid only for the duration of the consumer call.
+   * @param start_slot the slot to resume the scan from
+   * @param predicate filter evaluated against the in-page view; nullptr accepts every tuple
+   * @param[out] rid the rid of the matching tuple
+   * @param consume invoked once with the in-page view of the matching tuple
+   * @return true if a match was found in this page
+   */
+  bool FindFirstMatch(uint32_t start_slot, const std::function<bool(const Tuple &)> &predicate, RID *rid,
+                      const std::function<void(const Tuple &)> &consume);
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -137,17 +260,28 @@ class TablePage : public Page {
    */
   bool GetNextTupleRid(const RID &cur_rid, RID *next_rid);
 
+  /** @return the number of occupied, non-tombstoned slots, maintained in the header */
+  uint32_t GetLiveTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_LIVE_COUNT); }
+
  private:
   static_assert(sizeof(page_id_t) == 4);
 
-  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
+  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 156;
   static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
   static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
-  static constexpr size_t OFFSET_TUPLE_OFFSET = 24;  // Naming things is hard.
-  static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  /** One bit per slot, 8-byte aligned within the page so the words can be read directly. */
+  static constexpr size_t OFFSET_OCCUPIED_BITMAP = 24;
+  static constexpr size_t OFFSET_DELETED_BITMAP = 88;
+  static constexpr size_t OFFSET_LIVE_COUNT = 152;
+  static constexpr size_t OFFSET_TUPLE_OFFSET = 156;  // Naming things is hard.
+  static constexpr size_t OFFSET_TUPLE_SIZE = 160;
+  /** Bytes per slot bitmap; enough bits for every slot a page can physically hold. */
+  static constexpr size_t SIZE_SLOT_BITMAP = 64;
+  static_assert((PAGE_SIZE - SIZE_TABLE_PAGE_HEADER) / SIZE_TUPLE <= SIZE_SLOT_BITMAP * 8,
+                "The slot bitmaps must cover every slot the page can hold.");
 
   /** @return pointer to the end of the current free space, see header comment */
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
@@ -166,10 +300,6 @@ class TablePage : public Page {
   /** Set the number of tuples in this page. */
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   /** @return tuple offset at slot slot_num */
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
@@ -190,6 +320,36 @@ class TablePage : public Page {
     memcpy(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num, &size, sizeof(uint32_t));
   }
 
+  /** @return the occupied-slot bitmap, one bit per slot holding stored bytes */
+  uint64_t *OccupiedBitmap() { return reinterpret_cast<uint64_t *>(GetData() + OFFSET_OCCUPIED_BITMAP); }
+
+  /** @return the deleted-slot bitmap, one bit per tombstoned slot */
+  uint64_t *DeletedBitmap() { return reinterpret_cast<uint64_t *>(GetData() + OFFSET_DELETED_BITMAP); }
+
+  /** Sets the slot's bit in a bitmap. */
+  static void SetBitmapBit(uint64_t *bitmap, uint32_t slot_num) {
+    bitmap[slot_num >> 6] |= uint64_t{1} << (slot_num & 63);
+  }
+
+  /** Clears the slot's bit in a bitmap. */
+  static void ClearBitmapBit(uint64_t *bitmap, uint32_t slot_num) {
+    bitmap[slot_num >> 6] &= ~(uint64_t{1} << (slot_num & 63));
+  }
+
+  /** Sets the live-tuple count in the header. */
+  void SetLiveTupleCount(uint32_t live_count) {
+    memcpy(GetData() + OFFSET_LIVE_COUNT, &live_count, sizeof(uint32_t));
+  }
+
+  /**
+   * Bit-scans a slot bitmap for the first set bit at or after start_slot, below the tuple count.
+   * @param bitmap the bitmap to scan
+   * @param start_slot the slot to resume from
+   * @param[out] slot_num the first slot at or after start_slot whose bit is set
+   * @return true if such a slot exists
+   */
+  bool FindNextSetSlot(const uint64_t *bitmap, uint32_t start_slot, uint32_t *slot_num);
+
   /** @return true if the tuple is deleted or empty */
   static bool IsDeleted(uint32_t tuple_size) { return static_cast<bool>(tuple_size & DELETE_MASK) || tuple_size == 0; }
 
@@ -1,16 +1,19 @@
 #pragma once
 
+#include <cstring>
+
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
-
 /**
+ * TmpTuplePage holds serialized tuples that do not belong to any table, e.g. the spilled
+ * partitions of a grace hash join. Tuples are appended from the end of the page towards the
+ * header and are addressed by their byte offset (see TmpTuple); pages are private to the
+ * operator that allocated them, so access is unlatched.
+ *
  * TmpTuplePage format:
  *
  * Sizes are in bytes.
@@ -20,14 +23,63 @@ namespace bustub {
  */
 class TmpTuplePage : public Page {
  public:
-  void Init(page_id_t page_id, uint32_t page_size) {}
+  void Init(page_id_t page_id, uint32_t page_size) {
+    memcpy(GetData(), &page_id, sizeof(page_id_t));
+    SetFreeSpacePointer(page_size);
+  }
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
 
-  page_id_t GetTablePageId() { return INVALID_PAGE_ID; }
+  /**
+   * Appends a tuple to this page.
+   * @param tuple the tuple to serialize into the page
+   * @param[out] out the location of the stored tuple
+   * @return true if the insert succeeded, false if the page is out of space
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out) {
+    uint32_t entry_size = tuple.GetLength() + sizeof(uint32_t);
+    if (GetFreeSpacePointer() < SIZE_TMP_TUPLE_PAGE_HEADER + entry_size) {
+      return false;
+    }
+    uint32_t offset = GetFreeSpacePointer() - entry_size;
+    tuple.SerializeTo(GetData() + offset);
+    SetFreeSpacePointer(offset);
+    *out = TmpTuple(GetTablePageId(), offset);
+    return true;
+  }
 
-  bool Insert(const Tuple &tuple, TmpTuple *out) { return false; }
+  /** @return the offset of the first stored tuple, for use with GetNextTuple */
+  size_t GetFirstTupleOffset() { return GetFreeSpacePointer(); }
+
+  /**
+   * Reads the tuple at the given offset and advances the offset past it, so repeated calls
+   * starting from GetFirstTupleOffset() walk every tuple in the page.
+   * @param[in,out] offset the offset to read from, advanced past the tuple that was read
+   * @param[out] tuple the deserialized tuple
+   * @return true if a tuple was read, false if the offset is past the end of the page
+   */
+  bool GetNextTuple(size_t *offset, Tuple *tuple) {
+    if (*offset >= PAGE_SIZE) {
+      return false;
+    }
+    tuple->DeserializeFrom(GetData() + *offset);
+    *offset += sizeof(uint32_t) + tuple->GetLength();
+    return true;
+  }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t SIZE_TMP_TUPLE_PAGE_HEADER = 12;
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
+
+  /** @return pointer to the start of the last inserted tuple, see header comment */
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  /** Sets the pointer, this should be the start of the last inserted tuple. */
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// row_serializer.h
+//
+// Identification: src/include/storage/table/row_serializer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "storage/table/tuple.h"
+#include "type/limits.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * RowSerializer writes whole std::vector<Value> rows as tuple bytes with a plan compiled once
+ * from the schema. Tuple's value constructor resolves each column's offset, width, and
+ * inlinedness per row and serializes through a virtual SerializeTo per column; the serializer
+ * resolves all of that at construction and the per-row pass is straight-line: one fixed-width
+ * memcpy out of each Value's payload union (which writes the same bytes SerializeTo does,
+ * null sentinels included) plus the length-prefixed varlen tail. Build one per schema and
+ * reuse it -- constructing a serializer per row would give the lookups right back.
+ */
+class RowSerializer {
+ public:
+  /** Compiles the serialization plan for the given schema, which must outlive the serializer. */
+  explicit RowSerializer(const Schema *schema)
+      : fixed_length_(schema->GetLength()), bitmap_size_(Tuple::NullBitmapSize(schema)) {
+    cols_.reserve(schema->GetColumnCount());
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      const auto &col = schema->GetColumn(i);
+      cols_.push_back(ColSlot{col.GetOffset(), col.IsInlined() ? col.GetFixedLength() : 0});
+    }
+    varlens_ = schema->GetUnlinedColumns();
+  }
+
+  /**
+   * Materializes one row as a Tuple; a drop-in for Tuple(values, schema).
+   * @param values the row's values, in schema column order
+   * @return the serialized tuple
+   */
+  Tuple MakeTuple(const std::vector<Value> &values) const {
+    BUSTUB_ASSERT(values.size() == cols_.size(), "Row width does not match the compiled schema.");
+    // Size pass: fixed section, varlen tail (null varlens store no payload), null bitmap.
+    uint32_t size = fixed_length_ + bitmap_size_;
+    for (uint32_t idx : varlens_) {
+      const Value &val = values[idx];
+      if (val.size_.len_ != BUSTUB_VALUE_NULL) {
+        size += val.size_.len_ + sizeof(uint32_t);
+      }
+    }
+    Tuple tuple;
+    char *data = tuple.ResizeData(size);
+    std::memset(data, 0, size);
+    char *bitmap = data + size - bitmap_size_;
+    uint32_t offset = fixed_length_;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(cols_.size()); i++) {
+      const Value &val = values[i];
+      const ColSlot &col = cols_[i];
+      if (val.size_.len_ == BUSTUB_VALUE_NULL) {
+        bitmap[i / 8] |= static_cast<char>(1U << (i % 8));
+        // A null inlined column keeps its slot and stores the sentinel its Value carries; a
+        // null varlen column's offset slot stays zero.
+        if (col.width_ != 0) {
+          std::memcpy(data + col.offset_, &val.value_, col.width_);
+        }
+        continue;
+      }
+      if (col.width_ != 0) {
+        std::memcpy(data + col.offset_, &val.value_, col.width_);
+      } else {
+        *reinterpret_cast<uint32_t *>(data + col.offset_) = offset;
+        *reinterpret_cast<uint32_t *>(data + offset) = val.size_.len_;
+        std::memcpy(data + offset + sizeof(uint32_t), val.value_.const_varlen_, val.size_.len_);
+        offset += val.size_.len_ + sizeof(uint32_t);
+      }
+    }
+    return tuple;
+  }
+
+ private:
+  /** One column's resolved slot: its fixed-section offset and width, 0 width meaning varlen. */
+  struct ColSlot {
+    uint32_t offset_;
+    uint32_t width_;
+  };
+
+  /** Length of the fixed-width section, where the varlen tail begins. */
+  uint32_t fixed_length_;
+  /** Size in bytes of the trailing null bitmap. */
+  uint32_t bitmap_size_;
+  /** Per-column resolved slots, in schema order. */
+  std::vector<ColSlot> cols_;
+  /** Indices of the varlen columns, for the size pass. */
+  std::vector<uint32_t> varlens_;
+};
+
+}  // namespace bustub
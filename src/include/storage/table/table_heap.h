@@ -12,22 +12,74 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
+#include "storage/index/index.h"
+#include "storage/table/zone_map.h"
+#include "storage/page/overflow_page.h"
+#include "storage/page/pax_table_page.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+/** The physical layout of a table's pages, chosen once at creation. */
+enum class TableLayout {
+  /** N-ary slotted rows (TablePage); the default, and the only layout for schemas with varlen columns. */
+  ROW,
+  /** Per-column minipages within each page (PaxTablePage); fixed-length schemas only. */
+  PAX
+};
+
+/**
+ * One exported column in Arrow-style layout, filled by TableHeap::ExportColumnar. validity_
+ * holds one bit per row (set when the row's value is non-null). Fixed-width columns pack their
+ * values back to back in values_, so row i starts at i * fixed_length; a null row keeps its
+ * slot (holding the stored null sentinel) so the addressing stays positional. Varchar columns
+ * additionally carry offsets_ with num_rows + 1 entries, row i's bytes being
+ * values_[offsets_[i] .. offsets_[i + 1]); a null row contributes an empty range.
+ */
+struct ColumnarBuffer {
+  std::vector<uint8_t> validity_;
+  std::vector<char> values_;
+  std::vector<uint32_t> offsets_;
+};
+
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * A heap is created with one of two page layouts. ROW is the slotted layout
+ * everything has always used. PAX decomposes rows into per-column minipages
+ * so scans touch only the columns they need; it requires a fixed-length
+ * schema, which the heap keeps a copy of to address the minipages. PAX heaps
+ * read through the plain latched path -- the optimistic and snapshot read
+ * shortcuts stay row-layout-only for now.
+ *
+ * A row-layout heap created with a schema spills large varlen payloads into
+ * overflow page chains (TOAST-style): a row whose serialized size crosses
+ * TOAST_THRESHOLD has every varlen payload of at least TOAST_MIN_PAYLOAD
+ * bytes written to its own chain of OverflowPages, and the entry left in the
+ * row is a 12-byte pointer. Rows larger than a page become storable, and big
+ * blobs stop crowding their page neighbors out of slot locality. The read
+ * paths reassemble the payloads transparently; chains are freed when the
+ * row's delete is applied or its value is updated away.
  */
 class TableHeap {
   friend class TableIterator;
 
  public:
+  /** Chain pages between consecutive page directory entries, see GetPageDirectory(). */
+  static constexpr size_t DIRECTORY_INTERVAL = 8;
+
   ~TableHeap() = default;
 
   /**
@@ -50,6 +102,20 @@ class TableHeap {
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
             Transaction *txn);
 
+  /**
+   * Create a table heap with an explicit page layout. (create table)
+   * @param buffer_pool_manager the buffer pool manager
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @param txn the creating transaction
+   * @param schema the table schema; must be fixed-length for the PAX layout
+   * @param layout the page layout for this table
+   * @param compressed true to store this table's pages compressed on disk; every page the heap
+   * allocates (data, PAX, and overflow pages alike) is marked with the disk manager
+   */
+  TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
+            Transaction *txn, const Schema *schema, TableLayout layout, bool compressed = false);
+
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
    * @param tuple tuple to insert
@@ -59,6 +125,28 @@ class TableHeap {
    */
   bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn);
 
+  /**
+   * Insert a batch of tuples into the table. The tail page is kept pinned and write-latched
+   * across consecutive inserts, so a batch pays the buffer pool fetch and latch acquisition
+   * once per page it fills instead of once per row.
+   * @param tuples the tuples to insert
+   * @param[out] rids the rids of the inserted tuples, in order
+   * @param txn the transaction performing the insert
+   * @return true iff every insert succeeded
+   */
+  bool InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn);
+
+  /**
+   * Sets the fill factor for row pages: inserts fill a page only up to this fraction of its
+   * space and the remainder stays reserved as headroom, so later updates that grow a row can
+   * still succeed in place -- keeping the RID (and every index entry over it) valid instead of
+   * forcing the delete+reinsert fallback. Clamped to [0.5, 1.0]; the default of 1.0 reserves
+   * nothing. Affects future inserts only, and only the row layout (PAX slots are fixed-width).
+   * A tuple too large to fit alongside the headroom ignores it rather than become unstorable.
+   * @param fill_factor the fraction of a page's space inserts may fill
+   */
+  void SetFillFactor(double fill_factor);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param rid resource id of the tuple of delete
@@ -90,6 +178,32 @@ class TableHeap {
    */
   void RollbackDelete(const RID &rid, Transaction *txn);
 
+  /**
+   * Reclaims space left behind by applied deletes. Every page trims its trailing empty slots,
+   * and a page left with no stored rows at all is unlinked from the chain and freed back
+   * through the buffer pool, so an update-heavy table's chain stops growing forever. Live rows
+   * never move, so RIDs -- and the indexes built over them -- stay valid; rows tombstoned by
+   * in-flight transactions keep their pages. Walks the chain hand-over-hand under write
+   * latches. The caller must make sure no concurrent scan is positioned on the chain, since an
+   * unlinked page is deleted outright; the first page is never freed, as its id is the heap's
+   * identity.
+   * @return the number of pages freed
+   */
+  size_t Vacuum();
+
+  /**
+   * Splices another heap's page chain onto the tail of this one, so parallel bulk loads can
+   * build disjoint page runs and link them into one table at the end. Both heaps must live in
+   * the same buffer pool and use the same layout (and schema); the donor gives up its pages
+   * and must not be used afterwards. Row ids stay valid -- no row moves, pages just gain a
+   * predecessor -- and the donor's free-space knowledge carries over, so later inserts can
+   * fill the appended pages. Not safe against concurrent operations on either heap, and the
+   * receiving heap must have no registered indexes or zone map: the donor's rows were written
+   * past them.
+   * @param other the heap whose chain is appended; emptied by the call
+   */
+  void AppendChain(TableHeap *other);
+
   /**
    * Read a tuple from the table.
    * @param rid rid of the tuple to read
@@ -99,6 +213,119 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
+  /**
+   * Read a tuple without copying it out of the buffer pool: the page stays pinned and
+   * read-latched for the duration of the call and the consumer sees a non-owning view over the
+   * in-page bytes (a stack scratch row for PAX tables). Callers evaluate predicates and
+   * projections against the view and materialize only the survivors. Always takes the latched
+   * read path, so snapshot readers that need version-chain visibility should use GetTuple.
+   * @param rid rid of the tuple to read
+   * @param txn transaction performing the read
+   * @param consume invoked once with the view of the tuple
+   * @return true if the tuple exists and the consumer ran
+   */
+  bool GetTupleView(const RID &rid, Transaction *txn, const std::function<void(const Tuple &)> &consume);
+
+  /**
+   * Bulk read-only export of the whole table into Arrow-style column buffers. One walk of the
+   * page chain with read-ahead; each page's live rows are copied out raw in a single latched
+   * pass and transposed column by column straight from the stored bytes -- no Value objects,
+   * no per-row buffer pool traffic. The consumer runs once per page with the filled buffers
+   * and the page's row count; the buffers are reused across pages, so a consumer keeping the
+   * data must copy (or swap) it out. Rows are the committed stored bytes: dictionary codes and
+   * toast stubs are exported as stored, and in-flight rows of concurrent writers may or may
+   * not appear, exactly like a raw batch scan.
+   * @param schema the stored row layout to transpose against (normally GetSchema())
+   * @param consume invoked once per non-empty page with the column buffers and row count
+   * @return the total number of rows exported
+   */
+  size_t ExportColumnar(const Schema *schema, const std::function<void(std::vector<ColumnarBuffer> &, size_t)> &consume);
+
+  /**
+   * Returns the sampled page-id directory: entry i is the page at chain position
+   * i * DIRECTORY_INTERVAL. A parallel scan (or a future partitioned vacuum) can split the
+   * chain into balanced ranges without walking it -- each entry starts a run of
+   * DIRECTORY_INTERVAL pages ended by the next entry or the chain tail. The directory is
+   * maintained as inserts append pages and rebuilt by Vacuum; a heap opened by page id builds
+   * it with one chain walk on first request. The copy returned is a snapshot: pages appended
+   * after it are reached by walking past the last entry's run, exactly like a racing chain
+   * walk would.
+   * @return one page id per DIRECTORY_INTERVAL chain positions, starting with the first page
+   */
+  std::vector<page_id_t> GetPageDirectory();
+
+  /**
+   * Registers an index for this heap's write paths to maintain: inserts add its key entries,
+   * updates move them, and deletes remove them, so a registered index always reflects the
+   * table without every writer having to know about it. The caller (the catalog) retains
+   * ownership and must keep the index alive as long as the heap; the heap must have been
+   * created with a schema, since keys are extracted against it. Registering an index does not
+   * backfill it -- the catalog loads existing rows before handing the index over.
+   * @param index the index to maintain
+   */
+  void RegisterIndex(Index *index) {
+    BUSTUB_ASSERT(schema_ != nullptr, "Index maintenance needs the table schema to extract keys.");
+    indexes_.push_back(index);
+  }
+
+  /**
+   * Registers a zone map for this heap's write paths to maintain: every inserted or updated
+   * row widens its page's per-column ranges, so the map always covers the stored rows and a
+   * scan may trust it for pruning. Deletes never shrink ranges -- too wide only costs a page
+   * read, never correctness -- but vacuum drops the entries of pages it frees, since their
+   * ids can be recycled. The caller (the catalog) retains ownership and must keep the zone
+   * map alive as long as the heap; the heap must have been created with a schema, since
+   * ranges are widened against it. Registering does not backfill existing rows -- the
+   * catalog loads them before handing the zone map over.
+   * @param zone_map the zone map to maintain
+   */
+  void RegisterZoneMap(ZoneMap *zone_map) {
+    BUSTUB_ASSERT(schema_ != nullptr, "Zone map maintenance needs the table schema to read column values.");
+    zone_map_ = zone_map;
+  }
+
+  /**
+   * Pins every page of this table's chain for the heap's lifetime and wires the frames into a
+   * direct pointer array indexed by page id, so later accesses to those pages become a
+   * bounds-checked array deref instead of a buffer pool fetch -- no page table probe, no pin
+   * count traffic, no unpin. Meant for small hot lookup tables that are read on every query;
+   * the pins are never released, so a pinned table permanently occupies one frame per chain
+   * page and must be far smaller than the pool. Pages appended by later inserts, and overflow
+   * chains, keep going through the buffer pool as before. Dirty writes on pinned pages are
+   * forwarded with BufferPoolManager::MarkPageDirty, so flushing and recovery see them as
+   * usual. Call once, before the table sees concurrent access, like RegisterIndex.
+   * @return the number of pages pinned, 0 if the pool could not hold the whole chain
+   */
+  size_t PinForLifetime();
+
+  /**
+   * Joins the table's cooperative scan group. While at least one scan is attached, the group
+   * publishes the chain position the sweep is currently on; a scan that starts while another
+   * is in progress begins there instead of at the chain head, rides the same page fetches,
+   * and wraps around to cover the pages before its attach point -- so a dozen concurrent
+   * full scans read each page from disk roughly once instead of once each. Pair with
+   * LeaveSharedScan when the scan finishes or is abandoned.
+   * @return the position to attach at, or INVALID_PAGE_ID to lead a fresh sweep from the head
+   */
+  page_id_t JoinSharedScan() {
+    if (shared_scan_readers_.fetch_add(1, std::memory_order_acq_rel) == 0) {
+      return INVALID_PAGE_ID;
+    }
+    return shared_scan_cursor_.load(std::memory_order_acquire);
+  }
+
+  /** Publishes the page a joined scan has advanced to; attachers start from the latest one. */
+  void PublishScanPosition(page_id_t page_id) {
+    shared_scan_cursor_.store(page_id, std::memory_order_release);
+  }
+
+  /** Leaves the cooperative scan group; the last scan out retires the published position. */
+  void LeaveSharedScan() {
+    if (shared_scan_readers_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      shared_scan_cursor_.store(INVALID_PAGE_ID, std::memory_order_release);
+    }
+  }
+
   /** @return the begin iterator of this table */
   TableIterator Begin(Transaction *txn);
 
@@ -108,11 +335,160 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /** @return the page layout of this table */
+  inline TableLayout GetLayout() const { return layout_; }
+
+  /**
+   * @return the table schema, when the heap was created with one, or nullptr. PAX pages are
+   * addressed through it; row-layout heaps use it to move large varlen payloads out of line.
+   */
+  inline const Schema *GetSchema() const { return schema_.get(); }
+
+  /**
+   * @return true when the stored row holds at least one out-of-line (toasted) varlen entry.
+   * Such a row must go through the heap's detoasting read paths before its values are used;
+   * in-page scans use this to defer toasted rows past the page latch.
+   */
+  static bool IsToasted(const Tuple &tuple, const Schema *schema);
+
  private:
+  /** Stored rows larger than this have their big varlen payloads moved out of line. */
+  static constexpr uint32_t TOAST_THRESHOLD = PAGE_SIZE / 4;
+  /** Only payloads at least this large are worth an overflow chain of their own. */
+  static constexpr uint32_t TOAST_MIN_PAYLOAD = 256;
+  /** Length marker flagging a varlen entry as an overflow pointer; no real length gets here. */
+  static constexpr uint32_t TOAST_MARKER = 0xFFFFFFFE;
+  /** An overflow pointer entry: | MARKER (4) | FIRST PAGE ID (4) | PAYLOAD LENGTH (4) | */
+  static constexpr uint32_t SIZE_TOAST_ENTRY = 12;
+
+  /** The PAX counterpart of the insert loop: walk the chain for a page with a free slot. */
+  bool PaxInsertTuple(const Tuple &tuple, RID *rid, Transaction *txn);
+  /** The row-layout insert loop; stored goes into the page, original into the version chain. */
+  bool RowInsertTuple(const Tuple &stored, const Tuple &original, RID *rid, Transaction *txn);
+  /** The GetTuple body; returns the row as stored, overflow pointer entries included. */
+  bool GetTupleInternal(const RID &rid, Tuple *tuple, Transaction *txn);
+  /** Rewrites a row's large varlen payloads into overflow chains, leaving pointer entries. */
+  Tuple ToastTuple(const Tuple &tuple);
+  /** Replaces every overflow pointer entry of a stored row with its full in-line payload. */
+  void DetoastTuple(Tuple *tuple);
+  /** Appends the first page id of every overflow chain a stored row points at. */
+  void CollectOverflowChains(const Tuple &tuple, std::vector<page_id_t> *chains);
+  /** Writes a payload into a fresh overflow chain. @return the first page id of the chain */
+  page_id_t WriteOverflowChain(const char *data, uint32_t size);
+  /** Reads a chained payload of the given length back into a buffer. */
+  void ReadOverflowChain(page_id_t first_page_id, char *out, uint32_t size);
+  /** Deletes every page of an overflow chain. */
+  void FreeOverflowChain(page_id_t first_page_id);
+  /** @return true when the page is lifetime-pinned and served from the direct frame array */
+  bool IsPinnedPage(page_id_t page_id) const {
+    return static_cast<size_t>(page_id) < pinned_pages_.size() && pinned_pages_[page_id] != nullptr;
+  }
+
+  /**
+   * Resolves one of this heap's pages: a lifetime-pinned page is a direct array deref, anything
+   * else goes through the buffer pool. Every page access of the heap (and its iterator) funnels
+   * through here and UnpinHeapPage, so pinning a table speeds up all paths at once.
+   */
+  Page *FetchHeapPage(page_id_t page_id) {
+    if (IsPinnedPage(page_id)) {
+      return pinned_pages_[page_id];
+    }
+    return buffer_pool_manager_->FetchPage(page_id);
+  }
+
+  /** Releases a page taken with FetchHeapPage. A lifetime-pinned page keeps its pin and only
+   * has its dirty bit forwarded to the pool. */
+  void UnpinHeapPage(page_id_t page_id, bool is_dirty) {
+    if (IsPinnedPage(page_id)) {
+      if (is_dirty) {
+        buffer_pool_manager_->MarkPageDirty(page_id);
+      }
+      return;
+    }
+    buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+  }
+
+  /** Notes a page appended to the chain tail, sampling it into the directory as needed. */
+  void RecordAppendedPage(page_id_t page_id);
+  /**
+   * Allocates a page for this heap through the buffer pool, marking it compressed with the
+   * disk manager when the table opted in. Every page of a compressed table must be allocated
+   * through here so it is marked before its first flush.
+   * @param[out] page_id id of the new page
+   * @return the new page, or nullptr if the buffer pool could not provide one
+   */
+  Page *AllocatePage(page_id_t *page_id);
+  /**
+   * Records a row page's current free space in the free space map. Free bytes are coarsened to
+   * one of FSM_CATEGORIES fill levels; a page in category c is good for any request of up to
+   * c * PAGE_SIZE / FSM_CATEGORIES bytes. Called with the page latched so the sample is exact,
+   * though entries are allowed to go stale -- candidates are re-verified by the insert itself.
+   */
+  void UpdateFreeSpaceMap(page_id_t page_id, uint32_t free_bytes);
+  /** Drops a freed page from the free space map. */
+  void EraseFromFreeSpaceMap(page_id_t page_id);
+  /**
+   * @return a page whose last recorded free space covers a request of `size` bytes, or
+   * INVALID_PAGE_ID. O(1): pops stale bucket entries as it finds them but never walks the chain.
+   */
+  page_id_t GetInsertCandidate(uint32_t size);
+  /**
+   * Takes the table-granularity locks for one operation and decides the row-lock granularity.
+   * The table is locked in intention mode first; each row lock is counted, and once the
+   * transaction crosses the lock manager's escalation threshold it trades its intention lock for
+   * a full table lock. Returns the lock manager to use for row-level locking, or nullptr when the
+   * transaction already holds (or just escalated to) a table lock covering the access.
+   * @param txn the transaction performing the operation, may be nullptr during recovery
+   * @param write true when the operation modifies the table
+   * @return the lock manager for row locks, or nullptr when no row lock is needed
+   */
+  LockManager *RowLockManager(Transaction *txn, bool write);
+
+  /** Adds the row's key to every registered index. */
+  void InsertIndexEntries(const Tuple &tuple, RID rid, Transaction *txn);
+  /** Removes the row's key from every registered index. */
+  void DeleteIndexEntries(const Tuple &tuple, RID rid, Transaction *txn);
+  /** Widens the registered zone map's ranges for the row's page, when one is registered. */
+  void WidenZoneMap(const Tuple &tuple, RID rid);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  TableLayout layout_{TableLayout::ROW};
+  /** Owned copy of the schema; set when the heap is created with one, see GetSchema(). */
+  std::unique_ptr<Schema> schema_;
+  /** True when this is a row-layout heap with a varlen schema, i.e. writes may toast. */
+  bool toastable_{false};
+  /** True when this table's pages are stored compressed on disk, see AllocatePage. */
+  bool compressed_{false};
+  /** Indexes maintained by this heap's write paths, owned by the catalog. See RegisterIndex. */
+  std::vector<Index *> indexes_;
+  /** Zone map maintained by this heap's write paths, owned by the catalog. See RegisterZoneMap. */
+  ZoneMap *zone_map_{nullptr};
+  /** Direct frame pointers, indexed by page id, of a lifetime-pinned table; empty until
+   * PinForLifetime runs. Unmapped ids hold nullptr and fall through to the buffer pool. */
+  std::vector<Page *> pinned_pages_;
+  /** Free-space bytes inserts leave in each row page, derived from the fill factor. */
+  uint32_t insert_reserved_{0};
+  /** Protects the page directory against concurrent appenders and readers. */
+  std::mutex directory_latch_;
+  /** Every DIRECTORY_INTERVAL-th page of the chain; empty until built, see GetPageDirectory(). */
+  std::vector<page_id_t> page_directory_;
+  /** The chain length the directory reflects; positions appended since are sampled on arrival. */
+  size_t page_count_{0};
+  /** Fill levels the free space map distinguishes, see UpdateFreeSpaceMap. */
+  static constexpr size_t FSM_CATEGORIES = 8;
+  /** Protects the free space map. Row layout only; PAX pages track slots, not bytes. */
+  std::mutex fsm_latch_;
+  /** Scans currently attached to the cooperative scan group, see JoinSharedScan. */
+  std::atomic<uint32_t> shared_scan_readers_{0};
+  /** The chain position the shared sweep last published, INVALID_PAGE_ID when none is live. */
+  std::atomic<page_id_t> shared_scan_cursor_{INVALID_PAGE_ID};
+  /** Each row page's current fill category, the authority when a bucket entry disagrees. */
+  std::unordered_map<page_id_t, size_t> fsm_category_;
+  /** Pages by fill category; entries go stale lazily and are dropped when popped. */
+  std::vector<std::vector<page_id_t>> fsm_buckets_{FSM_CATEGORIES};
 };
 
 }  // namespace bustub
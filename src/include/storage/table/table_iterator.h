@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cassert>
+#include <vector>
 
 #include "common/rid.h"
 #include "concurrency/transaction.h"
@@ -24,6 +25,10 @@ class TableHeap;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
+ *
+ * The iterator works a page at a time: one latch acquisition materializes every live row of
+ * the current page into a local buffer, so advancing to the next row is an index bump and a
+ * tuple move instead of a buffer pool fetch, a latch round trip, and a slot probe per row.
  */
 class TableIterator {
   friend class Cursor;
@@ -46,9 +51,36 @@ class TableIterator {
   TableIterator operator++(int);
 
  private:
+  /**
+   * Copies every live row of the given page into page_tuples_ under one latch and records the
+   * page's successor in next_page_id_. Toasted rows are reassembled and MVCC-visible versions
+   * resolved after the latch drops. @return true if the page yielded at least one row
+   */
+  template <typename PageType>
+  bool LoadPage(page_id_t page_id);
+
+  /** Walks the page chain from the given page until one yields rows, then points tuple_ at its
+   *  first row; positions the iterator at End() if the chain runs out. */
+  void SeekPage(page_id_t page_id);
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** The current page's live rows, materialized once per page; operator++ consumes them. */
+  std::vector<Tuple> page_tuples_;
+  /** Index of the current row within page_tuples_. */
+  size_t page_idx_{0};
+  /** The page after the one page_tuples_ came from, INVALID_PAGE_ID at the end of the chain. */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+
+  /** Readahead never requests more than this many pages ahead of the scan. */
+  static constexpr page_id_t MAX_READAHEAD_PAGES = 64;
+  /** The previous page this iterator loaded, for detecting physically sequential chains. */
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  /** Current readahead window in pages; grows on confirmed sequential access, resets on a jump. */
+  page_id_t readahead_window_{1};
+  /** Highest page id already handed to the prefetcher, so windows do not re-request overlap. */
+  page_id_t readahead_high_water_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
@@ -17,23 +17,39 @@
 
 #include "catalog/schema.h"
 #include "common/rid.h"
+#include "type/abstract_pool.h"
 #include "type/value.h"
 
 namespace bustub {
 
 /**
  * Tuple format:
- * ---------------------------------------------------------------------
- * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD |
- * ---------------------------------------------------------------------
+ * ------------------------------------------------------------------------------------
+ * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD | NULL BITMAP |
+ * ------------------------------------------------------------------------------------
+ * The fixed-width section keeps one full-width slot per column at the schema's static offsets,
+ * so column address computation never depends on the row's data (compiled predicates bake the
+ * offsets in). A null inlined column stores its type's null sentinel in that slot; a null
+ * varlen column stores no payload at all, which is where sparse rows get their savings. The
+ * bitmap trails the tuple (one bit per column) so the sections before it keep their layout.
  */
 class Tuple {
   friend class TablePage;
 
+  friend class PaxTablePage;
+
   friend class TableHeap;
 
   friend class TableIterator;
 
+  friend class TupleBatch;
+
+  friend class RowSerializer;
+
+  friend class JoinOutputStager;
+
+  friend class ResultCursor;
+
  public:
   // Default constructor (to create a dummy tuple)
   Tuple() = default;
@@ -50,13 +66,41 @@ class Tuple {
   // assign operator, deep copy
   Tuple &operator=(const Tuple &other);
 
-  ~Tuple() {
-    if (allocated_) {
-      delete[] data_;
+  // move constructor: steals the buffer -- and, for a pool-backed buffer, the pool that must
+  // release it -- leaving the source empty. No bytes are touched, so moving tuples through
+  // batches and hash tables is free where copying paid a full memcpy.
+  Tuple(Tuple &&other) noexcept
+      : allocated_(other.allocated_),
+        rid_(other.rid_),
+        size_(other.size_),
+        data_(other.data_),
+        pool_(other.pool_),
+        pool_backed_(other.pool_backed_) {
+    other.allocated_ = false;
+    other.pool_backed_ = false;
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  // move assignment: releases the current buffer, then steals as the move constructor does
+  Tuple &operator=(Tuple &&other) noexcept {
+    if (this != &other) {
+      FreeData();
+      allocated_ = other.allocated_;
+      rid_ = other.rid_;
+      size_ = other.size_;
+      data_ = other.data_;
+      pool_ = other.pool_;
+      pool_backed_ = other.pool_backed_;
+      other.allocated_ = false;
+      other.pool_backed_ = false;
+      other.data_ = nullptr;
+      other.size_ = 0;
     }
-    allocated_ = false;
-    data_ = nullptr;
+    return *this;
   }
+
+  ~Tuple() { FreeData(); }
   // serialize tuple data
   void SerializeTo(char *storage) const;
 
@@ -66,6 +110,9 @@ class Tuple {
   // return RID of current tuple
   inline RID GetRid() const { return rid_; }
 
+  // set rid, used by executors materializing a projected row that still identifies its source
+  inline void SetRid(RID rid) { rid_ = rid; }
+
   // Get the address of this tuple in the table's backing store
   inline char *GetData() const { return data_; }
 
@@ -76,23 +123,73 @@ class Tuple {
   // checks the schema to see how to return the Value.
   Value GetValue(const Schema *schema, uint32_t column_idx) const;
 
-  // Is the column value null ?
+  // Builds an index key over this tuple: the key_attrs columns are read against the tuple's
+  // schema and re-serialized against the key schema.
+  Tuple KeyFromTuple(const Schema *schema, const Schema *key_schema, const std::vector<uint32_t> &key_attrs) const;
+
+  // Is the column value null? Reads the trailing null bitmap.
   inline bool IsNull(const Schema *schema, uint32_t column_idx) const {
-    Value value = GetValue(schema, column_idx);
-    return value.IsNull();
+    const char *bitmap = data_ + size_ - NullBitmapSize(schema);
+    return (bitmap[column_idx / 8] & (1U << (column_idx % 8))) != 0;
   }
+
+  /** @return the size in bytes of the null bitmap that trails every tuple over the schema */
+  static inline uint32_t NullBitmapSize(const Schema *schema) { return (schema->GetColumnCount() + 7) / 8; }
   inline bool IsAllocated() { return allocated_; }
 
+  /**
+   * Directs this tuple's future buffer allocations to the given pool instead of the heap.
+   * Pool-backed buffers are not freed individually -- the pool reclaims them wholesale -- so
+   * the pool must outlive the tuple. A buffer the tuple already holds keeps its original
+   * allocator. Copies of this tuple do not inherit the pool.
+   */
+  void SetPool(AbstractPool *pool) { pool_ = pool; }
+
   std::string ToString(const Schema *schema) const;
 
  private:
   // Get the starting storage address of specific column
   const char *GetDataPtr(const Schema *schema, uint32_t column_idx) const;
 
+  /**
+   * Points data_ at a fresh buffer of the given size, releasing the current one. Bytes come
+   * from pool_ when one is set, otherwise from the heap. Every owning write into a tuple goes
+   * through here so a pooled tuple never touches malloc.
+   */
+  char *ResizeData(uint32_t size) {
+    FreeData();
+    size_ = size;
+    if (pool_ != nullptr) {
+      data_ = static_cast<char *>(pool_->Allocate(size));
+      pool_backed_ = true;
+    } else {
+      data_ = new char[size];
+    }
+    allocated_ = true;
+    return data_;
+  }
+
+  /** Releases the current buffer: back to its pool if pool-backed, otherwise to the heap. */
+  void FreeData() {
+    if (allocated_) {
+      if (pool_backed_) {
+        pool_->Free(data_);
+      } else {
+        delete[] data_;
+      }
+    }
+    allocated_ = false;
+    pool_backed_ = false;
+    data_ = nullptr;
+  }
+
   bool allocated_{false};  // is allocated?
   RID rid_{};              // if pointing to the table heap, the rid is valid
   uint32_t size_{0};
   char *data_{nullptr};
+  /** When set, ResizeData draws from this pool; the data_ buffer is then pool_backed_. */
+  AbstractPool *pool_{nullptr};
+  bool pool_backed_{false};
 };
 
 }  // namespace bustub
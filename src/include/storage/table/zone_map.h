@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ZoneMap keeps per-page min/max values for a designated set of columns of one table heap, as
+ * a sidecar structure owned by the catalog and maintained by the heap's write paths. A scan
+ * whose predicate compares a mapped column against a constant can skip every page whose
+ * recorded range cannot contain a match -- on an append-mostly table with a correlated column
+ * (a timestamp, a serial key) that is most of them.
+ *
+ * Ranges only ever widen: inserts and updates extend them, deletes do not shrink them. A too
+ * wide range costs a page read that pruning could have saved, never a wrong answer. Rows with
+ * a NULL in a mapped column leave its range alone, which is also safe -- a comparison against
+ * NULL never passes a scan's filter, so a page holding only NULLs beyond its range still has
+ * nothing a pruned predicate could match.
+ *
+ * The map also caches each page's chain successor as scans and the heap discover them, so a
+ * later scan can step over a pruned page without fetching it just for the next-page pointer.
+ * Vacuum relinks the chain, so it drops the cached links and the entries of freed pages --
+ * the buffer pool recycles page ids, and a stale range on a recycled id could prune wrongly.
+ */
+class ZoneMap {
+ public:
+  /**
+   * Creates a zone map over the given columns.
+   * @param cols the mapped columns, as storage-schema column indexes
+   */
+  explicit ZoneMap(std::vector<uint32_t> cols) : cols_(std::move(cols)) {}
+
+  /** @return the mapped columns, as storage-schema column indexes */
+  const std::vector<uint32_t> &GetColumns() const { return cols_; }
+
+  /**
+   * Widens a page's ranges to cover one stored row.
+   * @param page_id the page the row landed on
+   * @param tuple the row, against the storage schema
+   * @param schema the storage schema
+   */
+  void Update(page_id_t page_id, const Tuple &tuple, const Schema *schema) {
+    std::lock_guard<std::mutex> guard(latch_);
+    PageEntry &entry = Entry(page_id);
+    for (size_t i = 0; i < cols_.size(); i++) {
+      Value val = tuple.GetValue(schema, cols_[i]);
+      if (val.IsNull()) {
+        continue;
+      }
+      if (entry.mins_[i].GetTypeId() == TypeId::INVALID || val.CompareLessThan(entry.mins_[i]) == CmpBool::CmpTrue) {
+        entry.mins_[i] = val;
+      }
+      if (entry.maxs_[i].GetTypeId() == TypeId::INVALID ||
+          val.CompareGreaterThan(entry.maxs_[i]) == CmpBool::CmpTrue) {
+        entry.maxs_[i] = val;
+      }
+    }
+  }
+
+  /**
+   * Reads a page's recorded range for one mapped column.
+   * @param page_id the page to look up
+   * @param col_idx the column, as a storage-schema column index
+   * @param[out] min the smallest non-null value recorded for the page
+   * @param[out] max the largest non-null value recorded for the page
+   * @return true with the range copied out, or false if the column is not mapped or the page
+   * has no recorded non-null value -- in which case the page cannot be pruned
+   */
+  bool GetRange(page_id_t page_id, uint32_t col_idx, Value *min, Value *max) const {
+    size_t slot = cols_.size();
+    for (size_t i = 0; i < cols_.size(); i++) {
+      if (cols_[i] == col_idx) {
+        slot = i;
+        break;
+      }
+    }
+    if (slot == cols_.size()) {
+      return false;
+    }
+    std::lock_guard<std::mutex> guard(latch_);
+    auto it = pages_.find(page_id);
+    if (it == pages_.end() || it->second.mins_.empty() || it->second.mins_[slot].GetTypeId() == TypeId::INVALID) {
+      return false;
+    }
+    *min = it->second.mins_[slot];
+    *max = it->second.maxs_[slot];
+    return true;
+  }
+
+  /** Caches a page's chain successor, so pruned pages can be stepped over without a fetch. */
+  void SetNextPage(page_id_t page_id, page_id_t next_page_id) {
+    std::lock_guard<std::mutex> guard(latch_);
+    PageEntry &entry = Entry(page_id);
+    entry.next_ = next_page_id;
+    entry.has_next_ = true;
+  }
+
+  /** @return true with the cached chain successor of a page copied out, false if unknown */
+  bool GetNextPage(page_id_t page_id, page_id_t *next_page_id) const {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto it = pages_.find(page_id);
+    if (it == pages_.end() || !it->second.has_next_) {
+      return false;
+    }
+    *next_page_id = it->second.next_;
+    return true;
+  }
+
+  /** Drops a freed page's entry; its id may be recycled for unrelated rows. */
+  void ErasePage(page_id_t page_id) {
+    std::lock_guard<std::mutex> guard(latch_);
+    pages_.erase(page_id);
+  }
+
+  /** Drops every cached chain successor; called when vacuum has relinked the chain. */
+  void InvalidateChainLinks() {
+    std::lock_guard<std::mutex> guard(latch_);
+    for (auto &[page_id, entry] : pages_) {
+      entry.has_next_ = false;
+    }
+  }
+
+ private:
+  /** One page's ranges (parallel to cols_) and cached chain successor. */
+  struct PageEntry {
+    /** Per-column range bounds; INVALID-typed until a non-null value is recorded. */
+    std::vector<Value> mins_;
+    std::vector<Value> maxs_;
+    /** The page's chain successor, valid when has_next_. */
+    page_id_t next_{INVALID_PAGE_ID};
+    bool has_next_{false};
+  };
+
+  /** Returns the page's entry, creating it with empty ranges on first touch. Caller latches. */
+  PageEntry &Entry(page_id_t page_id) {
+    PageEntry &entry = pages_[page_id];
+    if (entry.mins_.empty()) {
+      entry.mins_.resize(cols_.size(), Value(TypeId::INVALID));
+      entry.maxs_.resize(cols_.size(), Value(TypeId::INVALID));
+    }
+    return entry;
+  }
+
+  /** Guards pages_; writers come from the heap's write paths, readers from scans. */
+  mutable std::mutex latch_;
+  /** The mapped columns, as storage-schema column indexes. */
+  std::vector<uint32_t> cols_;
+  /** pages_ : page id -> that page's ranges and cached successor. */
+  std::unordered_map<page_id_t, PageEntry> pages_;
+};
+
+}  // namespace bustub
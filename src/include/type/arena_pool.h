@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool.h
+//
+// Identification: src/include/type/arena_pool.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "type/abstract_pool.h"
+
+namespace bustub {
+
+/**
+ * ArenaPool is a chunked bump allocator behind the AbstractPool interface. Allocate hands out
+ * 8-byte-aligned slices of large chunks, so a scan that materializes millions of tuples pays a
+ * pointer bump per row instead of a malloc round-trip. Free rolls back only the most recent
+ * allocation -- which makes the common reused-scratch-tuple pattern (free, then reallocate the
+ * same bytes) run in place -- and everything else is reclaimed wholesale by Reset or the
+ * destructor. Not thread-safe; parallel operators keep their per-worker copies on the heap.
+ */
+class ArenaPool : public AbstractPool {
+ public:
+  /** Chunk size; sized so one chunk absorbs many small tuples but any single page-sized
+   * allocation still fits. Larger requests get a dedicated chunk. */
+  static constexpr size_t CHUNK_SIZE = 4096;
+
+  void *Allocate(size_t size) override {
+    // Keep every slice 8-byte aligned so tuple readers can reinterpret fixed-width columns.
+    size = (size + 7) & ~static_cast<size_t>(7);
+    while (chunk_ < chunks_.size() && used_ + size > chunks_[chunk_].capacity_) {
+      chunk_++;
+      used_ = 0;
+    }
+    if (chunk_ >= chunks_.size()) {
+      size_t capacity = std::max(size, CHUNK_SIZE);
+      chunks_.push_back(Chunk{std::unique_ptr<char[]>(new char[capacity]), capacity});
+      used_ = 0;
+    }
+    last_chunk_ = chunk_;
+    last_used_ = used_;
+    last_alloc_ = chunks_[chunk_].data_.get() + used_;
+    used_ += size;
+    return last_alloc_;
+  }
+
+  /**
+   * Rolls the bump pointer back if this was the most recent allocation; any other pointer is a
+   * no-op and its bytes stay in the arena until Reset.
+   */
+  void Free(void *ptr) override {
+    if (ptr != nullptr && ptr == last_alloc_) {
+      chunk_ = last_chunk_;
+      used_ = last_used_;
+      last_alloc_ = nullptr;
+    }
+  }
+
+  /** Reclaims every allocation at once. Chunks are retained for reuse. */
+  void Reset() {
+    chunk_ = 0;
+    used_ = 0;
+    last_alloc_ = nullptr;
+  }
+
+ private:
+  struct Chunk {
+    std::unique_ptr<char[]> data_;
+    size_t capacity_;
+  };
+
+  std::vector<Chunk> chunks_;
+  /** Index of the chunk currently being bump-allocated from. */
+  size_t chunk_{0};
+  /** Bytes consumed in the current chunk. */
+  size_t used_{0};
+  /** The most recent allocation, for the rollback fast path in Free. */
+  void *last_alloc_{nullptr};
+  size_t last_chunk_{0};
+  size_t last_used_{0};
+};
+
+}  // namespace bustub
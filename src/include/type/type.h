@@ -15,6 +15,7 @@
 #include <cstdint>
 #include <string>
 
+#include "common/macros.h"
 #include "type/type_id.h"
 
 namespace bustub {
@@ -28,11 +29,77 @@ class Type {
   explicit Type(TypeId type_id) : type_id_(type_id) {}
 
   virtual ~Type() = default;
-  // Get the size of this data type in bytes
-  static uint64_t GetTypeSize(TypeId type_id);
+
+  // Out-of-line so the constexpr size lookup below does not need the Exception definition
+  // here; common/exception.h includes this header. Never reached in constant evaluation.
+  [[noreturn]] static void ThrowUnknownTypeException();
+
+  // Get the size of this data type in bytes. constexpr so that sizes -- and the column offsets
+  // computed from them -- fold to compile-time constants wherever the type id is one, instead
+  // of costing an out-of-line call per column per tuple.
+  static constexpr uint64_t GetTypeSize(const TypeId type_id) {
+    switch (type_id) {
+      case BOOLEAN:
+      case TINYINT:
+        return 1;
+      case SMALLINT:
+        return 2;
+      case INTEGER:
+        return 4;
+      case BIGINT:
+      case DECIMAL:
+      case TIMESTAMP:
+        return 8;
+      case VARCHAR:
+        return 0;
+      default:
+        ThrowUnknownTypeException();
+    }
+  }
 
   // Is this type coercable from the other type
-  bool IsCoercableFrom(TypeId type_id) const;
+  constexpr bool IsCoercableFrom(const TypeId type_id) const {
+    switch (type_id_) {
+      case INVALID:
+        return false;
+      case BOOLEAN:
+        return true;
+      case TINYINT:
+      case SMALLINT:
+      case INTEGER:
+      case BIGINT:
+      case DECIMAL:
+        switch (type_id) {
+          case TINYINT:
+          case SMALLINT:
+          case INTEGER:
+          case BIGINT:
+          case DECIMAL:
+          case VARCHAR:
+            return true;
+          default:
+            return false;
+        }
+      case TIMESTAMP:
+        return (type_id == VARCHAR || type_id == TIMESTAMP);
+      case VARCHAR:
+        switch (type_id) {
+          case BOOLEAN:
+          case TINYINT:
+          case SMALLINT:
+          case INTEGER:
+          case BIGINT:
+          case DECIMAL:
+          case TIMESTAMP:
+          case VARCHAR:
+            return true;
+          default:
+            return false;
+        }
+      default:
+        return (type_id == type_id_);
+    }  // END SWITCH
+  }
 
   // Debug info
   static std::string TypeIdToString(TypeId type_id);
@@ -14,10 +14,12 @@
 
 #include <cstring>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 #include "type/limits.h"
 #include "type/type.h"
+#include "type/varlen_pool.h"
 
 namespace bustub {
 
@@ -39,6 +41,8 @@ class Value {
   friend class TimestampType;
   friend class BooleanType;
   friend class VarlenType;
+  // Writes payloads straight out of the union, bypassing the virtual SerializeTo per column.
+  friend class RowSerializer;
 
  public:
   explicit Value(const TypeId type) : manage_data_(false), type_id_(type) { size_.len_ = BUSTUB_VALUE_NULL; }
@@ -60,14 +64,53 @@ class Value {
   Value(TypeId type, const std::string &data);
 
   Value() : Value(TypeId::INVALID) {}
-  Value(const Value &other);
+
+  // Copying a fixed-width value is a plain memberwise copy -- no allocation, no virtual Copy,
+  // one predictable branch. Only an owning VARCHAR clones its buffer. Inline on purpose: keys
+  // built from Values (every AggregateKey) copy them in tight loops.
+  Value(const Value &other)
+      : value_(other.value_), size_(other.size_), manage_data_(other.manage_data_), type_id_(other.type_id_) {
+    if (type_id_ == TypeId::VARCHAR) {
+      if (size_.len_ == BUSTUB_VALUE_NULL) {
+        value_.varlen_ = nullptr;
+      } else if (manage_data_) {
+        value_.varlen_ = AllocateVarlen(size_.len_);
+        memcpy(value_.varlen_, other.value_.varlen_, size_.len_);
+      }
+    }
+  }
+
+  // Moving steals an owning VARCHAR's buffer instead of cloning it, so vectors of Value
+  // relocate without touching the heap.
+  Value(Value &&other) noexcept
+      : value_(other.value_),
+        size_(other.size_),
+        manage_data_(other.manage_data_),
+        pool_backed_(other.pool_backed_),
+        type_id_(other.type_id_) {
+    other.manage_data_ = false;
+  }
+
   Value &operator=(Value other);
-  ~Value();
+
+  ~Value() {
+    if (type_id_ == TypeId::VARCHAR && manage_data_) {
+      if (pool_backed_) {
+        // Best-effort rollback; the arena reclaims the buffer wholesale either way.
+        if (VarlenPool::Current() != nullptr) {
+          VarlenPool::Current()->Free(value_.varlen_);
+        }
+      } else {
+        delete[] value_.varlen_;
+      }
+    }
+  }
   // NOLINTNEXTLINE
   friend void Swap(Value &first, Value &second) {
     std::swap(first.value_, second.value_);
     std::swap(first.size_, second.size_);
     std::swap(first.manage_data_, second.manage_data_);
+    std::swap(first.pool_backed_, second.pool_backed_);
     std::swap(first.type_id_, second.type_id_);
   }
   // check whether value is integer
@@ -151,12 +194,31 @@ class Value {
     const char *const_varlen_;
   } value_;
 
+  // The copy fast path above is only a memberwise copy because the payload itself is trivial.
+  static_assert(std::is_trivially_copyable<Val>::value, "Value's payload union must stay trivially copyable");
+
   union {
     uint32_t len_;
     TypeId elem_type_id_;
   } size_;
 
+  /**
+   * Allocates a buffer for an owning varchar: from this thread's scoped VarlenPool when one is
+   * installed (marking the value pool-backed), otherwise from the heap.
+   */
+  char *AllocateVarlen(uint32_t len) {
+    auto *pool = VarlenPool::Current();
+    if (pool != nullptr) {
+      pool_backed_ = true;
+      return static_cast<char *>(pool->Allocate(len));
+    }
+    pool_backed_ = false;
+    return new char[len];
+  }
+
   bool manage_data_;
+  /** True when varlen_ came from a scoped VarlenPool; such a buffer is never delete[]d. */
+  bool pool_backed_{false};
   // The data type
   TypeId type_id_;
 };
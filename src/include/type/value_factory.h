@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 
 #include "common/macros.h"
 #include "common/util/string_util.h"
@@ -33,6 +34,12 @@ namespace bustub {
 //===--------------------------------------------------------------------===//
 
 class ValueFactory {
+  // The factories below hand values back by value in the hottest loops of the system; they are
+  // only cheap while a Value moves without throwing or allocating and stays a few words big.
+  // These guards fail the build if Value regains a nontrivial representation.
+  static_assert(std::is_nothrow_move_constructible<Value>::value, "Value must move without allocating");
+  static_assert(sizeof(Value) <= 24, "Value must stay register-friendly; factories copy them freely");
+
  public:
   static inline Value Clone(const Value &src, __attribute__((__unused__)) AbstractPool *dataPool = nullptr) {
     return src.Copy();
@@ -150,21 +157,10 @@ class ValueFactory {
           }
           return ValueFactory::GetBigIntValue(static_cast<int64_t>(value.GetAs<double>()));
         }
-        case TypeId::VARCHAR: {
-          std::string str = value.ToString();
-          int64_t bigint = 0;
-          try {
-            bigint = stoll(str);
-          } catch (std::out_of_range &e) {
-            throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-          } catch (std::invalid_argument &e) {
-            throw Exception("Invalid input syntax for bigint: \'" + str + "\'");
-          }
-          if (bigint > BUSTUB_INT64_MAX || bigint < BUSTUB_INT64_MIN) {
-            throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-          }
-          return ValueFactory::GetBigIntValue(bigint);
-        }
+        case TypeId::VARCHAR:
+          // The varlen cast parses the buffer in place instead of round-tripping the
+          // characters through a std::string; so do the cases below.
+          return value.CastAs(TypeId::BIGINT);
         default:
           break;
       }
@@ -198,22 +194,8 @@ class ValueFactory {
           }
           return ValueFactory::GetIntegerValue(static_cast<int32_t>(value.GetAs<double>()));
         }
-        case TypeId::VARCHAR: {
-          std::string str = value.ToString();
-          int32_t integer = 0;
-          try {
-            integer = stoi(str);
-          } catch (std::out_of_range &e) {
-            throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-          } catch (std::invalid_argument &e) {
-            throw Exception("Invalid input syntax for integer: \'" + str + "\'");
-          }
-
-          if (integer > BUSTUB_INT32_MAX || integer < BUSTUB_INT32_MIN) {
-            throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-          }
-          return ValueFactory::GetIntegerValue(integer);
-        }
+        case TypeId::VARCHAR:
+          return value.CastAs(TypeId::INTEGER);
         default:
           break;
       }
@@ -252,21 +234,8 @@ class ValueFactory {
           }
           return ValueFactory::GetSmallIntValue(static_cast<int16_t>(value.GetAs<double>()));
         }
-        case TypeId::VARCHAR: {
-          std::string str = value.ToString();
-          int16_t smallint = 0;
-          try {
-            smallint = static_cast<int16_t>(stoi(str));
-          } catch (std::out_of_range &e) {
-            throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-          } catch (std::invalid_argument &e) {
-            throw Exception("Invalid input syntax for smallint: \'" + str + "\'");
-          }
-          if (smallint < BUSTUB_INT16_MIN) {
-            throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-          }
-          return ValueFactory::GetSmallIntValue(smallint);
-        }
+        case TypeId::VARCHAR:
+          return value.CastAs(TypeId::SMALLINT);
         default:
           break;
       }
@@ -310,21 +279,8 @@ class ValueFactory {
           }
           return ValueFactory::GetTinyIntValue(static_cast<int8_t>(value.GetAs<double>()));
         }
-        case TypeId::VARCHAR: {
-          std::string str = value.ToString();
-          int8_t tinyint = 0;
-          try {
-            tinyint = static_cast<int8_t>(stoi(str));
-          } catch (std::out_of_range &e) {
-            throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-          } catch (std::invalid_argument &e) {
-            throw Exception("Invalid input syntax for tinyint: \'" + str + "\'");
-          }
-          if (tinyint < BUSTUB_INT8_MIN) {
-            throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-          }
-          return ValueFactory::GetTinyIntValue(tinyint);
-        }
+        case TypeId::VARCHAR:
+          return value.CastAs(TypeId::TINYINT);
         default:
           break;
       }
@@ -348,21 +304,8 @@ class ValueFactory {
           return ValueFactory::GetDecimalValue(static_cast<double>(value.GetAs<int64_t>()));
         case TypeId::DECIMAL:
           return ValueFactory::GetDecimalValue(value.GetAs<double>());
-        case TypeId::VARCHAR: {
-          std::string str = value.ToString();
-          double res = 0;
-          try {
-            res = stod(str);
-          } catch (std::out_of_range &e) {
-            throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-          } catch (std::invalid_argument &e) {
-            throw Exception("Invalid input syntax for decimal: \'" + str + "\'");
-          }
-          if (res > BUSTUB_DECIMAL_MAX || res < BUSTUB_DECIMAL_MIN) {
-            throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-          }
-          return ValueFactory::GetDecimalValue(res);
-        }
+        case TypeId::VARCHAR:
+          return value.CastAs(TypeId::DECIMAL);
         default:
           break;
       }
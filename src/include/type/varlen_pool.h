@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_pool.h
+//
+// Identification: src/include/type/varlen_pool.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/macros.h"
+#include "type/arena_pool.h"
+
+namespace bustub {
+
+/**
+ * VarlenPool is the arena behind owning VARCHAR Value buffers. The slab allocator itself is
+ * inherited from ArenaPool; what VarlenPool adds is the per-thread binding: while a Scope is
+ * installed, every owning varchar Value constructed on that thread draws its buffer from the
+ * scoped pool instead of calling new[], and the outermost scope reclaims the whole arena when
+ * it ends. Execution installs a scope per drained batch, so the varchar temporaries a batch
+ * materializes -- column reads, cast results, predicate intermediates -- cost a pointer bump
+ * each and are released together.
+ *
+ * Contract: a pool-backed Value must not outlive the outermost scope over its pool. Values
+ * that escape a batch do so as serialized tuple bytes or as copies made outside any scope,
+ * both of which own heap storage.
+ */
+class VarlenPool : public ArenaPool {
+ public:
+  /** @return the pool varchar allocations on this thread currently draw from, or nullptr */
+  static AbstractPool *Current() { return current_; }
+
+  /** @return this thread's own pool, for callers that do not carry one of their own */
+  static VarlenPool *ThreadLocal() {
+    static thread_local VarlenPool pool;
+    return &pool;
+  }
+
+  /**
+   * Installs a pool as this thread's varlen allocator for the scope's lifetime. Scopes nest;
+   * the previous binding is restored on exit, and only the outermost scope over a given pool
+   * resets it -- so a reentrant drain on the same thread cannot free its caller's batch.
+   */
+  class Scope {
+   public:
+    explicit Scope(VarlenPool *pool) : pool_(pool), prev_(current_) { current_ = pool; }
+
+    ~Scope() {
+      current_ = prev_;
+      if (prev_ != pool_) {
+        pool_->Reset();
+      }
+    }
+
+    DISALLOW_COPY_AND_MOVE(Scope);
+
+   private:
+    VarlenPool *pool_;
+    AbstractPool *prev_;
+  };
+
+ private:
+  static inline thread_local AbstractPool *current_ = nullptr;
+};
+
+}  // namespace bustub
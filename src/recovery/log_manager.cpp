@@ -12,6 +12,12 @@
 
 #include "recovery/log_manager.h"
 
+#include <cstring>
+#include <vector>
+
+#include "common/tracer.h"
+#include "concurrency/transaction.h"
+
 namespace bustub {
 /*
  * set enable_logging = true
@@ -20,33 +26,299 @@ namespace bustub {
  * manager wants to force flush (it only happens when the flushed page has a
  * larger LSN than persistent LSN)
  */
-void LogManager::RunFlushThread() {}
+void LogManager::RunFlushThread() {
+  if (enable_logging.exchange(true)) {
+    return;
+  }
+  flush_thread_ = new std::thread([this] {
+    while (enable_logging) {
+      {
+        std::unique_lock lock(latch_);
+        cv_.wait_for(lock, log_timeout, [this] { return need_flush_ || !enable_logging; });
+      }
+      SwapAndFlush();
+    }
+  });
+}
 
 /*
  * Stop and join the flush thread, set enable_logging = false
  */
-void LogManager::StopFlushThread() {}
+void LogManager::StopFlushThread() {
+  if (!enable_logging.exchange(false)) {
+    return;
+  }
+  cv_.notify_all();
+  flush_thread_->join();
+  delete flush_thread_;
+  flush_thread_ = nullptr;
+  // Write out whatever the last round left behind.
+  SwapAndFlush();
+}
+
+/*
+ * Swap the append buffer with the flush buffer under the exclusive buffer latch, then do the
+ * (slow) disk write outside of it so appenders only stall for the pointer swap. One write covers
+ * every record that accumulated since the previous flush, so all transactions parked in
+ * WaitForFlush with an lsn in that range commit on a single fsync.
+ */
+void LogManager::SwapAndFlush() {
+  int flush_size;
+  lsn_t flush_lsn;
+  {
+    buffer_latch_.WLock();
+    flush_size = offset_.load();
+    if (flush_size == 0) {
+      buffer_latch_.WUnlock();
+      return;
+    }
+    if (flush_size > LOG_BUFFER_SIZE) {
+      // The buffer was sealed by an overflowing appender; only the bytes before its reservation
+      // hold complete records.
+      flush_size = sealed_bytes_.load();
+    }
+    std::swap(log_buffer_, flush_buffer_);
+    offset_.store(0);
+    // No appender is in flight while we hold the latch exclusively, so every assigned lsn is in
+    // this buffer or an already flushed one.
+    flush_lsn = next_lsn_.load() - 1;
+    need_flush_ = false;
+    buffer_latch_.WUnlock();
+  }
+  // The swapped-out buffer is private to this thread now; appenders fill the other one.
+  append_cv_.notify_all();
+  BUSTUB_TRACE_WAIT_START(trace_write_start);
+  disk_manager_->WriteLog(flush_buffer_, flush_size);
+  BUSTUB_TRACE_WAIT_END(LOG_SWAP_FLUSH, static_cast<uint64_t>(flush_size), trace_write_start);
+  // Ship the extent before commit waiters wake: a sink that has acknowledged this offset then
+  // holds every log byte behind any commit the primary reports durable. The pointer is into
+  // flush_buffer_, which stays private to this thread until the next swap, so the hand-off
+  // needs no copy here.
+  {
+    std::lock_guard<std::mutex> guard(consumers_latch_);
+    if (!log_consumers_.empty()) {
+      int start_offset = flushed_bytes_.load();
+      for (auto &entry : log_consumers_) {
+        entry.second(flush_buffer_, flush_size, start_offset, flush_lsn);
+      }
+    }
+  }
+  flushed_bytes_ += flush_size;
+  SetPersistentLSN(flush_lsn);
+  flush_cv_.notify_all();
+}
+
+/*
+ * Group commit: park until persistent_lsn_ has reached the given lsn.
+ */
+void LogManager::WaitForFlush(lsn_t lsn) {
+  BUSTUB_TRACE_WAIT_START(trace_stall_start);
+  std::unique_lock lock(latch_);
+  while (GetPersistentLSN() == INVALID_LSN || GetPersistentLSN() < lsn) {
+    need_flush_ = true;
+    cv_.notify_one();
+    flush_cv_.wait_for(lock, log_timeout);
+  }
+  BUSTUB_TRACE_WAIT_END(LOG_FLUSH_WAIT, static_cast<uint64_t>(lsn), trace_stall_start);
+}
 
 /*
  * append a log record into log buffer
  * you MUST set the log record's lsn within this method
  * @return: lsn that is assigned to this log record
  *
- *
- * example below
- * // First, serialize the must have fields(20 bytes in total)
- * log_record.lsn_ = next_lsn_++;
- * memcpy(log_buffer_ + offset_, &log_record, 20);
- * int pos = offset_ + 20;
- *
- * if (log_record.log_record_type_ == LogRecordType::INSERT) {
- *    memcpy(log_buffer_ + pos, &log_record.insert_rid_, sizeof(RID));
- *    pos += sizeof(RID);
- *    // we have provided serialize function for tuple class
- *    log_record.insert_tuple_.SerializeTo(log_buffer_ + pos);
- *  }
- *
+ * Appenders reserve their slot with one fetch_add on the buffer offset and copy concurrently,
+ * holding the buffer latch only in shared mode; they serialize solely against the flush thread's
+ * buffer swap, never against each other.
+ */
+lsn_t LogManager::AppendLogRecord(LogRecord *log_record) {
+  int32_t size = log_record->GetSize();
+  while (true) {
+    buffer_latch_.RLock();
+    int start = offset_.fetch_add(size);
+    if (start + size <= LOG_BUFFER_SIZE) {
+      log_record->lsn_ = next_lsn_++;
+      SerializeLogRecord(log_record, log_buffer_ + start);
+      buffer_latch_.RUnlock();
+      return log_record->lsn_;
+    }
+    if (start <= LOG_BUFFER_SIZE) {
+      // We are the first reservation past the end: everything before us is complete, so our
+      // start marks the sealed buffer's valid length.
+      sealed_bytes_.store(start);
+    }
+    buffer_latch_.RUnlock();
+    // Kick the flush thread and park until the swap opens the other buffer.
+    need_flush_ = true;
+    cv_.notify_one();
+    std::unique_lock lock(latch_);
+    // Timed wait: the notify happens outside latch_, so a narrowly missed wakeup just retries on
+    // the next timeout instead of stalling.
+    append_cv_.wait_for(lock, log_timeout, [this, size] { return offset_.load() + size <= LOG_BUFFER_SIZE; });
+  }
+}
+
+/*
+ * Copy pre-serialized record bytes into the shared buffer with the reservation/retry protocol
+ */
+void LogManager::AppendRawBytes(const char *data, int size) {
+  while (true) {
+    buffer_latch_.RLock();
+    int start = offset_.fetch_add(size);
+    if (start + size <= LOG_BUFFER_SIZE) {
+      memcpy(log_buffer_ + start, data, size);
+      buffer_latch_.RUnlock();
+      return;
+    }
+    if (start <= LOG_BUFFER_SIZE) {
+      sealed_bytes_.store(start);
+    }
+    buffer_latch_.RUnlock();
+    need_flush_ = true;
+    cv_.notify_one();
+    std::unique_lock lock(latch_);
+    append_cv_.wait_for(lock, log_timeout, [this, size] { return offset_.load() + size <= LOG_BUFFER_SIZE; });
+  }
+}
+
+/*
+ * Serialize a record into the transaction's private staging buffer; only the lsn counter is shared
+ */
+lsn_t LogManager::StageLogRecord(LogRecord *log_record, Transaction *txn) {
+  log_record->lsn_ = next_lsn_++;
+  bool spill;
+  {
+    std::lock_guard lock(*txn->GetLogStagingLatch());
+    auto *staging = txn->GetLogStagingBuffer();
+    size_t old_size = staging->size();
+    staging->resize(old_size + log_record->GetSize());
+    SerializeLogRecord(log_record, staging->data() + old_size);
+    spill = staging->size() >= static_cast<size_t>(LOG_BUFFER_SIZE) / 2;
+  }
+  {
+    std::lock_guard lock(staging_txns_latch_);
+    staging_txns_.insert(txn);
+  }
+  if (spill) {
+    // Spill long transactions early so one publish always fits in the shared buffer.
+    PublishStagedLog(txn);
+  }
+  return log_record->lsn_;
+}
+
+/*
+ * Publish the transaction's staged records to the shared buffer in one copy
+ */
+void LogManager::PublishStagedLog(Transaction *txn) {
+  {
+    std::lock_guard lock(staging_txns_latch_);
+    staging_txns_.erase(txn);
+  }
+  std::lock_guard lock(*txn->GetLogStagingLatch());
+  auto *staging = txn->GetLogStagingBuffer();
+  if (staging->empty()) {
+    return;
+  }
+  AppendRawBytes(staging->data(), staging->size());
+  staging->clear();
+}
+
+/*
+ * Drain every private staging buffer into the shared log; see the WAL note in the header
+ */
+void LogManager::PublishAllStaged() {
+  std::vector<Transaction *> txns;
+  {
+    std::lock_guard lock(staging_txns_latch_);
+    txns.assign(staging_txns_.begin(), staging_txns_.end());
+  }
+  for (auto *txn : txns) {
+    PublishStagedLog(txn);
+  }
+}
+
+/*
+ * Serialize the common header (20 bytes), then the type-specific payload
  */
-lsn_t LogManager::AppendLogRecord(LogRecord *log_record) { return INVALID_LSN; }
+void LogManager::SerializeLogRecord(LogRecord *log_record, char *pos) {
+  memcpy(pos, log_record, LogRecord::HEADER_SIZE);
+  pos += LogRecord::HEADER_SIZE;
+  switch (log_record->log_record_type_) {
+    // The mutation cases read the tuple images through the write-path references when set, so
+    // the bytes go straight from the source row into the reserved extent of the log buffer; a
+    // record owns its tuples only when recovery deserialized them back in.
+    case LogRecordType::INSERT: {
+      memcpy(pos, &log_record->insert_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      const Tuple &insert = log_record->insert_ref_ != nullptr ? *log_record->insert_ref_ : log_record->insert_tuple_;
+      insert.SerializeTo(pos);
+      break;
+    }
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE: {
+      memcpy(pos, &log_record->delete_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      const Tuple &removed = log_record->delete_ref_ != nullptr ? *log_record->delete_ref_ : log_record->delete_tuple_;
+      removed.SerializeTo(pos);
+      break;
+    }
+    case LogRecordType::UPDATE: {
+      memcpy(pos, &log_record->update_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      const Tuple &old_image = log_record->old_ref_ != nullptr ? *log_record->old_ref_ : log_record->old_tuple_;
+      const Tuple &new_image = log_record->new_ref_ != nullptr ? *log_record->new_ref_ : log_record->new_tuple_;
+      old_image.SerializeTo(pos);
+      pos += sizeof(int32_t) + old_image.GetLength();
+      new_image.SerializeTo(pos);
+      break;
+    }
+    case LogRecordType::INSERTBATCH: {
+      uint32_t count = log_record->batch_rids_.size();
+      memcpy(pos, &count, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      for (uint32_t i = 0; i < count; i++) {
+        memcpy(pos, &log_record->batch_rids_[i], sizeof(RID));
+        pos += sizeof(RID);
+        const Tuple &row =
+            !log_record->batch_refs_.empty() ? *log_record->batch_refs_[i] : log_record->batch_tuples_[i];
+        row.SerializeTo(pos);
+        pos += sizeof(int32_t) + row.GetLength();
+      }
+      break;
+    }
+    case LogRecordType::NEWPAGE:
+      memcpy(pos, &log_record->prev_page_id_, sizeof(page_id_t));
+      pos += sizeof(page_id_t);
+      memcpy(pos, &log_record->page_id_, sizeof(page_id_t));
+      break;
+    case LogRecordType::INDEXINSERT:
+    case LogRecordType::INDEXDELETE: {
+      memcpy(pos, &log_record->index_oid_, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      const Tuple &key =
+          log_record->index_key_ref_ != nullptr ? *log_record->index_key_ref_ : log_record->index_key_tuple_;
+      key.SerializeTo(pos);
+      pos += sizeof(int32_t) + key.GetLength();
+      memcpy(pos, &log_record->index_rid_, sizeof(RID));
+      break;
+    }
+    case LogRecordType::CHECKPOINT: {
+      uint32_t txn_count = log_record->checkpoint_active_txns_.size();
+      memcpy(pos, &txn_count, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      memcpy(pos, log_record->checkpoint_active_txns_.data(), txn_count * sizeof(txn_id_t));
+      pos += txn_count * sizeof(txn_id_t);
+      uint32_t page_count = log_record->checkpoint_dirty_pages_.size();
+      memcpy(pos, &page_count, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      memcpy(pos, log_record->checkpoint_dirty_pages_.data(), page_count * sizeof(page_id_t));
+      break;
+    }
+    default:
+      // BEGIN/COMMIT/ABORT carry no payload beyond the header.
+      break;
+  }
+}
 
 }  // namespace bustub
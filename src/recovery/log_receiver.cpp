@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_receiver.cpp
+//
+// Identification: src/recovery/log_receiver.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "recovery/log_receiver.h"
+
+#include <deque>
+#include <vector>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+/*
+ * Queue one shipped extent; runs on the sender's thread, so only a copy, no disk I/O.
+ */
+void LogReceiver::Receive(const char *data, int size, int start_offset) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (start_offset + size <= next_offset_) {
+    // A resend of bytes already queued; the sender may duplicate after a reconnect.
+    return;
+  }
+  if (start_offset != next_offset_) {
+    LOG_WARN("dropping log extent at offset %d, expected %d; this standby needs a reseed", start_offset, next_offset_);
+    return;
+  }
+  pending_.emplace_back(data, data + size);
+  next_offset_ += size;
+  apply_cv_.notify_all();
+}
+
+/*
+ * Land the queued extents in the standby's WAL, then replay them. The write-before-replay
+ * order matters: Redo reads the log back through the disk manager, and the standby must be
+ * able to restart from its own log copy alone.
+ */
+void LogReceiver::ApplyPending() {
+  std::lock_guard<std::mutex> apply_guard(apply_latch_);
+  std::deque<std::vector<char>> extents;
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    extents.swap(pending_);
+  }
+  if (extents.empty()) {
+    return;
+  }
+  for (auto &extent : extents) {
+    disk_manager_->WriteLog(extent.data(), static_cast<int>(extent.size()));
+    applied_bytes_ += static_cast<int>(extent.size());
+  }
+  log_recovery_.Redo();
+}
+
+void LogReceiver::RunApplyThread() {
+  if (apply_running_.exchange(true)) {
+    return;
+  }
+  apply_thread_ = new std::thread([this] {
+    while (apply_running_) {
+      {
+        std::unique_lock lock(latch_);
+        apply_cv_.wait_for(lock, log_timeout, [this] { return !pending_.empty() || !apply_running_; });
+      }
+      ApplyPending();
+    }
+  });
+}
+
+void LogReceiver::StopApplyThread() {
+  if (!apply_running_.exchange(false)) {
+    return;
+  }
+  apply_cv_.notify_all();
+  apply_thread_->join();
+  delete apply_thread_;
+  apply_thread_ = nullptr;
+  // Apply whatever arrived after the last round woke.
+  ApplyPending();
+}
+
+}  // namespace bustub
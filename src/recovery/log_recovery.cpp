@@ -12,15 +12,220 @@
 
 #include "recovery/log_recovery.h"
 
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "storage/index/index.h"
 #include "storage/page/table_page.h"
 
 namespace bustub {
 /*
  * deserialize a log record from log buffer
+ * The caller must guarantee that the full record (GetSize() bytes) lies within the buffer.
  * @return: true means deserialize succeed, otherwise can't deserialize cause
  * incomplete log record
  */
-bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record) { return false; }
+bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record) {
+  // Copy the header field by field; LogRecord owns Tuples, so it is not trivially copyable.
+  memcpy(&log_record->size_, data, sizeof(int32_t));
+  memcpy(&log_record->lsn_, data + 4, sizeof(lsn_t));
+  memcpy(&log_record->txn_id_, data + 8, sizeof(txn_id_t));
+  memcpy(&log_record->prev_lsn_, data + 12, sizeof(lsn_t));
+  memcpy(&log_record->log_record_type_, data + 16, sizeof(LogRecordType));
+  if (log_record->size_ < LogRecord::HEADER_SIZE || log_record->lsn_ == INVALID_LSN ||
+      log_record->log_record_type_ == LogRecordType::INVALID ||
+      log_record->log_record_type_ > LogRecordType::INDEXDELETE) {
+    return false;
+  }
+  // A checkpoint record belongs to no transaction; every other type must name one.
+  if (log_record->txn_id_ == INVALID_TXN_ID && log_record->log_record_type_ != LogRecordType::CHECKPOINT) {
+    return false;
+  }
+  const char *pos = data + LogRecord::HEADER_SIZE;
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT:
+      memcpy(&log_record->insert_rid_, pos, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->insert_tuple_.DeserializeFrom(pos);
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      memcpy(&log_record->delete_rid_, pos, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->delete_tuple_.DeserializeFrom(pos);
+      break;
+    case LogRecordType::UPDATE:
+      memcpy(&log_record->update_rid_, pos, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->old_tuple_.DeserializeFrom(pos);
+      pos += sizeof(int32_t) + log_record->old_tuple_.GetLength();
+      log_record->new_tuple_.DeserializeFrom(pos);
+      break;
+    case LogRecordType::NEWPAGE:
+      memcpy(&log_record->prev_page_id_, pos, sizeof(page_id_t));
+      pos += sizeof(page_id_t);
+      memcpy(&log_record->page_id_, pos, sizeof(page_id_t));
+      break;
+    case LogRecordType::INSERTBATCH: {
+      uint32_t count;
+      memcpy(&count, pos, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      log_record->batch_rids_.resize(count);
+      log_record->batch_tuples_.resize(count);
+      for (uint32_t i = 0; i < count; i++) {
+        memcpy(&log_record->batch_rids_[i], pos, sizeof(RID));
+        pos += sizeof(RID);
+        log_record->batch_tuples_[i].DeserializeFrom(pos);
+        pos += sizeof(int32_t) + log_record->batch_tuples_[i].GetLength();
+      }
+      break;
+    }
+    case LogRecordType::INDEXINSERT:
+    case LogRecordType::INDEXDELETE:
+      memcpy(&log_record->index_oid_, pos, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      log_record->index_key_tuple_.DeserializeFrom(pos);
+      pos += sizeof(int32_t) + log_record->index_key_tuple_.GetLength();
+      memcpy(&log_record->index_rid_, pos, sizeof(RID));
+      break;
+    case LogRecordType::CHECKPOINT: {
+      uint32_t txn_count;
+      memcpy(&txn_count, pos, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      log_record->checkpoint_active_txns_.resize(txn_count);
+      memcpy(log_record->checkpoint_active_txns_.data(), pos, txn_count * sizeof(txn_id_t));
+      pos += txn_count * sizeof(txn_id_t);
+      uint32_t page_count;
+      memcpy(&page_count, pos, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      log_record->checkpoint_dirty_pages_.resize(page_count);
+      memcpy(log_record->checkpoint_dirty_pages_.data(), pos, page_count * sizeof(page_id_t));
+      break;
+    }
+    default:
+      // BEGIN/COMMIT/ABORT carry no payload beyond the header.
+      break;
+  }
+  return true;
+}
+
+/*
+ * Replay a NEWPAGE record: re-initialize the created page (if its image predates the record)
+ * and link it behind its predecessor. The next-pointer update is idempotent and does not touch
+ * the predecessor's lsn, so it cannot mask older tuple records replayed later on that page.
+ */
+void LogRecovery::RedoNewPage(LogRecord *log_record) {
+  page_id_t page_id = log_record->GetNewPageId();
+  auto *page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    return;
+  }
+  if (page->GetLSN() < log_record->GetLSN()) {
+    page->Init(page_id, PAGE_SIZE, log_record->GetNewPageRecord(), nullptr, nullptr);
+    page->SetLSN(log_record->GetLSN());
+  }
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  page_id_t prev_page_id = log_record->GetNewPageRecord();
+  if (prev_page_id != INVALID_PAGE_ID) {
+    auto *prev_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(prev_page_id));
+    if (prev_page != nullptr) {
+      if (prev_page->GetNextPageId() != page_id) {
+        prev_page->SetNextPageId(page_id);
+        buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      } else {
+        buffer_pool_manager_->UnpinPage(prev_page_id, false);
+      }
+    }
+  }
+}
+
+std::unordered_map<page_id_t, lsn_t> LogRecovery::ScanDiskLsns(const std::unordered_set<page_id_t> &touched_pages) {
+  std::unordered_map<page_id_t, lsn_t> disk_lsn;
+  disk_lsn.reserve(touched_pages.size());
+  std::vector<page_id_t> page_ids(touched_pages.begin(), touched_pages.end());
+  // ReadPages sorts anyway, but pre-sorted ids keep the chunks themselves in file order.
+  std::sort(page_ids.begin(), page_ids.end());
+  constexpr size_t SCAN_BATCH = 64;
+  auto *scratch = static_cast<char *>(::operator new(SCAN_BATCH * PAGE_SIZE, std::align_val_t{DIRECT_IO_ALIGNMENT}));
+  for (size_t start = 0; start < page_ids.size(); start += SCAN_BATCH) {
+    size_t count = std::min(SCAN_BATCH, page_ids.size() - start);
+    std::vector<std::pair<page_id_t, char *>> requests;
+    requests.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+      requests.emplace_back(page_ids[start + i], scratch + i * PAGE_SIZE);
+    }
+    disk_manager_->ReadPages(&requests);
+    for (size_t i = 0; i < count; i++) {
+      // The lsn sits right behind the page id in the header. A page that was never flushed reads
+      // back zeroed (lsn 0), so its records are never skipped.
+      disk_lsn[page_ids[start + i]] = *reinterpret_cast<lsn_t *>(scratch + i * PAGE_SIZE + sizeof(page_id_t));
+    }
+  }
+  ::operator delete(scratch, std::align_val_t{DIRECT_IO_ALIGNMENT});
+  return disk_lsn;
+}
+
+page_id_t LogRecovery::TupleRecordPageId(LogRecord *log_record) {
+  RID rid = log_record->log_record_type_ == LogRecordType::UPDATE        ? log_record->update_rid_
+            : log_record->log_record_type_ == LogRecordType::INSERT      ? log_record->insert_rid_
+            : log_record->log_record_type_ == LogRecordType::INSERTBATCH ? log_record->batch_rids_.front()
+                                                                         : log_record->delete_rid_;
+  return rid.GetPageId();
+}
+
+/*
+ * Replay one tuple-level record if the on-disk page image predates it
+ */
+void LogRecovery::RedoLogRecord(LogRecord *log_record) {
+  RID rid = log_record->log_record_type_ == LogRecordType::UPDATE        ? log_record->update_rid_
+            : log_record->log_record_type_ == LogRecordType::INSERT      ? log_record->insert_rid_
+            : log_record->log_record_type_ == LogRecordType::INSERTBATCH ? log_record->batch_rids_.front()
+                                                                         : log_record->delete_rid_;
+  auto *page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    return;
+  }
+  if (page->GetLSN() >= log_record->GetLSN()) {
+    // The effect is already in the page image.
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+    return;
+  }
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT: {
+      RID redo_rid;
+      page->InsertTuple(log_record->insert_tuple_, &redo_rid, nullptr, nullptr, nullptr);
+      break;
+    }
+    case LogRecordType::INSERTBATCH: {
+      // The whole batch shares one LSN on one page, so the page-image check above covers it.
+      RID redo_rid;
+      for (const Tuple &row : log_record->batch_tuples_) {
+        page->InsertTuple(row, &redo_rid, nullptr, nullptr, nullptr);
+      }
+      break;
+    }
+    case LogRecordType::UPDATE: {
+      Tuple old_tuple;
+      page->UpdateTuple(log_record->new_tuple_, &old_tuple, rid, nullptr, nullptr, nullptr);
+      break;
+    }
+    case LogRecordType::MARKDELETE:
+      page->MarkDelete(rid, nullptr, nullptr, nullptr);
+      break;
+    case LogRecordType::APPLYDELETE:
+      page->ApplyDelete(rid, nullptr, nullptr);
+      break;
+    case LogRecordType::ROLLBACKDELETE:
+      page->RollbackDelete(rid, nullptr, nullptr);
+      break;
+    default:
+      break;
+  }
+  page->SetLSN(log_record->GetLSN());
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+}
 
 /*
  *redo phase on TABLE PAGE level(table/table_page.h)
@@ -28,13 +233,224 @@ bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record)
  *log buffer to reduce unnecessary I/O operations), remember to compare page's
  *LSN with log_record's sequence number, and also build active_txn_ table &
  *lsn_mapping_ table
+ *
+ * One sequential scan builds active_txn_ / lsn_mapping_ and buckets tuple-level records by
+ * page id; the buckets are then replayed on a thread pool. Records for one page always land in
+ * the same bucket in log order, and redo on distinct pages is independent, so the parallel phase
+ * needs no page latching and recovery is bounded by the disk, not one core.
+ *
+ * The scan cursor survives across calls: a later Redo on the same object picks up at the first
+ * offset the previous scan could not parse and replays only the log appended since. Crash
+ * recovery, with its fresh LogRecovery, still scans from the beginning; a standby applying
+ * shipped log (see LogReceiver) calls Redo repeatedly as extents land in its WAL, and
+ * active_txn_ / lsn_mapping_ accumulate so Undo still works after a promotion.
+ */
+void LogRecovery::Redo() {
+  uint32_t num_partitions = std::max(1U, std::thread::hardware_concurrency());
+  std::vector<std::vector<LogRecord>> partitions(num_partitions);
+  std::vector<LogRecord> index_records;
+  std::unordered_set<page_id_t> touched_pages;
+
+  while (disk_manager_->ReadLog(log_buffer_, LOG_BUFFER_SIZE, offset_)) {
+    int buffer_pos = 0;
+    LogRecord log_record;
+    while (buffer_pos + LogRecord::HEADER_SIZE <= LOG_BUFFER_SIZE) {
+      // Stop at the buffer edge so a straddling record is re-read from its own offset.
+      auto record_size = *reinterpret_cast<const int32_t *>(log_buffer_ + buffer_pos);
+      if (record_size < LogRecord::HEADER_SIZE || buffer_pos + record_size > LOG_BUFFER_SIZE) {
+        break;
+      }
+      if (!DeserializeLogRecord(log_buffer_ + buffer_pos, &log_record)) {
+        break;
+      }
+      lsn_mapping_[log_record.GetLSN()] = offset_ + buffer_pos;
+      if (log_record.GetTxnId() != INVALID_TXN_ID) {
+        active_txn_[log_record.GetTxnId()] = log_record.GetLSN();
+      }
+      switch (log_record.GetLogRecordType()) {
+        case LogRecordType::COMMIT:
+        case LogRecordType::ABORT:
+          active_txn_.erase(log_record.GetTxnId());
+          break;
+        case LogRecordType::NEWPAGE:
+          // Links two pages, so it cannot go through the per-page partitions.
+          RedoNewPage(&log_record);
+          break;
+        case LogRecordType::INSERT:
+        case LogRecordType::INSERTBATCH:
+        case LogRecordType::UPDATE:
+        case LogRecordType::MARKDELETE:
+        case LogRecordType::APPLYDELETE:
+        case LogRecordType::ROLLBACKDELETE: {
+          page_id_t page_id = TupleRecordPageId(&log_record);
+          touched_pages.insert(page_id);
+          partitions[static_cast<uint32_t>(page_id) % num_partitions].push_back(log_record);
+          break;
+        }
+        case LogRecordType::INDEXINSERT:
+        case LogRecordType::INDEXDELETE:
+          // Logical, so there is no page lsn to screen against; replayed after the page
+          // partitions, in lsn order, against whichever indexes were registered.
+          index_records.push_back(log_record);
+          break;
+        default:
+          break;
+      }
+      buffer_pos += record_size;
+    }
+    if (buffer_pos == 0) {
+      // Not even one complete record at this offset: end of the valid log.
+      break;
+    }
+    offset_ += buffer_pos;
+  }
+
+  // On a mostly-flushed workload almost every record's effect is already on disk. One batched
+  // pass over the touched pages' headers finds those records up front, so the replay phase does
+  // not have to pull every page through the buffer pool just to learn there is nothing to do.
+  std::unordered_map<page_id_t, lsn_t> disk_lsn = ScanDiskLsns(touched_pages);
+
+  // Parallel replay: one worker per non-empty partition. The lsn index is read-only from here on.
+  std::vector<std::thread> workers;
+  for (auto &partition : partitions) {
+    if (partition.empty()) {
+      continue;
+    }
+    workers.emplace_back([this, &partition, &disk_lsn] {
+      // Transactions publish locally staged records in batches, so file order is not lsn order
+      // across transactions; per page the records must be replayed oldest first.
+      std::sort(partition.begin(), partition.end(),
+                [](LogRecord &left, LogRecord &right) { return left.GetLSN() < right.GetLSN(); });
+      for (auto &log_record : partition) {
+        auto lsn_it = disk_lsn.find(TupleRecordPageId(&log_record));
+        if (lsn_it != disk_lsn.end() && log_record.GetLSN() <= lsn_it->second) {
+          // The flushed page image already covers this record.
+          continue;
+        }
+        RedoLogRecord(&log_record);
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  // Index entries depend on one another (an insert then delete of the same key must land in
+  // that order), so the logical records replay sequentially, oldest first.
+  std::sort(index_records.begin(), index_records.end(),
+            [](LogRecord &left, LogRecord &right) { return left.GetLSN() < right.GetLSN(); });
+  for (auto &log_record : index_records) {
+    ApplyIndexRecord(&log_record, /*undo=*/false);
+  }
+}
+
+/*
+ * Replay (or revert) one logical index record against its registered index
  */
-void LogRecovery::Redo() {}
+void LogRecovery::ApplyIndexRecord(LogRecord *log_record, bool undo) {
+  auto index_it = indexes_.find(log_record->GetIndexOid());
+  if (index_it == indexes_.end()) {
+    // Not registered: this index's owner rebuilds it from the heap instead.
+    return;
+  }
+  bool insert = (log_record->GetLogRecordType() == LogRecordType::INDEXINSERT) != undo;
+  if (insert) {
+    index_it->second->InsertEntry(log_record->GetIndexKey(), log_record->GetIndexRID(), nullptr);
+  } else {
+    index_it->second->DeleteEntry(log_record->GetIndexKey(), log_record->GetIndexRID(), nullptr);
+  }
+}
 
 /*
  *undo phase on TABLE PAGE level(table/table_page.h)
  *iterate through active txn map and undo each operation
  */
-void LogRecovery::Undo() {}
+void LogRecovery::Undo() {
+  // Walk each loser transaction's chain backwards via prev_lsn, reverting every change.
+  // Redo has finished, so log_buffer_ is free to reuse for the single-record reads.
+  char *record_buffer = log_buffer_;
+  for (auto &entry : active_txn_) {
+    lsn_t lsn = entry.second;
+    while (lsn != INVALID_LSN) {
+      auto offset_it = lsn_mapping_.find(lsn);
+      if (offset_it == lsn_mapping_.end()) {
+        break;
+      }
+      if (!disk_manager_->ReadLog(record_buffer, LOG_BUFFER_SIZE, offset_it->second)) {
+        break;
+      }
+      LogRecord log_record;
+      if (!DeserializeLogRecord(record_buffer, &log_record)) {
+        break;
+      }
+      switch (log_record.GetLogRecordType()) {
+        case LogRecordType::INSERT: {
+          auto *page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(log_record.insert_rid_.GetPageId()));
+          if (page != nullptr) {
+            page->ApplyDelete(log_record.insert_rid_, nullptr, nullptr);
+            buffer_pool_manager_->UnpinPage(log_record.insert_rid_.GetPageId(), true);
+          }
+          break;
+        }
+        case LogRecordType::INSERTBATCH: {
+          page_id_t page_id = log_record.batch_rids_.front().GetPageId();
+          auto *page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+          if (page != nullptr) {
+            // Revert the batch's rows newest first, mirroring the insertion order.
+            for (auto rid_it = log_record.batch_rids_.rbegin(); rid_it != log_record.batch_rids_.rend(); ++rid_it) {
+              page->ApplyDelete(*rid_it, nullptr, nullptr);
+            }
+            buffer_pool_manager_->UnpinPage(page_id, true);
+          }
+          break;
+        }
+        case LogRecordType::UPDATE: {
+          auto *page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(log_record.update_rid_.GetPageId()));
+          if (page != nullptr) {
+            Tuple ignored;
+            page->UpdateTuple(log_record.old_tuple_, &ignored, log_record.update_rid_, nullptr, nullptr, nullptr);
+            buffer_pool_manager_->UnpinPage(log_record.update_rid_.GetPageId(), true);
+          }
+          break;
+        }
+        case LogRecordType::MARKDELETE: {
+          auto *page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(log_record.delete_rid_.GetPageId()));
+          if (page != nullptr) {
+            page->RollbackDelete(log_record.delete_rid_, nullptr, nullptr);
+            buffer_pool_manager_->UnpinPage(log_record.delete_rid_.GetPageId(), true);
+          }
+          break;
+        }
+        case LogRecordType::APPLYDELETE: {
+          auto *page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(log_record.delete_rid_.GetPageId()));
+          if (page != nullptr) {
+            RID undo_rid;
+            page->InsertTuple(log_record.delete_tuple_, &undo_rid, nullptr, nullptr, nullptr);
+            buffer_pool_manager_->UnpinPage(log_record.delete_rid_.GetPageId(), true);
+          }
+          break;
+        }
+        case LogRecordType::ROLLBACKDELETE: {
+          auto *page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(log_record.delete_rid_.GetPageId()));
+          if (page != nullptr) {
+            page->MarkDelete(log_record.delete_rid_, nullptr, nullptr, nullptr);
+            buffer_pool_manager_->UnpinPage(log_record.delete_rid_.GetPageId(), true);
+          }
+          break;
+        }
+        case LogRecordType::INDEXINSERT:
+        case LogRecordType::INDEXDELETE:
+          // Logical undo: the inverse index operation.
+          ApplyIndexRecord(&log_record, /*undo=*/true);
+          break;
+        default:
+          break;
+      }
+      lsn = log_record.GetPrevLSN();
+    }
+  }
+  active_txn_.clear();
+  lsn_mapping_.clear();
+}
 
 }  // namespace bustub
@@ -10,15 +10,24 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <new>
 #include <string>
 #include <thread>  // NOLINT
 
 #include "common/logger.h"
+#include "common/util/crc32c.h"
+#include "execution/executor_stats.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/page_compressor.h"
 
 namespace bustub {
 
@@ -36,16 +45,34 @@ DiskManager::DiskManager(const std::string &db_file)
     return;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
+  warm_set_name_ = file_name_.substr(0, n) + ".warm";
+  free_list_name_ = file_name_.substr(0, n) + ".free";
+  checksum_name_ = file_name_.substr(0, n) + ".sums";
 
-  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
+  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::out);
   // directory or file does not exist
   if (!log_io_.is_open()) {
     log_io_.clear();
     // create a new file
-    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::app | std::ios::out);
+    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::out);
     log_io_.close();
     // reopen with original mode
-    log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
+    log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::out);
+  }
+  // Find where valid log data ends so appends continue there rather than at the preallocated
+  // file end, and move log_io_ onto the segment holding that position.
+  log_size_ = FindLogEnd();
+  cur_log_segment_ = log_size_ / LOG_SEGMENT_SIZE;
+  if (cur_log_segment_ > 0 || log_size_ == 0) {
+    // Reopen onto the segment holding the append position; an empty log gets segment 0
+    // preallocated here. A legacy short .log with data is left as-is.
+    OpenLogSegment(cur_log_segment_);
+  }
+  // Segment and pool files from an earlier run that lie past the valid end are stale; a later
+  // append must not resurrect their contents as log.
+  for (int segment = cur_log_segment_ + 1; std::remove(LogSegmentName(segment).c_str()) == 0; segment++) {
+  }
+  for (int pooled = 0; std::remove((log_name_ + ".recycled" + std::to_string(pooled)).c_str()) == 0; pooled++) {
   }
 
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out | std::ios::out);
@@ -59,60 +86,418 @@ DiskManager::DiskManager(const std::string &db_file)
     db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
   }
   buffer_used = nullptr;
+  stripe_names_ = {file_name_};
+  LoadFreeList();
+  LoadPageChecksums();
+}
+
+/**
+ * Constructor: stripe pages across several database files (one per device)
+ * @input db_files: database stripe file names, in stripe order
+ */
+DiskManager::DiskManager(const std::vector<std::string> &db_files) : DiskManager(db_files[0]) {
+  stripe_names_ = db_files;
+  num_stripes_ = db_files.size();
+  // stripe 0 keeps going through db_io_; only the extra stripes get their own stream
+  stripe_ios_ = std::vector<std::fstream>(num_stripes_);
+  for (size_t i = 1; i < num_stripes_; ++i) {
+    auto &stripe_io = stripe_ios_[i];
+    stripe_io.open(db_files[i], std::ios::binary | std::ios::in | std::ios::out);
+    // directory or file does not exist
+    if (!stripe_io.is_open()) {
+      stripe_io.clear();
+      // create a new file
+      stripe_io.open(db_files[i], std::ios::binary | std::ios::trunc | std::ios::out);
+      stripe_io.close();
+      // reopen with original mode
+      stripe_io.open(db_files[i], std::ios::binary | std::ios::in | std::ios::out);
+    }
+  }
 }
 
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
+  SaveFreeList();
+  SavePageChecksums();
   db_io_.close();
+  for (size_t i = 1; i < num_stripes_; ++i) {
+    stripe_ios_[i].close();
+  }
   log_io_.close();
 }
 
+/**
+ * Returns the stream for the stripe file holding the given page
+ */
+std::fstream &DiskManager::StripeIo(page_id_t page_id) {
+  size_t stripe = static_cast<size_t>(page_id) % num_stripes_;
+  return stripe == 0 ? db_io_ : stripe_ios_[stripe];
+}
+
+/**
+ * Returns the name of the stripe file holding the given page
+ */
+const std::string &DiskManager::StripeName(page_id_t page_id) {
+  return stripe_names_[static_cast<size_t>(page_id) % num_stripes_];
+}
+
+/**
+ * Returns the byte offset of the given page within its stripe file
+ */
+size_t DiskManager::StripeOffset(page_id_t page_id) const {
+  return (static_cast<size_t>(page_id) / num_stripes_) * PAGE_SIZE;
+}
+
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+  uint64_t timer = IoTimerStart();
+  auto &stripe_io = StripeIo(page_id);
+  size_t offset = StripeOffset(page_id);
+  alignas(DIRECT_IO_ALIGNMENT) char scratch[PAGE_SIZE];
+  size_t write_size;
+  const char *image = EncodePageImage(page_id, page_data, scratch, &write_size);
   // set write cursor to offset
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  stripe_io.seekp(offset);
+  stripe_io.write(image, write_size);
   // check for I/O error
-  if (db_io_.bad()) {
+  if (stripe_io.bad()) {
     LOG_DEBUG("I/O error while writing");
     return;
   }
   // needs to flush to keep disk file in sync
-  db_io_.flush();
+  stripe_io.flush();
+  // The checksum always covers the logical page image, independent of the slot encoding.
+  RecordPageChecksum(page_id, page_data);
+  RecordIoLatency(write_page_cycles_, timer);
+}
+
+void DiskManager::WritePages(std::vector<std::pair<page_id_t, const char *>> *requests) {
+  // Group by stripe first, then ascending within the stripe, so each file is touched in one pass
+  // and each stripe's requests form one contiguous slice of the sorted vector.
+  size_t num_stripes = num_stripes_;
+  std::sort(requests->begin(), requests->end(), [num_stripes](const auto &lhs, const auto &rhs) {
+    size_t lhs_stripe = static_cast<size_t>(lhs.first) % num_stripes;
+    size_t rhs_stripe = static_cast<size_t>(rhs.first) % num_stripes;
+    return lhs_stripe != rhs_stripe ? lhs_stripe < rhs_stripe : lhs.first < rhs.first;
+  });
+
+  // Writes one stripe's slice, coalescing runs of stripe-adjacent page ids (ids num_stripes_
+  // apart land on consecutive offsets of the same stripe file). Up to MAX_RUN_PAGES consecutive
+  // pages become one write call (a 1MB sequential write at the default page size), which is what
+  // turns a checkpoint's flood of dirty pages into sequential I/O.
+  auto write_range = [this](std::pair<page_id_t, const char *> *range, size_t count) {
+    static constexpr size_t MAX_RUN_PAGES = 256;
+    auto run_storage = std::make_unique<char[]>(MAX_RUN_PAGES * PAGE_SIZE);
+    char *run_buffer = run_storage.get();
+    size_t i = 0;
+    while (i < count) {
+      size_t run = 1;
+      while (i + run < count && run < MAX_RUN_PAGES &&
+             range[i + run].first == range[i].first + static_cast<page_id_t>(run * num_stripes_)) {
+        run++;
+      }
+      if (run == 1) {
+        WritePage(range[i].first, range[i].second);
+        i++;
+        continue;
+      }
+      // Encode each page into its fixed slot of the run buffer. A compressed image zero-fills
+      // the rest of its slot, which reads treat exactly like the stale tail a single-page
+      // write leaves behind.
+      for (size_t j = 0; j < run; ++j) {
+        char *slot = run_buffer + j * PAGE_SIZE;
+        size_t write_size;
+        const char *image = EncodePageImage(range[i + j].first, range[i + j].second, slot, &write_size);
+        if (image != slot) {
+          memcpy(slot, image, write_size);
+        } else if (write_size < PAGE_SIZE) {
+          memset(slot + write_size, 0, PAGE_SIZE - write_size);
+        }
+      }
+      auto &stripe_io = StripeIo(range[i].first);
+      size_t offset = StripeOffset(range[i].first);
+      num_writes_ += 1;
+      stripe_io.seekp(offset);
+      stripe_io.write(run_buffer, static_cast<std::streamsize>(run * PAGE_SIZE));
+      if (stripe_io.bad()) {
+        LOG_DEBUG("I/O error while writing");
+        i += run;
+        continue;
+      }
+      stripe_io.flush();
+      for (size_t j = 0; j < run; ++j) {
+        RecordPageChecksum(range[i + j].first, range[i + j].second);
+      }
+      i += run;
+    }
+  };
+
+  if (num_stripes == 1) {
+    write_range(requests->data(), requests->size());
+    return;
+  }
+
+  // One writer thread per stripe file. The slices touch disjoint streams, so the stripes'
+  // device writes proceed in parallel, and each writer's encode and checksum work overlaps the
+  // other stripes' I/O -- a checkpoint's FlushAllPages is bounded by the slowest stripe instead
+  // of the sum of all of them.
+  std::vector<std::thread> writers;
+  size_t begin = 0;
+  while (begin < requests->size()) {
+    size_t stripe = static_cast<size_t>((*requests)[begin].first) % num_stripes;
+    size_t end = begin + 1;
+    while (end < requests->size() && static_cast<size_t>((*requests)[end].first) % num_stripes == stripe) {
+      end++;
+    }
+    writers.emplace_back(write_range, requests->data() + begin, end - begin);
+    begin = end;
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
+  uint64_t timer = IoTimerStart();
+  auto &stripe_io = StripeIo(page_id);
+  int offset = static_cast<int>(StripeOffset(page_id));
   // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
+  if (offset > GetFileSize(StripeName(page_id))) {
     LOG_DEBUG("I/O error while reading");
     // std::cerr << "I/O error while reading" << std::endl;
   } else {
     // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
+    stripe_io.seekp(offset);
+    stripe_io.read(page_data, PAGE_SIZE);
     // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
+    int read_count = stripe_io.gcount();
     if (read_count < PAGE_SIZE) {
       LOG_DEBUG("Read less than a page");
       // std::cerr << "Read less than a page" << std::endl;
+      // Clear the eof/fail state like the batched path does, or every later operation on this
+      // stream silently fails. Routine since compressed slots can leave the file short.
+      stripe_io.clear();
       memset(page_data + read_count, 0, PAGE_SIZE - read_count);
     }
+    DecodePageImage(page_id, page_data);
+    VerifyPageChecksum(page_id, page_data);
+    RecordIoLatency(read_page_cycles_, timer);
+  }
+}
+
+/**
+ * Mark a page as belonging to a compressed table
+ */
+void DiskManager::SetPageCompressed(page_id_t page_id) {
+  std::lock_guard lock(compression_latch_);
+  compressed_pages_.insert(page_id);
+}
+
+/**
+ * Check whether a page has been marked compressed
+ */
+bool DiskManager::IsPageCompressed(page_id_t page_id) {
+  std::lock_guard lock(compression_latch_);
+  return compressed_pages_.count(page_id) > 0;
+}
+
+/**
+ * Build the slot image to write for a page: the compressed image in scratch when the page is
+ * marked and its image shrinks, the raw page data otherwise
+ */
+const char *DiskManager::EncodePageImage(page_id_t page_id, const char *page_data, char *scratch,
+                                         size_t *write_size) {
+  if (IsPageCompressed(page_id)) {
+    size_t payload = PageCompressor::Compress(page_data, scratch + sizeof(CompressedPageHeader));
+    if (payload != 0) {
+      CompressedPageHeader header{PageCompressor::COMPRESSED_PAGE_MAGIC, static_cast<uint32_t>(payload)};
+      memcpy(scratch, &header, sizeof(header));
+      // Pad to the direct-I/O alignment so every backend can write the slot as-is. The stale
+      // tail of the slot beyond the write is harmless; the header bounds the payload.
+      size_t used = sizeof(header) + payload;
+      *write_size = (used + DIRECT_IO_ALIGNMENT - 1) & ~(DIRECT_IO_ALIGNMENT - 1);
+      memset(scratch + used, 0, *write_size - used);
+      return scratch;
+    }
+    // Incompressible image: store it raw. The missing magic tells the read side.
+  }
+  *write_size = PAGE_SIZE;
+  return page_data;
+}
+
+/**
+ * Decompress a freshly read slot image in place, when the page is marked and the slot is valid
+ */
+void DiskManager::DecodePageImage(page_id_t page_id, char *page_data) {
+  if (!IsPageCompressed(page_id)) {
+    return;
+  }
+  CompressedPageHeader header;
+  memcpy(&header, page_data, sizeof(header));
+  if (header.magic_ != PageCompressor::COMPRESSED_PAGE_MAGIC) {
+    // Raw slot: an incompressible image, or a page allocated but never written.
+    return;
+  }
+  alignas(DIRECT_IO_ALIGNMENT) char payload[PAGE_SIZE];
+  if (header.compressed_size_ > PageCompressor::MAX_PAYLOAD) {
+    LOG_ERROR("malformed compressed slot for page %d", page_id);
+    memset(page_data, 0, PAGE_SIZE);
+    return;
+  }
+  memcpy(payload, page_data + sizeof(header), header.compressed_size_);
+  if (!PageCompressor::Decompress(payload, header.compressed_size_, page_data)) {
+    LOG_ERROR("malformed compressed slot for page %d", page_id);
+    memset(page_data, 0, PAGE_SIZE);
+  }
+}
+
+/**
+ * Record the checksum of the page image that was just written
+ */
+void DiskManager::RecordPageChecksum(page_id_t page_id, const char *page_data) {
+  uint32_t checksum = Crc32c::Compute(page_data, PAGE_SIZE);
+  std::lock_guard lock(checksum_latch_);
+  page_checksums_[page_id] = checksum;
+  // Journal the fresh checksum so detection survives the very crash that tears the page; an
+  // in-memory-only table would be gone exactly when it is needed. The flush pushes the record
+  // into the OS cache alongside the page write it covers.
+  if (checksum_io_.is_open()) {
+    checksum_io_.write(reinterpret_cast<const char *>(&page_id), sizeof(page_id));
+    checksum_io_.write(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+    checksum_io_.flush();
+  }
+}
+
+/**
+ * Verify a freshly read page image against its recorded checksum, if one exists
+ */
+bool DiskManager::VerifyPageChecksum(page_id_t page_id, const char *page_data) {
+  uint32_t expected;
+  {
+    std::lock_guard lock(checksum_latch_);
+    auto it = page_checksums_.find(page_id);
+    if (it == page_checksums_.end()) {
+      // Nothing recorded for this page (e.g. written before this process started).
+      return true;
+    }
+    expected = it->second;
+  }
+  if (Crc32c::Compute(page_data, PAGE_SIZE) != expected) {
+    LOG_ERROR("checksum mismatch on page %d: torn or corrupted page", page_id);
+    num_checksum_mismatches_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Read a batch of pages in one ascending pass per stripe file.
+ * Runs of pages that are adjacent within their stripe are fetched with a single read into a
+ * scratch buffer and then scattered to the per-page destinations.
+ */
+void DiskManager::ReadPages(std::vector<std::pair<page_id_t, char *>> *requests) {
+  // Up to this many consecutive pages are coalesced into one read call.
+  static constexpr size_t MAX_RUN_PAGES = 8;
+  auto run_storage = std::make_unique<char[]>(MAX_RUN_PAGES * PAGE_SIZE);
+  char *run_buffer = run_storage.get();
+
+  // Group by stripe first, then ascending within the stripe, so each file is touched in one pass.
+  size_t num_stripes = num_stripes_;
+  std::sort(requests->begin(), requests->end(), [num_stripes](const auto &lhs, const auto &rhs) {
+    size_t lhs_stripe = static_cast<size_t>(lhs.first) % num_stripes;
+    size_t rhs_stripe = static_cast<size_t>(rhs.first) % num_stripes;
+    return lhs_stripe != rhs_stripe ? lhs_stripe < rhs_stripe : lhs.first < rhs.first;
+  });
+
+  size_t i = 0;
+  while (i < requests->size()) {
+    // Find the run of stripe-adjacent page ids starting at i (ids num_stripes_ apart land on
+    // consecutive offsets of the same stripe file).
+    size_t run = 1;
+    while (i + run < requests->size() && run < MAX_RUN_PAGES &&
+           (*requests)[i + run].first ==
+               (*requests)[i].first + static_cast<page_id_t>(run * num_stripes_)) {
+      run++;
+    }
+    if (run == 1) {
+      ReadPage((*requests)[i].first, (*requests)[i].second);
+      i++;
+      continue;
+    }
+    auto &stripe_io = StripeIo((*requests)[i].first);
+    int offset = static_cast<int>(StripeOffset((*requests)[i].first));
+    int length = static_cast<int>(run) * PAGE_SIZE;
+    if (offset > GetFileSize(StripeName((*requests)[i].first))) {
+      LOG_DEBUG("I/O error while reading");
+      i += run;
+      continue;
+    }
+    stripe_io.seekp(offset);
+    stripe_io.read(run_buffer, length);
+    int read_count = stripe_io.gcount();
+    if (read_count < length) {
+      LOG_DEBUG("Read less than requested");
+      stripe_io.clear();
+      memset(run_buffer + read_count, 0, length - read_count);
+    }
+    for (size_t j = 0; j < run; ++j) {
+      memcpy((*requests)[i + j].second, run_buffer + j * PAGE_SIZE, PAGE_SIZE);
+      DecodePageImage((*requests)[i + j].first, (*requests)[i + j].second);
+      VerifyPageChecksum((*requests)[i + j].first, (*requests)[i + j].second);
+    }
+    i += run;
   }
 }
 
+/**
+ * Returns the file name of the given log segment; segment 0 keeps the plain .log name
+ */
+std::string DiskManager::LogSegmentName(int segment) const {
+  return segment == 0 ? log_name_ : log_name_ + "." + std::to_string(segment);
+}
+
+/**
+ * Point log_io_ at the given segment, preferring a recycled segment file over creating one
+ */
+void DiskManager::OpenLogSegment(int segment) {
+  log_io_.close();
+  std::string segment_name = LogSegmentName(segment);
+  bool preallocated = false;
+  {
+    std::lock_guard lock(log_segment_latch_);
+    if (!recycled_segments_.empty()) {
+      // A retired segment is already the right size; renaming it into place skips the zero-fill.
+      preallocated = std::rename(recycled_segments_.back().c_str(), segment_name.c_str()) == 0;
+      recycled_segments_.pop_back();
+    }
+  }
+  log_io_.clear();
+  log_io_.open(segment_name, std::ios::binary | std::ios::in | std::ios::out);
+  if (!log_io_.is_open() || (!preallocated && GetFileSize(segment_name) < LOG_SEGMENT_SIZE)) {
+    // Fresh segment: create it at full size up front so later append fsyncs never have to write
+    // file-extension metadata.
+    log_io_.clear();
+    log_io_.open(segment_name, std::ios::binary | std::ios::trunc | std::ios::out);
+    std::vector<char> zeros(LOG_SEGMENT_SIZE, 0);
+    log_io_.write(zeros.data(), zeros.size());
+    log_io_.close();
+    log_io_.open(segment_name, std::ios::binary | std::ios::in | std::ios::out);
+  }
+  cur_log_segment_ = segment;
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
+ * A write that crosses the end of the current segment continues in the next one.
  */
 void DiskManager::WriteLog(char *log_data, int size) {
   // enforce swap log buffer
@@ -123,6 +508,7 @@ void DiskManager::WriteLog(char *log_data, int size) {
     return;
   }
 
+  uint64_t timer = IoTimerStart();
   flush_log_ = true;
 
   if (flush_log_f_ != nullptr) {
@@ -131,17 +517,88 @@ void DiskManager::WriteLog(char *log_data, int size) {
   }
 
   num_flushes_ += 1;
-  // sequence write
-  log_io_.write(log_data, size);
+  while (size > 0) {
+    int segment_pos = log_size_ - cur_log_segment_ * LOG_SEGMENT_SIZE;
+    if (segment_pos == LOG_SEGMENT_SIZE) {
+      log_io_.flush();
+      OpenLogSegment(cur_log_segment_ + 1);
+      segment_pos = 0;
+    }
+    int chunk = std::min(size, LOG_SEGMENT_SIZE - segment_pos);
+    // sequence write
+    log_io_.seekp(segment_pos);
+    log_io_.write(log_data, chunk);
 
-  // check for I/O error
-  if (log_io_.bad()) {
-    LOG_DEBUG("I/O error while writing log");
-    return;
+    // check for I/O error
+    if (log_io_.bad()) {
+      LOG_DEBUG("I/O error while writing log");
+      return;
+    }
+    log_data += chunk;
+    log_size_ += chunk;
+    size -= chunk;
   }
   // needs to flush to keep disk file in sync
   log_io_.flush();
   flush_log_ = false;
+  RecordIoLatency(write_log_cycles_, timer);
+}
+
+/**
+ * Returns the cycle counter if latency tracking is on, 0 otherwise
+ */
+uint64_t DiskManager::IoTimerStart() const {
+  return io_latency_enabled_.load(std::memory_order_relaxed) ? ReadCycleCounter() : 0;
+}
+
+/**
+ * Buckets the time elapsed since start into the given histogram
+ */
+void DiskManager::RecordIoLatency(std::atomic<uint64_t> *histogram, uint64_t start) {
+  if (start == 0) {
+    return;
+  }
+  uint64_t elapsed = ReadCycleCounter() - start;
+  // Bucket i holds durations in [2^i, 2^(i+1)); |1 keeps a zero-tick delta in bucket 0.
+  auto bucket = static_cast<size_t>(63 - __builtin_clzll(elapsed | 1));
+  histogram[std::min(bucket, IoLatencyStats::LATENCY_HISTOGRAM_BUCKETS - 1)].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Snapshots the I/O latency histograms
+ */
+void DiskManager::GetIoLatencyStats(IoLatencyStats *stats) {
+  for (size_t i = 0; i < IoLatencyStats::LATENCY_HISTOGRAM_BUCKETS; ++i) {
+    stats->read_page_cycles[i] = read_page_cycles_[i].load(std::memory_order_relaxed);
+    stats->write_page_cycles[i] = write_page_cycles_[i].load(std::memory_order_relaxed);
+    stats->write_log_cycles[i] = write_log_cycles_[i].load(std::memory_order_relaxed);
+  }
+}
+
+/**
+ * Read log bytes across segment boundaries; missing or recycled segments read as zeroes
+ */
+void DiskManager::RawReadLog(char *log_data, int size, int offset) {
+  memset(log_data, 0, size);
+  while (size > 0) {
+    int segment = offset / LOG_SEGMENT_SIZE;
+    int segment_pos = offset % LOG_SEGMENT_SIZE;
+    int chunk = std::min(size, LOG_SEGMENT_SIZE - segment_pos);
+    if (segment == cur_log_segment_) {
+      log_io_.seekg(segment_pos);
+      log_io_.read(log_data, chunk);
+      log_io_.clear();
+    } else {
+      std::ifstream segment_io(LogSegmentName(segment), std::ios::binary);
+      if (segment_io.is_open()) {
+        segment_io.seekg(segment_pos);
+        segment_io.read(log_data, chunk);
+      }
+    }
+    log_data += chunk;
+    offset += chunk;
+    size -= chunk;
+  }
 }
 
 /**
@@ -150,35 +607,345 @@ void DiskManager::WriteLog(char *log_data, int size) {
  * @return: false means already reach the end
  */
 bool DiskManager::ReadLog(char *log_data, int size, int offset) {
-  if (offset >= GetFileSize(log_name_)) {
+  if (offset >= log_size_) {
     // LOG_DEBUG("end of log file");
-    // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
     return false;
   }
-  log_io_.seekp(offset);
-  log_io_.read(log_data, size);
-  // if log file ends before reading "size"
-  int read_count = log_io_.gcount();
-  if (read_count < size) {
-    log_io_.clear();
-    memset(log_data + read_count, 0, size - read_count);
+  RawReadLog(log_data, size, offset);
+  return true;
+}
+
+/**
+ * Walk the record length prefixes from offset 0 to find where valid log data ends
+ */
+int DiskManager::FindLogEnd() {
+  if (GetFileSize(log_name_) <= 0) {
+    return 0;
+  }
+  int end = 0;
+  while (true) {
+    int32_t record_size = 0;
+    RawReadLog(reinterpret_cast<char *>(&record_size), sizeof(record_size), end);
+    // A real record's length prefix covers at least its header and fits in one log buffer;
+    // anything else is the zeroed preallocation tail or a torn write.
+    if (record_size < 20 || record_size > LOG_BUFFER_SIZE) {
+      break;
+    }
+    end += record_size;
+  }
+  return end;
+}
+
+/**
+ * Retire whole segments before the live offset into the recycled pool
+ */
+void DiskManager::RecycleLogSegments(int live_offset) {
+  int live_segment = std::min(live_offset / LOG_SEGMENT_SIZE, cur_log_segment_);
+  std::lock_guard lock(log_segment_latch_);
+  for (int segment = first_log_segment_; segment < live_segment; segment++) {
+    std::string pool_name = log_name_ + ".recycled" + std::to_string(recycled_counter_++);
+    if (std::rename(LogSegmentName(segment).c_str(), pool_name.c_str()) == 0) {
+      recycled_segments_.push_back(pool_name);
+    }
   }
+  first_log_segment_ = std::max(first_log_segment_, live_segment);
+}
 
+/**
+ * Overwrite the warm-set sidecar file with the resident page ids
+ */
+void DiskManager::WriteWarmSet(const std::vector<page_id_t> &page_ids) {
+  std::ofstream warm_io(warm_set_name_, std::ios::binary | std::ios::trunc);
+  if (!warm_io.is_open()) {
+    LOG_DEBUG("can't open warm set file");
+    return;
+  }
+  uint32_t count = page_ids.size();
+  warm_io.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  warm_io.write(reinterpret_cast<const char *>(page_ids.data()), count * sizeof(page_id_t));
+}
+
+/**
+ * Read the page ids recorded in the warm-set sidecar file
+ * @return: false means there is no (readable) sidecar file
+ */
+bool DiskManager::ReadWarmSet(std::vector<page_id_t> *page_ids) {
+  std::ifstream warm_io(warm_set_name_, std::ios::binary);
+  if (!warm_io.is_open()) {
+    return false;
+  }
+  uint32_t count = 0;
+  warm_io.read(reinterpret_cast<char *>(&count), sizeof(count));
+  if (warm_io.gcount() != sizeof(count)) {
+    return false;
+  }
+  page_ids->resize(count);
+  warm_io.read(reinterpret_cast<char *>(page_ids->data()), count * sizeof(page_id_t));
+  if (static_cast<size_t>(warm_io.gcount()) != count * sizeof(page_id_t)) {
+    page_ids->clear();
+    return false;
+  }
   return true;
 }
 
+/**
+ * Copies src into dest with large sequential reads below the buffer pool
+ */
+bool DiskManager::CopyFileStreamed(const std::string &src, const std::string &dest) {
+  bool direct = false;
+  int src_fd = -1;
+#ifdef O_DIRECT
+  src_fd = open(src.c_str(), O_RDONLY | O_DIRECT);
+  direct = src_fd >= 0;
+#endif
+  if (src_fd < 0) {
+    // Not every filesystem supports O_DIRECT (tmpfs notably does not); fall back to buffered I/O.
+    src_fd = open(src.c_str(), O_RDONLY);
+  }
+  if (src_fd < 0) {
+    return false;
+  }
+  int dest_fd = open(dest.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (dest_fd < 0) {
+    close(src_fd);
+    return false;
+  }
+  auto *chunk = static_cast<char *>(::operator new(BACKUP_CHUNK_SIZE, std::align_val_t{DIRECT_IO_ALIGNMENT}));
+  bool ok = true;
+  while (true) {
+    // The request length and buffer are aligned as O_DIRECT requires; a short read past an
+    // unaligned sidecar tail is still delivered, just like at any other end of file.
+    ssize_t got = read(src_fd, chunk, BACKUP_CHUNK_SIZE);
+    if (got < 0 && direct) {
+      // Some filesystems accept the O_DIRECT open but reject the reads; restart buffered.
+      close(src_fd);
+      close(dest_fd);
+      direct = false;
+      src_fd = open(src.c_str(), O_RDONLY);
+      dest_fd = open(dest.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (src_fd < 0 || dest_fd < 0) {
+        ok = false;
+        break;
+      }
+      continue;
+    }
+    if (got < 0) {
+      ok = false;
+      break;
+    }
+    if (got == 0) {
+      break;
+    }
+    if (write(dest_fd, chunk, got) != got) {
+      ok = false;
+      break;
+    }
+  }
+  ::operator delete(chunk, std::align_val_t{DIRECT_IO_ALIGNMENT});
+  if (dest_fd >= 0) {
+    close(dest_fd);
+  }
+  if (src_fd >= 0) {
+    close(src_fd);
+  }
+  return ok;
+}
+
+/**
+ * Streams the database stripe files (and the free-list sidecar) into a backup copy
+ */
+bool DiskManager::BackupDataFiles(const std::string &backup_file) {
+  std::string::size_type n = backup_file.find('.');
+  if (n == std::string::npos) {
+    LOG_DEBUG("wrong file format");
+    return false;
+  }
+  // The sidecar is normally written on ShutDown; the copy needs it current.
+  SaveFreeList();
+  bool ok = true;
+  for (size_t i = 0; i < stripe_names_.size(); ++i) {
+    std::string dest = i == 0 ? backup_file : backup_file + "." + std::to_string(i);
+    ok = CopyFileStreamed(stripe_names_[i], dest) && ok;
+  }
+  ok = CopyFileStreamed(free_list_name_, backup_file.substr(0, n) + ".free") && ok;
+  return ok;
+}
+
+/**
+ * Streams the live log segment files alongside a data backup
+ */
+bool DiskManager::BackupLogFiles(const std::string &backup_file) {
+  std::string::size_type n = backup_file.find('.');
+  if (n == std::string::npos) {
+    LOG_DEBUG("wrong file format");
+    return false;
+  }
+  std::string dest_log = backup_file.substr(0, n) + ".log";
+  int first;
+  int last;
+  {
+    std::lock_guard<std::mutex> guard(log_segment_latch_);
+    first = first_log_segment_;
+    last = cur_log_segment_;
+  }
+  bool ok = true;
+  for (int segment = first; segment <= last; ++segment) {
+    std::string dest = segment == 0 ? dest_log : dest_log + "." + std::to_string(segment);
+    if (!CopyFileStreamed(LogSegmentName(segment), dest)) {
+      // A segment recycled out from under the copy lies entirely before the live log.
+      std::lock_guard<std::mutex> guard(log_segment_latch_);
+      ok = segment >= first_log_segment_ ? false : ok;
+    }
+  }
+  return ok;
+}
+
 /**
  * Allocate new page (operations like create index/table)
- * For now just keep an increasing counter
+ * Reuses the lowest deallocated page id before growing the file
  */
-page_id_t DiskManager::AllocatePage() { return next_page_id_++; }
+page_id_t DiskManager::AllocatePage() {
+  {
+    std::lock_guard lock(free_list_latch_);
+    if (!free_pages_.empty()) {
+      auto it = free_pages_.begin();
+      page_id_t page_id = *it;
+      free_pages_.erase(it);
+      return page_id;
+    }
+  }
+  return next_page_id_++;
+}
 
 /**
  * Deallocate page (operations like drop index/table)
- * Need bitmap in header page for tracking pages
- * This does not actually need to do anything for now.
+ * The id goes back to the free list so the file space is reused instead of growing forever
+ */
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  {
+    std::lock_guard lock(compression_latch_);
+    compressed_pages_.erase(page_id);
+  }
+  std::lock_guard lock(free_list_latch_);
+  if (page_id >= 0 && page_id < next_page_id_) {
+    free_pages_.insert(page_id);
+  }
+}
+
+/**
+ * Restore the allocation state from the free-list sidecar file, if the database file exists
+ */
+void DiskManager::LoadFreeList() {
+  if (GetFileSize(file_name_) <= 0) {
+    // Fresh (or deleted) database; ignore any stale sidecar.
+    return;
+  }
+  std::ifstream free_io(free_list_name_, std::ios::binary);
+  if (!free_io.is_open()) {
+    return;
+  }
+  page_id_t high_water_mark = 0;
+  uint32_t count = 0;
+  free_io.read(reinterpret_cast<char *>(&high_water_mark), sizeof(high_water_mark));
+  free_io.read(reinterpret_cast<char *>(&count), sizeof(count));
+  if (free_io.gcount() != sizeof(count)) {
+    return;
+  }
+  std::vector<page_id_t> page_ids(count);
+  free_io.read(reinterpret_cast<char *>(page_ids.data()), count * sizeof(page_id_t));
+  if (static_cast<size_t>(free_io.gcount()) != count * sizeof(page_id_t)) {
+    return;
+  }
+  next_page_id_ = high_water_mark;
+  {
+    std::lock_guard lock(free_list_latch_);
+    free_pages_.insert(page_ids.begin(), page_ids.end());
+  }
+  // Optional trailing section: the compressed page set. Sidecars from before it existed just
+  // end here, which the gcount check treats as an empty set.
+  uint32_t compressed_count = 0;
+  free_io.read(reinterpret_cast<char *>(&compressed_count), sizeof(compressed_count));
+  if (free_io.gcount() != sizeof(compressed_count)) {
+    return;
+  }
+  std::vector<page_id_t> compressed_ids(compressed_count);
+  free_io.read(reinterpret_cast<char *>(compressed_ids.data()), compressed_count * sizeof(page_id_t));
+  if (static_cast<size_t>(free_io.gcount()) != compressed_count * sizeof(page_id_t)) {
+    return;
+  }
+  std::lock_guard lock(compression_latch_);
+  compressed_pages_.insert(compressed_ids.begin(), compressed_ids.end());
+}
+
+/**
+ * Overwrite the free-list sidecar file with the allocation high-water mark and the free page ids
  */
-void DiskManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {}
+void DiskManager::SaveFreeList() {
+  std::ofstream free_io(free_list_name_, std::ios::binary | std::ios::trunc);
+  if (!free_io.is_open()) {
+    LOG_DEBUG("can't open free list file");
+    return;
+  }
+  {
+    std::lock_guard lock(free_list_latch_);
+    std::vector<page_id_t> page_ids(free_pages_.begin(), free_pages_.end());
+    page_id_t high_water_mark = next_page_id_;
+    uint32_t count = page_ids.size();
+    free_io.write(reinterpret_cast<const char *>(&high_water_mark), sizeof(high_water_mark));
+    free_io.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    free_io.write(reinterpret_cast<const char *>(page_ids.data()), count * sizeof(page_id_t));
+  }
+  std::lock_guard lock(compression_latch_);
+  std::vector<page_id_t> compressed_ids(compressed_pages_.begin(), compressed_pages_.end());
+  uint32_t compressed_count = compressed_ids.size();
+  free_io.write(reinterpret_cast<const char *>(&compressed_count), sizeof(compressed_count));
+  free_io.write(reinterpret_cast<const char *>(compressed_ids.data()), compressed_count * sizeof(page_id_t));
+}
+
+/**
+ * Replay the checksum sidecar and open it for appending
+ */
+void DiskManager::LoadPageChecksums() {
+  std::lock_guard lock(checksum_latch_);
+  bool fresh_db = GetFileSize(file_name_) <= 0;
+  if (!fresh_db) {
+    std::ifstream checksum_in(checksum_name_, std::ios::binary);
+    if (checksum_in.is_open()) {
+      // Replay the journal last-record-wins; a torn trailing record from a crashed append just
+      // ends the replay, losing only the checksum it would have recorded.
+      page_id_t page_id;
+      uint32_t checksum;
+      while (checksum_in.read(reinterpret_cast<char *>(&page_id), sizeof(page_id)) &&
+             checksum_in.read(reinterpret_cast<char *>(&checksum), sizeof(checksum))) {
+        page_checksums_[page_id] = checksum;
+      }
+    }
+  }
+  // A fresh (or deleted) database starts the journal over, so a stale sidecar cannot flag its
+  // reused page ids; otherwise new records extend the replayed journal.
+  checksum_io_.open(checksum_name_, fresh_db ? std::ios::binary | std::ios::trunc
+                                             : std::ios::binary | std::ios::app);
+  if (!checksum_io_.is_open()) {
+    LOG_DEBUG("can't open checksum file");
+  }
+}
+
+/**
+ * Compact the checksum sidecar to one record per page and close the journal
+ */
+void DiskManager::SavePageChecksums() {
+  std::lock_guard lock(checksum_latch_);
+  checksum_io_.close();
+  std::ofstream checksum_out(checksum_name_, std::ios::binary | std::ios::trunc);
+  if (!checksum_out.is_open()) {
+    LOG_DEBUG("can't open checksum file");
+    return;
+  }
+  for (const auto &[page_id, checksum] : page_checksums_) {
+    checksum_out.write(reinterpret_cast<const char *>(&page_id), sizeof(page_id));
+    checksum_out.write(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+  }
+}
 
 /**
  * Returns number of flushes made so far
@@ -190,6 +957,11 @@ int DiskManager::GetNumFlushes() const { return num_flushes_; }
  */
 int DiskManager::GetNumWrites() const { return num_writes_; }
 
+/**
+ * Returns number of page reads that failed checksum verification
+ */
+int DiskManager::GetNumChecksumMismatches() const { return num_checksum_mismatches_; }
+
 /**
  * Returns true if the log is currently being flushed
  */
@@ -0,0 +1,208 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.cpp
+//
+// Identification: src/storage/disk/disk_manager_uring.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include "common/logger.h"
+#include "storage/disk/disk_manager_uring.h"
+
+namespace bustub {
+
+/** Queue depth used for io_uring batch submissions. */
+static constexpr unsigned URING_QUEUE_DEPTH = 64;
+
+DiskManagerUring::DiskManagerUring(const std::string &db_file, bool use_direct_io) : DiskManager(db_file) {
+  // The base class already created the file (and opened the log); page I/O goes through a raw fd.
+  db_io_.close();
+  int flags = O_RDWR | O_CREAT;
+#ifdef O_DIRECT
+  if (use_direct_io) {
+    flags |= O_DIRECT;
+    direct_io_ = true;
+  }
+#endif
+  fd_ = open(db_file.c_str(), flags, 0644);
+#ifdef O_DIRECT
+  if (fd_ < 0 && direct_io_) {
+    // Not every filesystem supports O_DIRECT (tmpfs notably does not); fall back to buffered I/O.
+    LOG_DEBUG("O_DIRECT not supported, falling back to buffered I/O");
+    direct_io_ = false;
+    fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+#endif
+  if (fd_ < 0) {
+    LOG_DEBUG("can't open db file");
+  }
+#ifdef BUSTUB_HAS_LIBURING
+  ring_initialized_ = io_uring_queue_init(URING_QUEUE_DEPTH, &ring_, 0) == 0;
+#endif
+}
+
+DiskManagerUring::~DiskManagerUring() {
+#ifdef BUSTUB_HAS_LIBURING
+  if (ring_initialized_) {
+    io_uring_queue_exit(&ring_);
+    ring_initialized_ = false;
+  }
+#endif
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+void DiskManagerUring::ShutDown() {
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+  log_io_.close();
+}
+
+void DiskManagerUring::WritePage(page_id_t page_id, const char *page_data) {
+  uint64_t timer = IoTimerStart();
+  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+  alignas(DIRECT_IO_ALIGNMENT) char scratch[PAGE_SIZE];
+  size_t write_size;
+  // The encoded slot is padded to the direct-I/O alignment, so it can go straight to pwrite.
+  const char *image = EncodePageImage(page_id, page_data, scratch, &write_size);
+  num_writes_ += 1;
+  ssize_t written = pwrite(fd_, image, write_size, offset);
+  if (written != static_cast<ssize_t>(write_size)) {
+    LOG_DEBUG("I/O error while writing");
+    return;
+  }
+  RecordPageChecksum(page_id, page_data);
+  RecordIoLatency(write_page_cycles_, timer);
+}
+
+void DiskManagerUring::WritePages(std::vector<std::pair<page_id_t, const char *>> *requests) {
+  // Up to this many consecutive pages are coalesced into one pwrite (1MB at the default page
+  // size); the buffer is alignment-allocated so coalesced writes work under O_DIRECT too.
+  static constexpr size_t MAX_RUN_PAGES = 256;
+  auto *run_buffer =
+      static_cast<char *>(::operator new(MAX_RUN_PAGES * PAGE_SIZE, std::align_val_t{DIRECT_IO_ALIGNMENT}));
+
+  // One file, so a plain ascending sort touches it in one pass.
+  std::sort(requests->begin(), requests->end(),
+            [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+  size_t i = 0;
+  while (i < requests->size()) {
+    size_t run = 1;
+    while (i + run < requests->size() && run < MAX_RUN_PAGES &&
+           (*requests)[i + run].first == (*requests)[i].first + static_cast<page_id_t>(run)) {
+      run++;
+    }
+    if (run == 1) {
+      WritePage((*requests)[i].first, (*requests)[i].second);
+      i++;
+      continue;
+    }
+    // Encode each page into its fixed slot of the run buffer; a compressed image zero-fills
+    // the rest of its slot.
+    for (size_t j = 0; j < run; ++j) {
+      char *slot = run_buffer + j * PAGE_SIZE;
+      size_t write_size;
+      const char *image = EncodePageImage((*requests)[i + j].first, (*requests)[i + j].second, slot, &write_size);
+      if (image != slot) {
+        memcpy(slot, image, write_size);
+      } else if (write_size < PAGE_SIZE) {
+        memset(slot + write_size, 0, PAGE_SIZE - write_size);
+      }
+    }
+    size_t offset = static_cast<size_t>((*requests)[i].first) * PAGE_SIZE;
+    size_t length = run * PAGE_SIZE;
+    num_writes_ += 1;
+    ssize_t written = pwrite(fd_, run_buffer, length, offset);
+    if (written != static_cast<ssize_t>(length)) {
+      LOG_DEBUG("I/O error while writing");
+      i += run;
+      continue;
+    }
+    for (size_t j = 0; j < run; ++j) {
+      RecordPageChecksum((*requests)[i + j].first, (*requests)[i + j].second);
+    }
+    i += run;
+  }
+  ::operator delete(run_buffer, std::align_val_t{DIRECT_IO_ALIGNMENT});
+}
+
+void DiskManagerUring::ReadPage(page_id_t page_id, char *page_data) {
+  uint64_t timer = IoTimerStart();
+  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+  ssize_t read_count = pread(fd_, page_data, PAGE_SIZE, offset);
+  if (read_count < 0) {
+    LOG_DEBUG("I/O error while reading");
+    return;
+  }
+  if (read_count < PAGE_SIZE) {
+    // Reading past the current end of file yields a zeroed page, like the base class.
+    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+  }
+  DecodePageImage(page_id, page_data);
+  VerifyPageChecksum(page_id, page_data);
+  RecordIoLatency(read_page_cycles_, timer);
+}
+
+void DiskManagerUring::ReadPages(std::vector<std::pair<page_id_t, char *>> *requests) {
+  std::sort(requests->begin(), requests->end(),
+            [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+#ifdef BUSTUB_HAS_LIBURING
+  if (ring_initialized_) {
+    std::lock_guard lock(ring_latch_);
+    size_t submitted = 0;
+    while (submitted < requests->size()) {
+      size_t batch = std::min<size_t>(requests->size() - submitted, URING_QUEUE_DEPTH);
+      for (size_t i = 0; i < batch; ++i) {
+        auto &[page_id, page_data] = (*requests)[submitted + i];
+        struct io_uring_sqe *sqe = io_uring_get_sqe(&ring_);
+        io_uring_prep_read(sqe, fd_, page_data, PAGE_SIZE, static_cast<size_t>(page_id) * PAGE_SIZE);
+        io_uring_sqe_set_data(sqe, page_data);
+      }
+      io_uring_submit(&ring_);
+      for (size_t i = 0; i < batch; ++i) {
+        struct io_uring_cqe *cqe;
+        if (io_uring_wait_cqe(&ring_, &cqe) != 0) {
+          LOG_DEBUG("I/O error while reading");
+          continue;
+        }
+        auto *page_data = static_cast<char *>(io_uring_cqe_get_data(cqe));
+        int read_count = cqe->res;
+        if (read_count < 0) {
+          read_count = 0;
+        }
+        if (read_count < PAGE_SIZE) {
+          memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+        }
+        io_uring_cqe_seen(&ring_, cqe);
+      }
+      submitted += batch;
+    }
+    for (auto &[page_id, page_data] : *requests) {
+      DecodePageImage(page_id, page_data);
+      VerifyPageChecksum(page_id, page_data);
+    }
+    return;
+  }
+#endif
+  // Fallback: one ascending pread pass.
+  for (auto &[page_id, page_data] : *requests) {
+    ReadPage(page_id, page_data);
+  }
+}
+
+}  // namespace bustub
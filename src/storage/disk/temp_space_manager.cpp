@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// temp_space_manager.cpp
+//
+// Identification: src/storage/disk/temp_space_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/temp_space_manager.h"
+
+#include <unistd.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+TempSpaceManager::TempSpaceManager() {
+  // The pid plus a process-local counter keeps concurrent queries (and concurrent test
+  // processes in the same directory) on distinct files.
+  static std::atomic<uint64_t> next_temp_file{0};
+  file_name_ =
+      "bustub_tmp_" + std::to_string(::getpid()) + "_" + std::to_string(next_temp_file.fetch_add(1)) + ".tmp";
+  io_.open(file_name_, std::ios::binary | std::ios::trunc | std::ios::out);
+  io_.close();
+  io_.open(file_name_, std::ios::binary | std::ios::in | std::ios::out);
+}
+
+TempSpaceManager::~TempSpaceManager() {
+  io_.close();
+  std::remove(file_name_.c_str());
+}
+
+Page *TempSpaceManager::NewPage(page_id_t *page_id) {
+  if (free_pages_.empty()) {
+    *page_id = next_page_id_++;
+  } else {
+    *page_id = free_pages_.back();
+    free_pages_.pop_back();
+  }
+  auto frame = TakeFrame();
+  Page *page = frame.get();
+  memset(page->GetData(), 0, PAGE_SIZE);
+  pinned_.emplace(*page_id, std::move(frame));
+  return page;
+}
+
+Page *TempSpaceManager::FetchPage(page_id_t page_id) {
+  auto frame = TakeFrame();
+  Page *page = frame.get();
+  io_.seekg(static_cast<size_t>(page_id) * PAGE_SIZE);
+  io_.read(page->GetData(), PAGE_SIZE);
+  BUSTUB_ASSERT(!io_.fail(), "Failed to read a temp page that was previously written.");
+  pinned_.emplace(page_id, std::move(frame));
+  return page;
+}
+
+void TempSpaceManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  auto it = pinned_.find(page_id);
+  BUSTUB_ASSERT(it != pinned_.end(), "Unpinning a temp page that is not pinned.");
+  if (is_dirty) {
+    io_.seekp(static_cast<size_t>(page_id) * PAGE_SIZE);
+    io_.write(it->second->GetData(), PAGE_SIZE);
+    // No flush: temp pages need no durability, only read-back through this stream, and the
+    // seekg before every read synchronizes it.
+  }
+  frame_pool_.push_back(std::move(it->second));
+  pinned_.erase(it);
+}
+
+void TempSpaceManager::DeletePage(page_id_t page_id) { free_pages_.push_back(page_id); }
+
+std::unique_ptr<Page> TempSpaceManager::TakeFrame() {
+  if (!frame_pool_.empty()) {
+    auto frame = std::move(frame_pool_.back());
+    frame_pool_.pop_back();
+    return frame;
+  }
+  return std::make_unique<Page>();
+}
+
+}  // namespace bustub
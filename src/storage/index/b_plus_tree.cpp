@@ -0,0 +1,369 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree.cpp
+//
+// Identification: src/storage/index/b_plus_tree.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/b_plus_tree.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/logger.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                          int leaf_max_size, int internal_max_size)
+    : index_name_(std::move(name)),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size),
+      internal_max_size_(internal_max_size) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsEmpty() {
+  root_latch_.RLock();
+  bool empty = root_page_id_ == INVALID_PAGE_ID;
+  root_latch_.RUnlock();
+  return empty;
+}
+
+/*
+ * A note on reading a page's type before latching it: page_type_ is written
+ * once when a page joins the tree and tree pages are never recycled (deletion
+ * is lazy), so the type is stable for the page's whole lifetime. The descent
+ * relies on this to pick the latch mode (read for internals, write for the
+ * leaf) before acquiring the child's latch.
+ */
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageRead(const KeyType *key) {
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  page->RLatch();
+  root_latch_.RUnlock();
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_id = (key != nullptr) ? internal->Lookup(*key, comparator_) : internal->ValueAt(0);
+    Page *child_page = buffer_pool_manager_->FetchPage(child_id);
+    child_page->RLatch();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child_page;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  Page *page = FindLeafPageRead(&key);
+  if (page == nullptr) {
+    return false;
+  }
+  bool found = false;
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  // duplicates may spill across leaves, so walk right until a larger key shows up
+  while (true) {
+    bool past_key = false;
+    for (int i = leaf->KeyIndex(key, comparator_); i < leaf->GetSize(); i++) {
+      if (comparator_(leaf->KeyAt(i), key) != 0) {
+        past_key = true;
+        break;
+      }
+      result->push_back(leaf->GetItem(i).second);
+      found = true;
+    }
+    page_id_t next_id = leaf->GetNextPageId();
+    if (past_key || next_id == INVALID_PAGE_ID) {
+      break;
+    }
+    Page *next_page = buffer_pool_manager_->FetchPage(next_id);
+    next_page->RLatch();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = next_page;
+    leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ScanRange(const KeyType *low, const KeyType *high, std::vector<ValueType> *result,
+                               Transaction *transaction) {
+  Page *page = FindLeafPageRead(low);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  while (true) {
+    bool past_high = false;
+    for (int i = (low != nullptr) ? leaf->KeyIndex(*low, comparator_) : 0; i < leaf->GetSize(); i++) {
+      if (high != nullptr && comparator_(leaf->KeyAt(i), *high) > 0) {
+        past_high = true;
+        break;
+      }
+      result->push_back(leaf->GetItem(i).second);
+    }
+    page_id_t next_id = leaf->GetNextPageId();
+    if (past_high || next_id == INVALID_PAGE_ID) {
+      break;
+    }
+    Page *next_page = buffer_pool_manager_->FetchPage(next_id);
+    next_page->RLatch();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = next_page;
+    leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  if (!InsertOptimistic(key, value)) {
+    InsertPessimistic(key, value);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t root_id;
+  Page *page = buffer_pool_manager_->NewPage(&root_id);
+  BUSTUB_ASSERT(page != nullptr, "out of pages while creating a b+ tree root");
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  leaf->Init(root_id, INVALID_PAGE_ID, leaf_max_size_);
+  leaf->Insert(key, value, comparator_);
+  root_page_id_ = root_id;
+  buffer_pool_manager_->UnpinPage(root_id, true);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertOptimistic(const KeyType &key, const ValueType &value) {
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    return false;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (node->IsLeafPage()) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+  root_latch_.RUnlock();
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_id = internal->Lookup(key, comparator_);
+    Page *child_page = buffer_pool_manager_->FetchPage(child_id);
+    auto *child = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
+    // only the leaf gets a write latch on the optimistic path
+    if (child->IsLeafPage()) {
+      child_page->WLatch();
+    } else {
+      child_page->RLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child_page;
+    node = child;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(node);
+  if (leaf->GetSize() + 1 >= leaf_max_size_) {
+    // would split; retry with the pessimistic protocol
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return false;
+  }
+  leaf->Insert(key, value, comparator_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertPessimistic(const KeyType &key, const ValueType &value) {
+  root_latch_.WLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    StartNewTree(key, value);
+    root_latch_.WUnlock();
+    return;
+  }
+  bool root_latched = true;
+  // the path holds every write-latched page from the topmost unsafe node down
+  std::vector<Page *> path;
+  page_id_t page_id = root_page_id_;
+  while (true) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    page->WLatch();
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    bool safe = node->IsLeafPage() ? node->GetSize() + 1 < leaf_max_size_ : node->GetSize() < internal_max_size_;
+    if (safe) {
+      // this node absorbs any split from below, so the ancestors cannot change
+      for (auto *ancestor : path) {
+        ancestor->WUnlatch();
+        buffer_pool_manager_->UnpinPage(ancestor->GetPageId(), false);
+      }
+      path.clear();
+      if (root_latched) {
+        root_latch_.WUnlock();
+        root_latched = false;
+      }
+    }
+    path.push_back(page);
+    if (node->IsLeafPage()) {
+      break;
+    }
+    page_id = reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_);
+  }
+
+  auto *leaf = reinterpret_cast<LeafPage *>(path.back()->GetData());
+  leaf->Insert(key, value, comparator_);
+  if (leaf->GetSize() >= leaf_max_size_) {
+    page_id_t new_leaf_id;
+    Page *new_leaf_page = buffer_pool_manager_->NewPage(&new_leaf_id);
+    BUSTUB_ASSERT(new_leaf_page != nullptr, "out of pages while splitting a b+ tree leaf");
+    auto *new_leaf = reinterpret_cast<LeafPage *>(new_leaf_page->GetData());
+    new_leaf->Init(new_leaf_id, leaf->GetParentPageId(), leaf_max_size_);
+    leaf->MoveHalfTo(new_leaf);
+    InsertIntoParent(&path, leaf, new_leaf->KeyAt(0), new_leaf, root_latched);
+  }
+  for (auto *page : path) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  }
+  if (root_latched) {
+    root_latch_.WUnlock();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(std::vector<Page *> *latched_path, BPlusTreePage *old_node, const KeyType &key,
+                                      BPlusTreePage *new_node, bool root_latched) {
+  // new_node's page is pinned but never latched: it is invisible to other
+  // threads until the parent (held in write mode) publishes a link to it
+  while (true) {
+    if (old_node->IsRootPage()) {
+      // the root was unsafe on this path, so root_latch_ is still held
+      BUSTUB_ASSERT(root_latched, "splitting the root without the root latch");
+      page_id_t new_root_id;
+      Page *new_root_page = buffer_pool_manager_->NewPage(&new_root_id);
+      BUSTUB_ASSERT(new_root_page != nullptr, "out of pages while growing the b+ tree root");
+      auto *new_root = reinterpret_cast<InternalPage *>(new_root_page->GetData());
+      new_root->Init(new_root_id, INVALID_PAGE_ID, internal_max_size_);
+      new_root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+      old_node->SetParentPageId(new_root_id);
+      new_node->SetParentPageId(new_root_id);
+      root_page_id_ = new_root_id;
+      buffer_pool_manager_->UnpinPage(new_root_id, true);
+      buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
+      return;
+    }
+    // the parent is write-latched just above old_node on the path
+    Page *old_page = latched_path->back();
+    latched_path->pop_back();
+    auto *parent = reinterpret_cast<InternalPage *>(latched_path->back()->GetData());
+    parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+    new_node->SetParentPageId(parent->GetPageId());
+    old_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(old_page->GetPageId(), true);
+    buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
+    if (parent->GetSize() <= internal_max_size_) {
+      return;
+    }
+    // the parent overflowed its soft limit (its array still has room for the
+    // extra pair); split it and keep propagating
+    page_id_t new_internal_id;
+    Page *new_internal_page = buffer_pool_manager_->NewPage(&new_internal_id);
+    BUSTUB_ASSERT(new_internal_page != nullptr, "out of pages while splitting a b+ tree internal page");
+    auto *new_internal = reinterpret_cast<InternalPage *>(new_internal_page->GetData());
+    new_internal->Init(new_internal_id, parent->GetParentPageId(), internal_max_size_);
+    parent->MoveHalfTo(new_internal, buffer_pool_manager_);
+    old_node = parent;
+    new_node = new_internal;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    return;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (node->IsLeafPage()) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+  root_latch_.RUnlock();
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_id = internal->Lookup(key, comparator_);
+    Page *child_page = buffer_pool_manager_->FetchPage(child_id);
+    auto *child = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
+    if (child->IsLeafPage()) {
+      child_page->WLatch();
+    } else {
+      child_page->RLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child_page;
+    node = child;
+  }
+  // removal is lazy: the pair leaves its leaf, but leaves are never merged or
+  // freed, so empty leaves simply stay in the chain
+  auto *leaf = reinterpret_cast<LeafPage *>(node);
+  while (true) {
+    bool removed = leaf->RemoveRecord(key, value, comparator_);
+    // the run of equal keys may continue in the next leaf
+    bool run_continues = !removed && (leaf->GetSize() == 0 || comparator_(leaf->KeyAt(leaf->GetSize() - 1), key) <= 0);
+    page_id_t next_id = leaf->GetNextPageId();
+    if (!run_continues || next_id == INVALID_PAGE_ID) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+      return;
+    }
+    Page *next_page = buffer_pool_manager_->FetchPage(next_id);
+    next_page->WLatch();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = next_page;
+    leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  }
+}
+
+template class BPlusTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class BPlusTree<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class BPlusTree<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class BPlusTree<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class BPlusTree<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,65 @@
+#include <vector>
+
+#include "storage/index/b_plus_tree_index.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
+    : Index(metadata),
+      comparator_(metadata->GetKeySchema()),
+      container_(metadata->GetName(), buffer_pool_manager, comparator_) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct insert index key
+  KeyType index_key;
+  BuildIndexKey(&index_key, key, GetKeySchema());
+
+  container_.Insert(index_key, rid, transaction);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key
+  KeyType index_key;
+  BuildIndexKey(&index_key, key, GetKeySchema());
+
+  container_.Remove(index_key, rid, transaction);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // construct scan index key
+  KeyType index_key;
+  BuildIndexKey(&index_key, key, GetKeySchema());
+
+  container_.GetValue(index_key, result, transaction);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void BPLUSTREE_INDEX_TYPE::ScanRange(const Tuple &low, const Tuple &high, std::vector<RID> *result,
+                                     Transaction *transaction) {
+  // construct the two index keys bounding the scan
+  KeyType low_key;
+  BuildIndexKey(&low_key, low, GetKeySchema());
+  KeyType high_key;
+  BuildIndexKey(&high_key, high, GetKeySchema());
+
+  container_.ScanRange(&low_key, &high_key, result, transaction);
+}
+
+template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class BPlusTreeIndex<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class BPlusTreeIndex<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class BPlusTreeIndex<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class BPlusTreeIndex<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+}  // namespace bustub
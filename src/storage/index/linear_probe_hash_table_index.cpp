@@ -8,13 +8,32 @@ namespace bustub {
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_INDEX_TYPE::LinearProbeHashTableIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager,
-                                                 size_t num_buckets, const HashFunction<KeyType> &hash_fn)
+                                                 size_t num_buckets, const HashFunction<KeyType> &hash_fn,
+                                                 LogManager *log_manager, uint32_t index_oid)
     : Index(metadata),
       comparator_(metadata->GetKeySchema()),
-      container_(metadata->GetName(), buffer_pool_manager, comparator_, num_buckets, hash_fn) {}
+      container_(metadata->GetName(), buffer_pool_manager, comparator_, num_buckets, hash_fn),
+      log_manager_(log_manager),
+      index_oid_(index_oid) {}
+
+/*
+ * Write ahead one logical log record for an index mutation
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_INDEX_TYPE::LogIndexOperation(LogRecordType log_record_type, const Tuple &key, RID rid,
+                                              Transaction *transaction) {
+  if (!enable_logging || log_manager_ == nullptr || transaction == nullptr) {
+    return;
+  }
+  LogRecord log_record(transaction->GetTransactionId(), transaction->GetPrevLSN(), log_record_type, index_oid_, key,
+                       rid);
+  transaction->SetPrevLSN(log_manager_->StageLogRecord(&log_record, transaction));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  LogIndexOperation(LogRecordType::INDEXINSERT, key, rid, transaction);
+
   // construct insert index key
   KeyType index_key;
   index_key.SetFromKey(key);
@@ -24,6 +43,8 @@ void HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  LogIndexOperation(LogRecordType::INDEXDELETE, key, rid, transaction);
+
   // construct delete index key
   KeyType index_key;
   index_key.SetFromKey(key);
@@ -39,6 +60,41 @@ void HASH_TABLE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result,
 
   container_.GetValue(transaction, index_key, result);
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_INDEX_TYPE::ScanSingleKey(const Tuple &key, ValueType *result, Transaction *transaction) {
+  // construct scan index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  return container_.GetSingleValue(transaction, index_key, result);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_INDEX_TYPE::InsertEntries(const std::vector<std::pair<Tuple, ValueType>> &entries,
+                                          Transaction *transaction) {
+  // construct all the index keys up front, then let the table batch by bucket
+  std::vector<std::pair<KeyType, ValueType>> index_entries;
+  index_entries.reserve(entries.size());
+  for (const auto &entry : entries) {
+    KeyType index_key;
+    index_key.SetFromKey(entry.first);
+    index_entries.emplace_back(index_key, entry.second);
+  }
+  container_.InsertBatch(transaction, index_entries);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<ValueType>> *results,
+                                     Transaction *transaction) {
+  // construct all the index keys up front, then let the table batch by bucket
+  std::vector<KeyType> index_keys(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys[i].SetFromKey(keys[i]);
+  }
+  container_.GetValueBatch(transaction, index_keys, results);
+}
+
 template class LinearProbeHashTableIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class LinearProbeHashTableIndex<GenericKey<16>, RID, GenericComparator<16>>;
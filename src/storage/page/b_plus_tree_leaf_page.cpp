@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_leaf_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_leaf_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  SetSize(0);
+  SetMaxSize(max_size);
+  SetLSN();
+  next_page_id_ = INVALID_PAGE_ID;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const { return array_[index].first; }
+
+INDEX_TEMPLATE_ARGUMENTS
+const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const { return array_[index]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  // binary search for the first index whose key is not less than the target
+  int left = 0;
+  int right = GetSize() - 1;
+  int result = GetSize();
+  while (left <= right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(array_[mid].first, key) < 0) {
+      left = mid + 1;
+    } else {
+      result = mid;
+      right = mid - 1;
+    }
+  }
+  return result;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
+  // upper bound: the new pair lands after any existing pairs with an equal key
+  int index = GetSize();
+  while (index > 0 && comparator(key, array_[index - 1].first) < 0) {
+    index--;
+  }
+  for (int i = GetSize(); i > index; i--) {
+    array_[i] = array_[i - 1];
+  }
+  array_[index].first = key;
+  array_[index].second = value;
+  IncreaseSize(1);
+  return GetSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveRecord(const KeyType &key, const ValueType &value,
+                                              const KeyComparator &comparator) {
+  for (int i = KeyIndex(key, comparator); i < GetSize() && comparator(array_[i].first, key) == 0; i++) {
+    if (array_[i].second == value) {
+      for (int j = i; j < GetSize() - 1; j++) {
+        array_[j] = array_[j + 1];
+      }
+      IncreaseSize(-1);
+      return true;
+    }
+  }
+  return false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
+  int start = GetSize() / 2;
+  int moved = GetSize() - start;
+  for (int i = 0; i < moved; i++) {
+    recipient->array_[i] = array_[start + i];
+  }
+  recipient->SetSize(moved);
+  SetSize(start);
+  recipient->SetNextPageId(GetNextPageId());
+  SetNextPageId(recipient->GetPageId());
+}
+
+// explicit template instantiations, values are record ids
+template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class BPlusTreeLeafPage<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class BPlusTreeLeafPage<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class BPlusTreeLeafPage<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class BPlusTreeLeafPage<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+}  // namespace bustub
@@ -10,37 +10,153 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
+
+#include "common/util/hash_util.h"
 #include "storage/page/hash_table_block_page.h"
 #include "storage/index/generic_key.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 KeyType HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 ValueType HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) {
-  return false;
+  char mask = static_cast<char>(1U << (bucket_ind % 8));
+  // fetch_or claims the slot: exactly one inserter sees the occupied bit flip from 0 to 1.
+  if ((occupied_[bucket_ind / 8].fetch_or(mask) & mask) != 0) {
+    return false;
+  }
+  array_[bucket_ind] = std::make_pair(key, value);
+  tags_[bucket_ind] = Tag(key);
+  readable_[bucket_ind / 8].fetch_or(mask);
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+unsigned char HASH_TABLE_BLOCK_TYPE::Tag(const KeyType &key) {
+  // any byte of the avalanched hash works; keys hash by their bytes, so equal
+  // keys always carry equal tags
+  return static_cast<unsigned char>(HashUtil::HashBytes(reinterpret_cast<const char *>(&key), sizeof(KeyType)) >> 56);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {}
+void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
+  char mask = static_cast<char>(1U << (bucket_ind % 8));
+  // Clearing only the readable bit leaves a tombstone: probes keep walking past the slot.
+  readable_[bucket_ind / 8].fetch_and(static_cast<char>(~mask));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const {
-  return false;
+  char mask = static_cast<char>(1U << (bucket_ind % 8));
+  return (occupied_[bucket_ind / 8].load() & mask) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const {
-  return false;
+  char mask = static_cast<char>(1U << (bucket_ind % 8));
+  return (readable_[bucket_ind / 8].load() & mask) != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint64_t HASH_TABLE_BLOCK_TYPE::LoadBitmapWord(const std::atomic_char *bitmap, slot_offset_t base) const {
+  size_t first_byte = base / 8;
+  size_t num_bytes = std::min<size_t>(8, (BLOCK_ARRAY_SIZE - 1) / 8 + 1 - first_byte);
+  uint64_t word = 0;
+  for (size_t i = 0; i < num_bytes; i++) {
+    word |= static_cast<uint64_t>(static_cast<unsigned char>(bitmap[first_byte + i].load())) << (8 * i);
+  }
+  return word;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BLOCK_TYPE::ProbeWindow(slot_offset_t start, const KeyType &key, uint64_t *match_mask,
+                                        slot_offset_t *chain_end) const {
+  slot_offset_t base = start & ~static_cast<slot_offset_t>(63);
+  size_t valid = std::min<size_t>(64, BLOCK_ARRAY_SIZE - base);
+  uint64_t active = (valid == 64 ? ~0ULL : (1ULL << valid) - 1) & (~0ULL << (start - base));
+  uint64_t occupied = LoadBitmapWord(occupied_, base);
+  uint64_t unoccupied = ~occupied & active;
+  bool ended = unoccupied != 0;
+  // Matches past the first never-occupied slot belong to other probe chains; mask them off.
+  uint64_t below_end = ended ? (1ULL << __builtin_ctzll(unoccupied)) - 1 : ~0ULL;
+  *chain_end = ended ? base + __builtin_ctzll(unoccupied) : base + valid;
+  uint64_t candidates = LoadBitmapWord(readable_, base) & active & below_end;
+  uint64_t matches = 0;
+  if (candidates != 0) {
+    // The fingerprint tags go first: one byte compare per slot dismisses almost every
+    // non-matching candidate, so a negative probe rarely reaches a full key compare.
+    unsigned char tag = Tag(key);
+#ifdef __AVX2__
+    // 32 tags per compare; loads past the tag array read pair bytes on the same page,
+    // and the candidate mask has already excluded those slots.
+    __m256i probe_tag = _mm256_set1_epi8(static_cast<char>(tag));
+    const auto *tag_bytes = reinterpret_cast<const __m256i *>(&tags_[base]);
+    uint64_t tag_eq =
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(tag_bytes), probe_tag)));
+    tag_eq |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(
+                  _mm256_cmpeq_epi8(_mm256_loadu_si256(tag_bytes + 1), probe_tag))))
+              << 32;
+    candidates &= tag_eq;
+#else
+    uint64_t remaining_tags = candidates;
+    while (remaining_tags != 0) {
+      slot_offset_t offset = __builtin_ctzll(remaining_tags);
+      if (tags_[base + offset] != tag) {
+        candidates &= ~(1ULL << offset);
+      }
+      remaining_tags &= remaining_tags - 1;
+    }
+#endif
+  }
+#ifdef __AVX2__
+  if constexpr (sizeof(KeyType) == 8 && sizeof(MappingType) == 16) {
+    // Keys sit in 64-bit lanes 0 and 2 of each 32-byte pair of slots; one 256-bit compare
+    // against the broadcast probe key tests two slots, so a 4-slot group costs two compares.
+    int64_t probe_word;
+    memcpy(&probe_word, &key, sizeof(probe_word));
+    __m256i probe = _mm256_set1_epi64x(probe_word);
+    uint64_t remaining = candidates;
+    while (remaining != 0) {
+      slot_offset_t group = (__builtin_ctzll(remaining) / 4) * 4;
+      if (base + group + 4 > BLOCK_ARRAY_SIZE) {
+        break;  // the ragged tail falls through to the scalar loop below
+      }
+      const auto *slots = reinterpret_cast<const __m256i *>(&array_[base + group]);
+      int eq_lo = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256(slots), probe)));
+      int eq_hi = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256(slots + 1), probe)));
+      // movemask_pd lanes 0 and 2 carry the two key compares of each 32-byte load.
+      uint64_t group_eq = static_cast<uint64_t>((eq_lo & 1) | ((eq_lo >> 1) & 2) | ((eq_hi & 1) << 2) |
+                                                (((eq_hi >> 1) & 2) << 2));
+      matches |= (group_eq << group) & candidates;
+      remaining &= ~(0xFULL << group);
+    }
+    candidates = remaining;
+  }
+#endif
+  while (candidates != 0) {
+    slot_offset_t offset = base + __builtin_ctzll(candidates);
+    if (memcmp(&array_[offset].first, &key, sizeof(KeyType)) == 0) {
+      matches |= 1ULL << (offset - base);
+    }
+    candidates &= candidates - 1;
+  }
+  *match_mask = matches;
+  return ended;
 }
 
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
@@ -0,0 +1,361 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_page.cpp
+//
+// Identification: src/storage/page/pax_table_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_table_page.h"
+
+#include <cassert>
+
+namespace bustub {
+
+void PaxTablePage::Init(page_id_t page_id, const Schema *schema, page_id_t prev_page_id, LogManager *log_manager,
+                        Transaction *txn) {
+  BUSTUB_ASSERT(schema->GetUnlinedColumnCount() == 0, "The PAX layout supports fixed-length schemas only.");
+  // Set the page ID.
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  // Log that we are creating a new page.
+  if (enable_logging) {
+    LogRecord log_record =
+        LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::NEWPAGE, prev_page_id, page_id);
+    lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
+    SetLSN(lsn);
+    txn->SetPrevLSN(lsn);
+  }
+  SetPrevPageId(prev_page_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetTupleCount(0);
+  SetCapacity(Capacity(schema));
+  // Every slot starts out empty.
+  memset(GetData() + SIZE_PAX_PAGE_HEADER, SLOT_EMPTY, GetCapacity());
+}
+
+bool PaxTablePage::InsertTuple(const Schema *schema, const Tuple &tuple, RID *rid, Transaction *txn,
+                               LockManager *lock_manager, LogManager *log_manager) {
+  BUSTUB_ASSERT(tuple.size_ == schema->GetLength() + Tuple::NullBitmapSize(schema),
+                "A PAX row must be exactly one schema-width tuple plus its null bitmap.");
+  // Claim the first empty slot; slots freed by ApplyDelete are reused.
+  uint32_t capacity = GetCapacity();
+  uint32_t slot;
+  for (slot = 0; slot < capacity; slot++) {
+    if (GetSlotStatus(slot) == SLOT_EMPTY) {
+      break;
+    }
+  }
+  if (slot == capacity) {
+    return false;
+  }
+
+  ScatterColumns(schema, slot, tuple.data_);
+  SetSlotStatus(slot, SLOT_LIVE);
+  rid->Set(GetTablePageId(), slot);
+  if (slot >= GetTupleCount()) {
+    SetTupleCount(slot + 1);
+  }
+
+  // Write the log record.
+  if (enable_logging) {
+    BUSTUB_ASSERT(!txn->IsSharedLocked(*rid) && !txn->IsExclusiveLocked(*rid), "A new tuple should not be locked.");
+    // Acquire an exclusive lock on the new tuple; a null lock manager means the caller holds a
+    // covering table-granularity lock (see TableHeap::RowLockManager).
+    bool locked = lock_manager == nullptr || lock_manager->LockExclusive(txn, *rid);
+    BUSTUB_ASSERT(locked, "Locking a new tuple should always work.");
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::INSERT, *rid, tuple);
+    lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
+    SetLSN(lsn);
+    txn->SetPrevLSN(lsn);
+  }
+  return true;
+}
+
+bool PaxTablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  // If the slot does not hold a live tuple, abort the transaction.
+  if (slot_num >= GetTupleCount() || GetSlotStatus(slot_num) != SLOT_LIVE) {
+    if (enable_logging) {
+      txn->SetState(TransactionState::ABORTED);
+    }
+    return false;
+  }
+
+  if (enable_logging) {
+    // Acquire an exclusive lock, upgrading from a shared lock if necessary. A null lock manager
+    // means the caller holds a covering table-granularity lock.
+    if (lock_manager != nullptr) {
+      if (txn->IsSharedLocked(rid)) {
+        if (!lock_manager->LockUpgrade(txn, rid)) {
+          return false;
+        }
+      } else if (!txn->IsExclusiveLocked(rid) && !lock_manager->LockExclusive(txn, rid)) {
+        return false;
+      }
+    }
+    Tuple dummy_tuple;
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::MARKDELETE, rid, dummy_tuple);
+    lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
+    SetLSN(lsn);
+    txn->SetPrevLSN(lsn);
+  }
+
+  SetSlotStatus(slot_num, SLOT_DELETED);
+  return true;
+}
+
+bool PaxTablePage::UpdateTuple(const Schema *schema, const Tuple &new_tuple, Tuple *old_tuple, const RID &rid,
+                               Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
+  BUSTUB_ASSERT(new_tuple.size_ == schema->GetLength() + Tuple::NullBitmapSize(schema),
+                "A PAX row must be exactly one schema-width tuple plus its null bitmap.");
+  uint32_t slot_num = rid.GetSlotNum();
+  // If the slot does not hold a live tuple, abort the transaction.
+  if (slot_num >= GetTupleCount() || GetSlotStatus(slot_num) != SLOT_LIVE) {
+    if (enable_logging) {
+      txn->SetState(TransactionState::ABORTED);
+    }
+    return false;
+  }
+
+  // Copy out the old value.
+  GatherTuple(schema, slot_num, old_tuple);
+  old_tuple->rid_ = rid;
+
+  if (enable_logging) {
+    // Acquire an exclusive lock, upgrading from shared if necessary. A null lock manager means
+    // the caller holds a covering table-granularity lock.
+    if (lock_manager != nullptr) {
+      if (txn->IsSharedLocked(rid)) {
+        if (!lock_manager->LockUpgrade(txn, rid)) {
+          return false;
+        }
+      } else if (!txn->IsExclusiveLocked(rid) && !lock_manager->LockExclusive(txn, rid)) {
+        return false;
+      }
+    }
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::UPDATE, rid, *old_tuple, new_tuple);
+    lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
+    SetLSN(lsn);
+    txn->SetPrevLSN(lsn);
+  }
+
+  // Rows are fixed-length, so the update always fits in place.
+  ScatterColumns(schema, slot_num, new_tuple.data_);
+  return true;
+}
+
+void PaxTablePage::ApplyDelete(const Schema *schema, const RID &rid, Transaction *txn, LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  BUSTUB_ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
+  BUSTUB_ASSERT(GetSlotStatus(slot_num) != SLOT_EMPTY, "Cannot apply a delete to an empty slot.");
+
+  // We need to copy out the deleted tuple for undo purposes.
+  Tuple delete_tuple;
+  GatherTuple(schema, slot_num, &delete_tuple);
+  delete_tuple.rid_ = rid;
+
+  if (enable_logging) {
+    BUSTUB_ASSERT(txn->IsExclusiveLocked(rid), "We must own the exclusive lock!");
+
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::APPLYDELETE, rid, delete_tuple);
+    lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
+    SetLSN(lsn);
+    txn->SetPrevLSN(lsn);
+  }
+
+  // The minipage bytes stay behind; an empty status is what frees the slot.
+  SetSlotStatus(slot_num, SLOT_EMPTY);
+}
+
+void PaxTablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
+  // Log the rollback.
+  if (enable_logging) {
+    BUSTUB_ASSERT(txn->IsExclusiveLocked(rid), "We must own an exclusive lock on the RID.");
+    Tuple dummy_tuple;
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::ROLLBACKDELETE, rid, dummy_tuple);
+    lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
+    SetLSN(lsn);
+    txn->SetPrevLSN(lsn);
+  }
+
+  uint32_t slot_num = rid.GetSlotNum();
+  BUSTUB_ASSERT(slot_num < GetTupleCount(), "We can't have more slots than tuples.");
+
+  // Unset the deleted status.
+  if (GetSlotStatus(slot_num) == SLOT_DELETED) {
+    SetSlotStatus(slot_num, SLOT_LIVE);
+  }
+}
+
+bool PaxTablePage::GetTuple(const Schema *schema, const RID &rid, Tuple *tuple, Transaction *txn,
+                            LockManager *lock_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  // If the slot does not hold a live tuple, abort the transaction.
+  if (slot_num >= GetTupleCount() || GetSlotStatus(slot_num) != SLOT_LIVE) {
+    if (enable_logging) {
+      txn->SetState(TransactionState::ABORTED);
+    }
+    return false;
+  }
+
+  // Otherwise we have a valid tuple, try to acquire at least a shared lock. A null lock manager
+  // means the caller holds a covering table-granularity lock.
+  if (enable_logging && lock_manager != nullptr) {
+    if (!txn->IsSharedLocked(rid) && !txn->IsExclusiveLocked(rid) && !lock_manager->LockShared(txn, rid)) {
+      return false;
+    }
+  }
+
+  GatherTuple(schema, slot_num, tuple);
+  tuple->rid_ = rid;
+  return true;
+}
+
+bool PaxTablePage::GetTupleView(const Schema *schema, const RID &rid, const std::function<void(const Tuple &)> &consume,
+                                Transaction *txn, LockManager *lock_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  // If the slot does not hold a live tuple, abort the transaction.
+  if (slot_num >= GetTupleCount() || GetSlotStatus(slot_num) != SLOT_LIVE) {
+    if (enable_logging) {
+      txn->SetState(TransactionState::ABORTED);
+    }
+    return false;
+  }
+
+  // Same lock discipline as GetTuple. A null lock manager means the caller holds a covering
+  // table-granularity lock.
+  if (enable_logging && lock_manager != nullptr) {
+    if (!txn->IsSharedLocked(rid) && !txn->IsExclusiveLocked(rid) && !lock_manager->LockShared(txn, rid)) {
+      return false;
+    }
+  }
+
+  // The view aliases a stack scratch row; allocated_ stays false so it never frees it.
+  char row[PAGE_SIZE];
+  for (uint32_t col_idx = 0; col_idx < schema->GetColumnCount(); col_idx++) {
+    const Column &col = schema->GetColumn(col_idx);
+    memcpy(row + col.GetOffset(), ColumnEntry(schema, col_idx, slot_num), col.GetFixedLength());
+  }
+  memcpy(row + schema->GetLength(), NullBitmapEntry(schema, slot_num), Tuple::NullBitmapSize(schema));
+  Tuple view;
+  view.size_ = schema->GetLength() + Tuple::NullBitmapSize(schema);
+  view.data_ = row;
+  view.rid_ = rid;
+  consume(view);
+  view.data_ = nullptr;
+  return true;
+}
+
+bool PaxTablePage::FindFirstMatch(const Schema *schema, uint32_t start_slot, const std::vector<uint32_t> &needed_cols,
+                                  const std::function<bool(const Tuple &)> &predicate, RID *rid,
+                                  const std::function<void(const Tuple &)> &consume, const uint64_t *selection) {
+  uint32_t tuple_count = GetTupleCount();
+  // The scratch row is laid out by the schema but only the needed columns are ever written (or
+  // read); the view aliases it, and allocated_ stays false so it never frees what it points at.
+  char row[PAGE_SIZE];
+  Tuple view;
+  view.size_ = schema->GetLength() + Tuple::NullBitmapSize(schema);
+  view.data_ = row;
+  for (uint32_t slot = start_slot; slot < tuple_count; slot++) {
+    // A columnar kernel already rejected slots whose selection bit is clear; skip them before
+    // the status check so failing rows cost a bit test and nothing else.
+    if (selection != nullptr && ((selection[slot / 64] >> (slot % 64)) & 1) == 0) {
+      continue;
+    }
+    if (GetSlotStatus(slot) != SLOT_LIVE) {
+      continue;
+    }
+    view.rid_ = RID(GetTablePageId(), slot);
+    GatherColumns(schema, slot, needed_cols, row);
+    if (predicate != nullptr && !predicate(view)) {
+      continue;
+    }
+    consume(view);
+    *rid = view.rid_;
+    view.data_ = nullptr;
+    return true;
+  }
+  view.data_ = nullptr;
+  return false;
+}
+
+void PaxTablePage::GetColumnVector(const Schema *schema, uint32_t col_idx, const char **data, uint32_t *count) {
+  *data = ColumnEntry(schema, col_idx, 0);
+  *count = GetTupleCount();
+}
+
+uint32_t PaxTablePage::VacuumSlots() {
+  uint32_t count = GetTupleCount();
+  uint32_t stored = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    if (GetSlotStatus(i) != SLOT_EMPTY) {
+      stored++;
+    }
+  }
+  // Trim trailing empty slots off the high-water mark so scans stop visiting them.
+  while (count > 0 && GetSlotStatus(count - 1) == SLOT_EMPTY) {
+    count--;
+  }
+  SetTupleCount(count);
+  return stored;
+}
+
+bool PaxTablePage::GetFirstTupleRid(RID *first_rid) {
+  // Find and return the first valid tuple.
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    if (GetSlotStatus(i) != SLOT_EMPTY) {
+      first_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+bool PaxTablePage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) {
+  BUSTUB_ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  // Find and return the first valid tuple after our current slot number.
+  for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); ++i) {
+    if (GetSlotStatus(i) != SLOT_EMPTY) {
+      next_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  // Otherwise return false as there are no more tuples.
+  next_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+void PaxTablePage::ScatterColumns(const Schema *schema, uint32_t slot_num, const char *row) {
+  for (uint32_t col_idx = 0; col_idx < schema->GetColumnCount(); col_idx++) {
+    const Column &col = schema->GetColumn(col_idx);
+    memcpy(ColumnEntry(schema, col_idx, slot_num), row + col.GetOffset(), col.GetFixedLength());
+  }
+  // With no varlen tail, the row's null bitmap sits right after the fixed section.
+  memcpy(NullBitmapEntry(schema, slot_num), row + schema->GetLength(), Tuple::NullBitmapSize(schema));
+}
+
+void PaxTablePage::GatherColumns(const Schema *schema, uint32_t slot_num, const std::vector<uint32_t> &cols,
+                                 char *row) {
+  for (uint32_t col_idx : cols) {
+    const Column &col = schema->GetColumn(col_idx);
+    memcpy(row + col.GetOffset(), ColumnEntry(schema, col_idx, slot_num), col.GetFixedLength());
+  }
+  // The null bitmap is always gathered; readers consult it before any column.
+  memcpy(row + schema->GetLength(), NullBitmapEntry(schema, slot_num), Tuple::NullBitmapSize(schema));
+}
+
+void PaxTablePage::GatherTuple(const Schema *schema, uint32_t slot_num, Tuple *tuple) {
+  tuple->ResizeData(schema->GetLength() + Tuple::NullBitmapSize(schema));
+  for (uint32_t col_idx = 0; col_idx < schema->GetColumnCount(); col_idx++) {
+    const Column &col = schema->GetColumn(col_idx);
+    memcpy(tuple->data_ + col.GetOffset(), ColumnEntry(schema, col_idx, slot_num), col.GetFixedLength());
+  }
+  memcpy(tuple->data_ + schema->GetLength(), NullBitmapEntry(schema, slot_num), Tuple::NullBitmapSize(schema));
+}
+
+}  // namespace bustub
@@ -14,6 +14,8 @@
 
 #include <cassert>
 
+#include "execution/tuple_batch.h"
+
 namespace bustub {
 
 void TablePage::Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_id, LogManager *log_manager,
@@ -21,9 +23,10 @@ void TablePage::Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_
   // Set the page ID.
   memcpy(GetData(), &page_id, sizeof(page_id));
   // Log that we are creating a new page.
-  if (enable_logging) {
-    LogRecord log_record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::NEWPAGE, prev_page_id);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
+  if (enable_logging && txn != nullptr) {
+    LogRecord log_record =
+        LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::NEWPAGE, prev_page_id, page_id);
+    lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
     SetLSN(lsn);
     txn->SetPrevLSN(lsn);
   }
@@ -32,28 +35,37 @@ void TablePage::Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_
   SetNextPageId(INVALID_PAGE_ID);
   SetFreeSpacePointer(page_size);
   SetTupleCount(0);
+  // A recycled frame can hold stale bytes; the bitmaps and live count start from zero.
+  memset(GetData() + OFFSET_OCCUPIED_BITMAP, 0, SIZE_SLOT_BITMAP);
+  memset(GetData() + OFFSET_DELETED_BITMAP, 0, SIZE_SLOT_BITMAP);
+  SetLiveTupleCount(0);
 }
 
 bool TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager,
-                            LogManager *log_manager) {
+                            LogManager *log_manager, uint32_t reserved, bool defer_log) {
   BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
-  // If there is not enough space, then return false.
-  if (GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
+  // If there is not enough space past the reserved headroom, then return false.
+  if (GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE + reserved) {
     return false;
   }
 
-  // Try to find a free slot to reuse.
-  uint32_t i;
-  for (i = 0; i < GetTupleCount(); i++) {
-    // If the slot is empty, i.e. its tuple has size 0,
-    if (GetTupleSize(i) == 0) {
-      // Then we break out of the loop at index i.
+  // Try to find a free slot to reuse: the first hole in the occupied bitmap below the count.
+  uint32_t count = GetTupleCount();
+  uint32_t i = count;
+  const uint64_t *occupied = OccupiedBitmap();
+  for (uint32_t word = 0; (word << 6) < count; word++) {
+    uint64_t holes = ~occupied[word];
+    if (holes != 0) {
+      uint32_t slot = (word << 6) + static_cast<uint32_t>(__builtin_ctzll(holes));
+      if (slot < count) {
+        i = slot;
+      }
       break;
     }
   }
 
   // If there was no free slot left, and we cannot claim it from the free space, then we give up.
-  if (i == GetTupleCount() && GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
+  if (i == GetTupleCount() && GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE + reserved) {
     return false;
   }
 
@@ -69,26 +81,44 @@ bool TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, Lock
   if (i == GetTupleCount()) {
     SetTupleCount(GetTupleCount() + 1);
   }
+  SetBitmapBit(OccupiedBitmap(), i);
+  SetLiveTupleCount(GetLiveTupleCount() + 1);
 
   // Write the log record.
-  if (enable_logging) {
+  if (enable_logging && txn != nullptr) {
     BUSTUB_ASSERT(!txn->IsSharedLocked(*rid) && !txn->IsExclusiveLocked(*rid), "A new tuple should not be locked.");
-    // Acquire an exclusive lock on the new tuple.
-    bool locked = lock_manager->LockExclusive(txn, *rid);
+    // Acquire an exclusive lock on the new tuple; a null lock manager means the caller holds a
+    // covering table-granularity lock (see TableHeap::RowLockManager).
+    bool locked = lock_manager == nullptr || lock_manager->LockExclusive(txn, *rid);
     BUSTUB_ASSERT(locked, "Locking a new tuple should always work.");
-    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::INSERT, *rid, tuple);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
-    SetLSN(lsn);
-    txn->SetPrevLSN(lsn);
+    // A deferring caller covers the whole run of inserts with one LogInsertBatch record.
+    if (!defer_log) {
+      LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::INSERT, *rid, tuple);
+      lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
+      SetLSN(lsn);
+      txn->SetPrevLSN(lsn);
+    }
   }
   return true;
 }
 
+void TablePage::LogInsertBatch(const std::vector<RID> &rids, const std::vector<const Tuple *> &tuples,
+                               Transaction *txn, LogManager *log_manager) {
+  BUSTUB_ASSERT(rids.size() == tuples.size(), "Each batch-logged row needs its image.");
+  if (rids.empty()) {
+    return;
+  }
+  LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::INSERTBATCH, rids, tuples);
+  lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
+  SetLSN(lsn);
+  txn->SetPrevLSN(lsn);
+}
+
 bool TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
   uint32_t slot_num = rid.GetSlotNum();
   // If the slot number is invalid, abort the transaction.
   if (slot_num >= GetTupleCount()) {
-    if (enable_logging) {
+    if (enable_logging && txn != nullptr) {
       txn->SetState(TransactionState::ABORTED);
     }
     return false;
@@ -97,24 +127,27 @@ bool TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_m
   uint32_t tuple_size = GetTupleSize(slot_num);
   // If the tuple is already deleted, abort the transaction.
   if (IsDeleted(tuple_size)) {
-    if (enable_logging) {
+    if (enable_logging && txn != nullptr) {
       txn->SetState(TransactionState::ABORTED);
     }
     return false;
   }
 
-  if (enable_logging) {
-    // Acquire an exclusive lock, upgrading from a shared lock if necessary.
-    if (txn->IsSharedLocked(rid)) {
-      if (!lock_manager->LockUpgrade(txn, rid)) {
+  if (enable_logging && txn != nullptr) {
+    // Acquire an exclusive lock, upgrading from a shared lock if necessary. A null lock manager
+    // means the caller holds a covering table-granularity lock.
+    if (lock_manager != nullptr) {
+      if (txn->IsSharedLocked(rid)) {
+        if (!lock_manager->LockUpgrade(txn, rid)) {
+          return false;
+        }
+      } else if (!txn->IsExclusiveLocked(rid) && !lock_manager->LockExclusive(txn, rid)) {
         return false;
       }
-    } else if (!txn->IsExclusiveLocked(rid) && !lock_manager->LockExclusive(txn, rid)) {
-      return false;
     }
     Tuple dummy_tuple;
     LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::MARKDELETE, rid, dummy_tuple);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
+    lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
     SetLSN(lsn);
     txn->SetPrevLSN(lsn);
   }
@@ -122,6 +155,8 @@ bool TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_m
   // Mark the tuple as deleted.
   if (tuple_size > 0) {
     SetTupleSize(slot_num, SetDeletedFlag(tuple_size));
+    SetBitmapBit(DeletedBitmap(), slot_num);
+    SetLiveTupleCount(GetLiveTupleCount() - 1);
   }
   return true;
 }
@@ -132,7 +167,7 @@ bool TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
   uint32_t slot_num = rid.GetSlotNum();
   // If the slot number is invalid, abort the transaction.
   if (slot_num >= GetTupleCount()) {
-    if (enable_logging) {
+    if (enable_logging && txn != nullptr) {
       txn->SetState(TransactionState::ABORTED);
     }
     return false;
@@ -140,7 +175,7 @@ bool TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
   uint32_t tuple_size = GetTupleSize(slot_num);
   // If the tuple is deleted, abort the transaction.
   if (IsDeleted(tuple_size)) {
-    if (enable_logging) {
+    if (enable_logging && txn != nullptr) {
       txn->SetState(TransactionState::ABORTED);
     }
     return false;
@@ -152,30 +187,35 @@ bool TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
 
   // Copy out the old value.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  old_tuple->size_ = tuple_size;
-  if (old_tuple->allocated_) {
-    delete[] old_tuple->data_;
-  }
-  old_tuple->data_ = new char[old_tuple->size_];
-  memcpy(old_tuple->data_, GetData() + tuple_offset, old_tuple->size_);
+  memcpy(old_tuple->ResizeData(tuple_size), GetData() + tuple_offset, tuple_size);
   old_tuple->rid_ = rid;
-  old_tuple->allocated_ = true;
 
-  if (enable_logging) {
-    // Acquire an exclusive lock, upgrading from shared if necessary.
-    if (txn->IsSharedLocked(rid)) {
-      if (!lock_manager->LockUpgrade(txn, rid)) {
+  if (enable_logging && txn != nullptr) {
+    // Acquire an exclusive lock, upgrading from shared if necessary. A null lock manager means
+    // the caller holds a covering table-granularity lock.
+    if (lock_manager != nullptr) {
+      if (txn->IsSharedLocked(rid)) {
+        if (!lock_manager->LockUpgrade(txn, rid)) {
+          return false;
+        }
+      } else if (!txn->IsExclusiveLocked(rid) && !lock_manager->LockExclusive(txn, rid)) {
         return false;
       }
-    } else if (!txn->IsExclusiveLocked(rid) && !lock_manager->LockExclusive(txn, rid)) {
-      return false;
     }
     LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::UPDATE, rid, *old_tuple, new_tuple);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
+    lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
     SetLSN(lsn);
     txn->SetPrevLSN(lsn);
   }
 
+  // Fast path: a same-size update overwrites the bytes where they sit. Nothing else in the page
+  // moves, so the memmove of every byte below the tuple and the slot-directory offset rewrite
+  // are both skipped -- the common case for fixed-width counter updates.
+  if (new_tuple.size_ == tuple_size) {
+    memcpy(GetData() + tuple_offset, new_tuple.data_, new_tuple.size_);
+    return true;
+  }
+
   // Perform the update.
   uint32_t free_space_pointer = GetFreeSpacePointer();
   BUSTUB_ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
@@ -203,24 +243,22 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t tuple_size = GetTupleSize(slot_num);
   // Check if this is a delete operation, i.e. commit a delete.
-  if (IsDeleted(tuple_size)) {
+  bool was_live = !IsDeleted(tuple_size);
+  if (!was_live) {
     tuple_size = UnsetDeletedFlag(tuple_size);
   }
   // Otherwise we are rolling back an insert.
 
   // We need to copy out the deleted tuple for undo purposes.
   Tuple delete_tuple;
-  delete_tuple.size_ = tuple_size;
-  delete_tuple.data_ = new char[delete_tuple.size_];
-  memcpy(delete_tuple.data_, GetData() + tuple_offset, delete_tuple.size_);
+  memcpy(delete_tuple.ResizeData(tuple_size), GetData() + tuple_offset, tuple_size);
   delete_tuple.rid_ = rid;
-  delete_tuple.allocated_ = true;
 
-  if (enable_logging) {
+  if (enable_logging && txn != nullptr) {
     BUSTUB_ASSERT(txn->IsExclusiveLocked(rid), "We must own the exclusive lock!");
 
     LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::APPLYDELETE, rid, delete_tuple);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
+    lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
     SetLSN(lsn);
     txn->SetPrevLSN(lsn);
   }
@@ -233,6 +271,12 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
   SetFreeSpacePointer(free_space_pointer + tuple_size);
   SetTupleSize(slot_num, 0);
   SetTupleOffsetAtSlot(slot_num, 0);
+  // The slot is empty now; a committed delete already left the live count without this row.
+  ClearBitmapBit(OccupiedBitmap(), slot_num);
+  ClearBitmapBit(DeletedBitmap(), slot_num);
+  if (was_live) {
+    SetLiveTupleCount(GetLiveTupleCount() - 1);
+  }
 
   // Update all tuple offsets.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
@@ -245,11 +289,11 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
 
 void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
   // Log the rollback.
-  if (enable_logging) {
+  if (enable_logging && txn != nullptr) {
     BUSTUB_ASSERT(txn->IsExclusiveLocked(rid), "We must own an exclusive lock on the RID.");
     Tuple dummy_tuple;
     LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::ROLLBACKDELETE, rid, dummy_tuple);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
+    lsn_t lsn = log_manager->StageLogRecord(&log_record, txn);
     SetLSN(lsn);
     txn->SetPrevLSN(lsn);
   }
@@ -258,9 +302,12 @@ void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log
   BUSTUB_ASSERT(slot_num < GetTupleCount(), "We can't have more slots than tuples.");
   uint32_t tuple_size = GetTupleSize(slot_num);
 
-  // Unset the deleted flag.
-  if (IsDeleted(tuple_size)) {
+  // Unset the deleted flag; the tombstone check uses the flag itself, since an empty slot
+  // has no delete to roll back.
+  if ((tuple_size & DELETE_MASK) != 0) {
     SetTupleSize(slot_num, UnsetDeletedFlag(tuple_size));
+    ClearBitmapBit(DeletedBitmap(), slot_num);
+    SetLiveTupleCount(GetLiveTupleCount() + 1);
   }
 }
 
@@ -269,7 +316,7 @@ bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
   uint32_t slot_num = rid.GetSlotNum();
   // If somehow we have more slots than tuples, abort the transaction.
   if (slot_num >= GetTupleCount()) {
-    if (enable_logging) {
+    if (enable_logging && txn != nullptr) {
       txn->SetState(TransactionState::ABORTED);
     }
     return false;
@@ -278,14 +325,15 @@ bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
   uint32_t tuple_size = GetTupleSize(slot_num);
   // If the tuple is deleted, abort the transaction.
   if (IsDeleted(tuple_size)) {
-    if (enable_logging) {
+    if (enable_logging && txn != nullptr) {
       txn->SetState(TransactionState::ABORTED);
     }
     return false;
   }
 
-  // Otherwise we have a valid tuple, try to acquire at least a shared lock.
-  if (enable_logging) {
+  // Otherwise we have a valid tuple, try to acquire at least a shared lock. A null lock manager
+  // means the caller holds a covering table-granularity lock.
+  if (enable_logging && txn != nullptr && lock_manager != nullptr) {
     if (!txn->IsSharedLocked(rid) && !txn->IsExclusiveLocked(rid) && !lock_manager->LockShared(txn, rid)) {
       return false;
     }
@@ -293,37 +341,209 @@ bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
 
   // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  tuple->size_ = tuple_size;
-  if (tuple->allocated_) {
-    delete[] tuple->data_;
+  memcpy(tuple->ResizeData(tuple_size), GetData() + tuple_offset, tuple_size);
+  tuple->rid_ = rid;
+  return true;
+}
+
+bool TablePage::GetTupleRaw(const RID &rid, Tuple *tuple) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = UnsetDeletedFlag(GetTupleSize(slot_num));
+  // An empty slot's delete has already been applied; there are no bytes left to read.
+  if (tuple_size == 0) {
+    return false;
   }
-  tuple->data_ = new char[tuple->size_];
-  memcpy(tuple->data_, GetData() + tuple_offset, tuple->size_);
+  memcpy(tuple->ResizeData(tuple_size), GetData() + GetTupleOffsetAtSlot(slot_num), tuple_size);
   tuple->rid_ = rid;
-  tuple->allocated_ = true;
   return true;
 }
 
-bool TablePage::GetFirstTupleRid(RID *first_rid) {
-  // Find and return the first valid tuple.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    if (GetTupleSize(i) > 0) {
-      first_rid->Set(GetTablePageId(), i);
+bool TablePage::GetTupleView(const RID &rid, const std::function<void(const Tuple &)> &consume, Transaction *txn,
+                             LockManager *lock_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    if (enable_logging && txn != nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+    }
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (IsDeleted(tuple_size)) {
+    if (enable_logging && txn != nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+    }
+    return false;
+  }
+
+  // Same lock discipline as GetTuple. A null lock manager means the caller holds a covering
+  // table-granularity lock.
+  if (enable_logging && txn != nullptr && lock_manager != nullptr) {
+    if (!txn->IsSharedLocked(rid) && !txn->IsExclusiveLocked(rid) && !lock_manager->LockShared(txn, rid)) {
+      return false;
+    }
+  }
+
+  // The view aliases page memory; allocated_ stays false so it never frees what it points at.
+  Tuple view;
+  view.size_ = tuple_size;
+  view.data_ = GetData() + GetTupleOffsetAtSlot(slot_num);
+  view.rid_ = rid;
+  consume(view);
+  view.data_ = nullptr;
+  return true;
+}
+
+bool TablePage::GetTuples(uint32_t slot_start, uint32_t slot_end, TupleBatch *batch) {
+  size_t before = batch->Size();
+  uint32_t tuple_count = GetTupleCount();
+  if (slot_end > tuple_count) {
+    slot_end = tuple_count;
+  }
+  page_id_t page_id = GetTablePageId();
+  // Bit-scan the live slots (occupied and not tombstoned) and copy only the survivors' bytes;
+  // a mostly-deleted page costs a few word reads instead of a walk of its slot directory.
+  const uint64_t *occupied = OccupiedBitmap();
+  const uint64_t *deleted = DeletedBitmap();
+  for (uint32_t word = slot_start >> 6; (word << 6) < slot_end; word++) {
+    uint64_t live = occupied[word] & ~deleted[word];
+    if (word == slot_start >> 6) {
+      live &= ~uint64_t{0} << (slot_start & 63);
+    }
+    while (live != 0) {
+      uint32_t slot_num = (word << 6) + static_cast<uint32_t>(__builtin_ctzll(live));
+      live &= live - 1;
+      if (slot_num >= slot_end) {
+        break;
+      }
+      batch->AddFromPage(RID(page_id, slot_num), GetData() + GetTupleOffsetAtSlot(slot_num), GetTupleSize(slot_num));
+    }
+  }
+  return batch->Size() > before;
+}
+
+bool TablePage::FindFirstMatch(uint32_t start_slot, const std::function<bool(const Tuple &)> &predicate, RID *rid,
+                               Tuple *tuple) {
+  // Survivor: copy it whole out of the page.
+  return FindFirstMatch(start_slot, predicate, rid, [tuple](const Tuple &view) {
+    memcpy(tuple->ResizeData(view.size_), view.data_, view.size_);
+    tuple->rid_ = view.rid_;
+  });
+}
+
+bool TablePage::FindFirstMatch(uint32_t start_slot, const std::function<bool(const Tuple &)> &predicate, RID *rid,
+                               const std::function<void(const Tuple &)> &consume) {
+  uint32_t tuple_count = GetTupleCount();
+  // The view aliases page memory; allocated_ stays false so it never frees what it points at.
+  Tuple view;
+  const uint64_t *occupied = OccupiedBitmap();
+  const uint64_t *deleted = DeletedBitmap();
+  // Bit-scan the live slots; tombstoned and empty slots never reach the predicate.
+  for (uint32_t word = start_slot >> 6; (word << 6) < tuple_count; word++) {
+    uint64_t live = occupied[word] & ~deleted[word];
+    if (word == start_slot >> 6) {
+      live &= ~uint64_t{0} << (start_slot & 63);
+    }
+    while (live != 0) {
+      uint32_t slot = (word << 6) + static_cast<uint32_t>(__builtin_ctzll(live));
+      live &= live - 1;
+      if (slot >= tuple_count) {
+        break;
+      }
+      view.rid_ = RID(GetTablePageId(), slot);
+      view.size_ = GetTupleSize(slot);
+      view.data_ = GetData() + GetTupleOffsetAtSlot(slot);
+      if (predicate != nullptr && !predicate(view)) {
+        continue;
+      }
+      consume(view);
+      *rid = view.rid_;
+      view.data_ = nullptr;
       return true;
     }
   }
+  view.data_ = nullptr;
+  return false;
+}
+
+uint32_t TablePage::VacuumSlots() {
+  uint32_t count = GetTupleCount();
+  const uint64_t *occupied = OccupiedBitmap();
+  uint32_t stored = 0;
+  // One pass over the bitmap words: population count for the stored total, and the highest
+  // set bit marks the new high-water count -- trailing empty slots rejoin the free space.
+  uint32_t trimmed = 0;
+  for (uint32_t word = 0; (word << 6) < count; word++) {
+    uint64_t bits = occupied[word];
+    stored += static_cast<uint32_t>(__builtin_popcountll(bits));
+    if (bits != 0) {
+      trimmed = (word << 6) + 64 - static_cast<uint32_t>(__builtin_clzll(bits));
+    }
+  }
+  SetTupleCount(trimmed);
+  return stored;
+}
+
+bool TablePage::GetTupleOptimistic(const RID &rid, Tuple *tuple) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (IsDeleted(tuple_size)) {
+    return false;
+  }
+  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
+  // A racing writer can make these torn; keep every access inside the page so a bad read is
+  // caught by version validation instead of crashing here.
+  if (tuple_size > PAGE_SIZE || tuple_offset > PAGE_SIZE || tuple_offset + tuple_size > PAGE_SIZE) {
+    return false;
+  }
+  memcpy(tuple->ResizeData(tuple_size), GetData() + tuple_offset, tuple_size);
+  tuple->rid_ = rid;
+  return true;
+}
+
+bool TablePage::FindNextSetSlot(const uint64_t *bitmap, uint32_t start_slot, uint32_t *slot_num) {
+  uint32_t count = GetTupleCount();
+  for (uint32_t word = start_slot >> 6; (word << 6) < count; word++) {
+    uint64_t bits = bitmap[word];
+    if (word == start_slot >> 6) {
+      bits &= ~uint64_t{0} << (start_slot & 63);
+    }
+    if (bits != 0) {
+      uint32_t slot = (word << 6) + static_cast<uint32_t>(__builtin_ctzll(bits));
+      if (slot >= count) {
+        return false;
+      }
+      *slot_num = slot;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TablePage::GetFirstTupleRid(RID *first_rid) {
+  // Find and return the first occupied slot (the rid walk yields tombstoned rows too; the
+  // per-rid read filters them, exactly as the slot-directory walk used to).
+  uint32_t slot;
+  if (FindNextSetSlot(OccupiedBitmap(), 0, &slot)) {
+    first_rid->Set(GetTablePageId(), slot);
+    return true;
+  }
   first_rid->Set(INVALID_PAGE_ID, 0);
   return false;
 }
 
 bool TablePage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) {
   BUSTUB_ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
-  // Find and return the first valid tuple after our current slot number.
-  for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); ++i) {
-    if (GetTupleSize(i) > 0) {
-      next_rid->Set(GetTablePageId(), i);
-      return true;
-    }
+  // One bit-scan resumes the walk after the current slot; no re-read of the slots before it.
+  uint32_t slot;
+  if (FindNextSetSlot(OccupiedBitmap(), cur_rid.GetSlotNum() + 1, &slot)) {
+    next_rid->Set(GetTablePageId(), slot);
+    return true;
   }
   // Otherwise return false as there are no more tuples.
   next_rid->Set(INVALID_PAGE_ID, 0);
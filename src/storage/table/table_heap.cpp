@@ -10,13 +10,24 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
+#include <utility>
+#include <vector>
 
 #include "common/logger.h"
+#include "concurrency/version_manager.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
+namespace {
+/** Optimistic read retries before falling back to the page read latch. */
+constexpr int OPTIMISTIC_READ_ATTEMPTS = 3;
+}  // namespace
+
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      page_id_t first_page_id)
     : buffer_pool_manager_(buffer_pool_manager),
@@ -28,47 +39,177 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
                      Transaction *txn)
     : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
   // Initialize the first table page.
-  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
+  auto first_page = reinterpret_cast<TablePage *>(AllocatePage(&first_page_id_));
   BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
   first_page->WLatch();
   first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
   first_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  UnpinHeapPage(first_page_id_, true);
+  page_directory_.push_back(first_page_id_);
+  page_count_ = 1;
+}
+
+TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
+                     Transaction *txn, const Schema *schema, TableLayout layout, bool compressed)
+    : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager),
+      layout_(layout), compressed_(compressed) {
+  if (layout_ == TableLayout::ROW) {
+    // Keeping the schema lets writes spot large varlen payloads and move them out of line.
+    schema_ = std::make_unique<Schema>(*schema);
+    toastable_ = schema_->GetUnlinedColumnCount() > 0;
+    auto first_page = reinterpret_cast<TablePage *>(AllocatePage(&first_page_id_));
+    BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
+    first_page->WLatch();
+    first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+    first_page->WUnlatch();
+    UnpinHeapPage(first_page_id_, true);
+    page_directory_.push_back(first_page_id_);
+    page_count_ = 1;
+    return;
+  }
+  BUSTUB_ASSERT(schema->GetUnlinedColumnCount() == 0, "The PAX layout supports fixed-length schemas only.");
+  // The pages only store bytes; the heap keeps the schema that addresses the minipages.
+  schema_ = std::make_unique<Schema>(*schema);
+  auto first_page = reinterpret_cast<PaxTablePage *>(AllocatePage(&first_page_id_));
+  BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
+  first_page->WLatch();
+  first_page->Init(first_page_id_, schema_.get(), INVALID_LSN, log_manager_, txn);
+  first_page->WUnlatch();
+  UnpinHeapPage(first_page_id_, true);
+  page_directory_.push_back(first_page_id_);
+  page_count_ = 1;
+}
+
+LockManager *TableHeap::RowLockManager(Transaction *txn, bool write) {
+  if (!enable_logging || txn == nullptr || lock_manager_ == nullptr) {
+    return lock_manager_;
+  }
+  RID table_rid(first_page_id_, LockManager::TABLE_LOCK_SLOT);
+  // A covering table lock (from an earlier escalation) makes row locks redundant.
+  if (txn->IsExclusiveLocked(table_rid) || (!write && txn->IsSharedLocked(table_rid))) {
+    return nullptr;
+  }
+  if (!lock_manager_->LockTableIntention(txn, first_page_id_, write)) {
+    // Aborted while waiting; let the row-level path fail the operation.
+    return lock_manager_;
+  }
+  if (lock_manager_->RecordRowLock(txn, first_page_id_) && lock_manager_->LockTable(txn, first_page_id_, write)) {
+    // Escalated: one table lock now covers every row this transaction touches here.
+    return nullptr;
+  }
+  return lock_manager_;
+}
+
+void TableHeap::InsertIndexEntries(const Tuple &tuple, RID rid, Transaction *txn) {
+  for (Index *index : indexes_) {
+    index->InsertEntry(tuple.KeyFromTuple(schema_.get(), index->GetKeySchema(), index->GetKeyAttrs()), rid, txn);
+  }
+}
+
+void TableHeap::DeleteIndexEntries(const Tuple &tuple, RID rid, Transaction *txn) {
+  for (Index *index : indexes_) {
+    index->DeleteEntry(tuple.KeyFromTuple(schema_.get(), index->GetKeySchema(), index->GetKeyAttrs()), rid, txn);
+  }
+}
+
+void TableHeap::WidenZoneMap(const Tuple &tuple, RID rid) {
+  if (zone_map_ != nullptr) {
+    zone_map_->Update(rid.GetPageId(), tuple, schema_.get());
+  }
 }
 
 bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
+  if (layout_ == TableLayout::PAX) {
+    if (!PaxInsertTuple(tuple, rid, txn)) {
+      return false;
+    }
+    InsertIndexEntries(tuple, *rid, txn);
+    WidenZoneMap(tuple, *rid);
+    return true;
+  }
+  // A big row gets its large varlen payloads moved into overflow chains first; the stub left
+  // behind is small, so rows larger than a page become storable and big blobs stop crowding
+  // their neighbors out of slot locality.
+  if (toastable_ && tuple.size_ + 32 > TOAST_THRESHOLD) {
+    Tuple stub = ToastTuple(tuple);
+    if (stub.size_ + 32 > PAGE_SIZE) {  // nothing left to move out of line and still too large
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    if (!RowInsertTuple(stub, tuple, rid, txn)) {
+      // The chains were written before the insert; don't orphan them on failure.
+      std::vector<page_id_t> chains;
+      CollectOverflowChains(stub, &chains);
+      for (page_id_t chain : chains) {
+        FreeOverflowChain(chain);
+      }
+      return false;
+    }
+    // Keys and zone ranges come from the original row, never the toasted stub.
+    InsertIndexEntries(tuple, *rid, txn);
+    WidenZoneMap(tuple, *rid);
+    return true;
+  }
   if (tuple.size_ + 32 > PAGE_SIZE) {  // larger than one page size
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  if (!RowInsertTuple(tuple, tuple, rid, txn)) {
+    return false;
+  }
+  InsertIndexEntries(tuple, *rid, txn);
+  WidenZoneMap(tuple, *rid);
+  return true;
+}
+
+void TableHeap::SetFillFactor(double fill_factor) {
+  fill_factor = std::max(0.5, std::min(1.0, fill_factor));
+  insert_reserved_ = static_cast<uint32_t>(PAGE_SIZE * (1.0 - fill_factor));
+}
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+bool TableHeap::RowInsertTuple(const Tuple &stored, const Tuple &original, RID *rid, Transaction *txn) {
+  // A tuple that cannot fit alongside the headroom ignores it rather than loop forever on
+  // freshly created pages it can never fill.
+  uint32_t reserved = insert_reserved_;
+  if (stored.size_ + 32 + reserved > PAGE_SIZE) {
+    reserved = 0;
+  }
+  // Ask the free space map for a page that fits, so a hot heap places the row without walking
+  // the chain at all. A cold or stale map falls through to the walk from the front below.
+  page_id_t start_page_id = GetInsertCandidate(stored.size_ + 32 + reserved);
+  if (start_page_id == INVALID_PAGE_ID) {
+    start_page_id = first_page_id_;
+  }
+  auto cur_page = static_cast<TablePage *>(FetchHeapPage(start_page_id));
   if (cur_page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
+  LockManager *row_lock_manager = RowLockManager(txn, true);
   cur_page->WLatch();
   // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
   // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
+  while (!cur_page->InsertTuple(stored, rid, txn, row_lock_manager, log_manager_, reserved)) {
+    // Every full page probed refreshes its map entry, so later inserts skip it outright.
+    UpdateFreeSpaceMap(cur_page->GetTablePageId(), cur_page->GetFreeSpaceRemaining());
     auto next_page_id = cur_page->GetNextPageId();
     // If the next page is a valid page,
     if (next_page_id != INVALID_PAGE_ID) {
       // Unlatch and unpin the current page.
       cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+      UnpinHeapPage(cur_page->GetTablePageId(), false);
       // And repeat the process with the next page.
-      cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+      cur_page = static_cast<TablePage *>(FetchHeapPage(next_page_id));
       cur_page->WLatch();
     } else {
       // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
+      auto new_page = static_cast<TablePage *>(AllocatePage(&next_page_id));
       // If we could not create a new page,
       if (new_page == nullptr) {
         // Then life sucks and we abort the transaction.
         cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+        UnpinHeapPage(cur_page->GetTablePageId(), false);
         txn->SetState(TransactionState::ABORTED);
         return false;
       }
@@ -76,108 +217,1170 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
       new_page->Init(next_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      RecordAppendedPage(next_page_id);
       cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+      UnpinHeapPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
     }
   }
+  // Refresh the page's fill level while it is still latched.
+  UpdateFreeSpaceMap(cur_page->GetTablePageId(), cur_page->GetFreeSpaceRemaining());
+  // Record the insert for snapshot readers while the page is still latched. The chain keeps
+  // the original, untoasted row, so snapshot reads never chase overflow pages.
+  if (enable_logging && txn != nullptr) {
+    VersionManager::Instance().OnInsert(*rid, original, txn);
+  }
   // This line has caused most of us to double-take and "whoa double unlatch".
   // We are not, in fact, double unlatching. See the invariant above.
   cur_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+  UnpinHeapPage(cur_page->GetTablePageId(), true);
   // Update the transaction's write set.
   txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
   return true;
 }
 
+bool TableHeap::PaxInsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
+  auto cur_page = static_cast<PaxTablePage *>(FetchHeapPage(first_page_id_));
+  if (cur_page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+
+  const Schema *schema = schema_.get();
+  LockManager *row_lock_manager = RowLockManager(txn, true);
+  cur_page->WLatch();
+  // Insert into the first page with a free slot; extend the chain when every page is full.
+  // INVARIANT: cur_page is WLatched if you leave the loop normally.
+  while (!cur_page->InsertTuple(schema, tuple, rid, txn, row_lock_manager, log_manager_)) {
+    auto next_page_id = cur_page->GetNextPageId();
+    if (next_page_id != INVALID_PAGE_ID) {
+      cur_page->WUnlatch();
+      UnpinHeapPage(cur_page->GetTablePageId(), false);
+      cur_page = static_cast<PaxTablePage *>(FetchHeapPage(next_page_id));
+      cur_page->WLatch();
+    } else {
+      auto new_page = static_cast<PaxTablePage *>(AllocatePage(&next_page_id));
+      if (new_page == nullptr) {
+        cur_page->WUnlatch();
+        UnpinHeapPage(cur_page->GetTablePageId(), false);
+        txn->SetState(TransactionState::ABORTED);
+        return false;
+      }
+      new_page->WLatch();
+      cur_page->SetNextPageId(next_page_id);
+      new_page->Init(next_page_id, schema, cur_page->GetTablePageId(), log_manager_, txn);
+      RecordAppendedPage(next_page_id);
+      cur_page->WUnlatch();
+      UnpinHeapPage(cur_page->GetTablePageId(), true);
+      cur_page = new_page;
+    }
+  }
+  // Record the insert for snapshot readers while the page is still latched.
+  if (enable_logging && txn != nullptr) {
+    VersionManager::Instance().OnInsert(*rid, tuple, txn);
+  }
+  cur_page->WUnlatch();
+  UnpinHeapPage(cur_page->GetTablePageId(), true);
+  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+  return true;
+}
+
+bool TableHeap::InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) {
+  // A PAX insert scatters into several minipages, so there is no latched fast path to batch; the
+  // one-row path still reuses the tail page from the buffer pool on every call.
+  if (layout_ == TableLayout::PAX) {
+    for (const auto &tuple : tuples) {
+      RID rid;
+      if (!InsertTuple(tuple, &rid, txn)) {
+        return false;
+      }
+      rids->push_back(rid);
+    }
+    return true;
+  }
+  const size_t first_rid = rids->size();
+  rids->reserve(rids->size() + tuples.size());
+  // Toast big rows before anything is latched; the batch loop below then only ever sees stubs.
+  // The copy of the batch is made only when at least one row actually toasts.
+  const std::vector<Tuple> *stored = &tuples;
+  std::vector<Tuple> toasted;
+  if (toastable_) {
+    for (size_t i = 0; i < tuples.size(); i++) {
+      if (tuples[i].size_ + 32 > TOAST_THRESHOLD) {
+        if (toasted.empty()) {
+          toasted = tuples;
+          stored = &toasted;
+        }
+        toasted[i] = ToastTuple(tuples[i]);
+      }
+    }
+  }
+  // Reject oversized tuples up front so we never abort with half the batch inserted.
+  for (const auto &tuple : *stored) {
+    if (tuple.size_ + 32 > PAGE_SIZE) {  // larger than one page size
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+  }
+
+  // Start the batch on a page the free space map says fits the first row; the walk below still
+  // extends the chain as the batch outgrows it.
+  page_id_t start_page_id =
+      stored->empty() ? INVALID_PAGE_ID : GetInsertCandidate(stored->front().size_ + 32 + insert_reserved_);
+  if (start_page_id == INVALID_PAGE_ID) {
+    start_page_id = first_page_id_;
+  }
+  auto cur_page = static_cast<TablePage *>(FetchHeapPage(start_page_id));
+  if (cur_page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+
+  LockManager *row_lock_manager = RowLockManager(txn, true);
+  cur_page->WLatch();
+  // INVARIANT: between iterations cur_page is WLatched and cur_page_dirty says whether this
+  // batch has written to it. The page is only unlatched and unpinned when it runs out of space,
+  // so consecutive inserts into the same page pay the fetch and latch once.
+  bool cur_page_dirty = false;
+  // Logging is deferred the same way: the rows inserted into the current page accumulate here
+  // and one physiological INSERTBATCH record covers the run when the batch leaves the page, so
+  // a full page costs one staging call instead of one per row.
+  std::vector<RID> logged_rids;
+  std::vector<const Tuple *> logged_rows;
+  auto flush_log = [&](TablePage *page) {
+    if (enable_logging && !logged_rids.empty()) {
+      page->LogInsertBatch(logged_rids, logged_rows, txn, log_manager_);
+      logged_rids.clear();
+      logged_rows.clear();
+    }
+  };
+  for (size_t i = 0; i < stored->size(); i++) {
+    const Tuple &tuple = (*stored)[i];
+    // Same headroom escape hatch as the one-row path.
+    uint32_t reserved = insert_reserved_;
+    if (tuple.size_ + 32 + reserved > PAGE_SIZE) {
+      reserved = 0;
+    }
+    RID rid;
+    while (!cur_page->InsertTuple(tuple, &rid, txn, row_lock_manager, log_manager_, reserved, true)) {
+      UpdateFreeSpaceMap(cur_page->GetTablePageId(), cur_page->GetFreeSpaceRemaining());
+      flush_log(cur_page);
+      auto next_page_id = cur_page->GetNextPageId();
+      if (next_page_id != INVALID_PAGE_ID) {
+        cur_page->WUnlatch();
+        UnpinHeapPage(cur_page->GetTablePageId(), cur_page_dirty);
+        cur_page = static_cast<TablePage *>(FetchHeapPage(next_page_id));
+        cur_page->WLatch();
+        cur_page_dirty = false;
+      } else {
+        auto new_page = static_cast<TablePage *>(AllocatePage(&next_page_id));
+        if (new_page == nullptr) {
+          cur_page->WUnlatch();
+          UnpinHeapPage(cur_page->GetTablePageId(), cur_page_dirty);
+          txn->SetState(TransactionState::ABORTED);
+          return false;
+        }
+        new_page->WLatch();
+        cur_page->SetNextPageId(next_page_id);
+        new_page->Init(next_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+        RecordAppendedPage(next_page_id);
+        cur_page->WUnlatch();
+        UnpinHeapPage(cur_page->GetTablePageId(), true);
+        cur_page = new_page;
+        cur_page_dirty = false;
+      }
+    }
+    cur_page_dirty = true;
+    if (enable_logging) {
+      logged_rids.push_back(rid);
+      logged_rows.push_back(&tuple);
+    }
+    // The version chain keeps the original, untoasted row, as in the one-row path.
+    if (enable_logging && txn != nullptr) {
+      VersionManager::Instance().OnInsert(rid, tuples[i], txn);
+    }
+    rids->push_back(rid);
+    txn->GetWriteSet()->emplace_back(rid, WType::INSERT, Tuple{}, this);
+  }
+  // One refresh for the last page covers the whole batch; the exhausted pages refreshed above.
+  UpdateFreeSpaceMap(cur_page->GetTablePageId(), cur_page->GetFreeSpaceRemaining());
+  flush_log(cur_page);
+  cur_page->WUnlatch();
+  UnpinHeapPage(cur_page->GetTablePageId(), cur_page_dirty);
+  // Index entries and zone ranges go in after the page latch is dropped; keys and ranges
+  // come from the original rows.
+  if (!indexes_.empty() || zone_map_ != nullptr) {
+    for (size_t i = 0; i < tuples.size(); i++) {
+      InsertIndexEntries(tuples[i], (*rids)[first_rid + i], txn);
+      WidenZoneMap(tuples[i], (*rids)[first_rid + i]);
+    }
+  }
+  return true;
+}
+
 bool TableHeap::MarkDelete(const RID &rid, Transaction *txn) {
   // TODO(Amadou): remove empty page
+  if (layout_ == TableLayout::PAX) {
+    auto page = reinterpret_cast<PaxTablePage *>(FetchHeapPage(rid.GetPageId()));
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    LockManager *row_lock_manager = RowLockManager(txn, true);
+    page->WLatch();
+    // Save the pre-image so snapshot readers can still see the row until we commit. Index
+    // maintenance needs it too: the entries come out now, while the row is still readable,
+    // and go back in if the delete rolls back.
+    Tuple old_tuple;
+    bool had_tuple = (enable_logging || !indexes_.empty()) && txn != nullptr &&
+                     page->GetTuple(schema_.get(), rid, &old_tuple, txn, nullptr);
+    page->MarkDelete(rid, txn, row_lock_manager, log_manager_);
+    if (had_tuple && enable_logging && txn != nullptr && txn->GetState() != TransactionState::ABORTED) {
+      VersionManager::Instance().OnWrite(rid, old_tuple, Tuple{}, true, txn);
+    }
+    page->WUnlatch();
+    UnpinHeapPage(page->GetTablePageId(), true);
+    if (had_tuple && txn->GetState() != TransactionState::ABORTED) {
+      DeleteIndexEntries(old_tuple, rid, txn);
+    }
+    txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
+    return true;
+  }
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = reinterpret_cast<TablePage *>(FetchHeapPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // Otherwise, mark the tuple as deleted.
+  LockManager *row_lock_manager = RowLockManager(txn, true);
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  // Save the pre-image so snapshot readers can still see the row until we commit. Index
+  // maintenance needs it too: the entries come out now, while the row is still readable,
+  // and go back in if the delete rolls back.
+  Tuple old_tuple;
+  bool had_tuple =
+      (enable_logging || !indexes_.empty()) && txn != nullptr && page->GetTuple(rid, &old_tuple, txn, nullptr);
+  // The version chain must outlive the row's overflow chains (freed when the delete applies),
+  // so it gets the full payloads, not the stub.
+  if (had_tuple && toastable_ && IsToasted(old_tuple, schema_.get())) {
+    DetoastTuple(&old_tuple);
+  }
+  page->MarkDelete(rid, txn, row_lock_manager, log_manager_);
+  if (had_tuple && enable_logging && txn->GetState() != TransactionState::ABORTED) {
+    VersionManager::Instance().OnWrite(rid, old_tuple, Tuple{}, true, txn);
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  UnpinHeapPage(page->GetTablePageId(), true);
+  if (had_tuple && txn->GetState() != TransactionState::ABORTED) {
+    DeleteIndexEntries(old_tuple, rid, txn);
+  }
   // Update the transaction's write set.
   txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
   return true;
 }
 
 bool TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) {
+  if (layout_ == TableLayout::PAX) {
+    auto page = reinterpret_cast<PaxTablePage *>(FetchHeapPage(rid.GetPageId()));
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    Tuple old_tuple;
+    LockManager *row_lock_manager = RowLockManager(txn, true);
+    page->WLatch();
+    bool is_updated = page->UpdateTuple(schema_.get(), tuple, &old_tuple, rid, txn, row_lock_manager, log_manager_);
+    if (is_updated && enable_logging && txn != nullptr && txn->GetState() != TransactionState::ABORTED) {
+      VersionManager::Instance().OnWrite(rid, old_tuple, tuple, false, txn);
+    }
+    page->WUnlatch();
+    UnpinHeapPage(page->GetTablePageId(), is_updated);
+    if (is_updated && txn->GetState() != TransactionState::ABORTED) {
+      txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, old_tuple, this);
+    }
+    if (is_updated) {
+      // Move the row's index entries from the old key to the new one; the RID is unchanged.
+      DeleteIndexEntries(old_tuple, rid, txn);
+      InsertIndexEntries(tuple, rid, txn);
+      WidenZoneMap(tuple, rid);
+    }
+    return is_updated;
+  }
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = reinterpret_cast<TablePage *>(FetchHeapPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  // A big new value toasts exactly as it would on insert.
+  const Tuple *new_stored = &tuple;
+  Tuple new_stub;
+  if (toastable_ && tuple.size_ + 32 > TOAST_THRESHOLD) {
+    new_stub = ToastTuple(tuple);
+    new_stored = &new_stub;
+  }
   // Update the tuple; but first save the old value for rollbacks.
   Tuple old_tuple;
+  LockManager *row_lock_manager = RowLockManager(txn, true);
   page->WLatch();
-  bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  bool is_updated = page->UpdateTuple(*new_stored, &old_tuple, rid, txn, row_lock_manager, log_manager_);
+  // Undo and the version chain need the old row's full payloads: its overflow chains are freed
+  // below, and a rollback re-toasts the restored value on its own.
+  std::vector<page_id_t> old_chains;
+  if (is_updated && toastable_ && IsToasted(old_tuple, schema_.get())) {
+    CollectOverflowChains(old_tuple, &old_chains);
+    DetoastTuple(&old_tuple);
+  }
+  if (is_updated && enable_logging && txn != nullptr && txn->GetState() != TransactionState::ABORTED) {
+    VersionManager::Instance().OnWrite(rid, old_tuple, tuple, false, txn);
+  }
+  if (is_updated) {
+    // A shrinking update frees space; keep the free space map current while still latched.
+    UpdateFreeSpaceMap(page->GetTablePageId(), page->GetFreeSpaceRemaining());
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
+  UnpinHeapPage(page->GetTablePageId(), is_updated);
+  for (page_id_t chain : old_chains) {
+    FreeOverflowChain(chain);
+  }
   // Update the transaction's write set.
   if (is_updated && txn->GetState() != TransactionState::ABORTED) {
     txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, old_tuple, this);
   }
+  if (is_updated) {
+    // Move the row's index entries from the old key to the new one; the RID is unchanged.
+    // old_tuple was detoasted above, so keys over varlen columns see the real payloads.
+    DeleteIndexEntries(old_tuple, rid, txn);
+    InsertIndexEntries(tuple, rid, txn);
+    WidenZoneMap(tuple, rid);
+  }
   return is_updated;
 }
 
 void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
+  if (layout_ == TableLayout::PAX) {
+    auto page = reinterpret_cast<PaxTablePage *>(FetchHeapPage(rid.GetPageId()));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+    page->WLatch();
+    // A live slot here means an insert being rolled back, whose index entries must come out;
+    // a committed delete's entries already came out at MarkDelete. The probe finding the slot
+    // tombstoned is expected, so it must not leave the transaction aborted.
+    Tuple old_tuple;
+    bool was_live = false;
+    if (!indexes_.empty() && txn != nullptr) {
+      TransactionState prev_state = txn->GetState();
+      was_live = page->GetTuple(schema_.get(), rid, &old_tuple, txn, nullptr);
+      if (!was_live) {
+        txn->SetState(prev_state);
+      }
+    }
+    page->ApplyDelete(schema_.get(), rid, txn, log_manager_);
+    if (lock_manager_ != nullptr) {
+      lock_manager_->Unlock(txn, rid);
+    }
+    page->WUnlatch();
+    UnpinHeapPage(page->GetTablePageId(), true);
+    if (was_live) {
+      DeleteIndexEntries(old_tuple, rid, txn);
+    }
+    return;
+  }
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = reinterpret_cast<TablePage *>(FetchHeapPage(rid.GetPageId()));
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Delete the tuple from the page.
   page->WLatch();
+  // The slot may already be tombstoned, so read the stored bytes raw to find the row's
+  // overflow chains before they become unreachable.
+  std::vector<page_id_t> chains;
+  if (toastable_) {
+    Tuple raw;
+    if (page->GetTupleRaw(rid, &raw) && IsToasted(raw, schema_.get())) {
+      CollectOverflowChains(raw, &chains);
+    }
+  }
+  // A live slot here means an insert being rolled back, whose index entries must come out;
+  // a committed delete's entries already came out at MarkDelete. The probe finding the slot
+  // tombstoned is expected, so it must not leave the transaction aborted.
+  Tuple old_tuple;
+  bool was_live = false;
+  if (!indexes_.empty() && txn != nullptr) {
+    TransactionState prev_state = txn->GetState();
+    was_live = page->GetTuple(rid, &old_tuple, txn, nullptr);
+    if (!was_live) {
+      txn->SetState(prev_state);
+    }
+  }
+  if (was_live && toastable_ && IsToasted(old_tuple, schema_.get())) {
+    DetoastTuple(&old_tuple);
+  }
   page->ApplyDelete(rid, txn, log_manager_);
-  lock_manager_->Unlock(txn, rid);
+  // The reclaimed space makes this page an insert candidate again.
+  UpdateFreeSpaceMap(page->GetTablePageId(), page->GetFreeSpaceRemaining());
+  if (lock_manager_ != nullptr) {
+    lock_manager_->Unlock(txn, rid);
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  UnpinHeapPage(page->GetTablePageId(), true);
+  if (was_live) {
+    DeleteIndexEntries(old_tuple, rid, txn);
+  }
+  // The row is gone from the page; its out-of-line payloads go with it.
+  for (page_id_t chain : chains) {
+    FreeOverflowChain(chain);
+  }
 }
 
 void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
+  if (layout_ == TableLayout::PAX) {
+    auto page = reinterpret_cast<PaxTablePage *>(FetchHeapPage(rid.GetPageId()));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+    page->WLatch();
+    page->RollbackDelete(rid, txn, log_manager_);
+    // The row is live again; its index entries, removed at MarkDelete, go back in.
+    Tuple restored;
+    bool have_restored =
+        !indexes_.empty() && txn != nullptr && page->GetTuple(schema_.get(), rid, &restored, txn, nullptr);
+    page->WUnlatch();
+    UnpinHeapPage(page->GetTablePageId(), true);
+    if (have_restored) {
+      InsertIndexEntries(restored, rid, txn);
+    }
+    return;
+  }
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = reinterpret_cast<TablePage *>(FetchHeapPage(rid.GetPageId()));
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Rollback the delete.
   page->WLatch();
   page->RollbackDelete(rid, txn, log_manager_);
+  // The row is live again; its index entries, removed at MarkDelete, go back in.
+  Tuple restored;
+  bool have_restored = !indexes_.empty() && txn != nullptr && page->GetTuple(rid, &restored, txn, nullptr);
+  if (have_restored && toastable_ && IsToasted(restored, schema_.get())) {
+    DetoastTuple(&restored);
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  UnpinHeapPage(page->GetTablePageId(), true);
+  if (have_restored) {
+    InsertIndexEntries(restored, rid, txn);
+  }
+}
+
+bool TableHeap::GetTupleView(const RID &rid, Transaction *txn, const std::function<void(const Tuple &)> &consume) {
+  auto page = FetchHeapPage(rid.GetPageId());
+  if (page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  LockManager *row_lock_manager = RowLockManager(txn, false);
+  bool res;
+  if (layout_ == TableLayout::PAX) {
+    auto pax_page = static_cast<PaxTablePage *>(page);
+    pax_page->RLatch();
+    res = pax_page->GetTupleView(schema_.get(), rid, consume, txn, row_lock_manager);
+    pax_page->RUnlatch();
+    UnpinHeapPage(rid.GetPageId(), false);
+    return res;
+  }
+  auto table_page = static_cast<TablePage *>(page);
+  table_page->RLatch();
+  // A toasted row cannot be consumed in the page: its big payloads live in overflow chains,
+  // which must not be fetched under the page latch a view is pinned by. Copy the stub out and
+  // hand the consumer the reassembled row once the latch is dropped.
+  Tuple stub;
+  bool detoast = false;
+  if (toastable_) {
+    res = table_page->GetTupleView(
+        rid,
+        [&](const Tuple &view) {
+          if (IsToasted(view, schema_.get())) {
+            memcpy(stub.ResizeData(view.size_), view.data_, view.size_);
+            stub.rid_ = rid;
+            detoast = true;
+            return;
+          }
+          consume(view);
+        },
+        txn, row_lock_manager);
+  } else {
+    res = table_page->GetTupleView(rid, consume, txn, row_lock_manager);
+  }
+  table_page->RUnlatch();
+  UnpinHeapPage(rid.GetPageId(), false);
+  if (detoast) {
+    DetoastTuple(&stub);
+    consume(stub);
+  }
+  return res;
+}
+
+namespace {
+/** Appends one stored row to the column buffers; see ColumnarBuffer for the layout produced. */
+void TransposeRow(const Schema *schema, const char *data, uint32_t size, size_t row_idx,
+                  std::vector<ColumnarBuffer> *columns) {
+  const uint32_t column_count = schema->GetColumnCount();
+  const char *bitmap = data + size - Tuple::NullBitmapSize(schema);
+  for (uint32_t i = 0; i < column_count; i++) {
+    ColumnarBuffer &col = (*columns)[i];
+    const bool is_null = (bitmap[i / 8] & (1U << (i % 8))) != 0;
+    if (row_idx % 8 == 0) {
+      col.validity_.push_back(0);
+    }
+    if (!is_null) {
+      col.validity_.back() |= static_cast<uint8_t>(1U << (row_idx % 8));
+    }
+    const auto &column = schema->GetColumn(i);
+    if (column.IsInlined()) {
+      // Fixed-width slots copy unconditionally (a null slot holds the stored sentinel), so
+      // every row lands at row_idx * fixed_length and the array stays positional.
+      const char *src = data + column.GetOffset();
+      col.values_.insert(col.values_.end(), src, src + column.GetFixedLength());
+      continue;
+    }
+    uint32_t length = 0;
+    if (!is_null) {
+      uint32_t payload = *reinterpret_cast<const uint32_t *>(data + column.GetOffset());
+      length = *reinterpret_cast<const uint32_t *>(data + payload);
+      const char *src = data + payload + sizeof(uint32_t);
+      // The Value layer stores varchars with their terminating NUL; the export carries the
+      // characters only, as a consumer indexing by offsets expects.
+      if (length > 0 && src[length - 1] == '\0') {
+        length--;
+      }
+      col.values_.insert(col.values_.end(), src, src + length);
+    }
+    col.offsets_.push_back(col.offsets_.back() + length);
+  }
+}
+}  // namespace
+
+size_t TableHeap::ExportColumnar(const Schema *schema,
+                                 const std::function<void(std::vector<ColumnarBuffer> &, size_t)> &consume) {
+  std::vector<ColumnarBuffer> columns(schema->GetColumnCount());
+  std::vector<Tuple> pax_rows;
+  TupleBatch batch;
+  size_t total_rows = 0;
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    // Reset the buffers for this page, keeping their allocations across pages.
+    for (ColumnarBuffer &col : columns) {
+      col.validity_.clear();
+      col.values_.clear();
+      col.offsets_.assign(1, 0);
+    }
+    size_t num_rows = 0;
+    page_id_t next_page_id;
+    if (layout_ == TableLayout::PAX) {
+      auto page = static_cast<PaxTablePage *>(FetchHeapPage(page_id));
+      if (page == nullptr) {
+        break;
+      }
+      page->RLatch();
+      next_page_id = page->GetNextPageId();
+      // Read ahead: overlap the fetch of the next page with transposing this one.
+      if (next_page_id != INVALID_PAGE_ID && !IsPinnedPage(next_page_id)) {
+        buffer_pool_manager_->PrefetchPage(next_page_id);
+      }
+      // Gather the live rows under the latch; the transposition runs after it drops.
+      pax_rows.clear();
+      RID rid;
+      if (page->GetFirstTupleRid(&rid)) {
+        RID next;
+        do {
+          Tuple row;
+          // The rid walk only yields live slots and the page is latched, so the null
+          // transaction is never consulted.
+          if (page->GetTuple(schema, rid, &row, nullptr, nullptr)) {
+            pax_rows.push_back(std::move(row));
+          }
+          if (!page->GetNextTupleRid(rid, &next)) {
+            break;
+          }
+          rid = next;
+        } while (true);
+      }
+      page->RUnlatch();
+      UnpinHeapPage(page_id, false);
+      for (const Tuple &row : pax_rows) {
+        TransposeRow(schema, row.GetData(), row.GetLength(), num_rows, &columns);
+        num_rows++;
+      }
+    } else {
+      auto page = static_cast<TablePage *>(FetchHeapPage(page_id));
+      if (page == nullptr) {
+        break;
+      }
+      page->RLatch();
+      next_page_id = page->GetNextPageId();
+      // Read ahead: overlap the fetch of the next page with transposing this one.
+      if (next_page_id != INVALID_PAGE_ID && !IsPinnedPage(next_page_id)) {
+        buffer_pool_manager_->PrefetchPage(next_page_id);
+      }
+      // One latched pass copies the page's live rows raw; the transposition runs after it drops.
+      batch.Clear();
+      page->GetTuples(0, std::numeric_limits<uint32_t>::max(), &batch);
+      page->RUnlatch();
+      UnpinHeapPage(page_id, false);
+      for (const Tuple &row : batch) {
+        TransposeRow(schema, row.GetData(), row.GetLength(), num_rows, &columns);
+        num_rows++;
+      }
+    }
+    if (num_rows > 0) {
+      consume(columns, num_rows);
+      total_rows += num_rows;
+    }
+    page_id = next_page_id;
+  }
+  return total_rows;
 }
 
 bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
+  if (!GetTupleInternal(rid, tuple, txn)) {
+    return false;
+  }
+  // The stored row may carry overflow pointer entries; readers always get the full payloads.
+  if (toastable_ && IsToasted(*tuple, schema_.get())) {
+    DetoastTuple(tuple);
+  }
+  return true;
+}
+
+bool TableHeap::GetTupleInternal(const RID &rid, Tuple *tuple, Transaction *txn) {
+  if (layout_ == TableLayout::PAX) {
+    auto pax_page = static_cast<PaxTablePage *>(FetchHeapPage(rid.GetPageId()));
+    if (pax_page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    // PAX reads take the plain latched path; the optimistic and snapshot shortcuts below are
+    // row-layout-only for now.
+    LockManager *row_lock_manager = RowLockManager(txn, false);
+    pax_page->RLatch();
+    bool res = pax_page->GetTuple(schema_.get(), rid, tuple, txn, row_lock_manager);
+    pax_page->RUnlatch();
+    UnpinHeapPage(rid.GetPageId(), false);
+    return res;
+  }
   // Find the page which contains the tuple.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = static_cast<TablePage *>(FetchHeapPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  // A read-only transaction resolves the read against its snapshot and never takes row locks.
+  if (enable_logging && txn != nullptr && txn->IsReadOnly()) {
+    // A snapshot read has no lock side effects, so try a latch-free copy first and only fall
+    // back to the read latch when a writer keeps invalidating the page version.
+    for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; attempt++) {
+      uint64_t version = page->BeginOptimisticRead();
+      if ((version & 1) != 0) {
+        break;
+      }
+      auto lookup = VersionManager::Instance().GetVisible(rid, txn->GetReadTs(), tuple);
+      bool res = lookup == VersionManager::Lookup::FOUND ||
+                 (lookup == VersionManager::Lookup::NO_CHAIN && page->GetTupleOptimistic(rid, tuple));
+      if (page->ValidateOptimisticRead(version)) {
+        UnpinHeapPage(rid.GetPageId(), false);
+        return res;
+      }
+    }
+    page->RLatch();
+    auto lookup = VersionManager::Instance().GetVisible(rid, txn->GetReadTs(), tuple);
+    bool res = lookup == VersionManager::Lookup::FOUND ||
+               (lookup == VersionManager::Lookup::NO_CHAIN && page->GetTuple(rid, tuple, txn, nullptr));
+    page->RUnlatch();
+    UnpinHeapPage(rid.GetPageId(), false);
+    return res;
+  }
+  LockManager *row_lock_manager = RowLockManager(txn, false);
+  if (!enable_logging || row_lock_manager == nullptr) {
+    // No row lock will be taken, so the latched read has no side effects an optimistic copy
+    // would miss; validate the page version instead of hitting the latch cache line.
+    for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; attempt++) {
+      uint64_t version = page->BeginOptimisticRead();
+      if ((version & 1) != 0) {
+        break;
+      }
+      bool res = page->GetTupleOptimistic(rid, tuple);
+      if (page->ValidateOptimisticRead(version)) {
+        if (!res && enable_logging) {
+          txn->SetState(TransactionState::ABORTED);
+        }
+        UnpinHeapPage(rid.GetPageId(), false);
+        return res;
+      }
+    }
+  }
   // Read the tuple from the page.
   page->RLatch();
-  bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
+  bool res = page->GetTuple(rid, tuple, txn, row_lock_manager);
   page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+  UnpinHeapPage(rid.GetPageId(), false);
   return res;
 }
 
+void TableHeap::UpdateFreeSpaceMap(page_id_t page_id, uint32_t free_bytes) {
+  if (layout_ != TableLayout::ROW) {
+    return;
+  }
+  size_t category = static_cast<size_t>(free_bytes) * FSM_CATEGORIES / PAGE_SIZE;
+  std::lock_guard<std::mutex> guard(fsm_latch_);
+  auto it = fsm_category_.find(page_id);
+  if (it != fsm_category_.end() && it->second == category) {
+    return;  // the existing bucket entry is still accurate
+  }
+  fsm_category_[page_id] = category;
+  // The entry left in the old bucket goes stale; GetInsertCandidate drops it when popped.
+  fsm_buckets_[category].push_back(page_id);
+}
+
+void TableHeap::EraseFromFreeSpaceMap(page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(fsm_latch_);
+  // Bucket entries left behind are recognized as stale and dropped when popped.
+  fsm_category_.erase(page_id);
+}
+
+page_id_t TableHeap::GetInsertCandidate(uint32_t size) {
+  if (layout_ != TableLayout::ROW) {
+    return INVALID_PAGE_ID;
+  }
+  // A page only guarantees the floor of its category, so round the request up a category.
+  size_t needed = static_cast<size_t>(size) * FSM_CATEGORIES / PAGE_SIZE + 1;
+  std::lock_guard<std::mutex> guard(fsm_latch_);
+  for (size_t category = needed; category < FSM_CATEGORIES; category++) {
+    auto &bucket = fsm_buckets_[category];
+    while (!bucket.empty()) {
+      page_id_t page_id = bucket.back();
+      auto it = fsm_category_.find(page_id);
+      if (it == fsm_category_.end() || it->second != category) {
+        bucket.pop_back();  // stale: the page changed category or was freed
+        continue;
+      }
+      return page_id;
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+Page *TableHeap::AllocatePage(page_id_t *page_id) {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page != nullptr && compressed_) {
+    // Marked before the page's first flush, so every on-disk image of it is compressed.
+    buffer_pool_manager_->MarkPageCompressed(*page_id);
+  }
+  return page;
+}
+
+void TableHeap::RecordAppendedPage(page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(directory_latch_);
+  // An opened heap builds its directory lazily; until then there is nothing to maintain.
+  if (page_directory_.empty()) {
+    return;
+  }
+  if (page_count_ % DIRECTORY_INTERVAL == 0) {
+    page_directory_.push_back(page_id);
+  }
+  page_count_++;
+}
+
+std::vector<page_id_t> TableHeap::GetPageDirectory() {
+  std::lock_guard<std::mutex> guard(directory_latch_);
+  if (page_directory_.empty()) {
+    // A heap opened by page id pays the chain walk once, here, instead of on every scan.
+    for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+      auto page = static_cast<TablePage *>(FetchHeapPage(page_id));
+      if (page == nullptr) {
+        break;
+      }
+      page->RLatch();
+      page_id_t next_page_id = page->GetNextPageId();
+      page->RUnlatch();
+      UnpinHeapPage(page_id, false);
+      if (page_count_ % DIRECTORY_INTERVAL == 0) {
+        page_directory_.push_back(page_id);
+      }
+      page_count_++;
+      page_id = next_page_id;
+    }
+  }
+  return page_directory_;
+}
+
+size_t TableHeap::PinForLifetime() {
+  // Walk the chain and fetch every page without unpinning it; the pins never drop, so the
+  // frames can never be victimized and their pointers stay valid for the heap's lifetime.
+  // Both layouts keep the chain link at the same header offset, so TablePage reads it for both.
+  std::vector<std::pair<page_id_t, Page *>> pinned;
+  page_id_t max_page_id = first_page_id_;
+  for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      // The pool cannot hold the whole chain; a half-pinned table helps nobody, so undo.
+      for (const auto &[id, _] : pinned) {
+        buffer_pool_manager_->UnpinPage(id, false);
+      }
+      return 0;
+    }
+    pinned.emplace_back(page_id, page);
+    max_page_id = std::max(max_page_id, page_id);
+    page->RLatch();
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    page_id = next_page_id;
+  }
+  // Publish the direct array last, once every page is pinned. Gaps stay nullptr and keep
+  // routing through the buffer pool.
+  pinned_pages_.assign(max_page_id + 1, nullptr);
+  for (const auto &[id, page] : pinned) {
+    pinned_pages_[id] = page;
+  }
+  return pinned.size();
+}
+
+size_t TableHeap::Vacuum() {
+  // Both layouts keep the chain links and the high-water count at the same header offsets, so
+  // the walk runs over TablePage pointers and only the slot sweep dispatches on the layout.
+  auto vacuum_slots = [this](TablePage *page) {
+    if (layout_ == TableLayout::PAX) {
+      return reinterpret_cast<PaxTablePage *>(page)->VacuumSlots();
+    }
+    return page->VacuumSlots();
+  };
+  auto prev = static_cast<TablePage *>(FetchHeapPage(first_page_id_));
+  if (prev == nullptr) {
+    return 0;
+  }
+  prev->WLatch();
+  vacuum_slots(prev);
+  if (layout_ == TableLayout::ROW) {
+    UpdateFreeSpaceMap(first_page_id_, prev->GetFreeSpaceRemaining());
+  }
+  size_t freed = 0;
+  // Freeing pages shifts every chain position after them, so the directory is rebuilt from the
+  // survivors this walk visits anyway.
+  std::vector<page_id_t> kept{first_page_id_};
+  page_id_t cur_id = prev->GetNextPageId();
+  while (cur_id != INVALID_PAGE_ID) {
+    auto cur = static_cast<TablePage *>(FetchHeapPage(cur_id));
+    cur->WLatch();
+    page_id_t next_id = cur->GetNextPageId();
+    if (vacuum_slots(cur) == 0) {
+      // Nothing stored: splice the page out of the chain and free it. prev stays latched, so
+      // the chain is never observable in a half-relinked state.
+      prev->SetNextPageId(next_id);
+      if (next_id != INVALID_PAGE_ID) {
+        auto next = static_cast<TablePage *>(FetchHeapPage(next_id));
+        next->WLatch();
+        next->SetPrevPageId(prev->GetTablePageId());
+        next->WUnlatch();
+        UnpinHeapPage(next_id, true);
+      }
+      cur->WUnlatch();
+      UnpinHeapPage(cur_id, false);
+      buffer_pool_manager_->DeletePage(cur_id);
+      EraseFromFreeSpaceMap(cur_id);
+      if (zone_map_ != nullptr) {
+        // The freed id may be recycled for unrelated rows; a stale range could prune wrongly.
+        zone_map_->ErasePage(cur_id);
+      }
+      freed++;
+    } else {
+      if (layout_ == TableLayout::ROW) {
+        // Slot trimming may have moved the survivor into a better category.
+        UpdateFreeSpaceMap(cur_id, cur->GetFreeSpaceRemaining());
+      }
+      kept.push_back(cur_id);
+      prev->WUnlatch();
+      UnpinHeapPage(prev->GetTablePageId(), true);
+      prev = cur;
+    }
+    cur_id = next_id;
+  }
+  prev->WUnlatch();
+  UnpinHeapPage(prev->GetTablePageId(), true);
+  {
+    std::lock_guard<std::mutex> guard(directory_latch_);
+    page_directory_.clear();
+    for (size_t i = 0; i < kept.size(); i += DIRECTORY_INTERVAL) {
+      page_directory_.push_back(kept[i]);
+    }
+    page_count_ = kept.size();
+  }
+  if (freed > 0 && zone_map_ != nullptr) {
+    // Splicing changed some pages' successors; drop every cached link rather than track which.
+    zone_map_->InvalidateChainLinks();
+  }
+  return freed;
+}
+
+void TableHeap::AppendChain(TableHeap *other) {
+  BUSTUB_ASSERT(buffer_pool_manager_ == other->buffer_pool_manager_,
+                "Chains can only be linked within one buffer pool.");
+  BUSTUB_ASSERT(layout_ == other->layout_, "Chains can only be linked between heaps of the same layout.");
+  BUSTUB_ASSERT(indexes_.empty() && zone_map_ == nullptr,
+                "The donor's rows were written past any registered index or zone map.");
+  if (other->first_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  // Find the tail, starting from the last directory entry when one exists instead of the front.
+  page_id_t tail_id = first_page_id_;
+  {
+    std::lock_guard<std::mutex> guard(directory_latch_);
+    if (!page_directory_.empty()) {
+      tail_id = page_directory_.back();
+    }
+  }
+  for (;;) {
+    auto page = static_cast<TablePage *>(FetchHeapPage(tail_id));
+    BUSTUB_ASSERT(page != nullptr, "Chain walk lost a page.");
+    page->RLatch();
+    page_id_t next_id = page->GetNextPageId();
+    page->RUnlatch();
+    UnpinHeapPage(tail_id, false);
+    if (next_id == INVALID_PAGE_ID) {
+      break;
+    }
+    tail_id = next_id;
+  }
+  // Link the donor's first page behind the tail.
+  auto tail = static_cast<TablePage *>(FetchHeapPage(tail_id));
+  tail->WLatch();
+  tail->SetNextPageId(other->first_page_id_);
+  tail->WUnlatch();
+  UnpinHeapPage(tail_id, true);
+  auto head = static_cast<TablePage *>(FetchHeapPage(other->first_page_id_));
+  head->WLatch();
+  head->SetPrevPageId(tail_id);
+  head->WUnlatch();
+  UnpinHeapPage(other->first_page_id_, true);
+  // The donor's free-space knowledge carries over, so later inserts can fill its pages.
+  if (layout_ == TableLayout::ROW) {
+    std::scoped_lock lock(fsm_latch_, other->fsm_latch_);
+    for (const auto &[page_id, category] : other->fsm_category_) {
+      fsm_category_[page_id] = category;
+      fsm_buckets_[category].push_back(page_id);
+    }
+    other->fsm_category_.clear();
+    for (auto &bucket : other->fsm_buckets_) {
+      bucket.clear();
+    }
+  }
+  // Every appended page shifted chain position; drop the directory and rebuild it lazily.
+  {
+    std::lock_guard<std::mutex> guard(directory_latch_);
+    page_directory_.clear();
+    page_count_ = 0;
+  }
+  // The donor no longer owns any pages.
+  other->first_page_id_ = INVALID_PAGE_ID;
+  {
+    std::lock_guard<std::mutex> guard(other->directory_latch_);
+    other->page_directory_.clear();
+    other->page_count_ = 0;
+  }
+}
+
+bool TableHeap::IsToasted(const Tuple &tuple, const Schema *schema) {
+  for (auto &i : schema->GetUnlinedColumns()) {
+    if (tuple.IsNull(schema, i)) {
+      continue;
+    }
+    uint32_t entry = *reinterpret_cast<const uint32_t *>(tuple.data_ + schema->GetColumn(i).GetOffset());
+    if (*reinterpret_cast<const uint32_t *>(tuple.data_ + entry) == TOAST_MARKER) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Tuple TableHeap::ToastTuple(const Tuple &tuple) {
+  const Schema *schema = schema_.get();
+  uint32_t bitmap_size = Tuple::NullBitmapSize(schema);
+  // The stub is never larger than the original: a pointer entry only ever replaces a payload
+  // of at least TOAST_MIN_PAYLOAD bytes.
+  std::vector<char> stub(tuple.size_);
+  memcpy(stub.data(), tuple.data_, schema->GetLength());
+  uint32_t offset = schema->GetLength();
+  for (auto &i : schema->GetUnlinedColumns()) {
+    if (tuple.IsNull(schema, i)) {
+      continue;
+    }
+    uint32_t col_offset = schema->GetColumn(i).GetOffset();
+    uint32_t old_offset = *reinterpret_cast<const uint32_t *>(tuple.data_ + col_offset);
+    uint32_t length = *reinterpret_cast<const uint32_t *>(tuple.data_ + old_offset);
+    *reinterpret_cast<uint32_t *>(stub.data() + col_offset) = offset;
+    if (length >= TOAST_MIN_PAYLOAD) {
+      page_id_t first_page_id = WriteOverflowChain(tuple.data_ + old_offset + sizeof(uint32_t), length);
+      *reinterpret_cast<uint32_t *>(stub.data() + offset) = TOAST_MARKER;
+      *reinterpret_cast<uint32_t *>(stub.data() + offset + sizeof(uint32_t)) = static_cast<uint32_t>(first_page_id);
+      *reinterpret_cast<uint32_t *>(stub.data() + offset + 2 * sizeof(uint32_t)) = length;
+      offset += SIZE_TOAST_ENTRY;
+    } else {
+      // A small payload stays in line, length prefix and all.
+      memcpy(stub.data() + offset, tuple.data_ + old_offset, sizeof(uint32_t) + length);
+      offset += sizeof(uint32_t) + length;
+    }
+  }
+  memcpy(stub.data() + offset, tuple.data_ + tuple.size_ - bitmap_size, bitmap_size);
+  Tuple result;
+  memcpy(result.ResizeData(offset + bitmap_size), stub.data(), offset + bitmap_size);
+  result.rid_ = tuple.rid_;
+  return result;
+}
+
+void TableHeap::DetoastTuple(Tuple *tuple) {
+  const Schema *schema = schema_.get();
+  uint32_t bitmap_size = Tuple::NullBitmapSize(schema);
+  // First pass: the row's size once every pointer entry is replaced by its payload.
+  uint32_t full_size = schema->GetLength() + bitmap_size;
+  for (auto &i : schema->GetUnlinedColumns()) {
+    if (tuple->IsNull(schema, i)) {
+      continue;
+    }
+    uint32_t entry = *reinterpret_cast<const uint32_t *>(tuple->data_ + schema->GetColumn(i).GetOffset());
+    uint32_t length = *reinterpret_cast<const uint32_t *>(tuple->data_ + entry);
+    if (length == TOAST_MARKER) {
+      length = *reinterpret_cast<const uint32_t *>(tuple->data_ + entry + 2 * sizeof(uint32_t));
+    }
+    full_size += sizeof(uint32_t) + length;
+  }
+  // Second pass: rebuild the row, reading each chain straight into its in-line position.
+  std::vector<char> full(full_size);
+  memcpy(full.data(), tuple->data_, schema->GetLength());
+  uint32_t offset = schema->GetLength();
+  for (auto &i : schema->GetUnlinedColumns()) {
+    if (tuple->IsNull(schema, i)) {
+      continue;
+    }
+    uint32_t col_offset = schema->GetColumn(i).GetOffset();
+    uint32_t entry = *reinterpret_cast<const uint32_t *>(tuple->data_ + col_offset);
+    uint32_t length = *reinterpret_cast<const uint32_t *>(tuple->data_ + entry);
+    *reinterpret_cast<uint32_t *>(full.data() + col_offset) = offset;
+    if (length == TOAST_MARKER) {
+      auto first_page_id =
+          static_cast<page_id_t>(*reinterpret_cast<const uint32_t *>(tuple->data_ + entry + sizeof(uint32_t)));
+      uint32_t payload_length = *reinterpret_cast<const uint32_t *>(tuple->data_ + entry + 2 * sizeof(uint32_t));
+      *reinterpret_cast<uint32_t *>(full.data() + offset) = payload_length;
+      ReadOverflowChain(first_page_id, full.data() + offset + sizeof(uint32_t), payload_length);
+      offset += sizeof(uint32_t) + payload_length;
+    } else {
+      memcpy(full.data() + offset, tuple->data_ + entry, sizeof(uint32_t) + length);
+      offset += sizeof(uint32_t) + length;
+    }
+  }
+  memcpy(full.data() + offset, tuple->data_ + tuple->size_ - bitmap_size, bitmap_size);
+  memcpy(tuple->ResizeData(full_size), full.data(), full_size);
+}
+
+void TableHeap::CollectOverflowChains(const Tuple &tuple, std::vector<page_id_t> *chains) {
+  const Schema *schema = schema_.get();
+  for (auto &i : schema->GetUnlinedColumns()) {
+    if (tuple.IsNull(schema, i)) {
+      continue;
+    }
+    uint32_t entry = *reinterpret_cast<const uint32_t *>(tuple.data_ + schema->GetColumn(i).GetOffset());
+    if (*reinterpret_cast<const uint32_t *>(tuple.data_ + entry) == TOAST_MARKER) {
+      chains->push_back(
+          static_cast<page_id_t>(*reinterpret_cast<const uint32_t *>(tuple.data_ + entry + sizeof(uint32_t))));
+    }
+  }
+}
+
+page_id_t TableHeap::WriteOverflowChain(const char *data, uint32_t size) {
+  // NOTE: like PAX pages, overflow pages are not yet WAL-logged; recovery rebuilds only the
+  // in-page stubs. The chain is private to its row entry until the pointer to it is published,
+  // so no other thread can observe a half-written chain.
+  page_id_t first_page_id;
+  auto page = reinterpret_cast<OverflowPage *>(AllocatePage(&first_page_id));
+  BUSTUB_ASSERT(page != nullptr, "Couldn't create an overflow page.");
+  uint32_t written = 0;
+  while (true) {
+    uint32_t chunk = std::min(size - written, OverflowPage::CAPACITY);
+    page->WLatch();
+    page->Init(page->GetPageId());
+    memcpy(page->GetPayload(), data + written, chunk);
+    page->SetDataSize(chunk);
+    written += chunk;
+    if (written >= size) {
+      page->WUnlatch();
+      UnpinHeapPage(page->GetPageId(), true);
+      return first_page_id;
+    }
+    page_id_t next_page_id;
+    auto next_page = reinterpret_cast<OverflowPage *>(AllocatePage(&next_page_id));
+    BUSTUB_ASSERT(next_page != nullptr, "Couldn't create an overflow page.");
+    page->SetNextPageId(next_page_id);
+    page->WUnlatch();
+    UnpinHeapPage(page->GetPageId(), true);
+    page = next_page;
+  }
+}
+
+void TableHeap::ReadOverflowChain(page_id_t first_page_id, char *out, uint32_t size) {
+  uint32_t read = 0;
+  page_id_t page_id = first_page_id;
+  while (read < size && page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<OverflowPage *>(FetchHeapPage(page_id));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't find an overflow page.");
+    page->RLatch();
+    uint32_t chunk = std::min(page->GetDataSize(), size - read);
+    memcpy(out + read, page->GetPayload(), chunk);
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    UnpinHeapPage(page_id, false);
+    read += chunk;
+    page_id = next_page_id;
+  }
+  BUSTUB_ASSERT(read == size, "Overflow chain shorter than its recorded payload length.");
+}
+
+void TableHeap::FreeOverflowChain(page_id_t first_page_id) {
+  page_id_t page_id = first_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<OverflowPage *>(FetchHeapPage(page_id));
+    if (page == nullptr) {
+      return;
+    }
+    page->RLatch();
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    UnpinHeapPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
 TableIterator TableHeap::Begin(Transaction *txn) {
+  if (layout_ == TableLayout::PAX) {
+    auto pax_page = static_cast<PaxTablePage *>(FetchHeapPage(first_page_id_));
+    pax_page->RLatch();
+    RID rid;
+    pax_page->GetFirstTupleRid(&rid);
+    if (pax_page->GetNextPageId() != INVALID_PAGE_ID && !IsPinnedPage(pax_page->GetNextPageId())) {
+      buffer_pool_manager_->PrefetchPage(pax_page->GetNextPageId());
+    }
+    pax_page->RUnlatch();
+    UnpinHeapPage(first_page_id_, false);
+    return TableIterator(this, rid, txn);
+  }
   // Start an iterator from the first page.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  auto page = static_cast<TablePage *>(FetchHeapPage(first_page_id_));
   page->RLatch();
   RID rid;
   // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
   page->GetFirstTupleRid(&rid);
+  // Read ahead: start pulling in the second page of the chain while the first one is consumed.
+  if (page->GetNextPageId() != INVALID_PAGE_ID && !IsPinnedPage(page->GetNextPageId())) {
+    buffer_pool_manager_->PrefetchPage(page->GetNextPageId());
+  }
   page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(first_page_id_, false);
+  UnpinHeapPage(first_page_id_, false);
   return TableIterator(this, rid, txn);
 }
 
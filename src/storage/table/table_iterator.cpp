@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "storage/table/table_heap.h"
 
@@ -18,9 +21,26 @@ namespace bustub {
 
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
     : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
-  if (rid.GetPageId() != INVALID_PAGE_ID) {
-    table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
+  if (rid.GetPageId() == INVALID_PAGE_ID) {
+    return;
   }
+  bool loaded = table_heap_->layout_ == TableLayout::PAX ? LoadPage<PaxTablePage>(rid.GetPageId())
+                                                         : LoadPage<TablePage>(rid.GetPageId());
+  if (loaded) {
+    // Begin() hands us the page's first live rid; position on it when it is still present, and
+    // on the page's current first row otherwise.
+    for (size_t i = 0; i < page_tuples_.size(); i++) {
+      if (page_tuples_[i].rid_.Get() == rid.Get()) {
+        page_idx_ = i;
+        *tuple_ = std::move(page_tuples_[i]);
+        return;
+      }
+    }
+    page_idx_ = 0;
+    *tuple_ = std::move(page_tuples_[0]);
+    return;
+  }
+  SeekPage(next_page_id_);
 }
 
 const Tuple &TableIterator::operator*() {
@@ -33,34 +53,110 @@ Tuple *TableIterator::operator->() {
   return tuple_;
 }
 
-TableIterator &TableIterator::operator++() {
+template <typename PageType>
+bool TableIterator::LoadPage(page_id_t page_id) {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
-  cur_page->RLatch();
-  assert(cur_page != nullptr);  // all pages are pinned
-
-  RID next_tuple_rid;
-  if (!cur_page->GetNextTupleRid(tuple_->rid_,
-                                 &next_tuple_rid)) {  // end of this page
-    while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-      cur_page->RLatch();
-      if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
-        break;
+  page_tuples_.clear();
+  auto page = static_cast<PageType *>(table_heap_->FetchHeapPage(page_id));
+  if (page == nullptr) {
+    next_page_id_ = INVALID_PAGE_ID;
+    return false;
+  }
+  // A logging transaction's row reads go through the heap after the latch drops, so snapshot
+  // visibility and row locking apply per row as usual; only the rid walk is amortized then.
+  const bool copy_in_page = !enable_logging || txn_ == nullptr;
+  LockManager *row_lock_manager = table_heap_->RowLockManager(txn_, false);
+  std::vector<RID> rids;
+  page->RLatch();
+  next_page_id_ = page->GetNextPageId();
+  // Read ahead: overlap the fetch of upcoming pages with consuming this one's rows. The window
+  // scales like the kernel's readahead: each page that physically follows its predecessor
+  // doubles it (append-only heaps allocate consecutive ids, so a sequential chain keeps
+  // confirming), while a jump in the chain resets it to one page so a fragmented or re-linked
+  // table cannot flood the pool with guesses.
+  if (next_page_id_ != INVALID_PAGE_ID) {
+    if (last_page_id_ != INVALID_PAGE_ID) {
+      readahead_window_ = page_id == last_page_id_ + 1 ? std::min(readahead_window_ * 2, MAX_READAHEAD_PAGES) : 1;
+    }
+    last_page_id_ = page_id;
+    // Only the successor's id is known; the rest of the window speculates that the run of
+    // consecutive ids continues. The high-water mark keeps overlapping windows from
+    // re-requesting pages already handed to the prefetcher.
+    page_id_t window_end = next_page_id_ + (next_page_id_ == page_id + 1 ? readahead_window_ : 1);
+    for (page_id_t ahead = next_page_id_; ahead < window_end; ahead++) {
+      if (ahead > readahead_high_water_ && !table_heap_->IsPinnedPage(ahead)) {
+        buffer_pool_manager->PrefetchPage(ahead);
+      }
+    }
+    readahead_high_water_ = std::max(readahead_high_water_, window_end - 1);
+  }
+  // One pass over the slot directory materializes every live rid of the page.
+  RID rid;
+  if (page->GetFirstTupleRid(&rid)) {
+    rids.push_back(rid);
+    RID next;
+    while (page->GetNextTupleRid(rids.back(), &next)) {
+      rids.push_back(next);
+    }
+  }
+  if (copy_in_page) {
+    page_tuples_.reserve(rids.size());
+    for (const RID &r : rids) {
+      Tuple tuple;
+      bool found;
+      if constexpr (std::is_same_v<PageType, PaxTablePage>) {
+        found = page->GetTuple(table_heap_->schema_.get(), r, &tuple, txn_, row_lock_manager);
+      } else {
+        found = page->GetTuple(r, &tuple, txn_, row_lock_manager);
+      }
+      if (found) {
+        page_tuples_.push_back(std::move(tuple));
+      }
+    }
+  }
+  page->RUnlatch();
+  table_heap_->UnpinHeapPage(page_id, false);
+  if (!copy_in_page) {
+    page_tuples_.reserve(rids.size());
+    for (const RID &r : rids) {
+      Tuple tuple;
+      if (table_heap_->GetTuple(r, &tuple, txn_)) {
+        page_tuples_.push_back(std::move(tuple));
+      }
+    }
+  } else if (table_heap_->toastable_) {
+    // Overflow chains must not be fetched under the page latch; reassemble the full rows now.
+    for (Tuple &tuple : page_tuples_) {
+      if (TableHeap::IsToasted(tuple, table_heap_->schema_.get())) {
+        table_heap_->DetoastTuple(&tuple);
       }
     }
   }
-  tuple_->rid_ = next_tuple_rid;
+  return !page_tuples_.empty();
+}
+
+void TableIterator::SeekPage(page_id_t page_id) {
+  const bool pax = table_heap_->layout_ == TableLayout::PAX;
+  while (page_id != INVALID_PAGE_ID) {
+    bool loaded = pax ? LoadPage<PaxTablePage>(page_id) : LoadPage<TablePage>(page_id);
+    if (loaded) {
+      page_idx_ = 0;
+      *tuple_ = std::move(page_tuples_[0]);
+      return;
+    }
+    page_id = next_page_id_;
+  }
+  page_tuples_.clear();
+  page_idx_ = 0;
+  tuple_->rid_ = RID(INVALID_PAGE_ID, 0);  // matches End()
+}
 
-  if (*this != table_heap_->End()) {
-    table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
+TableIterator &TableIterator::operator++() {
+  if (++page_idx_ < page_tuples_.size()) {
+    *tuple_ = std::move(page_tuples_[page_idx_]);
+    return *this;
   }
-  // release until copy the tuple
-  cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+  SeekPage(next_page_id_);
   return *this;
 }
 
@@ -17,30 +17,43 @@
 #include <vector>
 
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
-// TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
-Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true) {
+Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
   assert(values.size() == schema->GetColumnCount());
+  uint32_t column_count = schema->GetColumnCount();
+  uint32_t bitmap_size = NullBitmapSize(schema);
 
-  // 1. Calculate the size of the tuple.
-  uint32_t tuple_size = schema->GetLength();
+  // 1. Calculate the size of the tuple: fixed section, varlen tail, trailing null bitmap.
+  // Null varlen columns store no payload.
+  uint32_t tuple_size = schema->GetLength() + bitmap_size;
   for (auto &i : schema->GetUnlinedColumns()) {
-    tuple_size += (values[i].GetLength() + sizeof(uint32_t));
+    if (!values[i].IsNull()) {
+      tuple_size += (values[i].GetLength() + sizeof(uint32_t));
+    }
   }
 
   // 2. Allocate memory.
-  size_ = tuple_size;
-  data_ = new char[size_];
+  ResizeData(tuple_size);
   std::memset(data_, 0, size_);
+  char *bitmap = data_ + size_ - bitmap_size;
 
   // 3. Serialize each attribute based on the input value.
-  uint32_t column_count = schema->GetColumnCount();
   uint32_t offset = schema->GetLength();
-
   for (uint32_t i = 0; i < column_count; i++) {
     const auto &col = schema->GetColumn(i);
+    if (values[i].IsNull()) {
+      bitmap[i / 8] |= static_cast<char>(1U << (i % 8));
+      // A null inlined column keeps its full-width slot and stores the type's null sentinel,
+      // so sentinel-based readers (e.g. compiled predicates) need no bitmap lookup. A null
+      // varlen column's offset slot stays zero.
+      if (col.IsInlined()) {
+        values[i].SerializeTo(data_ + col.GetOffset());
+      }
+      continue;
+    }
     if (!col.IsInlined()) {
       // Serialize relative offset, where the actual varchar data is stored.
       *reinterpret_cast<uint32_t *>(data_ + col.GetOffset()) = offset;
@@ -53,13 +66,10 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
   }
 }
 
-Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_) {
-  if (allocated_) {
-    delete[] data_;
-  }
-  if (allocated_) {
+Tuple::Tuple(const Tuple &other) : rid_(other.rid_), size_(other.size_) {
+  if (other.allocated_) {
     // Deep copy.
-    data_ = new char[size_];
+    ResizeData(other.size_);
     memcpy(data_, other.data_, size_);
   } else {
     // Shallow copy.
@@ -68,22 +78,17 @@ Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_
 }
 
 Tuple &Tuple::operator=(const Tuple &other) {
-  if (allocated_) {
-    delete[] data_;
-  }
-  allocated_ = other.allocated_;
   rid_ = other.rid_;
-  size_ = other.size_;
-
-  if (allocated_) {
-    // Deep copy.
-    data_ = new char[size_];
+  if (other.allocated_) {
+    // Deep copy, drawn from this tuple's pool when one is set.
+    ResizeData(other.size_);
     memcpy(data_, other.data_, size_);
   } else {
     // Shallow copy.
+    FreeData();
+    size_ = other.size_;
     data_ = other.data_;
   }
-
   return *this;
 }
 
@@ -91,11 +96,25 @@ Value Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const {
   assert(schema);
   assert(data_);
   const TypeId column_type = schema->GetColumn(column_idx).GetType();
+  // A null column has no payload to deserialize (a null varlen stores none at all).
+  if (IsNull(schema, column_idx)) {
+    return ValueFactory::GetNullValueByType(column_type);
+  }
   const char *data_ptr = GetDataPtr(schema, column_idx);
   // the third parameter "is_inlined" is unused
   return Value::DeserializeFrom(data_ptr, column_type);
 }
 
+Tuple Tuple::KeyFromTuple(const Schema *schema, const Schema *key_schema,
+                          const std::vector<uint32_t> &key_attrs) const {
+  std::vector<Value> values;
+  values.reserve(key_attrs.size());
+  for (uint32_t idx : key_attrs) {
+    values.push_back(GetValue(schema, idx));
+  }
+  return Tuple(std::move(values), key_schema);
+}
+
 const char *Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) const {
   assert(schema);
   assert(data_);
@@ -144,13 +163,8 @@ void Tuple::SerializeTo(char *storage) const {
 void Tuple::DeserializeFrom(const char *storage) {
   uint32_t size = *reinterpret_cast<const uint32_t *>(storage);
   // Construct a tuple.
-  this->size_ = size;
-  if (this->allocated_) {
-    delete[] this->data_;
-  }
-  this->data_ = new char[this->size_];
+  ResizeData(size);
   memcpy(this->data_, storage + sizeof(int32_t), this->size_);
-  this->allocated_ = true;
 }
 
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstdio>
 #include <iostream>
 #include <string>
 
@@ -309,7 +310,12 @@ Value DecimalType::CastAs(const Value &val, const TypeId type_id) const {
       if (val.IsNull()) {
         return Value(TypeId::VARCHAR, nullptr, 0, false);
       }
-      return Value(TypeId::VARCHAR, val.ToString());
+      // Format on the stack; going through ToString would build the same characters in a
+      // temporary std::string only for the Value constructor to copy them a second time.
+      // %f of the largest double stays under ~320 characters.
+      char buf[384];
+      int len = snprintf(buf, sizeof(buf), "%f", val.value_.decimal_);
+      return Value(TypeId::VARCHAR, buf, static_cast<uint32_t>(len) + 1, true);
     }
     default:
       break;
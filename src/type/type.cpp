@@ -28,72 +28,7 @@ Type *Type::k_types[] = {
     new IntegerType(TypeId::INTEGER), new BigintType(),  new DecimalType(), new VarlenType(TypeId::VARCHAR),
 };
 
-// Get the size of this data type in bytes
-uint64_t Type::GetTypeSize(const TypeId type_id) {
-  switch (type_id) {
-    case BOOLEAN:
-    case TINYINT:
-      return 1;
-    case SMALLINT:
-      return 2;
-    case INTEGER:
-      return 4;
-    case BIGINT:
-    case DECIMAL:
-    case TIMESTAMP:
-      return 8;
-    case VARCHAR:
-      return 0;
-    default:
-      break;
-  }
-  throw Exception(ExceptionType::UNKNOWN_TYPE, "Unknown type.");
-}
-
-bool Type::IsCoercableFrom(const TypeId type_id) const {
-  switch (type_id_) {
-    case INVALID:
-      return false;
-    case BOOLEAN:
-      return true;
-    case TINYINT:
-    case SMALLINT:
-    case INTEGER:
-    case BIGINT:
-    case DECIMAL:
-      switch (type_id) {
-        case TINYINT:
-        case SMALLINT:
-        case INTEGER:
-        case BIGINT:
-        case DECIMAL:
-        case VARCHAR:
-          return true;
-        default:
-          return false;
-      }
-      break;
-    case TIMESTAMP:
-      return (type_id == VARCHAR || type_id == TIMESTAMP);
-    case VARCHAR:
-      switch (type_id) {
-        case BOOLEAN:
-        case TINYINT:
-        case SMALLINT:
-        case INTEGER:
-        case BIGINT:
-        case DECIMAL:
-        case TIMESTAMP:
-        case VARCHAR:
-          return true;
-        default:
-          return false;
-      }
-      break;
-    default:
-      return (type_id == type_id_);
-  }  // END SWITCH
-}
+void Type::ThrowUnknownTypeException() { throw Exception(ExceptionType::UNKNOWN_TYPE, "Unknown type."); }
 
 std::string Type::TypeIdToString(const TypeId type_id) {
   switch (type_id) {
@@ -18,29 +18,6 @@
 #include "type/value.h"
 
 namespace bustub {
-Value::Value(const Value &other) {
-  type_id_ = other.type_id_;
-  size_ = other.size_;
-  manage_data_ = other.manage_data_;
-  value_ = other.value_;
-  switch (type_id_) {
-    case TypeId::VARCHAR:
-      if (size_.len_ == BUSTUB_VALUE_NULL) {
-        value_.varlen_ = nullptr;
-      } else {
-        if (manage_data_) {
-          value_.varlen_ = new char[size_.len_];
-          memcpy(value_.varlen_, other.value_.varlen_, size_.len_);
-        } else {
-          value_ = other.value_;
-        }
-      }
-      break;
-    default:
-      value_ = other.value_;
-  }
-}
-
 Value &Value::operator=(Value other) {
   Swap(*this, other);
   return *this;
@@ -221,7 +198,7 @@ Value::Value(TypeId type, const char *data, uint32_t len, bool manage_data) : Va
         manage_data_ = manage_data;
         if (manage_data_) {
           assert(len < BUSTUB_VARCHAR_MAX_LEN);
-          value_.varlen_ = new char[len];
+          value_.varlen_ = AllocateVarlen(len);
           assert(value_.varlen_ != nullptr);
           size_.len_ = len;
           memcpy(value_.varlen_, data, len);
@@ -243,7 +220,7 @@ Value::Value(TypeId type, const std::string &data) : Value(type) {
       manage_data_ = true;
       // TODO(TAs): How to represent a null string here?
       uint32_t len = static_cast<uint32_t>(data.length()) + 1;
-      value_.varlen_ = new char[len];
+      value_.varlen_ = AllocateVarlen(len);
       assert(value_.varlen_ != nullptr);
       size_.len_ = len;
       memcpy(value_.varlen_, data.c_str(), len);
@@ -254,19 +231,6 @@ Value::Value(TypeId type, const std::string &data) : Value(type) {
   }
 }
 
-// delete allocated char array space
-Value::~Value() {
-  switch (type_id_) {
-    case TypeId::VARCHAR:
-      if (manage_data_) {
-        delete[] value_.varlen_;
-      }
-      break;
-    default:
-      break;
-  }
-}
-
 bool Value::CheckComparable(const Value &o) const {
   switch (GetTypeId()) {
     case TypeId::BOOLEAN:
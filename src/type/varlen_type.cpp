@@ -11,13 +11,55 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 #include <string>
 
 #include "common/exception.h"
+#include "common/util/string_util.h"
 #include "type/type_util.h"
 #include "type/varlen_type.h"
 
 namespace bustub {
+namespace {
+// The numeric casts parse the varchar's bytes where they sit. Every stored varchar carries the
+// trailing terminator its std::string constructor wrote -- ToString strips it with len - 1 --
+// so the C parsing routines can run on the buffer directly instead of copying it into a
+// std::string first, which mattered once expressions started casting per scanned row.
+int64_t ParseVarlenInteger(const Value &value) {
+  const char *data = value.GetData();
+  if (data == nullptr || value.GetLength() == 0) {
+    throw Exception("Invalid input syntax for integer.");
+  }
+  char *end = nullptr;
+  errno = 0;
+  int64_t parsed = std::strtoll(data, &end, 10);
+  if (end == data) {
+    throw Exception("Invalid input syntax for integer.");
+  }
+  if (errno == ERANGE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+  }
+  return parsed;
+}
+
+double ParseVarlenDecimal(const Value &value) {
+  const char *data = value.GetData();
+  if (data == nullptr || value.GetLength() == 0) {
+    throw Exception("Invalid input syntax for decimal.");
+  }
+  char *end = nullptr;
+  errno = 0;
+  double parsed = std::strtod(data, &end);
+  if (end == data) {
+    throw Exception("Invalid input syntax for decimal.");
+  }
+  if (errno == ERANGE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+  }
+  return parsed;
+}
+}  // namespace
 #define VARLEN_COMPARE_FUNC(OP)                                               \
   const char *str1 = left.GetData();                                          \
   uint32_t len1 = GetLength(left) - 1;                                        \
@@ -183,7 +225,7 @@ Value VarlenType::CastAs(const Value &value, const TypeId type_id) const {
   switch (type_id) {
     case TypeId::BOOLEAN: {
       str = value.ToString();
-      std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+      StringUtil::LowerInPlace(str.data(), str.size());
       if (str == "true" || str == "1" || str == "t") {
         return Value(type_id, 1);
       }
@@ -193,65 +235,35 @@ Value VarlenType::CastAs(const Value &value, const TypeId type_id) const {
       throw Exception("Boolean value format error.");
     }
     case TypeId::TINYINT: {
-      str = value.ToString();
-      int8_t tinyint = 0;
-      try {
-        tinyint = static_cast<int8_t>(stoi(str));
-      } catch (std::out_of_range &e) {
-        throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-      }
-      if (tinyint < BUSTUB_INT8_MIN) {
+      int64_t tinyint = ParseVarlenInteger(value);
+      if (tinyint > BUSTUB_INT8_MAX || tinyint < BUSTUB_INT8_MIN) {
         throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
       }
-      return Value(type_id, tinyint);
+      return Value(type_id, static_cast<int8_t>(tinyint));
     }
     case TypeId::SMALLINT: {
-      str = value.ToString();
-      int16_t smallint = 0;
-      try {
-        smallint = static_cast<int16_t>(stoi(str));
-      } catch (std::out_of_range &e) {
-        throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-      }
-      if (smallint < BUSTUB_INT16_MIN) {
+      int64_t smallint = ParseVarlenInteger(value);
+      if (smallint > BUSTUB_INT16_MAX || smallint < BUSTUB_INT16_MIN) {
         throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
       }
-      return Value(type_id, smallint);
+      return Value(type_id, static_cast<int16_t>(smallint));
     }
     case TypeId::INTEGER: {
-      str = value.ToString();
-      int32_t integer = 0;
-      try {
-        integer = stoi(str);
-      } catch (std::out_of_range &e) {
-        throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-      }
+      int64_t integer = ParseVarlenInteger(value);
       if (integer > BUSTUB_INT32_MAX || integer < BUSTUB_INT32_MIN) {
         throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
       }
-      return Value(type_id, integer);
+      return Value(type_id, static_cast<int32_t>(integer));
     }
     case TypeId::BIGINT: {
-      str = value.ToString();
-      int64_t bigint = 0;
-      try {
-        bigint = stoll(str);
-      } catch (std::out_of_range &e) {
-        throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-      }
+      int64_t bigint = ParseVarlenInteger(value);
       if (bigint > BUSTUB_INT64_MAX || bigint < BUSTUB_INT64_MIN) {
         throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
       }
       return Value(type_id, bigint);
     }
     case TypeId::DECIMAL: {
-      str = value.ToString();
-      double res = 0;
-      try {
-        res = stod(str);
-      } catch (std::out_of_range &e) {
-        throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
-      }
+      double res = ParseVarlenDecimal(value);
       if (res > BUSTUB_DECIMAL_MAX || res < BUSTUB_DECIMAL_MIN) {
         throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
       }
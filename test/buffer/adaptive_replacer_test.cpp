@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_replacer_test.cpp
+//
+// Identification: test/buffer/adaptive_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+
+#include "buffer/adaptive_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(AdaptiveReplacerTest, SampleTest) {
+  AdaptiveReplacer replacer(4, /*window_misses=*/4);
+  EXPECT_EQ(ReplacerType::CLOCK, replacer.GetActivePolicy());
+
+  // Scenario: unpin four frames; both sub-policies see them, so the size matches either view.
+  replacer.Unpin(0);
+  replacer.Unpin(1);
+  replacer.Unpin(2);
+  replacer.Unpin(3);
+  EXPECT_EQ(4, replacer.Size());
+
+  // Scenario: victimize a frame and tell the replacer which page left through it.
+  frame_id_t victim;
+  ASSERT_TRUE(replacer.Victim(&victim));
+  EXPECT_EQ(3, replacer.Size());
+  replacer.RecordEviction(victim, /*page_id=*/42);
+
+  // Scenario: a miss on the just-evicted page is a ghost hit; misses on never-seen pages are not.
+  replacer.RecordMiss(42);
+  EXPECT_EQ(1U, replacer.GetGhostHits());
+  replacer.RecordMiss(100);
+  replacer.RecordMiss(101);
+
+  // Scenario: the fourth miss closes the window. LRU-K has never been measured, so the
+  // replacer explores it.
+  replacer.RecordMiss(102);
+  EXPECT_EQ(ReplacerType::LRU_K, replacer.GetActivePolicy());
+  EXPECT_EQ(1U, replacer.GetPolicySwitches());
+
+  // Scenario: the shadow policy was kept current, so victim selection keeps working after the
+  // switch and never hands out the already-victimized frame.
+  frame_id_t second;
+  ASSERT_TRUE(replacer.Victim(&second));
+  EXPECT_NE(victim, second);
+  frame_id_t third;
+  ASSERT_TRUE(replacer.Victim(&third));
+  frame_id_t fourth;
+  ASSERT_TRUE(replacer.Victim(&fourth));
+  EXPECT_EQ(0, replacer.Size());
+  EXPECT_FALSE(replacer.Victim(&victim));
+}
+
+}  // namespace bustub
@@ -10,8 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -74,4 +77,88 @@ TEST(BufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BatchFetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  // Create some pages, write recognizable content, and evict them from the pool.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "Page%d", page_id);
+    page_ids.push_back(page_id);
+  }
+  for (auto page_id : page_ids) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // A fresh buffer pool over the same file starts cold, so the batch goes down the
+  // coalesced disk-read path rather than the resident-pin path.
+  bpm->FlushAllPages();
+  delete bpm;
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  std::vector<Page *> pages;
+  bpm->FetchPages(page_ids, &pages);
+  ASSERT_EQ(page_ids.size(), pages.size());
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    ASSERT_NE(nullptr, pages[i]);
+    std::string expected = "Page" + std::to_string(page_ids[i]);
+    EXPECT_EQ(0, strcmp(pages[i]->GetData(), expected.c_str()));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FrameWaitTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  // Pin the whole pool.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    page_ids.push_back(page_id);
+  }
+
+  // A concurrent unpin is the usual way frames come free; the stalled NewPage must pick it
+  // up through its backoff retries instead of failing outright.
+  std::thread releaser([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[0], false));
+  });
+  page_id_t waited_page_id;
+  auto *waited_page = bpm->NewPage(&waited_page_id);
+  releaser.join();
+  ASSERT_NE(nullptr, waited_page);
+  EXPECT_GT(bpm->GetStats().frame_waits_, 0U);
+
+  // With every frame pinned and nobody releasing, the retry budget runs out: real starvation.
+  ASSERT_EQ(nullptr, bpm->NewPage(&waited_page_id));
+  EXPECT_GT(bpm->GetStats().frame_wait_failures_, 0U);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_replacer(7, 2);
+
+  // Scenario: unpin six elements, i.e. add them to the replacer.
+  lru_replacer.Unpin(1);
+  lru_replacer.Unpin(2);
+  lru_replacer.Unpin(3);
+  lru_replacer.Unpin(4);
+  lru_replacer.Unpin(5);
+  lru_replacer.Unpin(6);
+  EXPECT_EQ(6, lru_replacer.Size());
+
+  // Scenario: frame 1 is re-referenced, so it now has two accesses while the
+  // others have one. Frames with fewer than k accesses are victimized first,
+  // oldest access first.
+  lru_replacer.Pin(1);
+  lru_replacer.Unpin(1);
+
+  int value;
+  lru_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  lru_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+
+  // Scenario: pin elements in the replacer; they cannot be victimized.
+  lru_replacer.Pin(5);
+  lru_replacer.Pin(6);
+  EXPECT_EQ(1, lru_replacer.Size());
+
+  // Scenario: frame 1 has a full history but is the only evictable frame left.
+  lru_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  EXPECT_EQ(0, lru_replacer.Size());
+
+  // Scenario: no evictable frames left.
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+
+  // Scenario: a scan touching frames once cannot push out a frame with history.
+  lru_replacer.Pin(5);
+  lru_replacer.Unpin(5);  // frame 5 now has >= k accesses
+  lru_replacer.Unpin(2);  // single-access scan page
+  lru_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+}
+
+}  // namespace bustub
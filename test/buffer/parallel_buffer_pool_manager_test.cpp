@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, RoutingTest) {
+  const std::string db_name = "test.db";
+  const uint32_t num_instances = 4;
+  const size_t pool_size = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+
+  EXPECT_EQ(num_instances * pool_size, bpm->GetPoolSize());
+
+  // Scenario: every new page id must map back to the instance that created it.
+  page_id_t page_ids[num_instances * pool_size];
+  for (size_t i = 0; i < num_instances * pool_size; ++i) {
+    Page *page = bpm->NewPage(&page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "Page%d", page_ids[i]);
+  }
+
+  // Scenario: all frames are taken, so no new page can be created anywhere.
+  page_id_t tmp;
+  EXPECT_EQ(nullptr, bpm->NewPage(&tmp));
+
+  // Scenario: unpinning in one shard only frees frames in that shard.
+  for (size_t i = 0; i < num_instances * pool_size; ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+  }
+
+  // Scenario: we can fetch every page back through the router and see the data we wrote.
+  for (size_t i = 0; i < num_instances * pool_size; ++i) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    std::string expected = "Page" + std::to_string(page_ids[i]);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected.c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
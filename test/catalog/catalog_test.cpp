@@ -16,6 +16,7 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/simple_catalog.h"
+#include "execution/executor_context.h"
 #include "gtest/gtest.h"
 #include "type/value_factory.h"
 
@@ -28,8 +29,9 @@ TEST(CatalogTest, DISABLED_CreateTableTest) {
   auto catalog = new SimpleCatalog(bpm, nullptr, nullptr);
   std::string table_name = "potato";
 
-  // The table shouldn't exist in the catalog yet.
-  EXPECT_THROW(catalog->GetTable(table_name), std::out_of_range);
+  // The table shouldn't exist in the catalog yet. Lookups report a missing table by returning
+  // nullptr rather than throwing, matching GetIndex and GetStats.
+  EXPECT_EQ(catalog->GetTable(table_name), nullptr);
 
   // Put the table into the catalog.
   std::vector<Column> columns;
@@ -48,4 +50,128 @@ TEST(CatalogTest, DISABLED_CreateTableTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(CatalogTest, DISABLED_SnapshotLookupTest) {
+  auto disk_manager = new DiskManager("catalog_test.db");
+  auto bpm = new BufferPoolManager(32, disk_manager);
+  auto catalog = new SimpleCatalog(bpm, nullptr, nullptr);
+
+  EXPECT_EQ(catalog->GetTable("tomato"), nullptr);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  Schema schema(columns);
+  auto *tomato = catalog->CreateTable(nullptr, "tomato", schema);
+  ASSERT_NE(tomato, nullptr);
+  EXPECT_EQ(catalog->GetTable("tomato"), tomato);
+  EXPECT_EQ(catalog->GetTable(tomato->oid_), tomato);
+
+  // Later DDL swaps the snapshot; pointers handed out earlier stay valid and keep resolving.
+  auto *potato = catalog->CreateTable(nullptr, "potato", schema);
+  EXPECT_EQ(catalog->GetTable("tomato"), tomato);
+  EXPECT_EQ(catalog->GetTable("potato"), potato);
+
+  // The per-query cache answers repeated resolutions, and a miss is not sticky: a table
+  // created after the first attempt is still found.
+  ExecutorContext exec_ctx{nullptr, catalog, bpm};
+  EXPECT_EQ(exec_ctx.GetTable("tomato"), tomato);
+  EXPECT_EQ(exec_ctx.GetTable("tomato"), tomato);
+  EXPECT_EQ(exec_ctx.GetTable(tomato->oid_), tomato);
+  EXPECT_EQ(exec_ctx.GetTable("radish"), nullptr);
+  auto *radish = catalog->CreateTable(nullptr, "radish", schema);
+  EXPECT_EQ(exec_ctx.GetTable("radish"), radish);
+
+  delete catalog;
+  delete bpm;
+  delete disk_manager;
+  remove("catalog_test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(CatalogTest, DISABLED_PinnedVersionTest) {
+  auto disk_manager = new DiskManager("catalog_test.db");
+  auto bpm = new BufferPoolManager(32, disk_manager);
+  auto catalog = new SimpleCatalog(bpm, nullptr, nullptr);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  Schema schema(columns);
+  auto *tomato = catalog->CreateTable(nullptr, "tomato", schema);
+
+  // A pinned version keeps answering the same way no matter what DDL publishes after it.
+  SimpleCatalog::Version version = catalog->PinVersion();
+  EXPECT_EQ(catalog->GetTable(version, "tomato"), tomato);
+  auto *potato = catalog->CreateTable(nullptr, "potato", schema);
+  EXPECT_EQ(catalog->GetTable(version, "potato"), nullptr);
+  EXPECT_EQ(catalog->GetTable(version, potato->oid_), nullptr);
+  EXPECT_EQ(catalog->GetTable("potato"), potato);
+
+  // A context that pins at query start resolves repeatably; a later one sees the later DDL.
+  ExecutorContext pinned_ctx{nullptr, catalog, bpm};
+  pinned_ctx.PinCatalogVersion();
+  EXPECT_EQ(pinned_ctx.GetTable("tomato"), tomato);
+  auto *radish = catalog->CreateTable(nullptr, "radish", schema);
+  EXPECT_EQ(pinned_ctx.GetTable("radish"), nullptr);
+  ExecutorContext fresh_ctx{nullptr, catalog, bpm};
+  fresh_ctx.PinCatalogVersion();
+  EXPECT_EQ(fresh_ctx.GetTable("radish"), radish);
+
+  delete catalog;
+  delete bpm;
+  delete disk_manager;
+  remove("catalog_test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(CatalogTest, DISABLED_LazyAttachTest) {
+  auto disk_manager = new DiskManager("catalog_test.db");
+  auto bpm = new BufferPoolManager(32, disk_manager);
+  auto catalog = new SimpleCatalog(bpm, nullptr, nullptr);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  Schema schema(columns);
+
+  // Build a table the eager way and remember where it starts.
+  auto *transaction = new Transaction(0);
+  auto *carrot = catalog->CreateTable(nullptr, "carrot", schema);
+  std::vector<RID> rids(10);
+  for (int i = 0; i < 10; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i)}, &schema);
+    ASSERT_TRUE(carrot->table_->InsertTuple(tuple, &rids[i], transaction));
+  }
+  page_id_t first_page_id = carrot->table_->GetFirstPageId();
+  bpm->FlushAllPages();
+
+  // A second catalog attaches the same heap by its first page without reading anything.
+  auto reopened = new SimpleCatalog(bpm, nullptr, nullptr);
+  auto *attached = reopened->AttachTable("carrot", schema, first_page_id);
+  ASSERT_NE(attached, nullptr);
+  EXPECT_EQ(attached->table_, nullptr);
+  EXPECT_EQ(attached->first_page_id_, first_page_id);
+
+  // Warming batches the header read; the heap itself is still only built on lookup.
+  EXPECT_EQ(reopened->WarmAttachedTables(), 1u);
+  EXPECT_EQ(attached->table_, nullptr);
+
+  // First touch materializes the heap, and the rows are all there.
+  auto *touched = reopened->GetTable("carrot");
+  ASSERT_EQ(touched, attached);
+  ASSERT_NE(touched->table_, nullptr);
+  for (int i = 0; i < 10; i++) {
+    Tuple tuple;
+    ASSERT_TRUE(touched->table_->GetTuple(rids[i], &tuple, transaction));
+    EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+  }
+  // Nothing left to warm once every table has its heap.
+  EXPECT_EQ(reopened->WarmAttachedTables(), 0u);
+
+  delete transaction;
+  delete reopened;
+  delete catalog;
+  delete bpm;
+  delete disk_manager;
+  remove("catalog_test.db");
+}
+
 }  // namespace bustub
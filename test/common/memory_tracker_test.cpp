@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_tracker_test.cpp
+//
+// Identification: test/common/memory_tracker_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/memory_tracker.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(MemoryTrackerTest, GrantReleaseTest) {
+  MemoryTracker tracker(1024);
+  ASSERT_TRUE(tracker.Grant(512));
+  ASSERT_TRUE(tracker.Grant(512));
+  // The budget is exhausted; a denied grant must not leak accounting.
+  ASSERT_FALSE(tracker.Grant(1));
+  ASSERT_EQ(tracker.Used(), 1024);
+  tracker.Release(512);
+  ASSERT_TRUE(tracker.Grant(256));
+  ASSERT_EQ(tracker.Used(), 768);
+}
+
+// NOLINTNEXTLINE
+TEST(MemoryTrackerTest, ReservationTest) {
+  MemoryTracker tracker(1024 * 1024);
+  {
+    MemoryReservation reservation(&tracker);
+    // Reserve is called with the running footprint and claims chunks on the way up.
+    ASSERT_TRUE(reservation.Reserve(100));
+    ASSERT_TRUE(reservation.Reserve(200 * 1024));
+    ASSERT_GE(tracker.Used(), 200 * 1024U);
+    // A footprint past the budget is denied, and the earlier claim stays intact.
+    ASSERT_FALSE(reservation.Reserve(2 * 1024 * 1024));
+    ASSERT_GE(tracker.Used(), 200 * 1024U);
+  }
+  // Destruction hands everything back.
+  ASSERT_EQ(tracker.Used(), 0);
+
+  // A reservation without a tracker is unlimited.
+  MemoryReservation unlimited(nullptr);
+  ASSERT_TRUE(unlimited.Reserve(static_cast<size_t>(1) << 40));
+}
+
+}  // namespace bustub
@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// string_util_test.cpp
+//
+// Identification: test/common/string_util_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+
+#include "common/util/string_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(StringUtilTest, CaseConversionTest) {
+  // Crosses the eight-byte word boundary so both the SWAR loop and the scalar tail run.
+  std::string mixed = "Hello, World! 0123456789 [\\]^_`{|}~";
+  EXPECT_EQ(StringUtil::Upper(mixed), "HELLO, WORLD! 0123456789 [\\]^_`{|}~");
+  EXPECT_EQ(StringUtil::Lower(mixed), "hello, world! 0123456789 [\\]^_`{|}~");
+  EXPECT_EQ(StringUtil::Upper(""), "");
+
+  // The range test must not touch the ascii neighbours of the letter ranges ('@', '[', '`', '{')
+  // or bytes with the high bit set.
+  std::string edges = "@AZ[`az{\x80\xc1@AZ[`az{\x80\xc1";
+  EXPECT_EQ(StringUtil::Upper(edges), "@AZ[`AZ{\x80\xc1@AZ[`AZ{\x80\xc1");
+  EXPECT_EQ(StringUtil::Lower(edges), "@az[`az{\x80\xc1@az[`az{\x80\xc1");
+
+  std::string in_place = "AbCdEfGhIjK";
+  StringUtil::LowerInPlace(in_place.data(), in_place.size());
+  EXPECT_EQ(in_place, "abcdefghijk");
+  StringUtil::UpperInPlace(in_place.data(), in_place.size());
+  EXPECT_EQ(in_place, "ABCDEFGHIJK");
+}
+
+// NOLINTNEXTLINE
+TEST(StringUtilTest, ContainsTest) {
+  std::string haystack = "the quick brown fox jumps over the lazy dog";
+  EXPECT_TRUE(StringUtil::Contains(haystack, "brown fox"));
+  EXPECT_TRUE(StringUtil::Contains(haystack, ""));
+  EXPECT_FALSE(StringUtil::Contains(haystack, "browner"));
+
+  // Buffer overload: the needle must be found only within the given length.
+  EXPECT_TRUE(StringUtil::Contains(haystack.data(), haystack.size(), "dog", 3));
+  EXPECT_FALSE(StringUtil::Contains(haystack.data(), 10, "dog", 3));
+  EXPECT_TRUE(StringUtil::Contains(haystack.data(), 0, "", 0));
+}
+
+}  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tracer_test.cpp
+//
+// Identification: test/common/tracer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// The probes are compiled out of regular builds; this translation unit turns them on to
+// test the macros and the binary dump format.
+#define BUSTUB_TRACING
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common/tracer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TracerTest, RecordAndDumpTest) {
+  BUSTUB_TRACE(BPM_FETCH, 7, 1);
+  BUSTUB_TRACE(BPM_UNPIN, 7, 0);
+  BUSTUB_TRACE_WAIT_START(wait_start);
+  BUSTUB_TRACE_WAIT_END(LOG_FLUSH_WAIT, 42, wait_start);
+
+  const std::string path = "tracer_test.trace";
+  ASSERT_TRUE(Tracer::Dump(path));
+
+  FILE *in = fopen(path.c_str(), "rb");
+  ASSERT_NE(in, nullptr);
+  std::vector<TraceRecord> records;
+  TraceRecord record;
+  while (fread(&record, sizeof(TraceRecord), 1, in) == 1) {
+    records.push_back(record);
+  }
+  fclose(in);
+  remove(path.c_str());
+
+  ASSERT_GE(records.size(), 3U);
+  // The three records staged above come out in order with their arguments intact.
+  size_t base = records.size() - 3;
+  EXPECT_EQ(records[base].event_, TraceEvent::BPM_FETCH);
+  EXPECT_EQ(records[base].arg0_, 7U);
+  EXPECT_EQ(records[base].arg1_, 1U);
+  EXPECT_EQ(records[base + 1].event_, TraceEvent::BPM_UNPIN);
+  EXPECT_EQ(records[base + 2].event_, TraceEvent::LOG_FLUSH_WAIT);
+  EXPECT_EQ(records[base + 2].arg0_, 42U);
+  EXPECT_LE(records[base].timestamp_ns_, records[base + 2].timestamp_ns_);
+  EXPECT_EQ(records[base].thread_id_, records[base + 1].thread_id_);
+}
+
+}  // namespace bustub
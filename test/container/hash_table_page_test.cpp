@@ -15,8 +15,10 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/logger.h"
+#include "common/rid.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/index/generic_key.h"
 #include "storage/page/hash_table_block_page.h"
 #include "storage/page/hash_table_header_page.h"
 
@@ -111,4 +113,53 @@ TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, DISABLED_BlockPageProbeWindowTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  // 8-byte keys take the vectorized compare path on builds that have it
+  page_id_t block_page_id = INVALID_PAGE_ID;
+  auto block_page = reinterpret_cast<HashTableBlockPage<GenericKey<8>, RID, GenericComparator<8>> *>(
+      bpm->NewPage(&block_page_id, nullptr)->GetData());
+
+  // a chain of 70 slots crossing a 64-slot window boundary, with the probe key planted at a few
+  // offsets and a tombstone in between
+  GenericKey<8> probe_key;
+  probe_key.SetFromInteger(42);
+  GenericKey<8> other_key;
+  other_key.SetFromInteger(7);
+  for (unsigned i = 0; i < 70; i++) {
+    bool match = (i == 3 || i == 40 || i == 67);
+    block_page->Insert(i, match ? probe_key : other_key, RID(0, i));
+  }
+  block_page->Remove(40);  // tombstone: occupied but no longer a match
+
+  uint64_t match_mask;
+  slot_offset_t chain_end;
+  // first window: slots 0..63, chain does not end inside it
+  EXPECT_FALSE(block_page->ProbeWindow(0, probe_key, &match_mask, &chain_end));
+  EXPECT_EQ(match_mask, 1ULL << 3);
+  EXPECT_EQ(chain_end, 64);
+  // second window: the match at 67 precedes the chain end at 70
+  EXPECT_TRUE(block_page->ProbeWindow(64, probe_key, &match_mask, &chain_end));
+  EXPECT_EQ(match_mask, 1ULL << (67 - 64));
+  EXPECT_EQ(chain_end, 70);
+  // starting mid-window masks out the slots before the start
+  EXPECT_FALSE(block_page->ProbeWindow(4, probe_key, &match_mask, &chain_end));
+  EXPECT_EQ(match_mask, 0u);
+  // a key that is absent resolves with no matches; its fingerprint tag
+  // dismisses the chain without full key compares
+  GenericKey<8> absent_key;
+  absent_key.SetFromInteger(999);
+  EXPECT_FALSE(block_page->ProbeWindow(0, absent_key, &match_mask, &chain_end));
+  EXPECT_EQ(match_mask, 0u);
+
+  bpm->UnpinPage(block_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <numeric>
 #include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
 #include "common/logger.h"
@@ -104,4 +107,324 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_SingleValueProbeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  for (int i = 0; i < 50; i++) {
+    ht.Insert(nullptr, i, i * 10);
+  }
+
+  // the fast path finds every unique key and reports a missing one
+  for (int i = 0; i < 50; i++) {
+    int value = -1;
+    EXPECT_TRUE(ht.GetSingleValue(nullptr, i, &value));
+    EXPECT_EQ(i * 10, value);
+  }
+  int value = -1;
+  EXPECT_FALSE(ht.GetSingleValue(nullptr, 100, &value));
+
+  // under a non-unique key the fast path returns one of the stored values
+  ht.Insert(nullptr, 0, 7);
+  EXPECT_TRUE(ht.GetSingleValue(nullptr, 0, &value));
+  EXPECT_TRUE(value == 0 || value == 7);
+
+  // a removed key stops resolving
+  EXPECT_TRUE(ht.Remove(nullptr, 1, 10));
+  EXPECT_FALSE(ht.GetSingleValue(nullptr, 1, &value));
+
+  // the small-buffer overload matches the vector one without leaving the stack...
+  HashTableResultBuffer<int> buffer;
+  EXPECT_TRUE(ht.GetValue(nullptr, 2, &buffer));
+  EXPECT_EQ(1, buffer.size());
+  EXPECT_EQ(20, buffer[0]);
+
+  // ...spills correctly once a key stores more values than fit inline...
+  constexpr int num_values = 2 * HashTableResultBuffer<int>::INLINE_CAPACITY + 1;
+  for (int i = 0; i < num_values; i++) {
+    ht.Insert(nullptr, 500, 1000 + i);
+  }
+  buffer.clear();
+  EXPECT_TRUE(ht.GetValue(nullptr, 500, &buffer));
+  EXPECT_EQ(num_values, static_cast<int>(buffer.size()));
+  std::vector<int> spilled(buffer.begin(), buffer.end());
+  std::sort(spilled.begin(), spilled.end());
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_EQ(1000 + i, spilled[i]);
+  }
+
+  // ...and a cleared buffer is reusable for the next probe
+  buffer.clear();
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_TRUE(ht.GetValue(nullptr, 3, &buffer));
+  EXPECT_EQ(1, buffer.size());
+  EXPECT_EQ(30, buffer[0]);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_ConcurrentOperationsTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // concurrent inserters on disjoint key ranges; probes land across all blocks, so the
+  // per-block latches are exercised in parallel, and the key count exceeds the initial
+  // slot count so a resize happens under contention
+  const int num_threads = 4;
+  const int keys_per_thread = 500;
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&ht, t] {
+      for (int i = 0; i < keys_per_thread; i++) {
+        int key = t * keys_per_thread + i;
+        EXPECT_TRUE(ht.Insert(nullptr, key, key));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // every pair must be visible afterwards
+  for (int key = 0; key < num_threads * keys_per_thread; key++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, key, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to keep " << key << std::endl;
+    EXPECT_EQ(key, res[0]);
+  }
+
+  // concurrent readers and removers; each key is removed exactly once
+  threads.clear();
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&ht, t] {
+      for (int i = 0; i < keys_per_thread; i++) {
+        int key = t * keys_per_thread + i;
+        std::vector<int> res;
+        ht.GetValue(nullptr, key, &res);
+        EXPECT_EQ(1, res.size());
+        EXPECT_TRUE(ht.Remove(nullptr, key, key));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int key = 0; key < num_threads * keys_per_thread; key++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, key, &res);
+    EXPECT_EQ(0, res.size());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_BatchOperationsTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // more entries than the initial layout holds, so the batch also exercises
+  // the fall-back path that grows the table
+  std::vector<std::pair<int, int>> entries;
+  for (int i = 0; i < 3000; i++) {
+    entries.emplace_back(i, i * 2);
+  }
+  ht.InsertBatch(nullptr, entries);
+  // a second pass is all duplicates and must change nothing
+  ht.InsertBatch(nullptr, entries);
+
+  std::vector<int> keys(3000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<std::vector<int>> results;
+  ht.GetValueBatch(nullptr, keys, &results);
+  ASSERT_EQ(3000u, results.size());
+  for (int i = 0; i < 3000; i++) {
+    ASSERT_EQ(1u, results[i].size());
+    EXPECT_EQ(i * 2, results[i][0]);
+  }
+
+  // batched and one-key reads agree
+  std::vector<int> res;
+  ht.GetValue(nullptr, 1234, &res);
+  ASSERT_EQ(1u, res.size());
+  EXPECT_EQ(2468, res[0]);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_BulkLoadTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  // deliberately undersized: the load must re-size the layout itself
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 100, HashFunction<int>());
+
+  std::vector<std::pair<int, int>> entries;
+  for (int i = 0; i < 3000; i++) {
+    entries.emplace_back(i, i * 2);
+  }
+  // an exact duplicate in the input is skipped, like Insert would
+  entries.emplace_back(42, 84);
+  ht.BulkLoad(nullptr, entries);
+
+  // the load pre-sizes for half occupancy, so no grow can be pending
+  EXPECT_GE(ht.GetSize(), 6000u);
+
+  std::vector<int> keys(3000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<std::vector<int>> results;
+  ht.GetValueBatch(nullptr, keys, &results);
+  ASSERT_EQ(3000u, results.size());
+  for (int i = 0; i < 3000; i++) {
+    ASSERT_EQ(1u, results[i].size());
+    EXPECT_EQ(i * 2, results[i][0]);
+  }
+
+  // the table is no longer empty, so a second load lands through the
+  // batched-insert fall-back and keeps everything already stored
+  std::vector<std::pair<int, int>> more;
+  for (int i = 3000; i < 3500; i++) {
+    more.emplace_back(i, i * 2);
+  }
+  ht.BulkLoad(nullptr, more);
+  std::vector<int> res;
+  ht.GetValue(nullptr, 3250, &res);
+  ASSERT_EQ(1u, res.size());
+  EXPECT_EQ(6500, res[0]);
+  res.clear();
+  ht.GetValue(nullptr, 1234, &res);
+  ASSERT_EQ(1u, res.size());
+  EXPECT_EQ(2468, res[0]);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_StatsTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  HashTableStats stats;
+  ht.GetStats(&stats);
+  EXPECT_EQ(ht.GetSize(), stats.num_slots);
+  EXPECT_EQ(0u, stats.num_readable);
+  EXPECT_EQ(0u, stats.num_tombstones);
+  EXPECT_DOUBLE_EQ(0.0, stats.LoadFactor());
+
+  for (int i = 0; i < 500; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.GetStats(&stats);
+  EXPECT_EQ(500u, stats.num_readable);
+  EXPECT_EQ(0u, stats.num_tombstones);
+  EXPECT_DOUBLE_EQ(500.0 / stats.num_slots, stats.LoadFactor());
+  // every insert probed, so the histogram holds at least one entry per insert
+  size_t recorded = 0;
+  for (size_t bucket : stats.probe_lengths) {
+    recorded += bucket;
+  }
+  EXPECT_GE(recorded, 500u);
+
+  // removes turn live slots into tombstones
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.GetStats(&stats);
+  EXPECT_EQ(400u, stats.num_readable);
+  EXPECT_EQ(100u, stats.num_tombstones);
+
+  // a failed remove changes nothing
+  EXPECT_FALSE(ht.Remove(nullptr, 0, 0));
+  ht.GetStats(&stats);
+  EXPECT_EQ(400u, stats.num_readable);
+  EXPECT_EQ(100u, stats.num_tombstones);
+
+  // growing the table starts the new layout tombstone-free
+  ht.Resize(ht.GetSize());
+  ht.GetStats(&stats);
+  EXPECT_EQ(400u, stats.num_readable);
+  EXPECT_EQ(0u, stats.num_tombstones);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_CompactionTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+  size_t slots = ht.GetSize();
+
+  // hold compaction off while churning, so the tombstones pile up
+  ht.SetCompactionThreshold(2.0);
+  for (int i = 0; i < 600; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 0; i < 300; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  HashTableStats stats;
+  ht.GetStats(&stats);
+  EXPECT_EQ(300u, stats.num_readable);
+  EXPECT_EQ(300u, stats.num_tombstones);
+
+  // the next remove crosses the lowered threshold and schedules compaction
+  ht.SetCompactionThreshold(0.1);
+  EXPECT_TRUE(ht.Remove(nullptr, 300, 300));
+  // each insert migrates one old block; a handful finishes the table
+  for (int i = 700; i < 710; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+
+  // the tombstones are gone, the table did not grow, and every live pair survived
+  ht.GetStats(&stats);
+  EXPECT_EQ(0u, stats.num_tombstones);
+  EXPECT_EQ(309u, stats.num_readable);
+  EXPECT_EQ(slots, ht.GetSize());
+  for (int i = 0; i < 301; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(0u, res.size()) << "Found removed key " << i;
+  }
+  for (int i = 301; i < 600; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1u, res.size()) << "Lost key " << i;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -13,6 +13,7 @@
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -21,16 +22,29 @@
 #include "catalog/table_generator.h"
 #include "concurrency/transaction_manager.h"
 #include "execution/executor_context.h"
+#include "execution/executor_cache.h"
 #include "execution/executor_factory.h"
 #include "execution/executors/aggregation_executor.h"
 #include "execution/executors/hash_join_executor.h"
 #include "execution/executors/insert_executor.h"
+#include "execution/executors/sort_merge_join_executor.h"
+#include "execution/executors/stats_executor.h"
 #include "execution/expressions/aggregate_value_expression.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/plan_optimizer.h"
+#include "execution/result_cursor.h"
+#include "execution/plans/delete_plan.h"
+#include "execution/plans/index_scan_plan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/update_plan.h"
+#include "execution/plans/exchange_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/sort_merge_join_plan.h"
+#include "execution/plans/sort_plan.h"
 #include "gtest/gtest.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -148,6 +162,232 @@ TEST_F(ExecutorTest, DISABLED_SimpleSeqScanTest) {
   ASSERT_EQ(num_tuples, 500);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_SkewedTableTest) {
+  // SELECT colB, colC FROM test_skew -- the fixture's distributions, not a particular query
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_skew");
+  ASSERT_NE(table_info, nullptr);
+  Schema &schema = table_info->schema_;
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *colC = MakeColumnValueExpression(schema, 0, "colC");
+  auto *out_schema = MakeOutputSchema({{"colB", colB}, {"colC", colC}});
+
+  SeqScanPlanNode plan{out_schema, nullptr, table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  Tuple tuple;
+  uint32_t num_tuples = 0;
+  std::unordered_map<int32_t, uint32_t> b_freq;
+  uint32_t c_adjacent_dups = 0;
+  int32_t c_prev = -1;
+  while (executor->Next(&tuple)) {
+    int32_t b = tuple.GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<int32_t>();
+    int32_t c = tuple.GetValue(out_schema, out_schema->GetColIdx("colC")).GetAs<int32_t>();
+    ASSERT_GE(b, 0);
+    ASSERT_LE(b, 9);
+    b_freq[b]++;
+    if (num_tuples > 0 && c == c_prev) {
+      c_adjacent_dups++;
+    }
+    c_prev = c;
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, TEST1_SIZE);
+  // Zipf_99 over ten values puts roughly a third of the rows on the hottest one; a uniform
+  // column would put a tenth there. Assert well between the two so the check is not flaky.
+  uint32_t max_freq = 0;
+  for (const auto &[value, freq] : b_freq) {
+    max_freq = std::max(max_freq, freq);
+  }
+  ASSERT_GE(max_freq, TEST1_SIZE / 5);
+  // Cluster runs of sixteen make almost every adjacent pair a duplicate.
+  ASSERT_GE(c_adjacent_dups, TEST1_SIZE * 3 / 4);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_SharedScanTest) {
+  // Two concurrent full scans of test_1: the second attaches to the first's sweep mid-chain,
+  // wraps at the tail, and must still produce every row exactly once.
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+  SeqScanPlanNode plan{out_schema, nullptr, table_info->oid_};
+
+  auto leader = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  leader->Init();
+  Tuple tuple;
+  uint32_t leader_rows = 0;
+  // Pull the leader well into the chain so the attacher starts on a later page.
+  for (; leader_rows < TEST1_SIZE / 2; leader_rows++) {
+    ASSERT_TRUE(leader->Next(&tuple));
+  }
+
+  auto attacher = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  attacher->Init();
+  std::vector<bool> seen(TEST1_SIZE, false);
+  uint32_t attacher_rows = 0;
+  while (attacher->Next(&tuple)) {
+    auto a = tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>();
+    ASSERT_FALSE(seen[a]);
+    seen[a] = true;
+    attacher_rows++;
+  }
+  ASSERT_EQ(attacher_rows, TEST1_SIZE);
+
+  // The leader's own sweep is unaffected by the rider.
+  while (leader->Next(&tuple)) {
+    leader_rows++;
+  }
+  ASSERT_EQ(leader_rows, TEST1_SIZE);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_ParallelSeqScanTest) {
+  // SELECT colA, colB FROM test_1 WHERE colA < 500, scanned in parallel over morsels
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+  auto *predicate = MakeComparisonExpression(colA, const500, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_, /*parallel=*/true};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  Tuple tuple;
+  uint32_t num_tuples = 0;
+  while (executor->Next(&tuple)) {
+    ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>() < 500);
+    ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<int32_t>() < 10);
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, 500);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_ResultCursorTest) {
+  // SELECT colA, colB FROM test_1 WHERE colA < 500, streamed through a cursor
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+  auto *predicate = MakeComparisonExpression(colA, const500, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+
+  // A one-batch ring keeps the producer in lockstep with the consumer, so every handoff
+  // exercises the backpressure path.
+  {
+    ResultCursor cursor(GetExecutorContext(), &plan, 1);
+    Tuple tuple;
+    uint32_t num_tuples = 0;
+    while (cursor.Next(&tuple)) {
+      ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>() < 500);
+      num_tuples++;
+    }
+    ASSERT_EQ(num_tuples, 500);
+    // an exhausted cursor stays exhausted
+    ASSERT_FALSE(cursor.Next(&tuple));
+  }
+
+  // Abandoning a cursor mid-stream must stop the producer cleanly rather than buffer the rest.
+  {
+    ResultCursor cursor(GetExecutorContext(), &plan, 1);
+    Tuple tuple;
+    for (int i = 0; i < 10; i++) {
+      ASSERT_TRUE(cursor.Next(&tuple));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_ExchangeTest) {
+  // SELECT colA, colB FROM test_1 WHERE colA < 500, with the scan running as its own
+  // pipeline stage behind an exchange
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+  auto *predicate = MakeComparisonExpression(colA, const500, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode scan_plan{out_schema, predicate, table_info->oid_};
+  ExchangePlanNode exchange_plan{out_schema, &scan_plan};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &exchange_plan);
+  executor->Init();
+  Tuple tuple;
+  uint32_t num_tuples = 0;
+  while (executor->Next(&tuple)) {
+    ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>() < 500);
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, 500);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_PreparedExecutorTest) {
+  // SELECT COUNT(colA) FROM test_1, executed twice through the executor cache
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *scan_schema = MakeOutputSchema({{"colA", colA}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto *count_a = MakeAggregateValueExpression(false, 0);
+  auto *agg_schema = MakeOutputSchema({{"count_a", count_a}});
+  AggregationPlanNode agg_plan{agg_schema,
+                               &scan_plan,
+                               nullptr,
+                               {},
+                               {colA},
+                               {AggregationType::CountAggregate}};
+
+  ExecutorCache cache;
+  AbstractExecutor *first = cache.GetExecutor(GetExecutorContext(), &agg_plan);
+  AbstractExecutor *second = cache.GetExecutor(GetExecutorContext(), &agg_plan);
+  // Same plan, same prepared executor.
+  ASSERT_EQ(first, second);
+  // Re-running through Init() must not leak state from the previous execution.
+  for (int run = 0; run < 2; run++) {
+    first->Init();
+    Tuple tuple;
+    ASSERT_TRUE(first->Next(&tuple));
+    ASSERT_EQ(tuple.GetValue(agg_schema, agg_schema->GetColIdx("count_a")).GetAs<int32_t>(), TEST1_SIZE);
+    ASSERT_FALSE(first->Next(&tuple));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_ExecutorStatsTest) {
+  // SELECT colA, colB FROM test_1 WHERE colA < 500, then inspect the runtime counters
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+  auto *predicate = MakeComparisonExpression(colA, const500, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  Tuple tuple;
+  while (executor->Next(&tuple)) {
+  }
+
+  const auto &all_stats = GetExecutorContext()->GetExecutorStats();
+  ASSERT_EQ(all_stats.size(), 1);
+  const ExecutorStats &stats = *all_stats[0];
+  ASSERT_EQ(stats.name_, "SeqScan");
+  ASSERT_EQ(stats.rows_out_, 500);
+  // One call per produced row plus the final call that returns false.
+  ASSERT_EQ(stats.next_calls_, 501);
+  ASSERT_GT(stats.cycles_, 0);
+  ASSERT_GT(stats.pool_fetches_, 0);
+  ASSERT_FALSE(GetExecutorContext()->ReportStats().empty());
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, DISABLED_SimpleRawInsertTest) {
   // INSERT INTO empty_table2 VALUES (100, 10), (101, 11), (102, 12)
@@ -253,6 +493,68 @@ TEST_F(ExecutorTest, DISABLED_SimpleSelectInsertTest) {
   ASSERT_EQ(num_tuples, 500);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_SimpleDeleteTest) {
+  // DELETE FROM test_1 WHERE colA < 50
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto const50 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(50));
+  auto predicate = MakeComparisonExpression(colA, const50, ComparisonType::LessThan);
+  auto out_schema = MakeOutputSchema({{"colA", colA}});
+  SeqScanPlanNode scan_plan{out_schema, predicate, table_info->oid_};
+  DeletePlanNode delete_plan{&scan_plan, table_info->oid_};
+  auto delete_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &delete_plan);
+  delete_executor->Init();
+  ASSERT_TRUE(delete_executor->Next(nullptr));
+
+  // SELECT colA FROM test_1: the 50 deleted rows are gone, the rest remain.
+  SeqScanPlanNode verify_plan{out_schema, nullptr, table_info->oid_};
+  auto scan_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &verify_plan);
+  scan_executor->Init();
+  Tuple tuple;
+  int num_tuples = 0;
+  while (scan_executor->Next(&tuple)) {
+    ASSERT_GE(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>(), 50);
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, TEST1_SIZE - 50);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_SimpleUpdateTest) {
+  // UPDATE test_1 SET colB = 777, colA = colA + 10000 WHERE colA < 50
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto const50 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(50));
+  auto predicate = MakeComparisonExpression(colA, const50, ComparisonType::LessThan);
+  auto out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode scan_plan{out_schema, predicate, table_info->oid_};
+  std::unordered_map<uint32_t, UpdateInfo> update_attrs;
+  update_attrs.emplace(schema.GetColIdx("colA"), UpdateInfo{UpdateType::Add, 10000});
+  update_attrs.emplace(schema.GetColIdx("colB"), UpdateInfo{UpdateType::Set, 777});
+  UpdatePlanNode update_plan{&scan_plan, table_info->oid_, std::move(update_attrs)};
+  auto update_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &update_plan);
+  update_executor->Init();
+  ASSERT_TRUE(update_executor->Next(nullptr));
+
+  // SELECT colA, colB FROM test_1 WHERE colA >= 10000: exactly the 50 updated rows.
+  auto const10000 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(10000));
+  auto verify_predicate = MakeComparisonExpression(colA, const10000, ComparisonType::GreaterThanOrEqual);
+  SeqScanPlanNode verify_plan{out_schema, verify_predicate, table_info->oid_};
+  auto scan_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &verify_plan);
+  scan_executor->Init();
+  Tuple tuple;
+  int num_tuples = 0;
+  while (scan_executor->Next(&tuple)) {
+    ASSERT_EQ(tuple.GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<int32_t>(), 777);
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, 50);
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, DISABLED_SimpleHashJoinTest) {
   // INSERT INTO empty_table2 SELECT colA, colB FROM test_1 WHERE colA < 500
@@ -310,6 +612,167 @@ TEST_F(ExecutorTest, DISABLED_SimpleHashJoinTest) {
   ASSERT_EQ(num_tuples, 100);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_SortMergeJoinTest) {
+  // SELECT colA, colB, col1, col2 FROM test_1 JOIN test_2 ON colA = col1, with both sides
+  // sorted on the key so the join is a streaming merge.
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col2 = MakeColumnValueExpression(schema, 0, "col2");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<SortPlanNode> sort_plan1;
+  std::unique_ptr<SortPlanNode> sort_plan2;
+  {
+    auto sortA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto sort1 = MakeColumnValueExpression(*out_schema2, 0, "col1");
+    sort_plan1 = std::make_unique<SortPlanNode>(out_schema1, scan_plan1.get(),
+                                                std::vector<const AbstractExpression *>{sortA});
+    sort_plan2 = std::make_unique<SortPlanNode>(out_schema2, scan_plan2.get(),
+                                                std::vector<const AbstractExpression *>{sort1});
+  }
+  std::unique_ptr<SortMergeJoinPlanNode> join_plan;
+  const Schema *out_final;
+  {
+    auto colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+    auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+    auto col2 = MakeColumnValueExpression(*out_schema2, 1, "col2");
+    std::vector<const AbstractExpression *> left_keys{colA};
+    std::vector<const AbstractExpression *> right_keys{col1};
+    out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}, {"col2", col2}});
+    join_plan = std::make_unique<SortMergeJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{sort_plan1.get(), sort_plan2.get()}, nullptr,
+        std::move(left_keys), std::move(right_keys));
+  }
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), join_plan.get());
+  executor->Init();
+  Tuple tuple;
+  uint32_t num_tuples = 0;
+  int32_t prev_key = -1;
+  while (executor->Next(&tuple)) {
+    auto a = tuple.GetValue(out_final, out_final->GetColIdx("colA")).GetAs<int32_t>();
+    auto key = static_cast<int32_t>(tuple.GetValue(out_final, out_final->GetColIdx("col1")).GetAs<int16_t>());
+    ASSERT_EQ(a, key);
+    // The merge emits in key order.
+    ASSERT_GE(key, prev_key);
+    prev_key = key;
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, 100);
+
+  // A hash join whose children already deliver the keys in order is upgraded to the same
+  // streaming merge by the factory — no hash table is built.
+  std::unique_ptr<HashJoinPlanNode> hash_plan;
+  {
+    auto colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+    std::vector<const AbstractExpression *> left_keys{colA};
+    std::vector<const AbstractExpression *> right_keys{col1};
+    hash_plan = std::make_unique<HashJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{sort_plan1.get(), sort_plan2.get()}, nullptr,
+        std::move(left_keys), std::move(right_keys));
+  }
+  ASSERT_TRUE(SortMergeJoinExecutor::CanMerge(hash_plan.get()));
+  auto upgraded = ExecutorFactory::CreateExecutor(GetExecutorContext(), hash_plan.get());
+  ASSERT_NE(dynamic_cast<SortMergeJoinExecutor *>(StatsExecutor::Unwrap(upgraded.get())), nullptr);
+  upgraded->Init();
+  num_tuples = 0;
+  while (upgraded->Next(&tuple)) {
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, 100);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_FusedJoinAggregationTest) {
+  // SELECT colA, COUNT(colB) FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1 GROUP BY colA;
+  // grouping on the join key, so the factory fuses the aggregation into the join
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col2 = MakeColumnValueExpression(schema, 0, "col2");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<HashJoinPlanNode> join_plan;
+  const Schema *out_final;
+  const AbstractExpression *colA;
+  const AbstractExpression *colB;
+  {
+    colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+    auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+    auto col2 = MakeColumnValueExpression(*out_schema2, 1, "col2");
+    std::vector<const AbstractExpression *> left_keys{colA};
+    std::vector<const AbstractExpression *> right_keys{col1};
+    auto predicate = MakeComparisonExpression(colA, col1, ComparisonType::Equal);
+    out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}, {"col2", col2}});
+    join_plan = std::make_unique<HashJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, predicate,
+        std::move(left_keys), std::move(right_keys));
+  }
+  std::unique_ptr<AggregationPlanNode> agg_plan;
+  const Schema *agg_schema;
+  {
+    const AbstractExpression *groupbyA = MakeAggregateValueExpression(true, 0);
+    const AbstractExpression *countB = MakeAggregateValueExpression(false, 0);
+    agg_schema = MakeOutputSchema({{"colA", groupbyA}, {"countB", countB}});
+    agg_plan = std::make_unique<AggregationPlanNode>(agg_schema, join_plan.get(), nullptr,
+                                                     std::vector<const AbstractExpression *>{colA},
+                                                     std::vector<const AbstractExpression *>{colB},
+                                                     std::vector<AggregationType>{AggregationType::CountAggregate});
+  }
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), agg_plan.get());
+  executor->Init();
+  Tuple tuple;
+  uint32_t num_groups = 0;
+  while (executor->Next(&tuple)) {
+    // Every test_1 key joins at most one test_2 row, so each surviving group counts one row.
+    ASSERT_EQ(tuple.GetValue(agg_schema, agg_schema->GetColIdx("countB")).GetAs<int32_t>(), 1);
+    num_groups++;
+  }
+  ASSERT_EQ(num_groups, 100);
+
+  // The fused pair registers a single Aggregation profile; the join is folded into it.
+  // Children register before their parent, so the scans come first.
+  const auto &all_stats = GetExecutorContext()->GetExecutorStats();
+  ASSERT_EQ(all_stats.size(), 3);
+  ASSERT_EQ(all_stats[0]->name_, "SeqScan");
+  ASSERT_EQ(all_stats[1]->name_, "SeqScan");
+  ASSERT_EQ(all_stats[2]->name_, "Aggregation");
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, DISABLED_SimpleAggregationTest) {
   // SELECT COUNT(colA), SUM(colA), min(colA), max(colA) from test_1;
@@ -423,4 +886,713 @@ TEST_F(ExecutorTest, DISABLED_SimpleGroupByAggregation) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_AggregationSpillTest) {
+  // SELECT colA, count(colB) FROM test_1 GROUP BY colA, with a group budget small enough that
+  // the 1000 distinct colA groups spill to temp space and are merged back per partition.
+  GetExecutorContext()->SetAggregationGroupBudget(100);
+  std::unique_ptr<AbstractPlanNode> scan_plan;
+  const Schema *scan_schema;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    scan_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan = std::make_unique<SeqScanPlanNode>(scan_schema, nullptr, table_info->oid_);
+  }
+
+  std::unique_ptr<AbstractPlanNode> agg_plan;
+  const Schema *agg_schema;
+  {
+    const AbstractExpression *colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    const AbstractExpression *colB = MakeColumnValueExpression(*scan_schema, 0, "colB");
+    std::vector<const AbstractExpression *> group_by_cols{colA};
+    const AbstractExpression *groupbyA = MakeAggregateValueExpression(true, 0);
+    std::vector<const AbstractExpression *> aggregate_cols{colB};
+    std::vector<AggregationType> agg_types{AggregationType::CountAggregate};
+    const AbstractExpression *countB = MakeAggregateValueExpression(false, 0);
+    agg_schema = MakeOutputSchema({{"colA", groupbyA}, {"countB", countB}});
+    agg_plan = std::make_unique<AggregationPlanNode>(agg_schema, scan_plan.get(), nullptr, std::move(group_by_cols),
+                                                     std::move(aggregate_cols), std::move(agg_types));
+  }
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), agg_plan.get());
+  executor->Init();
+  Tuple tuple;
+
+  // colA is unique in test_1, so every group must come back exactly once with a count of one.
+  std::unordered_set<int32_t> encountered;
+  while (executor->Next(&tuple)) {
+    auto a = tuple.GetValue(agg_schema, agg_schema->GetColIdx("colA")).GetAs<int32_t>();
+    ASSERT_EQ(encountered.count(a), 0);
+    encountered.insert(a);
+    ASSERT_TRUE(0 <= a && a < static_cast<int32_t>(TEST1_SIZE));
+    ASSERT_EQ(tuple.GetValue(agg_schema, agg_schema->GetColIdx("countB")).GetAs<int32_t>(), 1);
+  }
+  ASSERT_EQ(encountered.size(), TEST1_SIZE);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_ParallelAggregationTest) {
+  // SELECT COUNT(colA), SUM(colA), min(colA), max(colA) from test_1, aggregated in parallel;
+  std::unique_ptr<AbstractPlanNode> scan_plan;
+  const Schema *scan_schema;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    scan_schema = MakeOutputSchema({{"colA", colA}});
+    scan_plan = std::make_unique<SeqScanPlanNode>(scan_schema, nullptr, table_info->oid_);
+  }
+
+  std::unique_ptr<AbstractPlanNode> agg_plan;
+  const Schema *agg_schema;
+  {
+    const AbstractExpression *colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    const AbstractExpression *countA = MakeAggregateValueExpression(false, 0);
+    const AbstractExpression *sumA = MakeAggregateValueExpression(false, 1);
+    const AbstractExpression *minA = MakeAggregateValueExpression(false, 2);
+    const AbstractExpression *maxA = MakeAggregateValueExpression(false, 3);
+
+    agg_schema = MakeOutputSchema({{"countA", countA}, {"sumA", sumA}, {"minA", minA}, {"maxA", maxA}});
+    agg_plan = std::make_unique<AggregationPlanNode>(
+        agg_schema, scan_plan.get(), nullptr, std::vector<const AbstractExpression *>{},
+        std::vector<const AbstractExpression *>{colA, colA, colA, colA},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                     AggregationType::MinAggregate, AggregationType::MaxAggregate},
+        /*parallel=*/true);
+  }
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), agg_plan.get());
+  executor->Init();
+  Tuple tuple;
+  ASSERT_TRUE(executor->Next(&tuple));
+  auto countA_val = tuple.GetValue(agg_schema, agg_schema->GetColIdx("countA")).GetAs<int32_t>();
+  auto sumA_val = tuple.GetValue(agg_schema, agg_schema->GetColIdx("sumA")).GetAs<int32_t>();
+  auto minA_val = tuple.GetValue(agg_schema, agg_schema->GetColIdx("minA")).GetAs<int32_t>();
+  auto maxA_val = tuple.GetValue(agg_schema, agg_schema->GetColIdx("maxA")).GetAs<int32_t>();
+  // The merged partial aggregates must equal the single-threaded result.
+  ASSERT_EQ(countA_val, TEST1_SIZE);
+  ASSERT_EQ(sumA_val, TEST1_SIZE * (TEST1_SIZE - 1) / 2);
+  ASSERT_EQ(minA_val, 0);
+  ASSERT_EQ(maxA_val, TEST1_SIZE - 1);
+  ASSERT_FALSE(executor->Next(&tuple));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_SortTest) {
+  // SELECT colA, colB FROM test_1 ORDER BY colB, colA DESC, with a buffer small enough to force
+  // spilled runs and an external merge.
+  std::unique_ptr<AbstractPlanNode> scan_plan;
+  const Schema *scan_schema;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    scan_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan = std::make_unique<SeqScanPlanNode>(scan_schema, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<SortPlanNode> sort_plan;
+  {
+    auto colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(*scan_schema, 0, "colB");
+    sort_plan = std::make_unique<SortPlanNode>(scan_schema, scan_plan.get(),
+                                               std::vector<const AbstractExpression *>{colB, colA},
+                                               std::vector<bool>{false, true}, /*buffer_capacity=*/128);
+  }
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), sort_plan.get());
+  executor->Init();
+  Tuple tuple;
+  uint32_t num_tuples = 0;
+  int32_t prev_a = 0;
+  int32_t prev_b = -1;
+  while (executor->Next(&tuple)) {
+    auto a = tuple.GetValue(scan_schema, scan_schema->GetColIdx("colA")).GetAs<int32_t>();
+    auto b = tuple.GetValue(scan_schema, scan_schema->GetColIdx("colB")).GetAs<int32_t>();
+    // colB ascending; within equal colB, colA descending.
+    ASSERT_GE(b, prev_b);
+    if (b == prev_b) {
+      ASSERT_LT(a, prev_a);
+    }
+    prev_a = a;
+    prev_b = b;
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, TEST1_SIZE);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_TopNTest) {
+  // SELECT colA FROM test_1 ORDER BY colA DESC LIMIT 50, fused into a bounded-heap Top-N.
+  std::unique_ptr<AbstractPlanNode> scan_plan;
+  const Schema *scan_schema;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    scan_schema = MakeOutputSchema({{"colA", colA}});
+    scan_plan = std::make_unique<SeqScanPlanNode>(scan_schema, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<SortPlanNode> sort_plan;
+  {
+    auto colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    sort_plan = std::make_unique<SortPlanNode>(scan_schema, scan_plan.get(),
+                                               std::vector<const AbstractExpression *>{colA},
+                                               std::vector<bool>{true});
+  }
+  auto limit_plan = std::make_unique<LimitPlanNode>(scan_schema, sort_plan.get(), 50);
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), limit_plan.get());
+  executor->Init();
+  Tuple tuple;
+  uint32_t num_tuples = 0;
+  int32_t expected = TEST1_SIZE - 1;
+  while (executor->Next(&tuple)) {
+    // colA is 0..TEST1_SIZE-1, so the top 50 descending are TEST1_SIZE-1 down to TEST1_SIZE-50.
+    ASSERT_EQ(tuple.GetValue(scan_schema, scan_schema->GetColIdx("colA")).GetAs<int32_t>(), expected);
+    expected--;
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, 50);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_IndexRangeScanTest) {
+  // SELECT colA FROM test_1 WHERE colA BETWEEN 100 AND 399, through a B+ tree index on colA
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+
+  // build the index over the generated table; colA is serial, so keys are 0..999
+  auto *metadata = new IndexMetadata("index_colA", "test_1", &schema, {0});
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(metadata, GetExecutorContext()->GetBufferPoolManager());
+  for (auto it = table_info->table_->Begin(GetExecutorContext()->GetTransaction()); it != table_info->table_->End();
+       ++it) {
+    std::vector<Value> key_values{it->GetValue(&schema, 0)};
+    Tuple key(key_values, metadata->GetKeySchema());
+    index.InsertEntry(key, it->GetRid(), GetExecutorContext()->GetTransaction());
+  }
+
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+  std::vector<const AbstractExpression *> low_keys{MakeConstantValueExpression(ValueFactory::GetIntegerValue(100))};
+  std::vector<const AbstractExpression *> high_keys{MakeConstantValueExpression(ValueFactory::GetIntegerValue(399))};
+  IndexScanPlanNode plan(out_schema, nullptr, table_info->oid_, &index, std::move(low_keys), std::move(high_keys));
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  Tuple tuple;
+  int32_t expected = 100;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(expected, tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+    expected++;
+  }
+  ASSERT_EQ(400, expected);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_CatalogIndexMaintenanceTest) {
+  // an index created through the catalog is backfilled, then kept current by inserts
+  Column col_a{"colA", TypeId::INTEGER};
+  Column col_b{"colB", TypeId::INTEGER};
+  std::vector<Column> cols{col_a, col_b};
+  Schema idx_schema{cols};
+  SimpleCatalog *catalog = GetExecutorContext()->GetCatalog();
+  TableMetadata *table_info =
+      catalog->CreateTable(GetExecutorContext()->GetTransaction(), "index_t", idx_schema);
+
+  // 100 pre-existing rows, picked up by the backfill
+  std::vector<std::vector<Value>> raw_vals;
+  for (int32_t i = 0; i < 100; i++) {
+    raw_vals.push_back({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i * 2)});
+  }
+  InsertPlanNode insert_plan{std::move(raw_vals), table_info->oid_};
+  auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->Next(nullptr));
+
+  IndexInfo *index_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetExecutorContext()->GetTransaction(), "index_colA", "index_t", {0});
+  ASSERT_NE(index_info, nullptr);
+  ASSERT_EQ(index_info, catalog->GetIndex("index_colA", "index_t"));
+  ASSERT_EQ(index_info, catalog->GetIndex(index_info->oid_));
+  ASSERT_EQ(1U, catalog->GetTableIndexes("index_t").size());
+
+  // 100 more rows after index creation, picked up by the heap's write-path maintenance
+  std::vector<std::vector<Value>> more_vals;
+  for (int32_t i = 100; i < 200; i++) {
+    more_vals.push_back({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i * 2)});
+  }
+  InsertPlanNode more_plan{std::move(more_vals), table_info->oid_};
+  auto more_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &more_plan);
+  more_executor->Init();
+  ASSERT_TRUE(more_executor->Next(nullptr));
+
+  // SELECT colA FROM index_t WHERE colA BETWEEN 50 AND 149, through the maintained index
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+  std::vector<const AbstractExpression *> low_keys{MakeConstantValueExpression(ValueFactory::GetIntegerValue(50))};
+  std::vector<const AbstractExpression *> high_keys{MakeConstantValueExpression(ValueFactory::GetIntegerValue(149))};
+  IndexScanPlanNode plan(out_schema, nullptr, table_info->oid_, index_info->index_.get(), std::move(low_keys),
+                         std::move(high_keys));
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  Tuple tuple;
+  int32_t expected = 50;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(expected, tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+    expected++;
+  }
+  ASSERT_EQ(150, expected);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_CatalogIndexKeyWidthTest) {
+  // the width-dispatching CreateIndex overload picks the GenericKey specialization from the
+  // key schema's byte length; the resulting index must behave exactly like an explicit one
+  Column col_a{"colA", TypeId::INTEGER};
+  Column col_b{"colB", TypeId::BIGINT};
+  std::vector<Column> cols{col_a, col_b};
+  Schema idx_schema{cols};
+  SimpleCatalog *catalog = GetExecutorContext()->GetCatalog();
+  TableMetadata *table_info =
+      catalog->CreateTable(GetExecutorContext()->GetTransaction(), "width_t", idx_schema);
+
+  std::vector<std::vector<Value>> raw_vals;
+  for (int32_t i = 0; i < 100; i++) {
+    raw_vals.push_back({ValueFactory::GetIntegerValue(i), ValueFactory::GetBigIntValue(i * 10)});
+  }
+  InsertPlanNode insert_plan{std::move(raw_vals), table_info->oid_};
+  auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->Next(nullptr));
+
+  // a 4-byte key and a 12-byte composite key land in different specializations
+  IndexInfo *narrow_info =
+      catalog->CreateIndex(GetExecutorContext()->GetTransaction(), "width_colA", "width_t", {0});
+  IndexInfo *wide_info =
+      catalog->CreateIndex(GetExecutorContext()->GetTransaction(), "width_colAB", "width_t", {0, 1});
+  ASSERT_NE(narrow_info, nullptr);
+  ASSERT_NE(wide_info, nullptr);
+  ASSERT_EQ(2U, catalog->GetTableIndexes("width_t").size());
+
+  // SELECT colA FROM width_t WHERE colA BETWEEN 20 AND 79, through the narrow index
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+  std::vector<const AbstractExpression *> low_keys{MakeConstantValueExpression(ValueFactory::GetIntegerValue(20))};
+  std::vector<const AbstractExpression *> high_keys{MakeConstantValueExpression(ValueFactory::GetIntegerValue(79))};
+  IndexScanPlanNode plan(out_schema, nullptr, table_info->oid_, narrow_info->index_.get(), std::move(low_keys),
+                         std::move(high_keys));
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  Tuple tuple;
+  int32_t expected = 20;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(expected, tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+    expected++;
+  }
+  ASSERT_EQ(80, expected);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_NullScreenedScanTest) {
+  // a decimal comparison keeps the interpreted Evaluate, so its rows go through the validity
+  // pre-screen; mostly-null columns must filter to exactly the present, passing values
+  Column col_a{"colA", TypeId::INTEGER};
+  Column col_b{"colB", TypeId::DECIMAL};
+  std::vector<Column> cols{col_a, col_b};
+  Schema null_schema{cols};
+  SimpleCatalog *catalog = GetExecutorContext()->GetCatalog();
+  TableMetadata *table_info =
+      catalog->CreateTable(GetExecutorContext()->GetTransaction(), "null_t", null_schema);
+
+  // colB is present on every tenth row only
+  std::vector<std::vector<Value>> raw_vals;
+  for (int32_t i = 0; i < 200; i++) {
+    Value b = i % 10 == 0 ? ValueFactory::GetDecimalValue(static_cast<double>(i))
+                          : ValueFactory::GetNullValueByType(TypeId::DECIMAL);
+    raw_vals.push_back({ValueFactory::GetIntegerValue(i), b});
+  }
+  InsertPlanNode insert_plan{std::move(raw_vals), table_info->oid_};
+  auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->Next(nullptr));
+
+  // SELECT colA, colB FROM null_t WHERE colB >= 100.0
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const100 = MakeConstantValueExpression(ValueFactory::GetDecimalValue(100.0));
+  auto *predicate = MakeComparisonExpression(colB, const100, ComparisonType::GreaterThanOrEqual);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  Tuple tuple;
+  int32_t expected = 100;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(expected, tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+    ASSERT_EQ(static_cast<double>(expected),
+              tuple.GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<double>());
+    expected += 10;
+  }
+  ASSERT_EQ(200, expected);
+
+  // a comparison against a NULL constant screens out every row
+  auto *const_null = MakeConstantValueExpression(ValueFactory::GetNullValueByType(TypeId::DECIMAL));
+  auto *null_predicate = MakeComparisonExpression(colB, const_null, ComparisonType::Equal);
+  SeqScanPlanNode null_plan{out_schema, null_predicate, table_info->oid_};
+  auto null_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &null_plan);
+  null_executor->Init();
+  ASSERT_FALSE(null_executor->Next(&tuple));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_AnalyzeTest) {
+  // ANALYZE test_1: row count, per-column ranges, and distinct-count sketches land in the
+  // catalog next to the table's metadata
+  SimpleCatalog *catalog = GetExecutorContext()->GetCatalog();
+  TableMetadata *table_info = catalog->GetTable("test_1");
+  ASSERT_EQ(nullptr, catalog->GetStats(table_info->oid_));
+
+  const TableStats *stats = catalog->Analyze(GetExecutorContext()->GetTransaction(), table_info->oid_);
+  ASSERT_NE(stats, nullptr);
+  ASSERT_EQ(stats, catalog->GetStats(table_info->oid_));
+  ASSERT_EQ(table_info->schema_.GetColumnCount(), stats->columns_.size());
+
+  // test_1 is small enough that every page is sampled, so the row count is exact
+  ASSERT_EQ(TEST1_SIZE, stats->row_count_);
+
+  // colA is serial 0..999: exact range, estimated ndv within the sketch's error
+  const ColumnStats &col_a = stats->columns_[0];
+  ASSERT_EQ(0, col_a.min_.GetAs<int32_t>());
+  ASSERT_EQ(static_cast<int32_t>(TEST1_SIZE) - 1, col_a.max_.GetAs<int32_t>());
+  ASSERT_EQ(0U, col_a.null_count_);
+  ASSERT_GE(col_a.ndv_, TEST1_SIZE * 85 / 100);
+  ASSERT_LE(col_a.ndv_, TEST1_SIZE * 115 / 100);
+
+  // colB is uniform over 0..9: ten distinct values, well inside linear-counting range
+  const ColumnStats &col_b = stats->columns_[1];
+  ASSERT_EQ(0, col_b.min_.GetAs<int32_t>());
+  ASSERT_EQ(9, col_b.max_.GetAs<int32_t>());
+  ASSERT_GE(col_b.ndv_, 8U);
+  ASSERT_LE(col_b.ndv_, 12U);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_PlanOptimizerTest) {
+  // SELECT * FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1, planned with the large
+  // table on the build side; the optimizer swaps the children using ANALYZE statistics
+  SimpleCatalog *catalog = GetExecutorContext()->GetCatalog();
+  catalog->Analyze(GetExecutorContext()->GetTransaction(), catalog->GetTable("test_1")->oid_);
+  catalog->Analyze(GetExecutorContext()->GetTransaction(), catalog->GetTable("test_2")->oid_);
+
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = catalog->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = catalog->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col2 = MakeColumnValueExpression(schema, 0, "col2");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<HashJoinPlanNode> join_plan;
+  const Schema *out_final;
+  {
+    auto colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+    auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+    auto col2 = MakeColumnValueExpression(*out_schema2, 1, "col2");
+    std::vector<const AbstractExpression *> left_keys{colA};
+    std::vector<const AbstractExpression *> right_keys{col1};
+    auto predicate = MakeComparisonExpression(colA, col1, ComparisonType::Equal);
+    out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}, {"col2", col2}});
+    join_plan = std::make_unique<HashJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, predicate,
+        std::move(left_keys), std::move(right_keys));
+  }
+
+  PlanOptimizer optimizer{catalog};
+  ASSERT_EQ(TEST1_SIZE, optimizer.EstimateCardinality(scan_plan1.get()));
+  ASSERT_EQ(TEST2_SIZE, optimizer.EstimateCardinality(scan_plan2.get()));
+
+  const AbstractPlanNode *optimized = optimizer.Optimize(join_plan.get());
+  ASSERT_NE(optimized, join_plan.get());
+  ASSERT_EQ(PlanType::HashJoin, optimized->GetType());
+  auto *optimized_join = static_cast<const HashJoinPlanNode *>(optimized);
+  ASSERT_EQ(scan_plan2.get(), optimized_join->GetLeftPlan());
+  ASSERT_EQ(scan_plan1.get(), optimized_join->GetRightPlan());
+
+  // The swapped plan still produces the same join: 100 rows with colA == col1
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), optimized);
+  executor->Init();
+  const Schema *result_schema = optimized->OutputSchema();
+  Tuple tuple;
+  uint32_t num_tuples = 0;
+  while (executor->Next(&tuple)) {
+    auto col_a = tuple.GetValue(result_schema, result_schema->GetColIdx("colA")).GetAs<int32_t>();
+    auto col_1 = tuple.GetValue(result_schema, result_schema->GetColIdx("col1")).GetAs<int16_t>();
+    ASSERT_EQ(col_a, col_1);
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, 100);
+
+  // A plan over unanalyzed tables passes through untouched
+  Column col_u{"colU", TypeId::INTEGER};
+  std::vector<Column> u_cols{col_u};
+  Schema u_schema{u_cols};
+  TableMetadata *plain = catalog->CreateTable(GetExecutorContext()->GetTransaction(), "no_stats_t", u_schema);
+  SeqScanPlanNode plain_scan{&u_schema, nullptr, plain->oid_};
+  ASSERT_EQ(PlanOptimizer::UNKNOWN_CARDINALITY, optimizer.EstimateCardinality(&plain_scan));
+  ASSERT_EQ(&plain_scan, optimizer.Optimize(&plain_scan));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_ZoneMapScanTest) {
+  // a zone map created through the catalog covers backfilled and later-inserted rows, and a
+  // pruned scan still returns exactly the matching rows
+  Column col_a{"colA", TypeId::INTEGER};
+  Column col_b{"colB", TypeId::INTEGER};
+  std::vector<Column> cols{col_a, col_b};
+  Schema zone_schema{cols};
+  SimpleCatalog *catalog = GetExecutorContext()->GetCatalog();
+  TableMetadata *table_info = catalog->CreateTable(GetExecutorContext()->GetTransaction(), "zone_t", zone_schema);
+
+  auto insert_rows = [&](int32_t from, int32_t to) {
+    std::vector<std::vector<Value>> vals;
+    for (int32_t i = from; i < to; i++) {
+      vals.push_back({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i % 7)});
+    }
+    InsertPlanNode insert_plan{std::move(vals), table_info->oid_};
+    auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+    insert_executor->Init();
+    ASSERT_TRUE(insert_executor->Next(nullptr));
+  };
+
+  // 500 pre-existing rows picked up by the backfill, 500 more by the write-path maintenance
+  insert_rows(0, 500);
+  ZoneMap *zone_map = catalog->CreateZoneMap(GetExecutorContext()->GetTransaction(), "zone_t", {0});
+  ASSERT_NE(zone_map, nullptr);
+  insert_rows(500, 1000);
+
+  // colA is appended in order, so the first page's range starts at 0
+  Value min;
+  Value max;
+  ASSERT_TRUE(zone_map->GetRange(table_info->table_->GetFirstPageId(), 0, &min, &max));
+  ASSERT_EQ(0, min.GetAs<int32_t>());
+
+  // SELECT colA FROM zone_t WHERE colA < 50; every page past the first few is pruned
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *const50 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(50));
+  auto *predicate = MakeComparisonExpression(colA, const50, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+
+  // Run the scan twice: the first walk primes the zone map's chain cache, the second prunes
+  // pages without fetching them. Both must see the same 50 rows.
+  for (int pass = 0; pass < 2; pass++) {
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+    executor->Init();
+    Tuple tuple;
+    uint32_t num_tuples = 0;
+    while (executor->Next(&tuple)) {
+      ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>() < 50);
+      num_tuples++;
+    }
+    ASSERT_EQ(50U, num_tuples);
+  }
+
+  // SELECT colA FROM zone_t WHERE colA >= 950 prunes from the other end
+  auto *const950 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(950));
+  auto *tail_predicate = MakeComparisonExpression(colA, const950, ComparisonType::GreaterThanOrEqual);
+  SeqScanPlanNode tail_plan{out_schema, tail_predicate, table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &tail_plan);
+  executor->Init();
+  Tuple tuple;
+  uint32_t num_tuples = 0;
+  while (executor->Next(&tuple)) {
+    ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>() >= 950);
+    num_tuples++;
+  }
+  ASSERT_EQ(50U, num_tuples);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_PaxSeqScanTest) {
+  // SELECT colA FROM pax_t WHERE colB = 5, over a PAX-layout table; the scan gathers only
+  // colA and colB out of the minipages and never touches colC
+  Column col_a{"colA", TypeId::INTEGER};
+  Column col_b{"colB", TypeId::INTEGER};
+  Column col_c{"colC", TypeId::BIGINT};
+  std::vector<Column> cols{col_a, col_b, col_c};
+  Schema pax_schema{cols};
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->CreateTable(
+      GetExecutorContext()->GetTransaction(), "pax_t", pax_schema, TableLayout::PAX);
+  for (int32_t i = 0; i < 1000; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i % 10),
+                              ValueFactory::GetBigIntValue(static_cast<int64_t>(i) * 1000)};
+    Tuple tuple(values, &table_info->schema_);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetExecutorContext()->GetTransaction()));
+  }
+
+  Schema &schema = table_info->schema_;
+  auto *col_a_expr = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b_expr = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const5 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(5));
+  auto *predicate = MakeComparisonExpression(col_b_expr, const5, ComparisonType::Equal);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a_expr}});
+
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  Tuple tuple;
+  int32_t expected = 5;
+  uint32_t num_tuples = 0;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(expected, tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+    expected += 10;
+    num_tuples++;
+  }
+  ASSERT_EQ(100u, num_tuples);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_PaxSimdFilterTest) {
+  // SELECT colA FROM pax_simd WHERE 500 > colB, over a PAX-layout table; the predicate is a
+  // single column-vs-constant comparison, so the scan filters whole minipages with the
+  // columnar kernel and the constant-on-the-left order exercises the mirrored operator
+  Column col_a{"colA", TypeId::INTEGER};
+  Column col_b{"colB", TypeId::BIGINT};
+  std::vector<Column> cols{col_a, col_b};
+  Schema pax_schema{cols};
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->CreateTable(
+      GetExecutorContext()->GetTransaction(), "pax_simd", pax_schema, TableLayout::PAX);
+  for (int32_t i = 0; i < 1000; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetBigIntValue(i)};
+    Tuple tuple(values, &table_info->schema_);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetExecutorContext()->GetTransaction()));
+  }
+
+  Schema &schema = table_info->schema_;
+  auto *col_a_expr = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b_expr = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const500 = MakeConstantValueExpression(ValueFactory::GetBigIntValue(500));
+  auto *predicate = MakeComparisonExpression(const500, col_b_expr, ComparisonType::GreaterThan);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a_expr}});
+
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  Tuple tuple;
+  uint32_t num_tuples = 0;
+  while (executor->Next(&tuple)) {
+    ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>() < 500);
+    num_tuples++;
+  }
+  ASSERT_EQ(500u, num_tuples);
+
+  // the parallel scan builds a selection bitmap per page inside each worker
+  SeqScanPlanNode parallel_plan{out_schema, predicate, table_info->oid_, /*parallel=*/true};
+  auto parallel_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &parallel_plan);
+  parallel_executor->Init();
+  num_tuples = 0;
+  while (parallel_executor->Next(&tuple)) {
+    ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>() < 500);
+    num_tuples++;
+  }
+  ASSERT_EQ(500u, num_tuples);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_DictionaryScanTest) {
+  // A table with a dictionary-encoded status column: inserts intern the strings, equality
+  // against a string constant runs as a code comparison, other predicate shapes filter on
+  // the decoded rows, and every scan decodes survivors back to strings on output
+  Column col_a{"colA", TypeId::INTEGER};
+  Column status{"status", TypeId::VARCHAR, 32};
+  std::vector<Column> cols{col_a, status};
+  Schema dict_schema{cols};
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->CreateTable(
+      GetExecutorContext()->GetTransaction(), "dict_table", dict_schema, TableLayout::ROW, {1});
+  // The storage schema holds codes where the declared schema holds strings.
+  ASSERT_EQ(TypeId::INTEGER, table_info->schema_.GetColumn(1).GetType());
+  ASSERT_EQ(TypeId::VARCHAR, table_info->logical_schema_.GetColumn(1).GetType());
+
+  // INSERT INTO dict_table VALUES (0, 'active'), (1, 'idle'), (2, 'failed'), (3, 'active'), ...
+  const std::vector<std::string> statuses{"active", "idle", "failed"};
+  std::vector<std::vector<Value>> raw_vals;
+  raw_vals.reserve(300);
+  for (int32_t i = 0; i < 300; i++) {
+    raw_vals.push_back({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(statuses[i % 3])});
+  }
+  InsertPlanNode insert_plan{std::move(raw_vals), table_info->oid_};
+  auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->Next(nullptr));
+  // 300 rows hold only three distinct strings; the dictionary interned each once.
+  ASSERT_EQ(3u, table_info->dictionaries_.at(1)->Size());
+
+  Schema &schema = table_info->logical_schema_;
+  auto *col_a_expr = MakeColumnValueExpression(schema, 0, "colA");
+  auto *status_expr = MakeColumnValueExpression(schema, 0, "status");
+  auto *out_schema = MakeOutputSchema({{"colA", col_a_expr}, {"status", status_expr}});
+
+  // SELECT colA, status FROM dict_table WHERE status = 'active' rewrites to a code comparison
+  auto *const_active = MakeConstantValueExpression(ValueFactory::GetVarcharValue("active"));
+  auto *eq_predicate = MakeComparisonExpression(status_expr, const_active, ComparisonType::Equal);
+  SeqScanPlanNode eq_plan{out_schema, eq_predicate, table_info->oid_};
+  auto eq_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &eq_plan);
+  eq_executor->Init();
+  Tuple tuple;
+  uint32_t num_tuples = 0;
+  while (eq_executor->Next(&tuple)) {
+    ASSERT_EQ("active", tuple.GetValue(out_schema, out_schema->GetColIdx("status")).ToString());
+    ASSERT_EQ(0, tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>() % 3);
+    num_tuples++;
+  }
+  ASSERT_EQ(100u, num_tuples);
+
+  // a string the dictionary has never seen matches nothing
+  auto *const_missing = MakeConstantValueExpression(ValueFactory::GetVarcharValue("missing"));
+  auto *miss_predicate = MakeComparisonExpression(status_expr, const_missing, ComparisonType::Equal);
+  SeqScanPlanNode miss_plan{out_schema, miss_predicate, table_info->oid_};
+  auto miss_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &miss_plan);
+  miss_executor->Init();
+  ASSERT_FALSE(miss_executor->Next(&tuple));
+
+  // WHERE status < 'idle' cannot compare codes (insertion order), so it filters decoded rows;
+  // 'active' and 'failed' sort below 'idle'
+  auto *const_idle = MakeConstantValueExpression(ValueFactory::GetVarcharValue("idle"));
+  auto *lt_predicate = MakeComparisonExpression(status_expr, const_idle, ComparisonType::LessThan);
+  SeqScanPlanNode lt_plan{out_schema, lt_predicate, table_info->oid_};
+  auto lt_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &lt_plan);
+  lt_executor->Init();
+  num_tuples = 0;
+  while (lt_executor->Next(&tuple)) {
+    ASSERT_NE("idle", tuple.GetValue(out_schema, out_schema->GetColIdx("status")).ToString());
+    num_tuples++;
+  }
+  ASSERT_EQ(200u, num_tuples);
+}
+
 }  // namespace bustub
@@ -19,7 +19,9 @@
 #include "concurrency/transaction_manager.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "recovery/log_receiver.h"
 #include "recovery/log_recovery.h"
+#include "storage/index/linear_probe_hash_table_index.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
@@ -121,6 +123,206 @@ TEST(RecoveryTest, DISABLED_RedoTest) {
   remove("test.log");
 }
 
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_IndexRedoTest) {
+  remove("test.db");
+  remove("test.log");
+
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+
+  ASSERT_FALSE(enable_logging);
+  bustub_instance->log_manager_->RunFlushThread();
+  ASSERT_TRUE(enable_logging);
+
+  Column key_col{"a", TypeId::BIGINT};
+  std::vector<Column> key_cols{key_col};
+  Schema key_schema{key_cols};
+  constexpr uint32_t index_oid = 7;
+
+  LOG_INFO("Build a logged index and mutate it under a committed txn");
+  auto *index = new LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      new IndexMetadata("index_redo", "t", &key_schema, {0}), bustub_instance->buffer_pool_manager_, 1000,
+      HashFunction<GenericKey<8>>(), bustub_instance->log_manager_, index_oid);
+
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  for (int64_t i = 0; i < 100; i++) {
+    Tuple key({Value(TypeId::BIGINT, i)}, &key_schema);
+    index->InsertEntry(key, RID(static_cast<page_id_t>(i), static_cast<uint32_t>(i)), txn);
+  }
+  for (int64_t i = 0; i < 100; i += 10) {
+    Tuple key({Value(TypeId::BIGINT, i)}, &key_schema);
+    index->DeleteEntry(key, RID(static_cast<page_id_t>(i), static_cast<uint32_t>(i)), txn);
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete index;
+
+  LOG_INFO("Shutdown System");
+  delete bustub_instance;
+
+  LOG_INFO("System restart...");
+  bustub_instance = new BustubInstance("test.db");
+  ASSERT_FALSE(enable_logging);
+
+  // A fresh, empty index stands in for the crashed one; replay is what fills it.
+  index = new LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      new IndexMetadata("index_redo2", "t", &key_schema, {0}), bustub_instance->buffer_pool_manager_, 1000,
+      HashFunction<GenericKey<8>>());
+
+  LOG_INFO("Begin recovery");
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery->RegisterIndex(index_oid, index);
+  log_recovery->Redo();
+  log_recovery->Undo();
+
+  LOG_INFO("Check if the index came back");
+  txn = bustub_instance->transaction_manager_->Begin();
+  for (int64_t i = 0; i < 100; i++) {
+    Tuple key({Value(TypeId::BIGINT, i)}, &key_schema);
+    std::vector<RID> result;
+    index->ScanKey(key, &result, txn);
+    if (i % 10 == 0) {
+      ASSERT_TRUE(result.empty());
+    } else {
+      ASSERT_EQ(1u, result.size());
+      ASSERT_EQ(RID(static_cast<page_id_t>(i), static_cast<uint32_t>(i)), result[0]);
+    }
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete index;
+  delete log_recovery;
+
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_BatchInsertRedoTest) {
+  remove("test.db");
+  remove("test.log");
+
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+
+  ASSERT_FALSE(enable_logging);
+  bustub_instance->log_manager_->RunFlushThread();
+  ASSERT_TRUE(enable_logging);
+
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+
+  // A batch spanning several pages; each page's run is covered by one INSERTBATCH record.
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 500; i++) {
+    tuples.push_back(ConstructTuple(&schema));
+  }
+  std::vector<RID> rids;
+  ASSERT_TRUE(test_table->InsertTuples(tuples, &rids, txn));
+  ASSERT_EQ(tuples.size(), rids.size());
+
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+  delete bustub_instance;
+
+  LOG_INFO("System restart...");
+  bustub_instance = new BustubInstance("test.db");
+  ASSERT_FALSE(enable_logging);
+
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery->Redo();
+  log_recovery->Undo();
+
+  LOG_INFO("Check if recovery success");
+  txn = bustub_instance->transaction_manager_->Begin();
+  test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                             bustub_instance->log_manager_, first_page_id);
+  for (size_t i = 0; i < rids.size(); i++) {
+    Tuple recovered;
+    ASSERT_TRUE(test_table->GetTuple(rids[i], &recovered, txn));
+    ASSERT_EQ(recovered.GetValue(&schema, 0).CompareEquals(tuples[i].GetValue(&schema, 0)), CmpBool::CmpTrue);
+    ASSERT_EQ(recovered.GetValue(&schema, 1).CompareEquals(tuples[i].GetValue(&schema, 1)), CmpBool::CmpTrue);
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+  delete log_recovery;
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_FlushedRedoTest) {
+  remove("test.db");
+  remove("test.log");
+
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+
+  ASSERT_FALSE(enable_logging);
+  bustub_instance->log_manager_->RunFlushThread();
+  ASSERT_TRUE(enable_logging);
+
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 500; i++) {
+    tuples.push_back(ConstructTuple(&schema));
+  }
+  std::vector<RID> rids;
+  ASSERT_TRUE(test_table->InsertTuples(tuples, &rids, txn));
+  bustub_instance->transaction_manager_->Commit(txn);
+
+  // Flush every page before shutdown, so Redo's disk-lsn pre-scan skips all of the records.
+  bustub_instance->buffer_pool_manager_->FlushAllPages();
+
+  delete txn;
+  delete test_table;
+  delete bustub_instance;
+
+  LOG_INFO("System restart...");
+  bustub_instance = new BustubInstance("test.db");
+  ASSERT_FALSE(enable_logging);
+
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery->Redo();
+  log_recovery->Undo();
+
+  LOG_INFO("Check if recovery success");
+  txn = bustub_instance->transaction_manager_->Begin();
+  test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                             bustub_instance->log_manager_, first_page_id);
+  for (size_t i = 0; i < rids.size(); i++) {
+    Tuple recovered;
+    ASSERT_TRUE(test_table->GetTuple(rids[i], &recovered, txn));
+    ASSERT_EQ(recovered.GetValue(&schema, 0).CompareEquals(tuples[i].GetValue(&schema, 0)), CmpBool::CmpTrue);
+    ASSERT_EQ(recovered.GetValue(&schema, 1).CompareEquals(tuples[i].GetValue(&schema, 1)), CmpBool::CmpTrue);
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+  delete log_recovery;
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
 // NOLINTNEXTLINE
 TEST(RecoveryTest, DISABLED_UndoTest) {
   remove("test.db");
@@ -314,4 +516,177 @@ TEST(RecoveryTest, DISABLED_CheckpointTest) {
   remove("test.db");
   remove("test.log");
 }
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_ScheduledCheckpointTest) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+
+  log_timeout = std::chrono::seconds(1);
+  checkpoint_poll_interval = std::chrono::milliseconds(10);
+
+  bustub_instance->log_manager_->RunFlushThread();
+  EXPECT_TRUE(enable_logging);
+
+  // Start the scheduler before any work: the WAL baseline is empty, any logged byte trips the
+  // budget, and the dirty-frame trigger is parked out of reach so only the WAL signal fires.
+  bustub_instance->checkpoint_manager_->SetWalByteBudget(1);
+  bustub_instance->checkpoint_manager_->SetDirtyFrameThreshold(1.1);
+  bustub_instance->checkpoint_manager_->SetFlushPacing(std::chrono::microseconds(0));
+  bustub_instance->checkpoint_manager_->RunCheckpointThread();
+  EXPECT_EQ(bustub_instance->checkpoint_manager_->GetScheduledCheckpoints(), 0U);
+
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+
+  for (int i = 0; i < 100; i++) {
+    RID rid;
+    EXPECT_TRUE(test_table->InsertTuple(tuple, &rid, txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+
+  // The committed work pushed WAL bytes past the one-byte budget; the scheduler must notice.
+  for (int i = 0; i < 200 && bustub_instance->checkpoint_manager_->GetScheduledCheckpoints() == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  size_t after_wal_trigger = bustub_instance->checkpoint_manager_->GetScheduledCheckpoints();
+  EXPECT_GE(after_wal_trigger, 1U);
+
+  // With the WAL baseline re-armed and no new log records, the scheduler must go quiet rather
+  // than checkpointing on every poll.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  size_t quiesced = bustub_instance->checkpoint_manager_->GetScheduledCheckpoints();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(bustub_instance->checkpoint_manager_->GetScheduledCheckpoints(), quiesced);
+
+  // Swap the triggers: WAL budget out of reach, dirty-frame threshold hair-trigger. Dirtying a
+  // single page must now force a checkpoint, and the checkpoint's flush re-cleans the pool.
+  bustub_instance->checkpoint_manager_->SetWalByteBudget(static_cast<size_t>(1) << 30);
+  bustub_instance->checkpoint_manager_->SetDirtyFrameThreshold(0.01);
+
+  Transaction *txn1 = bustub_instance->transaction_manager_->Begin();
+  RID rid;
+  EXPECT_TRUE(test_table->InsertTuple(tuple, &rid, txn1));
+  bustub_instance->transaction_manager_->Commit(txn1);
+
+  for (int i = 0; i < 200 && bustub_instance->checkpoint_manager_->GetScheduledCheckpoints() == quiesced; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_GT(bustub_instance->checkpoint_manager_->GetScheduledCheckpoints(), quiesced);
+
+  bustub_instance->checkpoint_manager_->StopCheckpointThread();
+  bustub_instance->log_manager_->StopFlushThread();
+
+  checkpoint_poll_interval = std::chrono::milliseconds(50);
+
+  delete txn;
+  delete txn1;
+  delete test_table;
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_LogShippingTest) {
+  remove("test.db");
+  remove("test.log");
+  remove("standby.db");
+  remove("standby.log");
+
+  log_timeout = std::chrono::seconds(1);
+
+  BustubInstance *primary = new BustubInstance("test.db");
+  BustubInstance *standby = new BustubInstance("standby.db");
+
+  // Wire the primary's flushed extents straight into the standby; a real deployment puts a
+  // socket between the consumer and Receive.
+  auto *receiver = new LogReceiver(standby->disk_manager_, standby->buffer_pool_manager_);
+  size_t handle = primary->log_manager_->RegisterLogConsumer(
+      [receiver](const char *data, int size, int start_offset, lsn_t /*end_lsn*/) {
+        receiver->Receive(data, size, start_offset);
+      });
+  receiver->RunApplyThread();
+
+  primary->log_manager_->RunFlushThread();
+  EXPECT_TRUE(enable_logging);
+
+  Transaction *txn = primary->transaction_manager_->Begin();
+  auto *test_table =
+      new TableHeap(primary->buffer_pool_manager_, primary->lock_manager_, primary->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  const Tuple tuple = ConstructTuple(&schema);
+  auto val_0 = tuple.GetValue(&schema, 0);
+  auto val_1 = tuple.GetValue(&schema, 1);
+
+  std::vector<RID> rids(100);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(test_table->InsertTuple(tuple, &rids[i], txn));
+  }
+  primary->transaction_manager_->Commit(txn);
+
+  // Commit waited for the flush, and the extent was shipped before the commit waiter woke, so
+  // the standby already holds the bytes; give its apply thread time to replay them.
+  int flushed = primary->log_manager_->GetFlushedBytes();
+  for (int i = 0; i < 200 && receiver->GetAppliedBytes() < flushed; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_GE(receiver->GetAppliedBytes(), flushed);
+
+  // The standby's own buffer pool and data file now hold the replayed table.
+  auto *standby_table =
+      new TableHeap(standby->buffer_pool_manager_, standby->lock_manager_, standby->log_manager_, first_page_id);
+  Tuple shipped;
+  auto *read_txn = new Transaction(0);
+  for (const RID &rid : rids) {
+    EXPECT_TRUE(standby_table->GetTuple(rid, &shipped, read_txn));
+    EXPECT_EQ(shipped.GetValue(&schema, 0).CompareEquals(val_0), CmpBool::CmpTrue);
+    EXPECT_EQ(shipped.GetValue(&schema, 1).CompareEquals(val_1), CmpBool::CmpTrue);
+  }
+
+  // A second round rides the resumable Redo: only the log appended since the last apply is
+  // scanned and replayed.
+  Transaction *txn1 = primary->transaction_manager_->Begin();
+  RID late_rid;
+  EXPECT_TRUE(test_table->InsertTuple(tuple, &late_rid, txn1));
+  primary->transaction_manager_->Commit(txn1);
+
+  flushed = primary->log_manager_->GetFlushedBytes();
+  for (int i = 0; i < 200 && receiver->GetAppliedBytes() < flushed; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_TRUE(standby_table->GetTuple(late_rid, &shipped, read_txn));
+  EXPECT_EQ(shipped.GetValue(&schema, 0).CompareEquals(val_0), CmpBool::CmpTrue);
+
+  primary->log_manager_->UnregisterLogConsumer(handle);
+  receiver->StopApplyThread();
+  primary->log_manager_->StopFlushThread();
+  EXPECT_FALSE(enable_logging);
+
+  delete read_txn;
+  delete txn;
+  delete txn1;
+  delete test_table;
+  delete standby_table;
+  delete receiver;
+  delete primary;
+  delete standby;
+  remove("test.db");
+  remove("test.log");
+  remove("standby.db");
+  remove("standby.log");
+}
 }  // namespace bustub
@@ -0,0 +1,184 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_test.cpp
+//
+// Identification: test/storage/b_plus_tree_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTest, InsertScanTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  std::vector<Column> cols{Column("a", TypeId::BIGINT)};
+  Schema schema(cols);
+  GenericComparator<8> comparator(&schema);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("test_tree", bpm, comparator);
+
+  EXPECT_TRUE(tree.IsEmpty());
+
+  // enough shuffled keys to force leaf and internal splits
+  std::vector<int64_t> keys(1000);
+  for (int64_t i = 0; i < 1000; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));  // NOLINT
+  for (int64_t k : keys) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(k);
+    tree.Insert(index_key, RID(static_cast<page_id_t>(k), 0));
+  }
+  EXPECT_FALSE(tree.IsEmpty());
+
+  // point lookups find every key
+  for (int64_t k = 0; k < 1000; k++) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(k);
+    std::vector<RID> result;
+    EXPECT_TRUE(tree.GetValue(index_key, &result));
+    ASSERT_EQ(1u, result.size());
+    EXPECT_EQ(k, result[0].GetPageId());
+  }
+
+  // a range scan comes back complete and in key order
+  GenericKey<8> low;
+  low.SetFromInteger(100);
+  GenericKey<8> high;
+  high.SetFromInteger(399);
+  std::vector<RID> range;
+  tree.ScanRange(&low, &high, &range);
+  ASSERT_EQ(300u, range.size());
+  for (int64_t i = 0; i < 300; i++) {
+    EXPECT_EQ(100 + i, range[i].GetPageId());
+  }
+
+  // an open-ended scan covers the whole tree
+  std::vector<RID> all;
+  tree.ScanRange(nullptr, nullptr, &all);
+  EXPECT_EQ(1000u, all.size());
+
+  bpm->FlushAllPages();
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTest, DuplicateKeyAndRemoveTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  std::vector<Column> cols{Column("a", TypeId::BIGINT)};
+  Schema schema(cols);
+  GenericComparator<8> comparator(&schema);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("test_tree", bpm, comparator);
+
+  // enough duplicates per key that a run spans several leaves
+  for (int64_t k = 0; k < 5; k++) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(k);
+    for (uint32_t slot = 0; slot < 400; slot++) {
+      tree.Insert(index_key, RID(static_cast<page_id_t>(k), slot));
+    }
+  }
+
+  GenericKey<8> probe;
+  probe.SetFromInteger(2);
+  std::vector<RID> result;
+  EXPECT_TRUE(tree.GetValue(probe, &result));
+  EXPECT_EQ(400u, result.size());
+
+  // removal is pair-exact
+  tree.Remove(probe, RID(2, 123));
+  result.clear();
+  tree.GetValue(probe, &result);
+  EXPECT_EQ(399u, result.size());
+  for (const RID &rid : result) {
+    EXPECT_NE(123u, rid.GetSlotNum());
+  }
+
+  // drain a key entirely; the others are untouched
+  for (uint32_t slot = 0; slot < 400; slot++) {
+    tree.Remove(probe, RID(2, slot));
+  }
+  result.clear();
+  EXPECT_FALSE(tree.GetValue(probe, &result));
+  probe.SetFromInteger(3);
+  result.clear();
+  EXPECT_TRUE(tree.GetValue(probe, &result));
+  EXPECT_EQ(400u, result.size());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTest, ConcurrentInsertTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  std::vector<Column> cols{Column("a", TypeId::BIGINT)};
+  Schema schema(cols);
+  GenericComparator<8> comparator(&schema);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("test_tree", bpm, comparator);
+
+  // disjoint key ranges inserted concurrently, enough to split under contention
+  constexpr int num_threads = 4;
+  constexpr int64_t keys_per_thread = 1000;
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&tree, t] {
+      for (int64_t i = 0; i < keys_per_thread; i++) {
+        int64_t k = t * keys_per_thread + i;
+        GenericKey<8> index_key;
+        index_key.SetFromInteger(k);
+        tree.Insert(index_key, RID(static_cast<page_id_t>(k), 0));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // every key is visible and the full scan is in order
+  for (int64_t k = 0; k < num_threads * keys_per_thread; k++) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(k);
+    std::vector<RID> result;
+    EXPECT_TRUE(tree.GetValue(index_key, &result));
+    ASSERT_EQ(1u, result.size());
+    EXPECT_EQ(k, result[0].GetPageId());
+  }
+  std::vector<RID> all;
+  tree.ScanRange(nullptr, nullptr, &all);
+  ASSERT_EQ(static_cast<size_t>(num_threads * keys_per_thread), all.size());
+  for (int64_t i = 0; i < num_threads * keys_per_thread; i++) {
+    EXPECT_EQ(i, all[i].GetPageId());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,345 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_test.cpp
+//
+// Identification: test/storage/disk_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/page_compressor.h"
+#include "storage/table/table_heap.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** @return the first word of the given page's on-disk slot, read straight from the file */
+static uint32_t ReadSlotMagic(const std::string &db_name, page_id_t page_id) {
+  std::ifstream db(db_name, std::ios::binary);
+  db.seekg(static_cast<std::streamoff>(page_id) * PAGE_SIZE);
+  uint32_t magic = 0;
+  db.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+  return magic;
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, PageCompressionTest) {
+  const std::string db_name = "disk_manager_test.db";
+  remove(db_name.c_str());
+  remove("disk_manager_test.log");
+  remove("disk_manager_test.free");
+
+  auto *disk_manager = new DiskManager(db_name);
+  page_id_t compressible_id = disk_manager->AllocatePage();
+  page_id_t incompressible_id = disk_manager->AllocatePage();
+  page_id_t raw_id = disk_manager->AllocatePage();
+  disk_manager->SetPageCompressed(compressible_id);
+  disk_manager->SetPageCompressed(incompressible_id);
+
+  // A page of repeated text compresses; its slot starts with the magic.
+  char compressible[PAGE_SIZE];
+  for (int i = 0; i < PAGE_SIZE; i++) {
+    compressible[i] = "temperature=23.5 humidity=40 "[i % 29];
+  }
+  disk_manager->WritePage(compressible_id, compressible);
+  EXPECT_EQ(PageCompressor::COMPRESSED_PAGE_MAGIC, ReadSlotMagic(db_name, compressible_id));
+
+  // Random bytes do not shrink; the slot falls back to the raw image.
+  char incompressible[PAGE_SIZE];
+  std::mt19937 rng(42);  // NOLINT
+  for (int i = 0; i < PAGE_SIZE; i++) {
+    incompressible[i] = static_cast<char>(rng());
+  }
+  disk_manager->WritePage(incompressible_id, incompressible);
+  EXPECT_NE(PageCompressor::COMPRESSED_PAGE_MAGIC, ReadSlotMagic(db_name, incompressible_id));
+
+  // A page that never opted in is written raw even if its content is compressible.
+  disk_manager->WritePage(raw_id, compressible);
+  EXPECT_NE(PageCompressor::COMPRESSED_PAGE_MAGIC, ReadSlotMagic(db_name, raw_id));
+
+  // All three read back as the logical image, whatever their slot encoding.
+  char frame[PAGE_SIZE];
+  disk_manager->ReadPage(compressible_id, frame);
+  EXPECT_EQ(0, std::memcmp(compressible, frame, PAGE_SIZE));
+  disk_manager->ReadPage(incompressible_id, frame);
+  EXPECT_EQ(0, std::memcmp(incompressible, frame, PAGE_SIZE));
+  disk_manager->ReadPage(raw_id, frame);
+  EXPECT_EQ(0, std::memcmp(compressible, frame, PAGE_SIZE));
+
+  // The compressed page set survives a restart through the free-list sidecar.
+  disk_manager->ShutDown();
+  delete disk_manager;
+  disk_manager = new DiskManager(db_name);
+  EXPECT_TRUE(disk_manager->IsPageCompressed(compressible_id));
+  EXPECT_FALSE(disk_manager->IsPageCompressed(raw_id));
+  disk_manager->ReadPage(compressible_id, frame);
+  EXPECT_EQ(0, std::memcmp(compressible, frame, PAGE_SIZE));
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  remove(db_name.c_str());
+  remove("disk_manager_test.log");
+  remove("disk_manager_test.free");
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, StripedWritePagesTest) {
+  const std::vector<std::string> db_files = {"disk_manager_test_0.db", "disk_manager_test_1.db",
+                                             "disk_manager_test_2.db"};
+  for (const auto &file : db_files) {
+    remove(file.c_str());
+  }
+  remove("disk_manager_test_0.log");
+  remove("disk_manager_test_0.free");
+  remove("disk_manager_test_0.warm");
+
+  auto *disk_manager = new DiskManager(db_files);
+
+  // Enough pages that every stripe's writer gets a multi-page slice to coalesce.
+  const int num_pages = 60;
+  std::vector<std::unique_ptr<char[]>> images;
+  std::vector<std::pair<page_id_t, const char *>> writes;
+  for (int i = 0; i < num_pages; ++i) {
+    page_id_t page_id = disk_manager->AllocatePage();
+    auto image = std::make_unique<char[]>(PAGE_SIZE);
+    snprintf(image.get(), PAGE_SIZE, "stripe payload %d", i);
+    writes.emplace_back(page_id, image.get());
+    images.push_back(std::move(image));
+  }
+  disk_manager->WritePages(&writes);
+
+  // Every page must read back intact from whichever stripe file its id maps to.
+  for (int i = 0; i < num_pages; ++i) {
+    char frame[PAGE_SIZE];
+    disk_manager->ReadPage(static_cast<page_id_t>(i), frame);
+    char expected[PAGE_SIZE];
+    snprintf(expected, PAGE_SIZE, "stripe payload %d", i);
+    EXPECT_EQ(0, std::memcmp(expected, frame, strlen(expected) + 1)) << "page " << i;
+  }
+
+  disk_manager->ShutDown();
+  delete disk_manager;
+  for (const auto &file : db_files) {
+    remove(file.c_str());
+  }
+  remove("disk_manager_test_0.log");
+  remove("disk_manager_test_0.free");
+  remove("disk_manager_test_0.warm");
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, ChecksumPersistenceTest) {
+  remove("disk_manager_test.db");
+  remove("disk_manager_test.log");
+  remove("disk_manager_test.free");
+  remove("disk_manager_test.warm");
+  remove("disk_manager_test.sums");
+
+  auto *disk_manager = new DiskManager("disk_manager_test.db");
+  page_id_t torn_page = disk_manager->AllocatePage();
+  page_id_t intact_page = disk_manager->AllocatePage();
+  char image[PAGE_SIZE];
+  snprintf(image, PAGE_SIZE, "torn payload");
+  disk_manager->WritePage(torn_page, image);
+  snprintf(image, PAGE_SIZE, "intact payload");
+  disk_manager->WritePage(intact_page, image);
+  // Simulated crash: no ShutDown, so only the per-write journal appends reach the sidecar.
+  delete disk_manager;
+
+  // Tear one page behind the disk manager's back, the way a crashed partial write would.
+  {
+    std::fstream db("disk_manager_test.db", std::ios::binary | std::ios::in | std::ios::out);
+    db.seekp(static_cast<std::streamoff>(torn_page) * PAGE_SIZE + PAGE_SIZE / 2);
+    std::vector<char> garbage(PAGE_SIZE / 4, '\xAB');
+    db.write(garbage.data(), garbage.size());
+  }
+
+  // The restarted disk manager replays the journal, so the first post-restart read of the torn
+  // page is flagged while the intact page verifies clean.
+  disk_manager = new DiskManager("disk_manager_test.db");
+  char frame[PAGE_SIZE];
+  disk_manager->ReadPage(torn_page, frame);
+  EXPECT_EQ(1, disk_manager->GetNumChecksumMismatches());
+  disk_manager->ReadPage(intact_page, frame);
+  EXPECT_EQ(1, disk_manager->GetNumChecksumMismatches());
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  // A fresh database must not inherit the stale sidecar: the same page ids, rewritten with new
+  // content, verify clean.
+  remove("disk_manager_test.db");
+  disk_manager = new DiskManager("disk_manager_test.db");
+  page_id_t reused_page = disk_manager->AllocatePage();
+  // Read before any write: with the stale sidecar truncated there is no recorded checksum, so
+  // the zero-filled never-written page passes instead of tripping over the old database's entry.
+  disk_manager->ReadPage(reused_page, frame);
+  EXPECT_EQ(0, disk_manager->GetNumChecksumMismatches());
+  snprintf(image, PAGE_SIZE, "fresh payload");
+  disk_manager->WritePage(reused_page, image);
+  disk_manager->ReadPage(reused_page, frame);
+  EXPECT_EQ(0, disk_manager->GetNumChecksumMismatches());
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  remove("disk_manager_test.db");
+  remove("disk_manager_test.log");
+  remove("disk_manager_test.free");
+  remove("disk_manager_test.warm");
+  remove("disk_manager_test.sums");
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, StreamingBackupTest) {
+  remove("disk_manager_test.db");
+  remove("disk_manager_test.log");
+  remove("disk_manager_test.free");
+  remove("backup_test.db");
+  remove("backup_test.log");
+  remove("backup_test.free");
+
+  auto *disk_manager = new DiskManager("disk_manager_test.db");
+  char frame[PAGE_SIZE] = {};
+  const int num_pages = 8;
+  for (int i = 0; i < num_pages; ++i) {
+    page_id_t page_id = disk_manager->AllocatePage();
+    snprintf(frame, PAGE_SIZE, "backup payload %d", i);
+    disk_manager->WritePage(page_id, frame);
+  }
+  EXPECT_TRUE(disk_manager->BackupDataFiles("backup_test.db"));
+  EXPECT_TRUE(disk_manager->BackupLogFiles("backup_test.db"));
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  // The copy opens as a complete database: pages, log and free-list sidecar all came along.
+  auto *backup = new DiskManager("backup_test.db");
+  for (int i = 0; i < num_pages; ++i) {
+    backup->ReadPage(static_cast<page_id_t>(i), frame);
+    char expected[PAGE_SIZE];
+    snprintf(expected, PAGE_SIZE, "backup payload %d", i);
+    EXPECT_EQ(0, std::memcmp(expected, frame, strlen(expected) + 1)) << "page " << i;
+  }
+  // the allocation high-water mark traveled in the sidecar
+  EXPECT_EQ(num_pages, backup->AllocatePage());
+  backup->ShutDown();
+  delete backup;
+
+  remove("disk_manager_test.db");
+  remove("disk_manager_test.log");
+  remove("disk_manager_test.free");
+  remove("backup_test.db");
+  remove("backup_test.log");
+  remove("backup_test.free");
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, IoLatencyStatsTest) {
+  remove("disk_manager_test.db");
+  remove("disk_manager_test.log");
+  remove("disk_manager_test.free");
+
+  auto *disk_manager = new DiskManager("disk_manager_test.db");
+  char frame[PAGE_SIZE] = {};
+  IoLatencyStats stats;
+
+  // Tracking is off by default: I/O leaves the histograms untouched.
+  disk_manager->WritePage(disk_manager->AllocatePage(), frame);
+  disk_manager->ReadPage(0, frame);
+  disk_manager->GetIoLatencyStats(&stats);
+  EXPECT_EQ(0U, IoLatencyStats::Percentile(stats.write_page_cycles, 0.5));
+  EXPECT_EQ(0U, IoLatencyStats::Percentile(stats.read_page_cycles, 0.5));
+
+  disk_manager->SetIoLatencyTracking(true);
+  const int num_pages = 16;
+  for (int i = 0; i < num_pages; ++i) {
+    disk_manager->WritePage(static_cast<page_id_t>(i % 2), frame);
+    disk_manager->ReadPage(static_cast<page_id_t>(i % 2), frame);
+  }
+  disk_manager->GetIoLatencyStats(&stats);
+  uint64_t writes = 0;
+  uint64_t reads = 0;
+  for (size_t i = 0; i < IoLatencyStats::LATENCY_HISTOGRAM_BUCKETS; ++i) {
+    writes += stats.write_page_cycles[i];
+    reads += stats.read_page_cycles[i];
+  }
+  EXPECT_EQ(static_cast<uint64_t>(num_pages), writes);
+  EXPECT_EQ(static_cast<uint64_t>(num_pages), reads);
+  // Every sample lies below its percentile bound, so the bound cannot be zero.
+  EXPECT_GT(IoLatencyStats::Percentile(stats.write_page_cycles, 0.99), 0U);
+  EXPECT_GT(IoLatencyStats::Percentile(stats.read_page_cycles, 0.99), 0U);
+
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove("disk_manager_test.db");
+  remove("disk_manager_test.log");
+  remove("disk_manager_test.free");
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, CompressedTableHeapTest) {
+  const std::string db_name = "disk_manager_test.db";
+  remove(db_name.c_str());
+  remove("disk_manager_test.log");
+  remove("disk_manager_test.free");
+
+  Column col1{"id", TypeId::INTEGER};
+  Column col2{"payload", TypeId::VARCHAR, 64};
+  Schema schema{{col1, col2}};
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager(db_name);
+  // A pool small enough that inserting spills pages to disk and scanning fetches them back,
+  // so the round trip goes through the compressed slots.
+  auto *buffer_pool_manager = new BufferPoolManager(4, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction, &schema, TableLayout::ROW,
+                              /*compressed=*/true);
+
+  const int num_rows = 500;
+  for (int i = 0; i < num_rows; ++i) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                              ValueFactory::GetVarcharValue("sensor reading " + std::to_string(i % 10))};
+    Tuple tuple{values, &schema};
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+  }
+  buffer_pool_manager->FlushAllPages();
+
+  // The heap spans several pages and each of them was marked with the disk manager.
+  EXPECT_TRUE(disk_manager->IsPageCompressed(table->GetFirstPageId()));
+  EXPECT_EQ(PageCompressor::COMPRESSED_PAGE_MAGIC, ReadSlotMagic(db_name, table->GetFirstPageId()));
+
+  int scanned = 0;
+  for (TableIterator itr = table->Begin(transaction); itr != table->End(); ++itr) {
+    EXPECT_EQ(scanned, itr->GetValue(&schema, 0).GetAs<int32_t>());
+    scanned++;
+  }
+  EXPECT_EQ(num_rows, scanned);
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("disk_manager_test.log");
+  remove("disk_manager_test.free");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+}  // namespace bustub
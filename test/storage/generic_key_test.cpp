@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key_test.cpp
+//
+// Identification: test/storage/generic_key_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+/** Encodes one single-column tuple per value and compares the two keys. */
+template <size_t KeySize>
+int CompareNormalized(const Schema *schema, const Value &lhs, const Value &rhs) {
+  std::vector<Value> lhs_values{lhs};
+  std::vector<Value> rhs_values{rhs};
+  Tuple lhs_tuple(lhs_values, schema);
+  Tuple rhs_tuple(rhs_values, schema);
+  NormalizedKey<KeySize> lhs_key;
+  NormalizedKey<KeySize> rhs_key;
+  lhs_key.SetFromKey(lhs_tuple, schema);
+  rhs_key.SetFromKey(rhs_tuple, schema);
+  return NormalizedComparator<KeySize>(nullptr)(lhs_key, rhs_key);
+}
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(NormalizedKeyTest, IntegerOrderTest) {
+  std::vector<Column> cols{Column("a", TypeId::BIGINT)};
+  Schema schema(cols);
+  // two's complement order must survive the sign flip, across zero included
+  std::vector<int64_t> ordered{INT64_MIN, -100000, -1, 0, 1, 42, 100000, INT64_MAX};
+  for (size_t i = 0; i < ordered.size(); i++) {
+    for (size_t j = 0; j < ordered.size(); j++) {
+      int cmp = CompareNormalized<8>(&schema, ValueFactory::GetBigIntValue(ordered[i]),
+                                     ValueFactory::GetBigIntValue(ordered[j]));
+      if (i < j) {
+        EXPECT_LT(cmp, 0) << ordered[i] << " vs " << ordered[j];
+      } else if (i > j) {
+        EXPECT_GT(cmp, 0) << ordered[i] << " vs " << ordered[j];
+      } else {
+        EXPECT_EQ(cmp, 0);
+      }
+    }
+  }
+  // the test-only integer setter uses the same encoding
+  NormalizedKey<8> negative;
+  negative.SetFromInteger(-5);
+  NormalizedKey<8> positive;
+  positive.SetFromInteger(3);
+  EXPECT_LT(NormalizedComparator<8>(nullptr)(negative, positive), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(NormalizedKeyTest, DecimalOrderTest) {
+  std::vector<Column> cols{Column("a", TypeId::DECIMAL)};
+  Schema schema(cols);
+  std::vector<double> ordered{-1e100, -3.5, -1.0, -0.25, 0.0, 0.5, 2.25, 1e100};
+  for (size_t i = 0; i + 1 < ordered.size(); i++) {
+    EXPECT_LT(CompareNormalized<8>(&schema, ValueFactory::GetDecimalValue(ordered[i]),
+                                   ValueFactory::GetDecimalValue(ordered[i + 1])),
+              0)
+        << ordered[i] << " vs " << ordered[i + 1];
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(NormalizedKeyTest, VarcharPrefixTest) {
+  std::vector<Column> cols{Column("a", TypeId::VARCHAR, 32)};
+  Schema schema(cols);
+  EXPECT_LT(CompareNormalized<16>(&schema, ValueFactory::GetVarcharValue("apple", false),
+                                  ValueFactory::GetVarcharValue("banana", false)),
+            0);
+  // zero padding ranks the shorter string first
+  EXPECT_LT(
+      CompareNormalized<16>(&schema, ValueFactory::GetVarcharValue("app", false), ValueFactory::GetVarcharValue("apple", false)), 0);
+  EXPECT_EQ(
+      CompareNormalized<16>(&schema, ValueFactory::GetVarcharValue("apple", false), ValueFactory::GetVarcharValue("apple", false)),
+      0);
+  // strings agreeing over the whole window are ties: that is the prefix truncation contract
+  std::string long_a(16, 'x');
+  std::string long_b = long_a + "different tail a";
+  std::string long_c = long_a + "different tail b";
+  EXPECT_EQ(CompareNormalized<16>(&schema, ValueFactory::GetVarcharValue(long_b.c_str(), false),
+                                  ValueFactory::GetVarcharValue(long_c.c_str(), false)),
+            0);
+}
+
+// NOLINTNEXTLINE
+TEST(NormalizedKeyTest, MultiColumnOrderTest) {
+  std::vector<Column> cols{Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 32)};
+  Schema schema(cols);
+  auto make_key = [&schema](int32_t a, const char *b) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(b, false)};
+    Tuple tuple(values, &schema);
+    NormalizedKey<16> key;
+    key.SetFromKey(tuple, &schema);
+    return key;
+  };
+  NormalizedComparator<16> comparator(nullptr);
+  // the leading integer dominates; the varchar breaks ties
+  EXPECT_LT(comparator(make_key(1, "zzz"), make_key(2, "aaa")), 0);
+  EXPECT_LT(comparator(make_key(-7, "zzz"), make_key(1, "aaa")), 0);
+  EXPECT_LT(comparator(make_key(2, "aaa"), make_key(2, "abc")), 0);
+  EXPECT_EQ(comparator(make_key(2, "abc"), make_key(2, "abc")), 0);
+}
+
+}  // namespace bustub
@@ -0,0 +1,228 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// storage_bench.cpp
+//
+// Identification: test/storage/storage_bench.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Microbenchmark harness for the slotted-page insert/read paths and the heap full scan. Not a
+// gtest target: it measures throughput across tuple sizes, fill factors, and delete ratios and
+// writes the results as JSON (stdout and storage_bench.json), so a layout change can be judged
+// by diffing the baseline of one commit against the next. Build and run with
+// `make storage-bench`.
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/table_page.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/table_iterator.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+namespace {
+
+/** One measured configuration: a benchmark name, its parameters, and a throughput. */
+struct BenchResult {
+  std::string name_;
+  std::vector<std::pair<std::string, double>> fields_;
+};
+
+/** Builds a tuple whose materialized size is close to the requested byte count. */
+Tuple MakeTuple(const Schema &schema, uint32_t payload_bytes) {
+  std::vector<Value> values;
+  values.emplace_back(ValueFactory::GetBigIntValue(42));
+  values.emplace_back(ValueFactory::GetVarcharValue(std::string(payload_bytes, 'x')));
+  return Tuple(values, &schema);
+}
+
+/** @return seconds elapsed since start */
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * InsertTuple throughput per tuple size: fill fresh standalone pages to capacity and time the
+ * inserts. Also reports how many tuples a page holds and the resulting fill factor, the numbers
+ * a slot-layout change moves first.
+ */
+void BenchInsert(std::vector<BenchResult> *results) {
+  for (uint32_t payload : {8U, 64U, 256U, 1024U}) {
+    std::vector<Column> columns{{"id", TypeId::BIGINT}, {"pad", TypeId::VARCHAR, payload}};
+    Schema schema{columns};
+    Tuple tuple = MakeTuple(schema, payload);
+
+    constexpr int NUM_PAGES = 2000;
+    size_t inserted = 0;
+    uint32_t per_page = 0;
+    double fill_factor = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int p = 0; p < NUM_PAGES; p++) {
+      TablePage page{};
+      page.Init(0, PAGE_SIZE, INVALID_PAGE_ID, nullptr, nullptr);
+      RID rid;
+      uint32_t count = 0;
+      while (page.InsertTuple(tuple, &rid, nullptr, nullptr, nullptr)) {
+        count++;
+      }
+      inserted += count;
+      per_page = count;
+      fill_factor = 1.0 - static_cast<double>(page.GetFreeSpaceRemaining()) / PAGE_SIZE;
+    }
+    double secs = SecondsSince(start);
+    results->push_back({"table_page_insert",
+                        {{"tuple_bytes", tuple.GetLength()},
+                         {"tuples_per_page", per_page},
+                         {"fill_factor", fill_factor},
+                         {"tuples_per_sec", inserted / secs}}});
+  }
+}
+
+/**
+ * GetTuple throughput across fill factors and delete ratios: a page is filled to the given
+ * fraction of its capacity, the given fraction of its tuples is deleted (MarkDelete then
+ * ApplyDelete, so the reads walk real holes and compacted offsets), and every surviving RID is
+ * then read repeatedly.
+ */
+void BenchGet(std::vector<BenchResult> *results) {
+  constexpr uint32_t PAYLOAD = 64;
+  std::vector<Column> columns{{"id", TypeId::BIGINT}, {"pad", TypeId::VARCHAR, PAYLOAD}};
+  Schema schema{columns};
+  Tuple tuple = MakeTuple(schema, PAYLOAD);
+
+  for (double fill : {0.25, 0.5, 1.0}) {
+    for (double delete_ratio : {0.0, 0.25, 0.5}) {
+      TablePage page{};
+      page.Init(0, PAGE_SIZE, INVALID_PAGE_ID, nullptr, nullptr);
+      // Measure capacity on a scratch page, then fill the real one to the target fraction.
+      uint32_t capacity = 0;
+      {
+        TablePage scratch{};
+        scratch.Init(0, PAGE_SIZE, INVALID_PAGE_ID, nullptr, nullptr);
+        RID rid;
+        while (scratch.InsertTuple(tuple, &rid, nullptr, nullptr, nullptr)) {
+          capacity++;
+        }
+      }
+      auto target = static_cast<uint32_t>(capacity * fill);
+      std::vector<RID> rids;
+      for (uint32_t i = 0; i < target; i++) {
+        RID rid;
+        if (!page.InsertTuple(tuple, &rid, nullptr, nullptr, nullptr)) {
+          break;
+        }
+        rids.push_back(rid);
+      }
+      auto to_delete = static_cast<size_t>(rids.size() * delete_ratio);
+      for (size_t i = 0; i < to_delete; i++) {
+        // Spread the holes across the page instead of clustering them at one end.
+        size_t victim = (i * rids.size()) / (to_delete != 0 ? to_delete : 1);
+        page.MarkDelete(rids[victim], nullptr, nullptr, nullptr);
+        page.ApplyDelete(rids[victim], nullptr, nullptr);
+      }
+
+      constexpr int ROUNDS = 20000;
+      size_t reads = 0;
+      Tuple out;
+      auto start = std::chrono::steady_clock::now();
+      for (int round = 0; round < ROUNDS && SecondsSince(start) < 0.25; round++) {
+        for (const RID &rid : rids) {
+          page.GetTuple(rid, &out, nullptr, nullptr);
+          reads++;
+        }
+      }
+      double secs = SecondsSince(start);
+      results->push_back({"table_page_get",
+                          {{"tuple_bytes", tuple.GetLength()},
+                           {"fill_factor", fill},
+                           {"delete_ratio", delete_ratio},
+                           {"reads_per_sec", reads / secs}}});
+    }
+  }
+}
+
+/**
+ * TableIterator full-scan rate over a real heap: rows are inserted through the table heap and
+ * buffer pool, then scanned end to end. The pool holds the whole table, so this measures the
+ * iterator and page code, not the disk.
+ */
+void BenchScan(std::vector<BenchResult> *results) {
+  constexpr uint32_t PAYLOAD = 64;
+  constexpr int NUM_ROWS = 50000;
+  std::vector<Column> columns{{"id", TypeId::BIGINT}, {"pad", TypeId::VARCHAR, PAYLOAD}};
+  Schema schema{columns};
+  Tuple tuple = MakeTuple(schema, PAYLOAD);
+
+  remove("storage_bench.db");
+  remove("storage_bench.log");
+  auto *disk_manager = new DiskManager("storage_bench.db");
+  auto *bpm = new BufferPoolManager(2048, disk_manager);
+  auto *txn = new Transaction(0);
+  auto *table = new TableHeap(bpm, nullptr, nullptr, txn);
+
+  RID rid;
+  for (int i = 0; i < NUM_ROWS; i++) {
+    table->InsertTuple(tuple, &rid, txn);
+  }
+
+  size_t rows = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (auto it = table->Begin(txn); it != table->End(); ++it) {
+    rows++;
+  }
+  double secs = SecondsSince(start);
+  results->push_back({"table_heap_full_scan",
+                      {{"tuple_bytes", tuple.GetLength()},
+                       {"rows", static_cast<double>(rows)},
+                       {"rows_per_sec", rows / secs}}});
+
+  delete table;
+  delete txn;
+  delete bpm;
+  delete disk_manager;
+  remove("storage_bench.db");
+  remove("storage_bench.log");
+}
+
+/** Serializes the results as one JSON object per line inside a top-level array. */
+std::string ToJson(const std::vector<BenchResult> &results) {
+  std::ostringstream out;
+  out << "{\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    out << "    {\"name\": \"" << results[i].name_ << "\"";
+    for (const auto &[key, value] : results[i].fields_) {
+      out << ", \"" << key << "\": " << value;
+    }
+    out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n}\n";
+  return out.str();
+}
+
+}  // namespace
+}  // namespace bustub
+
+int main() {
+  std::vector<bustub::BenchResult> results;
+  bustub::BenchInsert(&results);
+  bustub::BenchGet(&results);
+  bustub::BenchScan(&results);
+
+  std::string json = bustub::ToJson(results);
+  std::fputs(json.c_str(), stdout);
+  std::ofstream baseline("storage_bench.json");
+  baseline << json;
+  return 0;
+}
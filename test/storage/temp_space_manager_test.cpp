@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// temp_space_manager_test.cpp
+//
+// Identification: test/storage/temp_space_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/temp_space_manager.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TempSpaceManagerTest, ReadWriteRecycleTest) {
+  TempSpaceManager temp;
+
+  // Write a distinct pattern into a handful of pages and unpin them dirty.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 8; i++) {
+    page_id_t page_id;
+    Page *page = temp.NewPage(&page_id);
+    ASSERT_NE(page, nullptr);
+    memset(page->GetData(), 'a' + i, PAGE_SIZE);
+    temp.UnpinPage(page_id, true);
+    page_ids.push_back(page_id);
+  }
+
+  // Each page reads back with its own pattern.
+  for (int i = 0; i < 8; i++) {
+    Page *page = temp.FetchPage(page_ids[i]);
+    ASSERT_NE(page, nullptr);
+    for (size_t off = 0; off < PAGE_SIZE; off += PAGE_SIZE / 16) {
+      ASSERT_EQ(page->GetData()[off], 'a' + i);
+    }
+    temp.UnpinPage(page_ids[i], false);
+  }
+
+  // Deleted page ids are recycled by later allocations instead of growing the file.
+  temp.DeletePage(page_ids[3]);
+  temp.DeletePage(page_ids[5]);
+  page_id_t reused;
+  Page *page = temp.NewPage(&reused);
+  ASSERT_NE(page, nullptr);
+  ASSERT_TRUE(reused == page_ids[3] || reused == page_ids[5]);
+  // A recycled page comes back zeroed, not with the deleted page's contents.
+  ASSERT_EQ(page->GetData()[0], 0);
+  temp.UnpinPage(reused, false);
+}
+
+}  // namespace bustub
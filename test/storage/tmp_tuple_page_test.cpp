@@ -43,9 +43,15 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
   page.Insert(tuple, &tmp_tuple);
 
-  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), PAGE_SIZE - 8);
-  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 8), 4);
-  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 4), 123);
+  // A serialized tuple is its fixed section plus the trailing null bitmap, behind a length
+  // prefix; for one INTEGER column that is 4 + 1 bytes of tuple in a 9-byte entry.
+  uint32_t tuple_size = schema.GetLength() + Tuple::NullBitmapSize(&schema);
+  uint32_t entry_size = sizeof(uint32_t) + tuple_size;
+  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), PAGE_SIZE - entry_size);
+  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - entry_size), tuple_size);
+  ASSERT_EQ(*reinterpret_cast<int32_t *>(data + PAGE_SIZE - tuple_size), 123);
+  // The value is not null, so its bitmap bit is clear.
+  ASSERT_EQ(*(data + PAGE_SIZE - 1), 0);
 }
 
 }  // namespace bustub
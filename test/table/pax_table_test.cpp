@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_test.cpp
+//
+// Identification: test/table/pax_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PaxTableTest, InsertGetIterateTest) {
+  Column col1{"a", TypeId::BIGINT};
+  Column col2{"b", TypeId::INTEGER};
+  Column col3{"c", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2, col3};
+  Schema schema{cols};
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManager(50, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction, &schema, TableLayout::PAX);
+
+  // enough rows to span several pages
+  std::vector<RID> rids;
+  for (int64_t i = 0; i < 2000; i++) {
+    std::vector<Value> values{ValueFactory::GetBigIntValue(i), ValueFactory::GetIntegerValue(static_cast<int32_t>(i)),
+                              ValueFactory::GetSmallIntValue(static_cast<int16_t>(i % 100))};
+    Tuple tuple(values, &schema);
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    rids.push_back(rid);
+  }
+
+  // point reads gather the columns back out of the minipages
+  for (int64_t i = 0; i < 2000; i++) {
+    Tuple tuple;
+    ASSERT_TRUE(table->GetTuple(rids[i], &tuple, transaction));
+    EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int64_t>());
+    EXPECT_EQ(static_cast<int32_t>(i), tuple.GetValue(&schema, 1).GetAs<int32_t>());
+    EXPECT_EQ(static_cast<int16_t>(i % 100), tuple.GetValue(&schema, 2).GetAs<int16_t>());
+  }
+
+  // the iterator walks every row in insertion order
+  int64_t expected = 0;
+  for (TableIterator itr = table->Begin(transaction); itr != table->End(); ++itr) {
+    EXPECT_EQ(expected, itr->GetValue(&schema, 0).GetAs<int64_t>());
+    expected++;
+  }
+  EXPECT_EQ(2000, expected);
+
+  // fixed-length rows update in place
+  std::vector<Value> updated{ValueFactory::GetBigIntValue(static_cast<int64_t>(-7)), ValueFactory::GetIntegerValue(42),
+                             ValueFactory::GetSmallIntValue(static_cast<int16_t>(9))};
+  Tuple updated_tuple(updated, &schema);
+  ASSERT_TRUE(table->UpdateTuple(updated_tuple, rids[10], transaction));
+  Tuple reread;
+  ASSERT_TRUE(table->GetTuple(rids[10], &reread, transaction));
+  EXPECT_EQ(-7, reread.GetValue(&schema, 0).GetAs<int64_t>());
+  EXPECT_EQ(42, reread.GetValue(&schema, 1).GetAs<int32_t>());
+
+  // deletes tombstone the slot; applying the delete frees it for reuse
+  ASSERT_TRUE(table->MarkDelete(rids[20], transaction));
+  Tuple deleted;
+  EXPECT_FALSE(table->GetTuple(rids[20], &deleted, transaction));
+  table->ApplyDelete(rids[20], transaction);
+  std::vector<Value> replacement{ValueFactory::GetBigIntValue(static_cast<int64_t>(5000)),
+                                 ValueFactory::GetIntegerValue(5000),
+                                 ValueFactory::GetSmallIntValue(static_cast<int16_t>(50))};
+  Tuple replacement_tuple(replacement, &schema);
+  RID reused_rid;
+  ASSERT_TRUE(table->InsertTuple(replacement_tuple, &reused_rid, transaction));
+  EXPECT_EQ(rids[20], reused_rid);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+}  // namespace bustub